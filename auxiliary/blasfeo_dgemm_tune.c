@@ -0,0 +1,337 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+
+
+#include <stdlib.h>
+#if defined(EXT_DEP)
+#include <stdio.h>
+#include <string.h>
+#endif
+
+#include <blasfeo_target.h>
+#include <blasfeo_dgemm_tune.h>
+
+
+
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+#define TUNE_TARGET "X64_INTEL_SKYLAKE_X"
+#elif defined(TARGET_X64_INTEL_HASWELL)
+#define TUNE_TARGET "X64_INTEL_HASWELL"
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+#define TUNE_TARGET "X64_INTEL_SANDY_BRIDGE"
+#elif defined(TARGET_X64_INTEL_CORE)
+#define TUNE_TARGET "X64_INTEL_CORE"
+#elif defined(TARGET_X64_AMD_BULLDOZER)
+#define TUNE_TARGET "X64_AMD_BULLDOZER"
+#elif defined(TARGET_X86_AMD_JAGUAR)
+#define TUNE_TARGET "X86_AMD_JAGUAR"
+#elif defined(TARGET_X86_AMD_BARCELONA)
+#define TUNE_TARGET "X86_AMD_BARCELONA"
+#elif defined(TARGET_ARMV8A_APPLE_M1)
+#define TUNE_TARGET "ARMV8A_APPLE_M1"
+#elif defined(TARGET_ARMV8A_ARM_CORTEX_A76)
+#define TUNE_TARGET "ARMV8A_ARM_CORTEX_A76"
+#elif defined(TARGET_ARMV8A_ARM_CORTEX_A73)
+#define TUNE_TARGET "ARMV8A_ARM_CORTEX_A73"
+#elif defined(TARGET_ARMV8A_ARM_CORTEX_A57)
+#define TUNE_TARGET "ARMV8A_ARM_CORTEX_A57"
+#elif defined(TARGET_ARMV8A_ARM_CORTEX_A55)
+#define TUNE_TARGET "ARMV8A_ARM_CORTEX_A55"
+#elif defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+#define TUNE_TARGET "ARMV8A_ARM_CORTEX_A53"
+#elif defined(TARGET_ARMV7A_ARM_CORTEX_A15)
+#define TUNE_TARGET "ARMV7A_ARM_CORTEX_A15"
+#elif defined(TARGET_ARMV7A_ARM_CORTEX_A7)
+#define TUNE_TARGET "ARMV7A_ARM_CORTEX_A7"
+#elif defined(TARGET_ARMV7A_ARM_CORTEX_A9)
+#define TUNE_TARGET "ARMV7A_ARM_CORTEX_A9"
+#else
+#define TUNE_TARGET "GENERIC"
+#endif
+
+
+
+// entries hold alg+1, so that the zero-initialized table selects the built-in heuristic
+static signed char tune_table[4][BLASFEO_DGEMM_TUNE_BINS][BLASFEO_DGEMM_TUNE_BINS][BLASFEO_DGEMM_TUNE_BINS];
+// number of non-default entries
+static int tune_entries = 0;
+// 0: not initialized, 1: environment table being loaded, 2: initialized
+static int tune_state = 0;
+
+static const char *tune_variant_name[4] = {"nn", "nt", "tn", "tt"};
+
+
+
+static int tune_state_load()
+	{
+#if defined(__GNUC__) || defined(__clang__)
+	return __atomic_load_n(&tune_state, __ATOMIC_ACQUIRE);
+#else
+	return *(volatile int *) &tune_state;
+#endif
+	}
+
+
+
+static void tune_state_store(int state)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+	__atomic_store_n(&tune_state, state, __ATOMIC_RELEASE);
+#else
+	*(volatile int *) &tune_state = state;
+#endif
+	}
+
+
+
+// returns 1 if the state was changed from state_old to state_new
+static int tune_state_cas(int state_old, int state_new)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+	return __atomic_compare_exchange_n(&tune_state, &state_old, state_new, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#else
+	if(tune_state!=state_old)
+		return 0;
+	tune_state = state_new;
+	return 1;
+#endif
+	}
+
+
+
+#if defined(EXT_DEP)
+static int tune_load_file(char *file_name);
+#endif
+
+
+
+// the first caller loads the environment table, the concurrent ones wait for it
+static void tune_init()
+	{
+	if(!tune_state_cas(0, 1))
+		{
+		while(tune_state_load()!=2)
+			;
+		return;
+		}
+#if defined(EXT_DEP)
+	char *env = getenv("BLASFEO_DGEMM_TUNE");
+	if(env!=NULL)
+		{
+		if(tune_load_file(env)!=0)
+			{
+			printf("\nWarning: blasfeo_dgemm_tune: cannot load table %s, using the built-in heuristic\n", env);
+			}
+		}
+#endif
+	tune_state_store(2);
+	return;
+	}
+
+
+
+// an explicit change of the table takes precedence over the environment table: the latter is not loaded
+// afterwards, and one being loaded is waited for
+static void tune_claim()
+	{
+	if(!tune_state_cas(0, 2))
+		{
+		while(tune_state_load()!=2)
+			;
+		}
+	return;
+	}
+
+
+
+int blasfeo_dgemm_tune_bin(int size)
+	{
+	int bin = 0;
+	while(bin<BLASFEO_DGEMM_TUNE_BINS-1 && (1<<bin)<size)
+		bin++;
+	return bin;
+	}
+
+
+
+int blasfeo_dgemm_tune_bin_size(int bin)
+	{
+	// middle of the bin range
+	return bin<2 ? 1<<bin : 3<<(bin-2);
+	}
+
+
+
+int blasfeo_dgemm_tune_get(int variant, int bm, int bn, int bk)
+	{
+	if(variant<0 | variant>3 | bm<0 | bm>=BLASFEO_DGEMM_TUNE_BINS | bn<0 | bn>=BLASFEO_DGEMM_TUNE_BINS | bk<0 | bk>=BLASFEO_DGEMM_TUNE_BINS)
+		return BLASFEO_DGEMM_ALG_AUTO;
+	return tune_table[variant][bm][bn][bk] - 1;
+	}
+
+
+
+void blasfeo_dgemm_tune_set(int variant, int bm, int bn, int bk, int alg)
+	{
+	if(variant<0 | variant>3 | bm<0 | bm>=BLASFEO_DGEMM_TUNE_BINS | bn<0 | bn>=BLASFEO_DGEMM_TUNE_BINS | bk<0 | bk>=BLASFEO_DGEMM_TUNE_BINS)
+		return;
+	if(alg<BLASFEO_DGEMM_ALG_AUTO | alg>BLASFEO_DGEMM_ALG_2)
+		alg = BLASFEO_DGEMM_ALG_AUTO;
+	tune_claim();
+	signed char *entry = &tune_table[variant][bm][bn][bk];
+	tune_entries += (alg!=BLASFEO_DGEMM_ALG_AUTO) - (*entry!=0);
+	*entry = alg + 1;
+	return;
+	}
+
+
+
+void blasfeo_dgemm_tune_clear()
+	{
+	tune_claim();
+	signed char *ptr = &tune_table[0][0][0][0];
+	int ii;
+	for(ii=0; ii<sizeof(tune_table); ii++)
+		ptr[ii] = 0;
+	tune_entries = 0;
+	return;
+	}
+
+
+
+int blasfeo_dgemm_tune_alg(int variant, int m, int n, int k)
+	{
+	if(tune_state_load()!=2)
+		tune_init();
+	if(tune_entries==0)
+		return BLASFEO_DGEMM_ALG_AUTO;
+	return tune_table[variant][blasfeo_dgemm_tune_bin(m)][blasfeo_dgemm_tune_bin(n)][blasfeo_dgemm_tune_bin(k)] - 1;
+	}
+
+
+
+#if defined(EXT_DEP)
+
+// file format: a header line "blasfeo_dgemm_tune <target> <bins>", followed by one line per entry
+// "<variant> <bm> <bn> <bk> <alg>"; lines starting with # are comments
+static int tune_load_file(char *file_name)
+	{
+	FILE *file = fopen(file_name, "r");
+	if(file==NULL)
+		return 1;
+
+	char line[256];
+	char target[64];
+	char variant[8];
+	int bins, bm, bn, bk, alg;
+	int ii;
+	int header = 0;
+	int error = 0;
+
+	signed char table[4][BLASFEO_DGEMM_TUNE_BINS][BLASFEO_DGEMM_TUNE_BINS][BLASFEO_DGEMM_TUNE_BINS];
+	int entries = 0;
+	memset(table, 0, sizeof(table));
+
+	while(error==0 && fgets(line, sizeof(line), file)!=NULL)
+		{
+		if(line[0]=='#' | line[0]=='\n')
+			continue;
+		if(header==0)
+			{
+			if(sscanf(line, "blasfeo_dgemm_tune %63s %d", target, &bins)!=2 || strcmp(target, TUNE_TARGET)!=0 || bins!=BLASFEO_DGEMM_TUNE_BINS)
+				error = 1;
+			header = 1;
+			continue;
+			}
+		if(sscanf(line, "%7s %d %d %d %d", variant, &bm, &bn, &bk, &alg)!=5)
+			{
+			error = 1;
+			break;
+			}
+		for(ii=0; ii<4; ii++)
+			if(strcmp(variant, tune_variant_name[ii])==0)
+				break;
+		if(ii==4 | bm<0 | bm>=bins | bn<0 | bn>=bins | bk<0 | bk>=bins | alg<BLASFEO_DGEMM_ALG_AUTO | alg>BLASFEO_DGEMM_ALG_2)
+			{
+			error = 1;
+			break;
+			}
+		entries += (alg!=BLASFEO_DGEMM_ALG_AUTO) - (table[ii][bm][bn][bk]!=0);
+		table[ii][bm][bn][bk] = alg + 1;
+		}
+	fclose(file);
+
+	if(error!=0 | header==0)
+		return 1;
+
+	memcpy(tune_table, table, sizeof(tune_table));
+	tune_entries = entries;
+	return 0;
+	}
+
+
+
+int blasfeo_dgemm_tune_load(char *file_name)
+	{
+	tune_claim();
+	return tune_load_file(file_name);
+	}
+
+
+
+int blasfeo_dgemm_tune_save(char *file_name)
+	{
+	FILE *file = fopen(file_name, "w");
+	if(file==NULL)
+		return 1;
+
+	int ii, bm, bn, bk;
+
+	fprintf(file, "# dgemm packing algorithm table: 0 no packing, 1 pack A, 2 pack B, 3 pack A and B\n");
+	fprintf(file, "blasfeo_dgemm_tune %s %d\n", TUNE_TARGET, BLASFEO_DGEMM_TUNE_BINS);
+	for(ii=0; ii<4; ii++)
+		for(bm=0; bm<BLASFEO_DGEMM_TUNE_BINS; bm++)
+			for(bn=0; bn<BLASFEO_DGEMM_TUNE_BINS; bn++)
+				for(bk=0; bk<BLASFEO_DGEMM_TUNE_BINS; bk++)
+					if(tune_table[ii][bm][bn][bk]!=0)
+						fprintf(file, "%s %d %d %d %d\n", tune_variant_name[ii], bm, bn, bk, tune_table[ii][bm][bn][bk]-1);
+
+	fclose(file);
+	return 0;
+	}
+
+#endif
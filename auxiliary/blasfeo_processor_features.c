@@ -36,32 +36,32 @@
 #include <blasfeo_processor_features.h>
 #include <blasfeo_target.h>
 
-#if defined(TARGET_X64_INTEL_HASWELL) \
+#if defined(__linux__) && defined(EXT_DEP)
+#include <stdio.h>
+#endif
+
+#if defined(TARGET_X64_INTEL_SKYLAKE_X) \
+    || defined(TARGET_X64_INTEL_HASWELL) \
     || defined(TARGET_X64_INTEL_SANDY_BRIDGE) \
     || defined(TARGET_X64_INTEL_CORE) \
     || defined(TARGET_X64_AMD_BULLDOZER) \
     || defined(TARGET_X86_AMD_JAGUAR) \
-    || defined(TARGET_X86_AMD_BARCELONA)
+    || defined(TARGET_X86_AMD_BARCELONA) \
+    || defined(RUNTIME_DISPATCH)
 #if defined(__GNUC__) || defined(__clang__)
 #include <cpuid.h>
 // define missing bit_AVX2 (e.g. in case of clang compiler)
 #ifndef bit_AVX2
 #define bit_AVX2 (1 << 5)
 #endif
+#ifndef bit_AVX512F
+#define bit_AVX512F (1 << 16)
+#endif
+#ifndef bit_OSXSAVE
+#define bit_OSXSAVE (1 << 27)
+#endif
 #endif
 #endif
-
-// x86-64 CPU features
-#define BLASFEO_PROCESSOR_FEATURE_AVX  0x0001    /// AVX instruction set
-#define BLASFEO_PROCESSOR_FEATURE_AVX2 0x0002    /// AVX2 instruction set
-#define BLASFEO_PROCESSOR_FEATURE_FMA  0x0004    /// FMA instruction set
-#define BLASFEO_PROCESSOR_FEATURE_SSE3 0x0008    /// SSE3 instruction set
-
-// ARM CPU features
-#define BLASFEO_PROCESSOR_FEATURE_VFPv3  0x0100  /// VFPv3 instruction set
-#define BLASFEO_PROCESSOR_FEATURE_NEON   0x0100  /// NEON instruction set
-#define BLASFEO_PROCESSOR_FEATURE_VFPv4  0x0100  /// VFPv4 instruction set
-#define BLASFEO_PROCESSOR_FEATURE_NEONv2 0x0100  /// NEONv2 instruction set
 
 
 
@@ -102,6 +102,18 @@ void blasfeo_processor_feature_string( int features, char* featureString )
         featureString[idx++] = '3';
     }
 
+    if( features & BLASFEO_PROCESSOR_FEATURE_AVX512F )
+    {
+        featureString[idx++] = ' ';
+        featureString[idx++] = 'A';
+        featureString[idx++] = 'V';
+        featureString[idx++] = 'X';
+        featureString[idx++] = '5';
+        featureString[idx++] = '1';
+        featureString[idx++] = '2';
+        featureString[idx++] = 'F';
+    }
+
     featureString[idx] = 0;
 }
 
@@ -133,6 +145,10 @@ void blasfeo_processor_library_features( int* features )
     #if defined(TARGET_NEED_FEATURE_SSE3)
     *features |= BLASFEO_PROCESSOR_FEATURE_SSE3;
     #endif
+
+    #if defined(TARGET_NEED_FEATURE_AVX512F)
+    *features |= BLASFEO_PROCESSOR_FEATURE_AVX512F;
+    #endif
 }
 
 
@@ -140,12 +156,14 @@ int blasfeo_processor_cpu_features( int* features )
 {
     *features = 0;
 
-#if defined(TARGET_X64_INTEL_HASWELL) \
+#if defined(TARGET_X64_INTEL_SKYLAKE_X) \
+    || defined(TARGET_X64_INTEL_HASWELL) \
     || defined(TARGET_X64_INTEL_SANDY_BRIDGE) \
     || defined(TARGET_X64_INTEL_CORE) \
     || defined(TARGET_X64_AMD_BULLDOZER) \
     || defined(TARGET_X86_AMD_JAGUAR) \
-    || defined(TARGET_X86_AMD_BARCELONA)
+    || defined(TARGET_X86_AMD_BARCELONA) \
+    || defined(RUNTIME_DISPATCH)
 
 // GCC and clang provide the __get_cpuid function
 #if defined(__GNUC__) || defined(__clang__)
@@ -166,6 +184,15 @@ int blasfeo_processor_cpu_features( int* features )
     if( reg_ecx & bit_SSE3 )
         *features |= BLASFEO_PROCESSOR_FEATURE_SSE3;
 
+    // the OS has to save the AVX-512 state (opmask, upper ZMM and ZMM16-31) in XCR0
+    int os_avx512 = 0;
+    if( reg_ecx & bit_OSXSAVE )
+    {
+        unsigned int xcr0_eax, xcr0_edx;
+        __asm__ volatile( "xgetbv" : "=a" (xcr0_eax), "=d" (xcr0_edx) : "c" (0) );
+        os_avx512 = ( xcr0_eax & 0xe6 ) == 0xe6;
+    }
+
     // Test for extended features next in leaf 7 (subleaf 0)
 #if __GNUC__>5
     __get_cpuid_count( 7, 0, &reg_eax, &reg_ebx, &reg_ecx, &reg_edx );
@@ -182,6 +209,10 @@ int blasfeo_processor_cpu_features( int* features )
     // AVX2 is in the EBX register of leaf 7
     if( reg_ebx & bit_AVX2 )
         *features |= BLASFEO_PROCESSOR_FEATURE_AVX2;
+
+    // AVX512F is in the EBX register of leaf 7
+    if( ( reg_ebx & bit_AVX512F ) && os_avx512 )
+        *features |= BLASFEO_PROCESSOR_FEATURE_AVX512F;
 #endif  // #if defined(__GNUC__) || defined(__clang__)
 
 #endif // x86 processors
@@ -192,3 +223,203 @@ int blasfeo_processor_cpu_features( int* features )
 
     return ( libraryFeatures == ( *features & libraryFeatures ) ) ? 1 : 0;
 }
+
+
+
+#if defined(__linux__) && defined(EXT_DEP)
+// count the cpus in a sysfs cpu list (e.g. "0-5,12-17"); return 0 if not available
+static int cpu_list_count( const char* path )
+{
+    int first, last, count = 0;
+    char sep;
+    FILE *file = fopen( path, "r" );
+    if( file == NULL )
+        return 0;
+    while( fscanf( file, "%d", &first ) == 1 )
+    {
+        last = first;
+        sep = 0;
+        if( fscanf( file, "%c", &sep ) == 1 && sep == '-' )
+        {
+            if( fscanf( file, "%d", &last ) != 1 )
+                last = first;
+            sep = 0;
+            if( fscanf( file, "%c", &sep ) != 1 )
+                sep = 0;
+        }
+        count += last - first + 1;
+        if( sep != ',' )
+            break;
+    }
+    fclose( file );
+    return count;
+}
+
+
+
+// read the cache sizes of cpu0 from sysfs, and the number of cores sharing the last level cache;
+// return 0 if not available
+static int cache_sizes_sysfs( int* l1, int* l2, int* llc, int* llc_cores )
+{
+    char path[128];
+    char type[32];
+    char unit;
+    int idx, level, size, llc_level = 0, llc_idx = 0, cpus, threads;
+    FILE *file;
+
+    for( idx = 0; idx < 16; idx++ )
+    {
+        sprintf( path, "/sys/devices/system/cpu/cpu0/cache/index%d/level", idx );
+        file = fopen( path, "r" );
+        if( file == NULL )
+            break;
+        if( fscanf( file, "%d", &level ) != 1 )
+            level = 0;
+        fclose( file );
+
+        sprintf( path, "/sys/devices/system/cpu/cpu0/cache/index%d/type", idx );
+        file = fopen( path, "r" );
+        if( file == NULL )
+            continue;
+        if( fscanf( file, "%31s", type ) != 1 )
+            type[0] = 0;
+        fclose( file );
+        // skip instruction caches
+        if( type[0] == 'I' )
+            continue;
+
+        sprintf( path, "/sys/devices/system/cpu/cpu0/cache/index%d/size", idx );
+        file = fopen( path, "r" );
+        if( file == NULL )
+            continue;
+        unit = 0;
+        if( fscanf( file, "%d%c", &size, &unit ) < 1 )
+            size = 0;
+        fclose( file );
+        if( unit == 'K' )
+            size *= 1024;
+        else if( unit == 'M' )
+            size *= 1024 * 1024;
+
+        if( level == 1 )
+            *l1 = size;
+        if( level == 2 )
+            *l2 = size;
+        if( level >= llc_level )
+        {
+            llc_level = level;
+            llc_idx = idx;
+            *llc = size;
+        }
+    }
+
+    if( llc_level > 0 )
+    {
+        // logical cpus sharing the last level cache, over the hardware threads of each core
+        sprintf( path, "/sys/devices/system/cpu/cpu0/cache/index%d/shared_cpu_list", llc_idx );
+        cpus = cpu_list_count( path );
+        threads = cpu_list_count( "/sys/devices/system/cpu/cpu0/topology/thread_siblings_list" );
+        if( cpus > 0 && threads > 0 && cpus >= threads )
+            *llc_cores = cpus / threads;
+    }
+
+    return llc_level > 0;
+}
+#endif
+
+
+
+#if ( defined(__x86_64__) || defined(__i386__) ) && ( defined(__GNUC__) || defined(__clang__) ) && __GNUC__>5
+#include <cpuid.h>
+// read the cache sizes from the deterministic cache parameters leaf (4 on Intel, 0x8000001D on AMD),
+// and the number of cores sharing the last level cache
+static int cache_sizes_cpuid( int* l1, int* l2, int* llc, int* llc_cores )
+{
+    unsigned int reg_eax, reg_ebx, reg_ecx, reg_edx;
+    unsigned int leaves[2] = { 4, 0x8000001D };
+    unsigned int ii, sub, type, level, size, cpus = 0, threads = 1;
+    int llc_level = 0;
+
+    for( ii = 0; ii < 2 && llc_level == 0; ii++ )
+    {
+        if( __get_cpuid_max( leaves[ii] & 0x80000000, 0 ) < leaves[ii] )
+            continue;
+        for( sub = 0; sub < 16; sub++ )
+        {
+            __cpuid_count( leaves[ii], sub, reg_eax, reg_ebx, reg_ecx, reg_edx );
+            type = reg_eax & 0x1f;
+            // no more caches
+            if( type == 0 )
+                break;
+            // skip instruction caches
+            if( type == 2 )
+                continue;
+            level = ( reg_eax >> 5 ) & 0x7;
+            // ways * partitions * line size * sets
+            size = ( ( reg_ebx >> 22 ) + 1 ) * ( ( ( reg_ebx >> 12 ) & 0x3ff ) + 1 ) * ( ( reg_ebx & 0xfff ) + 1 ) * ( reg_ecx + 1 );
+            if( level == 1 )
+                *l1 = size;
+            if( level == 2 )
+                *l2 = size;
+            if( (int) level >= llc_level )
+            {
+                llc_level = level;
+                *llc = size;
+                // logical processors sharing the cache
+                cpus = ( ( reg_eax >> 14 ) & 0xfff ) + 1;
+            }
+        }
+    }
+
+    // hardware threads per core, from the SMT level of the extended topology leaf
+    if( __get_cpuid_max( 0, 0 ) >= 0xB )
+    {
+        __cpuid_count( 0xB, 0, reg_eax, reg_ebx, reg_ecx, reg_edx );
+        if( ( ( reg_ecx >> 8 ) & 0xff ) == 1 && ( reg_ebx & 0xffff ) > 0 )
+            threads = reg_ebx & 0xffff;
+    }
+    if( llc_level > 0 && cpus >= threads )
+        *llc_cores = cpus / threads;
+
+    return llc_level > 0;
+}
+#endif
+
+
+
+static void cache_sizes( int* l1, int* l2, int* llc, int* llc_cores )
+{
+    *l1 = 0;
+    *l2 = 0;
+    *llc = 0;
+    *llc_cores = 1;
+
+#if defined(__linux__) && defined(EXT_DEP)
+    if( cache_sizes_sysfs( l1, l2, llc, llc_cores ) )
+        return;
+#endif
+
+#if ( defined(__x86_64__) || defined(__i386__) ) && ( defined(__GNUC__) || defined(__clang__) ) && __GNUC__>5
+    if( cache_sizes_cpuid( l1, l2, llc, llc_cores ) )
+        return;
+#endif
+}
+
+
+
+void blasfeo_processor_cache_sizes( int* l1, int* l2, int* llc )
+{
+    int llc_cores;
+    cache_sizes( l1, l2, llc, &llc_cores );
+}
+
+
+
+void blasfeo_processor_cache_sizes_per_core( int* l1, int* l2, int* llc )
+{
+    int llc_cores;
+    cache_sizes( l1, l2, llc, &llc_cores );
+    // the last level cache is shared by the cores
+    if( llc_cores > 1 )
+        *llc /= llc_cores;
+}
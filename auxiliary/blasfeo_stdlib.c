@@ -36,12 +36,84 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#endif
 
 #include <blasfeo_stdlib.h>
 #include <blasfeo_block_size.h>
 
 
 
+// huge page mode, -1 if not read yet from the environment
+static int huge_pages = -1;
+
+
+
+void blasfeo_set_huge_pages(int mode)
+	{
+	huge_pages = mode;
+	return;
+	}
+
+
+
+int blasfeo_get_huge_pages()
+	{
+	if(huge_pages<0)
+		{
+		char *env = getenv("BLASFEO_HUGE_PAGES");
+		int mode = env!=NULL ? atoi(env) : BLASFEO_HUGE_PAGES_OFF;
+		huge_pages = mode>=0 ? mode : BLASFEO_HUGE_PAGES_OFF;
+		}
+	return huge_pages;
+	}
+
+
+
+#if defined(__linux__)
+
+// alignment of an allocation of size bytes: the huge page size if in huge page mode and the allocation spans one at least
+static size_t blasfeo_huge_pages_align(size_t size, size_t align)
+	{
+	if(blasfeo_get_huge_pages()!=BLASFEO_HUGE_PAGES_OFF & size>=BLASFEO_HUGE_PAGE_SIZE)
+		return BLASFEO_HUGE_PAGE_SIZE;
+	return align;
+	}
+
+
+
+// ask for transparent huge pages for the 2MB-aligned allocation
+static void blasfeo_huge_pages_advise(void *ptr, size_t size)
+	{
+#if defined(MADV_HUGEPAGE)
+	size_t page = sysconf(_SC_PAGESIZE);
+	madvise(ptr, (size+page-1) & ~(page-1), MADV_HUGEPAGE);
+#endif
+	return;
+	}
+
+
+
+// write the first byte of each page, so that no page fault is left to the computational routines
+static void blasfeo_huge_pages_prefault(void *ptr, size_t size)
+	{
+	if(blasfeo_get_huge_pages()!=BLASFEO_HUGE_PAGES_PREFAULT)
+		return;
+	size_t page = sysconf(_SC_PAGESIZE);
+	volatile char *ptr_c = ptr;
+	size_t ii;
+	for(ii=0; ii<size; ii+=page)
+		ptr_c[ii] = 0;
+	return;
+	}
+
+#endif // __linux__
+
+
+
 void blasfeo_malloc(void **ptr, size_t size)
 	{
 	*ptr = malloc(size);
@@ -67,6 +139,21 @@ void blasfeo_malloc_align(void **ptr, size_t size)
 
 	*ptr = memalign( CACHE_LINE_SIZE, size );
 
+#elif defined(__linux__)
+
+	size_t align = blasfeo_huge_pages_align(size, CACHE_LINE_SIZE);
+	int err = posix_memalign( ptr, align, size );
+	if(err!=0)
+		{
+		printf("Memory allocation error");
+		exit(1);
+		}
+	if(align==BLASFEO_HUGE_PAGE_SIZE)
+		{
+		blasfeo_huge_pages_advise(*ptr, size);
+		blasfeo_huge_pages_prefault(*ptr, size);
+		}
+
 #else
 
 	int err = posix_memalign( ptr, CACHE_LINE_SIZE, size );
@@ -108,3 +195,242 @@ void blasfeo_free_align(void *ptr)
 	return;
 
 	}
+
+
+
+/************************************************
+* NUMA placement
+************************************************/
+
+
+
+#if defined(__linux__) && defined(SYS_mbind)
+
+// memory policies of the mbind system call (linux/mempolicy.h)
+#define BLASFEO_MPOL_DEFAULT 0
+#define BLASFEO_MPOL_PREFERRED 1
+#define BLASFEO_MPOL_INTERLEAVE 3
+#define BLASFEO_MPOL_LOCAL 4
+#define BLASFEO_MPOL_MF_MOVE (1<<1)
+
+// max number of cpus in the cpu to node map
+#define BLASFEO_NUMA_MAX_CPUS 4096
+
+
+
+// number of nodes, and node of each cpu, read once from sysfs
+static int numa_num_nodes = 0;
+static unsigned char numa_cpu_node[BLASFEO_NUMA_MAX_CPUS];
+
+
+
+// parse a sysfs list as "0-3,8-11": flag[ii] is set for all listed ii<size; returns the max listed plus one
+static int blasfeo_numa_read_list(const char *path, unsigned char *flag, int size, int val)
+	{
+	FILE *file = fopen(path, "r");
+	if(file==NULL)
+		return 0;
+	int max = 0;
+	int i0, i1, ii;
+	char sep;
+	while(fscanf(file, "%d", &i0)==1)
+		{
+		i1 = i0;
+		sep = fgetc(file);
+		if(sep=='-')
+			{
+			if(fscanf(file, "%d", &i1)!=1)
+				break;
+			sep = fgetc(file);
+			}
+		for(ii=i0; ii<=i1 & ii<size; ii++)
+			flag[ii] = val;
+		max = i1+1>max ? i1+1 : max;
+		if(sep!=',')
+			break;
+		}
+	fclose(file);
+	return max;
+	}
+
+
+
+static void blasfeo_numa_init()
+	{
+	int ii;
+	char path[64];
+	unsigned char online[BLASFEO_NUMA_MAX_NODES];
+	int nnode = blasfeo_numa_read_list("/sys/devices/system/node/online", online, BLASFEO_NUMA_MAX_NODES, 1);
+	if(nnode<1)
+		nnode = 1;
+	if(nnode>BLASFEO_NUMA_MAX_NODES)
+		nnode = BLASFEO_NUMA_MAX_NODES;
+	for(ii=0; ii<BLASFEO_NUMA_MAX_CPUS; ii++)
+		numa_cpu_node[ii] = 0;
+	for(ii=1; ii<nnode; ii++)
+		{
+		snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", ii);
+		blasfeo_numa_read_list(path, numa_cpu_node, BLASFEO_NUMA_MAX_CPUS, ii);
+		}
+	// the map is complete before the number of nodes is published
+	__atomic_store_n(&numa_num_nodes, nnode, __ATOMIC_RELEASE);
+	return;
+	}
+
+
+
+int blasfeo_numa_num_nodes()
+	{
+	int nnode = __atomic_load_n(&numa_num_nodes, __ATOMIC_ACQUIRE);
+	if(nnode==0)
+		{
+		blasfeo_numa_init();
+		nnode = numa_num_nodes;
+		}
+	return nnode;
+	}
+
+
+
+int blasfeo_numa_node_of_cpu(int cpu)
+	{
+	blasfeo_numa_num_nodes();
+	if(cpu<0 | cpu>=BLASFEO_NUMA_MAX_CPUS)
+		return 0;
+	return numa_cpu_node[cpu];
+	}
+
+
+
+static int blasfeo_numa_mbind(void *ptr, size_t size, int mode, unsigned long *mask, int nnode)
+	{
+	if(size==0)
+		return 0;
+	size_t page = sysconf(_SC_PAGESIZE);
+	size_t addr0 = (size_t) ptr & ~(page-1);
+	size_t addr1 = ((size_t) ptr + size + page - 1) & ~(page-1);
+	if(syscall(SYS_mbind, (void *) addr0, addr1-addr0, mode, mask, mask==NULL ? 0 : nnode+1, BLASFEO_MPOL_MF_MOVE)!=0)
+		return -1;
+	return 0;
+	}
+
+
+
+int blasfeo_numa_bind_node(void *ptr, size_t size, int node)
+	{
+	int nnode = blasfeo_numa_num_nodes();
+	if(nnode<2)
+		return 0;
+	if(node<0 | node>=nnode)
+		return -1;
+	unsigned long mask[BLASFEO_NUMA_MAX_NODES/(8*sizeof(unsigned long))+1] = {0};
+	mask[node/(8*sizeof(unsigned long))] = 1ul << (node%(8*sizeof(unsigned long)));
+	return blasfeo_numa_mbind(ptr, size, BLASFEO_MPOL_PREFERRED, mask, nnode);
+	}
+
+
+
+int blasfeo_numa_bind(void *ptr, size_t size, int policy)
+	{
+	int ii;
+	int nnode = blasfeo_numa_num_nodes();
+	if(nnode<2)
+		return 0;
+	unsigned long mask[BLASFEO_NUMA_MAX_NODES/(8*sizeof(unsigned long))+1] = {0};
+	switch(policy)
+		{
+		case BLASFEO_NUMA_DEFAULT:
+			return blasfeo_numa_mbind(ptr, size, BLASFEO_MPOL_DEFAULT, NULL, nnode);
+		case BLASFEO_NUMA_LOCAL:
+			return blasfeo_numa_mbind(ptr, size, BLASFEO_MPOL_LOCAL, NULL, nnode);
+		case BLASFEO_NUMA_INTERLEAVE:
+			for(ii=0; ii<nnode; ii++)
+				mask[ii/(8*sizeof(unsigned long))] |= 1ul << (ii%(8*sizeof(unsigned long)));
+			return blasfeo_numa_mbind(ptr, size, BLASFEO_MPOL_INTERLEAVE, mask, nnode);
+		case BLASFEO_NUMA_PARTITION:
+			{
+			// chunk boundaries rounded to the page size
+			size_t page = sysconf(_SC_PAGESIZE);
+			size_t addr0 = (size_t) ptr;
+			size_t addr1;
+			int ret = 0;
+			for(ii=0; ii<nnode; ii++)
+				{
+				addr1 = ii==nnode-1 ? (size_t) ptr + size : ((size_t) ptr + size/nnode*(ii+1)) & ~(page-1);
+				if(addr1>addr0)
+					ret |= blasfeo_numa_bind_node((void *) addr0, addr1-addr0, ii);
+				addr0 = addr1>addr0 ? addr1 : addr0;
+				}
+			return ret;
+			}
+		default:
+			return -1;
+		}
+	}
+
+
+
+void blasfeo_malloc_align_numa(void **ptr, size_t size, int policy)
+	{
+	size_t page = sysconf(_SC_PAGESIZE);
+	// whole pages, not shared with other allocations
+	size = (size + page - 1) & ~(page-1);
+	size_t align = blasfeo_huge_pages_align(size, page);
+	int err = posix_memalign( ptr, align, size );
+	if(err!=0)
+		{
+		printf("Memory allocation error");
+		exit(1);
+		}
+	if(align==BLASFEO_HUGE_PAGE_SIZE)
+		blasfeo_huge_pages_advise(*ptr, size);
+	if(policy!=BLASFEO_NUMA_DEFAULT)
+		blasfeo_numa_bind(*ptr, size, policy);
+	if(align==BLASFEO_HUGE_PAGE_SIZE)
+		blasfeo_huge_pages_prefault(*ptr, size);
+	return;
+	}
+
+
+
+#else // __linux__
+
+
+
+int blasfeo_numa_num_nodes()
+	{
+	return 1;
+	}
+
+
+
+int blasfeo_numa_node_of_cpu(int cpu)
+	{
+	return 0;
+	}
+
+
+
+int blasfeo_numa_bind_node(void *ptr, size_t size, int node)
+	{
+	return node==0 ? 0 : -1;
+	}
+
+
+
+int blasfeo_numa_bind(void *ptr, size_t size, int policy)
+	{
+	return 0;
+	}
+
+
+
+void blasfeo_malloc_align_numa(void **ptr, size_t size, int policy)
+	{
+	blasfeo_malloc_align(ptr, size);
+	return;
+	}
+
+
+
+#endif // __linux__
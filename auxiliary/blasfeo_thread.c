@@ -0,0 +1,626 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+// pthread_setaffinity_np
+#define _GNU_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#if defined(MULTI_THREAD) && defined(__linux__)
+#include <sched.h>
+#endif
+
+#include <blasfeo_stdlib.h>
+#include <blasfeo_thread.h>
+
+
+
+// nested parallel regions are run by a single thread
+#if defined(__GNUC__) || defined(__clang__) || defined(__INTEL_COMPILER) || defined(__ICL) || defined(__ICC) || defined(__INTEL_LLVM_COMPILER)
+#define THREAD_LOCAL __thread
+#elif defined (_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL
+#endif
+
+
+
+// default number of iterations of busy-waiting before an idle thread sleeps
+#define BLASFEO_THREAD_SPIN 10000
+
+
+
+static int num_threads = 1;
+
+// operations with fewer flops are run on the calling thread
+static double thread_threshold = 0.0;
+
+// busy-waiting iterations, and exclusive mode (never sleep)
+static int spin_count = BLASFEO_THREAD_SPIN;
+static int exclusive = 0;
+
+#if defined(MULTI_THREAD)
+
+// the calling thread is running inside a parallel region
+static THREAD_LOCAL int in_parallel = 0;
+
+// cores of the pool threads
+static int affinity_num = 0;
+static int affinity_cpu[BLASFEO_MAX_THREADS];
+
+// the calling thread holds the pool
+static THREAD_LOCAL int pool_user = 0;
+
+#endif
+
+
+
+void blasfeo_set_num_threads(int nth)
+	{
+	if(nth<1)
+		nth = 1;
+	if(nth>BLASFEO_MAX_THREADS)
+		nth = BLASFEO_MAX_THREADS;
+	num_threads = nth;
+	return;
+	}
+
+
+
+int blasfeo_get_num_threads()
+	{
+#if defined(MULTI_THREAD)
+	if(in_parallel)
+		return 1;
+	return num_threads;
+#else
+	return 1;
+#endif
+	}
+
+
+
+void blasfeo_set_thread_threshold(double flops)
+	{
+	thread_threshold = flops;
+	return;
+	}
+
+
+
+int blasfeo_get_num_threads_flops(double flops)
+	{
+	if(flops<thread_threshold)
+		return 1;
+	return blasfeo_get_num_threads();
+	}
+
+
+
+int blasfeo_thread_numa_nodes(int nth, int *node)
+	{
+#if defined(MULTI_THREAD) && defined(__linux__)
+	int tid;
+	int nnode = blasfeo_numa_num_nodes();
+	// the pool threads are not pinned: their node is unknown
+	if(nnode<2 | affinity_num==0)
+		return 0;
+	int cpu = sched_getcpu();
+	if(cpu<0)
+		return 0;
+	node[0] = blasfeo_numa_node_of_cpu(cpu);
+	for(tid=1; tid<nth; tid++)
+		{
+		node[tid] = blasfeo_numa_node_of_cpu(affinity_cpu[(tid-1)%affinity_num]);
+		}
+	return nnode;
+#else
+	return 0;
+#endif
+	}
+
+
+
+void blasfeo_thread_numa_range(int tid, int nth, int *node, int nnode, int nb, int ba, int bb, int *b0, int *b1)
+	{
+
+	int ii, kk;
+	int count[BLASFEO_NUMA_MAX_NODES];
+	int rank = 0;
+	int c0, c1;
+
+	if(nnode<2 | nnode>BLASFEO_NUMA_MAX_NODES)
+		goto even;
+
+	for(kk=0; kk<nnode; kk++)
+		count[kk] = 0;
+	for(ii=0; ii<nth; ii++)
+		{
+		if(node[ii]<0 | node[ii]>=nnode)
+			goto even;
+		if(ii==tid)
+			rank = count[node[ii]];
+		count[node[ii]]++;
+		}
+
+	// every node owning some of the blocks needs a thread
+	for(kk=0; kk<nnode; kk++)
+		{
+		c0 = nb*kk/nnode;
+		c1 = nb*(kk+1)/nnode;
+		c0 = c0>ba ? c0 : ba;
+		c1 = c1<bb ? c1 : bb;
+		if(c0<c1 & count[kk]==0)
+			goto even;
+		}
+
+	// the blocks of the node are split over its threads
+	kk = node[tid];
+	c0 = nb*kk/nnode;
+	c1 = nb*(kk+1)/nnode;
+	c0 = c0>ba ? c0 : ba;
+	c1 = c1<bb ? c1 : bb;
+	if(c0>=c1)
+		{
+		*b0 = ba;
+		*b1 = ba;
+		return;
+		}
+	*b0 = c0 + (c1-c0)*rank/count[kk];
+	*b1 = c0 + (c1-c0)*(rank+1)/count[kk];
+	return;
+
+even:
+	*b0 = ba + (bb-ba)*tid/nth;
+	*b1 = ba + (bb-ba)*(tid+1)/nth;
+	return;
+
+	}
+
+
+
+#if ! defined(MULTI_THREAD)
+
+
+
+void blasfeo_set_thread_spin(int spin)
+	{
+	spin_count = spin;
+	return;
+	}
+
+
+
+void blasfeo_set_thread_exclusive(int excl)
+	{
+	exclusive = excl;
+	return;
+	}
+
+
+
+int blasfeo_set_thread_affinity(int ncpu, int *cpu)
+	{
+	return -1;
+	}
+
+
+
+void blasfeo_thread_pool_init()
+	{
+	return;
+	}
+
+
+
+void blasfeo_thread_pool_quit()
+	{
+	return;
+	}
+
+
+
+#else // MULTI_THREAD
+
+
+
+#define ATOMIC_LOAD(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define ATOMIC_STORE(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+#define ATOMIC_ADD(ptr, val) __atomic_add_fetch(ptr, val, __ATOMIC_ACQ_REL)
+
+
+
+// pool thread
+struct blasfeo_thread_worker
+	{
+	pthread_t thread;
+	void (*fun)(int tid, int nth, void *arg);
+	void *arg;
+	int nth;
+	int job; // incremented by the calling thread to start a job
+	};
+
+
+
+// persistent pool: the thread 0 of a parallel region is the calling thread, the threads 1, 2, ... are the pool ones
+struct blasfeo_thread_pool
+	{
+	struct blasfeo_thread_worker worker[BLASFEO_MAX_THREADS];
+	int size; // number of threads, including the calling one
+	int done; // number of pool threads done with the current job
+	int quit;
+	int users; // number of threads holding the pool, between blasfeo_thread_pool_init and blasfeo_thread_pool_quit
+	pthread_mutex_t run_mutex; // held by the thread using the pool
+	pthread_mutex_t mutex; // to sleep and to wake up
+	pthread_cond_t job_cond;
+	pthread_cond_t done_cond;
+	};
+
+
+
+static struct blasfeo_thread_pool pool =
+	{
+	.size = 1,
+	.done = 0,
+	.quit = 0,
+	.users = 0,
+	.run_mutex = PTHREAD_MUTEX_INITIALIZER,
+	.mutex = PTHREAD_MUTEX_INITIALIZER,
+	.job_cond = PTHREAD_COND_INITIALIZER,
+	.done_cond = PTHREAD_COND_INITIALIZER,
+	};
+
+
+
+static void blasfeo_cpu_relax()
+	{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+	__asm__ __volatile__("yield");
+#endif
+	return;
+	}
+
+
+
+// wait until *ptr==val: busy-wait first, then sleep on cond, unless in exclusive mode;
+// the value is updated before the cond is signaled holding the pool mutex
+static void blasfeo_thread_wait(int *ptr, int val, pthread_cond_t *cond)
+	{
+	int ii;
+	for(ii=0; ATOMIC_LOAD(ptr)!=val; ii++)
+		{
+		if(ii>=ATOMIC_LOAD(&spin_count) & !ATOMIC_LOAD(&exclusive))
+			{
+			pthread_mutex_lock(&pool.mutex);
+			while(ATOMIC_LOAD(ptr)!=val)
+				{
+				pthread_cond_wait(cond, &pool.mutex);
+				}
+			pthread_mutex_unlock(&pool.mutex);
+			return;
+			}
+		blasfeo_cpu_relax();
+		}
+	return;
+	}
+
+
+
+static void blasfeo_thread_wake(pthread_cond_t *cond)
+	{
+	pthread_mutex_lock(&pool.mutex);
+	pthread_cond_broadcast(cond);
+	pthread_mutex_unlock(&pool.mutex);
+	return;
+	}
+
+
+
+void blasfeo_set_thread_spin(int spin)
+	{
+	ATOMIC_STORE(&spin_count, spin);
+	return;
+	}
+
+
+
+void blasfeo_set_thread_exclusive(int excl)
+	{
+	ATOMIC_STORE(&exclusive, excl);
+	// leaving the exclusive mode, sleeping threads are woken up by the next job
+	return;
+	}
+
+
+
+// pin the pool thread tid according to the affinity list, or unpin it if empty
+static int blasfeo_thread_pin(int tid)
+	{
+#if defined(__linux__)
+	cpu_set_t set;
+	int ii;
+	CPU_ZERO(&set);
+	if(affinity_num>0)
+		{
+		CPU_SET(affinity_cpu[(tid-1)%affinity_num], &set);
+		}
+	else
+		{
+		for(ii=0; ii<CPU_SETSIZE; ii++)
+			CPU_SET(ii, &set);
+		}
+	return pthread_setaffinity_np(pool.worker[tid].thread, sizeof(cpu_set_t), &set);
+#else
+	return -1;
+#endif
+	}
+
+
+
+int blasfeo_set_thread_affinity(int ncpu, int *cpu)
+	{
+#if defined(__linux__)
+	int ii;
+	int ret = 0;
+	if(ncpu>BLASFEO_MAX_THREADS)
+		ncpu = BLASFEO_MAX_THREADS;
+	pthread_mutex_lock(&pool.run_mutex);
+	affinity_num = ncpu>0 ? ncpu : 0;
+	for(ii=0; ii<affinity_num; ii++)
+		affinity_cpu[ii] = cpu[ii];
+	// pin the running pool threads
+	for(ii=1; ii<pool.size; ii++)
+		{
+		if(blasfeo_thread_pin(ii)!=0)
+			ret = -1;
+		}
+	pthread_mutex_unlock(&pool.run_mutex);
+	return ret;
+#else
+	return -1;
+#endif
+	}
+
+
+
+static void *blasfeo_thread_pool_main(void *ptr)
+	{
+
+	struct blasfeo_thread_worker *worker = ptr;
+	int tid = worker - pool.worker;
+	int job = 0;
+
+	// the pool threads are always inside a parallel region
+	in_parallel = 1;
+
+	while(1)
+		{
+		job++;
+		blasfeo_thread_wait(&worker->job, job, &pool.job_cond);
+		if(ATOMIC_LOAD(&pool.quit))
+			break;
+		worker->fun(tid, worker->nth, worker->arg);
+		if(ATOMIC_ADD(&pool.done, 1)==worker->nth-1)
+			{
+			blasfeo_thread_wake(&pool.done_cond);
+			}
+		}
+
+	return NULL;
+
+	}
+
+
+
+// start pool threads up to a total of nth threads, holding the run mutex
+static void blasfeo_thread_pool_grow(int nth)
+	{
+	int tid;
+	for(tid=pool.size; tid<nth; tid++)
+		{
+		pool.worker[tid].job = 0;
+		if(pthread_create(&pool.worker[tid].thread, NULL, &blasfeo_thread_pool_main, &pool.worker[tid])!=0)
+			{
+			printf("\nerror: blasfeo_thread_pool: cannot create thread\n");
+			exit(1);
+			}
+		if(affinity_num>0)
+			blasfeo_thread_pin(tid);
+		pool.size = tid+1;
+		}
+	return;
+	}
+
+
+
+void blasfeo_thread_pool_init()
+	{
+	pthread_mutex_lock(&pool.run_mutex);
+	if(!pool_user)
+		{
+		pool.users++;
+		pool_user = 1;
+		}
+	blasfeo_thread_pool_grow(num_threads);
+	pthread_mutex_unlock(&pool.run_mutex);
+	return;
+	}
+
+
+
+void blasfeo_thread_pool_quit()
+	{
+	int tid;
+	pthread_mutex_lock(&pool.run_mutex);
+	if(pool_user)
+		{
+		pool.users--;
+		pool_user = 0;
+		}
+	// the pool threads are stopped by the last thread holding the pool
+	if(pool.users>0)
+		{
+		pthread_mutex_unlock(&pool.run_mutex);
+		return;
+		}
+	ATOMIC_STORE(&pool.quit, 1);
+	for(tid=1; tid<pool.size; tid++)
+		{
+		ATOMIC_ADD(&pool.worker[tid].job, 1);
+		}
+	blasfeo_thread_wake(&pool.job_cond);
+	for(tid=1; tid<pool.size; tid++)
+		{
+		pthread_join(pool.worker[tid].thread, NULL);
+		}
+	pool.size = 1;
+	ATOMIC_STORE(&pool.quit, 0);
+	pthread_mutex_unlock(&pool.run_mutex);
+	return;
+	}
+
+
+
+void blasfeo_barrier_init(struct blasfeo_barrier *bar, int nth)
+	{
+	pthread_mutex_init(&bar->mutex, NULL);
+	pthread_cond_init(&bar->cond, NULL);
+	bar->nth = nth;
+	bar->count = 0;
+	bar->phase = 0;
+	return;
+	}
+
+
+
+void blasfeo_barrier_wait(struct blasfeo_barrier *bar)
+	{
+	int ii;
+	pthread_mutex_lock(&bar->mutex);
+	int phase = bar->phase;
+	bar->count++;
+	if(bar->count==bar->nth)
+		{
+		// last thread to arrive releases the others
+		bar->count = 0;
+		ATOMIC_STORE(&bar->phase, phase+1);
+		pthread_cond_broadcast(&bar->cond);
+		pthread_mutex_unlock(&bar->mutex);
+		return;
+		}
+	pthread_mutex_unlock(&bar->mutex);
+	// busy-wait first, then sleep
+	for(ii=0; ATOMIC_LOAD(&bar->phase)==phase; ii++)
+		{
+		if(ii>=ATOMIC_LOAD(&spin_count) & !ATOMIC_LOAD(&exclusive))
+			{
+			pthread_mutex_lock(&bar->mutex);
+			while(bar->phase==phase)
+				{
+				pthread_cond_wait(&bar->cond, &bar->mutex);
+				}
+			pthread_mutex_unlock(&bar->mutex);
+			return;
+			}
+		blasfeo_cpu_relax();
+		}
+	return;
+	}
+
+
+
+void blasfeo_barrier_destroy(struct blasfeo_barrier *bar)
+	{
+	pthread_cond_destroy(&bar->cond);
+	pthread_mutex_destroy(&bar->mutex);
+	return;
+	}
+
+
+
+void blasfeo_parallel_run(int nth, void (*fun)(int tid, int nth, void *arg), void *arg)
+	{
+
+	int tid;
+
+	if(nth>BLASFEO_MAX_THREADS)
+		nth = BLASFEO_MAX_THREADS;
+
+	// nested parallel regions are run on the calling thread
+	if(nth<=1 | in_parallel)
+		{
+		fun(0, 1, arg);
+		return;
+		}
+
+	// wait for the pool if it is used by another thread
+	pthread_mutex_lock(&pool.run_mutex);
+
+	blasfeo_thread_pool_grow(nth);
+
+	// start the job on the pool threads
+	ATOMIC_STORE(&pool.done, 0);
+	for(tid=1; tid<nth; tid++)
+		{
+		pool.worker[tid].fun = fun;
+		pool.worker[tid].arg = arg;
+		pool.worker[tid].nth = nth;
+		ATOMIC_ADD(&pool.worker[tid].job, 1);
+		}
+	blasfeo_thread_wake(&pool.job_cond);
+
+	// the calling thread is the thread 0
+	in_parallel = 1;
+	fun(0, nth, arg);
+	in_parallel = 0;
+
+	blasfeo_thread_wait(&pool.done, nth-1, &pool.done_cond);
+
+	pthread_mutex_unlock(&pool.run_mutex);
+
+	return;
+
+	}
+
+
+
+#endif // MULTI_THREAD
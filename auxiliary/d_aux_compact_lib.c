@@ -0,0 +1,263 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_X64_INTEL_SKYLAKE_X)
+#include <mmintrin.h>
+#include <xmmintrin.h>  // SSE
+#include <emmintrin.h>  // SSE2
+#include <pmmintrin.h>  // SSE3
+#include <smmintrin.h>  // SSE4
+#include <immintrin.h>  // AVX
+#endif
+
+#include <blasfeo_common.h>
+#include <blasfeo_block_size.h>
+#include <blasfeo_d_aux.h>
+
+
+
+// return the memory size (in bytes) needed for a compact batch of nb matrices of size m*n
+size_t blasfeo_memsize_dmat_compact(int m, int n, int nb)
+	{
+	const int vl = D_VL;
+	int ng = (nb+vl-1)/vl;
+	size_t memsize = (size_t) ng*m*n*vl*sizeof(double);
+	memsize = (memsize + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+	return memsize;
+	}
+
+
+
+// create a compact batch of nb matrices of size m*n by using memory passed by a pointer
+void blasfeo_create_dmat_compact(int m, int n, int nb, struct blasfeo_dmat_compact *sA, void *memory)
+	{
+	const int vl = D_VL;
+	// the routines use aligned vector loads and stores of the D_VL interleaved matrices
+	if((size_t) memory & (vl*sizeof(double)-1))
+		{
+		printf("\nerror: blasfeo_create_dmat_compact: memory not aligned to %d bytes\n", (int) (vl*sizeof(double)));
+		exit(1);
+		}
+	sA->mem = memory;
+	sA->m = m;
+	sA->n = n;
+	sA->nb = nb;
+	sA->ng = (nb+vl-1)/vl;
+	sA->pA = (double *) memory;
+	size_t memsize = (size_t) sA->ng*m*n*vl*sizeof(double);
+	sA->memsize = (memsize + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+	return;
+	}
+
+
+
+// pack the nb column-major matrices A[ib] into the compact batch B
+void blasfeo_pack_dmat_compact(int m, int n, double **A, int lda, struct blasfeo_dmat_compact *sB, int bi, int bj)
+	{
+	if(m<=0 || n<=0)
+		return;
+
+	const int vl = D_VL;
+	int sdb = sB->m;
+	int gs = sB->m*sB->n*vl; // group stride
+	int nb = sB->nb;
+	int ib, ig, ii, jj, ll;
+	double *pB;
+
+#if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_X64_INTEL_SKYLAKE_X)
+	__m256d
+		a_0, a_1, a_2, a_3,
+		t_0, t_1, t_2, t_3;
+	double *A0, *A1, *A2, *A3;
+#endif
+
+	ig = 0;
+#if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_X64_INTEL_SKYLAKE_X)
+	// full groups: 4x4 transpose of 4 consecutive rows of the 4 matrices in the group
+	for(; ig<nb/vl; ig++)
+		{
+		A0 = A[ig*vl+0];
+		A1 = A[ig*vl+1];
+		A2 = A[ig*vl+2];
+		A3 = A[ig*vl+3];
+		for(jj=0; jj<n; jj++)
+			{
+			pB = sB->pA + ig*gs + (bi+(bj+jj)*sdb)*vl;
+			ii = 0;
+			for(; ii<m-3; ii+=4)
+				{
+				a_0 = _mm256_loadu_pd( &A0[ii+jj*lda] );
+				a_1 = _mm256_loadu_pd( &A1[ii+jj*lda] );
+				a_2 = _mm256_loadu_pd( &A2[ii+jj*lda] );
+				a_3 = _mm256_loadu_pd( &A3[ii+jj*lda] );
+				t_0 = _mm256_unpacklo_pd( a_0, a_1 );
+				t_1 = _mm256_unpackhi_pd( a_0, a_1 );
+				t_2 = _mm256_unpacklo_pd( a_2, a_3 );
+				t_3 = _mm256_unpackhi_pd( a_2, a_3 );
+				a_0 = _mm256_permute2f128_pd( t_0, t_2, 0x20 );
+				a_1 = _mm256_permute2f128_pd( t_1, t_3, 0x20 );
+				a_2 = _mm256_permute2f128_pd( t_0, t_2, 0x31 );
+				a_3 = _mm256_permute2f128_pd( t_1, t_3, 0x31 );
+				_mm256_store_pd( &pB[(ii+0)*vl], a_0 );
+				_mm256_store_pd( &pB[(ii+1)*vl], a_1 );
+				_mm256_store_pd( &pB[(ii+2)*vl], a_2 );
+				_mm256_store_pd( &pB[(ii+3)*vl], a_3 );
+				}
+			for(; ii<m; ii++)
+				{
+				pB[ii*vl+0] = A0[ii+jj*lda];
+				pB[ii*vl+1] = A1[ii+jj*lda];
+				pB[ii*vl+2] = A2[ii+jj*lda];
+				pB[ii*vl+3] = A3[ii+jj*lda];
+				}
+			}
+		}
+#endif
+	// remaining matrices
+	for(ib=ig*vl; ib<nb; ib++)
+		{
+		ll = ib%vl;
+		for(jj=0; jj<n; jj++)
+			{
+			pB = sB->pA + (ib/vl)*gs + (bi+(bj+jj)*sdb)*vl + ll;
+			for(ii=0; ii<m; ii++)
+				{
+				pB[ii*vl] = A[ib][ii+jj*lda];
+				}
+			}
+		}
+	// zero out the padding matrices of the last group, that are processed together with the others
+	for(ib=nb; ib<sB->ng*vl; ib++)
+		{
+		ll = ib%vl;
+		for(jj=0; jj<n; jj++)
+			{
+			pB = sB->pA + (ib/vl)*gs + (bi+(bj+jj)*sdb)*vl + ll;
+			for(ii=0; ii<m; ii++)
+				{
+				pB[ii*vl] = 0.0;
+				}
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// unpack the compact batch A into the nb column-major matrices B[ib]
+void blasfeo_unpack_dmat_compact(int m, int n, struct blasfeo_dmat_compact *sA, int ai, int aj, double **B, int ldb)
+	{
+	if(m<=0 || n<=0)
+		return;
+
+	const int vl = D_VL;
+	int sda = sA->m;
+	int gs = sA->m*sA->n*vl; // group stride
+	int nb = sA->nb;
+	int ib, ig, ii, jj, ll;
+	double *pA;
+
+#if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_X64_INTEL_SKYLAKE_X)
+	__m256d
+		a_0, a_1, a_2, a_3,
+		t_0, t_1, t_2, t_3;
+	double *B0, *B1, *B2, *B3;
+#endif
+
+	ig = 0;
+#if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_X64_INTEL_SKYLAKE_X)
+	// full groups: 4x4 transpose of 4 consecutive rows of the 4 matrices in the group
+	for(; ig<nb/vl; ig++)
+		{
+		B0 = B[ig*vl+0];
+		B1 = B[ig*vl+1];
+		B2 = B[ig*vl+2];
+		B3 = B[ig*vl+3];
+		for(jj=0; jj<n; jj++)
+			{
+			pA = sA->pA + ig*gs + (ai+(aj+jj)*sda)*vl;
+			ii = 0;
+			for(; ii<m-3; ii+=4)
+				{
+				a_0 = _mm256_load_pd( &pA[(ii+0)*vl] );
+				a_1 = _mm256_load_pd( &pA[(ii+1)*vl] );
+				a_2 = _mm256_load_pd( &pA[(ii+2)*vl] );
+				a_3 = _mm256_load_pd( &pA[(ii+3)*vl] );
+				t_0 = _mm256_unpacklo_pd( a_0, a_1 );
+				t_1 = _mm256_unpackhi_pd( a_0, a_1 );
+				t_2 = _mm256_unpacklo_pd( a_2, a_3 );
+				t_3 = _mm256_unpackhi_pd( a_2, a_3 );
+				a_0 = _mm256_permute2f128_pd( t_0, t_2, 0x20 );
+				a_1 = _mm256_permute2f128_pd( t_1, t_3, 0x20 );
+				a_2 = _mm256_permute2f128_pd( t_0, t_2, 0x31 );
+				a_3 = _mm256_permute2f128_pd( t_1, t_3, 0x31 );
+				_mm256_storeu_pd( &B0[ii+jj*ldb], a_0 );
+				_mm256_storeu_pd( &B1[ii+jj*ldb], a_1 );
+				_mm256_storeu_pd( &B2[ii+jj*ldb], a_2 );
+				_mm256_storeu_pd( &B3[ii+jj*ldb], a_3 );
+				}
+			for(; ii<m; ii++)
+				{
+				B0[ii+jj*ldb] = pA[ii*vl+0];
+				B1[ii+jj*ldb] = pA[ii*vl+1];
+				B2[ii+jj*ldb] = pA[ii*vl+2];
+				B3[ii+jj*ldb] = pA[ii*vl+3];
+				}
+			}
+		}
+#endif
+	// remaining matrices
+	for(ib=ig*vl; ib<nb; ib++)
+		{
+		ll = ib%vl;
+		for(jj=0; jj<n; jj++)
+			{
+			pA = sA->pA + (ib/vl)*gs + (ai+(aj+jj)*sda)*vl + ll;
+			for(ii=0; ii<m; ii++)
+				{
+				B[ib][ii+jj*ldb] = pA[ii*vl];
+				}
+			}
+		}
+
+	return;
+
+	}
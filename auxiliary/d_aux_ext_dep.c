@@ -35,10 +35,12 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <blasfeo_block_size.h>
 #include <blasfeo_common.h>
 #include <blasfeo_stdlib.h>
+#include <blasfeo_thread.h>
 #include <blasfeo_d_aux_ext_dep.h>
 #include <blasfeo_d_aux.h>
 
@@ -48,6 +50,7 @@
 #define CREATE_VEC blasfeo_create_dvec
 #define MEMSIZE_MAT blasfeo_memsize_dmat
 #define MEMSIZE_VEC blasfeo_memsize_dvec
+#define PS D_PS
 #define REAL double
 #define MAT blasfeo_dmat
 #define MATEL BLASFEO_DMATEL
@@ -59,6 +62,8 @@
 #define ALLOCATE_MAT blasfeo_allocate_dmat
 #define ALLOCATE_VEC blasfeo_allocate_dvec
 #define FREE_MAT blasfeo_free_dmat
+#define ALLOCATE_MAT_NUMA blasfeo_allocate_dmat_numa
+#define FIRST_TOUCH_MAT blasfeo_first_touch_dmat
 #define FREE_VEC blasfeo_free_dvec
 #define PRINT_MAT blasfeo_print_dmat
 #define PRINT_TRAN_MAT blasfeo_print_tran_dmat
@@ -80,3 +85,24 @@
 
 #include "x_aux_ext_dep.c"
 
+
+
+// create a compact batch of matrices by dynamically allocating the memory
+void blasfeo_allocate_dmat_compact(int m, int n, int nb, struct blasfeo_dmat_compact *sA)
+	{
+	size_t size = blasfeo_memsize_dmat_compact(m, n, nb);
+	void *mem;
+	blasfeo_malloc_align(&mem, size);
+	blasfeo_create_dmat_compact(m, n, nb, sA, mem);
+	return;
+	}
+
+
+
+// free memory of a compact batch of matrices
+void blasfeo_free_dmat_compact(struct blasfeo_dmat_compact *sA)
+	{
+	blasfeo_free_align(sA->mem);
+	return;
+	}
+
@@ -56,6 +56,8 @@
 #include <blasfeo_block_size.h>
 #include <blasfeo_d_aux.h>
 #include <blasfeo_d_kernel.h>
+#include <blasfeo_memory.h>
+#include <blasfeo_thread.h>
 #if defined(BLASFEO_REF_API)
 #include <blasfeo_d_aux_ref.h>
 #endif
@@ -1603,8 +1605,21 @@ void blasfeo_create_dvec(int m, struct blasfeo_dvec *sa, void *memory)
 
 
 
-// convert a matrix into a matrix structure
-void blasfeo_pack_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sA, int ai, int aj)
+#if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+// aligned store into a panel, bypassing the caches if nt
+static inline void blasfeo_dstore_lib4(double *ptr, __m256d v, int nt)
+	{
+	if(nt)
+		_mm256_stream_pd( ptr, v );
+	else
+		_mm256_store_pd( ptr, v );
+	}
+#endif
+
+
+
+// convert a matrix, scaled by alpha, into a matrix structure
+static void blasfeo_pack_sc_dmat_lib4(int m, int n, double alpha, double *A, int lda, struct blasfeo_dmat *sA, int ai, int aj, int nt)
 	{
 	if(m<=0 || n<=0)
 		return;
@@ -1624,14 +1639,16 @@ void blasfeo_pack_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sA
 		{
 		for(jj=0; jj<n; jj++)
 			{
-			pA[jj*bs] = A[jj*lda];
+			pA[jj*bs] = alpha*A[jj*lda];
 			}
 		return;
 		}
 
 #if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_X64_INTEL_SANDY_BRIDGE)
 	__m256d
-		tmp;
+		tmp,
+		v_alpha;
+	v_alpha = _mm256_set1_pd( alpha );
 #endif
 	m0 = (bs-ai%bs)%bs;
 	if(m0>m)
@@ -1647,10 +1664,10 @@ void blasfeo_pack_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sA
 			{
 			for( ; ii<m0; ii++)
 				{
-				pB[ii+bs*0] = B[ii+lda*0];
-				pB[ii+bs*1] = B[ii+lda*1];
-				pB[ii+bs*2] = B[ii+lda*2];
-				pB[ii+bs*3] = B[ii+lda*3];
+				pB[ii+bs*0] = alpha*B[ii+lda*0];
+				pB[ii+bs*1] = alpha*B[ii+lda*1];
+				pB[ii+bs*2] = alpha*B[ii+lda*2];
+				pB[ii+bs*3] = alpha*B[ii+lda*3];
 				}
 			B  += m0;
 			pB += m0 + bs*(sda-1);
@@ -1658,14 +1675,14 @@ void blasfeo_pack_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sA
 #if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_X64_INTEL_SANDY_BRIDGE)
 		for( ; ii<m-3; ii+=4)
 			{
-			tmp = _mm256_loadu_pd( &B[0+lda*0] );
-			_mm256_store_pd( &pB[0+bs*0], tmp );
-			tmp = _mm256_loadu_pd( &B[0+lda*1] );
-			_mm256_store_pd( &pB[0+bs*1], tmp );
-			tmp = _mm256_loadu_pd( &B[0+lda*2] );
-			_mm256_store_pd( &pB[0+bs*2], tmp );
-			tmp = _mm256_loadu_pd( &B[0+lda*3] );
-			_mm256_store_pd( &pB[0+bs*3], tmp );
+			tmp = _mm256_mul_pd( _mm256_loadu_pd( &B[0+lda*0] ), v_alpha );
+			blasfeo_dstore_lib4( &pB[0+bs*0], tmp, nt );
+			tmp = _mm256_mul_pd( _mm256_loadu_pd( &B[0+lda*1] ), v_alpha );
+			blasfeo_dstore_lib4( &pB[0+bs*1], tmp, nt );
+			tmp = _mm256_mul_pd( _mm256_loadu_pd( &B[0+lda*2] ), v_alpha );
+			blasfeo_dstore_lib4( &pB[0+bs*2], tmp, nt );
+			tmp = _mm256_mul_pd( _mm256_loadu_pd( &B[0+lda*3] ), v_alpha );
+			blasfeo_dstore_lib4( &pB[0+bs*3], tmp, nt );
 			B  += 4;
 			pB += bs*sda;
 			}
@@ -1673,25 +1690,25 @@ void blasfeo_pack_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sA
 		for( ; ii<m-3; ii+=4)
 			{
 			// col 0
-			pB[0+bs*0] = B[0+lda*0];
-			pB[1+bs*0] = B[1+lda*0];
-			pB[2+bs*0] = B[2+lda*0];
-			pB[3+bs*0] = B[3+lda*0];
+			pB[0+bs*0] = alpha*B[0+lda*0];
+			pB[1+bs*0] = alpha*B[1+lda*0];
+			pB[2+bs*0] = alpha*B[2+lda*0];
+			pB[3+bs*0] = alpha*B[3+lda*0];
 			// col 1
-			pB[0+bs*1] = B[0+lda*1];
-			pB[1+bs*1] = B[1+lda*1];
-			pB[2+bs*1] = B[2+lda*1];
-			pB[3+bs*1] = B[3+lda*1];
+			pB[0+bs*1] = alpha*B[0+lda*1];
+			pB[1+bs*1] = alpha*B[1+lda*1];
+			pB[2+bs*1] = alpha*B[2+lda*1];
+			pB[3+bs*1] = alpha*B[3+lda*1];
 			// col 2
-			pB[0+bs*2] = B[0+lda*2];
-			pB[1+bs*2] = B[1+lda*2];
-			pB[2+bs*2] = B[2+lda*2];
-			pB[3+bs*2] = B[3+lda*2];
+			pB[0+bs*2] = alpha*B[0+lda*2];
+			pB[1+bs*2] = alpha*B[1+lda*2];
+			pB[2+bs*2] = alpha*B[2+lda*2];
+			pB[3+bs*2] = alpha*B[3+lda*2];
 			// col 3
-			pB[0+bs*3] = B[0+lda*3];
-			pB[1+bs*3] = B[1+lda*3];
-			pB[2+bs*3] = B[2+lda*3];
-			pB[3+bs*3] = B[3+lda*3];
+			pB[0+bs*3] = alpha*B[0+lda*3];
+			pB[1+bs*3] = alpha*B[1+lda*3];
+			pB[2+bs*3] = alpha*B[2+lda*3];
+			pB[3+bs*3] = alpha*B[3+lda*3];
 			// update
 			B  += 4;
 			pB += bs*sda;
@@ -1700,13 +1717,13 @@ void blasfeo_pack_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sA
 		for( ; ii<m; ii++)
 			{
 			// col 0
-			pB[0+bs*0] = B[0+lda*0];
+			pB[0+bs*0] = alpha*B[0+lda*0];
 			// col 1
-			pB[0+bs*1] = B[0+lda*1];
+			pB[0+bs*1] = alpha*B[0+lda*1];
 			// col 2
-			pB[0+bs*2] = B[0+lda*2];
+			pB[0+bs*2] = alpha*B[0+lda*2];
 			// col 3
-			pB[0+bs*3] = B[0+lda*3];
+			pB[0+bs*3] = alpha*B[0+lda*3];
 			// update
 			B  += 1;
 			pB += 1;
@@ -1723,7 +1740,7 @@ void blasfeo_pack_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sA
 			{
 			for( ; ii<m0; ii++)
 				{
-				pB[ii+bs*0] = B[ii+lda*0];
+				pB[ii+bs*0] = alpha*B[ii+lda*0];
 				}
 			B  += m0;
 			pB += m0 + bs*(sda-1);
@@ -1731,10 +1748,10 @@ void blasfeo_pack_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sA
 		for( ; ii<m-3; ii+=4)
 			{
 			// col 0
-			pB[0+bs*0] = B[0+lda*0];
-			pB[1+bs*0] = B[1+lda*0];
-			pB[2+bs*0] = B[2+lda*0];
-			pB[3+bs*0] = B[3+lda*0];
+			pB[0+bs*0] = alpha*B[0+lda*0];
+			pB[1+bs*0] = alpha*B[1+lda*0];
+			pB[2+bs*0] = alpha*B[2+lda*0];
+			pB[3+bs*0] = alpha*B[3+lda*0];
 			// update
 			B  += 4;
 			pB += bs*sda;
@@ -1742,12 +1759,16 @@ void blasfeo_pack_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sA
 		for( ; ii<m; ii++)
 			{
 			// col 0
-			pB[0+bs*0] = B[0+lda*0];
+			pB[0+bs*0] = alpha*B[0+lda*0];
 			// update
 			B  += 1;
 			pB += 1;
 			}
 		}
+#if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(nt)
+		_mm_sfence();
+#endif
 	return;
 	}
 
@@ -2080,8 +2101,8 @@ void blasfeo_pack_u_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *
 
 
 
-// convert and transpose a matrix into a matrix structure
-void blasfeo_pack_tran_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sA, int ai, int aj)
+// convert and transpose a matrix, scaled by alpha, into a matrix structure
+static void blasfeo_pack_tran_sc_dmat_lib4(int m, int n, double alpha, double *A, int lda, struct blasfeo_dmat *sA, int ai, int aj, int nt)
 	{
 
 	// invalidate stored inverse diagonal
@@ -2099,7 +2120,7 @@ void blasfeo_pack_tran_dmat(int m, int n, double *A, int lda, struct blasfeo_dma
 		{
 		for(ii=0; ii<m; ii++)
 			{
-			pA[ii*bs] = A[ii];
+			pA[ii*bs] = alpha*A[ii];
 			}
 		return;
 		}
@@ -2107,7 +2128,9 @@ void blasfeo_pack_tran_dmat(int m, int n, double *A, int lda, struct blasfeo_dma
 #if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_X64_INTEL_SANDY_BRIDGE)
 	__m256d
 		v0, v1, v2, v3,
-		v4, v5, v6, v7;
+		v4, v5, v6, v7,
+		v_alpha;
+	v_alpha = _mm256_set1_pd( alpha );
 #endif
 	m0 = (bs-ai%bs)%bs;
 	if(m0>n)
@@ -2120,7 +2143,7 @@ void blasfeo_pack_tran_dmat(int m, int n, double *A, int lda, struct blasfeo_dma
 			{
 			for(i=0; i<m0; i++)
 				{
-				pA[i+j*bs+ii*sda] = A[j+(i+ii)*lda];
+				pA[i+j*bs+ii*sda] = alpha*A[j+(i+ii)*lda];
 				}
 			}
 		A  += m0*lda;
@@ -2135,25 +2158,25 @@ void blasfeo_pack_tran_dmat(int m, int n, double *A, int lda, struct blasfeo_dma
 #if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_X64_INTEL_SANDY_BRIDGE)
 		for(; j<m-3; j+=4)
 			{
-			v0 = _mm256_loadu_pd( &B[0+0*lda] ); // 00 10 20 30
-			v1 = _mm256_loadu_pd( &B[0+1*lda] ); // 01 11 21 31
+			v0 = _mm256_mul_pd( _mm256_loadu_pd( &B[0+0*lda] ), v_alpha ); // 00 10 20 30
+			v1 = _mm256_mul_pd( _mm256_loadu_pd( &B[0+1*lda] ), v_alpha ); // 01 11 21 31
 			v4 = _mm256_unpacklo_pd( v0, v1 ); // 00 01 20 21
 			v5 = _mm256_unpackhi_pd( v0, v1 ); // 10 11 30 31
-			v2 = _mm256_loadu_pd( &B[0+2*lda] ); // 02 12 22 32
-			v3 = _mm256_loadu_pd( &B[0+3*lda] ); // 03 13 23 33
+			v2 = _mm256_mul_pd( _mm256_loadu_pd( &B[0+2*lda] ), v_alpha ); // 02 12 22 32
+			v3 = _mm256_mul_pd( _mm256_loadu_pd( &B[0+3*lda] ), v_alpha ); // 03 13 23 33
 			v6 = _mm256_unpacklo_pd( v2, v3 ); // 02 03 22 23
 			v7 = _mm256_unpackhi_pd( v2, v3 ); // 12 13 32 33
 
 			B += 4;
 
 			v0 = _mm256_permute2f128_pd( v4, v6, 0x20 ); // 00 01 02 03
-			_mm256_store_pd( &pB[0+bs*0], v0 );
+			blasfeo_dstore_lib4( &pB[0+bs*0], v0, nt );
 			v2 = _mm256_permute2f128_pd( v4, v6, 0x31 ); // 20 21 22 23
-			_mm256_store_pd( &pB[0+bs*2], v2 );
+			blasfeo_dstore_lib4( &pB[0+bs*2], v2, nt );
 			v1 = _mm256_permute2f128_pd( v5, v7, 0x20 ); // 10 11 12 13
-			_mm256_store_pd( &pB[0+bs*1], v1 );
+			blasfeo_dstore_lib4( &pB[0+bs*1], v1, nt );
 			v3 = _mm256_permute2f128_pd( v5, v7, 0x31 ); // 30 31 32 33
-			_mm256_store_pd( &pB[0+bs*3], v3 );
+			blasfeo_dstore_lib4( &pB[0+bs*3], v3, nt );
 
 			pB += 4*bs;
 			}
@@ -2161,25 +2184,25 @@ void blasfeo_pack_tran_dmat(int m, int n, double *A, int lda, struct blasfeo_dma
 		for(; j<m-3; j+=4)
 			{
 			// unroll 0
-			pB[0+0*bs] = B[0+0*lda];
-			pB[1+0*bs] = B[0+1*lda];
-			pB[2+0*bs] = B[0+2*lda];
-			pB[3+0*bs] = B[0+3*lda];
+			pB[0+0*bs] = alpha*B[0+0*lda];
+			pB[1+0*bs] = alpha*B[0+1*lda];
+			pB[2+0*bs] = alpha*B[0+2*lda];
+			pB[3+0*bs] = alpha*B[0+3*lda];
 			// unroll 1
-			pB[0+1*bs] = B[1+0*lda];
-			pB[1+1*bs] = B[1+1*lda];
-			pB[2+1*bs] = B[1+2*lda];
-			pB[3+1*bs] = B[1+3*lda];
+			pB[0+1*bs] = alpha*B[1+0*lda];
+			pB[1+1*bs] = alpha*B[1+1*lda];
+			pB[2+1*bs] = alpha*B[1+2*lda];
+			pB[3+1*bs] = alpha*B[1+3*lda];
 			// unroll 2
-			pB[0+2*bs] = B[2+0*lda];
-			pB[1+2*bs] = B[2+1*lda];
-			pB[2+2*bs] = B[2+2*lda];
-			pB[3+2*bs] = B[2+3*lda];
+			pB[0+2*bs] = alpha*B[2+0*lda];
+			pB[1+2*bs] = alpha*B[2+1*lda];
+			pB[2+2*bs] = alpha*B[2+2*lda];
+			pB[3+2*bs] = alpha*B[2+3*lda];
 			// unroll 3
-			pB[0+3*bs] = B[3+0*lda];
-			pB[1+3*bs] = B[3+1*lda];
-			pB[2+3*bs] = B[3+2*lda];
-			pB[3+3*bs] = B[3+3*lda];
+			pB[0+3*bs] = alpha*B[3+0*lda];
+			pB[1+3*bs] = alpha*B[3+1*lda];
+			pB[2+3*bs] = alpha*B[3+2*lda];
+			pB[3+3*bs] = alpha*B[3+3*lda];
 			B  += 4;
 			pB += 4*bs;
 			}
@@ -2187,10 +2210,10 @@ void blasfeo_pack_tran_dmat(int m, int n, double *A, int lda, struct blasfeo_dma
 		for(; j<m; j++)
 			{
 			// unroll 0
-			pB[0+0*bs] = B[0+0*lda];
-			pB[1+0*bs] = B[0+1*lda];
-			pB[2+0*bs] = B[0+2*lda];
-			pB[3+0*bs] = B[0+3*lda];
+			pB[0+0*bs] = alpha*B[0+0*lda];
+			pB[1+0*bs] = alpha*B[0+1*lda];
+			pB[2+0*bs] = alpha*B[0+2*lda];
+			pB[3+0*bs] = alpha*B[0+3*lda];
 			B  += 1;
 			pB += 1*bs;
 			}
@@ -2203,10 +2226,14 @@ void blasfeo_pack_tran_dmat(int m, int n, double *A, int lda, struct blasfeo_dma
 			{
 			for(i=0; i<m2; i++)
 				{
-				pA[i+j*bs+ii*sda] = A[j+(i+ii)*lda];
+				pA[i+j*bs+ii*sda] = alpha*A[j+(i+ii)*lda];
 				}
 			}
 		}
+#if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(nt)
+		_mm_sfence();
+#endif
 	return;
 	}
 
@@ -2233,7 +2260,7 @@ void blasfeo_pack_dvec(int m, double *x, int xi, struct blasfeo_dvec *sa, int ai
 
 
 // convert a matrix structure into a matrix
-void blasfeo_unpack_dmat(int m, int n, struct blasfeo_dmat *sA, int ai, int aj, double *A, int lda)
+static void blasfeo_unpack_dmat_lib4(int m, int n, struct blasfeo_dmat *sA, int ai, int aj, double *A, int lda)
 	{
 	const int bs = 4;
 	int sda = sA->cn;
@@ -2355,7 +2382,7 @@ void blasfeo_unpack_dmat(int m, int n, struct blasfeo_dmat *sA, int ai, int aj,
 
 
 // convert and transpose a matrix structure into a matrix
-void blasfeo_unpack_tran_dmat(int m, int n, struct blasfeo_dmat *sA, int ai, int aj, double *A, int lda)
+static void blasfeo_unpack_tran_dmat_lib4(int m, int n, struct blasfeo_dmat *sA, int ai, int aj, double *A, int lda)
 	{
 	const int bs = 4;
 	int sda = sA->cn;
@@ -2489,6 +2516,196 @@ void blasfeo_unpack_tran_dmat(int m, int n, struct blasfeo_dmat *sA, int ai, int
 
 
 
+// pack (op 0), transpose and pack (op 1), unpack (op 2) or transpose and unpack (op 3):
+// the rows [i0,i1) of the matrix structure are processed, or the columns [i0,i1) for the unpack
+static void blasfeo_pack_dmat_blk(int op, int i0, int i1, int m, int n, double alpha, double *A, int lda, struct blasfeo_dmat *sB, int bi, int bj, int nt)
+	{
+	switch(op)
+		{
+		case 0:
+			blasfeo_pack_sc_dmat_lib4(i1-i0, n, alpha, A+i0, lda, sB, bi+i0, bj, nt);
+			break;
+		case 1:
+			blasfeo_pack_tran_sc_dmat_lib4(m, i1-i0, alpha, A+i0*lda, lda, sB, bi+i0, bj, nt);
+			break;
+		case 2:
+			blasfeo_unpack_dmat_lib4(m, i1-i0, sB, bi, bj+i0, A+i0*lda, lda);
+			break;
+		default:
+			blasfeo_unpack_tran_dmat_lib4(i1-i0, n, sB, bi+i0, bj, A+i0*lda, lda);
+			break;
+		}
+	return;
+	}
+
+
+
+#if defined(MULTI_THREAD)
+
+// min number of elements per thread
+#define PACK_MT_MIN (32*1024)
+
+
+
+struct blasfeo_pack_dmat_mt_arg
+	{
+	int op;
+	int m;
+	int n;
+	double alpha;
+	double *A;
+	int lda;
+	struct blasfeo_dmat *sB;
+	int bi;
+	int bj;
+	int d; // split dimension
+	int off; // offset of the split dimension in its first panel
+	int nt;
+	int nnode; // number of NUMA nodes, 0 if the node of the threads is unknown
+	int node[BLASFEO_MAX_THREADS]; // NUMA node of each thread
+	};
+
+
+
+// the split dimension is partitioned in whole panels, so that each thread writes its own panels;
+// the panel rows of the matrix structure go to the threads on the NUMA node owning them, as by blasfeo_allocate_dmat_numa
+static void blasfeo_pack_dmat_mt_work(int tid, int nth, void *ptr)
+	{
+	struct blasfeo_pack_dmat_mt_arg *arg = ptr;
+	const int bs = 4;
+	int np = (arg->off+arg->d+bs-1)/bs;
+	int p0, p1;
+	if(arg->op==2)
+		{
+		// blocks of columns of the matrix structure
+		blasfeo_thread_numa_range(tid, nth, arg->node, 0, np, 0, np, &p0, &p1);
+		}
+	else
+		{
+		int pa = arg->bi/bs;
+		blasfeo_thread_numa_range(tid, nth, arg->node, arg->nnode, arg->sB->pm/bs, pa, pa+np, &p0, &p1);
+		p0 -= pa;
+		p1 -= pa;
+		}
+	int i0 = p0*bs - arg->off;
+	int i1 = p1*bs - arg->off;
+	i0 = i0<0 ? 0 : i0;
+	i1 = i1<arg->d ? i1 : arg->d;
+	// private copy of the struct, the pack writes use_dA
+	struct blasfeo_dmat tB = *arg->sB;
+	if(i0<i1)
+		blasfeo_pack_dmat_blk(arg->op, i0, i1, arg->m, arg->n, arg->alpha, arg->A, arg->lda, &tB, arg->bi, arg->bj, arg->nt);
+	return;
+	}
+
+#endif // MULTI_THREAD
+
+
+
+static void blasfeo_pack_dmat_run(int op, int m, int n, double alpha, double *A, int lda, struct blasfeo_dmat *sB, int bi, int bj)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	const int bs = 4;
+
+	// invalidate stored inverse diagonal
+	if(op<2)
+		sB->use_dA = 0;
+
+	// split dimension: the rows of the matrix structure, or the columns of the matrix for the unpack
+	int d = op==0 | op==3 ? m : n;
+
+	int nt = 0;
+#if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	// the packed matrix does not fit in the LLC detected at run time: write it with non-temporal stores
+	int llc = blasfeo_get_llc_size();
+	nt = op<2 & llc>0 & (double) m*n*sizeof(double)>llc;
+#endif
+
+#if defined(MULTI_THREAD)
+	int off = op==2 ? 0 : bi%bs;
+	int nth = blasfeo_get_num_threads_flops((double) m*n);
+	int nth_max = (double) m*n/PACK_MT_MIN;
+	int np = (off+d+bs-1)/bs;
+	nth_max = nth_max<np ? nth_max : np;
+	nth = nth<nth_max ? nth : nth_max;
+	if(nth>1)
+		{
+		struct blasfeo_pack_dmat_mt_arg arg;
+		arg.op = op;
+		arg.m = m;
+		arg.n = n;
+		arg.alpha = alpha;
+		arg.A = A;
+		arg.lda = lda;
+		arg.sB = sB;
+		arg.bi = bi;
+		arg.bj = bj;
+		arg.d = d;
+		arg.off = off;
+		arg.nt = nt;
+		arg.nnode = blasfeo_thread_numa_nodes(nth, arg.node);
+		blasfeo_parallel_run(nth, &blasfeo_pack_dmat_mt_work, &arg);
+		return;
+		}
+#endif
+
+	blasfeo_pack_dmat_blk(op, 0, d, m, n, alpha, A, lda, sB, bi, bj, nt);
+
+	return;
+	}
+
+
+
+// convert a matrix into a matrix structure
+void blasfeo_pack_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sA, int ai, int aj)
+	{
+	blasfeo_pack_dmat_run(0, m, n, 1.0, A, lda, sA, ai, aj);
+	}
+
+
+
+// convert a matrix, scaled by alpha, into a matrix structure
+void blasfeo_pack_sc_dmat(int m, int n, double alpha, double *A, int lda, struct blasfeo_dmat *sA, int ai, int aj)
+	{
+	blasfeo_pack_dmat_run(0, m, n, alpha, A, lda, sA, ai, aj);
+	}
+
+
+
+// convert and transpose a matrix into a matrix structure
+void blasfeo_pack_tran_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sA, int ai, int aj)
+	{
+	blasfeo_pack_dmat_run(1, m, n, 1.0, A, lda, sA, ai, aj);
+	}
+
+
+
+// convert and transpose a matrix, scaled by alpha, into a matrix structure
+void blasfeo_pack_tran_sc_dmat(int m, int n, double alpha, double *A, int lda, struct blasfeo_dmat *sA, int ai, int aj)
+	{
+	blasfeo_pack_dmat_run(1, m, n, alpha, A, lda, sA, ai, aj);
+	}
+
+
+
+// convert a matrix structure into a matrix
+void blasfeo_unpack_dmat(int m, int n, struct blasfeo_dmat *sA, int ai, int aj, double *A, int lda)
+	{
+	blasfeo_pack_dmat_run(2, m, n, 1.0, A, lda, sA, ai, aj);
+	}
+
+
+
+// convert and transpose a matrix structure into a matrix
+void blasfeo_unpack_tran_dmat(int m, int n, struct blasfeo_dmat *sA, int ai, int aj, double *A, int lda)
+	{
+	blasfeo_pack_dmat_run(3, m, n, 1.0, A, lda, sA, ai, aj);
+	}
+
+
+
 // convert a vector structure into a vector
 void blasfeo_unpack_dvec(int m, struct blasfeo_dvec *sa, int ai, double *x, int xi)
 	{
@@ -37,10 +37,16 @@
 #include <stdio.h>
 #include <math.h>
 
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+#include <immintrin.h>
+#endif
+
 #include <blasfeo_common.h>
 #include <blasfeo_block_size.h>
 #include <blasfeo_d_aux.h>
 #include <blasfeo_d_kernel.h>
+#include <blasfeo_memory.h>
+#include <blasfeo_thread.h>
 #if defined(BLASFEO_REF_API)
 #include <blasfeo_d_aux_ref.h>
 #endif
@@ -139,104 +145,612 @@ void blasfeo_create_dvec(int m, struct blasfeo_dvec *sa, void *memory)
 
 
 
-// convert a matrix into a matrix structure
-void blasfeo_pack_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sA, int ai, int aj)
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+// aligned store of a panel column, bypassing the caches if nt
+static inline void blasfeo_dstore_lib8(double *ptr, __m512d v, int nt)
 	{
-#if defined(BLASFEO_REF_API)
-	blasfeo_ref_pack_dmat(m, n, A, lda, sA, ai, aj);
-#else
-	printf("\nblasfeo_pack_dmat: feature not implemented yet\n");
-	exit(1);
+	if(nt)
+		_mm512_stream_pd( ptr, v );
+	else
+		_mm512_store_pd( ptr, v );
+	}
+
+
+
+// in-place transpose of the 8x8 block with rows v[0], ..., v[7]
+static inline void blasfeo_dtran_8x8_lib8(__m512d *v)
+	{
+	const __m512i idx_l = _mm512_set_epi64( 13, 12, 5, 4, 9, 8, 1, 0 );
+	const __m512i idx_h = _mm512_set_epi64( 15, 14, 7, 6, 11, 10, 3, 2 );
+	const __m512i idx_ll = _mm512_set_epi64( 11, 10, 9, 8, 3, 2, 1, 0 );
+	const __m512i idx_hh = _mm512_set_epi64( 15, 14, 13, 12, 7, 6, 5, 4 );
+	__m512d t0, t1, t2, t3, t4, t5, t6, t7;
+	__m512d u0, u1, u2, u3, u4, u5, u6, u7;
+	t0 = _mm512_unpacklo_pd( v[0], v[1] ); // 00 10 02 12 04 14 06 16
+	t1 = _mm512_unpackhi_pd( v[0], v[1] ); // 01 11 03 13 05 15 07 17
+	t2 = _mm512_unpacklo_pd( v[2], v[3] );
+	t3 = _mm512_unpackhi_pd( v[2], v[3] );
+	t4 = _mm512_unpacklo_pd( v[4], v[5] );
+	t5 = _mm512_unpackhi_pd( v[4], v[5] );
+	t6 = _mm512_unpacklo_pd( v[6], v[7] );
+	t7 = _mm512_unpackhi_pd( v[6], v[7] );
+	u0 = _mm512_permutex2var_pd( t0, idx_l, t2 ); // 00 10 20 30 04 14 24 34
+	u2 = _mm512_permutex2var_pd( t0, idx_h, t2 ); // 02 12 22 32 06 16 26 36
+	u1 = _mm512_permutex2var_pd( t1, idx_l, t3 ); // 01 11 21 31 05 15 25 35
+	u3 = _mm512_permutex2var_pd( t1, idx_h, t3 ); // 03 13 23 33 07 17 27 37
+	u4 = _mm512_permutex2var_pd( t4, idx_l, t6 ); // 40 50 60 70 44 54 64 74
+	u6 = _mm512_permutex2var_pd( t4, idx_h, t6 );
+	u5 = _mm512_permutex2var_pd( t5, idx_l, t7 );
+	u7 = _mm512_permutex2var_pd( t5, idx_h, t7 );
+	v[0] = _mm512_permutex2var_pd( u0, idx_ll, u4 ); // 00 10 20 30 40 50 60 70
+	v[4] = _mm512_permutex2var_pd( u0, idx_hh, u4 ); // 04 14 24 34 44 54 64 74
+	v[1] = _mm512_permutex2var_pd( u1, idx_ll, u5 );
+	v[5] = _mm512_permutex2var_pd( u1, idx_hh, u5 );
+	v[2] = _mm512_permutex2var_pd( u2, idx_ll, u6 );
+	v[6] = _mm512_permutex2var_pd( u2, idx_hh, u6 );
+	v[3] = _mm512_permutex2var_pd( u3, idx_ll, u7 );
+	v[7] = _mm512_permutex2var_pd( u3, idx_hh, u7 );
+	return;
+	}
+#endif
+
+
+
+// convert a matrix, scaled by alpha, into a matrix structure
+static void blasfeo_pack_sc_dmat_lib8(int m, int n, double alpha, double *A, int lda, struct blasfeo_dmat *sA, int ai, int aj, int nt)
+	{
+	if(m<=0 || n<=0)
+		return;
+
+	// invalidate stored inverse diagonal
+	sA->use_dA = 0;
+
+	const int bs = 8;
+	int sda = sA->cn;
+	double *pA = sA->pA + aj*bs + ai/bs*bs*sda + ai%bs;
+	int i, ii, jj, m0, m1;
+	double *B, *pB;
+
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+	__m512d
+		tmp,
+		v_alpha;
+	v_alpha = _mm512_set1_pd( alpha );
+#endif
+
+	// first, partial panel
+	m0 = (bs-ai%bs)%bs;
+	if(m0>m)
+		m0 = m;
+	if(m0>0)
+		{
+		for(jj=0; jj<n; jj++)
+			{
+			for(i=0; i<m0; i++)
+				{
+				pA[i+jj*bs] = alpha*A[i+jj*lda];
+				}
+			}
+		A  += m0;
+		pA += m0 + bs*(sda-1);
+		}
+	m1 = m - m0;
+	ii = 0;
+	for(; ii<m1-7; ii+=8)
+		{
+		B  =  A + ii;
+		pB = pA + ii*sda;
+		jj = 0;
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+		for(; jj<n-3; jj+=4)
+			{
+			tmp = _mm512_mul_pd( _mm512_loadu_pd( &B[0+lda*0] ), v_alpha );
+			blasfeo_dstore_lib8( &pB[0+bs*0], tmp, nt );
+			tmp = _mm512_mul_pd( _mm512_loadu_pd( &B[0+lda*1] ), v_alpha );
+			blasfeo_dstore_lib8( &pB[0+bs*1], tmp, nt );
+			tmp = _mm512_mul_pd( _mm512_loadu_pd( &B[0+lda*2] ), v_alpha );
+			blasfeo_dstore_lib8( &pB[0+bs*2], tmp, nt );
+			tmp = _mm512_mul_pd( _mm512_loadu_pd( &B[0+lda*3] ), v_alpha );
+			blasfeo_dstore_lib8( &pB[0+bs*3], tmp, nt );
+			B  += 4*lda;
+			pB += 4*bs;
+			}
 #endif
+		for(; jj<n; jj++)
+			{
+			for(i=0; i<bs; i++)
+				{
+				pB[i] = alpha*B[i];
+				}
+			B  += lda;
+			pB += bs;
+			}
+		}
+	// last, partial panel
+	if(ii<m1)
+		{
+		for(jj=0; jj<n; jj++)
+			{
+			for(i=0; i<m1-ii; i++)
+				{
+				pA[i+jj*bs+ii*sda] = alpha*A[i+ii+jj*lda];
+				}
+			}
+		}
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+	if(nt)
+		_mm_sfence();
+#endif
+	return;
 	}
 
 
 
-// convert a lower triangular matrix into a matrix structure
-void blasfeo_pack_l_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sA, int ai, int aj)
+// convert and transpose a matrix, scaled by alpha, into a matrix structure
+static void blasfeo_pack_tran_sc_dmat_lib8(int m, int n, double alpha, double *A, int lda, struct blasfeo_dmat *sA, int ai, int aj, int nt)
 	{
-#if defined(BLASFEO_REF_API)
-	blasfeo_ref_pack_l_dmat(m, n, A, lda, sA, ai, aj);
-#else
-	printf("\nblasfeo_pack_l_dmat: feature not implemented yet\n");
-	exit(1);
+	if(m<=0 || n<=0)
+		return;
+
+	// invalidate stored inverse diagonal
+	sA->use_dA = 0;
+
+	const int bs = 8;
+	int sda = sA->cn;
+	double *pA = sA->pA + aj*bs + ai/bs*bs*sda + ai%bs;
+	int i, ii, jj, m0, m1;
+	double *B, *pB;
+
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+	__m512d
+		v[8],
+		v_alpha;
+	v_alpha = _mm512_set1_pd( alpha );
+#endif
+
+	// first, partial panel
+	m0 = (bs-ai%bs)%bs;
+	if(m0>n)
+		m0 = n;
+	if(m0>0)
+		{
+		for(jj=0; jj<m; jj++)
+			{
+			for(i=0; i<m0; i++)
+				{
+				pA[i+jj*bs] = alpha*A[jj+i*lda];
+				}
+			}
+		A  += m0*lda;
+		pA += m0 + bs*(sda-1);
+		}
+	m1 = n - m0;
+	ii = 0;
+	for(; ii<m1-7; ii+=8)
+		{
+		B  =  A + ii*lda;
+		pB = pA + ii*sda;
+		jj = 0;
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+		for(; jj<m-7; jj+=8)
+			{
+			for(i=0; i<8; i++)
+				v[i] = _mm512_mul_pd( _mm512_loadu_pd( &B[0+lda*i] ), v_alpha );
+			blasfeo_dtran_8x8_lib8( v );
+			for(i=0; i<8; i++)
+				blasfeo_dstore_lib8( &pB[0+bs*i], v[i], nt );
+			B  += 8;
+			pB += 8*bs;
+			}
+#endif
+		for(; jj<m; jj++)
+			{
+			for(i=0; i<bs; i++)
+				{
+				pB[i] = alpha*B[i*lda];
+				}
+			B  += 1;
+			pB += bs;
+			}
+		}
+	// last, partial panel
+	if(ii<m1)
+		{
+		for(jj=0; jj<m; jj++)
+			{
+			for(i=0; i<m1-ii; i++)
+				{
+				pA[i+jj*bs+ii*sda] = alpha*A[jj+(i+ii)*lda];
+				}
+			}
+		}
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+	if(nt)
+		_mm_sfence();
 #endif
+	return;
 	}
 
 
 
-// convert a upper triangular matrix into a matrix structure
-void blasfeo_pack_u_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sA, int ai, int aj)
+// convert a matrix structure into a matrix
+static void blasfeo_unpack_dmat_lib8(int m, int n, struct blasfeo_dmat *sA, int ai, int aj, double *A, int lda)
 	{
-#if defined(BLASFEO_REF_API)
-	blasfeo_ref_pack_u_dmat(m, n, A, lda, sA, ai, aj);
+	if(m<=0 || n<=0)
+		return;
+
+	const int bs = 8;
+	int sda = sA->cn;
+	double *pA = sA->pA + aj*bs + ai/bs*bs*sda + ai%bs;
+	int i, ii, jj, m0, m1;
+	double *B, *pB;
+
+	// first, partial panel
+	m0 = (bs-ai%bs)%bs;
+	if(m0>m)
+		m0 = m;
+	if(m0>0)
+		{
+		for(jj=0; jj<n; jj++)
+			{
+			for(i=0; i<m0; i++)
+				{
+				A[i+jj*lda] = pA[i+jj*bs];
+				}
+			}
+		A  += m0;
+		pA += m0 + bs*(sda-1);
+		}
+	m1 = m - m0;
+	ii = 0;
+	for(; ii<m1-7; ii+=8)
+		{
+		B  =  A + ii;
+		pB = pA + ii*sda;
+		for(jj=0; jj<n; jj++)
+			{
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+			_mm512_storeu_pd( &B[0], _mm512_load_pd( &pB[0] ) );
 #else
-	printf("\nblasfeo_pack_u_dmat: feature not implemented yet\n");
-	exit(1);
+			for(i=0; i<bs; i++)
+				{
+				B[i] = pB[i];
+				}
 #endif
+			B  += lda;
+			pB += bs;
+			}
+		}
+	// last, partial panel
+	if(ii<m1)
+		{
+		for(jj=0; jj<n; jj++)
+			{
+			for(i=0; i<m1-ii; i++)
+				{
+				A[i+ii+jj*lda] = pA[i+jj*bs+ii*sda];
+				}
+			}
+		}
+	return;
 	}
 
 
 
-// convert and transpose a matrix into a matrix structure
-void blasfeo_pack_tran_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sA, int ai, int aj)
+// convert and transpose a matrix structure into a matrix
+static void blasfeo_unpack_tran_dmat_lib8(int m, int n, struct blasfeo_dmat *sA, int ai, int aj, double *A, int lda)
 	{
-#if defined(BLASFEO_REF_API)
-	blasfeo_ref_pack_tran_dmat(m, n, A, lda, sA, ai, aj);
-#else
-	printf("\nblasfeo_pack_tran_dmat: feature not implemented yet\n");
-	exit(1);
+	if(m<=0 || n<=0)
+		return;
+
+	const int bs = 8;
+	int sda = sA->cn;
+	double *pA = sA->pA + aj*bs + ai/bs*bs*sda + ai%bs;
+	int i, ii, jj, m0, m1;
+	double *B, *pB;
+
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+	__m512d
+		v[8];
 #endif
+
+	// first, partial panel
+	m0 = (bs-ai%bs)%bs;
+	if(m0>m)
+		m0 = m;
+	if(m0>0)
+		{
+		for(jj=0; jj<n; jj++)
+			{
+			for(i=0; i<m0; i++)
+				{
+				A[jj+i*lda] = pA[i+jj*bs];
+				}
+			}
+		A  += m0*lda;
+		pA += m0 + bs*(sda-1);
+		}
+	m1 = m - m0;
+	ii = 0;
+	for(; ii<m1-7; ii+=8)
+		{
+		B  =  A + ii*lda;
+		pB = pA + ii*sda;
+		jj = 0;
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+		for(; jj<n-7; jj+=8)
+			{
+			for(i=0; i<8; i++)
+				v[i] = _mm512_load_pd( &pB[0+bs*i] );
+			blasfeo_dtran_8x8_lib8( v );
+			for(i=0; i<8; i++)
+				_mm512_storeu_pd( &B[0+lda*i], v[i] );
+			B  += 8;
+			pB += 8*bs;
+			}
+#endif
+		for(; jj<n; jj++)
+			{
+			for(i=0; i<bs; i++)
+				{
+				B[i*lda] = pB[i];
+				}
+			B  += 1;
+			pB += bs;
+			}
+		}
+	// last, partial panel
+	if(ii<m1)
+		{
+		for(jj=0; jj<n; jj++)
+			{
+			for(i=0; i<m1-ii; i++)
+				{
+				A[jj+(i+ii)*lda] = pA[i+jj*bs+ii*sda];
+				}
+			}
+		}
+	return;
 	}
 
 
 
-// convert a vector into a vector structure
-void blasfeo_pack_dvec(int m, double *x, int xi, struct blasfeo_dvec *sa, int ai)
+// pack (op 0), transpose and pack (op 1), unpack (op 2) or transpose and unpack (op 3):
+// the rows [i0,i1) of the matrix structure are processed, or the columns [i0,i1) for the unpack
+static void blasfeo_pack_dmat_blk(int op, int i0, int i1, int m, int n, double alpha, double *A, int lda, struct blasfeo_dmat *sB, int bi, int bj, int nt)
 	{
-	double *pa = sa->pa + ai;
-	int ii;
-	if(xi==1)
+	switch(op)
 		{
-		for(ii=0; ii<m; ii++)
-			pa[ii] = x[ii];
+		case 0:
+			blasfeo_pack_sc_dmat_lib8(i1-i0, n, alpha, A+i0, lda, sB, bi+i0, bj, nt);
+			break;
+		case 1:
+			blasfeo_pack_tran_sc_dmat_lib8(m, i1-i0, alpha, A+i0*lda, lda, sB, bi+i0, bj, nt);
+			break;
+		case 2:
+			blasfeo_unpack_dmat_lib8(m, i1-i0, sB, bi, bj+i0, A+i0*lda, lda);
+			break;
+		default:
+			blasfeo_unpack_tran_dmat_lib8(i1-i0, n, sB, bi+i0, bj, A+i0*lda, lda);
+			break;
+		}
+	return;
+	}
+
+
+
+#if defined(MULTI_THREAD)
+
+// min number of elements per thread
+#define PACK_MT_MIN (32*1024)
+
+
+
+struct blasfeo_pack_dmat_mt_arg
+	{
+	int op;
+	int m;
+	int n;
+	double alpha;
+	double *A;
+	int lda;
+	struct blasfeo_dmat *sB;
+	int bi;
+	int bj;
+	int d; // split dimension
+	int off; // offset of the split dimension in its first panel
+	int nt;
+	int nnode; // number of NUMA nodes, 0 if the node of the threads is unknown
+	int node[BLASFEO_MAX_THREADS]; // NUMA node of each thread
+	};
+
+
+
+// the split dimension is partitioned in whole panels, so that each thread writes its own panels;
+// the panel rows of the matrix structure go to the threads on the NUMA node owning them, as by blasfeo_allocate_dmat_numa
+static void blasfeo_pack_dmat_mt_work(int tid, int nth, void *ptr)
+	{
+	struct blasfeo_pack_dmat_mt_arg *arg = ptr;
+	const int bs = 8;
+	int np = (arg->off+arg->d+bs-1)/bs;
+	int p0, p1;
+	if(arg->op==2)
+		{
+		// blocks of columns of the matrix structure
+		blasfeo_thread_numa_range(tid, nth, arg->node, 0, np, 0, np, &p0, &p1);
 		}
 	else
 		{
-		for(ii=0; ii<m; ii++)
-			pa[ii] = x[ii*xi];
+		int pa = arg->bi/bs;
+		blasfeo_thread_numa_range(tid, nth, arg->node, arg->nnode, arg->sB->pm/bs, pa, pa+np, &p0, &p1);
+		p0 -= pa;
+		p1 -= pa;
 		}
+	int i0 = p0*bs - arg->off;
+	int i1 = p1*bs - arg->off;
+	i0 = i0<0 ? 0 : i0;
+	i1 = i1<arg->d ? i1 : arg->d;
+	// private copy of the struct, the pack writes use_dA
+	struct blasfeo_dmat tB = *arg->sB;
+	if(i0<i1)
+		blasfeo_pack_dmat_blk(arg->op, i0, i1, arg->m, arg->n, arg->alpha, arg->A, arg->lda, &tB, arg->bi, arg->bj, arg->nt);
 	return;
 	}
 
+#endif // MULTI_THREAD
+
+
+
+static void blasfeo_pack_dmat_run(int op, int m, int n, double alpha, double *A, int lda, struct blasfeo_dmat *sB, int bi, int bj)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	const int bs = 8;
+
+	// invalidate stored inverse diagonal
+	if(op<2)
+		sB->use_dA = 0;
+
+	// split dimension: the rows of the matrix structure, or the columns of the matrix for the unpack
+	int d = op==0 | op==3 ? m : n;
+
+	int nt = 0;
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+	// the packed matrix does not fit in the LLC detected at run time: write it with non-temporal stores
+	int llc = blasfeo_get_llc_size();
+	nt = op<2 & llc>0 & (double) m*n*sizeof(double)>llc;
+#endif
+
+#if defined(MULTI_THREAD)
+	int off = op==2 ? 0 : bi%bs;
+	int nth = blasfeo_get_num_threads_flops((double) m*n);
+	int nth_max = (double) m*n/PACK_MT_MIN;
+	int np = (off+d+bs-1)/bs;
+	nth_max = nth_max<np ? nth_max : np;
+	nth = nth<nth_max ? nth : nth_max;
+	if(nth>1)
+		{
+		struct blasfeo_pack_dmat_mt_arg arg;
+		arg.op = op;
+		arg.m = m;
+		arg.n = n;
+		arg.alpha = alpha;
+		arg.A = A;
+		arg.lda = lda;
+		arg.sB = sB;
+		arg.bi = bi;
+		arg.bj = bj;
+		arg.d = d;
+		arg.off = off;
+		arg.nt = nt;
+		arg.nnode = blasfeo_thread_numa_nodes(nth, arg.node);
+		blasfeo_parallel_run(nth, &blasfeo_pack_dmat_mt_work, &arg);
+		return;
+		}
+#endif
+
+	blasfeo_pack_dmat_blk(op, 0, d, m, n, alpha, A, lda, sB, bi, bj, nt);
+
+	return;
+	}
+
+
+
+// convert a matrix into a matrix structure
+void blasfeo_pack_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sA, int ai, int aj)
+	{
+	blasfeo_pack_dmat_run(0, m, n, 1.0, A, lda, sA, ai, aj);
+	}
+
+
+
+// convert a matrix, scaled by alpha, into a matrix structure
+void blasfeo_pack_sc_dmat(int m, int n, double alpha, double *A, int lda, struct blasfeo_dmat *sA, int ai, int aj)
+	{
+	blasfeo_pack_dmat_run(0, m, n, alpha, A, lda, sA, ai, aj);
+	}
+
+
+
+// convert and transpose a matrix into a matrix structure
+void blasfeo_pack_tran_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sA, int ai, int aj)
+	{
+	blasfeo_pack_dmat_run(1, m, n, 1.0, A, lda, sA, ai, aj);
+	}
+
+
+
+// convert and transpose a matrix, scaled by alpha, into a matrix structure
+void blasfeo_pack_tran_sc_dmat(int m, int n, double alpha, double *A, int lda, struct blasfeo_dmat *sA, int ai, int aj)
+	{
+	blasfeo_pack_dmat_run(1, m, n, alpha, A, lda, sA, ai, aj);
+	}
+
 
 
 // convert a matrix structure into a matrix
 void blasfeo_unpack_dmat(int m, int n, struct blasfeo_dmat *sA, int ai, int aj, double *A, int lda)
 	{
+	blasfeo_pack_dmat_run(2, m, n, 1.0, A, lda, sA, ai, aj);
+	}
+
+
+
+// convert and transpose a matrix structure into a matrix
+void blasfeo_unpack_tran_dmat(int m, int n, struct blasfeo_dmat *sA, int ai, int aj, double *A, int lda)
+	{
+	blasfeo_pack_dmat_run(3, m, n, 1.0, A, lda, sA, ai, aj);
+	}
+
+
+
+// convert a lower triangular matrix into a matrix structure
+void blasfeo_pack_l_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sA, int ai, int aj)
+	{
 #if defined(BLASFEO_REF_API)
-	blasfeo_ref_unpack_dmat(m, n, sA, ai, aj, A, lda);
+	blasfeo_ref_pack_l_dmat(m, n, A, lda, sA, ai, aj);
 #else
-	printf("\nblasfeo_unpack_dmat: feature not implemented yet\n");
+	printf("\nblasfeo_pack_l_dmat: feature not implemented yet\n");
 	exit(1);
 #endif
 	}
 
 
 
-// convert and transpose a matrix structure into a matrix
-void blasfeo_unpack_tran_dmat(int m, int n, struct blasfeo_dmat *sA, int ai, int aj, double *A, int lda)
+// convert a upper triangular matrix into a matrix structure
+void blasfeo_pack_u_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sA, int ai, int aj)
 	{
 #if defined(BLASFEO_REF_API)
-	blasfeo_ref_unpack_tran_dmat(m, n, sA, ai, aj, A, lda);
+	blasfeo_ref_pack_u_dmat(m, n, A, lda, sA, ai, aj);
 #else
-	printf("\nblasfeo_unpack_tran_dmat: feature not implemented yet\n");
+	printf("\nblasfeo_pack_u_dmat: feature not implemented yet\n");
 	exit(1);
 #endif
 	}
 
 
 
+// convert a vector into a vector structure
+void blasfeo_pack_dvec(int m, double *x, int xi, struct blasfeo_dvec *sa, int ai)
+	{
+	double *pa = sa->pa + ai;
+	int ii;
+	if(xi==1)
+		{
+		for(ii=0; ii<m; ii++)
+			pa[ii] = x[ii];
+		}
+	else
+		{
+		for(ii=0; ii<m; ii++)
+			pa[ii] = x[ii*xi];
+		}
+	return;
+	}
+
+
+
 // convert a vector structure into a vector
 void blasfeo_unpack_dvec(int m, struct blasfeo_dvec *sa, int ai, double *x, int xi)
 	{
@@ -50,6 +50,7 @@
 
 
 #define REF
+#define DOUBLE_PRECISION
 
 
 
@@ -85,7 +86,9 @@
 #define REF_PACK_MAT blasfeo_ref_pack_dmat
 #define REF_PACK_L_MAT blasfeo_ref_pack_l_dmat
 #define REF_PACK_U_MAT blasfeo_ref_pack_u_dmat
+#define REF_PACK_SC_MAT blasfeo_ref_pack_sc_dmat
 #define REF_PACK_TRAN_MAT blasfeo_ref_pack_tran_dmat
+#define REF_PACK_TRAN_SC_MAT blasfeo_ref_pack_tran_sc_dmat
 #define REF_PACK_VEC blasfeo_ref_pack_dvec
 #define REF_UNPACK_MAT blasfeo_ref_unpack_dmat
 #define REF_UNPACK_TRAN_MAT blasfeo_ref_unpack_tran_dmat
@@ -150,7 +153,9 @@
 #define PACK_MAT blasfeo_pack_dmat
 #define PACK_L_MAT blasfeo_pack_l_dmat
 #define PACK_U_MAT blasfeo_pack_u_dmat
+#define PACK_SC_MAT blasfeo_pack_sc_dmat
 #define PACK_TRAN_MAT blasfeo_pack_tran_dmat
+#define PACK_TRAN_SC_MAT blasfeo_pack_tran_sc_dmat
 #define PACK_VEC blasfeo_pack_dvec
 #define UNPACK_MAT blasfeo_unpack_dmat
 #define UNPACK_TRAN_MAT blasfeo_unpack_tran_dmat
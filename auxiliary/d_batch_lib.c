@@ -0,0 +1,341 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <blasfeo_common.h>
+#include <blasfeo_d_blasfeo_api.h>
+#include <blasfeo_thread.h>
+#if defined(LA_HIGH_PERFORMANCE) & defined(MF_PANELMAJ)
+#include <blasfeo_block_size.h>
+#include <blasfeo_d_kernel.h>
+#endif
+
+
+
+// minimum amount of flops assigned to each thread, below this the batch is processed by fewer threads
+#define MIN_FLOP_PER_THREAD 1000000
+
+
+
+// process the batch problems from ii0 to ii1-1
+static void blasfeo_dgemm_nt_batch_range(int m, int n, int k, double alpha, struct blasfeo_dmat **sA, int *ai, int *aj, struct blasfeo_dmat **sB, int *bi, int *bj, double beta, struct blasfeo_dmat **sC, int *ci, int *cj, struct blasfeo_dmat **sD, int *di, int *dj, int ii0, int ii1)
+	{
+
+	int ii;
+
+#if defined(LA_HIGH_PERFORMANCE) & defined(MF_PANELMAJ)
+
+	// problems fitting in one kernel: the kernel choice depends on the sizes only, so it is made once for the batch
+	if(m<=D_PS & n<=D_PS)
+		{
+		const int ps = D_PS;
+		double *pA, *pB, *pC, *pD;
+		int full = m==ps & n==ps;
+		for(ii=ii0; ii<ii1; ii++)
+			{
+			// problems with unaligned row offsets go through the full routine
+			if((ai[ii] | bi[ii] | ci[ii] | di[ii]) & (ps-1))
+				{
+				blasfeo_dgemm_nt(m, n, k, alpha, sA[ii], ai[ii], aj[ii], sB[ii], bi[ii], bj[ii], beta, sC[ii], ci[ii], cj[ii], sD[ii], di[ii], dj[ii]);
+				continue;
+				}
+			// invalidate stored inverse diagonal of result matrix
+			sD[ii]->use_dA = 0;
+			pA = sA[ii]->pA + aj[ii]*ps + ai[ii]*sA[ii]->cn;
+			pB = sB[ii]->pA + bj[ii]*ps + bi[ii]*sB[ii]->cn;
+			pC = sC[ii]->pA + cj[ii]*ps + ci[ii]*sC[ii]->cn;
+			pD = sD[ii]->pA + dj[ii]*ps + di[ii]*sD[ii]->cn;
+			if(full)
+				{
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+				kernel_dgemm_nt_8x8_lib8(k, &alpha, pA, pB, &beta, pC, pD);
+#else
+				kernel_dgemm_nt_4x4_lib4(k, &alpha, pA, pB, &beta, pC, pD);
+#endif
+				}
+			else
+				{
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+				kernel_dgemm_nt_8x8_vs_lib8(k, &alpha, pA, pB, &beta, pC, pD, m, n);
+#else
+				kernel_dgemm_nt_4x4_vs_lib4(k, &alpha, pA, pB, &beta, pC, pD, m, n);
+#endif
+				}
+			}
+		return;
+		}
+
+#elif defined(LA_HIGH_PERFORMANCE) & defined(MF_COLMAJ)
+
+	// the algorithm selection depends on the sizes only: plan once and execute on each problem
+	struct blasfeo_dplan plan;
+	blasfeo_dgemm_plan('n', 't', m, n, k, 0, 0, 0, 0, 0, 0, 0, 0, &plan);
+	for(ii=ii0; ii<ii1; ii++)
+		{
+		plan.ai = ai[ii];
+		plan.aj = aj[ii];
+		plan.bi = bi[ii];
+		plan.bj = bj[ii];
+		plan.ci = ci[ii];
+		plan.cj = cj[ii];
+		plan.di = di[ii];
+		plan.dj = dj[ii];
+		blasfeo_dgemm_execute(&plan, alpha, sA[ii], sB[ii], beta, sC[ii], sD[ii]);
+		}
+	return;
+
+#endif
+
+	for(ii=ii0; ii<ii1; ii++)
+		{
+		blasfeo_dgemm_nt(m, n, k, alpha, sA[ii], ai[ii], aj[ii], sB[ii], bi[ii], bj[ii], beta, sC[ii], ci[ii], cj[ii], sD[ii], di[ii], dj[ii]);
+		}
+
+	return;
+
+	}
+
+
+
+// process the batch problems from ii0 to ii1-1
+static void blasfeo_dpotrf_l_batch_range(int m, struct blasfeo_dmat **sC, int *ci, int *cj, struct blasfeo_dmat **sD, int *di, int *dj, int ii0, int ii1)
+	{
+
+	int ii;
+
+#if defined(LA_HIGH_PERFORMANCE) & defined(MF_PANELMAJ)
+
+	// problems fitting in one kernel: the kernel is called directly, without the checks of the full routine
+	if(m<=D_PS)
+		{
+		const int ps = D_PS;
+		double *pC, *pD;
+		for(ii=ii0; ii<ii1; ii++)
+			{
+			// problems with nonzero row offsets go through the full routine
+			if(ci[ii]!=0 | di[ii]!=0)
+				{
+				blasfeo_dpotrf_l(m, sC[ii], ci[ii], cj[ii], sD[ii], di[ii], dj[ii]);
+				continue;
+				}
+			sD[ii]->use_dA = dj[ii]==0 ? m : 0;
+			pC = sC[ii]->pA + cj[ii]*ps;
+			pD = sD[ii]->pA + dj[ii]*ps;
+			if(m==ps)
+				{
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+				kernel_dpotrf_nt_l_8x8_lib8(0, pD, pD, pC, pD, sD[ii]->dA);
+#else
+				kernel_dpotrf_nt_l_4x4_lib4(0, pD, pD, pC, pD, sD[ii]->dA);
+#endif
+				}
+			else
+				{
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+				kernel_dpotrf_nt_l_8x8_vs_lib8(0, pD, pD, pC, pD, sD[ii]->dA, m, m);
+#else
+				kernel_dpotrf_nt_l_4x4_vs_lib4(0, pD, pD, pC, pD, sD[ii]->dA, m, m);
+#endif
+				}
+			}
+		return;
+		}
+
+#endif
+
+	for(ii=ii0; ii<ii1; ii++)
+		{
+		blasfeo_dpotrf_l(m, sC[ii], ci[ii], cj[ii], sD[ii], di[ii], dj[ii]);
+		}
+
+	return;
+
+	}
+
+
+
+#if defined(MULTI_THREAD)
+
+struct blasfeo_dgemm_nt_batch_arg
+	{
+	struct blasfeo_dmat **sA;
+	struct blasfeo_dmat **sB;
+	struct blasfeo_dmat **sC;
+	struct blasfeo_dmat **sD;
+	int *ai;
+	int *aj;
+	int *bi;
+	int *bj;
+	int *ci;
+	int *cj;
+	int *di;
+	int *dj;
+	double alpha;
+	double beta;
+	int m;
+	int n;
+	int k;
+	int batch;
+	};
+
+
+
+static void blasfeo_dgemm_nt_batch_work(int tid, int nth, void *ptr)
+	{
+	struct blasfeo_dgemm_nt_batch_arg *arg = ptr;
+	// contiguous chunk of the batch
+	int bs = (arg->batch+nth-1)/nth;
+	int ii_end = (tid+1)*bs<arg->batch ? (tid+1)*bs : arg->batch;
+	blasfeo_dgemm_nt_batch_range(arg->m, arg->n, arg->k, arg->alpha, arg->sA, arg->ai, arg->aj, arg->sB, arg->bi, arg->bj, arg->beta, arg->sC, arg->ci, arg->cj, arg->sD, arg->di, arg->dj, tid*bs, ii_end);
+	return;
+	}
+
+
+
+struct blasfeo_dpotrf_l_batch_arg
+	{
+	struct blasfeo_dmat **sC;
+	struct blasfeo_dmat **sD;
+	int *ci;
+	int *cj;
+	int *di;
+	int *dj;
+	int m;
+	int batch;
+	};
+
+
+
+static void blasfeo_dpotrf_l_batch_work(int tid, int nth, void *ptr)
+	{
+	struct blasfeo_dpotrf_l_batch_arg *arg = ptr;
+	// contiguous chunk of the batch
+	int bs = (arg->batch+nth-1)/nth;
+	int ii_end = (tid+1)*bs<arg->batch ? (tid+1)*bs : arg->batch;
+	blasfeo_dpotrf_l_batch_range(arg->m, arg->sC, arg->ci, arg->cj, arg->sD, arg->di, arg->dj, tid*bs, ii_end);
+	return;
+	}
+
+
+
+// number of threads such that each one gets at least MIN_FLOP_PER_THREAD
+static int blasfeo_batch_nth(int batch, double flop)
+	{
+	int nth = blasfeo_get_num_threads_flops(flop*batch);
+	int nth_max = flop*batch/MIN_FLOP_PER_THREAD;
+	nth = nth<nth_max ? nth : nth_max;
+	nth = nth<batch ? nth : batch;
+	return nth;
+	}
+
+#endif
+
+
+
+void blasfeo_dgemm_nt_batch(int m, int n, int k, double alpha, struct blasfeo_dmat **sA, int *ai, int *aj, struct blasfeo_dmat **sB, int *bi, int *bj, double beta, struct blasfeo_dmat **sC, int *ci, int *cj, struct blasfeo_dmat **sD, int *di, int *dj, int batch)
+	{
+
+	if(m<=0 | n<=0 | batch<=0)
+		return;
+
+#if defined(MULTI_THREAD)
+	int nth = blasfeo_batch_nth(batch, 2.0*m*n*k);
+	if(nth>1)
+		{
+		struct blasfeo_dgemm_nt_batch_arg arg;
+		arg.sA = sA;
+		arg.sB = sB;
+		arg.sC = sC;
+		arg.sD = sD;
+		arg.ai = ai;
+		arg.aj = aj;
+		arg.bi = bi;
+		arg.bj = bj;
+		arg.ci = ci;
+		arg.cj = cj;
+		arg.di = di;
+		arg.dj = dj;
+		arg.alpha = alpha;
+		arg.beta = beta;
+		arg.m = m;
+		arg.n = n;
+		arg.k = k;
+		arg.batch = batch;
+		blasfeo_parallel_run(nth, &blasfeo_dgemm_nt_batch_work, &arg);
+		return;
+		}
+#endif
+
+	blasfeo_dgemm_nt_batch_range(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj, 0, batch);
+
+	return;
+
+	}
+
+
+
+void blasfeo_dpotrf_l_batch(int m, struct blasfeo_dmat **sC, int *ci, int *cj, struct blasfeo_dmat **sD, int *di, int *dj, int batch)
+	{
+
+	if(m<=0 | batch<=0)
+		return;
+
+#if defined(MULTI_THREAD)
+	int nth = blasfeo_batch_nth(batch, 1.0/3.0*m*m*m);
+	if(nth>1)
+		{
+		struct blasfeo_dpotrf_l_batch_arg arg;
+		arg.sC = sC;
+		arg.sD = sD;
+		arg.ci = ci;
+		arg.cj = cj;
+		arg.di = di;
+		arg.dj = dj;
+		arg.m = m;
+		arg.batch = batch;
+		blasfeo_parallel_run(nth, &blasfeo_dpotrf_l_batch_work, &arg);
+		return;
+		}
+#endif
+
+	blasfeo_dpotrf_l_batch_range(m, sC, ci, cj, sD, di, dj, 0, batch);
+
+	return;
+
+	}
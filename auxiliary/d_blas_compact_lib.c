@@ -0,0 +1,346 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <blasfeo_common.h>
+#include <blasfeo_block_size.h>
+#include <blasfeo_d_aux.h>
+#include <blasfeo_d_blasfeo_api.h>
+#if defined(LA_HIGH_PERFORMANCE)
+#include <blasfeo_d_kernel.h>
+#endif
+
+
+
+// the compact routines apply the operation to all the nb matrices of the batch,
+// one group of D_VL interleaved matrices at a time, vectorizing across the group
+
+#if defined(LA_HIGH_PERFORMANCE) & ( defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_X64_INTEL_SKYLAKE_X) )
+
+#define GEMM_NT_COMPACT kernel_dgemm_nt_compact_lib4
+#define GEMM_NN_COMPACT kernel_dgemm_nn_compact_lib4
+#define TRSM_NT_RL_INV_COMPACT kernel_dtrsm_nt_rl_inv_compact_lib4
+#define POTRF_L_COMPACT kernel_dpotrf_l_compact_lib4
+#define GETRF_NP_COMPACT kernel_dgetrf_np_compact_lib4
+
+#else
+
+#define GEMM_NT_COMPACT dgemm_nt_compact_lib
+#define GEMM_NN_COMPACT dgemm_nn_compact_lib
+#define TRSM_NT_RL_INV_COMPACT dtrsm_nt_rl_inv_compact_lib
+#define POTRF_L_COMPACT dpotrf_l_compact_lib
+#define GETRF_NP_COMPACT dgetrf_np_compact_lib
+
+
+
+static void dgemm_nt_compact_lib(int m, int n, int k, double *alpha, double *A, int lda, double *B, int ldb, double *beta, double *C, int ldc, double *D, int ldd)
+	{
+	const int vl = D_VL;
+	int ii, jj, ll, vv;
+	double d[D_VL];
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			for(vv=0; vv<vl; vv++)
+				d[vv] = 0.0;
+			for(ll=0; ll<k; ll++)
+				for(vv=0; vv<vl; vv++)
+					d[vv] += A[(ii+ll*lda)*vl+vv] * B[(jj+ll*ldb)*vl+vv];
+			if(beta[0]!=0.0)
+				for(vv=0; vv<vl; vv++)
+					D[(ii+jj*ldd)*vl+vv] = alpha[0]*d[vv] + beta[0]*C[(ii+jj*ldc)*vl+vv];
+			else
+				for(vv=0; vv<vl; vv++)
+					D[(ii+jj*ldd)*vl+vv] = alpha[0]*d[vv];
+			}
+		}
+	return;
+	}
+
+
+
+static void dgemm_nn_compact_lib(int m, int n, int k, double *alpha, double *A, int lda, double *B, int ldb, double *beta, double *C, int ldc, double *D, int ldd)
+	{
+	const int vl = D_VL;
+	int ii, jj, ll, vv;
+	double d[D_VL];
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			for(vv=0; vv<vl; vv++)
+				d[vv] = 0.0;
+			for(ll=0; ll<k; ll++)
+				for(vv=0; vv<vl; vv++)
+					d[vv] += A[(ii+ll*lda)*vl+vv] * B[(ll+jj*ldb)*vl+vv];
+			if(beta[0]!=0.0)
+				for(vv=0; vv<vl; vv++)
+					D[(ii+jj*ldd)*vl+vv] = alpha[0]*d[vv] + beta[0]*C[(ii+jj*ldc)*vl+vv];
+			else
+				for(vv=0; vv<vl; vv++)
+					D[(ii+jj*ldd)*vl+vv] = alpha[0]*d[vv];
+			}
+		}
+	return;
+	}
+
+
+
+static void dtrsm_nt_rl_inv_compact_lib(int m, int n, double *alpha, double *A, int lda, double *B, int ldb, double *D, int ldd)
+	{
+	const int vl = D_VL;
+	int ii, jj, ll, vv;
+	double d[D_VL], inv[D_VL];
+	for(jj=0; jj<n; jj++)
+		{
+		for(vv=0; vv<vl; vv++)
+			inv[vv] = 1.0/A[(jj+jj*lda)*vl+vv];
+		for(ii=0; ii<m; ii++)
+			{
+			for(vv=0; vv<vl; vv++)
+				d[vv] = alpha[0]*B[(ii+jj*ldb)*vl+vv];
+			for(ll=0; ll<jj; ll++)
+				for(vv=0; vv<vl; vv++)
+					d[vv] -= D[(ii+ll*ldd)*vl+vv] * A[(jj+ll*lda)*vl+vv];
+			for(vv=0; vv<vl; vv++)
+				D[(ii+jj*ldd)*vl+vv] = d[vv]*inv[vv];
+			}
+		}
+	return;
+	}
+
+
+
+static void dpotrf_l_compact_lib(int m, double *C, int ldc, double *D, int ldd)
+	{
+	const int vl = D_VL;
+	int ii, jj, ll, vv;
+	double d[D_VL], inv[D_VL];
+	for(jj=0; jj<m; jj++)
+		{
+		for(vv=0; vv<vl; vv++)
+			d[vv] = C[(jj+jj*ldc)*vl+vv];
+		for(ll=0; ll<jj; ll++)
+			for(vv=0; vv<vl; vv++)
+				d[vv] -= D[(jj+ll*ldd)*vl+vv] * D[(jj+ll*ldd)*vl+vv];
+		for(vv=0; vv<vl; vv++)
+			{
+			if(d[vv]>0.0)
+				{
+				d[vv] = sqrt(d[vv]);
+				inv[vv] = 1.0/d[vv];
+				}
+			else
+				{
+				d[vv] = 0.0;
+				inv[vv] = 0.0;
+				}
+			D[(jj+jj*ldd)*vl+vv] = d[vv];
+			}
+		for(ii=jj+1; ii<m; ii++)
+			{
+			for(vv=0; vv<vl; vv++)
+				d[vv] = C[(ii+jj*ldc)*vl+vv];
+			for(ll=0; ll<jj; ll++)
+				for(vv=0; vv<vl; vv++)
+					d[vv] -= D[(ii+ll*ldd)*vl+vv] * D[(jj+ll*ldd)*vl+vv];
+			for(vv=0; vv<vl; vv++)
+				D[(ii+jj*ldd)*vl+vv] = d[vv]*inv[vv];
+			}
+		}
+	return;
+	}
+
+
+
+static void dgetrf_np_compact_lib(int m, int n, double *C, int ldc, double *D, int ldd)
+	{
+	const int vl = D_VL;
+	int ii, jj, ll, vv;
+	int p = m<n ? m : n;
+	double d[D_VL], inv[D_VL];
+	for(jj=0; jj<n; jj++)
+		{
+		// upper part and diagonal
+		for(ii=0; ii<=jj & ii<m; ii++)
+			{
+			for(vv=0; vv<vl; vv++)
+				d[vv] = C[(ii+jj*ldc)*vl+vv];
+			for(ll=0; ll<ii; ll++)
+				for(vv=0; vv<vl; vv++)
+					d[vv] -= D[(ii+ll*ldd)*vl+vv] * D[(ll+jj*ldd)*vl+vv];
+			for(vv=0; vv<vl; vv++)
+				D[(ii+jj*ldd)*vl+vv] = d[vv];
+			}
+		if(jj>=p)
+			continue;
+		for(vv=0; vv<vl; vv++)
+			inv[vv] = 1.0/D[(jj+jj*ldd)*vl+vv];
+		// lower part
+		for(ii=jj+1; ii<m; ii++)
+			{
+			for(vv=0; vv<vl; vv++)
+				d[vv] = C[(ii+jj*ldc)*vl+vv];
+			for(ll=0; ll<jj; ll++)
+				for(vv=0; vv<vl; vv++)
+					d[vv] -= D[(ii+ll*ldd)*vl+vv] * D[(ll+jj*ldd)*vl+vv];
+			for(vv=0; vv<vl; vv++)
+				D[(ii+jj*ldd)*vl+vv] = d[vv]*inv[vv];
+			}
+		}
+	return;
+	}
+
+#endif
+
+
+
+// D <= beta * C + alpha * A * B^T
+void blasfeo_dgemm_nt_compact(int m, int n, int k, double alpha, struct blasfeo_dmat_compact *sA, int ai, int aj, struct blasfeo_dmat_compact *sB, int bi, int bj, double beta, struct blasfeo_dmat_compact *sC, int ci, int cj, struct blasfeo_dmat_compact *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+	const int vl = D_VL;
+	int ig;
+	int ng = sD->ng;
+	int gsa = sA->m*sA->n*vl;
+	int gsb = sB->m*sB->n*vl;
+	int gsc = sC->m*sC->n*vl;
+	int gsd = sD->m*sD->n*vl;
+	double *pA = sA->pA + (ai+aj*sA->m)*vl;
+	double *pB = sB->pA + (bi+bj*sB->m)*vl;
+	double *pC = sC->pA + (ci+cj*sC->m)*vl;
+	double *pD = sD->pA + (di+dj*sD->m)*vl;
+	for(ig=0; ig<ng; ig++)
+		{
+		GEMM_NT_COMPACT(m, n, k, &alpha, pA+ig*gsa, sA->m, pB+ig*gsb, sB->m, &beta, pC+ig*gsc, sC->m, pD+ig*gsd, sD->m);
+		}
+	return;
+	}
+
+
+
+// D <= beta * C + alpha * A * B
+void blasfeo_dgemm_nn_compact(int m, int n, int k, double alpha, struct blasfeo_dmat_compact *sA, int ai, int aj, struct blasfeo_dmat_compact *sB, int bi, int bj, double beta, struct blasfeo_dmat_compact *sC, int ci, int cj, struct blasfeo_dmat_compact *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+	const int vl = D_VL;
+	int ig;
+	int ng = sD->ng;
+	int gsa = sA->m*sA->n*vl;
+	int gsb = sB->m*sB->n*vl;
+	int gsc = sC->m*sC->n*vl;
+	int gsd = sD->m*sD->n*vl;
+	double *pA = sA->pA + (ai+aj*sA->m)*vl;
+	double *pB = sB->pA + (bi+bj*sB->m)*vl;
+	double *pC = sC->pA + (ci+cj*sC->m)*vl;
+	double *pD = sD->pA + (di+dj*sD->m)*vl;
+	for(ig=0; ig<ng; ig++)
+		{
+		GEMM_NN_COMPACT(m, n, k, &alpha, pA+ig*gsa, sA->m, pB+ig*gsb, sB->m, &beta, pC+ig*gsc, sC->m, pD+ig*gsd, sD->m);
+		}
+	return;
+	}
+
+
+
+// D <= alpha * B * A^{-T} , with A lower triangular employing explicit inverse of diagonal
+void blasfeo_dtrsm_rltn_compact(int m, int n, double alpha, struct blasfeo_dmat_compact *sA, int ai, int aj, struct blasfeo_dmat_compact *sB, int bi, int bj, struct blasfeo_dmat_compact *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+	const int vl = D_VL;
+	int ig;
+	int ng = sD->ng;
+	int gsa = sA->m*sA->n*vl;
+	int gsb = sB->m*sB->n*vl;
+	int gsd = sD->m*sD->n*vl;
+	double *pA = sA->pA + (ai+aj*sA->m)*vl;
+	double *pB = sB->pA + (bi+bj*sB->m)*vl;
+	double *pD = sD->pA + (di+dj*sD->m)*vl;
+	for(ig=0; ig<ng; ig++)
+		{
+		TRSM_NT_RL_INV_COMPACT(m, n, &alpha, pA+ig*gsa, sA->m, pB+ig*gsb, sB->m, pD+ig*gsd, sD->m);
+		}
+	return;
+	}
+
+
+
+// D <= chol( C ) ; C, D lower triangular
+void blasfeo_dpotrf_l_compact(int m, struct blasfeo_dmat_compact *sC, int ci, int cj, struct blasfeo_dmat_compact *sD, int di, int dj)
+	{
+	if(m<=0)
+		return;
+	const int vl = D_VL;
+	int ig;
+	int ng = sD->ng;
+	int gsc = sC->m*sC->n*vl;
+	int gsd = sD->m*sD->n*vl;
+	double *pC = sC->pA + (ci+cj*sC->m)*vl;
+	double *pD = sD->pA + (di+dj*sD->m)*vl;
+	for(ig=0; ig<ng; ig++)
+		{
+		POTRF_L_COMPACT(m, pC+ig*gsc, sC->m, pD+ig*gsd, sD->m);
+		}
+	return;
+	}
+
+
+
+// D <= lu( C ) ; no pivoting
+void blasfeo_dgetrf_np_compact(int m, int n, struct blasfeo_dmat_compact *sC, int ci, int cj, struct blasfeo_dmat_compact *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+	const int vl = D_VL;
+	int ig;
+	int ng = sD->ng;
+	int gsc = sC->m*sC->n*vl;
+	int gsd = sD->m*sD->n*vl;
+	double *pC = sC->pA + (ci+cj*sC->m)*vl;
+	double *pD = sD->pA + (di+dj*sD->m)*vl;
+	for(ig=0; ig<ng; ig++)
+		{
+		GETRF_NP_COMPACT(m, n, pC+ig*gsc, sC->m, pD+ig*gsd, sD->m);
+		}
+	return;
+	}
@@ -0,0 +1,1059 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <blasfeo_common.h>
+#include <blasfeo_block_size.h>
+#include <blasfeo_d_aux.h>
+#include <blasfeo_d_blasfeo_api.h>
+#include <blasfeo_memory.h>
+#include <blasfeo_thread.h>
+#if defined(LA_HIGH_PERFORMANCE)
+#include <blasfeo_d_blasfeo_hp_api.h>
+#endif
+
+
+
+// max number of matrix and vector arguments accessed by a recorded call
+#define MAX_ACCESS 4
+
+// routines called at replay: the high-performance ones are called directly, skipping the public wrappers
+#if defined(LA_HIGH_PERFORMANCE)
+#define GEMM_NN blasfeo_hp_dgemm_nn
+#define GEMM_NT blasfeo_hp_dgemm_nt
+#define SYRK_LN blasfeo_hp_dsyrk_ln
+#define SYRK_LN_MN blasfeo_hp_dsyrk_ln_mn
+#define TRMM_RLNN blasfeo_hp_dtrmm_rlnn
+#define TRMM_RUTN blasfeo_hp_dtrmm_rutn
+#define TRSM_RLTN blasfeo_hp_dtrsm_rltn
+#define POTRF_L blasfeo_hp_dpotrf_l
+#define POTRF_L_MN blasfeo_hp_dpotrf_l_mn
+#define SYRK_POTRF_LN blasfeo_hp_dsyrk_dpotrf_ln
+#define SYRK_POTRF_LN_MN blasfeo_hp_dsyrk_dpotrf_ln_mn
+#define GEMV_N blasfeo_hp_dgemv_n
+#define GEMV_T blasfeo_hp_dgemv_t
+#define TRSV_LNN blasfeo_hp_dtrsv_lnn
+#define TRSV_LTN blasfeo_hp_dtrsv_ltn
+#define TRSV_LNN_MN blasfeo_hp_dtrsv_lnn_mn
+#define TRSV_LTN_MN blasfeo_hp_dtrsv_ltn_mn
+#define TRMV_LNN blasfeo_hp_dtrmv_lnn
+#define TRMV_LTN blasfeo_hp_dtrmv_ltn
+#define AXPY blasfeo_hp_daxpy
+#else
+#define GEMM_NN blasfeo_dgemm_nn
+#define GEMM_NT blasfeo_dgemm_nt
+#define SYRK_LN blasfeo_dsyrk_ln
+#define SYRK_LN_MN blasfeo_dsyrk_ln_mn
+#define TRMM_RLNN blasfeo_dtrmm_rlnn
+#define TRMM_RUTN blasfeo_dtrmm_rutn
+#define TRSM_RLTN blasfeo_dtrsm_rltn
+#define POTRF_L blasfeo_dpotrf_l
+#define POTRF_L_MN blasfeo_dpotrf_l_mn
+#define SYRK_POTRF_LN blasfeo_dsyrk_dpotrf_ln
+#define SYRK_POTRF_LN_MN blasfeo_dsyrk_dpotrf_ln_mn
+#define GEMV_N blasfeo_dgemv_n
+#define GEMV_T blasfeo_dgemv_t
+#define TRSV_LNN blasfeo_dtrsv_lnn
+#define TRSV_LTN blasfeo_dtrsv_ltn
+#define TRSV_LNN_MN blasfeo_dtrsv_lnn_mn
+#define TRSV_LTN_MN blasfeo_dtrsv_ltn_mn
+#define TRMV_LNN blasfeo_dtrmv_lnn
+#define TRMV_LTN blasfeo_dtrmv_ltn
+#define AXPY blasfeo_daxpy
+#endif
+
+
+
+// block of a matrix or vector structure accessed by a recorded call
+struct blasfeo_dgraph_access
+	{
+	void *str; // matrix or vector structure
+	char *mem0; // memory of the structure
+	char *mem1;
+	int i0; // rows [i0,i1) and columns [j0,j1) of the block
+	int i1;
+	int j0;
+	int j1;
+	int write; // the block is written (and the use_dA field of the structure reset)
+	int diag; // the dA and use_dA fields of the structure are read or written
+	};
+
+
+
+// recorded call: arguments, accessed blocks, and the routine (or its execution plan) resolved at record time
+struct blasfeo_dgraph_node
+	{
+	void (*fun)(struct blasfeo_dgraph_node *node);
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_COLMAJ) )
+	struct blasfeo_dplan plan;
+#endif
+	struct blasfeo_dmat *sA;
+	struct blasfeo_dmat *sB;
+	struct blasfeo_dmat *sC;
+	struct blasfeo_dmat *sD;
+	struct blasfeo_dvec *sx;
+	struct blasfeo_dvec *sy;
+	struct blasfeo_dvec *sz;
+	double alpha;
+	double beta;
+	double flops;
+	size_t worksize;
+	struct blasfeo_dgraph_access acc[MAX_ACCESS];
+	int n_acc;
+	int m;
+	int n;
+	int k;
+	int ai;
+	int aj;
+	int bi;
+	int bj;
+	int ci;
+	int cj;
+	int di;
+	int dj;
+	int xi;
+	int yi;
+	int zi;
+	int level;
+	int tid;
+	};
+
+
+
+size_t blasfeo_dgraph_memsize(int max_node)
+	{
+	size_t memsize = (size_t) max_node*(sizeof(struct blasfeo_dgraph_node)+3*sizeof(int)) + sizeof(int);
+	memsize = (memsize + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+	return memsize;
+	}
+
+
+
+void blasfeo_dgraph_create(int max_node, struct blasfeo_dgraph *sG, void *memory)
+	{
+	char *c_ptr = memory;
+	sG->node = (struct blasfeo_dgraph_node *) c_ptr;
+	c_ptr += max_node*sizeof(struct blasfeo_dgraph_node);
+	sG->perm = (int *) c_ptr;
+	c_ptr += max_node*sizeof(int);
+	sG->lev_nth = (int *) c_ptr;
+	c_ptr += max_node*sizeof(int);
+	sG->lev_ptr = (int *) c_ptr;
+	sG->max_node = max_node;
+	sG->memsize = blasfeo_dgraph_memsize(max_node);
+	blasfeo_dgraph_begin(sG);
+	return;
+	}
+
+
+
+void blasfeo_dgraph_begin(struct blasfeo_dgraph *sG)
+	{
+	sG->n_node = 0;
+	sG->n_lev = 0;
+	sG->n_slot = 0;
+	sG->slotsize = 0;
+	sG->compiled = 0;
+	return;
+	}
+
+
+
+/************************************************
+* record
+************************************************/
+
+static struct blasfeo_dgraph_node *blasfeo_dgraph_new_node(struct blasfeo_dgraph *sG, void (*fun)(struct blasfeo_dgraph_node *node))
+	{
+	if(sG->n_node>=sG->max_node)
+		{
+		printf("\nerror: blasfeo_dgraph: more than max_node=%d recorded calls\n", sG->max_node);
+		exit(1);
+		}
+	// the plan has to be compiled again
+	sG->compiled = 0;
+	struct blasfeo_dgraph_node *node = sG->node+sG->n_node;
+	sG->n_node++;
+	node->fun = fun;
+	node->flops = 0.0;
+	node->worksize = 0;
+	node->n_acc = 0;
+	return node;
+	}
+
+
+
+static void blasfeo_dgraph_mat(struct blasfeo_dgraph_node *node, struct blasfeo_dmat *sA, int ai, int aj, int m, int n, int write, int diag)
+	{
+	struct blasfeo_dgraph_access *acc = node->acc+node->n_acc;
+	node->n_acc++;
+	acc->str = sA;
+	acc->mem0 = (char *) sA->mem;
+	acc->mem1 = acc->mem0 + sA->memsize;
+	acc->i0 = ai;
+	acc->i1 = ai + (m>0 ? m : 0);
+	acc->j0 = aj;
+	acc->j1 = aj + (n>0 ? n : 0);
+	acc->write = write;
+	acc->diag = diag;
+	return;
+	}
+
+
+
+static void blasfeo_dgraph_vec(struct blasfeo_dgraph_node *node, struct blasfeo_dvec *sx, int xi, int m, int write)
+	{
+	struct blasfeo_dgraph_access *acc = node->acc+node->n_acc;
+	node->n_acc++;
+	acc->str = sx;
+	acc->mem0 = (char *) sx->mem;
+	acc->mem1 = acc->mem0 + sx->memsize;
+	acc->i0 = xi;
+	acc->i1 = xi + (m>0 ? m : 0);
+	acc->j0 = 0;
+	acc->j1 = 1;
+	acc->write = write;
+	acc->diag = 0;
+	return;
+	}
+
+
+
+static void blasfeo_dgraph_exec_dgemm_nn(struct blasfeo_dgraph_node *nd)
+	{
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_COLMAJ) )
+	blasfeo_dgemm_execute(&nd->plan, nd->alpha, nd->sA, nd->sB, nd->beta, nd->sC, nd->sD);
+#else
+	GEMM_NN(nd->m, nd->n, nd->k, nd->alpha, nd->sA, nd->ai, nd->aj, nd->sB, nd->bi, nd->bj, nd->beta, nd->sC, nd->ci, nd->cj, nd->sD, nd->di, nd->dj);
+#endif
+	}
+
+void blasfeo_dgraph_dgemm_nn(struct blasfeo_dgraph *sG, int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dgemm_nn);
+	nd->m = m; nd->n = n; nd->k = k; nd->alpha = alpha; nd->beta = beta;
+	nd->sA = sA; nd->ai = ai; nd->aj = aj;
+	nd->sB = sB; nd->bi = bi; nd->bj = bj;
+	nd->sC = sC; nd->ci = ci; nd->cj = cj;
+	nd->sD = sD; nd->di = di; nd->dj = dj;
+	blasfeo_dgraph_mat(nd, sA, ai, aj, m, k, 0, 0);
+	blasfeo_dgraph_mat(nd, sB, bi, bj, k, n, 0, 0);
+	blasfeo_dgraph_mat(nd, sC, ci, cj, m, n, 0, 0);
+	blasfeo_dgraph_mat(nd, sD, di, dj, m, n, 1, 0);
+	nd->flops = 2.0*m*n*k;
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_COLMAJ) )
+	nd->worksize = blasfeo_dgemm_nn_worksize(m, n, k);
+	blasfeo_dgemm_plan('n', 'n', m, n, k, ai, aj, bi, bj, ci, cj, di, dj, &nd->plan);
+#endif
+	}
+
+
+
+static void blasfeo_dgraph_exec_dgemm_nt(struct blasfeo_dgraph_node *nd)
+	{
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_COLMAJ) )
+	blasfeo_dgemm_execute(&nd->plan, nd->alpha, nd->sA, nd->sB, nd->beta, nd->sC, nd->sD);
+#else
+	GEMM_NT(nd->m, nd->n, nd->k, nd->alpha, nd->sA, nd->ai, nd->aj, nd->sB, nd->bi, nd->bj, nd->beta, nd->sC, nd->ci, nd->cj, nd->sD, nd->di, nd->dj);
+#endif
+	}
+
+void blasfeo_dgraph_dgemm_nt(struct blasfeo_dgraph *sG, int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dgemm_nt);
+	nd->m = m; nd->n = n; nd->k = k; nd->alpha = alpha; nd->beta = beta;
+	nd->sA = sA; nd->ai = ai; nd->aj = aj;
+	nd->sB = sB; nd->bi = bi; nd->bj = bj;
+	nd->sC = sC; nd->ci = ci; nd->cj = cj;
+	nd->sD = sD; nd->di = di; nd->dj = dj;
+	blasfeo_dgraph_mat(nd, sA, ai, aj, m, k, 0, 0);
+	blasfeo_dgraph_mat(nd, sB, bi, bj, n, k, 0, 0);
+	blasfeo_dgraph_mat(nd, sC, ci, cj, m, n, 0, 0);
+	blasfeo_dgraph_mat(nd, sD, di, dj, m, n, 1, 0);
+	nd->flops = 2.0*m*n*k;
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_COLMAJ) )
+	nd->worksize = blasfeo_dgemm_nt_worksize(m, n, k);
+	blasfeo_dgemm_plan('n', 't', m, n, k, ai, aj, bi, bj, ci, cj, di, dj, &nd->plan);
+#endif
+	}
+
+
+
+static void blasfeo_dgraph_exec_dsyrk_ln(struct blasfeo_dgraph_node *nd)
+	{
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_COLMAJ) )
+	blasfeo_dsyrk_execute(&nd->plan, nd->alpha, nd->sA, nd->sB, nd->beta, nd->sC, nd->sD);
+#else
+	SYRK_LN(nd->m, nd->k, nd->alpha, nd->sA, nd->ai, nd->aj, nd->sB, nd->bi, nd->bj, nd->beta, nd->sC, nd->ci, nd->cj, nd->sD, nd->di, nd->dj);
+#endif
+	}
+
+void blasfeo_dgraph_dsyrk_ln(struct blasfeo_dgraph *sG, int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dsyrk_ln);
+	nd->m = m; nd->k = k; nd->alpha = alpha; nd->beta = beta;
+	nd->sA = sA; nd->ai = ai; nd->aj = aj;
+	nd->sB = sB; nd->bi = bi; nd->bj = bj;
+	nd->sC = sC; nd->ci = ci; nd->cj = cj;
+	nd->sD = sD; nd->di = di; nd->dj = dj;
+	blasfeo_dgraph_mat(nd, sA, ai, aj, m, k, 0, 0);
+	blasfeo_dgraph_mat(nd, sB, bi, bj, m, k, 0, 0);
+	blasfeo_dgraph_mat(nd, sC, ci, cj, m, m, 0, 0);
+	blasfeo_dgraph_mat(nd, sD, di, dj, m, m, 1, 0);
+	nd->flops = 1.0*m*(m+1)*k;
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_COLMAJ) )
+	nd->worksize = blasfeo_dsyrk_ln_worksize(m, k);
+	blasfeo_dsyrk_plan('l', 'n', m, k, ai, aj, bi, bj, ci, cj, di, dj, &nd->plan);
+#endif
+	}
+
+
+
+static void blasfeo_dgraph_exec_dsyrk_ln_mn(struct blasfeo_dgraph_node *nd)
+	{
+	SYRK_LN_MN(nd->m, nd->n, nd->k, nd->alpha, nd->sA, nd->ai, nd->aj, nd->sB, nd->bi, nd->bj, nd->beta, nd->sC, nd->ci, nd->cj, nd->sD, nd->di, nd->dj);
+	}
+
+void blasfeo_dgraph_dsyrk_ln_mn(struct blasfeo_dgraph *sG, int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dsyrk_ln_mn);
+	nd->m = m; nd->n = n; nd->k = k; nd->alpha = alpha; nd->beta = beta;
+	nd->sA = sA; nd->ai = ai; nd->aj = aj;
+	nd->sB = sB; nd->bi = bi; nd->bj = bj;
+	nd->sC = sC; nd->ci = ci; nd->cj = cj;
+	nd->sD = sD; nd->di = di; nd->dj = dj;
+	blasfeo_dgraph_mat(nd, sA, ai, aj, m, k, 0, 0);
+	blasfeo_dgraph_mat(nd, sB, bi, bj, n, k, 0, 0);
+	blasfeo_dgraph_mat(nd, sC, ci, cj, m, n, 0, 0);
+	blasfeo_dgraph_mat(nd, sD, di, dj, m, n, 1, 0);
+	nd->flops = (2.0*m-n)*n*k;
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_COLMAJ) )
+	nd->worksize = blasfeo_dsyrk_ln_mn_worksize(m, n, k);
+#endif
+	}
+
+
+
+static void blasfeo_dgraph_exec_dtrmm_rlnn(struct blasfeo_dgraph_node *nd)
+	{
+	TRMM_RLNN(nd->m, nd->n, nd->alpha, nd->sA, nd->ai, nd->aj, nd->sB, nd->bi, nd->bj, nd->sD, nd->di, nd->dj);
+	}
+
+void blasfeo_dgraph_dtrmm_rlnn(struct blasfeo_dgraph *sG, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dtrmm_rlnn);
+	nd->m = m; nd->n = n; nd->alpha = alpha;
+	nd->sA = sA; nd->ai = ai; nd->aj = aj;
+	nd->sB = sB; nd->bi = bi; nd->bj = bj;
+	nd->sD = sD; nd->di = di; nd->dj = dj;
+	blasfeo_dgraph_mat(nd, sA, ai, aj, n, n, 0, 0);
+	blasfeo_dgraph_mat(nd, sB, bi, bj, m, n, 0, 0);
+	blasfeo_dgraph_mat(nd, sD, di, dj, m, n, 1, 0);
+	nd->flops = 1.0*m*n*n;
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_COLMAJ) )
+	nd->worksize = blasfeo_dtrmm_rlnn_worksize(m, n);
+#endif
+	}
+
+
+
+static void blasfeo_dgraph_exec_dtrmm_rutn(struct blasfeo_dgraph_node *nd)
+	{
+	TRMM_RUTN(nd->m, nd->n, nd->alpha, nd->sA, nd->ai, nd->aj, nd->sB, nd->bi, nd->bj, nd->sD, nd->di, nd->dj);
+	}
+
+void blasfeo_dgraph_dtrmm_rutn(struct blasfeo_dgraph *sG, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dtrmm_rutn);
+	nd->m = m; nd->n = n; nd->alpha = alpha;
+	nd->sA = sA; nd->ai = ai; nd->aj = aj;
+	nd->sB = sB; nd->bi = bi; nd->bj = bj;
+	nd->sD = sD; nd->di = di; nd->dj = dj;
+	blasfeo_dgraph_mat(nd, sA, ai, aj, n, n, 0, 0);
+	blasfeo_dgraph_mat(nd, sB, bi, bj, m, n, 0, 0);
+	blasfeo_dgraph_mat(nd, sD, di, dj, m, n, 1, 0);
+	nd->flops = 1.0*m*n*n;
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_COLMAJ) )
+	nd->worksize = blasfeo_dtrmm_rutn_worksize(m, n);
+#endif
+	}
+
+
+
+static void blasfeo_dgraph_exec_dtrsm_rltn(struct blasfeo_dgraph_node *nd)
+	{
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_COLMAJ) )
+	blasfeo_dtrsm_execute(&nd->plan, nd->alpha, nd->sA, nd->sB, nd->sD);
+#else
+	TRSM_RLTN(nd->m, nd->n, nd->alpha, nd->sA, nd->ai, nd->aj, nd->sB, nd->bi, nd->bj, nd->sD, nd->di, nd->dj);
+#endif
+	}
+
+void blasfeo_dgraph_dtrsm_rltn(struct blasfeo_dgraph *sG, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dtrsm_rltn);
+	nd->m = m; nd->n = n; nd->alpha = alpha;
+	nd->sA = sA; nd->ai = ai; nd->aj = aj;
+	nd->sB = sB; nd->bi = bi; nd->bj = bj;
+	nd->sD = sD; nd->di = di; nd->dj = dj;
+	blasfeo_dgraph_mat(nd, sA, ai, aj, n, n, 0, 1);
+	blasfeo_dgraph_mat(nd, sB, bi, bj, m, n, 0, 0);
+	blasfeo_dgraph_mat(nd, sD, di, dj, m, n, 1, 0);
+	nd->flops = 1.0*m*n*n;
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_COLMAJ) )
+	nd->worksize = blasfeo_dtrsm_rltn_worksize(m, n);
+	blasfeo_dtrsm_plan('r', 'l', 't', 'n', m, n, ai, aj, bi, bj, di, dj, &nd->plan);
+#endif
+	}
+
+
+
+static void blasfeo_dgraph_exec_dpotrf_l(struct blasfeo_dgraph_node *nd)
+	{
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_COLMAJ) )
+	blasfeo_dpotrf_execute(&nd->plan, nd->sC, nd->sD);
+#else
+	POTRF_L(nd->m, nd->sC, nd->ci, nd->cj, nd->sD, nd->di, nd->dj);
+#endif
+	}
+
+void blasfeo_dgraph_dpotrf_l(struct blasfeo_dgraph *sG, int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dpotrf_l);
+	nd->m = m;
+	nd->sC = sC; nd->ci = ci; nd->cj = cj;
+	nd->sD = sD; nd->di = di; nd->dj = dj;
+	blasfeo_dgraph_mat(nd, sC, ci, cj, m, m, 0, 0);
+	blasfeo_dgraph_mat(nd, sD, di, dj, m, m, 1, 1);
+	nd->flops = 1.0/3.0*m*m*m;
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_COLMAJ) )
+	nd->worksize = blasfeo_dpotrf_l_worksize(m);
+	blasfeo_dpotrf_plan('l', m, ci, cj, di, dj, &nd->plan);
+#endif
+	}
+
+
+
+static void blasfeo_dgraph_exec_dpotrf_l_mn(struct blasfeo_dgraph_node *nd)
+	{
+	POTRF_L_MN(nd->m, nd->n, nd->sC, nd->ci, nd->cj, nd->sD, nd->di, nd->dj);
+	}
+
+void blasfeo_dgraph_dpotrf_l_mn(struct blasfeo_dgraph *sG, int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dpotrf_l_mn);
+	nd->m = m; nd->n = n;
+	nd->sC = sC; nd->ci = ci; nd->cj = cj;
+	nd->sD = sD; nd->di = di; nd->dj = dj;
+	blasfeo_dgraph_mat(nd, sC, ci, cj, m, n, 0, 0);
+	blasfeo_dgraph_mat(nd, sD, di, dj, m, n, 1, 1);
+	nd->flops = 1.0*n*n*(m-n/3.0);
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_COLMAJ) )
+	nd->worksize = blasfeo_dpotrf_l_mn_worksize(m, n);
+#endif
+	}
+
+
+
+static void blasfeo_dgraph_exec_dsyrk_dpotrf_ln(struct blasfeo_dgraph_node *nd)
+	{
+	SYRK_POTRF_LN(nd->m, nd->k, nd->sA, nd->ai, nd->aj, nd->sB, nd->bi, nd->bj, nd->sC, nd->ci, nd->cj, nd->sD, nd->di, nd->dj);
+	}
+
+void blasfeo_dgraph_dsyrk_dpotrf_ln(struct blasfeo_dgraph *sG, int m, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dsyrk_dpotrf_ln);
+	nd->m = m; nd->k = k;
+	nd->sA = sA; nd->ai = ai; nd->aj = aj;
+	nd->sB = sB; nd->bi = bi; nd->bj = bj;
+	nd->sC = sC; nd->ci = ci; nd->cj = cj;
+	nd->sD = sD; nd->di = di; nd->dj = dj;
+	blasfeo_dgraph_mat(nd, sA, ai, aj, m, k, 0, 0);
+	blasfeo_dgraph_mat(nd, sB, bi, bj, m, k, 0, 0);
+	blasfeo_dgraph_mat(nd, sC, ci, cj, m, m, 0, 0);
+	blasfeo_dgraph_mat(nd, sD, di, dj, m, m, 1, 1);
+	nd->flops = 1.0*m*(m+1)*k + 1.0/3.0*m*m*m;
+	}
+
+
+
+static void blasfeo_dgraph_exec_dsyrk_dpotrf_ln_mn(struct blasfeo_dgraph_node *nd)
+	{
+	SYRK_POTRF_LN_MN(nd->m, nd->n, nd->k, nd->sA, nd->ai, nd->aj, nd->sB, nd->bi, nd->bj, nd->sC, nd->ci, nd->cj, nd->sD, nd->di, nd->dj);
+	}
+
+void blasfeo_dgraph_dsyrk_dpotrf_ln_mn(struct blasfeo_dgraph *sG, int m, int n, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dsyrk_dpotrf_ln_mn);
+	nd->m = m; nd->n = n; nd->k = k;
+	nd->sA = sA; nd->ai = ai; nd->aj = aj;
+	nd->sB = sB; nd->bi = bi; nd->bj = bj;
+	nd->sC = sC; nd->ci = ci; nd->cj = cj;
+	nd->sD = sD; nd->di = di; nd->dj = dj;
+	blasfeo_dgraph_mat(nd, sA, ai, aj, m, k, 0, 0);
+	blasfeo_dgraph_mat(nd, sB, bi, bj, n, k, 0, 0);
+	blasfeo_dgraph_mat(nd, sC, ci, cj, m, n, 0, 0);
+	blasfeo_dgraph_mat(nd, sD, di, dj, m, n, 1, 1);
+	nd->flops = (2.0*m-n)*n*k + 1.0*n*n*(m-n/3.0);
+	}
+
+
+
+static void blasfeo_dgraph_exec_dgemv_n(struct blasfeo_dgraph_node *nd)
+	{
+	GEMV_N(nd->m, nd->n, nd->alpha, nd->sA, nd->ai, nd->aj, nd->sx, nd->xi, nd->beta, nd->sy, nd->yi, nd->sz, nd->zi);
+	}
+
+void blasfeo_dgraph_dgemv_n(struct blasfeo_dgraph *sG, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sx, int xi, double beta, struct blasfeo_dvec *sy, int yi, struct blasfeo_dvec *sz, int zi)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dgemv_n);
+	nd->m = m; nd->n = n; nd->alpha = alpha; nd->beta = beta;
+	nd->sA = sA; nd->ai = ai; nd->aj = aj;
+	nd->sx = sx; nd->xi = xi;
+	nd->sy = sy; nd->yi = yi;
+	nd->sz = sz; nd->zi = zi;
+	blasfeo_dgraph_mat(nd, sA, ai, aj, m, n, 0, 0);
+	blasfeo_dgraph_vec(nd, sx, xi, n, 0);
+	blasfeo_dgraph_vec(nd, sy, yi, m, 0);
+	blasfeo_dgraph_vec(nd, sz, zi, m, 1);
+	nd->flops = 2.0*m*n;
+	}
+
+
+
+static void blasfeo_dgraph_exec_dgemv_t(struct blasfeo_dgraph_node *nd)
+	{
+	GEMV_T(nd->m, nd->n, nd->alpha, nd->sA, nd->ai, nd->aj, nd->sx, nd->xi, nd->beta, nd->sy, nd->yi, nd->sz, nd->zi);
+	}
+
+void blasfeo_dgraph_dgemv_t(struct blasfeo_dgraph *sG, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sx, int xi, double beta, struct blasfeo_dvec *sy, int yi, struct blasfeo_dvec *sz, int zi)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dgemv_t);
+	nd->m = m; nd->n = n; nd->alpha = alpha; nd->beta = beta;
+	nd->sA = sA; nd->ai = ai; nd->aj = aj;
+	nd->sx = sx; nd->xi = xi;
+	nd->sy = sy; nd->yi = yi;
+	nd->sz = sz; nd->zi = zi;
+	blasfeo_dgraph_mat(nd, sA, ai, aj, m, n, 0, 0);
+	blasfeo_dgraph_vec(nd, sx, xi, m, 0);
+	blasfeo_dgraph_vec(nd, sy, yi, n, 0);
+	blasfeo_dgraph_vec(nd, sz, zi, n, 1);
+	nd->flops = 2.0*m*n;
+	}
+
+
+
+static void blasfeo_dgraph_exec_dtrsv_lnn(struct blasfeo_dgraph_node *nd)
+	{
+	TRSV_LNN(nd->m, nd->sA, nd->ai, nd->aj, nd->sx, nd->xi, nd->sz, nd->zi);
+	}
+
+void blasfeo_dgraph_dtrsv_lnn(struct blasfeo_dgraph *sG, int m, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sx, int xi, struct blasfeo_dvec *sz, int zi)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dtrsv_lnn);
+	nd->m = m;
+	nd->sA = sA; nd->ai = ai; nd->aj = aj;
+	nd->sx = sx; nd->xi = xi;
+	nd->sz = sz; nd->zi = zi;
+	blasfeo_dgraph_mat(nd, sA, ai, aj, m, m, 0, 1);
+	blasfeo_dgraph_vec(nd, sx, xi, m, 0);
+	blasfeo_dgraph_vec(nd, sz, zi, m, 1);
+	nd->flops = 1.0*m*m;
+	}
+
+
+
+static void blasfeo_dgraph_exec_dtrsv_ltn(struct blasfeo_dgraph_node *nd)
+	{
+	TRSV_LTN(nd->m, nd->sA, nd->ai, nd->aj, nd->sx, nd->xi, nd->sz, nd->zi);
+	}
+
+void blasfeo_dgraph_dtrsv_ltn(struct blasfeo_dgraph *sG, int m, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sx, int xi, struct blasfeo_dvec *sz, int zi)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dtrsv_ltn);
+	nd->m = m;
+	nd->sA = sA; nd->ai = ai; nd->aj = aj;
+	nd->sx = sx; nd->xi = xi;
+	nd->sz = sz; nd->zi = zi;
+	blasfeo_dgraph_mat(nd, sA, ai, aj, m, m, 0, 1);
+	blasfeo_dgraph_vec(nd, sx, xi, m, 0);
+	blasfeo_dgraph_vec(nd, sz, zi, m, 1);
+	nd->flops = 1.0*m*m;
+	}
+
+
+
+static void blasfeo_dgraph_exec_dtrsv_lnn_mn(struct blasfeo_dgraph_node *nd)
+	{
+	TRSV_LNN_MN(nd->m, nd->n, nd->sA, nd->ai, nd->aj, nd->sx, nd->xi, nd->sz, nd->zi);
+	}
+
+void blasfeo_dgraph_dtrsv_lnn_mn(struct blasfeo_dgraph *sG, int m, int n, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sx, int xi, struct blasfeo_dvec *sz, int zi)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dtrsv_lnn_mn);
+	nd->m = m; nd->n = n;
+	nd->sA = sA; nd->ai = ai; nd->aj = aj;
+	nd->sx = sx; nd->xi = xi;
+	nd->sz = sz; nd->zi = zi;
+	blasfeo_dgraph_mat(nd, sA, ai, aj, m, n, 0, 1);
+	blasfeo_dgraph_vec(nd, sx, xi, m, 0);
+	blasfeo_dgraph_vec(nd, sz, zi, m, 1);
+	nd->flops = (2.0*m-n)*n;
+	}
+
+
+
+static void blasfeo_dgraph_exec_dtrsv_ltn_mn(struct blasfeo_dgraph_node *nd)
+	{
+	TRSV_LTN_MN(nd->m, nd->n, nd->sA, nd->ai, nd->aj, nd->sx, nd->xi, nd->sz, nd->zi);
+	}
+
+void blasfeo_dgraph_dtrsv_ltn_mn(struct blasfeo_dgraph *sG, int m, int n, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sx, int xi, struct blasfeo_dvec *sz, int zi)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dtrsv_ltn_mn);
+	nd->m = m; nd->n = n;
+	nd->sA = sA; nd->ai = ai; nd->aj = aj;
+	nd->sx = sx; nd->xi = xi;
+	nd->sz = sz; nd->zi = zi;
+	blasfeo_dgraph_mat(nd, sA, ai, aj, m, n, 0, 1);
+	blasfeo_dgraph_vec(nd, sx, xi, m, 0);
+	blasfeo_dgraph_vec(nd, sz, zi, m, 1);
+	nd->flops = (2.0*m-n)*n;
+	}
+
+
+
+static void blasfeo_dgraph_exec_dtrmv_lnn(struct blasfeo_dgraph_node *nd)
+	{
+	TRMV_LNN(nd->m, nd->sA, nd->ai, nd->aj, nd->sx, nd->xi, nd->sz, nd->zi);
+	}
+
+void blasfeo_dgraph_dtrmv_lnn(struct blasfeo_dgraph *sG, int m, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sx, int xi, struct blasfeo_dvec *sz, int zi)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dtrmv_lnn);
+	nd->m = m;
+	nd->sA = sA; nd->ai = ai; nd->aj = aj;
+	nd->sx = sx; nd->xi = xi;
+	nd->sz = sz; nd->zi = zi;
+	blasfeo_dgraph_mat(nd, sA, ai, aj, m, m, 0, 0);
+	blasfeo_dgraph_vec(nd, sx, xi, m, 0);
+	blasfeo_dgraph_vec(nd, sz, zi, m, 1);
+	nd->flops = 1.0*m*m;
+	}
+
+
+
+static void blasfeo_dgraph_exec_dtrmv_ltn(struct blasfeo_dgraph_node *nd)
+	{
+	TRMV_LTN(nd->m, nd->sA, nd->ai, nd->aj, nd->sx, nd->xi, nd->sz, nd->zi);
+	}
+
+void blasfeo_dgraph_dtrmv_ltn(struct blasfeo_dgraph *sG, int m, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sx, int xi, struct blasfeo_dvec *sz, int zi)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dtrmv_ltn);
+	nd->m = m;
+	nd->sA = sA; nd->ai = ai; nd->aj = aj;
+	nd->sx = sx; nd->xi = xi;
+	nd->sz = sz; nd->zi = zi;
+	blasfeo_dgraph_mat(nd, sA, ai, aj, m, m, 0, 0);
+	blasfeo_dgraph_vec(nd, sx, xi, m, 0);
+	blasfeo_dgraph_vec(nd, sz, zi, m, 1);
+	nd->flops = 1.0*m*m;
+	}
+
+
+
+static void blasfeo_dgraph_exec_dgecp(struct blasfeo_dgraph_node *nd)
+	{
+	blasfeo_dgecp(nd->m, nd->n, nd->sA, nd->ai, nd->aj, nd->sB, nd->bi, nd->bj);
+	}
+
+void blasfeo_dgraph_dgecp(struct blasfeo_dgraph *sG, int m, int n, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dgecp);
+	nd->m = m; nd->n = n;
+	nd->sA = sA; nd->ai = ai; nd->aj = aj;
+	nd->sB = sB; nd->bi = bi; nd->bj = bj;
+	blasfeo_dgraph_mat(nd, sA, ai, aj, m, n, 0, 0);
+	blasfeo_dgraph_mat(nd, sB, bi, bj, m, n, 1, 0);
+	nd->flops = 1.0*m*n;
+	}
+
+
+
+static void blasfeo_dgraph_exec_dgead(struct blasfeo_dgraph_node *nd)
+	{
+	blasfeo_dgead(nd->m, nd->n, nd->alpha, nd->sA, nd->ai, nd->aj, nd->sB, nd->bi, nd->bj);
+	}
+
+void blasfeo_dgraph_dgead(struct blasfeo_dgraph *sG, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dgead);
+	nd->m = m; nd->n = n; nd->alpha = alpha;
+	nd->sA = sA; nd->ai = ai; nd->aj = aj;
+	nd->sB = sB; nd->bi = bi; nd->bj = bj;
+	blasfeo_dgraph_mat(nd, sA, ai, aj, m, n, 0, 0);
+	blasfeo_dgraph_mat(nd, sB, bi, bj, m, n, 1, 0);
+	nd->flops = 2.0*m*n;
+	}
+
+
+
+static void blasfeo_dgraph_exec_drowex(struct blasfeo_dgraph_node *nd)
+	{
+	blasfeo_drowex(nd->m, nd->alpha, nd->sA, nd->ai, nd->aj, nd->sx, nd->xi);
+	}
+
+void blasfeo_dgraph_drowex(struct blasfeo_dgraph *sG, int kmax, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sx, int xi)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_drowex);
+	nd->m = kmax; nd->alpha = alpha;
+	nd->sA = sA; nd->ai = ai; nd->aj = aj;
+	nd->sx = sx; nd->xi = xi;
+	blasfeo_dgraph_mat(nd, sA, ai, aj, 1, kmax, 0, 0);
+	blasfeo_dgraph_vec(nd, sx, xi, kmax, 1);
+	nd->flops = 1.0*kmax;
+	}
+
+
+
+static void blasfeo_dgraph_exec_dveccp(struct blasfeo_dgraph_node *nd)
+	{
+	blasfeo_dveccp(nd->m, nd->sx, nd->xi, nd->sy, nd->yi);
+	}
+
+void blasfeo_dgraph_dveccp(struct blasfeo_dgraph *sG, int m, struct blasfeo_dvec *sx, int xi, struct blasfeo_dvec *sy, int yi)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dveccp);
+	nd->m = m;
+	nd->sx = sx; nd->xi = xi;
+	nd->sy = sy; nd->yi = yi;
+	blasfeo_dgraph_vec(nd, sx, xi, m, 0);
+	blasfeo_dgraph_vec(nd, sy, yi, m, 1);
+	nd->flops = 1.0*m;
+	}
+
+
+
+static void blasfeo_dgraph_exec_dvecsc(struct blasfeo_dgraph_node *nd)
+	{
+	blasfeo_dvecsc(nd->m, nd->alpha, nd->sx, nd->xi);
+	}
+
+void blasfeo_dgraph_dvecsc(struct blasfeo_dgraph *sG, int m, double alpha, struct blasfeo_dvec *sx, int xi)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_dvecsc);
+	nd->m = m; nd->alpha = alpha;
+	nd->sx = sx; nd->xi = xi;
+	blasfeo_dgraph_vec(nd, sx, xi, m, 1);
+	nd->flops = 1.0*m;
+	}
+
+
+
+static void blasfeo_dgraph_exec_daxpy(struct blasfeo_dgraph_node *nd)
+	{
+	AXPY(nd->m, nd->alpha, nd->sx, nd->xi, nd->sy, nd->yi, nd->sz, nd->zi);
+	}
+
+void blasfeo_dgraph_daxpy(struct blasfeo_dgraph *sG, int m, double alpha, struct blasfeo_dvec *sx, int xi, struct blasfeo_dvec *sy, int yi, struct blasfeo_dvec *sz, int zi)
+	{
+	struct blasfeo_dgraph_node *nd = blasfeo_dgraph_new_node(sG, &blasfeo_dgraph_exec_daxpy);
+	nd->m = m; nd->alpha = alpha;
+	nd->sx = sx; nd->xi = xi;
+	nd->sy = sy; nd->yi = yi;
+	nd->sz = sz; nd->zi = zi;
+	blasfeo_dgraph_vec(nd, sx, xi, m, 0);
+	blasfeo_dgraph_vec(nd, sy, yi, m, 0);
+	blasfeo_dgraph_vec(nd, sz, zi, m, 1);
+	nd->flops = 2.0*m;
+	}
+
+
+
+/************************************************
+* compile
+************************************************/
+
+// two accesses are dependent if they touch the same memory and at least one of them writes;
+// blocks of the same structure are compared element-wise, except for the dA and use_dA fields: these are used
+// by the routines with the inverse of the diagonal, and reset by all the writing routines (two writes of disjoint
+// blocks both store 0 in use_dA, so they stay independent)
+static int blasfeo_dgraph_conflict(struct blasfeo_dgraph_access *a, struct blasfeo_dgraph_access *b)
+	{
+	if(!(a->write | b->write | (a->diag & b->diag)))
+		return 0;
+	if(a->mem1<=b->mem0 | b->mem1<=a->mem0)
+		return 0;
+	// different structures on overlapping memory
+	if(a->str!=b->str)
+		return 1;
+	if((a->diag & (b->diag | b->write)) | (b->diag & a->write))
+		return 1;
+	if(a->i1<=b->i0 | b->i1<=a->i0 | a->j1<=b->j0 | b->j1<=a->j0)
+		return 0;
+	return 1;
+	}
+
+
+
+void blasfeo_dgraph_compile(struct blasfeo_dgraph *sG)
+	{
+
+	int n_node = sG->n_node;
+	struct blasfeo_dgraph_node *node = sG->node;
+	int *perm = sG->perm;
+	int *lev_ptr = sG->lev_ptr;
+	int *lev_nth = sG->lev_nth;
+
+	int ii, jj, ll, ia, ja, i0, i1;
+	int lev;
+	size_t ws;
+
+	// level of each call: one more than the deepest previous call it depends on
+	int n_lev = 0;
+	for(ii=0; ii<n_node; ii++)
+		{
+		lev = 0;
+		for(jj=0; jj<ii; jj++)
+			{
+			if(node[jj].level<lev)
+				continue;
+			for(ia=0; ia<node[ii].n_acc; ia++)
+				{
+				for(ja=0; ja<node[jj].n_acc; ja++)
+					{
+					if(blasfeo_dgraph_conflict(node[ii].acc+ia, node[jj].acc+ja))
+						{
+						lev = node[jj].level+1;
+						goto next;
+						}
+					}
+				}
+next:
+			;
+			}
+		node[ii].level = lev;
+		n_lev = lev+1>n_lev ? lev+1 : n_lev;
+		}
+
+	// calls sorted by level, in recording order within a level (counting sort)
+	for(ll=0; ll<=n_lev; ll++)
+		lev_ptr[ll] = 0;
+	for(ii=0; ii<n_node; ii++)
+		lev_ptr[node[ii].level+1]++;
+	for(ll=0; ll<n_lev; ll++)
+		lev_ptr[ll+1] += lev_ptr[ll];
+	for(ii=0; ii<n_node; ii++)
+		{
+		perm[lev_ptr[node[ii].level]] = ii;
+		lev_ptr[node[ii].level]++;
+		}
+	for(ll=n_lev; ll>0; ll--)
+		lev_ptr[ll] = lev_ptr[ll-1];
+	lev_ptr[0] = 0;
+
+	// scratch memory of one thread
+	ws = 0;
+	for(ii=0; ii<n_node; ii++)
+		ws = node[ii].worksize>ws ? node[ii].worksize : ws;
+	sG->slotsize = (ws + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+
+	// threads of each level
+	int n_slot = 1;
+	int nth;
+#if defined(MULTI_THREAD)
+	int tid;
+	double flops, flops_max;
+	double load[BLASFEO_MAX_THREADS];
+#endif
+	for(ll=0; ll<n_lev; ll++)
+		{
+		i0 = lev_ptr[ll];
+		i1 = lev_ptr[ll+1];
+		for(ii=i0; ii<i1; ii++)
+			node[perm[ii]].tid = 0;
+		nth = 1;
+#if defined(MULTI_THREAD)
+		flops = 0.0;
+		flops_max = 0.0;
+		for(ii=i0; ii<i1; ii++)
+			{
+			flops += node[perm[ii]].flops;
+			flops_max = node[perm[ii]].flops>flops_max ? node[perm[ii]].flops : flops_max;
+			}
+		nth = blasfeo_get_num_threads_flops(flops);
+		nth = nth<i1-i0 ? nth : i1-i0;
+		// a level dominated by a single call is run sequentially, letting that call use the threads
+		if(nth>1 & flops_max*nth>2.0*flops)
+			nth = 1;
+		if(nth>1)
+			{
+			int tmp;
+			// largest calls first to the least loaded thread
+			for(ii=i0+1; ii<i1; ii++)
+				{
+				tmp = perm[ii];
+				for(jj=ii; jj>i0 && node[perm[jj-1]].flops<node[tmp].flops; jj--)
+					perm[jj] = perm[jj-1];
+				perm[jj] = tmp;
+				}
+			for(tid=0; tid<nth; tid++)
+				load[tid] = 0.0;
+			for(ii=i0; ii<i1; ii++)
+				{
+				tid = 0;
+				for(jj=1; jj<nth; jj++)
+					tid = load[jj]<load[tid] ? jj : tid;
+				node[perm[ii]].tid = tid;
+				load[tid] += node[perm[ii]].flops;
+				}
+			}
+#endif
+		lev_nth[ll] = nth;
+		n_slot = nth>n_slot ? nth : n_slot;
+		}
+
+	sG->n_lev = n_lev;
+	sG->n_slot = n_slot;
+	sG->compiled = 1;
+
+	return;
+
+	}
+
+
+
+size_t blasfeo_dgraph_worksize(struct blasfeo_dgraph *sG)
+	{
+	if(!sG->compiled)
+		{
+		printf("\nerror: blasfeo_dgraph_worksize: graph not compiled\n");
+		exit(1);
+		}
+	return sG->n_slot*sG->slotsize;
+	}
+
+
+
+/************************************************
+* run
+************************************************/
+
+#if defined(MULTI_THREAD)
+
+struct blasfeo_dgraph_mt_arg
+	{
+	struct blasfeo_dgraph *sG;
+	char *work;
+	int lev;
+	};
+
+
+
+static void blasfeo_dgraph_mt_work(int tid, int nth, void *ptr)
+	{
+	struct blasfeo_dgraph_mt_arg *arg = ptr;
+	struct blasfeo_dgraph *sG = arg->sG;
+	struct blasfeo_dgraph_node *node;
+	struct blasfeo_work prev;
+	int ii;
+	// the calling thread (tid 0) already uses the first slot
+	if(tid>0 & sG->slotsize>0)
+		blasfeo_work_begin(arg->work+tid*sG->slotsize, sG->slotsize, &prev);
+	for(ii=sG->lev_ptr[arg->lev]; ii<sG->lev_ptr[arg->lev+1]; ii++)
+		{
+		node = sG->node+sG->perm[ii];
+		// all the nodes of the level if it is run on the calling thread only, as in a nested parallel region
+		if(node->tid==tid | nth==1)
+			node->fun(node);
+		}
+	if(tid>0 & sG->slotsize>0)
+		blasfeo_work_end(&prev);
+	return;
+	}
+
+#endif
+
+
+
+void blasfeo_dgraph_run(struct blasfeo_dgraph *sG, void *work)
+	{
+
+	if(!sG->compiled)
+		{
+		printf("\nerror: blasfeo_dgraph_run: graph not compiled\n");
+		exit(1);
+		}
+
+	struct blasfeo_dgraph_node *node;
+	struct blasfeo_work prev;
+	int ii, ll;
+
+	if(sG->slotsize>0)
+		blasfeo_work_begin(work, sG->slotsize, &prev);
+
+#if defined(MULTI_THREAD)
+	struct blasfeo_dgraph_mt_arg arg;
+	arg.sG = sG;
+	arg.work = work;
+#endif
+
+	for(ll=0; ll<sG->n_lev; ll++)
+		{
+#if defined(MULTI_THREAD)
+		if(sG->lev_nth[ll]>1)
+			{
+			arg.lev = ll;
+			blasfeo_parallel_run(sG->lev_nth[ll], &blasfeo_dgraph_mt_work, &arg);
+			continue;
+			}
+#endif
+		for(ii=sG->lev_ptr[ll]; ii<sG->lev_ptr[ll+1]; ii++)
+			{
+			node = sG->node+sG->perm[ii];
+			node->fun(node);
+			}
+		}
+
+	if(sG->slotsize>0)
+		blasfeo_work_end(&prev);
+
+	return;
+
+	}
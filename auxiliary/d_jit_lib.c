@@ -0,0 +1,983 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <blasfeo_common.h>
+#include <blasfeo_block_size.h>
+#include <blasfeo_d_blasfeo_api.h>
+#include <blasfeo_processor_features.h>
+#include <blasfeo_stdlib.h>
+
+
+
+// the kernels are generated for x86-64 with the System V calling convention, in memory mapped executable
+#if defined(__x86_64__) & ( defined(OS_LINUX) | defined(OS_MAC) ) & ( defined(__GNUC__) | defined(__clang__) )
+#define JIT_X64
+#endif
+
+#if defined(JIT_X64)
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(MULTI_THREAD)
+#include <pthread.h>
+#endif
+#endif
+
+#if ( defined(LA_HIGH_PERFORMANCE) | defined(LA_REFERENCE) ) & defined(MF_PANELMAJ)
+#define JIT_PANELMAJ
+#endif
+
+
+
+// max value of m, n and k of a generated kernel
+#define JIT_MAX_SIZE 32
+// kernels with more fma than this loop on k instead of unrolling it fully
+#define JIT_MAX_UNROLL 1024
+// number of buckets of the kernel cache
+#define JIT_BUCKETS 1024
+// max number of kernels in the cache, past which the generic routine is used
+#define JIT_MAX_KERNELS 1024
+// constants at the beginning of the generated code: mask of the last rows (AVX2)
+#define JIT_DATA_MASK 0
+#define JIT_DATA_SIZE 64
+
+// registers
+#define JIT_RAX 0
+#define JIT_RCX 1
+#define JIT_RDX 2
+#define JIT_RSI 6
+#define JIT_RDI 7
+#define JIT_R8 8
+#define JIT_R9 9
+#define JIT_R10 10
+#define JIT_R11 11
+// rip-relative memory operand
+#define JIT_RIP -1
+
+// unroll of the k loop, multiple of the panel size for the access to B
+#if defined(JIT_PANELMAJ)
+#define JIT_KU D_PS
+#else
+#define JIT_KU 4
+#endif
+
+
+
+// kernel of D <= beta * C + alpha * op(A) * op(B) for fixed sizes, transpositions and strides; alpha=1, beta=0 and beta=1
+// are baked in the code, any other alpha and beta are arguments of the kernel
+struct blasfeo_djit_dgemm
+	{
+	void (*kernel)(double *pA, double *pB, double *pC, double *pD, double *alpha_beta); // entry point, with pointers to the first element of each matrix and to alpha and beta
+	struct blasfeo_djit_dgemm *next; // next kernel in the same cache bucket
+	void *code; // executable memory
+	size_t code_size; // size of the executable memory
+	int alpha_case; // 1 for alpha=1, 0 for any other alpha
+	int beta_case; // 0 for beta=0, 1 for beta=1, 2 for any other beta
+	int m;
+	int n;
+	int k;
+	int lda; // strides (panel stride in panel-major, leading dimension in column-major)
+	int ldb;
+	int ldc; // 0 if beta is 0
+	int ldd;
+	char ta;
+	char tb;
+	};
+
+
+
+// stride of a matrix
+static int mat_ld(struct blasfeo_dmat *sA)
+	{
+#if defined(JIT_PANELMAJ)
+	return sA->cn;
+#else
+	return sA->m;
+#endif
+	}
+
+
+
+// offset (in doubles) of the element (i,j) from the element (0,0), the row of the element (0,0) being a multiple of the panel size
+static int mat_off(int ld, int i, int j)
+	{
+#if defined(JIT_PANELMAJ)
+	return (i-(i&(D_PS-1)))*ld + j*D_PS + (i&(D_PS-1));
+#else
+	return i + j*ld;
+#endif
+	}
+
+
+
+// the generic routine
+static void jit_dgemm_ref(char ta, char tb, int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	if(ta=='n')
+		{
+		if(tb=='n')
+			blasfeo_dgemm_nn(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+		else
+			blasfeo_dgemm_nt(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+		}
+	else
+		{
+		if(tb=='n')
+			blasfeo_dgemm_tn(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+		else
+			blasfeo_dgemm_tt(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+		}
+	return;
+	}
+
+
+
+#if defined(JIT_X64)
+
+
+
+//
+// x86-64 encoder
+//
+
+// code buffer
+struct jit_code
+	{
+	unsigned char *buf;
+	int size;
+	int max;
+	int error; // out of memory
+	};
+
+
+
+static void jit_byte(struct jit_code *c, int b)
+	{
+	unsigned char *buf;
+	if(c->error)
+		return;
+	if(c->size==c->max)
+		{
+		blasfeo_malloc((void **) &buf, 2*c->max);
+		if(buf==NULL)
+			{
+			c->error = 1;
+			return;
+			}
+		memcpy(buf, c->buf, c->size);
+		blasfeo_free(c->buf);
+		c->buf = buf;
+		c->max = 2*c->max;
+		}
+	c->buf[c->size++] = b & 0xff;
+	return;
+	}
+
+
+
+static void jit_int32(struct jit_code *c, int v)
+	{
+	uint32_t u = (uint32_t) v;
+	jit_byte(c, u);
+	jit_byte(c, u>>8);
+	jit_byte(c, u>>16);
+	jit_byte(c, u>>24);
+	return;
+	}
+
+
+
+// ModRM (and SIB and displacement) of the register reg and the memory operand [base+disp],
+// with disp8 scaled by n (EVEX compressed displacement); with base JIT_RIP, disp is the offset in the code buffer
+static void jit_mem(struct jit_code *c, int reg, int base, int disp, int n)
+	{
+	int mod;
+	if(base==JIT_RIP)
+		{
+		jit_byte(c, ((reg&7)<<3) | 5);
+		// relative to the end of the instruction
+		jit_int32(c, disp - (c->size+4));
+		return;
+		}
+	if(disp==0 & (base&7)!=5)
+		mod = 0;
+	else if(disp%n==0 & disp/n>=-128 & disp/n<=127)
+		mod = 1;
+	else
+		mod = 2;
+	jit_byte(c, (mod<<6) | ((reg&7)<<3) | (base&7));
+	if((base&7)==4)
+		jit_byte(c, 0x24);
+	if(mod==1)
+		jit_byte(c, disp/n);
+	else if(mod==2)
+		jit_int32(c, disp);
+	return;
+	}
+
+
+
+// ModRM of two registers
+static void jit_reg(struct jit_code *c, int reg, int rm)
+	{
+	jit_byte(c, 0xc0 | ((reg&7)<<3) | (rm&7));
+	return;
+	}
+
+
+
+// VEX prefix and opcode; pp 1 is the 66 prefix, mm 1 and 2 the 0F and 0F38 maps, l 1 the 256-bit length;
+// rm is a register or the base of a memory operand
+static void jit_vex(struct jit_code *c, int mm, int w, int l, int reg, int vvvv, int rm, int op)
+	{
+	int pp = 1;
+	int r = (reg>>3) & 1;
+	int b = rm>=0 ? (rm>>3)&1 : 0;
+	if(mm==1 & w==0 & b==0)
+		{
+		jit_byte(c, 0xc5);
+		jit_byte(c, ((!r)<<7) | ((~vvvv&15)<<3) | (l<<2) | pp);
+		}
+	else
+		{
+		jit_byte(c, 0xc4);
+		jit_byte(c, ((!r)<<7) | (1<<6) | ((!b)<<5) | mm);
+		jit_byte(c, (w<<7) | ((~vvvv&15)<<3) | (l<<2) | pp);
+		}
+	jit_byte(c, op);
+	return;
+	}
+
+
+
+// EVEX prefix (66 prefix, 512-bit length) and opcode; rm_reg tells if rm is a register or the base of a memory operand,
+// aaa is the opmask register, z the zeroing-masking and bcst the embedded broadcast
+static void jit_evex(struct jit_code *c, int mm, int w, int reg, int vvvv, int rm, int rm_reg, int aaa, int z, int bcst, int op)
+	{
+	int pp = 1;
+	int r = (reg>>3) & 1;
+	int r1 = (reg>>4) & 1;
+	int b = rm>=0 ? (rm>>3)&1 : 0;
+	int x = rm_reg ? (rm>>4)&1 : 0;
+	int v1 = (vvvv>>4) & 1;
+	jit_byte(c, 0x62);
+	jit_byte(c, ((!r)<<7) | ((!x)<<6) | ((!b)<<5) | ((!r1)<<4) | mm);
+	jit_byte(c, (w<<7) | ((~vvvv&15)<<3) | (1<<2) | pp);
+	jit_byte(c, (z<<7) | (2<<5) | (bcst<<4) | ((!v1)<<3) | aaa);
+	jit_byte(c, op);
+	return;
+	}
+
+
+
+//
+// vector instructions on ymm (AVX2) or zmm (AVX-512) registers; the masked loads and stores use ymm15 (AVX2) or k1 (AVX-512)
+//
+
+// d = 0
+static void jit_vzero(struct jit_code *c, int avx512, int d)
+	{
+	if(avx512)
+		{
+		// vpxorq
+		jit_evex(c, 1, 1, d, d, d, 1, 0, 0, 0, 0xef);
+		}
+	else
+		{
+		// vxorpd
+		jit_vex(c, 1, 0, 1, d, d, d, 0x57);
+		}
+	jit_reg(c, d, d);
+	return;
+	}
+
+
+
+// d = [base+disp]
+static void jit_vload(struct jit_code *c, int avx512, int d, int base, int disp, int masked)
+	{
+	if(avx512)
+		{
+		// vmovupd
+		jit_evex(c, 1, 1, d, 0, base, 0, masked, masked, 0, 0x10);
+		jit_mem(c, d, base, disp, 64);
+		}
+	else if(masked)
+		{
+		// vmaskmovpd
+		jit_vex(c, 2, 0, 1, d, 15, base, 0x2d);
+		jit_mem(c, d, base, disp, 1);
+		}
+	else
+		{
+		// vmovupd
+		jit_vex(c, 1, 0, 1, d, 0, base, 0x10);
+		jit_mem(c, d, base, disp, 1);
+		}
+	return;
+	}
+
+
+
+// [base+disp] = s
+static void jit_vstore(struct jit_code *c, int avx512, int s, int base, int disp, int masked)
+	{
+	if(avx512)
+		{
+		// vmovupd
+		jit_evex(c, 1, 1, s, 0, base, 0, masked, 0, 0, 0x11);
+		jit_mem(c, s, base, disp, 64);
+		}
+	else if(masked)
+		{
+		// vmaskmovpd
+		jit_vex(c, 2, 0, 1, s, 15, base, 0x2f);
+		jit_mem(c, s, base, disp, 1);
+		}
+	else
+		{
+		// vmovupd
+		jit_vex(c, 1, 0, 1, s, 0, base, 0x11);
+		jit_mem(c, s, base, disp, 1);
+		}
+	return;
+	}
+
+
+
+// d = broadcast of the double at [base+disp]
+static void jit_vbroadcast(struct jit_code *c, int avx512, int d, int base, int disp)
+	{
+	// vbroadcastsd
+	if(avx512)
+		{
+		jit_evex(c, 2, 1, d, 0, base, 0, 0, 0, 0, 0x19);
+		jit_mem(c, d, base, disp, 8);
+		}
+	else
+		{
+		jit_vex(c, 2, 0, 1, d, 0, base, 0x19);
+		jit_mem(c, d, base, disp, 1);
+		}
+	return;
+	}
+
+
+
+// d += a * b, d = a * b or d = a + b on registers
+static void jit_varith(struct jit_code *c, int avx512, int op, int d, int a, int b)
+	{
+	int mm = op==0xb8 ? 2 : 1;
+	int w = op==0xb8 ? 1 : 0;
+	if(avx512)
+		jit_evex(c, mm, 1, d, a, b, 1, 0, 0, 0, op);
+	else
+		jit_vex(c, mm, w, 1, d, a, b, op);
+	jit_reg(c, d, b);
+	return;
+	}
+
+#define JIT_VFMADD231PD 0xb8
+#define JIT_VMULPD 0x59
+#define JIT_VADDPD 0x58
+
+
+
+// d += a * (broadcast of the double at [base+disp]) or d = a * (broadcast of the double at [base+disp]) (AVX-512 only)
+static void jit_varith_bcst(struct jit_code *c, int op, int d, int a, int base, int disp)
+	{
+	int mm = op==0xb8 ? 2 : 1;
+	jit_evex(c, mm, 1, d, a, base, 0, 0, 0, 1, op);
+	jit_mem(c, d, base, disp, 8);
+	return;
+	}
+
+
+
+//
+// general-purpose instructions
+//
+
+// d = s + disp (lea)
+static void jit_lea(struct jit_code *c, int d, int s, int disp)
+	{
+	jit_byte(c, 0x48 | (((d>>3)&1)<<2) | ((s>>3)&1));
+	jit_byte(c, 0x8d);
+	jit_mem(c, d, s, disp, 1);
+	return;
+	}
+
+
+
+// d += imm (64-bit)
+static void jit_add_imm(struct jit_code *c, int d, int imm)
+	{
+	jit_byte(c, 0x48 | ((d>>3)&1));
+	jit_byte(c, 0x81);
+	jit_reg(c, 0, d);
+	jit_int32(c, imm);
+	return;
+	}
+
+
+
+// d = imm (32-bit)
+static void jit_mov_imm(struct jit_code *c, int d, int imm)
+	{
+	if(d>=8)
+		jit_byte(c, 0x41);
+	jit_byte(c, 0xb8 | (d&7));
+	jit_int32(c, imm);
+	return;
+	}
+
+
+
+// d -= 1 (32-bit), and jump to target if not zero
+static void jit_dec_jnz(struct jit_code *c, int d, int target)
+	{
+	int rel;
+	if(d>=8)
+		jit_byte(c, 0x41);
+	jit_byte(c, 0x83);
+	jit_reg(c, 5, d);
+	jit_byte(c, 1);
+	rel = target - (c->size+2);
+	if(rel>=-128)
+		{
+		jit_byte(c, 0x75);
+		jit_byte(c, rel);
+		}
+	else
+		{
+		jit_byte(c, 0x0f);
+		jit_byte(c, 0x85);
+		jit_int32(c, target - (c->size+4));
+		}
+	return;
+	}
+
+
+
+//
+// dgemm kernel generator
+//
+
+// offset (in doubles) of the element (kk,j) of op(B)
+static int jit_boff(struct blasfeo_djit_dgemm *jit, int kk, int j)
+	{
+	return jit->tb=='n' ? mat_off(jit->ldb, kk, j) : mat_off(jit->ldb, j, kk);
+	}
+
+
+
+// one step kk of the k loop of a tile of nv vector registers of rows (from the vector row iv) and nc columns (from the column j0);
+// the element (0,0) of A and op(B) of the tile is at [abase+8*aoff0] and [bbase+8*boff0]
+static void jit_dgemm_step(struct jit_code *c, struct blasfeo_djit_dgemm *jit, int avx512, int iv, int nv, int j0, int nc, int kk, int abase, int aoff0, int bbase, int boff0)
+	{
+	int vl = avx512 ? 8 : 4;
+	int ra = avx512 ? 24 : 12; // first register of A
+	int rb = avx512 ? 27 : 14; // register of op(B)
+	int nvm = (jit->m+vl-1)/vl;
+	int v, jj;
+	for(v=0; v<nv; v++)
+		{
+		jit_vload(c, avx512, ra+v, abase, 8*(mat_off(jit->lda, (iv+v)*vl, kk)-aoff0), iv+v==nvm-1 & jit->m%vl!=0);
+		}
+	for(jj=0; jj<nc; jj++)
+		{
+		jit_vbroadcast(c, avx512, rb, bbase, 8*(jit_boff(jit, kk, j0+jj)-boff0));
+		for(v=0; v<nv; v++)
+			{
+			jit_varith(c, avx512, JIT_VFMADD231PD, v*nc+jj, ra+v, rb);
+			}
+		}
+	return;
+	}
+
+
+
+// tile of nv vector registers of rows (from the vector row iv) and nc columns (from the column j0), with the accumulators
+// in the registers v*nc+jj; the arguments pA, pB, pC and pD are in rdi, rsi, rdx and rcx, and alpha_beta in r8
+static void jit_dgemm_tile(struct jit_code *c, struct blasfeo_djit_dgemm *jit, int avx512, int loop, int iv, int nv, int j0, int nc)
+	{
+	int vl = avx512 ? 8 : 4;
+	int ra = avx512 ? 24 : 12;
+	int nvm = (jit->m+vl-1)/vl;
+	int v, jj, kk, aoff0, boff0, target;
+
+	for(v=0; v<nv*nc; v++)
+		{
+		jit_vzero(c, avx512, v);
+		}
+
+	if(loop)
+		{
+		// r11 and r9 walk on A and op(B), r10 counts the iterations
+		aoff0 = mat_off(jit->lda, iv*vl, 0);
+		boff0 = jit_boff(jit, 0, j0);
+		jit_lea(c, JIT_R11, JIT_RDI, 8*aoff0);
+		jit_lea(c, JIT_R9, JIT_RSI, 8*boff0);
+		jit_mov_imm(c, JIT_R10, jit->k/JIT_KU);
+		target = c->size;
+		for(kk=0; kk<JIT_KU; kk++)
+			{
+			jit_dgemm_step(c, jit, avx512, iv, nv, j0, nc, kk, JIT_R11, aoff0, JIT_R9, boff0);
+			}
+		jit_add_imm(c, JIT_R11, 8*(mat_off(jit->lda, 0, JIT_KU)-mat_off(jit->lda, 0, 0)));
+		jit_add_imm(c, JIT_R9, 8*(jit_boff(jit, JIT_KU, 0)-jit_boff(jit, 0, 0)));
+		jit_dec_jnz(c, JIT_R10, target);
+		for(kk=0; kk<jit->k%JIT_KU; kk++)
+			{
+			jit_dgemm_step(c, jit, avx512, iv, nv, j0, nc, kk, JIT_R11, aoff0, JIT_R9, boff0);
+			}
+		}
+	else
+		{
+		for(kk=0; kk<jit->k; kk++)
+			{
+			jit_dgemm_step(c, jit, avx512, iv, nv, j0, nc, kk, JIT_RDI, 0, JIT_RSI, 0);
+			}
+		}
+
+	// scale by alpha
+	if(jit->alpha_case==0)
+		{
+		if(!avx512)
+			jit_vbroadcast(c, avx512, 14, JIT_R8, 0);
+		for(v=0; v<nv*nc; v++)
+			{
+			if(avx512)
+				jit_varith_bcst(c, JIT_VMULPD, v, v, JIT_R8, 0);
+			else
+				jit_varith(c, avx512, JIT_VMULPD, v, v, 14);
+			}
+		}
+
+	// add beta * C, with C loaded in the first register of A
+	if(jit->beta_case!=0)
+		{
+		if(!avx512 & jit->beta_case==2)
+			jit_vbroadcast(c, avx512, 13, JIT_R8, 8);
+		for(v=0; v<nv; v++)
+			{
+			for(jj=0; jj<nc; jj++)
+				{
+				jit_vload(c, avx512, ra, JIT_RDX, 8*mat_off(jit->ldc, (iv+v)*vl, j0+jj), iv+v==nvm-1 & jit->m%vl!=0);
+				if(jit->beta_case==1)
+					jit_varith(c, avx512, JIT_VADDPD, v*nc+jj, v*nc+jj, ra);
+				else if(avx512)
+					jit_varith_bcst(c, JIT_VFMADD231PD, v*nc+jj, ra, JIT_R8, 8);
+				else
+					jit_varith(c, avx512, JIT_VFMADD231PD, v*nc+jj, ra, 13);
+				}
+			}
+		}
+
+	// store D
+	for(v=0; v<nv; v++)
+		{
+		for(jj=0; jj<nc; jj++)
+			{
+			jit_vstore(c, avx512, v*nc+jj, JIT_RCX, 8*mat_off(jit->ldd, (iv+v)*vl, j0+jj), iv+v==nvm-1 & jit->m%vl!=0);
+			}
+		}
+
+	return;
+	}
+
+
+
+// code of the kernel: data block, then the entry point
+static void jit_dgemm_code(struct jit_code *c, struct blasfeo_djit_dgemm *jit, int avx512)
+	{
+	int vl = avx512 ? 8 : 4; // doubles per vector register
+	int mr = avx512 ? 3 : 2; // max vector registers of rows of a tile
+	int nr = avx512 ? 8 : 6; // max columns of a tile
+	int nvm = (jit->m+vl-1)/vl;
+	int mb = (nvm+mr-1)/mr; // tiles in the row and column directions, balanced
+	int nb = (jit->n+nr-1)/nr;
+	int ii, jj, iv, nv, j0, nc, loop;
+	int64_t mask[4];
+
+	// data
+	for(ii=0; ii<4; ii++)
+		{
+		mask[ii] = ii<jit->m%4 ? -1 : 0;
+		}
+	memset(c->buf, 0, JIT_DATA_SIZE);
+	memcpy(c->buf+JIT_DATA_MASK, mask, sizeof(mask));
+	c->size = JIT_DATA_SIZE;
+
+	// masks of the last rows
+	if(jit->m%vl!=0)
+		{
+		if(avx512)
+			{
+			// kmovw k1, eax
+			jit_mov_imm(c, JIT_RAX, (1<<(jit->m%vl))-1);
+			jit_byte(c, 0xc5);
+			jit_byte(c, 0xf8);
+			jit_byte(c, 0x92);
+			jit_reg(c, 1, JIT_RAX);
+			}
+		else
+			{
+			jit_vload(c, avx512, 15, JIT_RIP, JIT_DATA_MASK, 0);
+			}
+		}
+
+	// fully unrolled k, or loop on k for the large kernels
+	loop = nvm*jit->n*jit->k > JIT_MAX_UNROLL & jit->k >= 2*JIT_KU;
+
+	iv = 0;
+	for(ii=0; ii<mb; ii++)
+		{
+		nv = (nvm-iv)/(mb-ii);
+		nv += (nvm-iv)%(mb-ii)!=0;
+		j0 = 0;
+		for(jj=0; jj<nb; jj++)
+			{
+			nc = (jit->n-j0)/(nb-jj);
+			nc += (jit->n-j0)%(nb-jj)!=0;
+			jit_dgemm_tile(c, jit, avx512, loop, iv, nv, j0, nc);
+			j0 += nc;
+			}
+		iv += nv;
+		}
+
+	// vzeroupper, ret
+	jit_byte(c, 0xc5);
+	jit_byte(c, 0xf8);
+	jit_byte(c, 0x77);
+	jit_byte(c, 0xc3);
+
+	return;
+	}
+
+
+
+// instruction set of the generated kernels: 2 for AVX-512, 1 for AVX2, 0 if not supported
+static int jit_isa()
+	{
+	static int isa = -1;
+	int features;
+	if(isa<0)
+		{
+		blasfeo_processor_cpu_features(&features);
+		isa = 0;
+		if((features&BLASFEO_PROCESSOR_FEATURE_AVX2)!=0 & (features&BLASFEO_PROCESSOR_FEATURE_FMA)!=0)
+			isa = 1;
+#if defined(JIT_PANELMAJ)
+		// a zmm register has to fit in a panel
+		if((features&BLASFEO_PROCESSOR_FEATURE_AVX512F)!=0 & D_PS%8==0)
+#else
+		if((features&BLASFEO_PROCESSOR_FEATURE_AVX512F)!=0)
+#endif
+			isa = 2;
+		}
+	return isa;
+	}
+
+
+
+// generate the kernel, in memory mapped with write and then execute permission; return 0 on success
+static int jit_dgemm_generate(struct blasfeo_djit_dgemm *jit, int isa)
+	{
+	struct jit_code c;
+	size_t page, len;
+	void *mem;
+
+	c.max = 4096;
+	c.size = 0;
+	c.error = 0;
+	blasfeo_malloc((void **) &c.buf, c.max);
+	if(c.buf==NULL)
+		return 1;
+
+	jit_dgemm_code(&c, jit, isa==2);
+	if(c.error)
+		{
+		blasfeo_free(c.buf);
+		return 1;
+		}
+
+	page = sysconf(_SC_PAGESIZE);
+	len = (c.size+page-1)/page*page;
+	mem = mmap(NULL, len, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANON, -1, 0);
+	if(mem==MAP_FAILED)
+		{
+		blasfeo_free(c.buf);
+		return 1;
+		}
+	memcpy(mem, c.buf, c.size);
+	blasfeo_free(c.buf);
+	if(mprotect(mem, len, PROT_READ|PROT_EXEC)!=0)
+		{
+		munmap(mem, len);
+		return 1;
+		}
+
+	jit->code = mem;
+	jit->code_size = len;
+	jit->kernel = (void (*)(double *, double *, double *, double *, double *)) ((char *) mem + JIT_DATA_SIZE);
+	return 0;
+	}
+
+
+
+//
+// kernel cache: a hash table with a list of kernels per bucket; the lookups are lock-free, the kernels being
+// pushed on the list heads (atomically, after being fully initialized) and never removed until blasfeo_djit_free;
+// once it holds JIT_MAX_KERNELS kernels, no more are generated
+//
+
+static struct blasfeo_djit_dgemm *jit_cache[JIT_BUCKETS];
+static int jit_count = 0;
+
+#if defined(MULTI_THREAD)
+static pthread_mutex_t jit_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+
+
+// independent products of the key fields, not to serialize the lookup on a chain of multiplications
+static unsigned int jit_hash(struct blasfeo_djit_dgemm *key)
+	{
+	uint64_t h = (uint64_t) (key->ta + 256*key->tb) * 0x9e3779b97f4a7c15ULL
+		^ (uint64_t) (key->m + 64*key->n + 4096*key->k) * 0xc2b2ae3d27d4eb4fULL
+		^ (uint64_t) (key->lda + 65536*key->ldb) * 0x165667b19e3779f9ULL
+		^ (uint64_t) (key->ldc + 65536*key->ldd) * 0x27d4eb2f165667c5ULL
+		^ (uint64_t) (key->alpha_case + 4*key->beta_case) * 0x85ebca77c2b2ae63ULL;
+	return (unsigned int) (h>>32) % JIT_BUCKETS;
+	}
+
+
+
+static int jit_equal(struct blasfeo_djit_dgemm *a, struct blasfeo_djit_dgemm *b)
+	{
+	return a->ta==b->ta & a->tb==b->tb & a->m==b->m & a->n==b->n & a->k==b->k
+		& a->lda==b->lda & a->ldb==b->ldb & a->ldc==b->ldc & a->ldd==b->ldd
+		& a->alpha_case==b->alpha_case & a->beta_case==b->beta_case;
+	}
+
+
+
+static struct blasfeo_djit_dgemm *jit_lookup(struct blasfeo_djit_dgemm *key, unsigned int h)
+	{
+	struct blasfeo_djit_dgemm *jit = __atomic_load_n(&jit_cache[h], __ATOMIC_ACQUIRE);
+	while(jit!=NULL)
+		{
+		if(jit_equal(jit, key))
+			return jit;
+		jit = jit->next;
+		}
+	return NULL;
+	}
+
+
+
+#endif // JIT_X64
+
+
+
+// variant of the kernel for alpha and beta
+static int jit_alpha_case(double alpha)
+	{
+	return alpha==1.0 ? 1 : 0;
+	}
+
+static int jit_beta_case(double beta)
+	{
+	return beta==0.0 ? 0 : beta==1.0 ? 1 : 2;
+	}
+
+
+
+struct blasfeo_djit_dgemm *blasfeo_djit_dgemm_dispatch(char ta, char tb, int m, int n, int k, double alpha, struct blasfeo_dmat *sA, struct blasfeo_dmat *sB, double beta, struct blasfeo_dmat *sC, struct blasfeo_dmat *sD)
+	{
+#if defined(JIT_X64)
+
+	struct blasfeo_djit_dgemm key, *jit;
+	unsigned int h;
+	int isa;
+
+	if(ta!='n' | (tb!='n' & tb!='t'))
+		return NULL;
+	if(m<=0 | n<=0 | k<=0 | m>JIT_MAX_SIZE | n>JIT_MAX_SIZE | k>JIT_MAX_SIZE)
+		return NULL;
+	isa = jit_isa();
+	if(isa==0)
+		return NULL;
+
+	memset(&key, 0, sizeof(key));
+	key.ta = ta;
+	key.tb = tb;
+	key.m = m;
+	key.n = n;
+	key.k = k;
+	key.alpha_case = jit_alpha_case(alpha);
+	key.beta_case = jit_beta_case(beta);
+	key.lda = mat_ld(sA);
+	key.ldb = mat_ld(sB);
+	key.ldc = beta!=0.0 ? mat_ld(sC) : 0;
+	key.ldd = mat_ld(sD);
+	h = jit_hash(&key);
+
+	jit = jit_lookup(&key, h);
+	if(jit!=NULL)
+		return jit;
+
+#if defined(MULTI_THREAD)
+	pthread_mutex_lock(&jit_mutex);
+#endif
+	// generated meanwhile by another thread
+	jit = jit_lookup(&key, h);
+	if(jit==NULL & jit_count<JIT_MAX_KERNELS)
+		{
+		blasfeo_malloc((void **) &jit, sizeof(struct blasfeo_djit_dgemm));
+		if(jit!=NULL)
+			{
+			*jit = key;
+			if(jit_dgemm_generate(jit, isa)!=0)
+				{
+				blasfeo_free(jit);
+				jit = NULL;
+				}
+			else
+				{
+				jit->next = jit_cache[h];
+				__atomic_store_n(&jit_cache[h], jit, __ATOMIC_RELEASE);
+				jit_count++;
+				}
+			}
+		}
+#if defined(MULTI_THREAD)
+	pthread_mutex_unlock(&jit_mutex);
+#endif
+
+	return jit;
+
+#else
+
+	return NULL;
+
+#endif // JIT_X64
+	}
+
+
+
+void blasfeo_djit_dgemm_run(struct blasfeo_djit_dgemm *jit, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	// alpha and beta not of the variant of the kernel
+	int other = (jit->alpha_case==1 & jit_alpha_case(alpha)!=1) | (jit->beta_case==2 ? beta==0.0 : jit_beta_case(beta)!=jit->beta_case);
+#if defined(JIT_PANELMAJ)
+	// the kernel addresses the matrices from the top of a panel
+	other |= ((ai | bi | ci | di) & (D_PS-1)) != 0;
+#endif
+	// matrices with strides other than the ones baked in the kernel
+	other |= (mat_ld(sA)!=jit->lda) | (mat_ld(sB)!=jit->ldb) | (jit->beta_case!=0 & mat_ld(sC)!=jit->ldc) | (mat_ld(sD)!=jit->ldd);
+	if(other)
+		{
+		jit_dgemm_ref(jit->ta, jit->tb, jit->m, jit->n, jit->k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+		return;
+		}
+
+	double alpha_beta[2] = {alpha, beta};
+	double *pC = jit->beta_case!=0 ? sC->pA + mat_off(jit->ldc, ci, cj) : NULL;
+	jit->kernel(sA->pA+mat_off(jit->lda, ai, aj), sB->pA+mat_off(jit->ldb, bi, bj), pC, sD->pA+mat_off(jit->ldd, di, dj), alpha_beta);
+
+	sD->use_dA = 0;
+
+	return;
+
+	}
+
+
+
+void blasfeo_djit_dgemm(char ta, char tb, int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	if(m<=0 | n<=0)
+		return;
+
+	struct blasfeo_djit_dgemm *jit = blasfeo_djit_dgemm_dispatch(ta, tb, m, n, k, alpha, sA, sB, beta, sC, sD);
+	if(jit!=NULL)
+		blasfeo_djit_dgemm_run(jit, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	else
+		jit_dgemm_ref(ta, tb, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+
+	return;
+
+	}
+
+
+
+void blasfeo_djit_free()
+	{
+#if defined(JIT_X64)
+
+	struct blasfeo_djit_dgemm *jit, *next;
+	int ii;
+
+#if defined(MULTI_THREAD)
+	pthread_mutex_lock(&jit_mutex);
+#endif
+	for(ii=0; ii<JIT_BUCKETS; ii++)
+		{
+		jit = jit_cache[ii];
+		while(jit!=NULL)
+			{
+			next = jit->next;
+			munmap(jit->code, jit->code_size);
+			blasfeo_free(jit);
+			jit = next;
+			}
+		jit_cache[ii] = NULL;
+		}
+	jit_count = 0;
+#if defined(MULTI_THREAD)
+	pthread_mutex_unlock(&jit_mutex);
+#endif
+
+#endif // JIT_X64
+	return;
+	}
@@ -0,0 +1,546 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <blasfeo_common.h>
+#include <blasfeo_d_aux.h>
+#include <blasfeo_d_blasfeo_api.h>
+#include <blasfeo_thread.h>
+
+
+
+// target number of elements of a leaf block
+#define TSQR_LEAF_SIZE 32768
+
+
+
+// tall-skinny QR (lq=0) of a (m)x(n) matrix, or short-wide LQ (lq=1) of a (n)x(m) matrix:
+// the long dimension is split into nl leaf blocks, that are factorized independently,
+// and their (n)x(n) triangular factors are combined pairwise in a binary reduction tree;
+// the Householder reflectors of the leaves and of the tree nodes are kept in the workspace,
+// and the same tree is traversed to apply Q^T to the (m)x(nrhs) matrix D, or Q^T from the right to the
+// (nrhs)x(m) matrix D for LQ (apply=1)
+struct tsqr_arg
+	{
+	struct blasfeo_dmat *sC;
+	struct blasfeo_dmat *sD;
+	struct blasfeo_dmat *blk; // the nl leaf blocks, followed by the nl-1 nodes of the tree
+	int *child; // children of the tree nodes, as indices in blk
+	int *level; // first node of each level of the tree, at most 64 levels
+	char **work; // factorization workspace, one per thread
+	int m;
+	int n;
+	int ci;
+	int cj;
+	int nl;
+	int nlev;
+	int lq;
+	int apply;
+	int nrhs;
+	int di;
+	int dj;
+#if defined(MULTI_THREAD)
+	struct blasfeo_barrier *bar;
+#endif
+	};
+
+
+
+// number of leaf blocks, each with at least n rows
+static int tsqr_nl(int m, int n)
+	{
+	int mb = TSQR_LEAF_SIZE/n;
+	if(mb<n)
+		mb = n;
+	int nl = m/mb;
+	return nl>1 ? nl : 1;
+	}
+
+
+
+// number of factorization workspaces
+static int tsqr_nwork(int nl)
+	{
+#if defined(MULTI_THREAD)
+	return nl<BLASFEO_MAX_THREADS ? nl : BLASFEO_MAX_THREADS;
+#else
+	return 1;
+#endif
+	}
+
+
+
+// rows of the leaf block ii
+static int tsqr_mb(int m, int nl, int ii)
+	{
+	return m/nl + (ii<m%nl);
+	}
+
+
+
+// first row of the leaf block ii
+static int tsqr_i0(int m, int nl, int ii)
+	{
+	return ii*(m/nl) + (ii<m%nl ? ii : m%nl);
+	}
+
+
+
+// factorization workspace of a leaf block or a node
+static size_t tsqr_fact_worksize(int lq, int m, int n, int nl)
+	{
+	int mb = tsqr_mb(m, nl, 0);
+	size_t s0 = lq ? blasfeo_dgelqf_worksize(n, mb) : blasfeo_dgeqrf_worksize(mb, n);
+	size_t s1 = lq ? blasfeo_dgelqf_worksize(n, 2*n) : blasfeo_dgeqrf_worksize(2*n, n);
+	return s0>s1 ? s0 : s1;
+	}
+
+
+
+static size_t tsqr_memsize_blk(int lq, int m, int n)
+	{
+	return (blasfeo_memsize_dmat(lq ? n : m, lq ? m : n) + 63)/64*64;
+	}
+
+
+
+static size_t tsqr_worksize(int lq, int m, int n)
+	{
+	if(m<=0 | n<=0)
+		return 0;
+	int ii;
+	int nl = tsqr_nl(m, n);
+	int nwork = tsqr_nwork(nl);
+	size_t size = 64; // alignment of the work pointer
+	size += ((2*nl-1)*sizeof(struct blasfeo_dmat) + 63)/64*64;
+	size += ((3*nl+64)*sizeof(int) + nwork*sizeof(char *) + 63)/64*64;
+	for(ii=0; ii<nl; ii++)
+		size += tsqr_memsize_blk(lq, tsqr_mb(m, nl, ii), n);
+	size += (nl-1)*tsqr_memsize_blk(lq, 2*n, n);
+	size += nwork*((tsqr_fact_worksize(lq, m, n, nl) + 63)/64*64);
+	return size;
+	}
+
+
+
+// copy the triangular factor of sA into the block (bi,bj) of sB
+static void tsqr_trcp(int lq, int n, struct blasfeo_dmat *sA, struct blasfeo_dmat *sB, int bi, int bj)
+	{
+	int jj;
+	if(lq)
+		{
+		blasfeo_dtrcp_l(n, sA, 0, 0, sB, bi, bj);
+		}
+	else
+		{
+		for(jj=0; jj<n; jj++)
+			blasfeo_dgecp(jj+1, 1, sA, 0, jj, sB, bi, bj+jj);
+		}
+	}
+
+
+
+// leaf block ii: copy from C and factorize
+static void tsqr_leaf(struct tsqr_arg *arg, int ii, void *work)
+	{
+	int m = arg->m;
+	int n = arg->n;
+	int nl = arg->nl;
+	int mb = tsqr_mb(m, nl, ii);
+	int i0 = tsqr_i0(m, nl, ii);
+	struct blasfeo_dmat *sL = arg->blk+ii;
+	if(arg->lq)
+		{
+		blasfeo_dgecp(n, mb, arg->sC, arg->ci, arg->cj+i0, sL, 0, 0);
+		blasfeo_dgelqf(n, mb, sL, 0, 0, sL, 0, 0, work);
+		}
+	else
+		{
+		blasfeo_dgecp(mb, n, arg->sC, arg->ci+i0, arg->cj, sL, 0, 0);
+		blasfeo_dgeqrf(mb, n, sL, 0, 0, sL, 0, 0, work);
+		}
+	}
+
+
+
+// tree node jj: stack the triangular factors of its two children and factorize
+static void tsqr_node(struct tsqr_arg *arg, int jj, void *work)
+	{
+	int n = arg->n;
+	struct blasfeo_dmat *sA = arg->blk+arg->child[2*jj+0];
+	struct blasfeo_dmat *sB = arg->blk+arg->child[2*jj+1];
+	struct blasfeo_dmat *sN = arg->blk+arg->nl+jj;
+	if(arg->lq)
+		{
+		blasfeo_dgese(n, 2*n, 0.0, sN, 0, 0);
+		tsqr_trcp(1, n, sA, sN, 0, 0);
+		tsqr_trcp(1, n, sB, sN, 0, n);
+		blasfeo_dgelqf(n, 2*n, sN, 0, 0, sN, 0, 0, work);
+		}
+	else
+		{
+		blasfeo_dgese(2*n, n, 0.0, sN, 0, 0);
+		tsqr_trcp(0, n, sA, sN, 0, 0);
+		tsqr_trcp(0, n, sB, sN, n, 0);
+		blasfeo_dgeqrf(2*n, n, sN, 0, 0, sN, 0, 0, work);
+		}
+	}
+
+
+
+// first row of C (and D) of the leaf block or tree node ii: the top n rows of the left-most leaf below it
+static int tsqr_row0(struct tsqr_arg *arg, int ii)
+	{
+	while(ii>=arg->nl)
+		ii = arg->child[2*(ii-arg->nl)+0];
+	return tsqr_i0(arg->m, arg->nl, ii);
+	}
+
+
+
+// element (ii,jj) of sA, or (jj,ii) for LQ
+static double *tsqr_el(int lq, struct blasfeo_dmat *sA, int ii, int jj)
+	{
+	return lq ? &BLASFEO_DMATEL(sA, jj, ii) : &BLASFEO_DMATEL(sA, ii, jj);
+	}
+
+
+
+// D <= H_{n-1} * ... * H_0 * D, with the reflectors H_k stored below the diagonal of the (mv)x(n) matrix V and
+// the scalar factors in tau; row r of V corresponds to the row r0+r of D for r<nr0, and to the row r1+r-nr0 otherwise,
+// and the nrhs columns of D start at d0; for LQ (lq=1) V and D are transposed, i.e. D <= D * H_0 * ... * H_{n-1}
+static void tsqr_apply_blk(int lq, int mv, int n, struct blasfeo_dmat *sV, int vi, int vj, double *tau, int nr0, int r0, int r1, int nrhs, struct blasfeo_dmat *sD, int d0)
+	{
+	int ii, jj, kk, ri;
+	double tmp;
+	int kmax = mv<n ? mv : n;
+	for(kk=0; kk<kmax; kk++)
+		{
+		if(tau[kk]==0.0)
+			continue;
+		for(jj=0; jj<nrhs; jj++)
+			{
+			// v[kk] = 1.0
+			tmp = *tsqr_el(lq, sD, kk<nr0 ? r0+kk : r1+kk-nr0, d0+jj);
+			for(ii=kk+1; ii<mv; ii++)
+				{
+				ri = ii<nr0 ? r0+ii : r1+ii-nr0;
+				tmp += *tsqr_el(lq, sV, vi+ii, vj+kk) * *tsqr_el(lq, sD, ri, d0+jj);
+				}
+			tmp *= tau[kk];
+			*tsqr_el(lq, sD, kk<nr0 ? r0+kk : r1+kk-nr0, d0+jj) -= tmp;
+			for(ii=kk+1; ii<mv; ii++)
+				{
+				ri = ii<nr0 ? r0+ii : r1+ii-nr0;
+				*tsqr_el(lq, sD, ri, d0+jj) -= tmp * *tsqr_el(lq, sV, vi+ii, vj+kk);
+				}
+			}
+		}
+	}
+
+
+
+// leaf block ii: apply its Q^T to its rows of D (columns for LQ)
+static void tsqr_leaf_apply(struct tsqr_arg *arg, int ii)
+	{
+	int lq = arg->lq;
+	int mb = tsqr_mb(arg->m, arg->nl, ii);
+	int i0 = tsqr_i0(arg->m, arg->nl, ii);
+	struct blasfeo_dmat *sL = arg->blk+ii;
+	int d0 = lq ? arg->dj : arg->di;
+	tsqr_apply_blk(lq, mb, arg->n, sL, 0, 0, sL->dA, mb, d0+i0, 0, arg->nrhs, arg->sD, lq ? arg->di : arg->dj);
+	}
+
+
+
+// tree node jj: apply its Q^T to the top n rows (left-most n columns for LQ) of its two children, stacked
+static void tsqr_node_apply(struct tsqr_arg *arg, int jj)
+	{
+	int lq = arg->lq;
+	int n = arg->n;
+	struct blasfeo_dmat *sN = arg->blk+arg->nl+jj;
+	int r0 = tsqr_row0(arg, arg->child[2*jj+0]);
+	int r1 = tsqr_row0(arg, arg->child[2*jj+1]);
+	int d0 = lq ? arg->dj : arg->di;
+	tsqr_apply_blk(lq, 2*n, n, sN, 0, 0, sN->dA, n, d0+r0, d0+r1, arg->nrhs, arg->sD, lq ? arg->di : arg->dj);
+	}
+
+
+
+// the leaf blocks and the nodes of each level of the tree are distributed round-robin over the threads
+static void tsqr_work(int tid, int nth, void *ptr)
+	{
+	struct tsqr_arg *arg = ptr;
+	void *work = arg->work[tid];
+	int ii, jj;
+
+	for(ii=tid; ii<arg->nl; ii+=nth)
+		{
+		if(arg->apply)
+			tsqr_leaf_apply(arg, ii);
+		else
+			tsqr_leaf(arg, ii, work);
+		}
+
+	for(ii=0; ii<arg->nlev; ii++)
+		{
+#if defined(MULTI_THREAD)
+		if(nth>1)
+			blasfeo_barrier_wait(arg->bar);
+#endif
+		for(jj=arg->level[ii]+tid; jj<arg->level[ii+1]; jj+=nth)
+			{
+			if(arg->apply)
+				tsqr_node_apply(arg, jj);
+			else
+				tsqr_node(arg, jj, work);
+			}
+		}
+
+	return;
+	}
+
+
+
+// partition the workspace and build the reduction tree, deterministic in (lq, m, n);
+// the matrices of the leaf blocks and of the nodes are created only before the factorization (create=1)
+static void tsqr_layout(struct tsqr_arg *arg, int lq, int m, int n, void *v_work, int create)
+	{
+	int ii, jj, cnt, nn;
+
+	int nl = tsqr_nl(m, n);
+	int nwork = tsqr_nwork(nl);
+
+	arg->m = m;
+	arg->n = n;
+	arg->nl = nl;
+	arg->lq = lq;
+
+	char *c_ptr = (char *) ( ( (size_t) v_work + 63 ) / 64 * 64 );
+	arg->blk = (struct blasfeo_dmat *) c_ptr;
+	c_ptr += ((2*nl-1)*sizeof(struct blasfeo_dmat) + 63)/64*64;
+	arg->work = (char **) c_ptr;
+	arg->child = (int *) (arg->work+nwork);
+	arg->level = arg->child + 2*nl;
+	c_ptr += ((3*nl+64)*sizeof(int) + nwork*sizeof(char *) + 63)/64*64;
+	for(ii=0; ii<nl; ii++)
+		{
+		nn = tsqr_mb(m, nl, ii);
+		if(create)
+			blasfeo_create_dmat(lq ? n : nn, lq ? nn : n, arg->blk+ii, c_ptr);
+		c_ptr += tsqr_memsize_blk(lq, nn, n);
+		}
+	for(ii=0; ii<nl-1; ii++)
+		{
+		if(create)
+			blasfeo_create_dmat(lq ? n : 2*n, lq ? 2*n : n, arg->blk+nl+ii, c_ptr);
+		c_ptr += tsqr_memsize_blk(lq, 2*n, n);
+		}
+	for(ii=0; ii<nwork; ii++)
+		{
+		arg->work[ii] = c_ptr;
+		c_ptr += (tsqr_fact_worksize(lq, m, n, nl) + 63)/64*64;
+		}
+
+	// build the tree: each level pairs the consecutive entries of the previous one,
+	// an odd entry is moved up to the next level unchanged
+	int *cur = arg->level + 64; // entries of the current level
+	for(ii=0; ii<nl; ii++)
+		cur[ii] = ii;
+	cnt = nl;
+	jj = 0;
+	arg->nlev = 0;
+	arg->level[0] = 0;
+	while(cnt>1)
+		{
+		nn = cnt/2;
+		for(ii=0; ii<nn; ii++)
+			{
+			arg->child[2*(jj+ii)+0] = cur[2*ii+0];
+			arg->child[2*(jj+ii)+1] = cur[2*ii+1];
+			}
+		for(ii=0; ii<nn; ii++)
+			cur[ii] = nl+jj+ii;
+		if(cnt%2)
+			cur[nn] = cur[cnt-1];
+		jj += nn;
+		cnt = nn + cnt%2;
+		arg->nlev++;
+		arg->level[arg->nlev] = jj;
+		}
+
+	return;
+	}
+
+
+
+// traverse the tree, in parallel if worth flops
+static void tsqr_run(struct tsqr_arg *arg, double flops)
+	{
+#if defined(MULTI_THREAD)
+	int nth = blasfeo_get_num_threads_flops(flops);
+	int nwork = tsqr_nwork(arg->nl);
+	if(nth>nwork)
+		nth = nwork;
+	if(nth>1)
+		{
+		struct blasfeo_barrier bar;
+		blasfeo_barrier_init(&bar, nth);
+		arg->bar = &bar;
+		blasfeo_parallel_run(nth, &tsqr_work, arg);
+		blasfeo_barrier_destroy(&bar);
+		}
+	else
+#endif
+		{
+		tsqr_work(0, 1, arg);
+		}
+	return;
+	}
+
+
+
+static void tsqr(int lq, int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *v_work)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	struct tsqr_arg arg;
+	tsqr_layout(&arg, lq, m, n, v_work, 1);
+	arg.sC = sC;
+	arg.ci = ci;
+	arg.cj = cj;
+	arg.apply = 0;
+
+	tsqr_run(&arg, 2.0*m*n*n);
+
+	// copy the triangular factor of the root (the last node, or the only leaf) into D
+	tsqr_trcp(lq, n, arg.blk+2*arg.nl-2, sD, di, dj);
+
+	return;
+	}
+
+
+
+// D <= Q^T * B, or D <= B * Q^T for LQ, with the reflectors kept in the workspace by tsqr
+static void tsqr_apply(int lq, int m, int n, int nrhs, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *v_work)
+	{
+	if(m<=0 | n<=0 | nrhs<=0)
+		return;
+
+	struct tsqr_arg arg;
+	tsqr_layout(&arg, lq, m, n, v_work, 0);
+	arg.sD = sD;
+	arg.di = di;
+	arg.dj = dj;
+	arg.nrhs = nrhs;
+	arg.apply = 1;
+
+	if(sB!=sD | bi!=di | bj!=dj)
+		blasfeo_dgecp(lq ? nrhs : m, lq ? m : nrhs, sB, bi, bj, sD, di, dj);
+
+	tsqr_run(&arg, 4.0*m*n*nrhs);
+
+	return;
+	}
+
+
+
+size_t blasfeo_dgeqrf_tsqr_worksize(int m, int n)
+	{
+	return tsqr_worksize(0, m, n);
+	}
+
+
+
+void blasfeo_dgeqrf_tsqr(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work)
+	{
+	if(m<n)
+		{
+		printf("\nerror: blasfeo_dgeqrf_tsqr: m<n : %d<%d\n", m, n);
+		exit(1);
+		}
+	tsqr(0, m, n, sC, ci, cj, sD, di, dj, work);
+	}
+
+
+
+void blasfeo_dormqr_tsqr_lt(int m, int n, int nrhs, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work)
+	{
+	tsqr_apply(0, m, n, nrhs, sB, bi, bj, sD, di, dj, work);
+	}
+
+
+
+void blasfeo_dormqr_lt(int m, int n, int nrhs, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0 | nrhs<=0)
+		return;
+	// reflectors below the diagonal of A
+	if(sB!=sD | bi!=di | bj!=dj)
+		blasfeo_dgecp(m, nrhs, sB, bi, bj, sD, di, dj);
+	tsqr_apply_blk(0, m, n, sA, ai, aj, sA->dA+ai, m, di, 0, nrhs, sD, dj);
+	}
+
+
+
+size_t blasfeo_dgelqf_tslq_worksize(int m, int n)
+	{
+	return tsqr_worksize(1, n, m);
+	}
+
+
+
+void blasfeo_dgelqf_tslq(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work)
+	{
+	if(n<m)
+		{
+		printf("\nerror: blasfeo_dgelqf_tslq: n<m : %d<%d\n", n, m);
+		exit(1);
+		}
+	tsqr(1, n, m, sC, ci, cj, sD, di, dj, work);
+	}
+
+
+
+void blasfeo_dormlq_tslq_rt(int m, int n, int nrhs, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work)
+	{
+	tsqr_apply(1, n, m, nrhs, sB, bi, bj, sD, di, dj, work);
+	}
@@ -0,0 +1,218 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_X64_INTEL_SKYLAKE_X)
+#include <mmintrin.h>
+#include <xmmintrin.h>  // SSE
+#include <emmintrin.h>  // SSE2
+#include <pmmintrin.h>  // SSE3
+#include <smmintrin.h>  // SSE4
+#include <immintrin.h>  // AVX
+#endif
+
+#include <blasfeo_common.h>
+#include <blasfeo_block_size.h>
+#include <blasfeo_s_aux.h>
+
+
+
+// return the memory size (in bytes) needed for a half-precision hmat
+size_t blasfeo_memsize_hmat(int m, int n)
+	{
+	const int ps = H_PS;
+	int nc = 4;
+	int pm = (m+ps-1)/ps*ps;
+	int cn = (n+nc-1)/nc*nc;
+	size_t memsize = (size_t) pm*cn*sizeof(unsigned short);
+	memsize = (memsize + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+	return memsize;
+	}
+
+
+
+// create a half-precision hmat for a matrix of size m*n by using memory passed by a pointer
+void blasfeo_create_hmat(int m, int n, struct blasfeo_hmat *sA, void *memory)
+	{
+	const int ps = H_PS;
+	int nc = 4;
+	sA->mem = memory;
+	sA->m = m;
+	sA->n = n;
+	sA->pm = (m+ps-1)/ps*ps;
+	sA->cn = (n+nc-1)/nc*nc;
+	sA->pA = (unsigned short *) memory;
+	sA->memsize = blasfeo_memsize_hmat(m, n);
+	// zero out the padding rows of the last panel, that are loaded together with the others
+	memset(memory, 0, sA->memsize);
+	return;
+	}
+
+
+
+// convert a single-precision scalar to half precision, rounding to nearest even
+unsigned short blasfeo_cvt_s2h(float a)
+	{
+	unsigned int x, mant, rem, half;
+	int expo, shift;
+	unsigned short h;
+	memcpy(&x, &a, sizeof(float));
+	unsigned short sign = (x >> 16) & 0x8000;
+	mant = x & 0x7fffff;
+	if(((x >> 23) & 0xff) == 0xff) // inf and nan
+		return sign | 0x7c00 | (mant ? 0x200 : 0);
+	expo = (int) ((x >> 23) & 0xff) - 127 + 15;
+	if(expo>=31) // overflow
+		return sign | 0x7c00;
+	if(expo<=0) // subnormal or zero
+		{
+		if(expo<-10)
+			return sign;
+		mant |= 0x800000;
+		shift = 14 - expo;
+		h = mant >> shift;
+		rem = mant & ((1u << shift) - 1);
+		half = 1u << (shift - 1);
+		if(rem>half | (rem==half & (h & 1)))
+			h++;
+		return sign | h;
+		}
+	h = sign | (expo << 10) | (mant >> 13);
+	rem = mant & 0x1fff;
+	// a carry from the mantissa correctly rounds up the exponent
+	if(rem>0x1000 | (rem==0x1000 & (h & 1)))
+		h++;
+	return h;
+	}
+
+
+
+// convert a half-precision scalar to single precision
+float blasfeo_cvt_h2s(unsigned short a)
+	{
+	unsigned int sign = (unsigned int) (a & 0x8000) << 16;
+	unsigned int expo = (a >> 10) & 0x1f;
+	unsigned int mant = a & 0x3ff;
+	unsigned int x;
+	float s;
+	if(expo==0x1f) // inf and nan
+		{
+		x = sign | 0x7f800000 | (mant << 13);
+		}
+	else if(expo!=0) // normal
+		{
+		x = sign | ((expo + 127 - 15) << 23) | (mant << 13);
+		}
+	else if(mant==0) // zero
+		{
+		x = sign;
+		}
+	else // subnormal, normalize
+		{
+		expo = 127 - 14;
+		while((mant & 0x400)==0)
+			{
+			mant <<= 1;
+			expo--;
+			}
+		x = sign | (expo << 23) | ((mant & 0x3ff) << 13);
+		}
+	memcpy(&s, &x, sizeof(float));
+	return s;
+	}
+
+
+
+// convert the single-precision matrix A into the half-precision matrix B
+void blasfeo_cvt_s2h_mat(int m, int n, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_hmat *sB, int bi, int bj)
+	{
+	if(m<=0 | n<=0)
+		return;
+	const int ps = H_PS;
+	int ii, jj;
+	for(jj=0; jj<n; jj++)
+		{
+		ii = 0;
+#if defined(LA_HIGH_PERFORMANCE) & defined(MF_PANELMAJ) & ( defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_X64_INTEL_SKYLAKE_X) )
+		// 8 contiguous elements in both matrices if the row offsets are aligned to the half-precision panel
+		if(ai%ps==0 & bi%ps==0)
+			{
+			for(; ii<m-ps+1; ii+=ps)
+				{
+				_mm_storeu_si128((__m128i *) &BLASFEO_HMATEL(sB, bi+ii, bj+jj), _mm256_cvtps_ph(_mm256_loadu_ps(&BLASFEO_SMATEL(sA, ai+ii, aj+jj)), _MM_FROUND_TO_NEAREST_INT));
+				}
+			}
+#endif
+		for(; ii<m; ii++)
+			{
+			BLASFEO_HMATEL(sB, bi+ii, bj+jj) = blasfeo_cvt_s2h(BLASFEO_SMATEL(sA, ai+ii, aj+jj));
+			}
+		}
+	return;
+	}
+
+
+
+// convert the half-precision matrix A into the single-precision matrix B
+void blasfeo_cvt_h2s_mat(int m, int n, struct blasfeo_hmat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj)
+	{
+	if(m<=0 | n<=0)
+		return;
+	const int ps = H_PS;
+	int ii, jj;
+	for(jj=0; jj<n; jj++)
+		{
+		ii = 0;
+#if defined(LA_HIGH_PERFORMANCE) & defined(MF_PANELMAJ) & ( defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_X64_INTEL_SKYLAKE_X) )
+		if(ai%ps==0 & bi%ps==0)
+			{
+			for(; ii<m-ps+1; ii+=ps)
+				{
+				_mm256_storeu_ps(&BLASFEO_SMATEL(sB, bi+ii, bj+jj), _mm256_cvtph_ps(_mm_loadu_si128((__m128i *) &BLASFEO_HMATEL(sA, ai+ii, aj+jj))));
+				}
+			}
+#endif
+		for(; ii<m; ii++)
+			{
+			BLASFEO_SMATEL(sB, bi+ii, bj+jj) = blasfeo_cvt_h2s(BLASFEO_HMATEL(sA, ai+ii, aj+jj));
+			}
+		}
+	return;
+	}
+
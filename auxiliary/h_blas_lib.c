@@ -0,0 +1,192 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <blasfeo_common.h>
+#include <blasfeo_block_size.h>
+#include <blasfeo_s_aux.h>
+#include <blasfeo_s_blasfeo_api.h>
+#if defined(LA_HIGH_PERFORMANCE)
+#include <blasfeo_s_kernel.h>
+#endif
+
+
+
+// the half-precision routines take the A operand as hmat and all the others as single precision;
+// elements of A are converted to single precision on load and the arithmetic is in single precision
+
+#if defined(LA_HIGH_PERFORMANCE) & defined(MF_PANELMAJ) & ( defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_X64_INTEL_SKYLAKE_X) )
+#define HGEMM_KERNELS
+#endif
+
+
+
+// D <= beta * C + alpha * A * B^T
+void blasfeo_hgemm_nt(int m, int n, int k, float alpha, struct blasfeo_hmat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, float beta, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	int ii, jj, ll;
+	float c;
+
+#if defined(HGEMM_KERNELS)
+	if(ai%H_PS==0 & bi%4==0 & ci%8==0 & di%8==0)
+		{
+		for(ii=0; ii<m-7; ii+=8)
+			{
+			for(jj=0; jj<n-3; jj+=4)
+				{
+				kernel_hgemm_nt_8x4_lib8(k, &alpha, &BLASFEO_HMATEL(sA, ai+ii, aj), &BLASFEO_SMATEL(sB, bi+jj, bj), &beta, &BLASFEO_SMATEL(sC, ci+ii, cj+jj), &BLASFEO_SMATEL(sD, di+ii, dj+jj));
+				}
+			if(jj<n)
+				{
+				kernel_hgemm_nt_8x4_vs_lib8(k, &alpha, &BLASFEO_HMATEL(sA, ai+ii, aj), &BLASFEO_SMATEL(sB, bi+jj, bj), &beta, &BLASFEO_SMATEL(sC, ci+ii, cj+jj), &BLASFEO_SMATEL(sD, di+ii, dj+jj), m-ii, n-jj);
+				}
+			}
+		if(ii<m)
+			{
+			for(jj=0; jj<n; jj+=4)
+				{
+				kernel_hgemm_nt_8x4_vs_lib8(k, &alpha, &BLASFEO_HMATEL(sA, ai+ii, aj), &BLASFEO_SMATEL(sB, bi+jj, bj), &beta, &BLASFEO_SMATEL(sC, ci+ii, cj+jj), &BLASFEO_SMATEL(sD, di+ii, dj+jj), m-ii, n-jj);
+				}
+			}
+		return;
+		}
+#endif
+
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			c = 0.0f;
+			for(ll=0; ll<k; ll++)
+				{
+				c += blasfeo_cvt_h2s(BLASFEO_HMATEL(sA, ai+ii, aj+ll)) * BLASFEO_SMATEL(sB, bi+jj, bj+ll);
+				}
+			BLASFEO_SMATEL(sD, di+ii, dj+jj) = alpha*c + (beta==0.0f ? 0.0f : beta*BLASFEO_SMATEL(sC, ci+ii, cj+jj));
+			}
+		}
+	return;
+	}
+
+
+
+// z <= beta * y + alpha * A * x
+void blasfeo_hgemv_n(int m, int n, float alpha, struct blasfeo_hmat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, float beta, struct blasfeo_svec *sy, int yi, struct blasfeo_svec *sz, int zi)
+	{
+	if(m<=0)
+		return;
+
+	float *x = sx->pa + xi;
+	float *y = sy->pa + yi;
+	float *z = sz->pa + zi;
+
+	int ii, jj;
+	float c;
+
+#if defined(HGEMM_KERNELS)
+	if(ai%H_PS==0)
+		{
+		for(ii=0; ii<m-7; ii+=8)
+			{
+			kernel_hgemv_n_8_lib8(n, &alpha, &BLASFEO_HMATEL(sA, ai+ii, aj), x, &beta, y+ii, z+ii);
+			}
+		if(ii<m)
+			{
+			kernel_hgemv_n_8_vs_lib8(n, &alpha, &BLASFEO_HMATEL(sA, ai+ii, aj), x, &beta, y+ii, z+ii, m-ii);
+			}
+		return;
+		}
+#endif
+
+	for(ii=0; ii<m; ii++)
+		{
+		c = 0.0f;
+		for(jj=0; jj<n; jj++)
+			{
+			c += blasfeo_cvt_h2s(BLASFEO_HMATEL(sA, ai+ii, aj+jj)) * x[jj];
+			}
+		z[ii] = alpha*c + (beta==0.0f ? 0.0f : beta*y[ii]);
+		}
+	return;
+	}
+
+
+
+// z <= beta * y + alpha * A^T * x
+void blasfeo_hgemv_t(int m, int n, float alpha, struct blasfeo_hmat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, float beta, struct blasfeo_svec *sy, int yi, struct blasfeo_svec *sz, int zi)
+	{
+	if(n<=0)
+		return;
+
+	float *x = sx->pa + xi;
+	float *y = sy->pa + yi;
+	float *z = sz->pa + zi;
+
+	int ii, jj;
+	float c;
+
+#if defined(HGEMM_KERNELS)
+	if(ai%H_PS==0)
+		{
+		for(jj=0; jj<n-7; jj+=8)
+			{
+			kernel_hgemv_t_8_lib8(m, &alpha, &BLASFEO_HMATEL(sA, ai, aj+jj), sA->cn, x, &beta, y+jj, z+jj);
+			}
+		if(jj<n)
+			{
+			kernel_hgemv_t_8_vs_lib8(m, &alpha, &BLASFEO_HMATEL(sA, ai, aj+jj), sA->cn, x, &beta, y+jj, z+jj, n-jj);
+			}
+		return;
+		}
+#endif
+
+	for(jj=0; jj<n; jj++)
+		{
+		c = 0.0f;
+		for(ii=0; ii<m; ii++)
+			{
+			c += blasfeo_cvt_h2s(BLASFEO_HMATEL(sA, ai+ii, aj+jj)) * x[ii];
+			}
+		z[jj] = alpha*c + (beta==0.0f ? 0.0f : beta*y[jj]);
+		}
+	return;
+	}
+
@@ -41,7 +41,8 @@
 
 
 
-#if defined(LA_REFERENCE) | defined(LA_EXTERNAL_BLAS_WRAPPER)
+// generic version, used by the targets without a panel-major specialization
+#if defined(LA_REFERENCE) | defined(LA_EXTERNAL_BLAS_WRAPPER) | ( defined(LA_HIGH_PERFORMANCE) & ( defined(MF_COLMAJ) | defined(TARGET_X64_INTEL_SKYLAKE_X) ) )
 
 
 
@@ -76,16 +77,12 @@ void blasfeo_cvt_s2d_vec(int m, struct blasfeo_svec *vs, int vsi, struct blasfeo
 
 void blasfeo_cvt_d2s_mat(int m, int n, struct blasfeo_dmat *Md, int mid, int nid, struct blasfeo_smat *Ms, int mis, int nis)
 	{
-	int lda = Md->m;
-	int ldb = Ms->m;
-	double *pA = Md->pA+mid+nid*lda;
-	float *pB = Ms->pA+mis+nis*ldb;
 	int ii, jj;
 	for(jj=0; jj<n; jj++)
 		{
 		for(ii=0; ii<m; ii++)
 			{
-			pB[ii+jj*ldb] = (float) pA[ii+jj*lda];
+			BLASFEO_SMATEL(Ms, mis+ii, nis+jj) = (float) BLASFEO_DMATEL(Md, mid+ii, nid+jj);
 			}
 		}
 	return;
@@ -95,16 +92,12 @@ void blasfeo_cvt_d2s_mat(int m, int n, struct blasfeo_dmat *Md, int mid, int nid
 
 void blasfeo_cvt_s2d_mat(int m, int n, struct blasfeo_smat *Ms, int mis, int nis, struct blasfeo_dmat *Md, int mid, int nid)
 	{
-	int lda = Ms->m;
-	int ldb = Md->m;
-	float *pA = Ms->pA+mis+nis*lda;
-	double *pB = Md->pA+mid+nid*ldb;
 	int ii, jj;
 	for(jj=0; jj<n; jj++)
 		{
 		for(ii=0; ii<m; ii++)
 			{
-			pB[ii+jj*ldb] = (double) pA[ii+jj*lda];
+			BLASFEO_DMATEL(Md, mid+ii, nid+jj) = (double) BLASFEO_SMATEL(Ms, mis+ii, nis+jj);
 			}
 		}
 	return;
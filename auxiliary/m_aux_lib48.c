@@ -76,12 +76,18 @@ void blasfeo_cvt_s2d_vec(int m, struct blasfeo_svec *vs, int vsi, struct blasfeo
 
 void blasfeo_cvt_d2s_mat(int m, int n, struct blasfeo_dmat *Md, int mid, int nid, struct blasfeo_smat *Ms, int mis, int nis)
 	{
+	int ii, jj, ll;
 	if(mid!=0 | mis!=0)
 		{
-#if defined(EXT_DEP)
-		printf("\nblasfeo_cvt_d2s_mat: feature not implmeneted yet: mid=%d, mis=%d\n\n", mid, mis);
-#endif
-		exit(1);
+		// generic version for row offsets that are not at the start of a panel
+		for(jj=0; jj<n; jj++)
+			{
+			for(ii=0; ii<m; ii++)
+				{
+				BLASFEO_SMATEL(Ms, mis+ii, nis+jj) = (float) BLASFEO_DMATEL(Md, mid+ii, nid+jj);
+				}
+			}
+		return;
 		}
 	const int psd = 4;
 	const int pss = 8;
@@ -90,7 +96,6 @@ void blasfeo_cvt_d2s_mat(int m, int n, struct blasfeo_dmat *Md, int mid, int nid
 	double *D1;
 	const int sds = Ms->cn;
 	float *S = Ms->pA + nis*pss;
-	int ii, jj, ll;
 	for(ii=0; ii<m-7; ii+=8)
 		{
 		D1 = D0 + psd*sdd;
@@ -144,10 +149,72 @@ void blasfeo_cvt_d2s_mat(int m, int n, struct blasfeo_dmat *Md, int mid, int nid
 
 void blasfeo_cvt_s2d_mat(int m, int n, struct blasfeo_smat *Ms, int mis, int nis, struct blasfeo_dmat *Md, int mid, int nid)
 	{
-#if defined(EXT_DEP)
-	printf("\nblasfeo_cvt_s2d_mat: feature not implmeneted yet\n\n");
-#endif
-	exit(1);
+	int ii, jj, ll;
+	if(mid!=0 | mis!=0)
+		{
+		// generic version for row offsets that are not at the start of a panel
+		for(jj=0; jj<n; jj++)
+			{
+			for(ii=0; ii<m; ii++)
+				{
+				BLASFEO_DMATEL(Md, mid+ii, nid+jj) = (double) BLASFEO_SMATEL(Ms, mis+ii, nis+jj);
+				}
+			}
+		return;
+		}
+	const int psd = 4;
+	const int pss = 8;
+	const int sdd = Md->cn;
+	double *D0 = Md->pA + nid*psd;
+	double *D1;
+	const int sds = Ms->cn;
+	float *S = Ms->pA + nis*pss;
+	for(ii=0; ii<m-7; ii+=8)
+		{
+		D1 = D0 + psd*sdd;
+		for(jj=0; jj<n; jj++)
+			{
+			D0[0+jj*psd] = (double) S[0+jj*pss];
+			D0[1+jj*psd] = (double) S[1+jj*pss];
+			D0[2+jj*psd] = (double) S[2+jj*pss];
+			D0[3+jj*psd] = (double) S[3+jj*pss];
+			D1[0+jj*psd] = (double) S[4+jj*pss];
+			D1[1+jj*psd] = (double) S[5+jj*pss];
+			D1[2+jj*psd] = (double) S[6+jj*pss];
+			D1[3+jj*psd] = (double) S[7+jj*pss];
+			}
+		D0 += 8*sdd;
+		S  += 8*sds;
+		}
+	if(m-ii>0)
+		{
+		if(m-ii<4)
+			{
+			for(jj=0; jj<n; jj++)
+				{
+				for(ll=0; ll<m-ii; ll++)
+					{
+					D0[ll+jj*psd] = (double) S[ll+jj*pss];
+					}
+				}
+			return;
+			}
+		else
+			{
+			D1 = D0 + psd*sdd;
+			for(jj=0; jj<n; jj++)
+				{
+				D0[0+jj*psd] = (double) S[0+jj*pss];
+				D0[1+jj*psd] = (double) S[1+jj*pss];
+				D0[2+jj*psd] = (double) S[2+jj*pss];
+				D0[3+jj*psd] = (double) S[3+jj*pss];
+				for(ll=0; ll<m-ii-4; ll++)
+					{
+					D1[ll+jj*psd] = (double) S[4+ll+jj*pss];
+					}
+				}
+			}
+		}
 	return;
 	}
 
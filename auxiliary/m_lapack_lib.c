@@ -0,0 +1,484 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+
+#include <blasfeo_common.h>
+#include <blasfeo_d_aux.h>
+#include <blasfeo_s_aux.h>
+#include <blasfeo_m_aux.h>
+#include <blasfeo_d_blasfeo_api.h>
+#include <blasfeo_s_blasfeo_api.h>
+#include <blasfeo_m_blasfeo_api.h>
+#include <blasfeo_memory.h>
+
+
+
+// maximum number of refinement iterations
+#define ITERMAX 30
+// the refinement is considered stalled if an iteration does not reduce the residual by at least this factor
+#define STALL_RATIO 0.5
+
+// the single-precision factorization only pays for the conversions and the refinement on targets where it runs
+// substantially faster than the double-precision one: the external LAPACK, and the Cholesky factorization of the
+// vectorized panel-major lib4 version; in the lib8 and lib16 versions and in the column-major version the
+// single-precision factorizations are not faster than the double-precision ones
+#if defined(LA_EXTERNAL_BLAS_WRAPPER)
+#define MIXED_PRECISION_PO
+#define MIXED_PRECISION_GE
+#elif ( defined(LA_HIGH_PERFORMANCE) & defined(MF_PANELMAJ) ) && S_PS==4
+#if !( defined(TARGET_GENERIC) | defined(TARGET_X64_AMD_BULLDOZER) | defined(TARGET_X86_AMD_BARCELONA) )
+#define MIXED_PRECISION_PO
+#endif
+#endif
+// minimum matrix size for the mixed-precision path
+#define MIXED_MIN_N 512
+
+
+
+// scratch memory from the workspace, 64-byte aligned also if taken from the heap
+static void *work_malloc_align(void **mem, size_t size)
+	{
+	blasfeo_work_malloc(mem, size+64);
+	return (void *) ( ( (size_t) *mem + 63 ) / 64 * 64 );
+	}
+
+
+
+// max-norm of the columns of X and R: converged if the residual of all columns is below tol times the solution,
+// returns -1 if any residual is not finite
+static int check_conv(int n, int nrhs, struct blasfeo_dmat *sX, int xi, int xj, struct blasfeo_dmat *sR, double tol, double *rnrm)
+	{
+	int ii, jj;
+	double xn, rn, tmp;
+	int conv = 1;
+	*rnrm = 0.0;
+	for(jj=0; jj<nrhs; jj++)
+		{
+		xn = 0.0;
+		rn = 0.0;
+		for(ii=0; ii<n; ii++)
+			{
+			tmp = fabs(BLASFEO_DMATEL(sX, xi+ii, xj+jj));
+			xn = tmp>xn ? tmp : xn;
+			tmp = fabs(BLASFEO_DMATEL(sR, ii, jj));
+			// written to catch nan
+			rn = tmp<=rn ? rn : tmp;
+			}
+		if(!(rn<=DBL_MAX))
+			return -1;
+		if(rn>xn*tol)
+			conv = 0;
+		*rnrm = rn>*rnrm ? rn : *rnrm;
+		}
+	return conv;
+	}
+
+
+
+// infinity norm of the n x n matrix A (if lower, A is symmetric with only the lower triangle stored)
+static double dnrm_inf(int n, struct blasfeo_dmat *sA, int ai, int aj, int lower)
+	{
+	int ii, jj;
+	double sum, tmp, nrm = 0.0;
+	for(ii=0; ii<n; ii++)
+		{
+		sum = 0.0;
+		for(jj=0; jj<n; jj++)
+			{
+			if(lower & jj>ii)
+				tmp = BLASFEO_DMATEL(sA, ai+jj, aj+ii);
+			else
+				tmp = BLASFEO_DMATEL(sA, ai+ii, aj+jj);
+			sum += fabs(tmp);
+			}
+		// written to catch nan
+		nrm = sum<=nrm ? nrm : sum;
+		}
+	return nrm;
+	}
+
+
+
+// max-norm of the m x n matrix A
+static double dnrm_max(int m, int n, struct blasfeo_dmat *sA, int ai, int aj)
+	{
+	int ii, jj;
+	double tmp, nrm = 0.0;
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			tmp = fabs(BLASFEO_DMATEL(sA, ai+ii, aj+jj));
+			nrm = tmp<=nrm ? nrm : tmp;
+			}
+		}
+	return nrm;
+	}
+
+
+
+// use the mixed-precision path for a matrix of size n, for the Cholesky (po=1) or the LU factorization
+static int use_mixed(int po, int n)
+	{
+#if defined(MIXED_PRECISION_PO)
+	if(po)
+		return n>=MIXED_MIN_N;
+#endif
+#if defined(MIXED_PRECISION_GE)
+	if(!po)
+		return n>=MIXED_MIN_N;
+#endif
+	return 0;
+	}
+
+
+
+// check that the diagonal of the single-precision factor is finite and nonzero
+static int check_diag(int n, struct blasfeo_smat *sA)
+	{
+	int ii;
+	float tmp;
+	for(ii=0; ii<n; ii++)
+		{
+		tmp = fabsf(BLASFEO_SMATEL(sA, ii, ii));
+		if(!(tmp>0.0f & tmp<=FLT_MAX))
+			return 0;
+		}
+	return 1;
+	}
+
+
+
+// X <= (L * L^T)^{-1} * X in single precision, one column at a time (the lib4 strsm_llnn and strsm_lltn are not
+// implemented, while strsv is)
+static void spotrs(int n, int nrhs, struct blasfeo_smat *sL, struct blasfeo_smat *sX, struct blasfeo_svec *sx)
+	{
+	int jj;
+	for(jj=0; jj<nrhs; jj++)
+		{
+		blasfeo_scolex(n, sX, 0, jj, sx, 0);
+		blasfeo_strsv_lnn(n, sL, 0, 0, sx, 0, sx, 0);
+		blasfeo_strsv_ltn(n, sL, 0, 0, sx, 0, sx, 0);
+		blasfeo_scolin(n, sx, 0, sX, 0, jj);
+		}
+	return;
+	}
+
+
+
+// X <= (P^T * L * U)^{-1} * X in single precision
+static void sgetrs(int n, int nrhs, struct blasfeo_smat *sLU, int *ipiv, struct blasfeo_smat *sX)
+	{
+	int ii;
+	for(ii=0; ii<n; ii++)
+		if(ipiv[ii]!=ii)
+			blasfeo_srowsw(nrhs, sX, ii, 0, sX, ipiv[ii], 0);
+	blasfeo_strsm_llnu(n, nrhs, 1.0, sLU, 0, 0, sX, 0, 0, sX, 0, 0);
+	blasfeo_strsm_lunn(n, nrhs, 1.0, sLU, 0, 0, sX, 0, 0, sX, 0, 0);
+	return;
+	}
+
+
+
+size_t blasfeo_dgesv_mixed_worksize(int n, int nrhs)
+	{
+
+	if(n<=0 | nrhs<=0)
+		return 0;
+
+	size_t size;
+
+	size = blasfeo_work_memsize(blasfeo_memsize_smat(n, n)+64); // single-precision factor
+	size += blasfeo_work_memsize(n*sizeof(int)); // pivots
+	size += blasfeo_work_memsize(blasfeo_memsize_smat(n, nrhs)+64); // single-precision correction
+	size += blasfeo_work_memsize(blasfeo_memsize_dmat(n, nrhs)+64); // residual
+	size += blasfeo_work_memsize(blasfeo_memsize_dmat(n, n)+64); // double-precision factor of the fallback
+
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_COLMAJ) )
+	// nested routines
+	size_t tmp;
+	size_t nest = blasfeo_strsm_llnu_worksize(n, nrhs);
+	tmp = blasfeo_strsm_lunn_worksize(n, nrhs);
+	nest = tmp>nest ? tmp : nest;
+	tmp = blasfeo_dgemm_nn_worksize(n, nrhs, n);
+	nest = tmp>nest ? tmp : nest;
+	tmp = blasfeo_dgetrf_rp_worksize(n, n);
+	nest = tmp>nest ? tmp : nest;
+	tmp = blasfeo_dtrsm_llnu_worksize(n, nrhs);
+	nest = tmp>nest ? tmp : nest;
+	tmp = blasfeo_dtrsm_lunn_worksize(n, nrhs);
+	nest = tmp>nest ? tmp : nest;
+	size += nest;
+#endif
+
+	return size;
+
+	}
+
+
+
+int blasfeo_dgesv_mixed(int n, int nrhs, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sX, int xi, int xj)
+	{
+
+	if(n<=0 | nrhs<=0)
+		return 0;
+
+	int ii, iter;
+	double anrm, tol, rnrm, rnrm0;
+	int conv;
+
+	struct blasfeo_smat sAs, sXs;
+	struct blasfeo_dmat sR, sAd;
+	void *mem_As, *mem_ipiv, *mem_Xs, *mem_R, *mem_Ad;
+	int *ipiv;
+
+	blasfeo_create_smat(n, n, &sAs, work_malloc_align(&mem_As, blasfeo_memsize_smat(n, n)));
+	blasfeo_work_malloc(&mem_ipiv, n*sizeof(int));
+	ipiv = (int *) mem_ipiv;
+	blasfeo_create_smat(n, nrhs, &sXs, work_malloc_align(&mem_Xs, blasfeo_memsize_smat(n, nrhs)));
+	blasfeo_create_dmat(n, nrhs, &sR, work_malloc_align(&mem_R, blasfeo_memsize_dmat(n, nrhs)));
+
+	if(!use_mixed(0, n))
+		goto fallback;
+
+	// stopping criterion of xGESV in LAPACK: ||r|| < ||x|| * ||A|| * eps * sqrt(n) for each column
+	anrm = dnrm_inf(n, sA, ai, aj, 0);
+	tol = anrm * 0.5*DBL_EPSILON * sqrt((double) n);
+
+	// A and B out of the range of single precision
+	if(!(anrm<=FLT_MAX & dnrm_max(n, nrhs, sB, bi, bj)<=FLT_MAX))
+		goto fallback;
+
+	// single-precision factorization
+	blasfeo_cvt_d2s_mat(n, n, sA, ai, aj, &sAs, 0, 0);
+	blasfeo_sgetrf_rp(n, n, &sAs, 0, 0, &sAs, 0, 0, ipiv);
+	if(!check_diag(n, &sAs))
+		goto fallback;
+
+	// initial solution
+	blasfeo_cvt_d2s_mat(n, nrhs, sB, bi, bj, &sXs, 0, 0);
+	sgetrs(n, nrhs, &sAs, ipiv, &sXs);
+	blasfeo_cvt_s2d_mat(n, nrhs, &sXs, 0, 0, sX, xi, xj);
+
+	rnrm0 = DBL_MAX;
+	for(iter=0; iter<=ITERMAX; iter++)
+		{
+		// residual in double precision
+		blasfeo_dgemm_nn(n, nrhs, n, -1.0, sA, ai, aj, sX, xi, xj, 1.0, sB, bi, bj, &sR, 0, 0);
+		conv = check_conv(n, nrhs, sX, xi, xj, &sR, tol, &rnrm);
+		if(conv==1)
+			goto done;
+		if(conv<0 | !(rnrm<=STALL_RATIO*rnrm0) | iter==ITERMAX)
+			break;
+		rnrm0 = rnrm;
+		// correction in single precision
+		blasfeo_cvt_d2s_mat(n, nrhs, &sR, 0, 0, &sXs, 0, 0);
+		sgetrs(n, nrhs, &sAs, ipiv, &sXs);
+		blasfeo_cvt_s2d_mat(n, nrhs, &sXs, 0, 0, &sR, 0, 0);
+		blasfeo_dgead(n, nrhs, 1.0, &sR, 0, 0, sX, xi, xj);
+		}
+
+fallback:
+	// double-precision factorization
+	blasfeo_create_dmat(n, n, &sAd, work_malloc_align(&mem_Ad, blasfeo_memsize_dmat(n, n)));
+	blasfeo_dgetrf_rp(n, n, sA, ai, aj, &sAd, 0, 0, ipiv);
+	blasfeo_dgecp(n, nrhs, sB, bi, bj, &sR, 0, 0);
+	for(ii=0; ii<n; ii++)
+		if(ipiv[ii]!=ii)
+			blasfeo_drowsw(nrhs, &sR, ii, 0, &sR, ipiv[ii], 0);
+	blasfeo_dtrsm_llnu(n, nrhs, 1.0, &sAd, 0, 0, &sR, 0, 0, &sR, 0, 0);
+	blasfeo_dtrsm_lunn(n, nrhs, 1.0, &sAd, 0, 0, &sR, 0, 0, sX, xi, xj);
+	blasfeo_work_free(mem_Ad);
+	iter = -1;
+
+done:
+	blasfeo_work_free(mem_R);
+	blasfeo_work_free(mem_Xs);
+	blasfeo_work_free(mem_ipiv);
+	blasfeo_work_free(mem_As);
+
+	return iter;
+
+	}
+
+
+
+int blasfeo_dgesv_mixed_ws(int n, int nrhs, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sX, int xi, int xj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	int iter = blasfeo_dgesv_mixed(n, nrhs, sA, ai, aj, sB, bi, bj, sX, xi, xj);
+	blasfeo_work_end(&prev);
+	return iter;
+	}
+
+
+
+size_t blasfeo_dposv_mixed_worksize(int n, int nrhs)
+	{
+
+	if(n<=0 | nrhs<=0)
+		return 0;
+
+	size_t size;
+
+	size = blasfeo_work_memsize(blasfeo_memsize_smat(n, n)+64); // single-precision factor
+	size += blasfeo_work_memsize(blasfeo_memsize_smat(n, nrhs)+64); // single-precision correction
+	size += blasfeo_work_memsize(blasfeo_memsize_dmat(n, nrhs)+64); // residual
+	size += 2*blasfeo_work_memsize(blasfeo_memsize_dvec(n)+64); // columns of the solution and the residual
+	size += blasfeo_work_memsize(blasfeo_memsize_svec(n)+64); // column of the single-precision correction
+	size += blasfeo_work_memsize(blasfeo_memsize_dmat(n, n)+64); // double-precision factor of the fallback
+
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_COLMAJ) )
+	// nested routines
+	size_t tmp;
+	size_t nest = blasfeo_spotrf_l_worksize(n);
+	tmp = blasfeo_dpotrf_l_worksize(n);
+	nest = tmp>nest ? tmp : nest;
+	tmp = blasfeo_dtrsm_llnn_worksize(n, nrhs);
+	nest = tmp>nest ? tmp : nest;
+	tmp = blasfeo_dtrsm_lltn_worksize(n, nrhs);
+	nest = tmp>nest ? tmp : nest;
+	size += nest;
+#endif
+
+	return size;
+
+	}
+
+
+
+int blasfeo_dposv_mixed(int n, int nrhs, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sX, int xi, int xj)
+	{
+
+	if(n<=0 | nrhs<=0)
+		return 0;
+
+	int jj, iter;
+	double anrm, tol, rnrm, rnrm0;
+	int conv;
+
+	struct blasfeo_smat sAs, sXs;
+	struct blasfeo_dmat sR, sAd;
+	struct blasfeo_dvec sx, sr;
+	struct blasfeo_svec sxs;
+	void *mem_As, *mem_Xs, *mem_R, *mem_x, *mem_r, *mem_xs, *mem_Ad;
+
+	blasfeo_create_smat(n, n, &sAs, work_malloc_align(&mem_As, blasfeo_memsize_smat(n, n)));
+	blasfeo_create_smat(n, nrhs, &sXs, work_malloc_align(&mem_Xs, blasfeo_memsize_smat(n, nrhs)));
+	blasfeo_create_dmat(n, nrhs, &sR, work_malloc_align(&mem_R, blasfeo_memsize_dmat(n, nrhs)));
+	blasfeo_create_dvec(n, &sx, work_malloc_align(&mem_x, blasfeo_memsize_dvec(n)));
+	blasfeo_create_dvec(n, &sr, work_malloc_align(&mem_r, blasfeo_memsize_dvec(n)));
+	blasfeo_create_svec(n, &sxs, work_malloc_align(&mem_xs, blasfeo_memsize_svec(n)));
+
+	if(!use_mixed(1, n))
+		goto fallback;
+
+	anrm = dnrm_inf(n, sA, ai, aj, 1);
+	tol = anrm * 0.5*DBL_EPSILON * sqrt((double) n);
+
+	if(!(anrm<=FLT_MAX & dnrm_max(n, nrhs, sB, bi, bj)<=FLT_MAX))
+		goto fallback;
+
+	// single-precision factorization (only the lower triangle is accessed)
+	blasfeo_cvt_d2s_mat(n, n, sA, ai, aj, &sAs, 0, 0);
+	blasfeo_spotrf_l(n, &sAs, 0, 0, &sAs, 0, 0);
+	if(!check_diag(n, &sAs))
+		goto fallback;
+
+	blasfeo_cvt_d2s_mat(n, nrhs, sB, bi, bj, &sXs, 0, 0);
+	spotrs(n, nrhs, &sAs, &sXs, &sxs);
+	blasfeo_cvt_s2d_mat(n, nrhs, &sXs, 0, 0, sX, xi, xj);
+
+	rnrm0 = DBL_MAX;
+	for(iter=0; iter<=ITERMAX; iter++)
+		{
+		// residual in double precision, one column at a time as only the lower triangle of A is stored
+		for(jj=0; jj<nrhs; jj++)
+			{
+			blasfeo_dcolex(n, sX, xi, xj+jj, &sx, 0);
+			blasfeo_dcolex(n, sB, bi, bj+jj, &sr, 0);
+			blasfeo_dsymv_l(n, -1.0, sA, ai, aj, &sx, 0, 1.0, &sr, 0, &sr, 0);
+			blasfeo_dcolin(n, &sr, 0, &sR, 0, jj);
+			}
+		conv = check_conv(n, nrhs, sX, xi, xj, &sR, tol, &rnrm);
+		if(conv==1)
+			goto done;
+		if(conv<0 | !(rnrm<=STALL_RATIO*rnrm0) | iter==ITERMAX)
+			break;
+		rnrm0 = rnrm;
+		blasfeo_cvt_d2s_mat(n, nrhs, &sR, 0, 0, &sXs, 0, 0);
+		spotrs(n, nrhs, &sAs, &sXs, &sxs);
+		blasfeo_cvt_s2d_mat(n, nrhs, &sXs, 0, 0, &sR, 0, 0);
+		blasfeo_dgead(n, nrhs, 1.0, &sR, 0, 0, sX, xi, xj);
+		}
+
+fallback:
+	blasfeo_create_dmat(n, n, &sAd, work_malloc_align(&mem_Ad, blasfeo_memsize_dmat(n, n)));
+	blasfeo_dpotrf_l(n, sA, ai, aj, &sAd, 0, 0);
+	blasfeo_dtrsm_llnn(n, nrhs, 1.0, &sAd, 0, 0, sB, bi, bj, &sR, 0, 0);
+	blasfeo_dtrsm_lltn(n, nrhs, 1.0, &sAd, 0, 0, &sR, 0, 0, sX, xi, xj);
+	blasfeo_work_free(mem_Ad);
+	iter = -1;
+
+done:
+	blasfeo_work_free(mem_xs);
+	blasfeo_work_free(mem_r);
+	blasfeo_work_free(mem_x);
+	blasfeo_work_free(mem_R);
+	blasfeo_work_free(mem_Xs);
+	blasfeo_work_free(mem_As);
+
+	return iter;
+
+	}
+
+
+
+int blasfeo_dposv_mixed_ws(int n, int nrhs, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sX, int xi, int xj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	int iter = blasfeo_dposv_mixed(n, nrhs, sA, ai, aj, sB, bi, bj, sX, xi, xj);
+	blasfeo_work_end(&prev);
+	return iter;
+	}
+
@@ -41,30 +41,297 @@
 #include <blasfeo_block_size.h>
 #include <blasfeo_d_aux.h>
 #include <blasfeo_s_aux.h>
+#include <blasfeo_memory.h>
+#include <blasfeo_processor_features.h>
+#include <blasfeo_thread.h>
 
 
 
-static int initialized = 0;
+// the packing buffer is thread-local: each thread calling blasfeo_init gets its own buffer,
+// so that routines called concurrently from different threads never share packed panels
+#if defined(__GNUC__) || defined(__clang__) || defined(__INTEL_COMPILER) || defined(__ICL) || defined(__ICC) || defined(__INTEL_LLVM_COMPILER)
+#define THREAD_LOCAL __thread
+#elif defined (_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL
+#endif
 
-static void *mem = NULL;
+static THREAD_LOCAL int initialized = 0;
 
+static THREAD_LOCAL void *mem = NULL;
 
+// the buffer has been allocated by blasfeo_init (and not passed by the user)
+static THREAD_LOCAL int mem_owned = 0;
 
+// size of the buffer, for the block sizes at the time of blasfeo_init
+static THREAD_LOCAL size_t mem_size = 0;
+
+// block sizes the buffer has been sized for: as the needed size grows with each block size, the buffer can be used
+// for any block sizes not larger than these, and the check on each call takes no size computation
+static THREAD_LOCAL struct blasfeo_block_size mem_bs = {0, 0, 0};
+
+// workspace of the computational routines
+static THREAD_LOCAL struct blasfeo_work work = {NULL, 0, 0};
+
+// block sizes, shared by all threads: packed in a single word (see block_size_pack), so that they are
+// always published and read as a consistent set; 0 if not initialized yet
+static unsigned long long block_size_word = 0;
+
+// total last level cache size, shared by all threads; 0 if not detected yet, -1 if unknown
+static int llc_size = 0;
+
+// bits of each block size in the packed word
+#define BLOCK_SIZE_BITS 21
+#define BLOCK_SIZE_MASK ((1ull<<BLOCK_SIZE_BITS)-1)
+
+// the block sizes set at run time are at most this many times the default ones
+#define BLOCK_SIZE_MAX_RATIO 16
+
+
+
+static unsigned long long block_size_pack(struct blasfeo_block_size *bs)
+	{
+	return (unsigned long long) bs->d_kc | (unsigned long long) bs->d_nc<<BLOCK_SIZE_BITS | (unsigned long long) bs->d_mc<<(2*BLOCK_SIZE_BITS);
+	}
+
+
+
+static void block_size_unpack(unsigned long long word, struct blasfeo_block_size *bs)
+	{
+	bs->d_kc = word & BLOCK_SIZE_MASK;
+	bs->d_nc = word>>BLOCK_SIZE_BITS & BLOCK_SIZE_MASK;
+	bs->d_mc = word>>(2*BLOCK_SIZE_BITS) & BLOCK_SIZE_MASK;
+	}
+
+
+
+static unsigned long long block_size_load()
+	{
+#if defined(__GNUC__) || defined(__clang__)
+	return __atomic_load_n(&block_size_word, __ATOMIC_ACQUIRE);
+#else
+	return *(volatile unsigned long long *) &block_size_word;
+#endif
+	}
+
+
+
+static void block_size_store(unsigned long long word)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+	__atomic_store_n(&block_size_word, word, __ATOMIC_RELEASE);
+#else
+	*(volatile unsigned long long *) &block_size_word = word;
+#endif
+	}
+
+
+
+// round down to a multiple of the kernel size, and clamp between one kernel and BLOCK_SIZE_MAX_RATIO times the default
+static int block_size_clamp(int size, int size_default, int multiple)
+	{
+	int size_max = BLOCK_SIZE_MAX_RATIO*size_default/multiple*multiple;
+	size = size/multiple*multiple;
+	return size<multiple ? multiple : size>size_max ? size_max : size;
+	}
+
+
+
+// scale the default block size by the ratio between the detected per-core cache size and the one it is tuned for
+static int block_size_scale(int size_default, int cache_target, int cache, int multiple)
+	{
+	if(cache<=0 | cache_target<=0 | cache==cache_target)
+		return size_default;
+	double ratio = (double) cache / cache_target;
+	// stay close to the tuned values
+	ratio = ratio<0.25 ? 0.25 : ratio>4.0 ? 4.0 : ratio;
+	int size = (int) (size_default*ratio) / multiple * multiple;
+	return size<multiple ? multiple : size;
+	}
+
+
+
+static int block_size_env(char *name, int size, int size_default, int multiple)
+	{
+	char *env = getenv(name);
+	int size_env = env!=NULL ? atoi(env) : 0;
+	return size_env>0 ? block_size_clamp(size_env, size_default, multiple) : size;
+	}
+
+
+
+// the initialization is idempotent, so concurrent first calls at worst repeat it
+static unsigned long long block_size_init()
+	{
+	struct blasfeo_block_size bs;
+	int l1, l2, llc;
+	blasfeo_processor_cache_sizes_per_core(&l1, &l2, &llc);
+	bs.d_kc = D_KC;
+#if defined(D_NC_CACHE_SIZE)
+	bs.d_nc = block_size_scale(D_NC, D_NC_CACHE_SIZE, l2, D_N_KERNEL);
+#else
+	bs.d_nc = D_NC;
+#endif
+#if defined(D_MC_CACHE_SIZE)
+	bs.d_mc = block_size_scale(D_MC, D_MC_CACHE_SIZE, llc, D_M_KERNEL);
+#else
+	bs.d_mc = D_MC;
+#endif
+	bs.d_kc = block_size_env("BLASFEO_D_KC", bs.d_kc, D_KC, D_PS);
+	bs.d_nc = block_size_env("BLASFEO_D_NC", bs.d_nc, D_NC, D_N_KERNEL);
+	bs.d_mc = block_size_env("BLASFEO_D_MC", bs.d_mc, D_MC, D_M_KERNEL);
+	unsigned long long word = block_size_pack(&bs);
+	block_size_store(word);
+	return word;
+	}
+
+
+
+static unsigned long long block_size_get()
+	{
+	unsigned long long word = block_size_load();
+	return word!=0 ? word : block_size_init();
+	}
+
+
+
+void blasfeo_get_block_size(struct blasfeo_block_size *bs)
+	{
+	block_size_unpack(block_size_get(), bs);
+	}
+
+
+
+// apply the positive entries of bs to the packed block sizes
+static unsigned long long block_size_update(unsigned long long word, struct blasfeo_block_size *bs)
+	{
+	struct blasfeo_block_size bs_new;
+	block_size_unpack(word, &bs_new);
+	if(bs->d_kc>0)
+		bs_new.d_kc = block_size_clamp(bs->d_kc, D_KC, D_PS);
+	if(bs->d_nc>0)
+		bs_new.d_nc = block_size_clamp(bs->d_nc, D_NC, D_N_KERNEL);
+	if(bs->d_mc>0)
+		bs_new.d_mc = block_size_clamp(bs->d_mc, D_MC, D_M_KERNEL);
+	return block_size_pack(&bs_new);
+	}
+
+
+
+void blasfeo_set_block_size(struct blasfeo_block_size *bs)
+	{
+	unsigned long long word_old = block_size_get();
+#if defined(__GNUC__) || defined(__clang__)
+	unsigned long long word_new;
+	// retry if another thread has published different block sizes in the meantime
+	do
+		{
+		word_new = block_size_update(word_old, bs);
+		}
+	while(!__atomic_compare_exchange_n(&block_size_word, &word_old, word_new, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+#else
+	block_size_store(block_size_update(word_old, bs));
+#endif
+	}
+
+
+
+int blasfeo_get_d_kc()
+	{
+	return block_size_get() & BLOCK_SIZE_MASK;
+	}
+
+
+
+int blasfeo_get_d_nc()
+	{
+	return block_size_get()>>BLOCK_SIZE_BITS & BLOCK_SIZE_MASK;
+	}
+
+
+
+int blasfeo_get_d_mc()
+	{
+	return block_size_get()>>(2*BLOCK_SIZE_BITS) & BLOCK_SIZE_MASK;
+	}
+
+
+
+// the detection is idempotent, so concurrent first calls at worst repeat it
+int blasfeo_get_llc_size()
+	{
+#if defined(__GNUC__) || defined(__clang__)
+	int size = __atomic_load_n(&llc_size, __ATOMIC_RELAXED);
+#else
+	int size = *(volatile int *) &llc_size;
+#endif
+	if(size==0)
+		{
+		int l1, l2, llc;
+		blasfeo_processor_cache_sizes(&l1, &l2, &llc);
+#if defined(LLC_CACHE_SIZE)
+		size = llc>0 ? llc : LLC_CACHE_SIZE;
+#else
+		size = llc>0 ? llc : -1;
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+		__atomic_store_n(&llc_size, size, __ATOMIC_RELAXED);
+#else
+		*(volatile int *) &llc_size = size;
+#endif
+		}
+	return size>0 ? size : 0;
+	}
+
+
+
+static int mem_block_size_fits(struct blasfeo_block_size *bs)
+	{
+	return bs->d_kc<=mem_bs.d_kc & bs->d_nc<=mem_bs.d_nc & bs->d_mc<=mem_bs.d_mc;
+	}
+
+
+
+// the buffer is not used if sized for smaller block sizes than the current ones
 int blasfeo_is_init()
 	{
-	return initialized;
+	if(!initialized)
+		return 0;
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+	return mem_block_size_fits(&bs);
 	}
 
 
 
-void blasfeo_init()
+int blasfeo_is_init_block_size(struct blasfeo_block_size *bs)
+	{
+	return initialized && mem_block_size_fits(bs);
+	}
+
+
+
+size_t blasfeo_memsize_buffer()
+	{
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+	return blasfeo_memsize_buffer_block_size(&bs);
+	}
+
+
+
+size_t blasfeo_memsize_buffer_block_size(struct blasfeo_block_size *bs)
 	{
 	size_t tmp0, tmp1;
 	// compute max needed memory
-	size_t size_A_double = blasfeo_pm_memsize_dmat(D_PS, D_MC, D_KC); 
-	size_t size_B_double = blasfeo_pm_memsize_dmat(D_PS, D_NC, D_KC); 
-	tmp0 = blasfeo_pm_memsize_dmat(D_PS, D_KC, D_KC); 
-	tmp1 = blasfeo_pm_memsize_dmat(D_PS, D_NC, D_NC); 
+	int d_kc = bs->d_kc;
+	int d_nc = bs->d_nc;
+	int d_mc = bs->d_mc;
+	size_t size_A_double = blasfeo_pm_memsize_dmat(D_PS, d_mc, d_kc); 
+	size_t size_B_double = blasfeo_pm_memsize_dmat(D_PS, d_nc, d_kc); 
+	tmp0 = blasfeo_pm_memsize_dmat(D_PS, d_kc, d_kc); 
+	tmp1 = blasfeo_pm_memsize_dmat(D_PS, d_nc, d_nc); 
 	size_t size_T_double = tmp0>tmp1 ? tmp0 : tmp1;
 	// TODO size_T_double
 	size_t size_A_single = blasfeo_pm_memsize_smat(S_PS, S_MC, S_KC); 
@@ -85,17 +352,69 @@ void blasfeo_init()
 	// alignment
 	size += 2*4096;
 //	printf("\nsize %d\n", size);
-	// call malloc
-	mem = malloc(size);
+	return size;
+	}
+
+
+
+void blasfeo_init()
+	{
+#if defined(NO_HEAP)
+	printf("\nError: blasfeo_init: heap allocation disabled (NO_HEAP), use blasfeo_init_buffer\n");
+	exit(1);
+#endif
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+	size_t size = blasfeo_memsize_buffer_block_size(&bs);
+	if(initialized)
+		{
+		if(mem_size>=size)
+			{
+			if(!mem_block_size_fits(&bs))
+				mem_bs = bs;
+			blasfeo_thread_pool_init();
+			return;
+			}
+		// block sizes have been increased: resize
+		blasfeo_quit();
+		}
+	// call malloc, huge pages if enabled
+	blasfeo_malloc_align(&mem, size);
+	mem_owned = 1;
+	mem_size = size;
+	mem_bs = bs;
+	initialized = 1;
+	blasfeo_thread_pool_init();
+	}
+
+
+
+void blasfeo_init_buffer(void *buffer)
+	{
+	if(initialized)
+		blasfeo_quit();
+	mem = buffer;
+	mem_owned = 0;
+	blasfeo_get_block_size(&mem_bs);
+	mem_size = blasfeo_memsize_buffer_block_size(&mem_bs);
 	initialized = 1;
+	blasfeo_thread_pool_init();
 	}
 
 
 
 void blasfeo_quit()
 	{
-	free(mem);
+	if(mem_owned)
+		blasfeo_free_align(mem);
+	mem = NULL;
+	mem_owned = 0;
+	mem_size = 0;
+	mem_bs.d_kc = 0;
+	mem_bs.d_nc = 0;
+	mem_bs.d_mc = 0;
 	initialized = 0;
+	blasfeo_thread_pool_quit();
 	}
 
 
@@ -104,3 +423,67 @@ void *blasfeo_get_buffer()
 	{
 	return mem;
 	}
+
+
+
+void blasfeo_work_begin(void *ptr, size_t size, struct blasfeo_work *prev)
+	{
+	*prev = work;
+	work.ptr = ptr;
+	work.size = ptr!=NULL ? size : 0;
+	work.used = 0;
+	}
+
+
+
+void blasfeo_work_end(struct blasfeo_work *prev)
+	{
+	work = *prev;
+	}
+
+
+
+size_t blasfeo_work_memsize(size_t size)
+	{
+	// worst-case alignment padding
+	return (size + 63) / 64 * 64 + 64;
+	}
+
+
+
+void blasfeo_work_malloc(void **ptr, size_t size)
+	{
+	if(work.ptr!=NULL)
+		{
+		char *start = work.ptr + work.used;
+		char *start_align = (char *) ( ( (size_t) start + 63 ) / 64 * 64 );
+		size_t used = start_align - work.ptr + (size + 63) / 64 * 64;
+		if(used<=work.size)
+			{
+			work.used = used;
+			*ptr = (void *) start_align;
+			return;
+			}
+		}
+#if defined(NO_HEAP)
+	printf("\nError: blasfeo_work_malloc: %zu bytes needed, %zu of %zu workspace bytes in use, heap allocation disabled (NO_HEAP)\n", size, work.used, work.size);
+	exit(1);
+#else
+	*ptr = malloc(size);
+#endif
+	return;
+	}
+
+
+
+void blasfeo_work_free(void *ptr)
+	{
+	if(work.ptr!=NULL & (char *) ptr>=work.ptr & (char *) ptr<work.ptr+work.size)
+		{
+		// stack order: everything allocated after ptr has been already released
+		work.used = (char *) ptr - work.ptr;
+		return;
+		}
+	free(ptr);
+	return;
+	}
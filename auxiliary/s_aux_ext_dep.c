@@ -35,10 +35,12 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <blasfeo_block_size.h>
 #include <blasfeo_common.h>
 #include <blasfeo_stdlib.h>
+#include <blasfeo_thread.h>
 #include <blasfeo_s_aux_ext_dep.h>
 #include <blasfeo_s_aux.h>
 
@@ -48,6 +50,7 @@
 #define CREATE_VEC blasfeo_create_svec
 #define MEMSIZE_MAT blasfeo_memsize_smat
 #define MEMSIZE_VEC blasfeo_memsize_svec
+#define PS S_PS
 #define REAL float
 #define MAT blasfeo_smat
 #define MATEL BLASFEO_SMATEL
@@ -59,6 +62,8 @@
 #define ALLOCATE_MAT blasfeo_allocate_smat
 #define ALLOCATE_VEC blasfeo_allocate_svec
 #define FREE_MAT blasfeo_free_smat
+#define ALLOCATE_MAT_NUMA blasfeo_allocate_smat_numa
+#define FIRST_TOUCH_MAT blasfeo_first_touch_smat
 #define FREE_VEC blasfeo_free_svec
 #define PRINT_MAT blasfeo_print_smat
 #define PRINT_TRAN_MAT blasfeo_print_tran_smat
@@ -80,3 +85,24 @@
 
 #include "x_aux_ext_dep.c"
 
+
+
+// create a half-precision hmat by dynamically allocating the memory
+void blasfeo_allocate_hmat(int m, int n, struct blasfeo_hmat *sA)
+	{
+	size_t size = blasfeo_memsize_hmat(m, n);
+	void *mem;
+	blasfeo_malloc_align(&mem, size);
+	blasfeo_create_hmat(m, n, sA, mem);
+	return;
+	}
+
+
+
+// free memory of a half-precision hmat
+void blasfeo_free_hmat(struct blasfeo_hmat *sA)
+	{
+	blasfeo_free_align(sA->mem);
+	return;
+	}
+
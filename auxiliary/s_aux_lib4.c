@@ -1029,14 +1029,14 @@ void scolex_lib(int kmax, int offset, float *pD, int sdd, float *x)
 		}
 	for(jj=0; jj<kmax-3; jj+=4)
 		{
-		x[jj*sdd+0] = pD[jj+0];
-		x[jj*sdd+1] = pD[jj+1];
-		x[jj*sdd+2] = pD[jj+2];
-		x[jj*sdd+3] = pD[jj+3];
+		x[jj+0] = pD[jj*sdd+0];
+		x[jj+1] = pD[jj*sdd+1];
+		x[jj+2] = pD[jj*sdd+2];
+		x[jj+3] = pD[jj*sdd+3];
 		}
 	for(ll=0; ll<kmax-jj; ll++)
 		{
-		x[jj*sdd+ll] = pD[jj+ll];
+		x[jj+ll] = pD[jj*sdd+ll];
 		}
 
 	}
@@ -56,6 +56,122 @@ void FREE_MAT(struct MAT *sA)
 
 
 
+// blocks of the matrix partitioned over the NUMA nodes: the panel rows, or the columns if column-major
+static void blasfeo_mat_numa_blocks(struct MAT *sA, int *nb, size_t *bsize)
+	{
+#if ( defined(LA_HIGH_PERFORMANCE) | defined(LA_REFERENCE) ) & defined(MF_PANELMAJ)
+	*nb = (sA->m+PS-1)/PS;
+	*bsize = (size_t) PS*sA->cn*sizeof(REAL);
+#else
+	*nb = sA->n;
+	*bsize = (size_t) sA->m*sizeof(REAL);
+#endif
+	return;
+	}
+
+
+
+// create a matrix structure for a matrix of size m*n by dynamically allocating the memory with a NUMA placement policy;
+// with BLASFEO_NUMA_PARTITION, the blocks (panel rows, or columns if column-major) are split in one contiguous chunk per node
+void ALLOCATE_MAT_NUMA(int m, int n, struct MAT *sA, int policy)
+	{
+	size_t size = MEMSIZE_MAT(m, n);
+	void *mem;
+	if(policy!=BLASFEO_NUMA_PARTITION)
+		{
+		blasfeo_malloc_align_numa(&mem, size, policy);
+		CREATE_MAT(m, n, sA, mem);
+		return;
+		}
+	blasfeo_malloc_align_numa(&mem, size, BLASFEO_NUMA_DEFAULT);
+	CREATE_MAT(m, n, sA, mem);
+	int nnode = blasfeo_numa_num_nodes();
+	int nb;
+	size_t bsize;
+	blasfeo_mat_numa_blocks(sA, &nb, &bsize);
+	// same chunks of blocks as blasfeo_thread_numa_range: a page across two chunks goes to the latter node
+	char *ptr0 = mem;
+	char *ptr1;
+	int ii;
+	for(ii=0; ii<nnode; ii++)
+		{
+		ptr1 = ii==nnode-1 ? (char *) mem + size : (char *) sA->pA + bsize*(nb*(ii+1)/nnode);
+		if(ptr1>ptr0)
+			{
+			blasfeo_numa_bind_node(ptr0, ptr1-ptr0, ii);
+			ptr0 = ptr1;
+			}
+		}
+	return;
+	}
+
+
+
+#if defined(MULTI_THREAD)
+
+// min number of bytes per thread
+#define FIRST_TOUCH_MT_MIN (256*1024)
+
+
+
+struct blasfeo_first_touch_mt_arg
+	{
+	char *ptr;
+	size_t bsize;
+	int nb;
+	int nnode;
+	int node[BLASFEO_MAX_THREADS];
+	};
+
+
+
+static void blasfeo_first_touch_mt_work(int tid, int nth, void *ptr)
+	{
+	struct blasfeo_first_touch_mt_arg *arg = ptr;
+	int b0, b1;
+	blasfeo_thread_numa_range(tid, nth, arg->node, arg->nnode, arg->nb, 0, arg->nb, &b0, &b1);
+	if(b0<b1)
+		memset(arg->ptr+b0*arg->bsize, 0, (b1-b0)*arg->bsize);
+	return;
+	}
+
+#endif // MULTI_THREAD
+
+
+
+// zero a matrix structure, each block (panel row, or column if column-major) being written by a thread on the NUMA node
+// owning it, as by blasfeo_allocate_dmat_numa: with BLASFEO_NUMA_DEFAULT, this places the untouched pages by first touch
+void FIRST_TOUCH_MAT(struct MAT *sA)
+	{
+	int nb;
+	size_t bsize;
+	blasfeo_mat_numa_blocks(sA, &nb, &bsize);
+	// invalidate stored inverse diagonal
+	sA->use_dA = 0;
+	if(nb<=0 | bsize==0)
+		return;
+#if defined(MULTI_THREAD)
+	int nth = blasfeo_get_num_threads();
+	int nth_max = (double) nb*bsize/FIRST_TOUCH_MT_MIN;
+	nth_max = nth_max<nb ? nth_max : nb;
+	nth = nth<nth_max ? nth : nth_max;
+	if(nth>1)
+		{
+		struct blasfeo_first_touch_mt_arg arg;
+		arg.ptr = (char *) sA->pA;
+		arg.bsize = bsize;
+		arg.nb = nb;
+		arg.nnode = blasfeo_thread_numa_nodes(nth, arg.node);
+		blasfeo_parallel_run(nth, &blasfeo_first_touch_mt_work, &arg);
+		return;
+		}
+#endif
+	memset(sA->pA, 0, nb*bsize);
+	return;
+	}
+
+
+
 // create a vector structure for a vector of size m by dynamically allocating the memory
 void ALLOCATE_VEC(int m, struct VEC *sa)
 	{
@@ -271,6 +271,74 @@ void REF_PACK_TRAN_MAT(int m, int n, REAL *A, int lda, struct MAT *sB, int bi, i
 
 
 
+#if defined(DOUBLE_PRECISION)
+// convert a matrix, scaled by alpha, into a matrix structure
+void REF_PACK_SC_MAT(int m, int n, REAL alpha, REAL *A, int lda, struct MAT *sB, int bi, int bj)
+	{
+	// invalidate stored inverse diagonal
+	sB->use_dA = 0;
+	int ii, jj;
+#if defined(MF_COLMAJ)
+	int ldb = sB->m;
+	REAL *pB = sB->pA + bi + bj*ldb;
+	const int bbi=0; const int bbj=0;
+#else
+	int bbi=bi; int bbj=bj;
+#endif
+	for(jj=0; jj<n; jj++)
+		{
+		ii = 0;
+		for(; ii<m-3; ii+=4)
+			{
+			XMATEL_B(bbi+ii+0, bbj+jj) = alpha*A[ii+0+jj*lda];
+			XMATEL_B(bbi+ii+1, bbj+jj) = alpha*A[ii+1+jj*lda];
+			XMATEL_B(bbi+ii+2, bbj+jj) = alpha*A[ii+2+jj*lda];
+			XMATEL_B(bbi+ii+3, bbj+jj) = alpha*A[ii+3+jj*lda];
+			}
+		for(; ii<m; ii++)
+			{
+			XMATEL_B(bbi+ii+0, bbj+jj) = alpha*A[ii+0+jj*lda];
+			}
+		}
+	return;
+	}
+
+
+
+// convert and transpose a matrix, scaled by alpha, into a matrix structure
+void REF_PACK_TRAN_SC_MAT(int m, int n, REAL alpha, REAL *A, int lda, struct MAT *sB, int bi, int bj)
+	{
+	// invalidate stored inverse diagonal
+	sB->use_dA = 0;
+	int ii, jj;
+#if defined(MF_COLMAJ)
+	int ldb = sB->m;
+	REAL *pB = sB->pA + bi + bj*ldb;
+	const int bbi=0; const int bbj=0;
+#else
+	int bbi=bi; int bbj=bj;
+#endif
+	for(jj=0; jj<n; jj++)
+		{
+		ii = 0;
+		for(; ii<m-3; ii+=4)
+			{
+			XMATEL_B(bbi+jj, bbj+(ii+0)) = alpha*A[ii+0+jj*lda];
+			XMATEL_B(bbi+jj, bbj+(ii+1)) = alpha*A[ii+1+jj*lda];
+			XMATEL_B(bbi+jj, bbj+(ii+2)) = alpha*A[ii+2+jj*lda];
+			XMATEL_B(bbi+jj, bbj+(ii+3)) = alpha*A[ii+3+jj*lda];
+			}
+		for(; ii<m; ii++)
+			{
+			XMATEL_B(bbi+jj, bbj+(ii+0)) = alpha*A[ii+0+jj*lda];
+			}
+		}
+	return;
+	}
+#endif
+
+
+
 // convert a vector into a vector structure
 void REF_PACK_VEC(int m, REAL *x, int xi, struct VEC *sa, int ai)
 	{
@@ -1594,6 +1662,22 @@ void PACK_TRAN_MAT(int m, int n, REAL *A, int lda, struct MAT *sB, int bi, int b
 
 
 
+#if defined(DOUBLE_PRECISION)
+void PACK_SC_MAT(int m, int n, REAL alpha, REAL *A, int lda, struct MAT *sB, int bi, int bj)
+	{
+	REF_PACK_SC_MAT(m, n, alpha, A, lda, sB, bi, bj);
+	}
+
+
+
+void PACK_TRAN_SC_MAT(int m, int n, REAL alpha, REAL *A, int lda, struct MAT *sB, int bi, int bj)
+	{
+	REF_PACK_TRAN_SC_MAT(m, n, alpha, A, lda, sB, bi, bj);
+	}
+#endif
+
+
+
 void PACK_VEC(int m, REAL *x, int xi, struct VEC *sa, int ai)
 	{
 	REF_PACK_VEC(m, x, xi, sa, ai);
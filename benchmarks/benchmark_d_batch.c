@@ -0,0 +1,152 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "../include/blasfeo.h"
+#include "benchmark_x_common.h"
+
+
+
+// throughput of the batched routines against a loop of single calls,
+// on batch independent stages each with a dgemm_nt followed by a dpotrf_l
+
+int main()
+	{
+
+	printf("\nbenchmark batched dgemm_nt + dpotrf_l\n");
+	printf("\nnum threads %d\n\n", blasfeo_get_num_threads());
+
+	int ii, jj, ll, rep, rep_in;
+
+	int nrep_in = 10; // number of benchmark batches
+
+	int nn[] = {4, 6, 8, 10, 12, 16, 20, 24, 32};
+	int batch = 1000;
+
+	struct blasfeo_dmat *sA = malloc(batch*sizeof(struct blasfeo_dmat));
+	struct blasfeo_dmat *sC = malloc(batch*sizeof(struct blasfeo_dmat));
+	struct blasfeo_dmat *sD = malloc(batch*sizeof(struct blasfeo_dmat));
+	struct blasfeo_dmat **pA = malloc(batch*sizeof(struct blasfeo_dmat *));
+	struct blasfeo_dmat **pC = malloc(batch*sizeof(struct blasfeo_dmat *));
+	struct blasfeo_dmat **pD = malloc(batch*sizeof(struct blasfeo_dmat *));
+	int *i0 = calloc(batch, sizeof(int));
+
+	printf("n\tbatch\tloop [Gflops]\tbatch [Gflops]\tspeedup\n");
+
+	for(ll=0; ll<9; ll++)
+		{
+
+		int n = nn[ll];
+		int nrep = 40000/n/n;
+		nrep = nrep>1 ? nrep : 1;
+
+		for(ii=0; ii<batch; ii++)
+			{
+			blasfeo_allocate_dmat(n, n, sA+ii);
+			blasfeo_allocate_dmat(n, n, sC+ii);
+			blasfeo_allocate_dmat(n, n, sD+ii);
+			pA[ii] = sA+ii;
+			pC[ii] = sC+ii;
+			pD[ii] = sD+ii;
+			// A full, C = n * I, A * A^T + C is positive definite
+			for(jj=0; jj<n*n; jj++)
+				blasfeo_dgein1(1.0/(1.0+ii+jj), sA+ii, jj%n, jj/n);
+			blasfeo_dgese(n, n, 0.0, sC+ii, 0, 0);
+			blasfeo_ddiare(n, 1.0*n, sC+ii, 0, 0);
+			}
+
+		blasfeo_timer timer;
+		double time_loop = 1e15;
+		double time_batch = 1e15;
+		double tmp_time;
+
+		// batches repetion, find minimum averaged time
+		for(rep_in=0; rep_in<nrep_in; rep_in++)
+			{
+
+			// loop of single calls
+			blasfeo_tic(&timer);
+			for(rep=0; rep<nrep; rep++)
+				{
+				for(ii=0; ii<batch; ii++)
+					{
+					blasfeo_dgemm_nt(n, n, n, 1.0, sA+ii, 0, 0, sA+ii, 0, 0, 1.0, sC+ii, 0, 0, sD+ii, 0, 0);
+					blasfeo_dpotrf_l(n, sD+ii, 0, 0, sD+ii, 0, 0);
+					}
+				}
+			tmp_time = blasfeo_toc(&timer) / nrep;
+			time_loop = tmp_time<time_loop ? tmp_time : time_loop;
+
+			// batched calls
+			blasfeo_tic(&timer);
+			for(rep=0; rep<nrep; rep++)
+				{
+				blasfeo_dgemm_nt_batch(n, n, n, 1.0, pA, i0, i0, pA, i0, i0, 1.0, pC, i0, i0, pD, i0, i0, batch);
+				blasfeo_dpotrf_l_batch(n, pD, i0, i0, pD, i0, i0, batch);
+				}
+			tmp_time = blasfeo_toc(&timer) / nrep;
+			time_batch = tmp_time<time_batch ? tmp_time : time_batch;
+
+			}
+
+		double flop = batch * (2.0*n*n*n + 1.0/3.0*n*n*n);
+		double Gflops_loop = 1e-9 * flop / time_loop;
+		double Gflops_batch = 1e-9 * flop / time_batch;
+
+		printf("%d\t%d\t%f\t%f\t%f\n", n, batch, Gflops_loop, Gflops_batch, time_loop/time_batch);
+
+		for(ii=0; ii<batch; ii++)
+			{
+			blasfeo_free_dmat(sA+ii);
+			blasfeo_free_dmat(sC+ii);
+			blasfeo_free_dmat(sD+ii);
+			}
+
+		}
+
+	free(sA);
+	free(sC);
+	free(sD);
+	free(pA);
+	free(pC);
+	free(pD);
+	free(i0);
+
+	return 0;
+
+	}
@@ -0,0 +1,169 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "../include/blasfeo.h"
+#include "benchmark_x_common.h"
+
+
+
+// throughput of the compact layout routines against the batched routines on the standard layout,
+// on nb independent stages each with a dgemm_nt followed by a dpotrf_l
+
+int main()
+	{
+
+	printf("\nbenchmark compact dgemm_nt + dpotrf_l\n");
+	printf("\nnum threads %d\n\n", blasfeo_get_num_threads());
+
+	int ii, jj, ll, rep, rep_in;
+
+	int nrep_in = 10; // number of benchmark batches
+
+	int nn[] = {2, 3, 4, 6, 8, 10, 12, 16, 20, 24};
+	int nb = 1000;
+
+	struct blasfeo_dmat *sA = malloc(nb*sizeof(struct blasfeo_dmat));
+	struct blasfeo_dmat *sC = malloc(nb*sizeof(struct blasfeo_dmat));
+	struct blasfeo_dmat *sD = malloc(nb*sizeof(struct blasfeo_dmat));
+	struct blasfeo_dmat **pA = malloc(nb*sizeof(struct blasfeo_dmat *));
+	struct blasfeo_dmat **pC = malloc(nb*sizeof(struct blasfeo_dmat *));
+	struct blasfeo_dmat **pD = malloc(nb*sizeof(struct blasfeo_dmat *));
+	double **A = malloc(nb*sizeof(double *));
+	double **C = malloc(nb*sizeof(double *));
+	int *i0 = calloc(nb, sizeof(int));
+
+	struct blasfeo_dmat_compact cA, cC, cD;
+
+	printf("n\tnb\tbatch [Gflops]\tcompact [Gflops]\tspeedup\n");
+
+	for(ll=0; ll<10; ll++)
+		{
+
+		int n = nn[ll];
+		int nrep = 40000/n/n;
+		nrep = nrep>1 ? nrep : 1;
+
+		blasfeo_allocate_dmat_compact(n, n, nb, &cA);
+		blasfeo_allocate_dmat_compact(n, n, nb, &cC);
+		blasfeo_allocate_dmat_compact(n, n, nb, &cD);
+
+		for(ii=0; ii<nb; ii++)
+			{
+			// A full, C = n * I, A * A^T + C is positive definite
+			A[ii] = malloc(n*n*sizeof(double));
+			C[ii] = calloc(n*n, sizeof(double));
+			for(jj=0; jj<n*n; jj++)
+				A[ii][jj] = 1.0/(1.0+ii+jj);
+			for(jj=0; jj<n; jj++)
+				C[ii][jj*(n+1)] = 1.0*n;
+			blasfeo_allocate_dmat(n, n, sA+ii);
+			blasfeo_allocate_dmat(n, n, sC+ii);
+			blasfeo_allocate_dmat(n, n, sD+ii);
+			blasfeo_pack_dmat(n, n, A[ii], n, sA+ii, 0, 0);
+			blasfeo_pack_dmat(n, n, C[ii], n, sC+ii, 0, 0);
+			pA[ii] = sA+ii;
+			pC[ii] = sC+ii;
+			pD[ii] = sD+ii;
+			}
+		blasfeo_pack_dmat_compact(n, n, A, n, &cA, 0, 0);
+		blasfeo_pack_dmat_compact(n, n, C, n, &cC, 0, 0);
+
+		blasfeo_timer timer;
+		double time_batch = 1e15;
+		double time_compact = 1e15;
+		double tmp_time;
+
+		// batches repetion, find minimum averaged time
+		for(rep_in=0; rep_in<nrep_in; rep_in++)
+			{
+
+			// batched calls on the standard layout
+			blasfeo_tic(&timer);
+			for(rep=0; rep<nrep; rep++)
+				{
+				blasfeo_dgemm_nt_batch(n, n, n, 1.0, pA, i0, i0, pA, i0, i0, 1.0, pC, i0, i0, pD, i0, i0, nb);
+				blasfeo_dpotrf_l_batch(n, pD, i0, i0, pD, i0, i0, nb);
+				}
+			tmp_time = blasfeo_toc(&timer) / nrep;
+			time_batch = tmp_time<time_batch ? tmp_time : time_batch;
+
+			// compact layout calls
+			blasfeo_tic(&timer);
+			for(rep=0; rep<nrep; rep++)
+				{
+				blasfeo_dgemm_nt_compact(n, n, n, 1.0, &cA, 0, 0, &cA, 0, 0, 1.0, &cC, 0, 0, &cD, 0, 0);
+				blasfeo_dpotrf_l_compact(n, &cD, 0, 0, &cD, 0, 0);
+				}
+			tmp_time = blasfeo_toc(&timer) / nrep;
+			time_compact = tmp_time<time_compact ? tmp_time : time_compact;
+
+			}
+
+		double flop = nb * (2.0*n*n*n + 1.0/3.0*n*n*n);
+		double Gflops_batch = 1e-9 * flop / time_batch;
+		double Gflops_compact = 1e-9 * flop / time_compact;
+
+		printf("%d\t%d\t%f\t%f\t%f\n", n, nb, Gflops_batch, Gflops_compact, time_batch/time_compact);
+
+		for(ii=0; ii<nb; ii++)
+			{
+			free(A[ii]);
+			free(C[ii]);
+			blasfeo_free_dmat(sA+ii);
+			blasfeo_free_dmat(sC+ii);
+			blasfeo_free_dmat(sD+ii);
+			}
+		blasfeo_free_dmat_compact(&cA);
+		blasfeo_free_dmat_compact(&cC);
+		blasfeo_free_dmat_compact(&cD);
+
+		}
+
+	free(sA);
+	free(sC);
+	free(sD);
+	free(pA);
+	free(pC);
+	free(pD);
+	free(A);
+	free(C);
+	free(i0);
+
+	return 0;
+
+	}
@@ -0,0 +1,196 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "../include/blasfeo.h"
+
+
+
+// autotuner of the packing algorithm selection in the column-major dgemm (BLAS API): for each variant and each
+// (m,n,k) bin triple of the decision table, time the built-in heuristic and each packing algorithm at the
+// representative bin size, and assign the fastest algorithm to the triple when it beats the heuristic by more
+// than the tolerance; the table is written to a file to be loaded through the BLASFEO_DGEMM_TUNE environment
+// variable or blasfeo_dgemm_tune_load
+//
+// usage: benchmark_d_dgemm_tune.out [table file] [max bin] [tolerance]
+
+
+
+#if defined(BLAS_API)
+
+static double *A, *B, *C;
+
+// minimum over a few batches of the averaged time of one call
+static double time_dgemm(char ta, char tb, int m, int n, int k)
+	{
+	int lda = ta=='n' ? m : k;
+	int ldb = tb=='n' ? k : n;
+	int ldc = m;
+	double alpha = 1.0;
+	double beta = 0.0;
+	// about 2e6 flops per batch, at most 2000 calls
+	int nrep = 1000000 / (m*n*k);
+	nrep = nrep<2000 ? nrep : 2000;
+	nrep = nrep>1 ? nrep : 1;
+	int rep, rep_in;
+	blasfeo_timer timer;
+	double time = 1e15;
+	double tmp_time;
+	// warm up
+	blasfeo_blas_dgemm(&ta, &tb, &m, &n, &k, &alpha, A, &lda, B, &ldb, &beta, C, &ldc);
+	for(rep_in=0; rep_in<5; rep_in++)
+		{
+		blasfeo_tic(&timer);
+		for(rep=0; rep<nrep; rep++)
+			{
+			blasfeo_blas_dgemm(&ta, &tb, &m, &n, &k, &alpha, A, &lda, B, &ldb, &beta, C, &ldc);
+			}
+		tmp_time = blasfeo_toc(&timer) / nrep;
+		time = tmp_time<time ? tmp_time : time;
+		}
+	return time;
+	}
+
+#endif
+
+
+
+int main(int argc, char **argv)
+	{
+
+#if defined(BLAS_API)
+
+	char *file_name = argc>1 ? argv[1] : "dgemm_tune.txt";
+	int max_bin = argc>2 ? atoi(argv[2]) : 8;
+	double tol = argc>3 ? atof(argv[3]) : 0.10;
+
+	max_bin = max_bin<BLASFEO_DGEMM_TUNE_BINS ? max_bin : BLASFEO_DGEMM_TUNE_BINS-1;
+
+	char ta_list[4] = {'n', 'n', 't', 't'};
+	char tb_list[4] = {'n', 't', 'n', 't'};
+
+	int ii;
+	int variant, bm, bn, bk, alg;
+	int m, n, k;
+	int size = blasfeo_dgemm_tune_bin_size(max_bin);
+	double time, time_auto, time_best;
+	int alg_best;
+	int entries = 0;
+
+	A = malloc(size*size*sizeof(double));
+	B = malloc(size*size*sizeof(double));
+	C = malloc(size*size*sizeof(double));
+	for(ii=0; ii<size*size; ii++)
+		{
+		A[ii] = 1.0/(1.0+ii);
+		B[ii] = 1.0/(2.0+ii);
+		C[ii] = 0.0;
+		}
+
+	// the table being tuned is the one used by dgemm: start from the built-in heuristic
+	blasfeo_dgemm_tune_clear();
+
+	printf("\ndgemm decision table autotuner, bins 0 to %d (sizes up to %d), tolerance %f\n", max_bin, size, tol);
+	printf("\nvariant\tm\tn\tk\tauto [Gflops]\tbest [Gflops]\tbest alg\n");
+
+	for(variant=0; variant<4; variant++)
+		{
+		for(bm=0; bm<=max_bin; bm++)
+			{
+			m = blasfeo_dgemm_tune_bin_size(bm);
+			for(bn=0; bn<=max_bin; bn++)
+				{
+				n = blasfeo_dgemm_tune_bin_size(bn);
+				for(bk=0; bk<=max_bin; bk++)
+					{
+					k = blasfeo_dgemm_tune_bin_size(bk);
+
+					blasfeo_dgemm_tune_set(variant, bm, bn, bk, BLASFEO_DGEMM_ALG_AUTO);
+					time_auto = time_dgemm(ta_list[variant], tb_list[variant], m, n, k);
+
+					time_best = time_auto;
+					alg_best = BLASFEO_DGEMM_ALG_AUTO;
+					for(alg=BLASFEO_DGEMM_ALG_0; alg<=BLASFEO_DGEMM_ALG_2; alg++)
+						{
+						if(variant==BLASFEO_DGEMM_TN & alg==BLASFEO_DGEMM_ALG_0)
+							continue;
+						blasfeo_dgemm_tune_set(variant, bm, bn, bk, alg);
+						time = time_dgemm(ta_list[variant], tb_list[variant], m, n, k);
+						if(time<time_best)
+							{
+							time_best = time;
+							alg_best = alg;
+							}
+						}
+
+					// keep the heuristic unless clearly slower
+					if(time_best>(1.0-tol)*time_auto)
+						{
+						alg_best = BLASFEO_DGEMM_ALG_AUTO;
+						time_best = time_auto;
+						}
+					blasfeo_dgemm_tune_set(variant, bm, bn, bk, alg_best);
+					entries += alg_best!=BLASFEO_DGEMM_ALG_AUTO;
+
+					printf("%c%c\t%d\t%d\t%d\t%f\t%f\t%d\n", ta_list[variant], tb_list[variant], m, n, k, 2e-9*m*n*k/time_auto, 2e-9*m*n*k/time_best, alg_best);
+					}
+				}
+			}
+		}
+
+	if(blasfeo_dgemm_tune_save(file_name)!=0)
+		{
+		printf("\nError: cannot write %s\n", file_name);
+		exit(1);
+		}
+	printf("\n%d entries written to %s\n\n", entries, file_name);
+
+	free(A);
+	free(B);
+	free(C);
+
+#else
+
+	printf("\nthe dgemm autotuner needs BLAS_API=1\n\n");
+
+#endif
+
+	return 0;
+
+	}
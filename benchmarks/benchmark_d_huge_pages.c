@@ -0,0 +1,166 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../include/blasfeo.h"
+#include "benchmark_x_common.h"
+
+
+
+// large dgemm_nt and dpotrf_l on matrices allocated with and without huge pages
+
+// anonymous memory of the process backed by transparent huge pages, in kB (-1 if unknown)
+static long huge_pages_kb()
+	{
+	long kb = -1;
+#if defined(__linux__)
+	char line[256];
+	FILE *file = fopen("/proc/self/smaps_rollup", "r");
+	if(file==NULL)
+		return -1;
+	while(fgets(line, sizeof(line), file)!=NULL)
+		{
+		if(strncmp(line, "AnonHugePages:", 14)==0)
+			{
+			kb = atol(line+14);
+			break;
+			}
+		}
+	fclose(file);
+#endif
+	return kb;
+	}
+
+
+
+int main()
+	{
+
+	printf("\nbenchmark dgemm_nt and dpotrf_l with huge pages (BLASFEO_HUGE_PAGES_OFF, _ON, _PREFAULT)\n\n");
+
+	int ii, jj, ll, mode, rep, rep_in;
+
+	int nrep_in = 3; // number of benchmark batches
+
+	int nn[] = {512, 1024, 2048, 3072, 4096};
+	char *mode_name[] = {"off", "on", "prefault"};
+
+	printf("n\tmode\t\tdgemm_nt [Gflops]\tdpotrf_l [Gflops]\thuge pages [MB]\n");
+
+	for(ll=0; ll<5; ll++)
+		{
+
+		int n = nn[ll];
+		int nrep = 4000000000.0/n/n/n;
+		nrep = nrep>1 ? nrep : 1;
+
+		for(mode=BLASFEO_HUGE_PAGES_OFF; mode<=BLASFEO_HUGE_PAGES_PREFAULT; mode++)
+			{
+
+			blasfeo_set_huge_pages(mode);
+			// packing buffer allocated in the same mode
+			blasfeo_quit();
+			blasfeo_init();
+
+			struct blasfeo_dmat sA, sB, sD, sP, sL;
+			blasfeo_allocate_dmat(n, n, &sA);
+			blasfeo_allocate_dmat(n, n, &sB);
+			blasfeo_allocate_dmat(n, n, &sD);
+			blasfeo_allocate_dmat(n, n, &sP);
+			blasfeo_allocate_dmat(n, n, &sL);
+
+			// P = A * A^T + n * I symmetric positive definite
+			for(jj=0; jj<n; jj++)
+				for(ii=0; ii<n; ii++)
+					{
+					blasfeo_dgein1((double) rand() / RAND_MAX - 0.5, &sA, ii, jj);
+					blasfeo_dgein1((double) rand() / RAND_MAX - 0.5, &sB, ii, jj);
+					}
+			blasfeo_dgese(n, n, 0.0, &sP, 0, 0);
+			blasfeo_ddiare(n, 1.0*n, &sP, 0, 0);
+			blasfeo_dsyrk_ln(n, n, 1.0, &sA, 0, 0, &sA, 0, 0, 1.0, &sP, 0, 0, &sP, 0, 0);
+
+			long kb = huge_pages_kb();
+
+			blasfeo_timer timer;
+			double time_gemm = 1e15;
+			double time_potrf = 1e15;
+			double tmp_time;
+
+			// batches repetion, find minimum averaged time
+			for(rep_in=0; rep_in<nrep_in; rep_in++)
+				{
+
+				blasfeo_tic(&timer);
+				for(rep=0; rep<nrep; rep++)
+					{
+					blasfeo_dgemm_nt(n, n, n, 1.0, &sA, 0, 0, &sB, 0, 0, 0.0, &sD, 0, 0, &sD, 0, 0);
+					}
+				tmp_time = blasfeo_toc(&timer) / nrep;
+				time_gemm = tmp_time<time_gemm ? tmp_time : time_gemm;
+
+				blasfeo_tic(&timer);
+				for(rep=0; rep<nrep; rep++)
+					{
+					blasfeo_dpotrf_l(n, &sP, 0, 0, &sL, 0, 0);
+					}
+				tmp_time = blasfeo_toc(&timer) / nrep;
+				time_potrf = tmp_time<time_potrf ? tmp_time : time_potrf;
+
+				}
+
+			double flop_gemm = 2.0*n*n*n;
+			double flop_potrf = 1.0/3.0*n*n*n;
+
+			printf("%d\t%s\t\t%f\t\t%f\t\t%.1f\n", n, mode_name[mode], 1e-9*flop_gemm/time_gemm, 1e-9*flop_potrf/time_potrf, kb/1024.0);
+
+			blasfeo_free_dmat(&sA);
+			blasfeo_free_dmat(&sB);
+			blasfeo_free_dmat(&sD);
+			blasfeo_free_dmat(&sP);
+			blasfeo_free_dmat(&sL);
+
+			}
+
+		}
+
+	blasfeo_quit();
+
+	return 0;
+
+	}
@@ -0,0 +1,150 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "../include/blasfeo.h"
+#include "benchmark_x_common.h"
+
+
+
+// small dgemm_nn and dgemm_nt with the generic routines and with the JIT-compiled kernels
+
+int main()
+	{
+
+	printf("\nbenchmark JIT-compiled dgemm kernels against the generic routines\n\n");
+
+	int ii, jj, ll, tt, rep, rep_in;
+
+	int nrep_in = 5; // number of benchmark batches
+
+	int nn[] = {2, 3, 4, 5, 6, 8, 10, 12, 16, 20, 24, 28, 32};
+	int nnn = sizeof(nn)/sizeof(int);
+
+	int nmax = 32;
+
+	struct blasfeo_dmat sA, sB, sC, sD;
+	blasfeo_allocate_dmat(nmax, nmax, &sA);
+	blasfeo_allocate_dmat(nmax, nmax, &sB);
+	blasfeo_allocate_dmat(nmax, nmax, &sC);
+	blasfeo_allocate_dmat(nmax, nmax, &sD);
+
+	for(jj=0; jj<nmax; jj++)
+		for(ii=0; ii<nmax; ii++)
+			{
+			blasfeo_dgein1((double) rand() / RAND_MAX - 0.5, &sA, ii, jj);
+			blasfeo_dgein1((double) rand() / RAND_MAX - 0.5, &sB, ii, jj);
+			blasfeo_dgein1((double) rand() / RAND_MAX - 0.5, &sC, ii, jj);
+			}
+
+	printf("routine\tn\tgeneric [ns]\tjit [ns]\tjit+lookup [ns]\tspeedup\n");
+
+	for(tt=0; tt<2; tt++)
+		{
+
+		char tb = tt==0 ? 'n' : 't';
+
+		for(ll=0; ll<nnn; ll++)
+			{
+
+			int n = nn[ll];
+			int nrep = 100000000.0/n/n/n;
+			nrep = nrep>1000 ? nrep : 1000;
+
+			struct blasfeo_djit_dgemm *jit = blasfeo_djit_dgemm_dispatch('n', tb, n, n, n, 1.0, &sA, &sB, 1.0, &sC, &sD);
+			if(jit==NULL)
+				{
+				printf("\nJIT not available\n\n");
+				return 0;
+				}
+
+			blasfeo_timer timer;
+			double time_ref = 1e15;
+			double time_jit = 1e15;
+			double time_lookup = 1e15;
+			double tmp_time;
+
+			// batches repetion, find minimum averaged time
+			for(rep_in=0; rep_in<nrep_in; rep_in++)
+				{
+
+				blasfeo_tic(&timer);
+				for(rep=0; rep<nrep; rep++)
+					{
+					if(tb=='n')
+						blasfeo_dgemm_nn(n, n, n, 1.0, &sA, 0, 0, &sB, 0, 0, 1.0, &sC, 0, 0, &sD, 0, 0);
+					else
+						blasfeo_dgemm_nt(n, n, n, 1.0, &sA, 0, 0, &sB, 0, 0, 1.0, &sC, 0, 0, &sD, 0, 0);
+					}
+				tmp_time = blasfeo_toc(&timer) / nrep;
+				time_ref = tmp_time<time_ref ? tmp_time : time_ref;
+
+				blasfeo_tic(&timer);
+				for(rep=0; rep<nrep; rep++)
+					{
+					blasfeo_djit_dgemm_run(jit, 1.0, &sA, 0, 0, &sB, 0, 0, 1.0, &sC, 0, 0, &sD, 0, 0);
+					}
+				tmp_time = blasfeo_toc(&timer) / nrep;
+				time_jit = tmp_time<time_jit ? tmp_time : time_jit;
+
+				blasfeo_tic(&timer);
+				for(rep=0; rep<nrep; rep++)
+					{
+					blasfeo_djit_dgemm('n', tb, n, n, n, 1.0, &sA, 0, 0, &sB, 0, 0, 1.0, &sC, 0, 0, &sD, 0, 0);
+					}
+				tmp_time = blasfeo_toc(&timer) / nrep;
+				time_lookup = tmp_time<time_lookup ? tmp_time : time_lookup;
+
+				}
+
+			printf("dgemm_n%c\t%d\t%f\t%f\t%f\t%f\n", tb, n, 1e9*time_ref, 1e9*time_jit, 1e9*time_lookup, time_ref/time_jit);
+
+			}
+
+		}
+
+	blasfeo_djit_free();
+
+	blasfeo_free_dmat(&sA);
+	blasfeo_free_dmat(&sB);
+	blasfeo_free_dmat(&sC);
+	blasfeo_free_dmat(&sD);
+
+	return 0;
+
+	}
@@ -0,0 +1,180 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo.h"
+#include "benchmark_x_common.h"
+
+
+
+// time-to-solution of the mixed-precision solvers against the double-precision factorization and solution
+
+static double residual(int n, int nrhs, struct blasfeo_dmat *sA, struct blasfeo_dmat *sB, struct blasfeo_dmat *sX, struct blasfeo_dmat *sR)
+	{
+	int ii, jj;
+	double tmp, res = 0.0;
+	blasfeo_dgemm_nn(n, nrhs, n, -1.0, sA, 0, 0, sX, 0, 0, 1.0, sB, 0, 0, sR, 0, 0);
+	for(jj=0; jj<nrhs; jj++)
+		for(ii=0; ii<n; ii++)
+			{
+			tmp = fabs(BLASFEO_DMATEL(sR, ii, jj));
+			res = tmp>res ? tmp : res;
+			}
+	return res;
+	}
+
+
+
+int main()
+	{
+
+	printf("\nbenchmark mixed-precision dgesv and dposv\n\n");
+
+	int ii, jj, ll, rep, rep_in;
+
+	int nrep_in = 5; // number of benchmark batches
+
+	int nn[] = {16, 32, 64, 128, 256, 512, 1024};
+	int nrhs = 1;
+
+	printf("n\tdgetrf+s [ms]\tdgesv_mixed [ms]\titer\tspeedup\tdposv [ms]\tdposv_mixed [ms]\titer\tspeedup\tres_d\t\tres_mixed\n");
+
+	for(ll=0; ll<7; ll++)
+		{
+
+		int n = nn[ll];
+		int nrep = 10000000/n/n/n;
+		nrep = nrep>1 ? nrep : 1;
+
+		struct blasfeo_dmat sA, sP, sLU, sB, sX, sR;
+		blasfeo_allocate_dmat(n, n, &sA);
+		blasfeo_allocate_dmat(n, n, &sP);
+		blasfeo_allocate_dmat(n, n, &sLU);
+		blasfeo_allocate_dmat(n, nrhs, &sB);
+		blasfeo_allocate_dmat(n, nrhs, &sX);
+		blasfeo_allocate_dmat(n, nrhs, &sR);
+		int *ipiv = malloc(n*sizeof(int));
+
+		// A general and well conditioned, P = A^T * A + n * I symmetric positive definite
+		for(jj=0; jj<n; jj++)
+			for(ii=0; ii<n; ii++)
+				blasfeo_dgein1((double) rand() / RAND_MAX - 0.5 + (ii==jj ? 0.1*n : 0.0), &sA, ii, jj);
+		blasfeo_dgese(n, n, 0.0, &sP, 0, 0);
+		blasfeo_ddiare(n, 1.0*n, &sP, 0, 0);
+		blasfeo_dgemm_tn(n, n, n, 1.0, &sA, 0, 0, &sA, 0, 0, 1.0, &sP, 0, 0, &sP, 0, 0);
+		for(jj=0; jj<nrhs; jj++)
+			for(ii=0; ii<n; ii++)
+				blasfeo_dgein1((double) rand() / RAND_MAX - 0.5, &sB, ii, jj);
+
+		blasfeo_timer timer;
+		double time_getrf = 1e15;
+		double time_gesv = 1e15;
+		double time_potrf = 1e15;
+		double time_posv = 1e15;
+		double tmp_time;
+		int iter_gesv = 0;
+		int iter_posv = 0;
+
+		// batches repetion, find minimum averaged time
+		for(rep_in=0; rep_in<nrep_in; rep_in++)
+			{
+
+			blasfeo_tic(&timer);
+			for(rep=0; rep<nrep; rep++)
+				{
+				blasfeo_dgetrf_rp(n, n, &sA, 0, 0, &sLU, 0, 0, ipiv);
+				blasfeo_dgecp(n, nrhs, &sB, 0, 0, &sX, 0, 0);
+				blasfeo_drowpe(n, ipiv, &sX);
+				blasfeo_dtrsm_llnu(n, nrhs, 1.0, &sLU, 0, 0, &sX, 0, 0, &sX, 0, 0);
+				blasfeo_dtrsm_lunn(n, nrhs, 1.0, &sLU, 0, 0, &sX, 0, 0, &sX, 0, 0);
+				}
+			tmp_time = blasfeo_toc(&timer) / nrep;
+			time_getrf = tmp_time<time_getrf ? tmp_time : time_getrf;
+
+			blasfeo_tic(&timer);
+			for(rep=0; rep<nrep; rep++)
+				{
+				iter_gesv = blasfeo_dgesv_mixed(n, nrhs, &sA, 0, 0, &sB, 0, 0, &sX, 0, 0);
+				}
+			tmp_time = blasfeo_toc(&timer) / nrep;
+			time_gesv = tmp_time<time_gesv ? tmp_time : time_gesv;
+
+			blasfeo_tic(&timer);
+			for(rep=0; rep<nrep; rep++)
+				{
+				blasfeo_dpotrf_l(n, &sP, 0, 0, &sLU, 0, 0);
+				blasfeo_dtrsm_llnn(n, nrhs, 1.0, &sLU, 0, 0, &sB, 0, 0, &sX, 0, 0);
+				blasfeo_dtrsm_lltn(n, nrhs, 1.0, &sLU, 0, 0, &sX, 0, 0, &sX, 0, 0);
+				}
+			tmp_time = blasfeo_toc(&timer) / nrep;
+			time_potrf = tmp_time<time_potrf ? tmp_time : time_potrf;
+
+			blasfeo_tic(&timer);
+			for(rep=0; rep<nrep; rep++)
+				{
+				iter_posv = blasfeo_dposv_mixed(n, nrhs, &sP, 0, 0, &sB, 0, 0, &sX, 0, 0);
+				}
+			tmp_time = blasfeo_toc(&timer) / nrep;
+			time_posv = tmp_time<time_posv ? tmp_time : time_posv;
+
+			}
+
+		// accuracy of the last solutions
+		double res_mixed = residual(n, nrhs, &sP, &sB, &sX, &sR);
+		blasfeo_dpotrf_l(n, &sP, 0, 0, &sLU, 0, 0);
+		blasfeo_dtrsm_llnn(n, nrhs, 1.0, &sLU, 0, 0, &sB, 0, 0, &sX, 0, 0);
+		blasfeo_dtrsm_lltn(n, nrhs, 1.0, &sLU, 0, 0, &sX, 0, 0, &sX, 0, 0);
+		double res_d = residual(n, nrhs, &sP, &sB, &sX, &sR);
+
+		printf("%d\t%f\t%f\t\t%d\t%f\t%f\t%f\t\t%d\t%f\t%e\t%e\n", n, 1e3*time_getrf, 1e3*time_gesv, iter_gesv, time_getrf/time_gesv, 1e3*time_potrf, 1e3*time_posv, iter_posv, time_potrf/time_posv, res_d, res_mixed);
+
+		blasfeo_free_dmat(&sA);
+		blasfeo_free_dmat(&sP);
+		blasfeo_free_dmat(&sLU);
+		blasfeo_free_dmat(&sB);
+		blasfeo_free_dmat(&sX);
+		blasfeo_free_dmat(&sR);
+		free(ipiv);
+
+		}
+
+	return 0;
+
+	}
@@ -81,7 +81,7 @@ void GEMV(char *trans, int *pm, int *pn, REAL *alpha, REAL *A, int *plda, REAL *
 	else
 		{
 		if(lx>K_MAX_STACK)
-			x = malloc(lx*sizeof(REAL));
+			blasfeo_work_malloc((void **) &x, lx*sizeof(REAL));
 		else
 			x = x_stack;
 
@@ -101,7 +101,7 @@ void GEMV(char *trans, int *pm, int *pn, REAL *alpha, REAL *A, int *plda, REAL *
 	else
 		{
 		if(ly>K_MAX_STACK)
-			y = malloc(ly*sizeof(REAL));
+			blasfeo_work_malloc((void **) &y, ly*sizeof(REAL));
 		else
 			y = y_stack;
 
@@ -136,7 +136,7 @@ void GEMV(char *trans, int *pm, int *pn, REAL *alpha, REAL *A, int *plda, REAL *
 	if(incx!=1)
 		{
 		if(lx>K_MAX_STACK)
-			free(x);
+			blasfeo_work_free(x);
 		}
 
 	if(incy!=1)
@@ -145,7 +145,7 @@ void GEMV(char *trans, int *pm, int *pn, REAL *alpha, REAL *A, int *plda, REAL *
 			y0[ky + ii*incy] = y[ii];
 
 		if(ly>K_MAX_STACK)
-			free(y);
+			blasfeo_work_free(y);
 		}
 
 	return;
@@ -68,7 +68,7 @@ void BLAS_GER(int *pm, int *pn, REAL *alpha, REAL *x0, int *pincx, REAL *y0, int
 	else
 		{
 		if(lx>K_MAX_STACK)
-			x = malloc(lx*sizeof(REAL));
+			blasfeo_work_malloc((void **) &x, lx*sizeof(REAL));
 		else
 			x = x_stack;
 
@@ -88,7 +88,7 @@ void BLAS_GER(int *pm, int *pn, REAL *alpha, REAL *x0, int *pincx, REAL *y0, int
 	else
 		{
 		if(ly>K_MAX_STACK)
-			y = malloc(ly*sizeof(REAL));
+			blasfeo_work_malloc((void **) &y, ly*sizeof(REAL));
 		else
 			y = y_stack;
 
@@ -116,13 +116,13 @@ void BLAS_GER(int *pm, int *pn, REAL *alpha, REAL *x0, int *pincx, REAL *y0, int
 	if(incx!=1)
 		{
 		if(lx>K_MAX_STACK)
-			free(x);
+			blasfeo_work_free(x);
 		}
 
 	if(incy!=1)
 		{
 		if(ly>K_MAX_STACK)
-			free(y);
+			blasfeo_work_free(y);
 		}
 
 	return;
@@ -52,7 +52,7 @@ void GETRF(int *pm, int *pn, REAL *C, int *pldc, int *ipiv, int *info)
 	REAL *dC;
 	if(p>K_MAX_STACK)
 		{
-		dC = (REAL *) malloc(p*sizeof(REAL));
+		blasfeo_work_malloc((void **) &dC, p*sizeof(REAL));
 		}
 	else
 		{
@@ -72,7 +72,7 @@ void GETRF(int *pm, int *pn, REAL *C, int *pldc, int *ipiv, int *info)
 
 	if(p>K_MAX_STACK)
 		{
-		free(dC);
+		blasfeo_work_free(dC);
 		}
 
 	// from 0-based to 1-based
@@ -62,7 +62,7 @@ void POTRF(char *uplo, int *pm, REAL *C, int *pldc, int *info)
 	REAL *dC;
 	if(*pm>K_MAX_STACK)
 		{
-		dC = (REAL *) malloc(*pm*sizeof(REAL));
+		blasfeo_work_malloc((void **) &dC, *pm*sizeof(REAL));
 		}
 	else
 		{
@@ -89,7 +89,7 @@ void POTRF(char *uplo, int *pm, REAL *C, int *pldc, int *info)
 
 	if(*pm>K_MAX_STACK)
 		{
-		free(dC);
+		blasfeo_work_free(dC);
 		}
 
 	*info = 0;
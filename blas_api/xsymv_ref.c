@@ -68,7 +68,7 @@ void SYMV(char *uplo, int *pn, REAL *alpha, REAL *A, int *plda, REAL *x0, int *p
 	else
 		{
 		if(n>K_MAX_STACK)
-			x = malloc(n*sizeof(REAL));
+			blasfeo_work_malloc((void **) &x, n*sizeof(REAL));
 		else
 			x = x_stack;
 
@@ -88,7 +88,7 @@ void SYMV(char *uplo, int *pn, REAL *alpha, REAL *A, int *plda, REAL *x0, int *p
 	else
 		{
 		if(n>K_MAX_STACK)
-			y = malloc(n*sizeof(REAL));
+			blasfeo_work_malloc((void **) &y, n*sizeof(REAL));
 		else
 			y = y_stack;
 
@@ -123,7 +123,7 @@ void SYMV(char *uplo, int *pn, REAL *alpha, REAL *A, int *plda, REAL *x0, int *p
 	if(incx!=1)
 		{
 		if(n>K_MAX_STACK)
-			free(x);
+			blasfeo_work_free(x);
 		}
 
 	if(incy!=1)
@@ -132,7 +132,7 @@ void SYMV(char *uplo, int *pn, REAL *alpha, REAL *A, int *plda, REAL *x0, int *p
 			y0[ky + ii*incy] = y[ii];
 
 		if(n>K_MAX_STACK)
-			free(y);
+			blasfeo_work_free(y);
 		}
 
 	return;
@@ -83,7 +83,7 @@ void TRSM(char *side, char *uplo, char *transa, char *diag, int *pm, int *pn, RE
 	REAL *dA;
 	if(p>K_MAX_STACK)
 		{
-		dA = (REAL *) malloc(p*sizeof(REAL));
+		blasfeo_work_malloc((void **) &dA, p*sizeof(REAL));
 		}
 	else
 		{
@@ -209,7 +209,7 @@ void TRSM(char *side, char *uplo, char *transa, char *diag, int *pm, int *pn, RE
 
 	if(p>K_MAX_STACK)
 		{
-		free(dA);
+		blasfeo_work_free(dA);
 		}
 
 #ifdef TIME_INT
@@ -59,6 +59,8 @@
 #include <blasfeo_timing.h>
 
 #include <blasfeo_memory.h>
+#include <blasfeo_thread.h>
+#include <blasfeo_dgemm_tune.h>
 
 //void *blas_memory_alloc(int);
 //void blas_memory_free(void *);
@@ -77,6 +79,30 @@
 #define blasfeo_dgemm_nt blasfeo_cm_dgemm_nt
 #define blasfeo_dgemm_tn blasfeo_cm_dgemm_tn
 #define blasfeo_dgemm_tt blasfeo_cm_dgemm_tt
+#define blasfeo_hp_dgemm_nn_worksize blasfeo_hp_cm_dgemm_nn_worksize
+#define blasfeo_hp_dgemm_nt_worksize blasfeo_hp_cm_dgemm_nt_worksize
+#define blasfeo_hp_dgemm_tn_worksize blasfeo_hp_cm_dgemm_tn_worksize
+#define blasfeo_hp_dgemm_tt_worksize blasfeo_hp_cm_dgemm_tt_worksize
+#define blasfeo_dgemm_nn_worksize blasfeo_cm_dgemm_nn_worksize
+#define blasfeo_dgemm_nt_worksize blasfeo_cm_dgemm_nt_worksize
+#define blasfeo_dgemm_tn_worksize blasfeo_cm_dgemm_tn_worksize
+#define blasfeo_dgemm_tt_worksize blasfeo_cm_dgemm_tt_worksize
+#define blasfeo_dgemm_nn_ws blasfeo_cm_dgemm_nn_ws
+#define blasfeo_dgemm_nt_ws blasfeo_cm_dgemm_nt_ws
+#define blasfeo_dgemm_tn_ws blasfeo_cm_dgemm_tn_ws
+#define blasfeo_dgemm_tt_ws blasfeo_cm_dgemm_tt_ws
+#define blasfeo_hp_dgemm_pack_memsize blasfeo_hp_cm_dgemm_pack_memsize
+#define blasfeo_hp_dgemm_pack blasfeo_hp_cm_dgemm_pack
+#define blasfeo_hp_dgemm_compute_n blasfeo_hp_cm_dgemm_compute_n
+#define blasfeo_hp_dgemm_compute_t blasfeo_hp_cm_dgemm_compute_t
+#define blasfeo_dgemm_pack_memsize blasfeo_cm_dgemm_pack_memsize
+#define blasfeo_dgemm_pack blasfeo_cm_dgemm_pack
+#define blasfeo_dgemm_compute_n blasfeo_cm_dgemm_compute_n
+#define blasfeo_dgemm_compute_t blasfeo_cm_dgemm_compute_t
+#define blasfeo_hp_dgemm_plan blasfeo_hp_cm_dgemm_plan
+#define blasfeo_hp_dgemm_execute blasfeo_hp_cm_dgemm_execute
+#define blasfeo_dgemm_plan blasfeo_cm_dgemm_plan
+#define blasfeo_dgemm_execute blasfeo_cm_dgemm_execute
 #endif
 
 
@@ -92,9 +118,6 @@
 #define LLC_CACHE_EL D_LLC_CACHE_EL
 #define PS D_PS
 #define M_KERNEL D_M_KERNEL
-#define KC D_KC
-#define NC D_NC
-#define MC D_MC
 
 
 
@@ -578,16 +601,21 @@ nt_n2_return:
 
 
 
-static void blasfeo_hp_dgemm_nn_m1(int m, int n, int k, double alpha, double *A, int lda, double *B, int ldb, double beta, double *C, int ldc, double *D, int ldd, double *pU, int sdu)
+// A==NULL: A pre-packed in pU0 by blasfeo_hp_dgemm_pack, with panel stride sdu
+static void blasfeo_hp_dgemm_nn_m1(int m, int n, int k, double alpha, double *A, int lda, double *B, int ldb, double beta, double *C, int ldc, double *D, int ldd, double *pU0, int sdu)
 	{
 
 	int ii, jj;
+	double *pU = pU0;
 
 	ii = 0;
 #if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
 	for(; ii<m-11; ii+=12)
 		{
-		kernel_dpack_nn_12_lib4(k, A+ii+0, lda, pU, sdu);
+		if(A==NULL)
+			pU = pU0+ii*sdu;
+		else
+			kernel_dpack_nn_12_lib4(k, A+ii+0, lda, pU, sdu);
 		for(jj=0; jj<n-3; jj+=4)
 			{
 			kernel_dgemm_nn_12x4_lib4ccc(k, &alpha, pU, sdu, B+jj*ldb, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd);
@@ -615,7 +643,10 @@ static void blasfeo_hp_dgemm_nn_m1(int m, int n, int k, double alpha, double *A,
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57)
 	for(; ii<m-7; ii+=8)
 		{
-		kernel_dpack_nn_8_lib4(k, A+ii+0, lda, pU, sdu);
+		if(A==NULL)
+			pU = pU0+ii*sdu;
+		else
+			kernel_dpack_nn_8_lib4(k, A+ii+0, lda, pU, sdu);
 		for(jj=0; jj<n-3; jj+=4)
 			{
 			kernel_dgemm_nn_8x4_lib4ccc(k, &alpha, pU, sdu, B+jj*ldb, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd);
@@ -639,7 +670,10 @@ static void blasfeo_hp_dgemm_nn_m1(int m, int n, int k, double alpha, double *A,
 #elif defined(TARGET_X64_INTEL_SKYLAKE_X)
 	for(; ii<m-23; ii+=24)
 		{
-		kernel_dpack_nn_24_lib8(k, A+ii+0, lda, pU, sdu);
+		if(A==NULL)
+			pU = pU0+ii*sdu;
+		else
+			kernel_dpack_nn_24_lib8(k, A+ii+0, lda, pU, sdu);
 		for(jj=0; jj<n-7; jj+=8)
 			{
 			kernel_dgemm_nn_24x8_lib8ccc(k, &alpha, pU, sdu, B+jj*ldb, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd);
@@ -667,7 +701,10 @@ static void blasfeo_hp_dgemm_nn_m1(int m, int n, int k, double alpha, double *A,
 #elif 0 //defined(TARGET_X64_INTEL_SKYLAKE_X)
 	for(; ii<m-15; ii+=16)
 		{
-		kernel_dpack_nn_16_lib8(k, A+ii+0, lda, pU, sdu);
+		if(A==NULL)
+			pU = pU0+ii*sdu;
+		else
+			kernel_dpack_nn_16_lib8(k, A+ii+0, lda, pU, sdu);
 		for(jj=0; jj<n-7; jj+=8)
 			{
 			kernel_dgemm_nn_16x8_lib8ccc(k, &alpha, pU, sdu, B+jj*ldb, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd);
@@ -691,7 +728,10 @@ static void blasfeo_hp_dgemm_nn_m1(int m, int n, int k, double alpha, double *A,
 #elif 0 //defined(TARGET_X64_INTEL_SKYLAKE_X)
 	for(; ii<m-7; ii+=8)
 		{
-		kernel_dpack_nn_8_lib8(k, A+ii, lda, pU);
+		if(A==NULL)
+			pU = pU0+ii*sdu;
+		else
+			kernel_dpack_nn_8_lib8(k, A+ii, lda, pU);
 		for(jj=0; jj<n-7; jj+=8)
 			{
 			kernel_dgemm_nn_8x8_lib8ccc(k, &alpha, pU, B+jj*ldb, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd);
@@ -708,7 +748,10 @@ static void blasfeo_hp_dgemm_nn_m1(int m, int n, int k, double alpha, double *A,
 #else
 	for(; ii<m-3; ii+=4)
 		{
-		kernel_dpack_nn_4_lib4(k, A+ii, lda, pU);
+		if(A==NULL)
+			pU = pU0+ii*sdu;
+		else
+			kernel_dpack_nn_4_lib4(k, A+ii, lda, pU);
 		for(jj=0; jj<n-3; jj+=4)
 			{
 			kernel_dgemm_nn_4x4_lib4ccc(k, &alpha, pU, B+jj*ldb, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd);
@@ -727,7 +770,10 @@ static void blasfeo_hp_dgemm_nn_m1(int m, int n, int k, double alpha, double *A,
 
 #if defined(TARGET_X64_INTEL_SKYLAKE_X)
 nn_m1_left_24:
-	kernel_dpack_nn_24_vs_lib8(k, A+ii, lda, pU, sdu, m-ii);
+	if(A==NULL)
+		pU = pU0+ii*sdu;
+	else
+		kernel_dpack_nn_24_vs_lib8(k, A+ii, lda, pU, sdu, m-ii);
 	for(jj=0; jj<n; jj+=8)
 		{
 		kernel_dgemm_nn_24x8_vs_lib8ccc(k, &alpha, pU, sdu, B+jj*ldb, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd, m-ii, n-jj);
@@ -737,7 +783,10 @@ nn_m1_left_24:
 
 #if defined(TARGET_X64_INTEL_SKYLAKE_X)
 nn_m1_left_16:
-	kernel_dpack_nn_16_vs_lib8(k, A+ii, lda, pU, sdu, m-ii);
+	if(A==NULL)
+		pU = pU0+ii*sdu;
+	else
+		kernel_dpack_nn_16_vs_lib8(k, A+ii, lda, pU, sdu, m-ii);
 	for(jj=0; jj<n; jj+=8)
 		{
 		kernel_dgemm_nn_16x8_vs_lib8ccc(k, &alpha, pU, sdu, B+jj*ldb, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd, m-ii, n-jj);
@@ -747,7 +796,10 @@ nn_m1_left_16:
 
 #if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
 nn_m1_left_12:
-	kernel_dpack_nn_12_vs_lib4(k, A+ii, lda, pU, sdu, m-ii);
+	if(A==NULL)
+		pU = pU0+ii*sdu;
+	else
+		kernel_dpack_nn_12_vs_lib4(k, A+ii, lda, pU, sdu, m-ii);
 	for(jj=0; jj<n; jj+=4)
 		{
 		kernel_dgemm_nn_12x4_vs_lib4ccc(k, &alpha, pU, sdu, B+jj*ldb, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd, m-ii, n-jj);
@@ -757,7 +809,10 @@ nn_m1_left_12:
 
 #if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
 nn_m1_left_8:
-	kernel_dpack_nn_8_vs_lib4(k, A+ii, lda, pU, sdu, m-ii);
+	if(A==NULL)
+		pU = pU0+ii*sdu;
+	else
+		kernel_dpack_nn_8_vs_lib4(k, A+ii, lda, pU, sdu, m-ii);
 	for(jj=0; jj<n; jj+=4)
 		{
 		kernel_dgemm_nn_8x4_vs_lib4ccc(k, &alpha, pU, sdu, B+jj*ldb, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd, m-ii, n-jj);
@@ -766,7 +821,10 @@ nn_m1_left_8:
 #endif
 #if defined(TARGET_X64_INTEL_SKYLAKE_X)
 nn_m1_left_8:
-	kernel_dpack_nn_8_vs_lib8(k, A+ii, lda, pU, m-ii);
+	if(A==NULL)
+		pU = pU0+ii*sdu;
+	else
+		kernel_dpack_nn_8_vs_lib8(k, A+ii, lda, pU, m-ii);
 	for(jj=0; jj<n; jj+=8)
 		{
 		kernel_dgemm_nn_8x8_vs_lib8ccc(k, &alpha, pU, B+jj*ldb, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd, m-ii, n-jj);
@@ -775,7 +833,10 @@ nn_m1_left_8:
 #endif
 
 nn_m1_left_4:
-	kernel_dpack_nn_4_vs_lib4(k, A+ii, lda, pU, m-ii);
+	if(A==NULL)
+		pU = pU0+ii*sdu;
+	else
+		kernel_dpack_nn_4_vs_lib4(k, A+ii, lda, pU, m-ii);
 #if defined(TARGET_X64_INTEL_HASWELL)
 	for(jj=0; jj<n-8; jj+=12)
 		{
@@ -1072,16 +1133,21 @@ nn_n1_return:
 
 
 
-static void blasfeo_hp_dgemm_nt_m1(int m, int n, int k, double alpha, double *A, int lda, double *B, int ldb, double beta, double *C, int ldc, double *D, int ldd, double *pU, int sdu)
+// A==NULL: A pre-packed in pU0 by blasfeo_hp_dgemm_pack, with panel stride sdu
+static void blasfeo_hp_dgemm_nt_m1(int m, int n, int k, double alpha, double *A, int lda, double *B, int ldb, double beta, double *C, int ldc, double *D, int ldd, double *pU0, int sdu)
 	{
 
 	int ii, jj;
+	double *pU = pU0;
 
 	ii = 0;
 #if defined(TARGET_X64_INTEL_HASWELL)
 	for(; ii<m-11; ii+=12)
 		{
-		kernel_dpack_nn_12_lib4(k, A+ii+0, lda, pU, sdu);
+		if(A==NULL)
+			pU = pU0+ii*sdu;
+		else
+			kernel_dpack_nn_12_lib4(k, A+ii+0, lda, pU, sdu);
 		for(jj=0; jj<n-3; jj+=4)
 			{
 			kernel_dgemm_nt_12x4_lib4ccc(k, &alpha, pU, sdu, B+jj, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd);
@@ -1109,7 +1175,10 @@ static void blasfeo_hp_dgemm_nt_m1(int m, int n, int k, double alpha, double *A,
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
 	for(; ii<m-7; ii+=8)
 		{
-		kernel_dpack_nn_8_lib4(k, A+ii+0, lda, pU, sdu);
+		if(A==NULL)
+			pU = pU0+ii*sdu;
+		else
+			kernel_dpack_nn_8_lib4(k, A+ii+0, lda, pU, sdu);
 		for(jj=0; jj<n-3; jj+=4)
 			{
 			kernel_dgemm_nt_8x4_lib4ccc(k, &alpha, pU, sdu, B+jj, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd);
@@ -1133,7 +1202,10 @@ static void blasfeo_hp_dgemm_nt_m1(int m, int n, int k, double alpha, double *A,
 #elif defined(TARGET_X64_INTEL_SKYLAKE_X)
 	for(; ii<m-23; ii+=24)
 		{
-		kernel_dpack_nn_24_lib8(k, A+ii+0, lda, pU, sdu);
+		if(A==NULL)
+			pU = pU0+ii*sdu;
+		else
+			kernel_dpack_nn_24_lib8(k, A+ii+0, lda, pU, sdu);
 		for(jj=0; jj<n-7; jj+=8)
 			{
 			kernel_dgemm_nt_24x8_lib8ccc(k, &alpha, pU, sdu, B+jj, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd);
@@ -1161,7 +1233,10 @@ static void blasfeo_hp_dgemm_nt_m1(int m, int n, int k, double alpha, double *A,
 #elif 0 //defined(TARGET_X64_INTEL_SKYLAKE_X)
 	for(; ii<m-15; ii+=16)
 		{
-		kernel_dpack_nn_16_lib8(k, A+ii+0, lda, pU, sdu);
+		if(A==NULL)
+			pU = pU0+ii*sdu;
+		else
+			kernel_dpack_nn_16_lib8(k, A+ii+0, lda, pU, sdu);
 		for(jj=0; jj<n-7; jj+=8)
 			{
 			kernel_dgemm_nt_16x8_lib8ccc(k, &alpha, pU, sdu, B+jj, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd);
@@ -1185,7 +1260,10 @@ static void blasfeo_hp_dgemm_nt_m1(int m, int n, int k, double alpha, double *A,
 #elif 0 //defined(TARGET_X64_INTEL_SKYLAKE_X)
 	for(; ii<m-7; ii+=8)
 		{
-		kernel_dpack_nn_8_lib8(k, A+ii, lda, pU);
+		if(A==NULL)
+			pU = pU0+ii*sdu;
+		else
+			kernel_dpack_nn_8_lib8(k, A+ii, lda, pU);
 		for(jj=0; jj<n-7; jj+=8)
 			{
 			kernel_dgemm_nt_8x8_lib8ccc(k, &alpha, pU, B+jj, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd);
@@ -1202,7 +1280,10 @@ static void blasfeo_hp_dgemm_nt_m1(int m, int n, int k, double alpha, double *A,
 #else
 	for(; ii<m-3; ii+=4)
 		{
-		kernel_dpack_nn_4_lib4(k, A+ii, lda, pU);
+		if(A==NULL)
+			pU = pU0+ii*sdu;
+		else
+			kernel_dpack_nn_4_lib4(k, A+ii, lda, pU);
 		for(jj=0; jj<n-3; jj+=4)
 			{
 			kernel_dgemm_nt_4x4_lib4ccc(k, &alpha, pU, B+jj, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd);
@@ -1221,7 +1302,10 @@ static void blasfeo_hp_dgemm_nt_m1(int m, int n, int k, double alpha, double *A,
 
 #if defined(TARGET_X64_INTEL_SKYLAKE_X)
 nt_m1_left_24:
-	kernel_dpack_nn_24_vs_lib8(k, A+ii+0, lda, pU, sdu, m-ii);
+	if(A==NULL)
+		pU = pU0+ii*sdu;
+	else
+		kernel_dpack_nn_24_vs_lib8(k, A+ii+0, lda, pU, sdu, m-ii);
 	for(jj=0; jj<n; jj+=8)
 		{
 		kernel_dgemm_nt_24x8_vs_lib8ccc(k, &alpha, pU, sdu, B+jj, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd, m-ii, n-jj);
@@ -1231,7 +1315,10 @@ nt_m1_left_24:
 
 #if defined(TARGET_X64_INTEL_SKYLAKE_X)
 nt_m1_left_16:
-	kernel_dpack_nn_16_vs_lib8(k, A+ii+0, lda, pU, sdu, m-ii);
+	if(A==NULL)
+		pU = pU0+ii*sdu;
+	else
+		kernel_dpack_nn_16_vs_lib8(k, A+ii+0, lda, pU, sdu, m-ii);
 	for(jj=0; jj<n; jj+=8)
 		{
 		kernel_dgemm_nt_16x8_vs_lib8ccc(k, &alpha, pU, sdu, B+jj, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd, m-ii, n-jj);
@@ -1241,7 +1328,10 @@ nt_m1_left_16:
 
 #if defined(TARGET_X64_INTEL_HASWELL)
 nt_m1_left_12:
-	kernel_dpack_nn_12_vs_lib4(k, A+ii+0, lda, pU, sdu, m-ii);
+	if(A==NULL)
+		pU = pU0+ii*sdu;
+	else
+		kernel_dpack_nn_12_vs_lib4(k, A+ii+0, lda, pU, sdu, m-ii);
 	for(jj=0; jj<n; jj+=4)
 		{
 		kernel_dgemm_nt_12x4_vs_lib4ccc(k, &alpha, pU, sdu, B+jj, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd, m-ii, n-jj);
@@ -1251,7 +1341,10 @@ nt_m1_left_12:
 
 #if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
 nt_m1_left_8:
-	kernel_dpack_nn_8_vs_lib4(k, A+ii+0, lda, pU, sdu, m-ii);
+	if(A==NULL)
+		pU = pU0+ii*sdu;
+	else
+		kernel_dpack_nn_8_vs_lib4(k, A+ii+0, lda, pU, sdu, m-ii);
 	for(jj=0; jj<n; jj+=4)
 		{
 		kernel_dgemm_nt_8x4_vs_lib4ccc(k, &alpha, pU, sdu, B+jj, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd, m-ii, n-jj);
@@ -1260,7 +1353,10 @@ nt_m1_left_8:
 #endif
 #if defined(TARGET_X64_INTEL_SKYLAKE_X)
 nt_m1_left_8:
-	kernel_dpack_nn_8_vs_lib8(k, A+ii, lda, pU, m-ii);
+	if(A==NULL)
+		pU = pU0+ii*sdu;
+	else
+		kernel_dpack_nn_8_vs_lib8(k, A+ii, lda, pU, m-ii);
 	for(jj=0; jj<n; jj+=8)
 		{
 		kernel_dgemm_nt_8x8_vs_lib8ccc(k, &alpha, pU, B+jj, ldb, &beta, C+ii+jj*ldc, ldc, D+ii+jj*ldd, ldd, m-ii, n-jj);
@@ -1269,7 +1365,10 @@ nt_m1_left_8:
 #endif
 
 nt_m1_left_4:
-	kernel_dpack_nn_4_vs_lib4(k, A+ii, lda, pU, m-ii);
+	if(A==NULL)
+		pU = pU0+ii*sdu;
+	else
+		kernel_dpack_nn_4_vs_lib4(k, A+ii, lda, pU, m-ii);
 #if defined(TARGET_X64_INTEL_HASWELL)
 	for(jj=0; jj<n-8; jj+=12)
 		{
@@ -2552,82 +2651,299 @@ tt_n1_return:
 
 
 
-//#ifdef HP_BLAS
-//
-//static void blas_hp_dgemm_nn(int m, int n, int k, double alpha, double *A, int lda, double *B, int ldb, double beta, double *C, int ldc)
-//	{
-//
-//#if defined(PRINT_NAME)
-//	printf("\nblas_hp_dgemm_nn %d %d %d %f %p %d %p %d %f %p %d\n", m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
-//#endif
-//
-//	if(m<=0 | n<=0)
-//		return;
-//
-//	int ldd = ldc;
-//	double *D = C;
-//
-//#else
+#if defined(MULTI_THREAD)
 
-void blasfeo_hp_dgemm_nn(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+// arguments of the multi-threaded pack-A-and-B algorithm
+struct blasfeo_hp_dgemm_2_mt_arg
 	{
+	int ta; // A transposed
+	int tb; // B transposed
+	int m;
+	int n;
+	int k;
+	double alpha;
+	double beta;
+	double *A;
+	int lda;
+	double *B;
+	int ldb;
+	double *C;
+	int ldc;
+	double *D;
+	int ldd;
+	char *mem_align;
+	int tA_size;
+	int tB_size;
+	struct blasfeo_block_size *bs; // block sizes of the call
+	struct blasfeo_barrier *bar;
+	};
 
-#if defined(PRINT_NAME)
-	printf("\nblasfeo_hp_dgemm_nn (cm) %d %d %d %f %p %d %d %p %d %d %f %p %d %d %p %d %d\n", m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
-#endif
 
-	if(m<=0 | n<=0)
-		return;
 
-	// extract pointer to column-major matrices from structures
-	int lda = sA->m;
-	int ldb = sB->m;
-	int ldc = sC->m;
-	int ldd = sD->m;
-	double *A = sA->pA + ai + aj*lda;
-	double *B = sB->pA + bi + bj*ldb;
-	double *C = sC->pA + ci + cj*ldc;
-	double *D = sD->pA + di + dj*ldd;
+// the packed B panel is shared: all threads pack a slice of it, and then, once the barrier is passed, use it
+// for all the blocks of rows, each thread packing its own rows of A;
+// the B panel is double-buffered, so that one barrier per panel is enough
+static void blasfeo_hp_dgemm_2_mt_work(int tid, int nth, void *ptr)
+	{
 
-//#endif
+	struct blasfeo_hp_dgemm_2_mt_arg *arg = ptr;
+
+	int ta = arg->ta;
+	int tb = arg->tb;
+	int m = arg->m;
+	int n = arg->n;
+	int k = arg->k;
+	double alpha = arg->alpha;
+	double beta = arg->beta;
+	double *A = arg->A;
+	int lda = arg->lda;
+	double *B = arg->B;
+	int ldb = arg->ldb;
+	double *C = arg->C;
+	int ldc = arg->ldc;
+	double *D = arg->D;
+	int ldd = arg->ldd;
 
-//	printf("\n%p %d %p %d %p %d %p %d\n", A, lda, B, ldb, C, ldc, D, ldd);
+	const int ps = PS;
+	const int m_kernel = M_KERNEL;
 
-	int ii, jj, ll, kk;
-	int iii;
-	int idx;
-	int mc, nc, kc, oc;
-	int mleft, nleft, kleft, oleft;
-	int mc0, nc0, kc0, oc0;
+	int ii, jj, ll, iii;
+	int ib, mb, m0, m1, j0, j1;
+	int mleft, nleft, kleft;
+	int sda, sdb;
 	int ldc1;
+	int buf;
 	double beta1;
-	double *pA, *pB, *C1;
+	double *pA, *pB, *pB0, *C1;
 
-	const int ps = PS;
+	int mc0 = arg->bs->d_mc;
+	int nc0 = arg->bs->d_nc;
+	int kc0 = arg->bs->d_kc;
 
-#if defined(TARGET_GENERIC)
-	double pU_stack[M_KERNEL*K_MAX_STACK];
+	int kc = k<kc0 ? k : kc0;
+
+	// private A buffer
+	pA = (double *) (arg->mem_align + 2*arg->tB_size + tid*arg->tA_size);
+
+	// rows computed by each thread in a block of nth*mc rows
+	int mc = (m+nth-1)/nth;
+	mc = (mc+m_kernel-1)/m_kernel*m_kernel;
+	mc = mc<mc0 ? mc : mc0;
+
+	buf = 0;
+
+	for(jj=0; jj<n; jj+=nleft)
+		{
+
+		nleft = n-jj<nc0 ? n-jj : nc0;
+
+		for(ll=0; ll<k; ll+=kleft)
+			{
+
+			if(k-ll<2*kc0)
+				{
+				if(k-ll<=kc0) // last
+					{
+					kleft = k-ll;
+					}
+				else // second last
+					{
+					kleft = (k-ll+1)/2;
+					kleft = (kleft+4-1)/4*4;
+					}
+				}
+			else
+				{
+				kleft = kc;
+				}
+
+			sda = (kleft+4-1)/4*4;
+			sdb = (kleft+4-1)/4*4;
+
+			beta1 = ll==0 ? beta : 1.0;
+			C1 = ll==0 ? C : D;
+			ldc1 = ll==0 ? ldc : ldd;
+
+			pB = (double *) (arg->mem_align + buf*arg->tB_size);
+			buf = 1-buf;
+
+			// columns of B packed by this thread, in multiples of the panel size
+			j0 = (nleft+nth*ps-1)/(nth*ps)*ps;
+			j1 = (tid+1)*j0;
+			j0 = tid*j0;
+			j1 = j1<nleft ? j1 : nleft;
+
+			// pack B
+			if(j1>j0)
+				{
+				pB0 = pB+j0*sdb;
+				if(tb==0)
+					{
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+					for(iii=0; iii<j1-j0-7; iii+=8)
+						{
+						kernel_dpack_tn_8_lib8(kleft, B+ll+(jj+j0+iii)*ldb, ldb, pB0+iii*sdb);
+						}
+					if(iii<j1-j0)
+						{
+						kernel_dpack_tn_8_vs_lib8(kleft, B+ll+(jj+j0+iii)*ldb, ldb, pB0+iii*sdb, j1-j0-iii);
+						}
 #else
-	ALIGNED( double pU_stack[M_KERNEL*K_MAX_STACK], 64 );
-//	ALIGNED( double pU_stack[M_KERNEL*K_MAX_STACK], 4096 );
+					kernel_dpack_buffer_ft(kleft, j1-j0, B+ll+(jj+j0)*ldb, ldb, pB0, sdb);
 #endif
-	int sdu_stack = K_MAX_STACK;
-	int k4 = (k+3)/4*4;
+					}
+				else
+					{
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+					for(iii=0; iii<kleft-3; iii+=4)
+						{
+						kernel_dpack_tt_4_lib8(j1-j0, B+jj+j0+(ll+iii)*ldb, ldb, pB0+iii*ps, sdb);
+						}
+					if(iii<kleft)
+						{
+						kernel_dpack_tt_4_vs_lib8(j1-j0, B+jj+j0+(ll+iii)*ldb, ldb, pB0+iii*ps, sdb, kleft-iii);
+						}
+#else
+					kernel_dpack_buffer_fn(j1-j0, kleft, B+jj+j0+ll*ldb, ldb, pB0, sdb);
+#endif
+					}
+				}
 
-	double *pU;
-	int sdu;
-	int pU_size;
+			// wait for the whole B panel to be packed
+			blasfeo_barrier_wait(arg->bar);
 
-	struct blasfeo_pm_dmat tA, tB;
-	int sda, sdb;
-	int tA_size, tB_size;
+			// the packed B panel is used by all the blocks of rows
+			for(ib=0; ib<m; ib+=mb)
+				{
+
+				mb = m-ib<nth*mc ? m-ib : nth*mc;
+
+				// rows of this thread
+				m0 = ib + tid*mc;
+				m1 = m0+mc<ib+mb ? m0+mc : ib+mb;
+				mleft = m1-m0;
+
+				if(mleft<=0)
+					continue;
+
+				// pack A
+				ii = m0;
+				if(ta==0)
+					{
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+					for(iii=0; iii<kleft-3; iii+=4)
+						{
+						kernel_dpack_tt_4_lib8(mleft, A+ii+(ll+iii)*lda, lda, pA+iii*ps, sda);
+						}
+					if(iii<kleft)
+						{
+						kernel_dpack_tt_4_vs_lib8(mleft, A+ii+(ll+iii)*lda, lda, pA+iii*ps, sda, kleft-iii);
+						}
+#else
+					kernel_dpack_buffer_fn(mleft, kleft, A+ii+ll*lda, lda, pA, sda);
+#endif
+					}
+				else
+					{
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+					for(iii=0; iii<mleft-7; iii+=8)
+						{
+						kernel_dpack_tn_8_lib8(kleft, A+ll+(ii+iii)*lda, lda, pA+iii*sda);
+						}
+					if(iii<mleft)
+						{
+						kernel_dpack_tn_8_vs_lib8(kleft, A+ll+(ii+iii)*lda, lda, pA+iii*sda, mleft-iii);
+						}
+#else
+					kernel_dpack_buffer_ft(kleft, mleft, A+ll+ii*lda, lda, pA, sda);
+#endif
+					}
+
+				blasfeo_hp_dgemm_nt_m2(mleft, nleft, kleft, alpha, pA, sda, pB, sdb, beta1, C1+ii+jj*ldc1, ldc1, D+ii+jj*ldd, ldd);
+
+				}
+
+			}
+
+		}
+
+	return;
+
+	}
+
+
+
+// multi-threaded pack-A-and-B algorithm, ta and tb select the transposition of A and B
+static void blasfeo_hp_dgemm_2_mt(int ta, int tb, int nth, int m, int n, int k, double alpha, double *A, int lda, double *B, int ldb, double beta, double *C, int ldc, double *D, int ldd, struct blasfeo_block_size *bs)
+	{
+
+	const int ps = PS;
+
+	struct blasfeo_hp_dgemm_2_mt_arg arg;
+	struct blasfeo_barrier bar;
 	void *mem;
 	char *mem_align;
-	int m1, n1, k1;
-	int pack_B;
 
-	int error;
-	int mem_size;
+	int tA_size = blasfeo_pm_memsize_dmat(ps, bs->d_mc, bs->d_kc);
+	int tB_size = blasfeo_pm_memsize_dmat(ps, bs->d_nc, bs->d_kc);
+	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
+	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
+
+	// two shared B buffers and one A buffer per thread
+	blasfeo_work_malloc(&mem, 2*tB_size+nth*tA_size+4096);
+	blasfeo_align_4096_byte(mem, (void **) &mem_align);
+
+	blasfeo_barrier_init(&bar, nth);
+
+	arg.ta = ta;
+	arg.tb = tb;
+	arg.m = m;
+	arg.n = n;
+	arg.k = k;
+	arg.alpha = alpha;
+	arg.beta = beta;
+	arg.A = A;
+	arg.lda = lda;
+	arg.B = B;
+	arg.ldb = ldb;
+	arg.C = C;
+	arg.ldc = ldc;
+	arg.D = D;
+	arg.ldd = ldd;
+	arg.mem_align = mem_align;
+	arg.tA_size = tA_size;
+	arg.tB_size = tB_size;
+	arg.bs = bs;
+	arg.bar = &bar;
+
+	blasfeo_parallel_run(nth, &blasfeo_hp_dgemm_2_mt_work, &arg);
+
+	blasfeo_barrier_destroy(&bar);
+	blasfeo_work_free(mem);
+
+	return;
+
+	}
+
+
+
+// number of threads used by the pack-A-and-B algorithm: at least one kernel row block per thread
+static int blasfeo_hp_dgemm_2_mt_nth(int m, int n, int k)
+	{
+	int nth = blasfeo_get_num_threads_flops(2.0*m*n*k);
+	int nth_max = (m+M_KERNEL-1)/M_KERNEL;
+	return nth<nth_max ? nth : nth_max;
+	}
+
+#endif // MULTI_THREAD
+
+
+
+
+// packing algorithm of dgemm_nn, forced at build time, from the tuned decision table or from the built-in heuristic;
+// the leading dimensions only enter the cache footprint estimates, a negative one standing for a padded matrix
+static int blasfeo_hp_dgemm_nn_alg(int m, int n, int k, int lda, int ldb, int ldc, int ldd, struct blasfeo_block_size *bs)
+	{
 
 	const int m_kernel = M_KERNEL;
 	const int l1_cache_el = L1_CACHE_EL;
@@ -2640,65 +2956,81 @@ void blasfeo_hp_dgemm_nn(int m, int n, int k, double alpha, struct blasfeo_dmat
 	const int reals_per_cache_line = CACHE_LINE_EL;
 
 	const int m_cache = (m+reals_per_cache_line-1)/reals_per_cache_line*reals_per_cache_line;
-	const int n_cache = (n+reals_per_cache_line-1)/reals_per_cache_line*reals_per_cache_line;
 	const int k_cache = (k+reals_per_cache_line-1)/reals_per_cache_line*reals_per_cache_line;
 	const int m_kernel_cache = (m_kernel+reals_per_cache_line-1)/reals_per_cache_line*reals_per_cache_line;
-	int m_min = m_cache<m_kernel_cache ? m_cache : m_kernel_cache;
-//	int n_min = n_cache<m_kernel_cache ? n_cache : m_kernel_cache;
 
 	int m_a = m==lda ? m : m_cache;
 	int m_a_kernel = m<=m_kernel ? m_a : m_kernel_cache;
 	int k_b = k==ldb ? k : k_cache;
 	int m_c = m==ldc ? m : m_cache;
 	int m_d = m==ldd ? m : m_cache;
-	int k_block = K_MAX_STACK<KC ? K_MAX_STACK : KC;
+	int k_block = K_MAX_STACK<bs->d_kc ? K_MAX_STACK : bs->d_kc;
 	k_block = k<=k_block ? k : k_block; // m1 and n1 alg are blocked !!!
 
 #if defined(PACKING_ALG_0)
 #if defined(TARGET_X64_INTEL_SKYLAKE_X) | defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	goto nn_m1; // pack A
+	return BLASFEO_DGEMM_ALG_M1; // pack A
 #else
-	goto nn_0; // no pack
+	return BLASFEO_DGEMM_ALG_0; // no pack
 #endif
 #endif
 #if defined(PACKING_ALG_M1)
-	goto nn_m1; // pack A
+	return BLASFEO_DGEMM_ALG_M1; // pack A
 #endif
 #if defined(PACKING_ALG_N1)
-	goto nn_n1; // pack B
+	return BLASFEO_DGEMM_ALG_N1; // pack B
 #endif
 #if defined(PACKING_ALG_2)
-	goto nn_2; // pack A and B
+	return BLASFEO_DGEMM_ALG_2; // pack A and B
+#endif
+
+	// tuned decision table
+	switch(blasfeo_dgemm_tune_alg(BLASFEO_DGEMM_NN, m, n, k))
+		{
+		case BLASFEO_DGEMM_ALG_0:
+#if defined(TARGET_X64_INTEL_SKYLAKE_X) | defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+			return BLASFEO_DGEMM_ALG_M1; // pack A
+#else
+			return BLASFEO_DGEMM_ALG_0; // no pack
 #endif
+		case BLASFEO_DGEMM_ALG_M1:
+			return BLASFEO_DGEMM_ALG_M1; // pack A
+		case BLASFEO_DGEMM_ALG_N1:
+			return BLASFEO_DGEMM_ALG_N1; // pack B
+		case BLASFEO_DGEMM_ALG_2:
+			return BLASFEO_DGEMM_ALG_2; // pack A and B
+		default:
+			break; // built-in heuristic
+		}
 
 #if defined(TARGET_X64_INTEL_SKYLAKE_X)
 	if( (m<=m_kernel & n<=m_kernel) | (m_a_kernel*k + k_b*n <= l1_cache_el) )
 		{
 //		printf("\nalg 2\n");
-//		goto nn_0; // small matrix: no pack TODO
-		goto nn_m1; // small matrix: pack A
+//		return BLASFEO_DGEMM_ALG_0; // small matrix: no pack TODO
+		return BLASFEO_DGEMM_ALG_M1; // small matrix: pack A
 		}
 #elif defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A57)
 	if( (m<=m_kernel & n<=m_kernel) | (m_a_kernel*k + k_b*n <= l1_cache_el) )
 		{
 //		printf("\nalg 2\n");
-		goto nn_0; // small matrix: no pack
+		return BLASFEO_DGEMM_ALG_0; // small matrix: no pack
 		}
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
 	if( m<=48 & n<=48 & k<=K_MAX_STACK )
 		{
-		goto nn_m1; // small matrix: pack A
+		return BLASFEO_DGEMM_ALG_M1; // small matrix: pack A
 		}
 #elif defined(TARGET_ARMV8A_ARM_CORTEX_A53)
 	if( (m<=m_kernel & n<=m_kernel & k<160) )
 		{
 //		printf("\nalg 2\n");
-		goto nn_0; // small matrix: no pack
+		return BLASFEO_DGEMM_ALG_0; // small matrix: no pack
 		}
 #else
 	if( m<=8 & n<=8 )
 		{
-		goto nn_0; // small matrix: no pack
+		return BLASFEO_DGEMM_ALG_0; // small matrix: no pack
 		}
 #endif
 #if defined(TARGET_X64_INTEL_SKYLAKE_X) | defined(TARGET_X64_INTEL_HASWELL)
@@ -2709,11 +3041,11 @@ void blasfeo_hp_dgemm_nn(int m, int n, int k, double alpha, struct blasfeo_dmat
 		if( n<=2*m_kernel | k_block*n <= l2_cache_el )
 #else
 //		if( m<=2*m_kernel | m_a*k + k_b*n <= llc_cache_el )
-		if( m<=2*m_kernel | ( k<=KC & (m_a*k + k_b*n + m_c*n + m_d*n <= llc_cache_el) ) )
+		if( m<=2*m_kernel | ( k<=bs->d_kc & (m_a*k + k_b*n + m_c*n + m_d*n <= llc_cache_el) ) )
 #endif
 			{
 //			printf("\nalg m0\n");
-			goto nn_m1; // long matrix: pack A
+			return BLASFEO_DGEMM_ALG_M1; // long matrix: pack A
 			}
 		}
 	else
@@ -2721,7 +3053,7 @@ void blasfeo_hp_dgemm_nn(int m, int n, int k, double alpha, struct blasfeo_dmat
 		if( n<=2*m_kernel | m_a*k_block <= l2_cache_el )
 			{
 //			printf("\nalg n0\n");
-			goto nn_n1; // tall matrix: pack B
+			return BLASFEO_DGEMM_ALG_N1; // tall matrix: pack B
 			}
 		}
 #else
@@ -2740,17 +3072,69 @@ void blasfeo_hp_dgemm_nn(int m, int n, int k, double alpha, struct blasfeo_dmat
 		if( m<=n*4 )
 			{
 //			printf("\nalg m0\n");
-			goto nn_m1; // long matrix: pack A
+			return BLASFEO_DGEMM_ALG_M1; // long matrix: pack A
 			}
 		else
 			{
 //			printf("\nalg n0\n");
-			goto nn_n1; // tall matrix: pack B
+			return BLASFEO_DGEMM_ALG_N1; // tall matrix: pack B
 			}
 		}
 #endif
 //	printf("\nalg 1\n");
-	goto nn_2; // big matrix: pack A and B
+	return BLASFEO_DGEMM_ALG_2; // big matrix: pack A and B
+
+	}
+
+
+
+// dgemm_nn with the packing algorithm alg and nth threads for the pack A and B alg
+static void blasfeo_hp_dgemm_nn_run(int alg, int nth, int m, int n, int k, double alpha, double *A, int lda, double *B, int ldb, double beta, double *C, int ldc, double *D, int ldd, struct blasfeo_block_size *bs)
+	{
+
+//	printf("\n%p %d %p %d %p %d %p %d\n", A, lda, B, ldb, C, ldc, D, ldd);
+
+	int ii, jj, ll;
+	int iii;
+	int mc, nc, kc;
+	int mleft, nleft, kleft;
+	int mc0, nc0, kc0;
+	int ldc1;
+	double beta1;
+	double *pA, *pB, *C1;
+
+	const int ps = PS;
+
+#if defined(TARGET_GENERIC)
+	double pU_stack[M_KERNEL*K_MAX_STACK];
+#else
+	ALIGNED( double pU_stack[M_KERNEL*K_MAX_STACK], 64 );
+//	ALIGNED( double pU_stack[M_KERNEL*K_MAX_STACK], 4096 );
+#endif
+	int sdu_stack = K_MAX_STACK;
+	int k4 = (k+3)/4*4;
+
+	double *pU;
+	int sdu;
+	int pU_size;
+
+	struct blasfeo_pm_dmat tA, tB;
+	int sda, sdb;
+	int tA_size, tB_size;
+	void *mem;
+	char *mem_align;
+
+	switch(alg)
+		{
+		case BLASFEO_DGEMM_ALG_M1:
+			goto nn_m1; // pack A
+		case BLASFEO_DGEMM_ALG_N1:
+			goto nn_n1; // pack B
+		case BLASFEO_DGEMM_ALG_0:
+			goto nn_0; // no pack
+		default:
+			goto nn_2; // pack A and B
+		}
 
 	// never to get here
 	return;
@@ -2763,13 +3147,13 @@ nn_m1:
 
 	// k-blocking alg
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs->d_kc>K_MAX_STACK)
 		{
-		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		pU_size = M_KERNEL*bs->d_kc*sizeof(double);
+		blasfeo_work_malloc(&mem, pU_size+64);
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
-		sdu = KC;
+		sdu = bs->d_kc;
 		}
 	else
 		{
@@ -2781,7 +3165,7 @@ nn_m1:
 
 //	kc = K_MAX_STACK<KC ? K_MAX_STACK : KC;
 //	kc = 4;
-	kc = KC;
+	kc = bs->d_kc;
 
 	if(k<kc)
 		{
@@ -2823,9 +3207,9 @@ nn_m1:
 
 		}
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs->d_kc>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -2839,13 +3223,13 @@ nn_n1:
 
 	// k-blocking alg
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs->d_kc>K_MAX_STACK)
 		{
-		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		pU_size = M_KERNEL*bs->d_kc*sizeof(double);
+		blasfeo_work_malloc(&mem, pU_size+64);
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
-		sdu = KC;
+		sdu = bs->d_kc;
 		}
 	else
 		{
@@ -2857,7 +3241,7 @@ nn_n1:
 
 //	kc = K_MAX_STACK<KC ? K_MAX_STACK : KC;
 //	kc = 4;
-	kc = KC;
+	kc = bs->d_kc;
 
 	if(k<kc)
 		{
@@ -2879,9 +3263,9 @@ nn_n1:
 			}
 		}
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs->d_kc>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -2890,13 +3274,21 @@ nn_n1:
 
 nn_2:
 
+#if defined(MULTI_THREAD)
+	if(nth>1)
+		{
+		blasfeo_hp_dgemm_2_mt(0, 0, nth, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, D, ldd, bs);
+		return;
+		}
+#endif
+
 #if defined(TARGET_X64_INTEL_SKYLAKE_X) | defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
 
 	// cache blocking alg
 
-	mc0 = MC;
-	nc0 = NC;
-	kc0 = KC;
+	mc0 = bs->d_mc;
+	nc0 = bs->d_nc;
+	kc0 = bs->d_kc;
 
 //	mc0 = 12;
 //	nc0 = 8;
@@ -2913,9 +3305,9 @@ nn_2:
 	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
 #if 1
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(bs)==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+2*4096);
 		}
 	else
 		{
@@ -2932,7 +3324,7 @@ nn_2:
 //	error = posix_memalign( &mem, 4*1024, tA_size+tB_size+2*4096 );
 //	error = posix_memalign( &mem, 2*1024*1024, mem_size );
 //	error = madvise( mem, tA_size+tB_size+2*4096, MADV_HUGEPAGE );
-	mem = malloc(mem_size);
+	blasfeo_work_malloc(&mem, mem_size);
 	blasfeo_align_2MB(mem, (void **) &mem_align);
 //	blasfeo_align_4096_byte(mem, (void **) &mem_align);
 	error = madvise( mem_align, tA_size+tB_size+4096+2*1024*1024, MADV_HUGEPAGE );
@@ -3081,9 +3473,9 @@ if (thp_count.pages_available) {
 		}
 
 //	printf("\ntime: pack_A %e, pack_B %e, kernel %e, kernel2 %e, kernel3 %e\n", time_pack_A, time_pack_B, time_kernel, time_kernel2, time_kernel3); 
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(bs)==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 //	blas_memory_free(mem);
 //	blas_memory_free_nolock(mem);
@@ -3098,9 +3490,9 @@ if (thp_count.pages_available) {
 
 	// cache blocking alg
 
-	mc0 = NC; //MC;
-	nc0 = MC; //NC;
-	kc0 = KC;
+	mc0 = bs->d_nc; //MC;
+	nc0 = bs->d_mc; //NC;
+	kc0 = bs->d_kc;
 
 #if 0
 	mc0 = 8;//12;
@@ -3116,9 +3508,9 @@ if (thp_count.pages_available) {
 	tB_size = blasfeo_pm_memsize_dmat(ps, nc0, kc0);
 	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(bs)==0)
 		{
-		mem = malloc(tA_size+tB_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+2*4096);
 		}
 	else
 		{
@@ -3212,7 +3604,10 @@ if (thp_count.pages_available) {
 		}
 
 //	printf("\ntime: pack_A %e, pack_B %e, kernel %e, kernel2 %e, kernel3 %e\n", time_pack_A, time_pack_B, time_kernel, time_kernel2, time_kernel3); 
-	free(mem);
+	if(blasfeo_is_init_block_size(bs)==0)
+		{
+		blasfeo_work_free(mem);
+		}
 
 	return;
 
@@ -3243,7 +3638,7 @@ if (thp_count.pages_available) {
 	tB_size = blasfeo_pm_memsize_dmat(ps, nc0, kc0);
 	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
-	mem = malloc(tA_size+tB_size+2*4096);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+2*4096);
 	blasfeo_align_4096_byte(mem, (void **) &mem_align);
 
 	blasfeo_pm_create_dmat(ps, mc0, oc0, &tA, (void *) mem_align);
@@ -3328,7 +3723,7 @@ if (thp_count.pages_available) {
 		}
 
 //	printf("\ntime: pack_A %e, pack_B %e, kernel %e, kernel2 %e, kernel3 %e\n", time_pack_A, time_pack_B, time_kernel, time_kernel2, time_kernel3); 
-	free(mem);
+	blasfeo_work_free(mem);
 
 	return;
 
@@ -3344,7 +3739,7 @@ if (thp_count.pages_available) {
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, k1);
 //	mem = malloc(tA_size+tB_size+64);
 //	blasfeo_align_64_byte(mem, (void **) &mem_align);
-	mem = malloc(tA_size+tB_size+4096);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+4096);
 	blasfeo_align_4096_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, k, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, k, &tB, (void *) (mem_align+tA_size));
@@ -3478,7 +3873,7 @@ nn_2_left_4:
 	goto nn_2_return;
 
 nn_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 #endif
@@ -3619,11 +4014,11 @@ nn_0_return:
 
 //#ifdef HP_BLAS
 //
-//static void blas_hp_dgemm_nt(int m, int n, int k, double alpha, double *A, int lda, double *B, int ldb, double beta, double *C, int ldc)
+//static void blas_hp_dgemm_nn(int m, int n, int k, double alpha, double *A, int lda, double *B, int ldb, double beta, double *C, int ldc)
 //	{
 //
 //#if defined(PRINT_NAME)
-//	printf("\nblas_hp_dgemm_nt %d %d %d %f %p %d %p %d %f %p %d\n", m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+//	printf("\nblas_hp_dgemm_nn %d %d %d %f %p %d %p %d %f %p %d\n", m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
 //#endif
 //
 //	if(m<=0 | n<=0)
@@ -3634,11 +4029,11 @@ nn_0_return:
 //
 //#else
 
-void blasfeo_hp_dgemm_nt(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+void blasfeo_hp_dgemm_nn(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
 #if defined(PRINT_NAME)
-	printf("\nblasfeo_hp_dgemm_nt (cm) %d %d %d %f %p %d %d %p %d %d %f %p %d %d %p %d %d\n", m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	printf("\nblasfeo_hp_dgemm_nn (cm) %d %d %d %f %p %d %d %p %d %d %f %p %d %d %p %d %d\n", m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
 #endif
 
 	if(m<=0 | n<=0)
@@ -3654,38 +4049,30 @@ void blasfeo_hp_dgemm_nt(int m, int n, int k, double alpha, struct blasfeo_dmat
 	double *C = sC->pA + ci + cj*ldc;
 	double *D = sD->pA + di + dj*ldd;
 
-//#endif
-
-	int ii, jj, ll;
-	int iii;
-	int mc, nc, kc;
-	int mleft, nleft, kleft;
-	int mc0, nc0, kc0;
-	int ldc1;
-	double beta1;
-	double *pA, *pB, *C1;
+	// the block sizes are read once, the whole call uses the same ones
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
 
-#if defined(TARGET_GENERIC)
-	double pU_stack[M_KERNEL*K_MAX_STACK];
-#else
-	ALIGNED( double pU_stack[M_KERNEL*K_MAX_STACK], 64 );
+	int alg = blasfeo_hp_dgemm_nn_alg(m, n, k, lda, ldb, ldc, ldd, &bs);
+	int nth = 1;
+#if defined(MULTI_THREAD)
+	if(alg==BLASFEO_DGEMM_ALG_2)
+		nth = blasfeo_hp_dgemm_2_mt_nth(m, n, k);
 #endif
-	int sdu_stack = K_MAX_STACK;
-	int k4 = (k+3)/4*4;
 
-	double *pU;
-	int sdu;
-	int pU_size;
+	blasfeo_hp_dgemm_nn_run(alg, nth, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, D, ldd, &bs);
 
-	struct blasfeo_pm_dmat tA, tB;
-	int sda, sdb;
-	int tA_size, tB_size;
-	void *mem;
-	char *mem_align;
-	int m1, n1, k1;
-	int pack_B;
+	return;
+
+	}
+
+
+
+// packing algorithm of dgemm_nt, forced at build time, from the tuned decision table or from the built-in heuristic;
+// the leading dimensions only enter the cache footprint estimates, a negative one standing for a padded matrix
+static int blasfeo_hp_dgemm_nt_alg(int m, int n, int k, int lda, int ldb, int ldc, int ldd, struct blasfeo_block_size *bs)
+	{
 
-	const int ps = PS;
 	const int m_kernel = M_KERNEL;
 	const int l1_cache_el = L1_CACHE_EL;
 #if defined(TARGET_X64_INTEL_SKYLAKE_X) | defined(TARGET_X64_INTEL_HASWELL)
@@ -3698,62 +4085,78 @@ void blasfeo_hp_dgemm_nt(int m, int n, int k, double alpha, struct blasfeo_dmat
 
 	const int m_cache = (m+reals_per_cache_line-1)/reals_per_cache_line*reals_per_cache_line;
 	const int n_cache = (n+reals_per_cache_line-1)/reals_per_cache_line*reals_per_cache_line;
-	const int k_cache = (k+reals_per_cache_line-1)/reals_per_cache_line*reals_per_cache_line;
 	const int m_kernel_cache = (m_kernel+reals_per_cache_line-1)/reals_per_cache_line*reals_per_cache_line;
-	int m_min = m_cache<m_kernel_cache ? m_cache : m_kernel_cache;
-//	int n_min = n_cache<m_kernel_cache ? n_cache : m_kernel_cache;
 
 	int m_a = m==lda ? m : m_cache;
 	int m_a_kernel = m<=m_kernel ? m_a : m_kernel_cache;
 	int n_b = n==ldb ? n : n_cache;
-	int k_block = K_MAX_STACK<KC ? K_MAX_STACK : KC;
+	int k_block = K_MAX_STACK<bs->d_kc ? K_MAX_STACK : bs->d_kc;
 	k_block = k<=k_block ? k : k_block; // m1 and n1 alg are blocked !!!
 
 #if defined(PACKING_ALG_0)
 #if defined(TARGET_X64_INTEL_SKYLAKE_X) | defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	goto nt_m1; // pack A
+	return BLASFEO_DGEMM_ALG_M1; // pack A
 #else
-	goto nt_0; // no pack
+	return BLASFEO_DGEMM_ALG_0; // no pack
 #endif
 #endif
 #if defined(PACKING_ALG_M1)
-	goto nt_m1; // pack A
+	return BLASFEO_DGEMM_ALG_M1; // pack A
 #endif
 #if defined(PACKING_ALG_N1)
-	goto nt_n1; // pack B
+	return BLASFEO_DGEMM_ALG_N1; // pack B
 #endif
 #if defined(PACKING_ALG_2)
-	goto nt_2; // pack A and B
+	return BLASFEO_DGEMM_ALG_2; // pack A and B
+#endif
+
+	// tuned decision table
+	switch(blasfeo_dgemm_tune_alg(BLASFEO_DGEMM_NT, m, n, k))
+		{
+		case BLASFEO_DGEMM_ALG_0:
+#if defined(TARGET_X64_INTEL_SKYLAKE_X) | defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+			return BLASFEO_DGEMM_ALG_M1; // pack A
+#else
+			return BLASFEO_DGEMM_ALG_0; // no pack
 #endif
+		case BLASFEO_DGEMM_ALG_M1:
+			return BLASFEO_DGEMM_ALG_M1; // pack A
+		case BLASFEO_DGEMM_ALG_N1:
+			return BLASFEO_DGEMM_ALG_N1; // pack B
+		case BLASFEO_DGEMM_ALG_2:
+			return BLASFEO_DGEMM_ALG_2; // pack A and B
+		default:
+			break; // built-in heuristic
+		}
 
 #if defined(TARGET_X64_INTEL_SKYLAKE_X)
 	if( (m<=m_kernel & n<=m_kernel) | (m_a_kernel*k + n_b*k <= l1_cache_el) )
 		{
 //		printf("\nalg 2\n");
-//		goto nt_0; // small matrix: no pack TODO
-		goto nt_m1; // small matrix: pack A
+//		return BLASFEO_DGEMM_ALG_0; // small matrix: no pack TODO
+		return BLASFEO_DGEMM_ALG_M1; // small matrix: pack A
 		}
 #elif defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A57) 
 	if( (m<=m_kernel & n<=m_kernel) | (m_a_kernel*k + n_b*k <= l1_cache_el) )
 		{
 //		printf("\nalg 2\n");
-		goto nt_0; // small matrix: no pack
+		return BLASFEO_DGEMM_ALG_0; // small matrix: no pack
 		}
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
 	if( m<=48 & n<=48 & k<=K_MAX_STACK )
 		{
-		goto nt_m1; // small matrix: pack A
+		return BLASFEO_DGEMM_ALG_M1; // small matrix: pack A
 		}
 #elif defined(TARGET_ARMV8A_ARM_CORTEX_A53)
 	if( (m<=m_kernel & n<=m_kernel & k<160) )
 		{
 //		printf("\nalg 2\n");
-		goto nt_0; // small matrix: no pack
+		return BLASFEO_DGEMM_ALG_0; // small matrix: no pack
 		}
 #else
 	if( m<=8 & n<=8 )
 		{
-		goto nt_0; // small matrix: no pack
+		return BLASFEO_DGEMM_ALG_0; // small matrix: no pack
 		}
 #endif
 #if defined(TARGET_X64_INTEL_SKYLAKE_X) | defined(TARGET_X64_INTEL_HASWELL)
@@ -3762,7 +4165,7 @@ void blasfeo_hp_dgemm_nt(int m, int n, int k, double alpha, struct blasfeo_dmat
 		if( m<=2*m_kernel | n_b*k_block <= l2_cache_el )
 			{
 //			printf("\nalg m0\n");
-			goto nt_m1; // long matrix: pack A
+			return BLASFEO_DGEMM_ALG_M1; // long matrix: pack A
 			}
 		}
 	else
@@ -3770,7 +4173,7 @@ void blasfeo_hp_dgemm_nt(int m, int n, int k, double alpha, struct blasfeo_dmat
 		if( n<=2*m_kernel | m_a*k_block <= l2_cache_el )
 			{
 //			printf("\nalg n0\n");
-			goto nt_n1; // tall matrix: pack B
+			return BLASFEO_DGEMM_ALG_N1; // tall matrix: pack B
 			}
 		}
 #else
@@ -3789,17 +4192,67 @@ void blasfeo_hp_dgemm_nt(int m, int n, int k, double alpha, struct blasfeo_dmat
 		if( m<=n )
 			{
 //			printf("\nalg m0\n");
-			goto nt_m1; // long matrix: pack A
+			return BLASFEO_DGEMM_ALG_M1; // long matrix: pack A
 			}
 		else
 			{
 //			printf("\nalg n0\n");
-			goto nt_n1; // tall matrix: pack B
+			return BLASFEO_DGEMM_ALG_N1; // tall matrix: pack B
 			}
 		}
 #endif
 //	printf("\nalg 1\n");
-	goto nt_2; // big matrix: pack A and B
+	return BLASFEO_DGEMM_ALG_2; // big matrix: pack A and B
+
+	}
+
+
+
+// dgemm_nt with the packing algorithm alg and nth threads for the pack A and B alg
+static void blasfeo_hp_dgemm_nt_run(int alg, int nth, int m, int n, int k, double alpha, double *A, int lda, double *B, int ldb, double beta, double *C, int ldc, double *D, int ldd, struct blasfeo_block_size *bs)
+	{
+	int ii, jj, ll;
+	int iii;
+	int mc, nc, kc;
+	int mleft, nleft, kleft;
+	int mc0, nc0, kc0;
+	int ldc1;
+	double beta1;
+	double *pA, *pB, *C1;
+
+#if defined(TARGET_GENERIC)
+	double pU_stack[M_KERNEL*K_MAX_STACK];
+#else
+	ALIGNED( double pU_stack[M_KERNEL*K_MAX_STACK], 64 );
+#endif
+	int sdu_stack = K_MAX_STACK;
+	int k4 = (k+3)/4*4;
+
+	double *pU;
+	int sdu;
+	int pU_size;
+
+	struct blasfeo_pm_dmat tA, tB;
+	int sda, sdb;
+	int tA_size, tB_size;
+	void *mem;
+	char *mem_align;
+	int n1, k1;
+
+	const int ps = PS;
+	const int m_kernel = M_KERNEL;
+
+	switch(alg)
+		{
+		case BLASFEO_DGEMM_ALG_M1:
+			goto nt_m1; // pack A
+		case BLASFEO_DGEMM_ALG_N1:
+			goto nt_n1; // pack B
+		case BLASFEO_DGEMM_ALG_0:
+			goto nt_0; // no pack
+		default:
+			goto nt_2; // pack A and B
+		}
 
 	// never to get here
 	return;
@@ -3813,13 +4266,13 @@ nt_m1:
 
 	// k-blocking alg
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs->d_kc>K_MAX_STACK)
 		{
-		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		pU_size = M_KERNEL*bs->d_kc*sizeof(double);
+		blasfeo_work_malloc(&mem, pU_size+64);
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
-		sdu = KC;
+		sdu = bs->d_kc;
 		}
 	else
 		{
@@ -3831,7 +4284,7 @@ nt_m1:
 
 //	kc = K_MAX_STACK<KC ? K_MAX_STACK : KC;
 //	kc = 4;
-	kc = KC;
+	kc = bs->d_kc;
 
 	if(k<kc)
 		{
@@ -3853,9 +4306,9 @@ nt_m1:
 			}
 		}
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs->d_kc>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -3869,13 +4322,13 @@ nt_n1:
 
 	// k-blocking alg
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs->d_kc>K_MAX_STACK)
 		{
-		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		pU_size = M_KERNEL*bs->d_kc*sizeof(double);
+		blasfeo_work_malloc(&mem, pU_size+64);
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
-		sdu = KC;
+		sdu = bs->d_kc;
 		}
 	else
 		{
@@ -3887,7 +4340,7 @@ nt_n1:
 
 //	kc = K_MAX_STACK<KC ? K_MAX_STACK : KC;
 //	kc = 4;
-	kc = KC;
+	kc = bs->d_kc;
 
 	if(k<kc)
 		{
@@ -3909,9 +4362,9 @@ nt_n1:
 			}
 		}
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs->d_kc>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -3921,14 +4374,22 @@ nt_n1:
 
 nt_2:
 
+#if defined(MULTI_THREAD)
+	if(nth>1)
+		{
+		blasfeo_hp_dgemm_2_mt(0, 1, nth, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, D, ldd, bs);
+		return;
+		}
+#endif
+
 //#if 0
 #if defined(TARGET_X64_INTEL_SKYLAKE_X) | defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
 
 	// cache blocking alg
 
-	mc0 = MC;
-	nc0 = NC;
-	kc0 = KC;
+	mc0 = bs->d_mc;
+	nc0 = bs->d_nc;
+	kc0 = bs->d_kc;
 
 //	mc0 = 12;
 //	nc0 = 8;
@@ -3944,9 +4405,9 @@ nt_2:
 	tB_size = blasfeo_pm_memsize_dmat(ps, nc0, kc0);
 	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(bs)==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+2*4096);
 		}
 	else
 		{
@@ -4045,9 +4506,9 @@ nt_2:
 		
 		}
 
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(bs)==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -4060,7 +4521,7 @@ nt_2:
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, k1);
 //	mem = malloc(tA_size+tB_size+64);
 //	blasfeo_align_64_byte(mem, (void **) &mem_align);
-	mem = malloc(tA_size+tB_size+4096);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+4096);
 	blasfeo_align_4096_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, k, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, k, &tB, (void *) (mem_align+tA_size));
@@ -4173,7 +4634,7 @@ nt_2_left_4:
 	goto nt_2_return;
 
 nt_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 #endif
@@ -4315,11 +4776,11 @@ nt_0_return:
 
 //#ifdef HP_BLAS
 //
-//static void blas_hp_dgemm_tn(int m, int n, int k, double alpha, double *A, int lda, double *B, int ldb, double beta, double *C, int ldc)
+//static void blas_hp_dgemm_nt(int m, int n, int k, double alpha, double *A, int lda, double *B, int ldb, double beta, double *C, int ldc)
 //	{
 //
 //#if defined(PRINT_NAME)
-//	printf("\nblas_hp_dgemm_tn %d %d %d %f %p %d %p %d %f %p %d\n", m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+//	printf("\nblas_hp_dgemm_nt %d %d %d %f %p %d %p %d %f %p %d\n", m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
 //#endif
 //
 //	if(m<=0 | n<=0)
@@ -4330,11 +4791,11 @@ nt_0_return:
 //
 //#else
 
-void blasfeo_hp_dgemm_tn(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+void blasfeo_hp_dgemm_nt(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
 #if defined(PRINT_NAME)
-	printf("\nblasfeo_hp_dgemm_tn (cm) %d %d %d %f %p %d %d %p %d %d %f %p %d %d %p %d %d\n", m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	printf("\nblasfeo_hp_dgemm_nt (cm) %d %d %d %f %p %d %d %p %d %d %f %p %d %d %p %d %d\n", m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
 #endif
 
 	if(m<=0 | n<=0)
@@ -4350,42 +4811,31 @@ void blasfeo_hp_dgemm_tn(int m, int n, int k, double alpha, struct blasfeo_dmat
 	double *C = sC->pA + ci + cj*ldc;
 	double *D = sD->pA + di + dj*ldd;
 
-//#endif
+	// the block sizes are read once, the whole call uses the same ones
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
 
-//	printf("\n%p %d %p %d %p %d %p %d\n", A, lda, B, ldb, C, ldc, D, ldd);
+	int alg = blasfeo_hp_dgemm_nt_alg(m, n, k, lda, ldb, ldc, ldd, &bs);
+	int nth = 1;
+#if defined(MULTI_THREAD)
+	if(alg==BLASFEO_DGEMM_ALG_2)
+		nth = blasfeo_hp_dgemm_2_mt_nth(m, n, k);
+#endif
 
-	int ii, jj, ll;
-	int iii;
-	int mc, nc, kc;
-	int mleft, nleft, kleft;
-	int mc0, nc0, kc0;
-	int ldc1;
-	double beta1;
-	double *pA, *pB, *C1;
+	blasfeo_hp_dgemm_nt_run(alg, nth, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, D, ldd, &bs);
 
-#if defined(TARGET_GENERIC)
-	double pU_stack[M_KERNEL*K_MAX_STACK];
-#else
-	ALIGNED( double pU_stack[M_KERNEL*K_MAX_STACK], 64 );
-#endif
-	int sdu_stack = K_MAX_STACK;
-	int k4 = (k+3)/4*4;
+	return;
 
-	double *pU;
-	int sdu;
-	int pU_size;
+	}
 
-	struct blasfeo_pm_dmat tA, tB;
-	int sda, sdb;
-	int tA_size, tB_size;
-	void *mem;
-	char *mem_align;
-	int m1, n1, k1;
-	int pack_B;
 
-	const int ps = PS;
+
+// packing algorithm of dgemm_tn, forced at build time, from the tuned decision table or from the built-in heuristic;
+// the leading dimensions only enter the cache footprint estimates, a negative one standing for a padded matrix
+static int blasfeo_hp_dgemm_tn_alg(int m, int n, int k, int lda, int ldb, int ldc, int ldd, struct blasfeo_block_size *bs)
+	{
+
 	const int m_kernel = M_KERNEL;
-	const int l1_cache_el = L1_CACHE_EL;
 #if defined(TARGET_X64_INTEL_SKYLAKE_X) | defined(TARGET_X64_INTEL_HASWELL)
 	const int l2_cache_el = L2_CACHE_EL;
 #endif
@@ -4395,29 +4845,38 @@ void blasfeo_hp_dgemm_tn(int m, int n, int k, double alpha, struct blasfeo_dmat
 	const int reals_per_cache_line = CACHE_LINE_EL;
 
 	const int m_cache = (m+reals_per_cache_line-1)/reals_per_cache_line*reals_per_cache_line;
-	const int n_cache = (n+reals_per_cache_line-1)/reals_per_cache_line*reals_per_cache_line;
 	const int k_cache = (k+reals_per_cache_line-1)/reals_per_cache_line*reals_per_cache_line;
-	const int m_kernel_cache = (m_kernel+reals_per_cache_line-1)/reals_per_cache_line*reals_per_cache_line;
-	int m_min = m_cache<m_kernel_cache ? m_cache : m_kernel_cache;
-//	int n_min = n_cache<m_kernel_cache ? n_cache : m_kernel_cache;
 
 	int k_a = k==lda ? k : k_cache;
 	int k_b = k==ldb ? k : k_cache;
 	int m_c = m==ldc ? m : m_cache;
 	int m_d = m==ldd ? m : m_cache;
-	int k_block = K_MAX_STACK<KC ? K_MAX_STACK : KC;
+	int k_block = K_MAX_STACK<bs->d_kc ? K_MAX_STACK : bs->d_kc;
 	k_block = k<=k_block ? k : k_block; // m1 and n1 alg are blocked !!!
 
 #if defined(PACKING_ALG_M1)
-	goto tn_m1; // pack A
+	return BLASFEO_DGEMM_ALG_M1; // pack A
 #endif
 #if defined(PACKING_ALG_N1)
-	goto tn_n1; // pack B
+	return BLASFEO_DGEMM_ALG_N1; // pack B
 #endif
 #if defined(PACKING_ALG_2)
-	goto tn_2; // pack A and B
+	return BLASFEO_DGEMM_ALG_2; // pack A and B
 #endif
 
+	// tuned decision table
+	switch(blasfeo_dgemm_tune_alg(BLASFEO_DGEMM_TN, m, n, k))
+		{
+		case BLASFEO_DGEMM_ALG_M1:
+			return BLASFEO_DGEMM_ALG_M1; // pack A
+		case BLASFEO_DGEMM_ALG_N1:
+			return BLASFEO_DGEMM_ALG_N1; // pack B
+		case BLASFEO_DGEMM_ALG_2:
+			return BLASFEO_DGEMM_ALG_2; // pack A and B
+		default:
+			break; // built-in heuristic
+		}
+
 	// no algorithm for small matrix
 #if defined(TARGET_X64_INTEL_SKYLAKE_X)
 	if( m<=n )
@@ -4425,7 +4884,7 @@ void blasfeo_hp_dgemm_tn(int m, int n, int k, double alpha, struct blasfeo_dmat
 		if( n<=2*m_kernel | k_block*n <= l2_cache_el )
 			{
 //			printf("\nalg m0\n");
-			goto tn_m1; // long matrix: pack A
+			return BLASFEO_DGEMM_ALG_M1; // long matrix: pack A
 			}
 		}
 	else
@@ -4433,12 +4892,12 @@ void blasfeo_hp_dgemm_tn(int m, int n, int k, double alpha, struct blasfeo_dmat
 		if( n<=2*m_kernel | k_block*m <= l2_cache_el )
 			{
 //			printf("\nalg n0\n");
-			goto tn_n1; // tall matrix: pack B
+			return BLASFEO_DGEMM_ALG_N1; // tall matrix: pack B
 			}
 		}
 #else
 #if defined(TARGET_X64_INTEL_HASWELL)
-	if( m<=2*m_kernel | n<=2*m_kernel | ( k<=KC & (k_a*m + k_b*n + m_c*n + m_d*n <= llc_cache_el) ) )
+	if( m<=2*m_kernel | n<=2*m_kernel | ( k<=bs->d_kc & (k_a*m + k_b*n + m_c*n + m_d*n <= llc_cache_el) ) )
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
 	if( m<=2*m_kernel | n<=2*m_kernel | k<56 )
 #elif defined(TARGET_X64_INTEL_CORE)
@@ -4454,17 +4913,69 @@ void blasfeo_hp_dgemm_tn(int m, int n, int k, double alpha, struct blasfeo_dmat
 		if( m<=n )
 			{
 //			printf("\nalg m0\n");
-			goto tn_m1; // long matrix: pack A
+			return BLASFEO_DGEMM_ALG_M1; // long matrix: pack A
 			}
 		else
 			{
 //			printf("\nalg n0\n");
-			goto tn_n1; // tall matrix: pack B
+			return BLASFEO_DGEMM_ALG_N1; // tall matrix: pack B
 			}
 		}
 #endif
 //	printf("\nalg 1\n");
-	goto tn_2; // big matrix: pack A and B
+	return BLASFEO_DGEMM_ALG_2; // big matrix: pack A and B
+
+	}
+
+
+
+// dgemm_tn with the packing algorithm alg and nth threads for the pack A and B alg
+static void blasfeo_hp_dgemm_tn_run(int alg, int nth, int m, int n, int k, double alpha, double *A, int lda, double *B, int ldb, double beta, double *C, int ldc, double *D, int ldd, struct blasfeo_block_size *bs)
+	{
+
+//	printf("\n%p %d %p %d %p %d %p %d\n", A, lda, B, ldb, C, ldc, D, ldd);
+
+	int ii, jj, ll;
+	int iii;
+	int mc, nc, kc;
+	int mleft, nleft, kleft;
+	int mc0, nc0, kc0;
+	int ldc1;
+	double beta1;
+	double *pA, *pB, *C1;
+
+#if defined(TARGET_GENERIC)
+	double pU_stack[M_KERNEL*K_MAX_STACK];
+#else
+	ALIGNED( double pU_stack[M_KERNEL*K_MAX_STACK], 64 );
+#endif
+	int sdu_stack = K_MAX_STACK;
+	int k4 = (k+3)/4*4;
+
+	double *pU;
+	int sdu;
+	int pU_size;
+
+	struct blasfeo_pm_dmat tA, tB;
+	int sda, sdb;
+	int tA_size, tB_size;
+	void *mem;
+	char *mem_align;
+	int n1, k1;
+	int pack_B;
+
+	const int ps = PS;
+	const int m_kernel = M_KERNEL;
+
+	switch(alg)
+		{
+		case BLASFEO_DGEMM_ALG_M1:
+			goto tn_m1; // pack A
+		case BLASFEO_DGEMM_ALG_N1:
+			goto tn_n1; // pack B
+		default:
+			goto tn_2; // pack A and B
+		}
 
 	// never to get here
 	return;
@@ -4477,13 +4988,13 @@ tn_m1:
 
 	// k-blocking alg
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs->d_kc>K_MAX_STACK)
 		{
-		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		pU_size = M_KERNEL*bs->d_kc*sizeof(double);
+		blasfeo_work_malloc(&mem, pU_size+64);
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
-		sdu = KC;
+		sdu = bs->d_kc;
 		}
 	else
 		{
@@ -4495,7 +5006,7 @@ tn_m1:
 
 //	kc = K_MAX_STACK<KC ? K_MAX_STACK : KC;
 //	kc = 4;
-	kc = KC;
+	kc = bs->d_kc;
 
 	if(k<kc)
 		{
@@ -4518,9 +5029,9 @@ tn_m1:
 
 		}
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs->d_kc>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -4535,13 +5046,13 @@ tn_n1:
 	// k-blocking alg
 
 //	if(k>KC)
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs->d_kc>K_MAX_STACK)
 		{
-		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		pU_size = M_KERNEL*bs->d_kc*sizeof(double);
+		blasfeo_work_malloc(&mem, pU_size+64);
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
-		sdu = KC;
+		sdu = bs->d_kc;
 		}
 	else
 		{
@@ -4553,7 +5064,7 @@ tn_n1:
 
 //	kc = K_MAX_STACK<KC ? K_MAX_STACK : KC;
 //	kc = 4;
-	kc = KC;
+	kc = bs->d_kc;
 
 	if(k<kc)
 		{
@@ -4576,9 +5087,9 @@ tn_n1:
 		}
 
 //	if(k>KC)
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs->d_kc>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -4587,14 +5098,22 @@ tn_n1:
 
 tn_2:
 
+#if defined(MULTI_THREAD)
+	if(nth>1)
+		{
+		blasfeo_hp_dgemm_2_mt(1, 0, nth, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, D, ldd, bs);
+		return;
+		}
+#endif
+
 //#if 0
 #if defined(TARGET_X64_INTEL_SKYLAKE_X) | defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
 
 	// cache blocking alg
 
-	mc0 = MC;
-	nc0 = NC;
-	kc0 = KC;
+	mc0 = bs->d_mc;
+	nc0 = bs->d_nc;
+	kc0 = bs->d_kc;
 
 //	mc0 = 12;
 //	nc0 = 8;
@@ -4610,9 +5129,9 @@ tn_2:
 	tB_size = blasfeo_pm_memsize_dmat(ps, nc0, kc0);
 	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(bs)==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+2*4096);
 		}
 	else
 		{
@@ -4706,9 +5225,9 @@ tn_2:
 
 		}
 
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(bs)==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -4721,7 +5240,7 @@ tn_2:
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, k1);
 //	mem = malloc(tA_size+tB_size+64);
 //	blasfeo_align_64_byte(mem, (void **) &mem_align);
-	mem = malloc(tA_size+tB_size+4096);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+4096);
 	blasfeo_align_4096_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, k, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, k, &tB, (void *) (mem_align+tA_size));
@@ -4861,7 +5380,7 @@ tn_2_left_4:
 	goto tn_2_return;
 
 tn_2_return:
-free(mem);
+blasfeo_work_free(mem);
 	return;
 
 #endif
@@ -4876,11 +5395,11 @@ free(mem);
 
 //#ifdef HP_BLAS
 //
-//static void blas_hp_dgemm_tt(int m, int n, int k, double alpha, double *A, int lda, double *B, int ldb, double beta, double *C, int ldc)
+//static void blas_hp_dgemm_tn(int m, int n, int k, double alpha, double *A, int lda, double *B, int ldb, double beta, double *C, int ldc)
 //	{
 //
 //#if defined(PRINT_NAME)
-//	printf("\nblas_hp_dgemm_tt %d %d %d %f %p %d %p %d %f %p %d\n", m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+//	printf("\nblas_hp_dgemm_tn %d %d %d %f %p %d %p %d %f %p %d\n", m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
 //#endif
 //
 //	if(m<=0 | n<=0)
@@ -4891,11 +5410,11 @@ free(mem);
 //
 //#else
 
-void blasfeo_hp_dgemm_tt(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+void blasfeo_hp_dgemm_tn(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
 #if defined(PRINT_NAME)
-	printf("\nblasfeo_hp_dgemm_tt (cm) %d %d %d %f %p %d %d %p %d %d %f %p %d %d %p %d %d\n", m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	printf("\nblasfeo_hp_dgemm_tn (cm) %d %d %d %f %p %d %d %p %d %d %f %p %d %d %p %d %d\n", m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
 #endif
 
 	if(m<=0 | n<=0)
@@ -4911,40 +5430,30 @@ void blasfeo_hp_dgemm_tt(int m, int n, int k, double alpha, struct blasfeo_dmat
 	double *C = sC->pA + ci + cj*ldc;
 	double *D = sD->pA + di + dj*ldd;
 
-//#endif
+	// the block sizes are read once, the whole call uses the same ones
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
 
-//	printf("\n%p %d %p %d %p %d %p %d\n", A, lda, B, ldb, C, ldc, D, ldd);
+	int alg = blasfeo_hp_dgemm_tn_alg(m, n, k, lda, ldb, ldc, ldd, &bs);
+	int nth = 1;
+#if defined(MULTI_THREAD)
+	if(alg==BLASFEO_DGEMM_ALG_2)
+		nth = blasfeo_hp_dgemm_2_mt_nth(m, n, k);
+#endif
 
-	int ii, jj, ll;
-	int iii;
-	int mc, nc, kc;
-	int mleft, nleft, kleft;
-	int mc0, nc0, kc0;
-	int ldc1;
-	double beta1;
-	double *pA, *pB, *C1;
+	blasfeo_hp_dgemm_tn_run(alg, nth, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, D, ldd, &bs);
 
-#if defined(TARGET_GENERIC)
-	double pU_stack[M_KERNEL*K_MAX_STACK];
-#else
-	ALIGNED( double pU_stack[M_KERNEL*K_MAX_STACK], 64 );
-#endif
-	int sdu_stack = K_MAX_STACK;
-	int k4 = (k+3)/4*4;
+	return;
 
-	double *pU;
-	int sdu;
-	int pU_size;
+	}
 
-	struct blasfeo_pm_dmat tA, tB;
-	int sda, sdb;
-	int tA_size, tB_size;
-	void *mem;
-	char *mem_align;
-	int m1, n1, k1;
-	int pack_B;
 
-	const int ps = PS;
+
+// packing algorithm of dgemm_tt, forced at build time, from the tuned decision table or from the built-in heuristic;
+// the leading dimensions only enter the cache footprint estimates, a negative one standing for a padded matrix
+static int blasfeo_hp_dgemm_tt_alg(int m, int n, int k, int lda, int ldb, int ldc, int ldd, struct blasfeo_block_size *bs)
+	{
+
 	const int m_kernel = M_KERNEL;
 	const int l1_cache_el = L1_CACHE_EL;
 #if defined(TARGET_X64_INTEL_SKYLAKE_X) | defined(TARGET_X64_INTEL_HASWELL)
@@ -4959,60 +5468,77 @@ void blasfeo_hp_dgemm_tt(int m, int n, int k, double alpha, struct blasfeo_dmat
 	const int n_cache = (n+reals_per_cache_line-1)/reals_per_cache_line*reals_per_cache_line;
 	const int k_cache = (k+reals_per_cache_line-1)/reals_per_cache_line*reals_per_cache_line;
 	const int m_kernel_cache = (m_kernel+reals_per_cache_line-1)/reals_per_cache_line*reals_per_cache_line;
-	int m_min = m_cache<m_kernel_cache ? m_cache : m_kernel_cache;
-//	int n_min = n_cache<m_kernel_cache ? n_cache : m_kernel_cache;
 
 	int k_a = k==lda ? k : k_cache;
 	int n_b = n==ldb ? n : n_cache;
 	int n_b_kernel = n<=m_kernel ? n_b : m_kernel_cache;
 	int m_c = m==ldc ? m : m_cache;
 	int m_d = m==ldd ? m : m_cache;
-	int k_block = K_MAX_STACK<KC ? K_MAX_STACK : KC;
+	int k_block = K_MAX_STACK<bs->d_kc ? K_MAX_STACK : bs->d_kc;
 	k_block = k<=k_block ? k : k_block; // m1 and n1 alg are blocked !!!
 
 #if defined(PACKING_ALG_0)
 #if defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	goto tt_m1; // pack A
+	return BLASFEO_DGEMM_ALG_M1; // pack A
 #else
-	goto tt_0; // no pack
+	return BLASFEO_DGEMM_ALG_0; // no pack
 #endif
 #endif
 #if defined(PACKING_ALG_M1)
-	goto tt_m1; // pack A
+	return BLASFEO_DGEMM_ALG_M1; // pack A
 #endif
 #if defined(PACKING_ALG_N1)
-	goto tt_n1; // pack B
+	return BLASFEO_DGEMM_ALG_N1; // pack B
 #endif
 #if defined(PACKING_ALG_2)
-	goto tt_2; // pack A and B
+	return BLASFEO_DGEMM_ALG_2; // pack A and B
+#endif
+
+	// tuned decision table
+	switch(blasfeo_dgemm_tune_alg(BLASFEO_DGEMM_TT, m, n, k))
+		{
+		case BLASFEO_DGEMM_ALG_0:
+#if defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+			return BLASFEO_DGEMM_ALG_M1; // pack A
+#else
+			return BLASFEO_DGEMM_ALG_0; // no pack
 #endif
+		case BLASFEO_DGEMM_ALG_M1:
+			return BLASFEO_DGEMM_ALG_M1; // pack A
+		case BLASFEO_DGEMM_ALG_N1:
+			return BLASFEO_DGEMM_ALG_N1; // pack B
+		case BLASFEO_DGEMM_ALG_2:
+			return BLASFEO_DGEMM_ALG_2; // pack A and B
+		default:
+			break; // built-in heuristic
+		}
 
 #if defined(TARGET_X64_INTEL_SKYLAKE_X)
 	if( (m<=m_kernel & n<=m_kernel) | (k_a*m + n_b_kernel*k <= l1_cache_el) )
 		{
-		goto tt_m1; // small matrix: pack A
-//		goto tt_0; // small matrix: no pack TODO
+		return BLASFEO_DGEMM_ALG_M1; // small matrix: pack A
+//		return BLASFEO_DGEMM_ALG_0; // small matrix: no pack TODO
 		}
 #elif defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A57)
 	if( (m<=m_kernel & n<=m_kernel) | (k_a*m + n_b_kernel*k <= l1_cache_el) )
 		{
-		goto tt_0; // small matrix: no pack
+		return BLASFEO_DGEMM_ALG_0; // small matrix: no pack
 		}
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
 	if( m<=48 & n<=48 & k<=K_MAX_STACK )
 		{
-		goto tt_m1; // small matrix: pack A
+		return BLASFEO_DGEMM_ALG_M1; // small matrix: pack A
 		}
 #elif defined(TARGET_ARMV8A_ARM_CORTEX_A53)
 	if( (m<=m_kernel & n<=m_kernel & k<160) )
 		{
 //		printf("\nalg 2\n");
-		goto tt_0; // small matrix: no pack
+		return BLASFEO_DGEMM_ALG_0; // small matrix: no pack
 		}
 #else
 	if( m<=8 & n<=8 )
 		{
-		goto tt_0; // small matrix: no pack
+		return BLASFEO_DGEMM_ALG_0; // small matrix: no pack
 		}
 #endif
 #if defined(TARGET_X64_INTEL_SKYLAKE_X) | defined(TARGET_X64_INTEL_HASWELL)
@@ -5021,7 +5547,7 @@ void blasfeo_hp_dgemm_tt(int m, int n, int k, double alpha, struct blasfeo_dmat
 		if( m<=2*m_kernel | n_b*k_block <= l2_cache_el )
 			{
 //			printf("\nalg m0\n");
-			goto tt_m1; // long matrix: pack A
+			return BLASFEO_DGEMM_ALG_M1; // long matrix: pack A
 			}
 		}
 	else
@@ -5029,11 +5555,11 @@ void blasfeo_hp_dgemm_tt(int m, int n, int k, double alpha, struct blasfeo_dmat
 #if defined(TARGET_X64_INTEL_SKYLAKE_X)
 		if( n<=2*m_kernel | k_block*m <= l2_cache_el )
 #elif defined(TARGET_X64_INTEL_HASWELL)
-		if( n<=2*m_kernel | ( k<=KC & (k_a*m + n_b*k + m_c*n + m_d*n <= llc_cache_el) ) )
+		if( n<=2*m_kernel | ( k<=bs->d_kc & (k_a*m + n_b*k + m_c*n + m_d*n <= llc_cache_el) ) )
 #endif
 			{
 //			printf("\nalg n0\n");
-			goto tt_n1; // tall matrix: pack B
+			return BLASFEO_DGEMM_ALG_N1; // tall matrix: pack B
 			}
 		}
 #else
@@ -5051,15 +5577,68 @@ void blasfeo_hp_dgemm_tt(int m, int n, int k, double alpha, struct blasfeo_dmat
 		{
 		if( m*4<=n | k<=4 ) // XXX k too !!!
 			{
-			goto tt_m1; // long matrix: pack A
+			return BLASFEO_DGEMM_ALG_M1; // long matrix: pack A
 			}
 		else
 			{
-			goto tt_n1; // tall matrix: pack B
+			return BLASFEO_DGEMM_ALG_N1; // tall matrix: pack B
 			}
 		}
 #endif
-	goto tt_2; // big matrix: pack A and B
+	return BLASFEO_DGEMM_ALG_2; // big matrix: pack A and B
+
+	}
+
+
+
+// dgemm_tt with the packing algorithm alg and nth threads for the pack A and B alg
+static void blasfeo_hp_dgemm_tt_run(int alg, int nth, int m, int n, int k, double alpha, double *A, int lda, double *B, int ldb, double beta, double *C, int ldc, double *D, int ldd, struct blasfeo_block_size *bs)
+	{
+
+//	printf("\n%p %d %p %d %p %d %p %d\n", A, lda, B, ldb, C, ldc, D, ldd);
+
+	int ii, jj, ll;
+	int iii;
+	int mc, nc, kc;
+	int mleft, nleft, kleft;
+	int mc0, nc0, kc0;
+	int ldc1;
+	double beta1;
+	double *pA, *pB, *C1;
+
+#if defined(TARGET_GENERIC)
+	double pU_stack[M_KERNEL*K_MAX_STACK];
+#else
+	ALIGNED( double pU_stack[M_KERNEL*K_MAX_STACK], 64 );
+#endif
+	int sdu_stack = K_MAX_STACK;
+	int k4 = (k+3)/4*4;
+
+	double *pU;
+	int sdu;
+	int pU_size;
+
+	struct blasfeo_pm_dmat tA, tB;
+	int sda, sdb;
+	int tA_size, tB_size;
+	void *mem;
+	char *mem_align;
+	int n1, k1;
+
+	const int ps = PS;
+	const int m_kernel = M_KERNEL;
+
+	switch(alg)
+		{
+		case BLASFEO_DGEMM_ALG_M1:
+			goto tt_m1; // pack A
+		case BLASFEO_DGEMM_ALG_N1:
+			goto tt_n1; // pack B
+		case BLASFEO_DGEMM_ALG_0:
+			goto tt_0; // no pack
+		default:
+			goto tt_2; // pack A and B
+		}
 
 	// never to get here
 	return;
@@ -5072,13 +5651,13 @@ tt_m1:
 
 	// k-blocking alg
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs->d_kc>K_MAX_STACK)
 		{
-		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		pU_size = M_KERNEL*bs->d_kc*sizeof(double);
+		blasfeo_work_malloc(&mem, pU_size+64);
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
-		sdu = KC;
+		sdu = bs->d_kc;
 		}
 	else
 		{
@@ -5090,7 +5669,7 @@ tt_m1:
 
 //	kc = K_MAX_STACK<KC ? K_MAX_STACK : KC;
 //	kc = 4;
-	kc = KC;
+	kc = bs->d_kc;
 
 	if(k<kc)
 		{
@@ -5112,9 +5691,9 @@ tt_m1:
 			}
 		}
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs->d_kc>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -5128,13 +5707,13 @@ tt_n1:
 
 	// k-blocking alg
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs->d_kc>K_MAX_STACK)
 		{
-		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		pU_size = M_KERNEL*bs->d_kc*sizeof(double);
+		blasfeo_work_malloc(&mem, pU_size+64);
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
-		sdu = KC;
+		sdu = bs->d_kc;
 		}
 	else
 		{
@@ -5146,7 +5725,7 @@ tt_n1:
 
 //	kc = K_MAX_STACK<KC ? K_MAX_STACK : KC;
 //	kc = 4;
-	kc = KC;
+	kc = bs->d_kc;
 
 	if(k<kc)
 		{
@@ -5168,9 +5747,9 @@ tt_n1:
 			}
 		}
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs->d_kc>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -5179,14 +5758,22 @@ tt_n1:
 
 tt_2:
 
+#if defined(MULTI_THREAD)
+	if(nth>1)
+		{
+		blasfeo_hp_dgemm_2_mt(1, 1, nth, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, D, ldd, bs);
+		return;
+		}
+#endif
+
 //#if 0
 #if defined(TARGET_X64_INTEL_SKYLAKE_X) | defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
 
 	// cache blocking alg
 
-	mc0 = MC;
-	nc0 = NC;
-	kc0 = KC;
+	mc0 = bs->d_mc;
+	nc0 = bs->d_nc;
+	kc0 = bs->d_kc;
 
 //	mc0 = 12;
 //	nc0 = 8;
@@ -5202,9 +5789,9 @@ tt_2:
 	tB_size = blasfeo_pm_memsize_dmat(ps, nc0, kc0);
 	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(bs)==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+2*4096);
 		}
 	else
 		{
@@ -5303,9 +5890,9 @@ tt_2:
 
 		}
 
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(bs)==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -5318,7 +5905,7 @@ tt_2:
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, k1);
 //	mem = malloc(tA_size+tB_size+64);
 //	blasfeo_align_64_byte(mem, (void **) &mem_align);
-	mem = malloc(tA_size+tB_size+4096);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+4096);
 	blasfeo_align_4096_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, k, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, k, &tB, (void *) (mem_align+tA_size));
@@ -5437,7 +6024,7 @@ tt_2_left_4:
 	goto tt_2_return;
 
 tt_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 #endif
@@ -5578,9 +6165,453 @@ tt_0_return:
 
 
 
-#if defined(LA_HIGH_PERFORMANCE)
-//#ifndef HP_BLAS
-
+//#ifdef HP_BLAS
+//
+//static void blas_hp_dgemm_tt(int m, int n, int k, double alpha, double *A, int lda, double *B, int ldb, double beta, double *C, int ldc)
+//	{
+//
+//#if defined(PRINT_NAME)
+//	printf("\nblas_hp_dgemm_tt %d %d %d %f %p %d %p %d %f %p %d\n", m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+//#endif
+//
+//	if(m<=0 | n<=0)
+//		return;
+//
+//	int ldd = ldc;
+//	double *D = C;
+//
+//#else
+
+void blasfeo_hp_dgemm_tt(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+#if defined(PRINT_NAME)
+	printf("\nblasfeo_hp_dgemm_tt (cm) %d %d %d %f %p %d %d %p %d %d %f %p %d %d %p %d %d\n", m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+#endif
+
+	if(m<=0 | n<=0)
+		return;
+
+	// extract pointer to column-major matrices from structures
+	int lda = sA->m;
+	int ldb = sB->m;
+	int ldc = sC->m;
+	int ldd = sD->m;
+	double *A = sA->pA + ai + aj*lda;
+	double *B = sB->pA + bi + bj*ldb;
+	double *C = sC->pA + ci + cj*ldc;
+	double *D = sD->pA + di + dj*ldd;
+
+	// the block sizes are read once, the whole call uses the same ones
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+
+	int alg = blasfeo_hp_dgemm_tt_alg(m, n, k, lda, ldb, ldc, ldd, &bs);
+	int nth = 1;
+#if defined(MULTI_THREAD)
+	if(alg==BLASFEO_DGEMM_ALG_2)
+		nth = blasfeo_hp_dgemm_2_mt_nth(m, n, k);
+#endif
+
+	blasfeo_hp_dgemm_tt_run(alg, nth, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, D, ldd, &bs);
+
+	return;
+
+	}
+
+
+
+// workspace size in bytes: upper bound over the algorithms that can be selected for a m x n x k product
+static size_t blasfeo_hp_dgemm_worksize(int var, int m, int n, int k)
+	{
+
+	const int ps = PS;
+
+	size_t size = 0;
+	size_t tmp, tA_size, tB_size;
+	int k1, n1;
+#if defined(MULTI_THREAD)
+	int nth;
+#endif
+
+	if(m<=0 | n<=0)
+		return 0;
+
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+
+	// pack A or pack B alg: panel buffer on the heap if larger than the stack one
+	if(k>K_MAX_STACK && bs.d_kc>K_MAX_STACK)
+		{
+		tmp = blasfeo_work_memsize(M_KERNEL*bs.d_kc*sizeof(double)+64);
+		size = tmp>size ? tmp : size;
+		}
+
+	// pack A and B alg: never selected for a single kernel block, unless forced
+#if ! defined(PACKING_ALG_2)
+	if(m<=M_KERNEL & n<=M_KERNEL & k<160 & blasfeo_dgemm_tune_alg(var, m, n, k)!=BLASFEO_DGEMM_ALG_2)
+		return size;
+#endif
+
+#if defined(MULTI_THREAD)
+	nth = blasfeo_hp_dgemm_2_mt_nth(m, n, k);
+	if(nth>1)
+		{
+		tA_size = blasfeo_pm_memsize_dmat(ps, bs.d_mc, bs.d_kc);
+		tB_size = blasfeo_pm_memsize_dmat(ps, bs.d_nc, bs.d_kc);
+		tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
+		tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
+		tmp = blasfeo_work_memsize(2*tB_size+nth*tA_size+4096);
+		size = tmp>size ? tmp : size;
+		return size;
+		}
+#endif
+
+#if defined(TARGET_X64_INTEL_SKYLAKE_X) | defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+	if(1)
+#else
+	if(var==BLASFEO_DGEMM_NN)
+#endif
+		{
+		// cache blocking alg, unless the buffer of blasfeo_init is used
+		if(blasfeo_is_init_block_size(&bs)==0)
+			{
+			tmp = blasfeo_work_memsize(blasfeo_memsize_buffer_block_size(&bs));
+			size = tmp>size ? tmp : size;
+			}
+		}
+	else
+		{
+		k1 = (k+128-1)/128*128;
+		n1 = (n+128-1)/128*128;
+		tA_size = blasfeo_pm_memsize_dmat(ps, M_KERNEL, k1);
+		tB_size = blasfeo_pm_memsize_dmat(ps, n1, k1);
+		tmp = blasfeo_work_memsize(tA_size+tB_size+4096);
+		size = tmp>size ? tmp : size;
+		}
+
+	return size;
+
+	}
+
+
+
+size_t blasfeo_hp_dgemm_nn_worksize(int m, int n, int k)
+	{
+	return blasfeo_hp_dgemm_worksize(BLASFEO_DGEMM_NN, m, n, k);
+	}
+
+
+
+size_t blasfeo_hp_dgemm_nt_worksize(int m, int n, int k)
+	{
+	return blasfeo_hp_dgemm_worksize(BLASFEO_DGEMM_NT, m, n, k);
+	}
+
+
+
+size_t blasfeo_hp_dgemm_tn_worksize(int m, int n, int k)
+	{
+	return blasfeo_hp_dgemm_worksize(BLASFEO_DGEMM_TN, m, n, k);
+	}
+
+
+
+size_t blasfeo_hp_dgemm_tt_worksize(int m, int n, int k)
+	{
+	return blasfeo_hp_dgemm_worksize(BLASFEO_DGEMM_TT, m, n, k);
+	}
+
+
+
+
+// pack once, compute many: op(A) is packed into a panel-major matrix with the panel size and the panel stride
+// of the pack-A algorithm, and the compute routines run the pack-A algorithm skipping the packing of A;
+// the columns of D are blocked so that the current block of B stays in the L2 cache over all rows of A
+
+size_t blasfeo_hp_dgemm_pack_memsize(int m, int k)
+	{
+	return blasfeo_pm_memsize_dmat(PS, m, k);
+	}
+
+
+
+void blasfeo_hp_dgemm_pack(char ta, int m, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_pm_dmat *sP, void *mem)
+	{
+
+	const int ps = PS;
+
+	int ii;
+
+	blasfeo_pm_create_dmat(ps, m, k, sP, mem);
+
+	if(m<=0 | k<=0)
+		return;
+
+	int lda = sA->m;
+	double *A = sA->pA + ai + aj*lda;
+	double *pA = sP->pA;
+	int sda = sP->cn;
+
+	// zero the padding rows of the last panel, read by the kernels
+	if(m%ps!=0)
+		{
+		for(ii=0; ii<ps*sda; ii++)
+			pA[(m/ps)*ps*sda+ii] = 0.0;
+		}
+
+	if(ta=='n' | ta=='N')
+		{
+		for(ii=0; ii<m-ps+1; ii+=ps)
+			{
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+			kernel_dpack_nn_8_lib8(k, A+ii, lda, pA+ii*sda);
+#else
+			kernel_dpack_nn_4_lib4(k, A+ii, lda, pA+ii*sda);
+#endif
+			}
+		if(ii<m)
+			{
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+			kernel_dpack_nn_8_vs_lib8(k, A+ii, lda, pA+ii*sda, m-ii);
+#else
+			kernel_dpack_nn_4_vs_lib4(k, A+ii, lda, pA+ii*sda, m-ii);
+#endif
+			}
+		}
+	else if(ta=='t' | ta=='T')
+		{
+		for(ii=0; ii<m-ps+1; ii+=ps)
+			{
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+			kernel_dpack_tn_8_lib8(k, A+ii*lda, lda, pA+ii*sda);
+#else
+			kernel_dpack_tn_4_lib4(k, A+ii*lda, lda, pA+ii*sda);
+#endif
+			}
+		if(ii<m)
+			{
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+			kernel_dpack_tn_8_vs_lib8(k, A+ii*lda, lda, pA+ii*sda, m-ii);
+#else
+			kernel_dpack_tn_4_vs_lib4(k, A+ii*lda, lda, pA+ii*sda, m-ii);
+#endif
+			}
+		}
+	else
+		{
+		printf("\nerror: blasfeo_dgemm_pack: wrong value of ta %c\n", ta);
+		exit(1);
+		}
+
+	return;
+
+	}
+
+
+
+// width of the blocks of columns of D: as the L2 block of the pack-A-and-B algorithm for a KC deep product,
+// multiple of the kernel widths of all targets
+static int blasfeo_hp_dgemm_compute_nc(int k)
+	{
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+	int nc = (int) ((double) bs.d_nc*bs.d_kc/(k>0 ? k : 1));
+	nc = nc/24*24;
+	return nc>24 ? nc : 24;
+	}
+
+
+
+// D <= beta * C + alpha * op(A) * B, with op(A) pre-packed
+void blasfeo_hp_dgemm_compute_n(int n, double alpha, struct blasfeo_pm_dmat *sP, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	int m = sP->m;
+	int k = sP->n;
+
+	if(m<=0 | n<=0)
+		return;
+
+	int ldb = sB->m;
+	int ldc = sC->m;
+	int ldd = sD->m;
+	double *B = sB->pA + bi + bj*ldb;
+	double *C = sC->pA + ci + cj*ldc;
+	double *D = sD->pA + di + dj*ldd;
+
+	int jj, nleft;
+	int nc = blasfeo_hp_dgemm_compute_nc(k);
+
+	for(jj=0; jj<n; jj+=nleft)
+		{
+		nleft = n-jj<nc ? n-jj : nc;
+		blasfeo_hp_dgemm_nn_m1(m, nleft, k, alpha, NULL, 0, B+jj*ldb, ldb, beta, C+jj*ldc, ldc, D+jj*ldd, ldd, sP->pA, sP->cn);
+		}
+
+	return;
+
+	}
+
+
+
+// D <= beta * C + alpha * op(A) * B^T, with op(A) pre-packed
+void blasfeo_hp_dgemm_compute_t(int n, double alpha, struct blasfeo_pm_dmat *sP, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	int m = sP->m;
+	int k = sP->n;
+
+	if(m<=0 | n<=0)
+		return;
+
+	int ldb = sB->m;
+	int ldc = sC->m;
+	int ldd = sD->m;
+	double *B = sB->pA + bi + bj*ldb;
+	double *C = sC->pA + ci + cj*ldc;
+	double *D = sD->pA + di + dj*ldd;
+
+	int jj, nleft;
+	int nc = blasfeo_hp_dgemm_compute_nc(k);
+
+	for(jj=0; jj<n; jj+=nleft)
+		{
+		nleft = n-jj<nc ? n-jj : nc;
+		blasfeo_hp_dgemm_nt_m1(m, nleft, k, alpha, NULL, 0, B+jj, ldb, beta, C+jj*ldc, ldc, D+jj*ldd, ldd, sP->pA, sP->cn);
+		}
+
+	return;
+
+	}
+
+
+
+
+// execution plan: the variant and the packing algorithm are resolved at plan creation for the given sizes and
+// offsets, while the number of threads of the cache-blocking algorithm is still taken at execution
+
+void blasfeo_hp_dgemm_plan(char ta, char tb, int m, int n, int k, int ai, int aj, int bi, int bj, int ci, int cj, int di, int dj, struct blasfeo_dplan *plan)
+	{
+
+	plan->m = m;
+	plan->n = n;
+	plan->k = k;
+	plan->ai = ai;
+	plan->aj = aj;
+	plan->bi = bi;
+	plan->bj = bj;
+	plan->ci = ci;
+	plan->cj = cj;
+	plan->di = di;
+	plan->dj = dj;
+
+	int var;
+	if(ta=='n' | ta=='N')
+		{
+		var = BLASFEO_DGEMM_NN;
+		}
+	else if(ta=='t' | ta=='T')
+		{
+		var = BLASFEO_DGEMM_TN;
+		}
+	else
+		{
+		printf("\nerror: blasfeo_dgemm_plan: wrong value of ta %c\n", ta);
+		exit(1);
+		}
+	if(tb=='t' | tb=='T')
+		{
+		var += 1;
+		}
+	else if(tb!='n' & tb!='N')
+		{
+		printf("\nerror: blasfeo_dgemm_plan: wrong value of tb %c\n", tb);
+		exit(1);
+		}
+	plan->var = var;
+
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+
+	// the leading dimensions are not known yet: size the cache footprints on padded matrices
+	switch(var)
+		{
+		case BLASFEO_DGEMM_NN:
+			plan->alg = blasfeo_hp_dgemm_nn_alg(m, n, k, -1, -1, -1, -1, &bs);
+			break;
+		case BLASFEO_DGEMM_NT:
+			plan->alg = blasfeo_hp_dgemm_nt_alg(m, n, k, -1, -1, -1, -1, &bs);
+			break;
+		case BLASFEO_DGEMM_TN:
+			plan->alg = blasfeo_hp_dgemm_tn_alg(m, n, k, -1, -1, -1, -1, &bs);
+			break;
+		default:
+			plan->alg = blasfeo_hp_dgemm_tt_alg(m, n, k, -1, -1, -1, -1, &bs);
+			break;
+		}
+
+	return;
+
+	}
+
+
+
+void blasfeo_hp_dgemm_execute(struct blasfeo_dplan *plan, double alpha, struct blasfeo_dmat *sA, struct blasfeo_dmat *sB, double beta, struct blasfeo_dmat *sC, struct blasfeo_dmat *sD)
+	{
+
+	int m = plan->m;
+	int n = plan->n;
+	int k = plan->k;
+
+	if(m<=0 | n<=0)
+		return;
+
+	// extract pointer to column-major matrices from structures
+	int lda = sA->m;
+	int ldb = sB->m;
+	int ldc = sC->m;
+	int ldd = sD->m;
+	double *A = sA->pA + plan->ai + plan->aj*lda;
+	double *B = sB->pA + plan->bi + plan->bj*ldb;
+	double *C = sC->pA + plan->ci + plan->cj*ldc;
+	double *D = sD->pA + plan->di + plan->dj*ldd;
+
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+
+	int nth = 1;
+#if defined(MULTI_THREAD)
+	if(plan->alg==BLASFEO_DGEMM_ALG_2)
+		nth = blasfeo_hp_dgemm_2_mt_nth(m, n, k);
+#endif
+
+	switch(plan->var)
+		{
+		case BLASFEO_DGEMM_NN:
+			blasfeo_hp_dgemm_nn_run(plan->alg, nth, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, D, ldd, &bs);
+			break;
+		case BLASFEO_DGEMM_NT:
+			blasfeo_hp_dgemm_nt_run(plan->alg, nth, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, D, ldd, &bs);
+			break;
+		case BLASFEO_DGEMM_TN:
+			blasfeo_hp_dgemm_tn_run(plan->alg, nth, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, D, ldd, &bs);
+			break;
+		default:
+			blasfeo_hp_dgemm_tt_run(plan->alg, nth, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, D, ldd, &bs);
+			break;
+		}
+
+	return;
+
+	}
+
+
+
+
+#if defined(LA_HIGH_PERFORMANCE)
+//#ifndef HP_BLAS
+
 
 
 void blasfeo_dgemm_nn(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
@@ -5611,6 +6642,116 @@ void blasfeo_dgemm_tt(int m, int n, int k, double alpha, struct blasfeo_dmat *sA
 
 
 
+size_t blasfeo_dgemm_nn_worksize(int m, int n, int k)
+	{
+	return blasfeo_hp_dgemm_nn_worksize(m, n, k);
+	}
+
+
+
+void blasfeo_dgemm_nn_ws(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dgemm_nn(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dgemm_nt_worksize(int m, int n, int k)
+	{
+	return blasfeo_hp_dgemm_nt_worksize(m, n, k);
+	}
+
+
+
+void blasfeo_dgemm_nt_ws(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dgemm_nt(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dgemm_tn_worksize(int m, int n, int k)
+	{
+	return blasfeo_hp_dgemm_tn_worksize(m, n, k);
+	}
+
+
+
+void blasfeo_dgemm_tn_ws(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dgemm_tn(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dgemm_tt_worksize(int m, int n, int k)
+	{
+	return blasfeo_hp_dgemm_tt_worksize(m, n, k);
+	}
+
+
+
+void blasfeo_dgemm_tt_ws(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dgemm_tt(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dgemm_pack_memsize(int m, int k)
+	{
+	return blasfeo_hp_dgemm_pack_memsize(m, k);
+	}
+
+
+
+void blasfeo_dgemm_pack(char ta, int m, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_pm_dmat *sP, void *mem)
+	{
+	blasfeo_hp_dgemm_pack(ta, m, k, sA, ai, aj, sP, mem);
+	}
+
+
+
+void blasfeo_dgemm_compute_n(int n, double alpha, struct blasfeo_pm_dmat *sP, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dgemm_compute_n(n, alpha, sP, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	}
+
+
+
+void blasfeo_dgemm_compute_t(int n, double alpha, struct blasfeo_pm_dmat *sP, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dgemm_compute_t(n, alpha, sP, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	}
+
+
+
+void blasfeo_dgemm_plan(char ta, char tb, int m, int n, int k, int ai, int aj, int bi, int bj, int ci, int cj, int di, int dj, struct blasfeo_dplan *plan)
+	{
+	blasfeo_hp_dgemm_plan(ta, tb, m, n, k, ai, aj, bi, bj, ci, cj, di, dj, plan);
+	}
+
+
+
+void blasfeo_dgemm_execute(struct blasfeo_dplan *plan, double alpha, struct blasfeo_dmat *sA, struct blasfeo_dmat *sB, double beta, struct blasfeo_dmat *sC, struct blasfeo_dmat *sD)
+	{
+	blasfeo_hp_dgemm_execute(plan, alpha, sA, sB, beta, sC, sD);
+	}
+
+
+
 //#endif
 #endif
 
@@ -41,6 +41,7 @@
 #include <blasfeo_common.h>
 #include <blasfeo_d_aux.h>
 #include <blasfeo_d_kernel.h>
+#include <blasfeo_memory.h>
 #if defined(BLASFEO_REF_API)
 #include <blasfeo_d_blasfeo_ref_api.h>
 #endif
@@ -53,6 +54,9 @@
 #define blasfeo_hp_dgetrf_np blasfeo_hp_cm_dgetrf_np
 #define blasfeo_dgetrf_rp blasfeo_cm_dgetrf_rp
 #define blasfeo_dgetrf_np blasfeo_cm_dgetrf_np
+#define blasfeo_hp_dgetrf_rp_worksize blasfeo_hp_cm_dgetrf_rp_worksize
+#define blasfeo_dgetrf_rp_worksize blasfeo_cm_dgetrf_rp_worksize
+#define blasfeo_dgetrf_rp_ws blasfeo_cm_dgetrf_rp_ws
 #endif
 
 
@@ -648,7 +652,7 @@ alg2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, mem_align);
@@ -1259,7 +1263,7 @@ end_2:
 	// TODO clean loops
 
 end_m_2:
-	free(mem);
+	blasfeo_work_free(mem);
 	// from 0-index to 1-index
 	// TODO move to BLAS_API !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 //	for(ii=0; ii<p; ii++)
@@ -1675,6 +1679,28 @@ end_1:
 
 
 
+size_t blasfeo_hp_dgetrf_rp_worksize(int m, int n)
+	{
+
+	const int ps = 4; //D_PS;
+
+	int m1, n1;
+
+	if(m<=0 | n<=0)
+		return 0;
+
+	// small matrix
+	if(m<12 & n<12 & m<=K_MAX_STACK)
+		return 0;
+
+	m1 = (m+128-1)/128*128;
+	n1 = (n+128-1)/128*128;
+	return blasfeo_work_memsize(blasfeo_pm_memsize_dmat(ps, M_KERNEL, m1)+blasfeo_pm_memsize_dmat(ps, m1, n1)+64);
+
+	}
+
+
+
 #if defined(LA_HIGH_PERFORMANCE)
 
 
@@ -1693,5 +1719,22 @@ void blasfeo_dgetrf_np(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, st
 
 
 
+size_t blasfeo_dgetrf_rp_worksize(int m, int n)
+	{
+	return blasfeo_hp_dgetrf_rp_worksize(m, n);
+	}
+
+
+
+void blasfeo_dgetrf_rp_ws(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, int *ipiv, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dgetrf_rp(m, n, sC, ci, cj, sD, di, dj, ipiv);
+	blasfeo_work_end(&prev);
+	}
+
+
+
 #endif
 
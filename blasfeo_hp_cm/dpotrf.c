@@ -45,6 +45,7 @@
 #include <blasfeo_d_kernel.h>
 #include <blasfeo_stdlib.h>
 #include <blasfeo_memory.h>
+#include <blasfeo_thread.h>
 
 
 
@@ -56,6 +57,19 @@
 #define blasfeo_dpotrf_l blasfeo_cm_dpotrf_l
 #define blasfeo_dpotrf_u blasfeo_cm_dpotrf_u
 #define blasfeo_dpotrf_l_mn blasfeo_cm_dpotrf_l_mn
+#define blasfeo_hp_dpotrf_l_worksize blasfeo_hp_cm_dpotrf_l_worksize
+#define blasfeo_hp_dpotrf_u_worksize blasfeo_hp_cm_dpotrf_u_worksize
+#define blasfeo_hp_dpotrf_l_mn_worksize blasfeo_hp_cm_dpotrf_l_mn_worksize
+#define blasfeo_dpotrf_l_worksize blasfeo_cm_dpotrf_l_worksize
+#define blasfeo_dpotrf_u_worksize blasfeo_cm_dpotrf_u_worksize
+#define blasfeo_dpotrf_l_mn_worksize blasfeo_cm_dpotrf_l_mn_worksize
+#define blasfeo_dpotrf_l_ws blasfeo_cm_dpotrf_l_ws
+#define blasfeo_dpotrf_u_ws blasfeo_cm_dpotrf_u_ws
+#define blasfeo_dpotrf_l_mn_ws blasfeo_cm_dpotrf_l_mn_ws
+#define blasfeo_hp_dpotrf_plan blasfeo_cm_hp_dpotrf_plan
+#define blasfeo_hp_dpotrf_execute blasfeo_cm_hp_dpotrf_execute
+#define blasfeo_dpotrf_plan blasfeo_cm_dpotrf_plan
+#define blasfeo_dpotrf_execute blasfeo_cm_dpotrf_execute
 #endif
 
 
@@ -63,6 +77,16 @@
 #if ( defined(BLAS_API) & defined(MF_PANELMAJ) )
 #define blasfeo_hp_dtrsm_rltn blasfeo_hp_cm_dtrsm_rltn
 #define blasfeo_hp_dsyrk3_ln blasfeo_hp_cm_dsyrk3_ln
+#define blasfeo_hp_dtrsm_rltn_worksize blasfeo_hp_cm_dtrsm_rltn_worksize
+#define blasfeo_hp_dsyrk3_ln_worksize blasfeo_hp_cm_dsyrk3_ln_worksize
+#define blasfeo_hp_dgemm_nt blasfeo_hp_cm_dgemm_nt
+#define blasfeo_hp_dgemm_tn blasfeo_hp_cm_dgemm_tn
+#define blasfeo_hp_dsyrk3_ut blasfeo_hp_cm_dsyrk3_ut
+#define blasfeo_hp_dtrsm_lutn blasfeo_hp_cm_dtrsm_lutn
+#define blasfeo_hp_dgemm_nt_worksize blasfeo_hp_cm_dgemm_nt_worksize
+#define blasfeo_hp_dgemm_tn_worksize blasfeo_hp_cm_dgemm_tn_worksize
+#define blasfeo_hp_dsyrk3_ut_worksize blasfeo_hp_cm_dsyrk3_ut_worksize
+#define blasfeo_hp_dtrsm_lutn_worksize blasfeo_hp_cm_dtrsm_lutn_worksize
 #endif
 #include <blasfeo_d_blasfeo_hp_api.h>
 
@@ -75,9 +99,6 @@
 #define PS D_PS
 #define M_KERNEL D_M_KERNEL
 #define N_KERNEL D_N_KERNEL
-#define KC D_KC
-#define NC D_NC
-#define MC D_MC
 
 
 
@@ -552,6 +573,368 @@ lx_2_return:
 
 
 
+#if defined(MULTI_THREAD)
+
+
+
+void blasfeo_hp_dpotrf_l(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_hp_dpotrf_u(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+size_t blasfeo_hp_dpotrf_l_worksize(int m);
+size_t blasfeo_hp_dpotrf_u_worksize(int m);
+
+
+
+// tile size of the multi-threaded alg: multiple of the kernel sizes of all targets
+#define POTRF_MT_NB 192
+
+
+
+// shared state of the multi-threaded tiled alg;
+// the tiles are indexed in the lower triangle, (i,j) with j<=i, i.e. transposed for the upper factorization
+struct blasfeo_hp_dpotrf_mt_arg
+	{
+	int upper;
+	int m;
+	int nt; // number of tile rows/cols
+	struct blasfeo_dmat *sC;
+	int ci;
+	int cj;
+	struct blasfeo_dmat *sD;
+	int di;
+	int dj;
+	int *upd; // number of trailing updates applied to the tile
+	int *busy; // tile being processed by a thread
+	int *done; // tile factorized
+	int n_done;
+	char *work; // workspace of the nested routines, one slot per thread
+	size_t slotsize;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	};
+
+
+
+// task of the multi-threaded tiled alg
+struct blasfeo_hp_dpotrf_mt_task
+	{
+	int ii; // tile row
+	int jj; // tile col
+	int k0; // first update
+	int k1; // one past the last update; k0==k1 for the factorization of the tile
+	};
+
+
+
+#define POTRF_MT_IDX(ii, jj) ((ii)*((ii)+1)/2+(jj))
+
+
+
+// pick the next ready task, scanning the tiles column by column: the tiles of the next panel
+// are updated and factorized as soon as their dependencies are met (lookahead), while the
+// trailing updates of the previous panels are still in progress;
+// consecutive updates ready for the same tile are merged in a single call;
+// return 0 if no task is ready at the moment
+static int blasfeo_hp_dpotrf_mt_next(struct blasfeo_hp_dpotrf_mt_arg *arg, struct blasfeo_hp_dpotrf_mt_task *task)
+	{
+
+	int nt = arg->nt;
+	int *upd = arg->upd;
+	int *busy = arg->busy;
+	int *done = arg->done;
+
+	int ii, jj, kk, idx;
+
+	for(jj=0; jj<nt; jj++)
+		{
+		for(ii=jj; ii<nt; ii++)
+			{
+			idx = POTRF_MT_IDX(ii, jj);
+			if(done[idx] | busy[idx])
+				continue;
+			kk = upd[idx];
+			if(kk<jj)
+				{
+				// trailing update with the factorized tiles (ii,kk) and (jj,kk)
+				if(done[POTRF_MT_IDX(ii, kk)] & done[POTRF_MT_IDX(jj, kk)])
+					{
+					task->ii = ii;
+					task->jj = jj;
+					task->k0 = kk;
+					for(kk++; kk<jj && done[POTRF_MT_IDX(ii, kk)] & done[POTRF_MT_IDX(jj, kk)]; kk++)
+						;
+					task->k1 = kk;
+					busy[idx] = 1;
+					return 1;
+					}
+				}
+			else
+				{
+				// factorization, the off-diagonal tiles need the diagonal one
+				if(ii==jj || done[POTRF_MT_IDX(jj, jj)])
+					{
+					task->ii = ii;
+					task->jj = jj;
+					task->k0 = kk;
+					task->k1 = kk;
+					busy[idx] = 1;
+					return 1;
+					}
+				}
+			}
+		}
+
+	return 0;
+
+	}
+
+
+
+static void blasfeo_hp_dpotrf_mt_run(struct blasfeo_hp_dpotrf_mt_arg *arg, struct blasfeo_hp_dpotrf_mt_task *task)
+	{
+
+	int m = arg->m;
+	int upper = arg->upper;
+	struct blasfeo_dmat *sC = arg->sC;
+	int ci = arg->ci;
+	int cj = arg->cj;
+	struct blasfeo_dmat *sD = arg->sD;
+	int di = arg->di;
+	int dj = arg->dj;
+
+	const int nb = POTRF_MT_NB;
+
+	int ii = task->ii;
+	int jj = task->jj;
+	int k0 = task->k0;
+	int k1 = task->k1;
+
+	int i0 = ii*nb;
+	int j0 = jj*nb;
+	int mi = m-i0<nb ? m-i0 : nb;
+	int nj = m-j0<nb ? m-j0 : nb;
+	int kk = (k1-k0)*nb;
+
+	// the tile is read from C until the first operation, and from D after that
+	struct blasfeo_dmat *sS = k0==0 ? sC : sD;
+	int si = k0==0 ? ci : di;
+	int sj = k0==0 ? cj : dj;
+
+	if(upper==0)
+		{
+		if(k0<k1) // trailing update
+			{
+			if(ii==jj)
+				blasfeo_hp_dsyrk3_ln(mi, kk, -1.0, sD, di+i0, dj+k0*nb, 1.0, sS, si+i0, sj+j0, sD, di+i0, dj+j0);
+			else
+				blasfeo_hp_dgemm_nt(mi, nj, kk, -1.0, sD, di+i0, dj+k0*nb, sD, di+j0, dj+k0*nb, 1.0, sS, si+i0, sj+j0, sD, di+i0, dj+j0);
+			}
+		else // factorization
+			{
+			if(ii==jj)
+				blasfeo_hp_dpotrf_l(mi, sS, si+i0, sj+j0, sD, di+i0, dj+j0);
+			else
+				blasfeo_hp_dtrsm_rltn(mi, nj, 1.0, sD, di+j0, dj+j0, sS, si+i0, sj+j0, sD, di+i0, dj+j0);
+			}
+		}
+	else
+		{
+		// tile (jj,ii) of the upper triangle
+		if(k0<k1) // trailing update
+			{
+			if(ii==jj)
+				blasfeo_hp_dsyrk3_ut(mi, kk, -1.0, sD, di+k0*nb, dj+i0, 1.0, sS, si+j0, sj+i0, sD, di+j0, dj+i0);
+			else
+				blasfeo_hp_dgemm_tn(nj, mi, kk, -1.0, sD, di+k0*nb, dj+j0, sD, di+k0*nb, dj+i0, 1.0, sS, si+j0, sj+i0, sD, di+j0, dj+i0);
+			}
+		else // factorization
+			{
+			if(ii==jj)
+				blasfeo_hp_dpotrf_u(mi, sS, si+j0, sj+i0, sD, di+j0, dj+i0);
+			else
+				blasfeo_hp_dtrsm_lutn(nj, mi, 1.0, sD, di+j0, dj+j0, sS, si+j0, sj+i0, sD, di+j0, dj+i0);
+			}
+		}
+
+	return;
+
+	}
+
+
+
+static void blasfeo_hp_dpotrf_mt_work(int tid, int nth, void *ptr)
+	{
+
+	struct blasfeo_hp_dpotrf_mt_arg *arg = ptr;
+
+	struct blasfeo_hp_dpotrf_mt_task task;
+	struct blasfeo_work prev;
+	int idx;
+
+	int nt = arg->nt;
+	int n_tiles = nt*(nt+1)/2;
+
+	// the workspace state is thread-local: each thread takes its nested allocations from its own slot
+	blasfeo_work_begin(arg->work+tid*arg->slotsize, arg->slotsize, &prev);
+
+	pthread_mutex_lock(&arg->mutex);
+	while(arg->n_done<n_tiles)
+		{
+		if(blasfeo_hp_dpotrf_mt_next(arg, &task)==0)
+			{
+			pthread_cond_wait(&arg->cond, &arg->mutex);
+			continue;
+			}
+		pthread_mutex_unlock(&arg->mutex);
+
+		blasfeo_hp_dpotrf_mt_run(arg, &task);
+
+		pthread_mutex_lock(&arg->mutex);
+		idx = POTRF_MT_IDX(task.ii, task.jj);
+		arg->busy[idx] = 0;
+		if(task.k0<task.k1)
+			{
+			arg->upd[idx] = task.k1;
+			}
+		else
+			{
+			arg->done[idx] = 1;
+			arg->n_done++;
+			}
+		pthread_cond_broadcast(&arg->cond);
+		}
+	pthread_mutex_unlock(&arg->mutex);
+
+	blasfeo_work_end(&prev);
+
+	return;
+
+	}
+
+
+
+// workspace slot of each thread, sized for the nested routines called on a tile
+static size_t blasfeo_hp_dpotrf_mt_slotsize(int upper, int m)
+	{
+
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+
+	size_t size, tmp;
+
+	int nb = POTRF_MT_NB;
+
+	if(upper==0)
+		{
+		size = blasfeo_hp_dgemm_nt_worksize(nb, nb, m);
+		tmp = blasfeo_hp_dsyrk3_ln_worksize(nb, m);
+		size = tmp>size ? tmp : size;
+		tmp = blasfeo_hp_dtrsm_rltn_worksize(nb, nb);
+		size = tmp>size ? tmp : size;
+		tmp = blasfeo_hp_dpotrf_l_worksize(nb);
+		size = tmp>size ? tmp : size;
+		}
+	else
+		{
+		size = blasfeo_hp_dgemm_tn_worksize(nb, nb, m);
+		tmp = blasfeo_hp_dsyrk3_ut_worksize(nb, m);
+		size = tmp>size ? tmp : size;
+		tmp = blasfeo_hp_dtrsm_lutn_worksize(nb, nb);
+		size = tmp>size ? tmp : size;
+		tmp = blasfeo_hp_dpotrf_u_worksize(nb);
+		size = tmp>size ? tmp : size;
+		}
+
+	// the buffer of blasfeo_init is only available to the calling thread
+	if(blasfeo_is_init_block_size(&bs))
+		size += blasfeo_work_memsize(blasfeo_memsize_buffer_block_size(&bs));
+
+	return (size+63)/64*64;
+
+	}
+
+
+
+// tiled right-looking alg, with the tasks scheduled dynamically as their dependencies are met
+static void blasfeo_hp_dpotrf_mt(int upper, int nth, int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	struct blasfeo_hp_dpotrf_mt_arg arg;
+	void *mem, *mem_work;
+	int ii;
+
+	int nt = (m+POTRF_MT_NB-1)/POTRF_MT_NB;
+	int n_tiles = nt*(nt+1)/2;
+
+	size_t slotsize = blasfeo_hp_dpotrf_mt_slotsize(upper, m);
+
+	blasfeo_work_malloc(&mem, 3*n_tiles*sizeof(int));
+	blasfeo_work_malloc(&mem_work, nth*slotsize);
+
+	arg.upper = upper;
+	arg.m = m;
+	arg.nt = nt;
+	arg.sC = sC;
+	arg.ci = ci;
+	arg.cj = cj;
+	arg.sD = sD;
+	arg.di = di;
+	arg.dj = dj;
+	arg.upd = (int *) mem;
+	arg.busy = arg.upd + n_tiles;
+	arg.done = arg.busy + n_tiles;
+	for(ii=0; ii<3*n_tiles; ii++)
+		arg.upd[ii] = 0;
+	arg.n_done = 0;
+	arg.work = (char *) mem_work;
+	arg.slotsize = slotsize;
+	pthread_mutex_init(&arg.mutex, NULL);
+	pthread_cond_init(&arg.cond, NULL);
+
+	blasfeo_parallel_run(nth, &blasfeo_hp_dpotrf_mt_work, &arg);
+
+	pthread_cond_destroy(&arg.cond);
+	pthread_mutex_destroy(&arg.mutex);
+	blasfeo_work_free(mem_work);
+	blasfeo_work_free(mem);
+
+	return;
+
+	}
+
+
+
+// number of threads used by the multi-threaded alg: at least two tiles per thread in the trailing matrix,
+// and the sequential alg for small matrices
+static int blasfeo_hp_dpotrf_mt_nth(int m)
+	{
+	int nth = blasfeo_get_num_threads_flops(1.0/3.0*m*m*m);
+	int nt = (m+POTRF_MT_NB-1)/POTRF_MT_NB;
+	if(nt<3)
+		return 1;
+	int nth_max = (nt-1)*nt/4;
+	return nth<nth_max ? nth : nth_max;
+	}
+
+
+
+static size_t blasfeo_hp_dpotrf_mt_worksize(int upper, int m)
+	{
+
+	int nb = POTRF_MT_NB;
+	int nt = (m+nb-1)/nb;
+	int n_tiles = nt*(nt+1)/2;
+	int nth = blasfeo_hp_dpotrf_mt_nth(m);
+
+	return blasfeo_work_memsize(3*n_tiles*sizeof(int)) + blasfeo_work_memsize(nth*blasfeo_hp_dpotrf_mt_slotsize(upper, m));
+
+	}
+
+
+
+#endif // MULTI_THREAD
+
+
+
 void blasfeo_hp_dpotrf_l(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
@@ -562,6 +945,9 @@ void blasfeo_hp_dpotrf_l(int m, struct blasfeo_dmat *sC, int ci, int cj, struct
 	if(m<=0)
 		return;
 
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+
 	// extract pointer to column-major matrices from structures
 	int ldc = sC->m;
 	int ldd = sD->m;
@@ -625,6 +1011,15 @@ void blasfeo_hp_dpotrf_l(int m, struct blasfeo_dmat *sC, int ci, int cj, struct
 	double d_1 = 1.0;
 	double d_m1 = -1.0;
 
+#if defined(MULTI_THREAD)
+	int nth = blasfeo_hp_dpotrf_mt_nth(m);
+	if(nth>1)
+		{
+		blasfeo_hp_dpotrf_mt(0, nth, m, sC, ci, cj, sD, di, dj);
+		return;
+		}
+#endif
+
 
 //	goto l_1;
 	goto l_2;
@@ -767,9 +1162,9 @@ l_2:
 
 	// cache blocking alg
 
-	mc0 = MC;
-	nc0 = NC;
-	kc0 = KC;
+	mc0 = bs.d_mc;
+	nc0 = bs.d_nc;
+	kc0 = bs.d_kc;
 
 	// these must all be multiple of ps !!!
 //	mc0 = 12;
@@ -786,9 +1181,9 @@ l_2:
 	tB_size = blasfeo_pm_memsize_dmat(ps, nc0, kc0);
 	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(&bs)==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+2*4096);
 		}
 	else
 		{
@@ -820,33 +1215,47 @@ l_2:
 			sda = (kleft+4-1)/4*4; // XXX
 			sdb = (kleft+4-1)/4*4; // XXX
 
-			blasfeo_hp_dpotrf_l_mn_m2(mleft-ll, kleft, C+ii+ll+(ii+ll)*ldc, ldc, D+ii+ll+(ii+ll)*ldd, ldd, pA, dA, sda);
+			// the trailing matrix has already been updated into D, unless in the first block
+			C1 = ii==0 & ll==0 ? C : D;
+			ldc1 = ii==0 & ll==0 ? ldc : ldd;
+
+			blasfeo_hp_dpotrf_l_mn_m2(mleft-ll, kleft, C1+ii+ll+(ii+ll)*ldc1, ldc1, D+ii+ll+(ii+ll)*ldd, ldd, pA, dA, sda);
 
 			for(jj=ll+kleft; jj<mleft; jj+=nleft)
 				{
 
 				nleft = mleft-jj<nc ? mleft-jj : nc;
 
-				blasfeo_hp_dsyrk_ln_mn_m2(mleft-jj, nleft, kleft, d_m1, pA+(jj-ll)*sda, sda, pA+(jj-ll)*sda, sda, d_1, C+ii+jj+(ii+jj)*ldc, ldc, D+ii+jj+(ii+jj)*ldd, ldd);
+				blasfeo_hp_dsyrk_ln_mn_m2(mleft-jj, nleft, kleft, d_m1, pA+(jj-ll)*sda, sda, pA+(jj-ll)*sda, sda, d_1, C1+ii+jj+(ii+jj)*ldc1, ldc1, D+ii+jj+(ii+jj)*ldd, ldd);
 
 				}
 
 			}
 
-		blasfeo_hp_dtrsm_rltn(m-ii-mleft, mleft, 1.0, sD, di+ii, dj+ii, sC, ci+ii+mleft, cj+ii, sD, di+ii+mleft, dj+ii);
-
-		blasfeo_hp_dsyrk3_ln(m-ii-mleft, mleft, -1.0, sD, di+ii+mleft, dj+ii, 1.0, sC, ci+ii+mleft, cj+ii+mleft, sD, di+ii+mleft, dj+ii+mleft);
+		if(ii==0)
+			{
+			blasfeo_hp_dtrsm_rltn(m-ii-mleft, mleft, 1.0, sD, di+ii, dj+ii, sC, ci+ii+mleft, cj+ii, sD, di+ii+mleft, dj+ii);
+			blasfeo_hp_dsyrk3_ln(m-ii-mleft, mleft, -1.0, sD, di+ii+mleft, dj+ii, 1.0, sC, ci+ii+mleft, cj+ii+mleft, sD, di+ii+mleft, dj+ii+mleft);
+			}
+		else
+			{
+			blasfeo_hp_dtrsm_rltn(m-ii-mleft, mleft, 1.0, sD, di+ii, dj+ii, sD, di+ii+mleft, dj+ii, sD, di+ii+mleft, dj+ii);
+			blasfeo_hp_dsyrk3_ln(m-ii-mleft, mleft, -1.0, sD, di+ii+mleft, dj+ii, 1.0, sD, di+ii+mleft, dj+ii+mleft, sD, di+ii+mleft, dj+ii+mleft);
+			}
 
 		}
 
-	free(mem);
+	if(blasfeo_is_init_block_size(&bs)==0)
+		{
+		blasfeo_work_free(mem);
+		}
 	return;
 
 #else
 
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	mem = malloc(tA_size+64);
+	blasfeo_work_malloc(&mem, tA_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tA, (void *) mem_align);
 
@@ -981,7 +1390,7 @@ l_2_left_4:
 	goto l_2_return;
 
 l_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 #endif
@@ -993,7 +1402,52 @@ l_2_return:
 
 
 
-void blasfeo_hp_dpotrf_u(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+// unpack the transpose of the lower triangle of a 4x4 panel-major block into the upper triangle of
+// the (m1)x(m1) diagonal block of D, leaving its strictly lower part untouched
+static void blasfeo_hp_dpotrf_u_unpack_diag(int m1, double *pA, double *D, int ldd)
+	{
+
+	const int ps = 4;
+
+	int ii, jj;
+
+	m1 = m1<4 ? m1 : 4;
+	for(jj=0; jj<m1; jj++)
+		{
+		for(ii=0; ii<=jj; ii++)
+			{
+			D[ii+jj*ldd] = pA[jj+ii*ps];
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// size-based choice between the u_2 and u_1 code paths of blasfeo_hp_dpotrf_u: nonzero selects u_2
+static int blasfeo_hp_dpotrf_u_alg(int m)
+	{
+
+#if defined(TARGET_X64_INTEL_HASWELL)
+	if(m>=256 | m>K_MAX_STACK)
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(m>=64 | m>K_MAX_STACK)
+#else
+	if(m>=12 | m>K_MAX_STACK)
+#endif
+		{
+		return 1;
+		}
+
+	return 0;
+
+	}
+
+
+
+static void blasfeo_hp_dpotrf_u_run(int alg, int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
 #if defined(PRINT_NAME)
@@ -1050,16 +1504,19 @@ void blasfeo_hp_dpotrf_u(int m, struct blasfeo_dmat *sC, int ci, int cj, struct
 
 	double d_1 = 1.0;
 
+#if defined(MULTI_THREAD)
+	int nth = blasfeo_hp_dpotrf_mt_nth(m);
+	if(nth>1)
+		{
+		blasfeo_hp_dpotrf_mt(1, nth, m, sC, ci, cj, sD, di, dj);
+		return;
+		}
+#endif
+
 
 //	goto u_1;
 //	goto u_2;
-#if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=256 | m>K_MAX_STACK)
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | m>K_MAX_STACK)
-#else
-	if(m>=12 | m>K_MAX_STACK)
-#endif
+	if(alg)
 		{
 		goto u_2;
 		}
@@ -1094,7 +1551,7 @@ u_1:
 		kernel_dpack_tn_4_lib4(4, C+ii+(ii+4)*ldc, ldc, pD+4*4);
 		kernel_dpack_tn_4_lib4(4, C+ii+(ii+8)*ldc, ldc, pD+8*4);
 		kernel_dpotrf_nt_l_12x4_lib4(ii, pU, sdu, pU, pD, ps, pD, ps, dU+ii);
-		kernel_dunpack_nt_4_lib4(4, pD+0*4, D+ii+(ii+0)*ldd, ldd);
+		blasfeo_hp_dpotrf_u_unpack_diag(4, pD+0*4, D+ii+(ii+0)*ldd, ldd);
 		kernel_dunpack_nt_4_lib4(4, pD+4*4, D+ii+(ii+4)*ldd, ldd);
 		kernel_dunpack_nt_4_lib4(4, pD+8*4, D+ii+(ii+8)*ldd, ldd); // TODO unpack l !!!!!!!!!!!!!!!!
 
@@ -1106,21 +1563,21 @@ u_1:
 		kernel_dpack_tn_4_lib4(4, C+ii+4+(ii+8)*ldc, ldc, pD+8*4);
 		kernel_dpack_tn_4_lib4(4, C+ii+8+(ii+8)*ldc, ldc, pD+12*4);
 		kernel_dpotrf_nt_l_8x8_lib4(ii+4, pU+4*sdu, sdu, pU+4*sdu, sdu, pD, 8, pD, 8, dU+ii+4);
-		kernel_dunpack_nt_4_lib4(4, pD+0*4, D+ii+4+(ii+4)*ldd, ldd); // TODO unpack l !!!!!!!!!!!!!!!!
+		blasfeo_hp_dpotrf_u_unpack_diag(4, pD+0*4, D+ii+4+(ii+4)*ldd, ldd);
 		kernel_dunpack_nt_4_lib4(4, pD+8*4, D+ii+4+(ii+8)*ldd, ldd);
-		kernel_dunpack_nt_4_lib4(4, pD+12*4, D+ii+8+(ii+8)*ldd, ldd); // TODO unpack l !!!!!!!!!!!!!!!!
+		blasfeo_hp_dpotrf_u_unpack_diag(4, pD+12*4, D+ii+8+(ii+8)*ldd, ldd);
 #else
 		kernel_dpack_tn_4_lib4(4, C+ii+4+(ii+4)*ldc, ldc, pD+0*4);
 		kernel_dpack_tn_4_lib4(4, C+ii+4+(ii+8)*ldc, ldc, pD+4*4);
 		kernel_dpotrf_nt_l_8x4_lib4(ii+4, pU+4*sdu, sdu, pU+4*sdu, pD, ps, pD, ps, dU+ii+4);
-		kernel_dunpack_nt_4_lib4(4, pD+0*4, D+ii+4+(ii+4)*ldd, ldd);
+		blasfeo_hp_dpotrf_u_unpack_diag(4, pD+0*4, D+ii+4+(ii+4)*ldd, ldd);
 		kernel_dunpack_nt_4_lib4(4, pD+4*4, D+ii+4+(ii+8)*ldd, ldd); // TODO unpack l !!!!!!!!!!!!!!!!
 
 		kernel_dpack_tn_4_lib4(4, D+ii+4+(ii+8)*ldd, ldd, pU+8*sdu+(ii+4)*ps);
 
 		kernel_dpack_tn_4_lib4(4, C+ii+8+(ii+8)*ldc, ldc, pD);
 		kernel_dpotrf_nt_l_4x4_lib4(ii+8, pU+8*sdu, pU+8*sdu, pD, pD, dU+ii+8);
-		kernel_dunpack_nt_4_lib4(4, pD, D+ii+8+(ii+8)*ldd, ldd); // TODO unpack l !!!!!!!!!!!!!!!!
+		blasfeo_hp_dpotrf_u_unpack_diag(4, pD, D+ii+8+(ii+8)*ldd, ldd);
 #endif
 		}
 	if(ii<m)
@@ -1152,14 +1609,14 @@ u_1:
 		kernel_dpack_tn_4_lib4(4, C+ii+(ii+0)*ldc, ldc, pD+0*4);
 		kernel_dpack_tn_4_lib4(4, C+ii+(ii+4)*ldc, ldc, pD+4*4);
 		kernel_dpotrf_nt_l_8x4_lib4(ii, pU, sdu, pU, pD, ps, pD, ps, dU+ii);
-		kernel_dunpack_nt_4_lib4(4, pD+0*4, D+ii+(ii+0)*ldd, ldd);
+		blasfeo_hp_dpotrf_u_unpack_diag(4, pD+0*4, D+ii+(ii+0)*ldd, ldd);
 		kernel_dunpack_nt_4_lib4(4, pD+4*4, D+ii+(ii+4)*ldd, ldd); // TODO unpack l !!!!!!!!!!!!!!!!
 
 		kernel_dpack_tn_4_lib4(4, D+ii+(ii+4)*ldd, ldd, pU+4*sdu+ii*ps);
 
 		kernel_dpack_tn_4_lib4(4, C+ii+4+(ii+4)*ldc, ldc, pD);
 		kernel_dpotrf_nt_l_4x4_lib4(ii+4, pU+4*sdu, pU+4*sdu, pD, pD, dU+ii+4);
-		kernel_dunpack_nt_4_lib4(4, pD, D+ii+4+(ii+4)*ldd, ldd); // TODO unpack l !!!!!!!!!!!!!!!!
+		blasfeo_hp_dpotrf_u_unpack_diag(4, pD, D+ii+4+(ii+4)*ldd, ldd);
 		}
 	if(ii<m)
 		{
@@ -1183,7 +1640,7 @@ u_1:
 			}
 		kernel_dpack_tn_4_lib4(4, C+ii+ii*ldc, ldc, pD);
 		kernel_dpotrf_nt_l_4x4_lib4(ii, pU, pU, pD, pD, dU+ii);
-		kernel_dunpack_nt_4_lib4(4, pD, D+ii+ii*ldd, ldd); // TODO unpack l !!!!!!!!!!!!!!!!
+		blasfeo_hp_dpotrf_u_unpack_diag(4, pD, D+ii+ii*ldd, ldd);
 		}
 	if(ii<m)
 		{
@@ -1210,7 +1667,7 @@ u_1_left_12:
 	kernel_dpack_tn_4_lib4(4, C+ii+(ii+4)*ldc, ldc, pD+4*4);
 	kernel_dpack_tn_4_vs_lib4(4, C+ii+(ii+8)*ldc, ldc, pD+8*4, m-ii-8);
 	kernel_dpotrf_nt_l_12x4_vs_lib4(ii, pU, sdu, pU, pD, ps, pD, ps, dU+ii, m-ii, m-ii);
-	kernel_dunpack_nt_4_lib4(4, pD+0*4, D+ii+(ii+0)*ldd, ldd);
+	blasfeo_hp_dpotrf_u_unpack_diag(4, pD+0*4, D+ii+(ii+0)*ldd, ldd);
 	kernel_dunpack_nt_4_lib4(4, pD+4*4, D+ii+(ii+4)*ldd, ldd);
 	kernel_dunpack_nt_4_vs_lib4(4, pD+8*4, D+ii+(ii+8)*ldd, ldd, m-ii-8); // TODO pack vs with m and n, or triangle
 
@@ -1222,21 +1679,21 @@ u_1_left_12:
 	kernel_dpack_tn_4_vs_lib4(4, C+ii+4+(ii+8)*ldc, ldc, pD+8*4, m-ii-8);
 	kernel_dpack_tn_4_vs_lib4(4, C+ii+8+(ii+8)*ldc, ldc, pD+12*4, m-ii-8);
 	kernel_dpotrf_nt_l_8x8_vs_lib4(ii+4, pU+4*sdu, sdu, pU+4*sdu, sdu, pD, 8, pD, 8, dU+ii+4, m-ii-4, m-ii-4);
-	kernel_dunpack_nt_4_lib4(4, pD+0*4, D+ii+4+(ii+4)*ldd, ldd); // TODO pack vs with m and n, or triangle
+	blasfeo_hp_dpotrf_u_unpack_diag(4, pD+0*4, D+ii+4+(ii+4)*ldd, ldd);
 	kernel_dunpack_nt_4_vs_lib4(4, pD+8*4, D+ii+4+(ii+8)*ldd, ldd, m-ii-8);
-	kernel_dunpack_nt_4_vs_lib4(4, pD+12*4, D+ii+8+(ii+8)*ldd, ldd, m-ii-8); // TODO pack vs with m and n, or triangle
+	blasfeo_hp_dpotrf_u_unpack_diag(m-ii-8, pD+12*4, D+ii+8+(ii+8)*ldd, ldd);
 #else
 	kernel_dpack_tn_4_lib4(4, C+ii+4+(ii+4)*ldc, ldc, pD+0*4);
 	kernel_dpack_tn_4_vs_lib4(4, C+ii+4+(ii+8)*ldc, ldc, pD+4*4, m-ii-8);
 	kernel_dpotrf_nt_l_8x4_vs_lib4(ii+4, pU+4*sdu, sdu, pU+4*sdu, pD, ps, pD, ps, dU+ii+4, m-ii-4, m-ii-4);
-	kernel_dunpack_nt_4_lib4(4, pD+0*4, D+ii+4+(ii+4)*ldd, ldd);
+	blasfeo_hp_dpotrf_u_unpack_diag(4, pD+0*4, D+ii+4+(ii+4)*ldd, ldd);
 	kernel_dunpack_nt_4_vs_lib4(4, pD+4*4, D+ii+4+(ii+8)*ldd, ldd, m-ii-8); // TODO pack vs with m and n, or triangle
 
 	kernel_dpack_tn_4_lib4(4, D+ii+4+(ii+8)*ldd, ldd, pU+8*sdu+(ii+4)*ps);
 
 	kernel_dpack_tn_4_vs_lib4(4, C+ii+8+(ii+8)*ldc, ldc, pD, m-ii-8);
 	kernel_dpotrf_nt_l_4x4_vs_lib4(ii+8, pU+8*sdu, pU+8*sdu, pD, pD, dU+ii+8, m-ii-8, m-ii-8);
-	kernel_dunpack_nt_4_vs_lib4(4, pD, D+ii+8+(ii+8)*ldd, ldd, m-ii-8); // TODO pack vs with m and n, or triangle
+	blasfeo_hp_dpotrf_u_unpack_diag(m-ii-8, pD, D+ii+8+(ii+8)*ldd, ldd);
 #endif
 	goto u_1_return;
 #endif
@@ -1256,14 +1713,14 @@ u_1_left_8:
 	kernel_dpack_tn_4_lib4(4, C+ii+(ii+0)*ldc, ldc, pD+0*4);
 	kernel_dpack_tn_4_vs_lib4(4, C+ii+(ii+4)*ldc, ldc, pD+4*4, m-ii-4);
 	kernel_dpotrf_nt_l_8x4_vs_lib4(ii, pU, sdu, pU, pD, ps, pD, ps, dU+ii, m-ii, m-ii);
-	kernel_dunpack_nt_4_lib4(4, pD+0*4, D+ii+(ii+0)*ldd, ldd);
+	blasfeo_hp_dpotrf_u_unpack_diag(4, pD+0*4, D+ii+(ii+0)*ldd, ldd);
 	kernel_dunpack_nt_4_vs_lib4(4, pD+4*4, D+ii+(ii+4)*ldd, ldd, m-ii-4);
 
 	kernel_dpack_tn_4_lib4(4, D+ii+(ii+4)*ldd, ldd, pU+4*sdu+ii*ps);
 
 	kernel_dpack_tn_4_vs_lib4(4, C+ii+4+(ii+4)*ldc, ldc, pD, m-ii-4); // TODO pack vs with m and n, or triangle
 	kernel_dpotrf_nt_l_4x4_vs_lib4(ii+4, pU+4*sdu, pU+4*sdu, pD, pD, dU+ii+4, m-ii-4, m-ii-4);
-	kernel_dunpack_nt_4_vs_lib4(4, pD, D+ii+4+(ii+4)*ldd, ldd, m-ii-4); // TODO pack vs with m and n, or triangle
+	blasfeo_hp_dpotrf_u_unpack_diag(m-ii-4, pD, D+ii+4+(ii+4)*ldd, ldd);
 	goto u_1_return;
 #endif
 
@@ -1276,7 +1733,7 @@ u_1_left_4:
 		}
 	kernel_dpack_tn_4_vs_lib4(4, C+ii+ii*ldc, ldc, pD, m-ii); // TODO pack vs with m and n, or triangle
 	kernel_dpotrf_nt_l_4x4_vs_lib4(ii, pU, pU, pD, pD, dU+ii, m-ii, m-ii);
-	kernel_dunpack_nt_4_vs_lib4(4, pD, D+ii+ii*ldd, ldd, m-ii); // TODO pack vs with m and n, or triangle
+	blasfeo_hp_dpotrf_u_unpack_diag(m-ii, pD, D+ii+ii*ldd, ldd);
 	goto u_1_return;
 
 u_1_return:
@@ -1289,7 +1746,7 @@ u_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
 //	tA_size = blasfeo_memsize_dmat(m, m);
-	mem = malloc(tA_size+64);
+	blasfeo_work_malloc(&mem, tA_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tA, (void *) mem_align);
 
@@ -1314,7 +1771,7 @@ u_2:
 		kernel_dpack_tn_4_lib4(4, C+ii+(ii+4)*ldc, ldc, tA.pA+(ii+4)*sda+ii*ps);
 		kernel_dpack_tn_4_lib4(4, C+ii+(ii+8)*ldc, ldc, tA.pA+(ii+8)*sda+ii*ps);
 		kernel_dpotrf_nt_l_12x4_lib4(ii, tA.pA+ii*sda, sda, tA.pA+ii*sda, tA.pA+ii*sda+ii*ps, sda, tA.pA+ii*sda+ii*ps, sda, dA+ii);
-		kernel_dunpack_nt_4_lib4(4, tA.pA+(ii+0)*sda+ii*ps, D+ii+(ii+0)*ldd, ldd);
+		blasfeo_hp_dpotrf_u_unpack_diag(4, tA.pA+(ii+0)*sda+ii*ps, D+ii+(ii+0)*ldd, ldd);
 		kernel_dunpack_nt_4_lib4(4, tA.pA+(ii+4)*sda+ii*ps, D+ii+(ii+4)*ldd, ldd);
 		kernel_dunpack_nt_4_lib4(4, tA.pA+(ii+8)*sda+ii*ps, D+ii+(ii+8)*ldd, ldd);
 		kernel_dpack_tn_4_lib4(4, C+ii+4+(ii+4)*ldc, ldc, tA.pA+(ii+4)*sda+(ii+4)*ps);
@@ -1322,16 +1779,16 @@ u_2:
 #if defined(TARGET_X64_INTEL_HASWELL)
 		kernel_dpack_tn_4_lib4(4, C+ii+8+(ii+8)*ldc, ldc, tA.pA+(ii+8)*sda+(ii+8)*ps);
 		kernel_dpotrf_nt_l_8x8_lib4(ii+4, tA.pA+(ii+4)*sda, sda, tA.pA+(ii+4)*sda, sda, tA.pA+(ii+4)*sda+(ii+4)*ps, sda, tA.pA+(ii+4)*sda+(ii+4)*ps, sda, dA+ii+4);
-		kernel_dunpack_nt_4_lib4(4, tA.pA+(ii+4)*sda+(ii+4)*ps, D+ii+4+(ii+4)*ldd, ldd);
+		blasfeo_hp_dpotrf_u_unpack_diag(4, tA.pA+(ii+4)*sda+(ii+4)*ps, D+ii+4+(ii+4)*ldd, ldd);
 		kernel_dunpack_nt_4_lib4(4, tA.pA+(ii+8)*sda+(ii+4)*ps, D+ii+4+(ii+8)*ldd, ldd);
-		kernel_dunpack_nt_4_lib4(4, tA.pA+(ii+8)*sda+(ii+8)*ps, D+ii+8+(ii+8)*ldd, ldd);
+		blasfeo_hp_dpotrf_u_unpack_diag(4, tA.pA+(ii+8)*sda+(ii+8)*ps, D+ii+8+(ii+8)*ldd, ldd);
 #else
 		kernel_dpotrf_nt_l_8x4_lib4(ii+4, tA.pA+(ii+4)*sda, sda, tA.pA+(ii+4)*sda, tA.pA+(ii+4)*sda+(ii+4)*ps, sda, tA.pA+(ii+4)*sda+(ii+4)*ps, sda, dA+ii+4);
-		kernel_dunpack_nt_4_lib4(4, tA.pA+(ii+4)*sda+(ii+4)*ps, D+ii+4+(ii+4)*ldd, ldd);
+		blasfeo_hp_dpotrf_u_unpack_diag(4, tA.pA+(ii+4)*sda+(ii+4)*ps, D+ii+4+(ii+4)*ldd, ldd);
 		kernel_dunpack_nt_4_lib4(4, tA.pA+(ii+8)*sda+(ii+4)*ps, D+ii+4+(ii+8)*ldd, ldd);
 		kernel_dpack_tn_4_lib4(4, C+ii+8+(ii+8)*ldc, ldc, tA.pA+(ii+8)*sda+(ii+8)*ps);
 		kernel_dpotrf_nt_l_4x4_lib4(ii+8, tA.pA+(ii+8)*sda, tA.pA+(ii+8)*sda, tA.pA+(ii+8)*sda+(ii+8)*ps, tA.pA+(ii+8)*sda+(ii+8)*ps, dA+ii+8);
-		kernel_dunpack_nt_4_lib4(4, tA.pA+(ii+8)*sda+(ii+8)*ps, D+ii+8+(ii+8)*ldd, ldd);
+		blasfeo_hp_dpotrf_u_unpack_diag(4, tA.pA+(ii+8)*sda+(ii+8)*ps, D+ii+8+(ii+8)*ldd, ldd);
 #endif
 		}
 	if(ii<m)
@@ -1363,11 +1820,11 @@ u_2:
 		kernel_dpack_tn_4_lib4(4, C+ii+(ii+0)*ldc, ldc, tA.pA+(ii+0)*sda+ii*ps);
 		kernel_dpack_tn_4_lib4(4, C+ii+(ii+4)*ldc, ldc, tA.pA+(ii+4)*sda+ii*ps);
 		kernel_dpotrf_nt_l_8x4_lib4(ii, tA.pA+ii*sda, sda, tA.pA+ii*sda, tA.pA+ii*sda+ii*ps, sda, tA.pA+ii*sda+ii*ps, sda, dA+ii);
-		kernel_dunpack_nt_4_lib4(4, tA.pA+(ii+0)*sda+ii*ps, D+ii+(ii+0)*ldd, ldd);
+		blasfeo_hp_dpotrf_u_unpack_diag(4, tA.pA+(ii+0)*sda+ii*ps, D+ii+(ii+0)*ldd, ldd);
 		kernel_dunpack_nt_4_lib4(4, tA.pA+(ii+4)*sda+ii*ps, D+ii+(ii+4)*ldd, ldd);
 		kernel_dpack_tn_4_lib4(4, C+ii+4+(ii+4)*ldc, ldc, tA.pA+(ii+4)*sda+(ii+4)*ps);
 		kernel_dpotrf_nt_l_4x4_lib4(ii+4, tA.pA+(ii+4)*sda, tA.pA+(ii+4)*sda, tA.pA+(ii+4)*sda+(ii+4)*ps, tA.pA+(ii+4)*sda+(ii+4)*ps, dA+ii+4);
-		kernel_dunpack_nt_4_lib4(4, tA.pA+(ii+4)*sda+(ii+4)*ps, D+ii+4+(ii+4)*ldd, ldd);
+		blasfeo_hp_dpotrf_u_unpack_diag(4, tA.pA+(ii+4)*sda+(ii+4)*ps, D+ii+4+(ii+4)*ldd, ldd);
 		}
 	if(ii<m)
 		{
@@ -1391,7 +1848,7 @@ u_2:
 			}
 		kernel_dpack_tn_4_lib4(4, C+ii+ii*ldc, ldc, tA.pA+ii*sda+ii*ps);
 		kernel_dpotrf_nt_l_4x4_lib4(ii, tA.pA+ii*sda, tA.pA+ii*sda, tA.pA+ii*sda+ii*ps, tA.pA+ii*sda+ii*ps, dA+ii);
-		kernel_dunpack_nt_4_lib4(4, tA.pA+ii*sda+ii*ps, D+ii+ii*ldd, ldd);
+		blasfeo_hp_dpotrf_u_unpack_diag(4, tA.pA+ii*sda+ii*ps, D+ii+ii*ldd, ldd);
 		}
 	if(ii<m)
 		{
@@ -1416,7 +1873,7 @@ u_2_left_12:
 	kernel_dpack_tn_4_lib4(4, C+ii+(ii+4)*ldc, ldc, tA.pA+(ii+4)*sda+ii*ps);
 	kernel_dpack_tn_4_vs_lib4(4, C+ii+(ii+8)*ldc, ldc, tA.pA+(ii+8)*sda+ii*ps, m-ii-8);
 	kernel_dpotrf_nt_l_12x4_vs_lib4(ii, tA.pA+ii*sda, sda, tA.pA+ii*sda, tA.pA+ii*sda+ii*ps, sda, tA.pA+ii*sda+ii*ps, sda, dA+ii, m-ii, m-ii);
-	kernel_dunpack_nt_4_lib4(4, tA.pA+(ii+0)*sda+ii*ps, D+ii+(ii+0)*ldd, ldd);
+	blasfeo_hp_dpotrf_u_unpack_diag(4, tA.pA+(ii+0)*sda+ii*ps, D+ii+(ii+0)*ldd, ldd);
 	kernel_dunpack_nt_4_lib4(4, tA.pA+(ii+4)*sda+ii*ps, D+ii+(ii+4)*ldd, ldd);
 	kernel_dunpack_nt_4_vs_lib4(4, tA.pA+(ii+8)*sda+ii*ps, D+ii+(ii+8)*ldd, ldd, m-ii-8);
 	kernel_dpack_tn_4_lib4(4, C+ii+4+(ii+4)*ldc, ldc, tA.pA+(ii+4)*sda+(ii+4)*ps);
@@ -1424,16 +1881,16 @@ u_2_left_12:
 #if defined(TARGET_X64_INTEL_HASWELL)
 	kernel_dpack_tn_4_vs_lib4(4, C+ii+8+(ii+8)*ldc, ldc, tA.pA+(ii+8)*sda+(ii+8)*ps, m-ii-8); // TODO triangle
 	kernel_dpotrf_nt_l_8x8_vs_lib4(ii+4, tA.pA+(ii+4)*sda, sda, tA.pA+(ii+4)*sda, sda, tA.pA+(ii+4)*sda+(ii+4)*ps, sda, tA.pA+(ii+4)*sda+(ii+4)*ps, sda, dA+ii+4, m-ii-4, m-ii-4);
-	kernel_dunpack_nt_4_lib4(4, tA.pA+(ii+4)*sda+(ii+4)*ps, D+ii+4+(ii+4)*ldd, ldd);
+	blasfeo_hp_dpotrf_u_unpack_diag(4, tA.pA+(ii+4)*sda+(ii+4)*ps, D+ii+4+(ii+4)*ldd, ldd);
 	kernel_dunpack_nt_4_vs_lib4(4, tA.pA+(ii+8)*sda+(ii+4)*ps, D+ii+4+(ii+8)*ldd, ldd, m-ii-8);
-	kernel_dunpack_nt_4_vs_lib4(4, tA.pA+(ii+8)*sda+(ii+8)*ps, D+ii+8+(ii+8)*ldd, ldd, m-ii-8); // TODO triangle
+	blasfeo_hp_dpotrf_u_unpack_diag(m-ii-8, tA.pA+(ii+8)*sda+(ii+8)*ps, D+ii+8+(ii+8)*ldd, ldd);
 #else
 	kernel_dpotrf_nt_l_8x4_vs_lib4(ii+4, tA.pA+(ii+4)*sda, sda, tA.pA+(ii+4)*sda, tA.pA+(ii+4)*sda+(ii+4)*ps, sda, tA.pA+(ii+4)*sda+(ii+4)*ps, sda, dA+ii+4, m-ii-4, m-ii-4);
-	kernel_dunpack_nt_4_lib4(4, tA.pA+(ii+4)*sda+(ii+4)*ps, D+ii+4+(ii+4)*ldd, ldd);
+	blasfeo_hp_dpotrf_u_unpack_diag(4, tA.pA+(ii+4)*sda+(ii+4)*ps, D+ii+4+(ii+4)*ldd, ldd);
 	kernel_dunpack_nt_4_vs_lib4(4, tA.pA+(ii+8)*sda+(ii+4)*ps, D+ii+4+(ii+8)*ldd, ldd, m-ii-8);
 	kernel_dpack_tn_4_vs_lib4(4, C+ii+8+(ii+8)*ldc, ldc, tA.pA+(ii+8)*sda+(ii+8)*ps, m-ii-8); // TODO triangle
 	kernel_dpotrf_nt_l_4x4_vs_lib4(ii+8, tA.pA+(ii+8)*sda, tA.pA+(ii+8)*sda, tA.pA+(ii+8)*sda+(ii+8)*ps, tA.pA+(ii+8)*sda+(ii+8)*ps, dA+ii+8, m-ii-8, m-ii-8);
-	kernel_dunpack_nt_4_vs_lib4(4, tA.pA+(ii+8)*sda+(ii+8)*ps, D+ii+8+(ii+8)*ldd, ldd, m-ii-8); // TODO triangle
+	blasfeo_hp_dpotrf_u_unpack_diag(m-ii-8, tA.pA+(ii+8)*sda+(ii+8)*ps, D+ii+8+(ii+8)*ldd, ldd);
 #endif
 	goto u_2_return;
 #endif
@@ -1451,11 +1908,11 @@ u_2_left_8:
 	kernel_dpack_tn_4_lib4(4, C+ii+(ii+0)*ldc, ldc, tA.pA+(ii+0)*sda+ii*ps);
 	kernel_dpack_tn_4_vs_lib4(4, C+ii+(ii+4)*ldc, ldc, tA.pA+(ii+4)*sda+ii*ps, m-ii-4);
 	kernel_dpotrf_nt_l_8x4_vs_lib4(ii, tA.pA+ii*sda, sda, tA.pA+ii*sda, tA.pA+ii*sda+ii*ps, sda, tA.pA+ii*sda+ii*ps, sda, dA+ii, m-ii, m-ii);
-	kernel_dunpack_nt_4_lib4(4, tA.pA+(ii+0)*sda+ii*ps, D+ii+(ii+0)*ldd, ldd);
+	blasfeo_hp_dpotrf_u_unpack_diag(4, tA.pA+(ii+0)*sda+ii*ps, D+ii+(ii+0)*ldd, ldd);
 	kernel_dunpack_nt_4_vs_lib4(4, tA.pA+(ii+4)*sda+ii*ps, D+ii+(ii+4)*ldd, ldd, m-ii-4);
 	kernel_dpack_tn_4_vs_lib4(4, C+ii+4+(ii+4)*ldc, ldc, tA.pA+(ii+4)*sda+(ii+4)*ps, m-ii-4); // TODO triangle
 	kernel_dpotrf_nt_l_4x4_vs_lib4(ii+4, tA.pA+(ii+4)*sda, tA.pA+(ii+4)*sda, tA.pA+(ii+4)*sda+(ii+4)*ps, tA.pA+(ii+4)*sda+(ii+4)*ps, dA+ii+4, m-ii-4, m-ii-4);
-	kernel_dunpack_nt_4_vs_lib4(4, tA.pA+(ii+4)*sda+(ii+4)*ps, D+ii+4+(ii+4)*ldd, ldd, m-ii-4); // TODO triangle
+	blasfeo_hp_dpotrf_u_unpack_diag(m-ii-4, tA.pA+(ii+4)*sda+(ii+4)*ps, D+ii+4+(ii+4)*ldd, ldd);
 	goto u_2_return;
 #endif
 
@@ -1468,11 +1925,11 @@ u_2_left_4:
 		}
 	kernel_dpack_tn_4_vs_lib4(4, C+ii+ii*ldc, ldc, tA.pA+ii*sda+ii*ps, m-ii); // TODO triangle
 	kernel_dpotrf_nt_l_4x4_vs_lib4(ii, tA.pA+ii*sda, tA.pA+ii*sda, tA.pA+ii*sda+ii*ps, tA.pA+ii*sda+ii*ps, dA+ii, m-ii, m-ii);
-	kernel_dunpack_nt_4_vs_lib4(4, tA.pA+ii*sda+ii*ps, D+ii+ii*ldd, ldd, m-ii); // TODO triangle
+	blasfeo_hp_dpotrf_u_unpack_diag(m-ii, tA.pA+ii*sda+ii*ps, D+ii+ii*ldd, ldd);
 	goto u_2_return;
 
 u_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -1483,7 +1940,37 @@ u_2_return:
 
 
 
-void blasfeo_hp_dpotrf_l_mn(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+void blasfeo_hp_dpotrf_u(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	blasfeo_hp_dpotrf_u_run(blasfeo_hp_dpotrf_u_alg(m), m, sC, ci, cj, sD, di, dj);
+
+	}
+
+
+
+// size-based choice between the l_1 and l_0 code paths of blasfeo_hp_dpotrf_l_mn: nonzero selects l_1
+static int blasfeo_hp_dpotrf_l_mn_alg(int m)
+	{
+
+#if defined(TARGET_X64_INTEL_HASWELL)
+	if(m>=200 | m>K_MAX_STACK)
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(m>=64 | m>K_MAX_STACK)
+#else
+	if(m>=12 | m>K_MAX_STACK)
+#endif
+		{
+		return 1;
+		}
+
+	return 0;
+
+	}
+
+
+
+static void blasfeo_hp_dpotrf_l_mn_run(int alg, int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
 #if defined(PRINT_NAME)
@@ -1542,13 +2029,7 @@ void blasfeo_hp_dpotrf_l_mn(int m, int n, struct blasfeo_dmat *sC, int ci, int c
 
 //	goto l_0;
 //	goto l_1;
-#if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=200 | m>K_MAX_STACK)
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | m>K_MAX_STACK)
-#else
-	if(m>=12 | m>K_MAX_STACK)
-#endif
+	if(alg)
 		{
 		goto l_1;
 		}
@@ -1815,7 +2296,7 @@ l_1:
 	m1 = (m+128-1)/128*128;
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, n1);
-	mem = malloc(tA_size+64);
+	blasfeo_work_malloc(&mem, tA_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, n, &tA, (void *) mem_align);
 
@@ -1824,7 +2305,7 @@ l_1:
 
 	blasfeo_hp_dpotrf_l_mn_m2(m, n, C, ldc, D, ldd, tA.pA, dA, sda);
 
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -1835,6 +2316,157 @@ l_1:
 
 
 
+void blasfeo_hp_dpotrf_l_mn(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	blasfeo_hp_dpotrf_l_mn_run(blasfeo_hp_dpotrf_l_mn_alg(m), m, n, sC, ci, cj, sD, di, dj);
+
+	}
+
+
+
+size_t blasfeo_hp_dpotrf_l_worksize(int m)
+	{
+
+	size_t size;
+#if ! defined(TARGET_X64_INTEL_SKYLAKE_X)
+	size_t tmp0, tmp1;
+#else
+	const int ps = 4; // XXX TODO fix once implemented missing kernels !!!
+	int m1;
+#endif
+
+	if(m<=0)
+		return 0;
+
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dpotrf_mt_nth(m)>1)
+		return blasfeo_hp_dpotrf_mt_worksize(0, m);
+#endif
+
+#if ! defined(TARGET_X64_INTEL_SKYLAKE_X)
+	// cache blocking alg, unless the buffer of blasfeo_init is used
+	size = blasfeo_is_init_block_size(&bs)==0 ? blasfeo_work_memsize(blasfeo_memsize_buffer_block_size(&bs)) : 0;
+	// nested trsm and syrk on the trailing matrix
+	tmp0 = blasfeo_hp_dtrsm_rltn_worksize(m, m);
+	tmp1 = blasfeo_hp_dsyrk3_ln_worksize(m, m);
+	size += tmp0>tmp1 ? tmp0 : tmp1;
+#else
+	m1 = (m+128-1)/128*128;
+	size = blasfeo_work_memsize(blasfeo_pm_memsize_dmat(ps, m1, m1)+64);
+#endif
+
+	return size;
+
+	}
+
+
+
+size_t blasfeo_hp_dpotrf_u_worksize(int m)
+	{
+
+	const int ps = 4; //D_PS;
+
+	int m1;
+
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dpotrf_mt_nth(m)>1)
+		return blasfeo_hp_dpotrf_mt_worksize(1, m);
+#endif
+
+	// small matrix
+	if(m<12 & m<=K_MAX_STACK)
+		return 0;
+
+	m1 = (m+128-1)/128*128;
+	return blasfeo_work_memsize(blasfeo_pm_memsize_dmat(ps, m1, m1)+64);
+
+	}
+
+
+
+size_t blasfeo_hp_dpotrf_l_mn_worksize(int m, int n)
+	{
+
+	const int ps = 4; //D_PS;
+
+	int m1, n1;
+
+	if(n<=0)
+		return 0;
+
+	// small matrix
+	if(m<12 & m<=K_MAX_STACK)
+		return 0;
+
+	m1 = (m+128-1)/128*128;
+	n1 = (n+128-1)/128*128;
+	return blasfeo_work_memsize(blasfeo_pm_memsize_dmat(ps, m1, n1)+64);
+
+	}
+
+
+
+// execution plan: the variant and the code path are resolved at plan creation for the given size and offsets;
+// only the upper variant has a size-dependent code path
+
+void blasfeo_hp_dpotrf_plan(char uplo, int m, int ci, int cj, int di, int dj, struct blasfeo_dplan *plan)
+	{
+
+	int upper;
+
+	if(uplo=='l' | uplo=='L')
+		{
+		upper = 0;
+		}
+	else if(uplo=='u' | uplo=='U')
+		{
+		upper = 1;
+		}
+	else
+		{
+		printf("\nerror: blasfeo_dpotrf_plan: wrong value of uplo %c\n", uplo);
+		exit(1);
+		}
+
+	plan->m = m;
+	plan->n = m;
+	plan->k = 0;
+	plan->ai = 0;
+	plan->aj = 0;
+	plan->bi = 0;
+	plan->bj = 0;
+	plan->ci = ci;
+	plan->cj = cj;
+	plan->di = di;
+	plan->dj = dj;
+
+	plan->var = upper;
+	plan->alg = upper ? blasfeo_hp_dpotrf_u_alg(m) : 0;
+
+	return;
+
+	}
+
+
+
+void blasfeo_hp_dpotrf_execute(struct blasfeo_dplan *plan, struct blasfeo_dmat *sC, struct blasfeo_dmat *sD)
+	{
+
+	if(plan->var==0)
+		blasfeo_hp_dpotrf_l(plan->m, sC, plan->ci, plan->cj, sD, plan->di, plan->dj);
+	else
+		blasfeo_hp_dpotrf_u_run(plan->alg, plan->m, sC, plan->ci, plan->cj, sD, plan->di, plan->dj);
+
+	return;
+
+	}
+
+
+
 #if defined(LA_HIGH_PERFORMANCE)
 
 
@@ -1860,5 +2492,70 @@ void blasfeo_dpotrf_l_mn(int m, int n, struct blasfeo_dmat *sC, int ci, int cj,
 
 
 
+size_t blasfeo_dpotrf_l_worksize(int m)
+	{
+	return blasfeo_hp_dpotrf_l_worksize(m);
+	}
+
+
+
+void blasfeo_dpotrf_l_ws(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dpotrf_l(m, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dpotrf_u_worksize(int m)
+	{
+	return blasfeo_hp_dpotrf_u_worksize(m);
+	}
+
+
+
+void blasfeo_dpotrf_u_ws(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dpotrf_u(m, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dpotrf_l_mn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dpotrf_l_mn_worksize(m, n);
+	}
+
+
+
+void blasfeo_dpotrf_l_mn_ws(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dpotrf_l_mn(m, n, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+void blasfeo_dpotrf_plan(char uplo, int m, int ci, int cj, int di, int dj, struct blasfeo_dplan *plan)
+	{
+	blasfeo_hp_dpotrf_plan(uplo, m, ci, cj, di, dj, plan);
+	}
+
+
+
+void blasfeo_dpotrf_execute(struct blasfeo_dplan *plan, struct blasfeo_dmat *sC, struct blasfeo_dmat *sD)
+	{
+	blasfeo_hp_dpotrf_execute(plan, sC, sD);
+	}
+
+
+
 #endif
 
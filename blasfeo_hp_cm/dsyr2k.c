@@ -61,16 +61,34 @@
 #define blasfeo_dsyr2k_lt blasfeo_cm_dsyr2k_lt
 #define blasfeo_dsyr2k_un blasfeo_cm_dsyr2k_un
 #define blasfeo_dsyr2k_ut blasfeo_cm_dsyr2k_ut
+#define blasfeo_hp_dsyr2k_ln_worksize blasfeo_hp_cm_dsyr2k_ln_worksize
+#define blasfeo_hp_dsyr2k_lt_worksize blasfeo_hp_cm_dsyr2k_lt_worksize
+#define blasfeo_hp_dsyr2k_un_worksize blasfeo_hp_cm_dsyr2k_un_worksize
+#define blasfeo_hp_dsyr2k_ut_worksize blasfeo_hp_cm_dsyr2k_ut_worksize
+#define blasfeo_dsyr2k_ln_worksize blasfeo_cm_dsyr2k_ln_worksize
+#define blasfeo_dsyr2k_lt_worksize blasfeo_cm_dsyr2k_lt_worksize
+#define blasfeo_dsyr2k_un_worksize blasfeo_cm_dsyr2k_un_worksize
+#define blasfeo_dsyr2k_ut_worksize blasfeo_cm_dsyr2k_ut_worksize
+#define blasfeo_dsyr2k_ln_ws blasfeo_cm_dsyr2k_ln_ws
+#define blasfeo_dsyr2k_lt_ws blasfeo_cm_dsyr2k_lt_ws
+#define blasfeo_dsyr2k_un_ws blasfeo_cm_dsyr2k_un_ws
+#define blasfeo_dsyr2k_ut_ws blasfeo_cm_dsyr2k_ut_ws
 
 #define blasfeo_dsyrk_ln blasfeo_cm_dsyrk_ln
 #define blasfeo_dsyrk_lt blasfeo_cm_dsyrk_lt
 #define blasfeo_dsyrk_un blasfeo_cm_dsyrk_un
 #define blasfeo_dsyrk_ut blasfeo_cm_dsyrk_ut
+#define blasfeo_dsyrk_lt_worksize blasfeo_cm_dsyrk_lt_worksize
+#define blasfeo_dsyrk_un_worksize blasfeo_cm_dsyrk_un_worksize
+#define blasfeo_dsyrk_ut_worksize blasfeo_cm_dsyrk_ut_worksize
 
 void blasfeo_cm_dsyrk_ln(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
 void blasfeo_cm_dsyrk_lt(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
 void blasfeo_cm_dsyrk_un(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
 void blasfeo_cm_dsyrk_ut(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+size_t blasfeo_cm_dsyrk_lt_worksize(int m, int k);
+size_t blasfeo_cm_dsyrk_un_worksize(int m, int k);
+size_t blasfeo_cm_dsyrk_ut_worksize(int m, int k);
 #endif
 
 
@@ -81,9 +99,6 @@ void blasfeo_cm_dsyrk_ut(int m, int k, double alpha, struct blasfeo_dmat *sA, in
 #define LLC_CACHE_EL D_LLC_CACHE_EL
 #define PS D_PS
 #define M_KERNEL D_M_KERNEL
-#define KC D_KC
-#define NC D_NC
-#define MC D_MC
 
 
 
@@ -466,6 +481,9 @@ void blasfeo_hp_dsyr2k_ln(int m, int k, double alpha, struct blasfeo_dmat *sA, i
 	if(m<=0)
 		return;
 
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldb = sB->m;
@@ -533,7 +551,7 @@ void blasfeo_hp_dsyr2k_ln(int m, int k, double alpha, struct blasfeo_dmat *sA, i
 	int m_a = m==lda ? m : m_cache;
 //	int n_b = n==ldb ? n : n_cache;
 	int n_b = m_a; // syrk: B=A
-	int k_block = K_MAX_STACK<KC ? K_MAX_STACK : KC;
+	int k_block = K_MAX_STACK<bs.d_kc ? K_MAX_STACK : bs.d_kc;
 	k_block = 2*k<=k_block ? 2*k : k_block; // m1 and n1 alg are blocked !!!
 
 	double d_1 = 1.0;
@@ -572,13 +590,13 @@ void blasfeo_hp_dsyr2k_ln(int m, int k, double alpha, struct blasfeo_dmat *sA, i
 ln_1:
 	// k-blocking alg
 
-	if(2*k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(2*k>K_MAX_STACK && bs.d_kc>K_MAX_STACK)
 		{
-		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		pU_size = M_KERNEL*bs.d_kc*sizeof(double);
+		blasfeo_work_malloc(&mem, pU_size+64);
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
-		sdu = KC;
+		sdu = bs.d_kc;
 		}
 	else
 		{
@@ -590,7 +608,7 @@ ln_1:
 	sdu = k4<sdu ? k4 : sdu;
 
 //	kc = 4;
-	kc = KC;
+	kc = bs.d_kc;
 
 	kcd2 = kc/2;
 
@@ -634,9 +652,9 @@ ln_1:
 
 		}
 
-	if(2*k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(2*k>K_MAX_STACK && bs.d_kc>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -648,9 +666,9 @@ ln_2:
 
 	// cache blocking alg
 
-	mc0 = MC;
-	nc0 = NC;
-	kc0 = KC;
+	mc0 = bs.d_mc;
+	nc0 = bs.d_nc;
+	kc0 = bs.d_kc;
 
 //	mc0 = 12;
 //	nc0 = 8;
@@ -674,9 +692,9 @@ ln_2:
 	tB_size = blasfeo_pm_memsize_dmat(ps, nc0, kc0);
 	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(&bs)==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+2*4096);
 		}
 	else
 		{
@@ -793,9 +811,9 @@ ln_2:
 
 		}
 
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(&bs)==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -805,7 +823,7 @@ ln_2:
 	k1 = (2*k+128-1)/128*128;
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, k1);
-	mem = malloc(tA_size+64);
+	blasfeo_work_malloc(&mem, tA_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, 2*k, &tA, (void *) mem_align);
 
@@ -820,7 +838,7 @@ ln_2:
 
 	blasfeo_hp_dsyr2k_ln_m2(m, k, alpha, pU, sdu, pU+k*ps, sdu, beta, C, ldc, D, ldd);
 
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 #endif
@@ -868,6 +886,85 @@ void blasfeo_hp_dsyr2k_ut(int m, int k, double alpha, struct blasfeo_dmat *sA, i
 
 
 
+// workspace size in bytes of the syr2k routine: upper bound over the algorithms that can be selected
+static size_t blasfeo_hp_dsyr2k_worksize(int m, int k)
+	{
+
+	size_t size = 0;
+	size_t tmp;
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+	const int ps = PS;
+	int k1, m1;
+#endif
+
+	if(m<=0)
+		return 0;
+
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+
+	// m1 alg: panel buffer on the heap if larger than the stack one
+	if(2*k>K_MAX_STACK && bs.d_kc>K_MAX_STACK)
+		{
+		tmp = blasfeo_work_memsize(M_KERNEL*bs.d_kc*sizeof(double)+64);
+		size = tmp>size ? tmp : size;
+		}
+
+	// small matrix
+	if(m<12 & 2*k<12)
+		return size;
+
+#if ! defined(TARGET_X64_INTEL_SKYLAKE_X)
+	// cache blocking alg, unless the buffer of blasfeo_init is used
+	if(blasfeo_is_init_block_size(&bs)==0)
+		{
+		tmp = blasfeo_work_memsize(blasfeo_memsize_buffer_block_size(&bs));
+		size = tmp>size ? tmp : size;
+		}
+#else
+	k1 = (2*k+128-1)/128*128;
+	m1 = (m+128-1)/128*128;
+	tmp = blasfeo_work_memsize(blasfeo_pm_memsize_dmat(ps, m1, k1)+64);
+	size = tmp>size ? tmp : size;
+#endif
+
+	return size;
+
+	}
+
+
+
+size_t blasfeo_hp_dsyr2k_ln_worksize(int m, int k)
+	{
+	return blasfeo_hp_dsyr2k_worksize(m, k);
+	}
+
+
+
+size_t blasfeo_hp_dsyr2k_lt_worksize(int m, int k)
+	{
+	// two syrk calls, one after the other
+	return blasfeo_dsyrk_lt_worksize(m, k);
+	}
+
+
+
+size_t blasfeo_hp_dsyr2k_un_worksize(int m, int k)
+	{
+	// two syrk calls, one after the other
+	return blasfeo_dsyrk_un_worksize(m, k);
+	}
+
+
+
+size_t blasfeo_hp_dsyr2k_ut_worksize(int m, int k)
+	{
+	// two syrk calls, one after the other
+	return blasfeo_dsyrk_ut_worksize(m, k);
+	}
+
+
+
 #if defined(LA_HIGH_PERFORMANCE)
 
 
@@ -900,5 +997,73 @@ void blasfeo_dsyr2k_ut(int m, int k, double alpha, struct blasfeo_dmat *sA, int
 
 
 
+size_t blasfeo_dsyr2k_ln_worksize(int m, int k)
+	{
+	return blasfeo_hp_dsyr2k_ln_worksize(m, k);
+	}
+
+
+
+void blasfeo_dsyr2k_ln_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dsyr2k_ln(m, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dsyr2k_lt_worksize(int m, int k)
+	{
+	return blasfeo_hp_dsyr2k_lt_worksize(m, k);
+	}
+
+
+
+void blasfeo_dsyr2k_lt_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dsyr2k_lt(m, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dsyr2k_un_worksize(int m, int k)
+	{
+	return blasfeo_hp_dsyr2k_un_worksize(m, k);
+	}
+
+
+
+void blasfeo_dsyr2k_un_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dsyr2k_un(m, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dsyr2k_ut_worksize(int m, int k)
+	{
+	return blasfeo_hp_dsyr2k_ut_worksize(m, k);
+	}
+
+
+
+void blasfeo_dsyr2k_ut_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dsyr2k_ut(m, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
 #endif
 
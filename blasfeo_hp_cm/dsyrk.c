@@ -70,6 +70,37 @@
 #define blasfeo_dsyrk_lt blasfeo_cm_dsyrk_lt
 #define blasfeo_dsyrk_un blasfeo_cm_dsyrk_un
 #define blasfeo_dsyrk_ut blasfeo_cm_dsyrk_ut
+#define blasfeo_hp_dsyrk3_ln_worksize blasfeo_hp_cm_dsyrk3_ln_worksize
+#define blasfeo_hp_dsyrk3_lt_worksize blasfeo_hp_cm_dsyrk3_lt_worksize
+#define blasfeo_hp_dsyrk3_un_worksize blasfeo_hp_cm_dsyrk3_un_worksize
+#define blasfeo_hp_dsyrk3_ut_worksize blasfeo_hp_cm_dsyrk3_ut_worksize
+#define blasfeo_hp_dsyrk_ln_worksize blasfeo_hp_cm_dsyrk_ln_worksize
+#define blasfeo_hp_dsyrk_ln_mn_worksize blasfeo_hp_cm_dsyrk_ln_mn_worksize
+#define blasfeo_hp_dsyrk_lt_worksize blasfeo_hp_cm_dsyrk_lt_worksize
+#define blasfeo_hp_dsyrk_un_worksize blasfeo_hp_cm_dsyrk_un_worksize
+#define blasfeo_hp_dsyrk_ut_worksize blasfeo_hp_cm_dsyrk_ut_worksize
+#define blasfeo_dsyrk3_ln_worksize blasfeo_cm_dsyrk3_ln_worksize
+#define blasfeo_dsyrk3_lt_worksize blasfeo_cm_dsyrk3_lt_worksize
+#define blasfeo_dsyrk3_un_worksize blasfeo_cm_dsyrk3_un_worksize
+#define blasfeo_dsyrk3_ut_worksize blasfeo_cm_dsyrk3_ut_worksize
+#define blasfeo_dsyrk_ln_worksize blasfeo_cm_dsyrk_ln_worksize
+#define blasfeo_dsyrk_ln_mn_worksize blasfeo_cm_dsyrk_ln_mn_worksize
+#define blasfeo_dsyrk_lt_worksize blasfeo_cm_dsyrk_lt_worksize
+#define blasfeo_dsyrk_un_worksize blasfeo_cm_dsyrk_un_worksize
+#define blasfeo_dsyrk_ut_worksize blasfeo_cm_dsyrk_ut_worksize
+#define blasfeo_dsyrk3_ln_ws blasfeo_cm_dsyrk3_ln_ws
+#define blasfeo_dsyrk3_lt_ws blasfeo_cm_dsyrk3_lt_ws
+#define blasfeo_dsyrk3_un_ws blasfeo_cm_dsyrk3_un_ws
+#define blasfeo_dsyrk3_ut_ws blasfeo_cm_dsyrk3_ut_ws
+#define blasfeo_dsyrk_ln_ws blasfeo_cm_dsyrk_ln_ws
+#define blasfeo_dsyrk_ln_mn_ws blasfeo_cm_dsyrk_ln_mn_ws
+#define blasfeo_dsyrk_lt_ws blasfeo_cm_dsyrk_lt_ws
+#define blasfeo_dsyrk_un_ws blasfeo_cm_dsyrk_un_ws
+#define blasfeo_dsyrk_ut_ws blasfeo_cm_dsyrk_ut_ws
+#define blasfeo_hp_dsyrk_plan blasfeo_cm_hp_dsyrk_plan
+#define blasfeo_hp_dsyrk_execute blasfeo_cm_hp_dsyrk_execute
+#define blasfeo_dsyrk_plan blasfeo_cm_dsyrk_plan
+#define blasfeo_dsyrk_execute blasfeo_cm_dsyrk_execute
 #endif
 
 
@@ -80,9 +111,6 @@
 #define LLC_CACHE_EL D_LLC_CACHE_EL
 #define PS D_PS
 #define M_KERNEL D_M_KERNEL
-#define KC D_KC
-#define NC D_NC
-#define MC D_MC
 
 
 
@@ -838,6 +866,9 @@ void blasfeo_hp_dsyrk3_ln(int m, int k, double alpha, struct blasfeo_dmat *sA, i
 	if(m<=0)
 		return;
 
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldc = sC->m;
@@ -903,7 +934,7 @@ void blasfeo_hp_dsyrk3_ln(int m, int k, double alpha, struct blasfeo_dmat *sA, i
 	int m_a = m==lda ? m : m_cache;
 //	int n_b = n==ldb ? n : n_cache;
 	int n_b = m_a; // syrk: B=A
-	int k_block = K_MAX_STACK<KC ? K_MAX_STACK : KC;
+	int k_block = K_MAX_STACK<bs.d_kc ? K_MAX_STACK : bs.d_kc;
 	k_block = k<=k_block ? k : k_block; // m1 and n1 alg are blocked !!!
 
 
@@ -940,13 +971,13 @@ void blasfeo_hp_dsyrk3_ln(int m, int k, double alpha, struct blasfeo_dmat *sA, i
 ln_1:
 	// k-blocking alg
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs.d_kc>K_MAX_STACK)
 		{
-		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		pU_size = M_KERNEL*bs.d_kc*sizeof(double);
+		blasfeo_work_malloc(&mem, pU_size+64);
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
-		sdu = KC;
+		sdu = bs.d_kc;
 		}
 	else
 		{
@@ -957,7 +988,7 @@ ln_1:
 	sdu = k4<sdu ? k4 : sdu;
 
 //	kc = 4;
-	kc = KC;
+	kc = bs.d_kc;
 
 	if(k<kc)
 		{
@@ -999,9 +1030,9 @@ ln_1:
 
 		}
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs.d_kc>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -1013,9 +1044,9 @@ ln_2:
 
 	// cache blocking alg
 
-	mc0 = MC;
-	nc0 = NC;
-	kc0 = KC;
+	mc0 = bs.d_mc;
+	nc0 = bs.d_nc;
+	kc0 = bs.d_kc;
 
 //	mc0 = 12;
 //	nc0 = 8;
@@ -1029,9 +1060,9 @@ ln_2:
 	tB_size = blasfeo_pm_memsize_dmat(ps, nc0, kc0);
 	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(&bs)==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+2*4096);
 		}
 	else
 		{
@@ -1139,9 +1170,9 @@ ln_2:
 
 		}
 
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(&bs)==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -1151,7 +1182,7 @@ ln_2:
 	k1 = (k+128-1)/128*128;
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, k1);
-	mem = malloc(tA_size+64);
+	blasfeo_work_malloc(&mem, tA_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, k, &tA, (void *) mem_align);
 
@@ -1165,7 +1196,7 @@ ln_2:
 
 	blasfeo_hp_dsyrk3_ln_m2(m, k, alpha, pU, sdu, beta, C, ldc, D, ldd);
 
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 #endif
@@ -1187,6 +1218,9 @@ void blasfeo_hp_dsyrk3_lt(int m, int k, double alpha, struct blasfeo_dmat *sA, i
 	if(m<=0)
 		return;
 
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldc = sC->m;
@@ -1245,7 +1279,7 @@ void blasfeo_hp_dsyrk3_lt(int m, int k, double alpha, struct blasfeo_dmat *sA, i
 	const int m_kernel_cache = (m_kernel+reals_per_cache_line-1)/reals_per_cache_line*reals_per_cache_line;
 	int m_min = m_cache<m_kernel_cache ? m_cache : m_kernel_cache;
 //	int n_min = n_cache<m_kernel_cache ? n_cache : m_kernel_cache;
-	int k_block = K_MAX_STACK<KC ? K_MAX_STACK : KC;
+	int k_block = K_MAX_STACK<bs.d_kc ? K_MAX_STACK : bs.d_kc;
 	k_block = k<=k_block ? k : k_block; // m1 and n1 alg are blocked !!!
 
 	int k_a = k==lda ? k : k_cache;
@@ -1284,13 +1318,13 @@ void blasfeo_hp_dsyrk3_lt(int m, int k, double alpha, struct blasfeo_dmat *sA, i
 lt_1:
 	// k-blocking alg
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs.d_kc>K_MAX_STACK)
 		{
-		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		pU_size = M_KERNEL*bs.d_kc*sizeof(double);
+		blasfeo_work_malloc(&mem, pU_size+64);
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
-		sdu = KC;
+		sdu = bs.d_kc;
 		}
 	else
 		{
@@ -1301,7 +1335,7 @@ lt_1:
 	sdu = k4<sdu ? k4 : sdu;
 
 //	kc = 4;
-	kc = KC;
+	kc = bs.d_kc;
 
 	if(k<kc)
 		{
@@ -1343,9 +1377,9 @@ lt_1:
 
 		}
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs.d_kc>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -1357,9 +1391,9 @@ lt_2:
 
 	// cache blocking alg
 
-	mc0 = MC;
-	nc0 = NC;
-	kc0 = KC;
+	mc0 = bs.d_mc;
+	nc0 = bs.d_nc;
+	kc0 = bs.d_kc;
 
 //	mc0 = 12;
 //	nc0 = 8;
@@ -1373,9 +1407,9 @@ lt_2:
 	tB_size = blasfeo_pm_memsize_dmat(ps, nc0, kc0);
 	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(&bs)==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+2*4096);
 		}
 	else
 		{
@@ -1483,9 +1517,9 @@ lt_2:
 
 		}
 
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(&bs)==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -1495,7 +1529,7 @@ lt_2:
 	k1 = (k+128-1)/128*128;
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, k1);
-	mem = malloc(tA_size+64);
+	blasfeo_work_malloc(&mem, tA_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, k, &tA, (void *) mem_align);
 
@@ -1514,7 +1548,7 @@ lt_2:
 
 	blasfeo_hp_dsyrk3_ln_m2(m, k, alpha, pU, sdu, beta, C, ldc, D, ldd);
 
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 #endif
@@ -1536,6 +1570,9 @@ void blasfeo_hp_dsyrk3_un(int m, int k, double alpha, struct blasfeo_dmat *sA, i
 	if(m<=0)
 		return;
 
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldc = sC->m;
@@ -1601,7 +1638,7 @@ void blasfeo_hp_dsyrk3_un(int m, int k, double alpha, struct blasfeo_dmat *sA, i
 	int m_a = m==lda ? m : m_cache;
 //	int n_b = n==ldb ? n : n_cache;
 	int n_b = m_a; // syrk: B=A
-	int k_block = K_MAX_STACK<KC ? K_MAX_STACK : KC;
+	int k_block = K_MAX_STACK<bs.d_kc ? K_MAX_STACK : bs.d_kc;
 	k_block = k<=k_block ? k : k_block; // m1 and n1 alg are blocked !!!
 
 
@@ -1636,13 +1673,13 @@ void blasfeo_hp_dsyrk3_un(int m, int k, double alpha, struct blasfeo_dmat *sA, i
 un_1:
 	// k-blocking alg
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs.d_kc>K_MAX_STACK)
 		{
-		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		pU_size = M_KERNEL*bs.d_kc*sizeof(double);
+		blasfeo_work_malloc(&mem, pU_size+64);
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
-		sdu = KC;
+		sdu = bs.d_kc;
 		}
 	else
 		{
@@ -1653,7 +1690,7 @@ un_1:
 	sdu = k4<sdu ? k4 : sdu;
 
 //	kc = 4;
-	kc = KC;
+	kc = bs.d_kc;
 
 	if(k<kc)
 		{
@@ -1695,9 +1732,9 @@ un_1:
 
 		}
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs.d_kc>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -1709,9 +1746,9 @@ un_2:
 
 	// cache blocking alg
 
-	mc0 = MC;
-	nc0 = NC;
-	kc0 = KC;
+	mc0 = bs.d_mc;
+	nc0 = bs.d_nc;
+	kc0 = bs.d_kc;
 
 //	mc0 = 12;
 //	nc0 = 8;
@@ -1725,9 +1762,9 @@ un_2:
 	tB_size = blasfeo_pm_memsize_dmat(ps, nc0, kc0);
 	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(&bs)==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+2*4096);
 		}
 	else
 		{
@@ -1835,9 +1872,9 @@ un_2:
 
 		}
 
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(&bs)==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -1847,7 +1884,7 @@ un_2:
 	k1 = (k+128-1)/128*128;
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, k1);
-	mem = malloc(tA_size+64);
+	blasfeo_work_malloc(&mem, tA_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, k, &tA, (void *) mem_align);
 
@@ -1864,7 +1901,7 @@ un_2:
 
 	blasfeo_hp_dsyrk3_un_m2(m, k, alpha, pU, sdu, beta, C, ldc, D, ldd);
 
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 #endif
@@ -1886,6 +1923,9 @@ void blasfeo_hp_dsyrk3_ut(int m, int k, double alpha, struct blasfeo_dmat *sA, i
 	if(m<=0)
 		return;
 
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldc = sC->m;
@@ -1944,7 +1984,7 @@ void blasfeo_hp_dsyrk3_ut(int m, int k, double alpha, struct blasfeo_dmat *sA, i
 	const int m_kernel_cache = (m_kernel+reals_per_cache_line-1)/reals_per_cache_line*reals_per_cache_line;
 	int m_min = m_cache<m_kernel_cache ? m_cache : m_kernel_cache;
 //	int n_min = n_cache<m_kernel_cache ? n_cache : m_kernel_cache;
-	int k_block = K_MAX_STACK<KC ? K_MAX_STACK : KC;
+	int k_block = K_MAX_STACK<bs.d_kc ? K_MAX_STACK : bs.d_kc;
 	k_block = k<=k_block ? k : k_block; // m1 and n1 alg are blocked !!!
 
 	int k_a = k==lda ? k : k_cache;
@@ -1978,13 +2018,13 @@ void blasfeo_hp_dsyrk3_ut(int m, int k, double alpha, struct blasfeo_dmat *sA, i
 ut_1:
 	// k-blocking alg
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs.d_kc>K_MAX_STACK)
 		{
-		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		pU_size = M_KERNEL*bs.d_kc*sizeof(double);
+		blasfeo_work_malloc(&mem, pU_size+64);
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
-		sdu = KC;
+		sdu = bs.d_kc;
 		}
 	else
 		{
@@ -1995,7 +2035,7 @@ ut_1:
 	sdu = k4<sdu ? k4 : sdu;
 
 //	kc = 4;
-	kc = KC;
+	kc = bs.d_kc;
 
 	if(k<kc)
 		{
@@ -2037,9 +2077,9 @@ ut_1:
 
 		}
 
-	if(k>K_MAX_STACK && KC>K_MAX_STACK)
+	if(k>K_MAX_STACK && bs.d_kc>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -2051,9 +2091,9 @@ ut_2:
 
 	// cache blocking alg
 
-	mc0 = MC;
-	nc0 = NC;
-	kc0 = KC;
+	mc0 = bs.d_mc;
+	nc0 = bs.d_nc;
+	kc0 = bs.d_kc;
 
 //	mc0 = 12;
 //	nc0 = 8;
@@ -2067,9 +2107,9 @@ ut_2:
 	tB_size = blasfeo_pm_memsize_dmat(ps, nc0, kc0);
 	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(&bs)==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+2*4096);
 		}
 	else
 		{
@@ -2177,9 +2217,9 @@ ut_2:
 
 		}
 
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(&bs)==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -2189,7 +2229,7 @@ ut_2:
 	k1 = (k+128-1)/128*128;
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, k1);
-	mem = malloc(tA_size+64);
+	blasfeo_work_malloc(&mem, tA_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, k, &tA, (void *) mem_align);
 
@@ -2207,7 +2247,7 @@ ut_2:
 
 	blasfeo_hp_dsyrk3_un_m2(m, k, alpha, pU, sdu, beta, C, ldc, D, ldd);
 
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 #endif
@@ -2219,7 +2259,32 @@ ut_2:
 
 
 
-void blasfeo_hp_dsyrk_ln(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+// size-based choice between the lx_2 and ln_1 code paths of blasfeo_hp_dsyrk_ln: nonzero selects lx_2
+static int blasfeo_hp_dsyrk_ln_alg(int m, int k)
+	{
+
+#if defined(TARGET_X64_INTEL_HASWELL)
+	if(m>=200 | k>=200 | k>K_MAX_STACK)
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(m>=64 | k>=64 | k>K_MAX_STACK)
+#elif defined(TARGET_ARMV8A_ARM_CORTEX_A57)
+	if(m>=32 | k>=32 | k>K_MAX_STACK)
+#elif defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+	if(m>16 | k>16 | k>K_MAX_STACK)
+#else
+	if(m>=12 | k>=12 | k>K_MAX_STACK)
+#endif
+		{
+		return 1;
+		}
+
+	return 0;
+
+	}
+
+
+
+static void blasfeo_hp_dsyrk_ln_run(int alg, int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
 #if defined(PRINT_NAME)
@@ -2286,17 +2351,7 @@ void blasfeo_hp_dsyrk_ln(int m, int k, double alpha, struct blasfeo_dmat *sA, in
 
 //	goto ln_1;
 //	goto lx_2;
-#if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=200 | k>=200 | k>K_MAX_STACK)
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | k>=64 | k>K_MAX_STACK)
-#elif defined(TARGET_ARMV8A_ARM_CORTEX_A57)
-	if(m>=32 | k>=32 | k>K_MAX_STACK)
-#elif defined(TARGET_ARMV8A_ARM_CORTEX_A53)
-	if(m>16 | k>16 | k>K_MAX_STACK)
-#else
-	if(m>=12 | k>=12 | k>K_MAX_STACK)
-#endif
+	if(alg)
 		{
 		goto lx_2;
 		}
@@ -2430,7 +2485,7 @@ lx_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, k1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, k1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, k, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, k, &tB, (void *) (mem_align+tA_size));
@@ -2562,7 +2617,7 @@ lx_2_left_4:
 	goto lx_2_return;
 
 lx_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -2574,7 +2629,41 @@ lx_2_return:
 
 
 
-void blasfeo_hp_dsyrk_ln_mn(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+void blasfeo_hp_dsyrk_ln(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	blasfeo_hp_dsyrk_ln_run(blasfeo_hp_dsyrk_ln_alg(m, k), m, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+
+	}
+
+
+
+// size-based choice between the lx_2 and ln_1 code paths of blasfeo_hp_dsyrk_ln_mn: nonzero selects lx_2
+static int blasfeo_hp_dsyrk_ln_mn_alg(int m, int k)
+	{
+
+#if defined(TARGET_X64_INTEL_HASWELL)
+	if(m>=200 | k>=200 | k>K_MAX_STACK)
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(m>=64 | k>=64 | k>K_MAX_STACK)
+#elif defined(TARGET_ARMV8A_ARM_CORTEX_A57)
+	if(m>=32 | k>=32 | k>K_MAX_STACK)
+#elif defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+	if(m>16 | k>16 | k>K_MAX_STACK)
+#else
+	if(m>=12 | k>=12 | k>K_MAX_STACK)
+#endif
+		{
+		return 1;
+		}
+
+	return 0;
+
+	}
+
+
+
+static void blasfeo_hp_dsyrk_ln_mn_run(int alg, int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
 #if defined(PRINT_NAME)
@@ -2641,17 +2730,7 @@ void blasfeo_hp_dsyrk_ln_mn(int m, int n, int k, double alpha, struct blasfeo_dm
 
 //	goto ln_1;
 //	goto lx_2;
-#if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=200 | k>=200 | k>K_MAX_STACK)
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | k>=64 | k>K_MAX_STACK)
-#elif defined(TARGET_ARMV8A_ARM_CORTEX_A57)
-	if(m>=32 | k>=32 | k>K_MAX_STACK)
-#elif defined(TARGET_ARMV8A_ARM_CORTEX_A53)
-	if(m>16 | k>16 | k>K_MAX_STACK)
-#else
-	if(m>=12 | k>=12 | k>K_MAX_STACK)
-#endif
+	if(alg)
 		{
 		goto lx_2;
 		}
@@ -2864,7 +2943,7 @@ lx_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, k1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, k1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, k, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, k, &tB, (void *) (mem_align+tA_size));
@@ -3068,7 +3147,7 @@ lx_2_left_4:
 	goto lx_2_return;
 
 lx_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -3080,6 +3159,15 @@ lx_2_return:
 
 
 
+void blasfeo_hp_dsyrk_ln_mn(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	blasfeo_hp_dsyrk_ln_mn_run(blasfeo_hp_dsyrk_ln_mn_alg(m, k), m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+
+	}
+
+
+
 // dsyrk_lower transposed
 void blasfeo_hp_dsyrk_lt(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
@@ -3143,7 +3231,7 @@ void blasfeo_hp_dsyrk_lt(int m, int k, double alpha, struct blasfeo_dmat *sA, in
 			pD[(ii+0)+(jj+0)*ldd] = beta * pC[(ii+0)+(jj+0)*ldc] + alpha * c_00;
 			pD[(ii+1)+(jj+0)*ldd] = beta * pC[(ii+1)+(jj+0)*ldc] + alpha * c_10;
 			pD[(ii+0)+(jj+1)*ldd] = beta * pC[(ii+0)+(jj+1)*ldc] + alpha * c_01;
-			pD[(jj+1)+(jj+1)*ldd] = beta * pC[(ii+1)+(jj+1)*ldc] + alpha * c_11;
+			pD[(ii+1)+(jj+1)*ldd] = beta * pC[(ii+1)+(jj+1)*ldc] + alpha * c_11;
 			}
 		for(; ii<m; ii++)
 			{
@@ -3223,7 +3311,7 @@ void blasfeo_hp_dsyrk_un(int m, int k, double alpha, struct blasfeo_dmat *sA, in
 			pD[(ii+0)+(jj+0)*ldd] = beta * pC[(ii+0)+(jj+0)*ldc] + alpha * c_00;
 			pD[(ii+1)+(jj+0)*ldd] = beta * pC[(ii+1)+(jj+0)*ldc] + alpha * c_10;
 			pD[(ii+0)+(jj+1)*ldd] = beta * pC[(ii+0)+(jj+1)*ldc] + alpha * c_01;
-			pD[(jj+1)+(jj+1)*ldd] = beta * pC[(ii+1)+(jj+1)*ldc] + alpha * c_11;
+			pD[(ii+1)+(jj+1)*ldd] = beta * pC[(ii+1)+(jj+1)*ldc] + alpha * c_11;
 			}
 		// diagonal
 		c_00 = 0.0;
@@ -3318,7 +3406,7 @@ void blasfeo_hp_dsyrk_ut(int m, int k, double alpha, struct blasfeo_dmat *sA, in
 			pD[(ii+0)+(jj+0)*ldd] = beta * pC[(ii+0)+(jj+0)*ldc] + alpha * c_00;
 			pD[(ii+1)+(jj+0)*ldd] = beta * pC[(ii+1)+(jj+0)*ldc] + alpha * c_10;
 			pD[(ii+0)+(jj+1)*ldd] = beta * pC[(ii+0)+(jj+1)*ldc] + alpha * c_01;
-			pD[(jj+1)+(jj+1)*ldd] = beta * pC[(ii+1)+(jj+1)*ldc] + alpha * c_11;
+			pD[(ii+1)+(jj+1)*ldd] = beta * pC[(ii+1)+(jj+1)*ldc] + alpha * c_11;
 			}
 		// diagonal
 		c_00 = 0.0;
@@ -3363,6 +3451,224 @@ void blasfeo_hp_dsyrk_ut(int m, int k, double alpha, struct blasfeo_dmat *sA, in
 
 
 
+// workspace size in bytes of the syrk3 routines: upper bound over the algorithms that can be selected
+static size_t blasfeo_hp_dsyrk3_worksize(int m, int k)
+	{
+
+	size_t size = 0;
+	size_t tmp;
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+	const int ps = PS;
+	int k1, m1;
+#endif
+
+	if(m<=0)
+		return 0;
+
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+
+	// m1 alg: panel buffer on the heap if larger than the stack one
+	if(k>K_MAX_STACK && bs.d_kc>K_MAX_STACK)
+		{
+		tmp = blasfeo_work_memsize(M_KERNEL*bs.d_kc*sizeof(double)+64);
+		size = tmp>size ? tmp : size;
+		}
+
+	// small matrix
+	if(m<12 & k<12)
+		return size;
+
+#if ! defined(TARGET_X64_INTEL_SKYLAKE_X)
+	// cache blocking alg, unless the buffer of blasfeo_init is used
+	if(blasfeo_is_init_block_size(&bs)==0)
+		{
+		tmp = blasfeo_work_memsize(blasfeo_memsize_buffer_block_size(&bs));
+		size = tmp>size ? tmp : size;
+		}
+#else
+	k1 = (k+128-1)/128*128;
+	m1 = (m+128-1)/128*128;
+	tmp = blasfeo_work_memsize(blasfeo_pm_memsize_dmat(ps, m1, k1)+64);
+	size = tmp>size ? tmp : size;
+#endif
+
+	return size;
+
+	}
+
+
+
+// workspace size in bytes of the syrk routines with A!=B
+static size_t blasfeo_hp_dsyrk_lx_worksize(int m, int k)
+	{
+
+	const int ps = PS;
+
+	int k1, m1;
+
+	if(m<=0)
+		return 0;
+
+	// small matrix
+	if(m<12 & k<12)
+		return 0;
+
+	k1 = (k+128-1)/128*128;
+	m1 = (m+128-1)/128*128;
+	return blasfeo_work_memsize(blasfeo_pm_memsize_dmat(ps, M_KERNEL, k1)+blasfeo_pm_memsize_dmat(ps, m1, k1)+64);
+
+	}
+
+
+
+size_t blasfeo_hp_dsyrk3_ln_worksize(int m, int k)
+	{
+	return blasfeo_hp_dsyrk3_worksize(m, k);
+	}
+
+
+
+size_t blasfeo_hp_dsyrk3_lt_worksize(int m, int k)
+	{
+	return blasfeo_hp_dsyrk3_worksize(m, k);
+	}
+
+
+
+size_t blasfeo_hp_dsyrk3_un_worksize(int m, int k)
+	{
+	return blasfeo_hp_dsyrk3_worksize(m, k);
+	}
+
+
+
+size_t blasfeo_hp_dsyrk3_ut_worksize(int m, int k)
+	{
+	return blasfeo_hp_dsyrk3_worksize(m, k);
+	}
+
+
+
+size_t blasfeo_hp_dsyrk_ln_worksize(int m, int k)
+	{
+	return blasfeo_hp_dsyrk_lx_worksize(m, k);
+	}
+
+
+
+size_t blasfeo_hp_dsyrk_ln_mn_worksize(int m, int n, int k)
+	{
+	return blasfeo_hp_dsyrk_lx_worksize(m, k);
+	}
+
+
+
+size_t blasfeo_hp_dsyrk_lt_worksize(int m, int k)
+	{
+	// A==B is solved by the syrk3 routine
+	return blasfeo_hp_dsyrk3_lt_worksize(m, k);
+	}
+
+
+
+size_t blasfeo_hp_dsyrk_un_worksize(int m, int k)
+	{
+	// A==B is solved by the syrk3 routine
+	return blasfeo_hp_dsyrk3_un_worksize(m, k);
+	}
+
+
+
+size_t blasfeo_hp_dsyrk_ut_worksize(int m, int k)
+	{
+	// A==B is solved by the syrk3 routine
+	return blasfeo_hp_dsyrk3_ut_worksize(m, k);
+	}
+
+
+
+// execution plan: the variant and the code path are resolved at plan creation for the given sizes and offsets;
+// only the lower non-transposed variant has a size-dependent code path
+
+void blasfeo_hp_dsyrk_plan(char uplo, char ta, int m, int k, int ai, int aj, int bi, int bj, int ci, int cj, int di, int dj, struct blasfeo_dplan *plan)
+	{
+
+	int upper, trans;
+
+	if(uplo=='l' | uplo=='L')
+		{
+		upper = 0;
+		}
+	else if(uplo=='u' | uplo=='U')
+		{
+		upper = 1;
+		}
+	else
+		{
+		printf("\nerror: blasfeo_dsyrk_plan: wrong value of uplo %c\n", uplo);
+		exit(1);
+		}
+	if(ta=='n' | ta=='N')
+		{
+		trans = 0;
+		}
+	else if(ta=='t' | ta=='T')
+		{
+		trans = 1;
+		}
+	else
+		{
+		printf("\nerror: blasfeo_dsyrk_plan: wrong value of ta %c\n", ta);
+		exit(1);
+		}
+
+	plan->m = m;
+	plan->n = m;
+	plan->k = k;
+	plan->ai = ai;
+	plan->aj = aj;
+	plan->bi = bi;
+	plan->bj = bj;
+	plan->ci = ci;
+	plan->cj = cj;
+	plan->di = di;
+	plan->dj = dj;
+
+	plan->var = 2*upper + trans;
+	plan->alg = plan->var==0 ? blasfeo_hp_dsyrk_ln_alg(m, k) : 0;
+
+	return;
+
+	}
+
+
+
+void blasfeo_hp_dsyrk_execute(struct blasfeo_dplan *plan, double alpha, struct blasfeo_dmat *sA, struct blasfeo_dmat *sB, double beta, struct blasfeo_dmat *sC, struct blasfeo_dmat *sD)
+	{
+
+	switch(plan->var)
+		{
+		case 0:
+			blasfeo_hp_dsyrk_ln_run(plan->alg, plan->m, plan->k, alpha, sA, plan->ai, plan->aj, sB, plan->bi, plan->bj, beta, sC, plan->ci, plan->cj, sD, plan->di, plan->dj);
+			break;
+		case 1:
+			blasfeo_hp_dsyrk_lt(plan->m, plan->k, alpha, sA, plan->ai, plan->aj, sB, plan->bi, plan->bj, beta, sC, plan->ci, plan->cj, sD, plan->di, plan->dj);
+			break;
+		case 2:
+			blasfeo_hp_dsyrk_un(plan->m, plan->k, alpha, sA, plan->ai, plan->aj, sB, plan->bi, plan->bj, beta, sC, plan->ci, plan->cj, sD, plan->di, plan->dj);
+			break;
+		default:
+			blasfeo_hp_dsyrk_ut(plan->m, plan->k, alpha, sA, plan->ai, plan->aj, sB, plan->bi, plan->bj, beta, sC, plan->ci, plan->cj, sD, plan->di, plan->dj);
+			break;
+		}
+
+	return;
+
+	}
+
+
+
 #if defined(LA_HIGH_PERFORMANCE)
 
 
@@ -3430,5 +3736,172 @@ void blasfeo_dsyrk_ut(int m, int k, double alpha, struct blasfeo_dmat *sA, int a
 
 
 
+size_t blasfeo_dsyrk3_ln_worksize(int m, int k)
+	{
+	return blasfeo_hp_dsyrk3_ln_worksize(m, k);
+	}
+
+
+
+void blasfeo_dsyrk3_ln_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dsyrk3_ln(m, k, alpha, sA, ai, aj, beta, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dsyrk3_lt_worksize(int m, int k)
+	{
+	return blasfeo_hp_dsyrk3_lt_worksize(m, k);
+	}
+
+
+
+void blasfeo_dsyrk3_lt_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dsyrk3_lt(m, k, alpha, sA, ai, aj, beta, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dsyrk3_un_worksize(int m, int k)
+	{
+	return blasfeo_hp_dsyrk3_un_worksize(m, k);
+	}
+
+
+
+void blasfeo_dsyrk3_un_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dsyrk3_un(m, k, alpha, sA, ai, aj, beta, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dsyrk3_ut_worksize(int m, int k)
+	{
+	return blasfeo_hp_dsyrk3_ut_worksize(m, k);
+	}
+
+
+
+void blasfeo_dsyrk3_ut_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dsyrk3_ut(m, k, alpha, sA, ai, aj, beta, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dsyrk_ln_worksize(int m, int k)
+	{
+	return blasfeo_hp_dsyrk_ln_worksize(m, k);
+	}
+
+
+
+void blasfeo_dsyrk_ln_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dsyrk_ln(m, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dsyrk_ln_mn_worksize(int m, int n, int k)
+	{
+	return blasfeo_hp_dsyrk_ln_mn_worksize(m, n, k);
+	}
+
+
+
+void blasfeo_dsyrk_ln_mn_ws(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dsyrk_ln_mn(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dsyrk_lt_worksize(int m, int k)
+	{
+	return blasfeo_hp_dsyrk_lt_worksize(m, k);
+	}
+
+
+
+void blasfeo_dsyrk_lt_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dsyrk_lt(m, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dsyrk_un_worksize(int m, int k)
+	{
+	return blasfeo_hp_dsyrk_un_worksize(m, k);
+	}
+
+
+
+void blasfeo_dsyrk_un_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dsyrk_un(m, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dsyrk_ut_worksize(int m, int k)
+	{
+	return blasfeo_hp_dsyrk_ut_worksize(m, k);
+	}
+
+
+
+void blasfeo_dsyrk_ut_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dsyrk_ut(m, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+void blasfeo_dsyrk_plan(char uplo, char ta, int m, int k, int ai, int aj, int bi, int bj, int ci, int cj, int di, int dj, struct blasfeo_dplan *plan)
+	{
+	blasfeo_hp_dsyrk_plan(uplo, ta, m, k, ai, aj, bi, bj, ci, cj, di, dj, plan);
+	}
+
+
+
+void blasfeo_dsyrk_execute(struct blasfeo_dplan *plan, double alpha, struct blasfeo_dmat *sA, struct blasfeo_dmat *sB, double beta, struct blasfeo_dmat *sC, struct blasfeo_dmat *sD)
+	{
+	blasfeo_hp_dsyrk_execute(plan, alpha, sA, sB, beta, sC, sD);
+	}
+
+
+
 #endif
 
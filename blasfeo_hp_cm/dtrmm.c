@@ -82,6 +82,54 @@
 #define blasfeo_dtrmm_runu blasfeo_cm_dtrmm_runu
 #define blasfeo_dtrmm_rutn blasfeo_cm_dtrmm_rutn
 #define blasfeo_dtrmm_rutu blasfeo_cm_dtrmm_rutu
+#define blasfeo_hp_dtrmm_llnn_worksize blasfeo_hp_cm_dtrmm_llnn_worksize
+#define blasfeo_hp_dtrmm_llnu_worksize blasfeo_hp_cm_dtrmm_llnu_worksize
+#define blasfeo_hp_dtrmm_lltn_worksize blasfeo_hp_cm_dtrmm_lltn_worksize
+#define blasfeo_hp_dtrmm_lltu_worksize blasfeo_hp_cm_dtrmm_lltu_worksize
+#define blasfeo_hp_dtrmm_lunn_worksize blasfeo_hp_cm_dtrmm_lunn_worksize
+#define blasfeo_hp_dtrmm_lunu_worksize blasfeo_hp_cm_dtrmm_lunu_worksize
+#define blasfeo_hp_dtrmm_lutn_worksize blasfeo_hp_cm_dtrmm_lutn_worksize
+#define blasfeo_hp_dtrmm_lutu_worksize blasfeo_hp_cm_dtrmm_lutu_worksize
+#define blasfeo_hp_dtrmm_rlnn_worksize blasfeo_hp_cm_dtrmm_rlnn_worksize
+#define blasfeo_hp_dtrmm_rlnu_worksize blasfeo_hp_cm_dtrmm_rlnu_worksize
+#define blasfeo_hp_dtrmm_rltn_worksize blasfeo_hp_cm_dtrmm_rltn_worksize
+#define blasfeo_hp_dtrmm_rltu_worksize blasfeo_hp_cm_dtrmm_rltu_worksize
+#define blasfeo_hp_dtrmm_runn_worksize blasfeo_hp_cm_dtrmm_runn_worksize
+#define blasfeo_hp_dtrmm_runu_worksize blasfeo_hp_cm_dtrmm_runu_worksize
+#define blasfeo_hp_dtrmm_rutn_worksize blasfeo_hp_cm_dtrmm_rutn_worksize
+#define blasfeo_hp_dtrmm_rutu_worksize blasfeo_hp_cm_dtrmm_rutu_worksize
+#define blasfeo_dtrmm_llnn_worksize blasfeo_cm_dtrmm_llnn_worksize
+#define blasfeo_dtrmm_llnu_worksize blasfeo_cm_dtrmm_llnu_worksize
+#define blasfeo_dtrmm_lltn_worksize blasfeo_cm_dtrmm_lltn_worksize
+#define blasfeo_dtrmm_lltu_worksize blasfeo_cm_dtrmm_lltu_worksize
+#define blasfeo_dtrmm_lunn_worksize blasfeo_cm_dtrmm_lunn_worksize
+#define blasfeo_dtrmm_lunu_worksize blasfeo_cm_dtrmm_lunu_worksize
+#define blasfeo_dtrmm_lutn_worksize blasfeo_cm_dtrmm_lutn_worksize
+#define blasfeo_dtrmm_lutu_worksize blasfeo_cm_dtrmm_lutu_worksize
+#define blasfeo_dtrmm_rlnn_worksize blasfeo_cm_dtrmm_rlnn_worksize
+#define blasfeo_dtrmm_rlnu_worksize blasfeo_cm_dtrmm_rlnu_worksize
+#define blasfeo_dtrmm_rltn_worksize blasfeo_cm_dtrmm_rltn_worksize
+#define blasfeo_dtrmm_rltu_worksize blasfeo_cm_dtrmm_rltu_worksize
+#define blasfeo_dtrmm_runn_worksize blasfeo_cm_dtrmm_runn_worksize
+#define blasfeo_dtrmm_runu_worksize blasfeo_cm_dtrmm_runu_worksize
+#define blasfeo_dtrmm_rutn_worksize blasfeo_cm_dtrmm_rutn_worksize
+#define blasfeo_dtrmm_rutu_worksize blasfeo_cm_dtrmm_rutu_worksize
+#define blasfeo_dtrmm_llnn_ws blasfeo_cm_dtrmm_llnn_ws
+#define blasfeo_dtrmm_llnu_ws blasfeo_cm_dtrmm_llnu_ws
+#define blasfeo_dtrmm_lltn_ws blasfeo_cm_dtrmm_lltn_ws
+#define blasfeo_dtrmm_lltu_ws blasfeo_cm_dtrmm_lltu_ws
+#define blasfeo_dtrmm_lunn_ws blasfeo_cm_dtrmm_lunn_ws
+#define blasfeo_dtrmm_lunu_ws blasfeo_cm_dtrmm_lunu_ws
+#define blasfeo_dtrmm_lutn_ws blasfeo_cm_dtrmm_lutn_ws
+#define blasfeo_dtrmm_lutu_ws blasfeo_cm_dtrmm_lutu_ws
+#define blasfeo_dtrmm_rlnn_ws blasfeo_cm_dtrmm_rlnn_ws
+#define blasfeo_dtrmm_rlnu_ws blasfeo_cm_dtrmm_rlnu_ws
+#define blasfeo_dtrmm_rltn_ws blasfeo_cm_dtrmm_rltn_ws
+#define blasfeo_dtrmm_rltu_ws blasfeo_cm_dtrmm_rltu_ws
+#define blasfeo_dtrmm_runn_ws blasfeo_cm_dtrmm_runn_ws
+#define blasfeo_dtrmm_runu_ws blasfeo_cm_dtrmm_runu_ws
+#define blasfeo_dtrmm_rutn_ws blasfeo_cm_dtrmm_rutn_ws
+#define blasfeo_dtrmm_rutu_ws blasfeo_cm_dtrmm_rutu_ws
 #endif
 
 
@@ -92,9 +140,6 @@
 #define LLC_CACHE_EL D_LLC_CACHE_EL
 #define PS D_PS
 #define M_KERNEL D_M_KERNEL
-#define KC D_KC
-#define NC D_NC
-#define MC D_MC
 
 
 
@@ -470,6 +515,9 @@ void blasfeo_hp_dtrmm_llnn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 	if(m<=0 | n<=0)
 		return;
 
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldb = sB->m;
@@ -680,9 +728,9 @@ llnn_2:
 
 	// cache blocking alg
 
-	mc0 = MC;
-	nc0 = NC;
-	kc0 = KC;
+	mc0 = bs.d_mc;
+	nc0 = bs.d_nc;
+	kc0 = bs.d_kc;
 
 	// these must all be multiple of ps !!!
 //	mc0 = 12;
@@ -702,9 +750,9 @@ llnn_2:
 	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
 	tT_size = (tT_size + 4096 - 1) / 4096 * 4096;
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(&bs)==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
 		}
 	else
 		{
@@ -806,7 +854,10 @@ llnn_2:
 
 		}
 
-	free(mem);
+	if(blasfeo_is_init_block_size(&bs)==0)
+		{
+		blasfeo_work_free(mem);
+		}
 	return;
 
 #else
@@ -815,7 +866,7 @@ llnn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, m, &tB, (void *) (mem_align+tA_size));
@@ -833,7 +884,7 @@ llnn_2:
 
 	blasfeo_hp_dtrmm_llnn_m2(m, n, alpha, pA, sda, pB, sdb, D, ldd);
 
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 #endif
@@ -1051,7 +1102,7 @@ llnu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -1179,7 +1230,7 @@ llnu_2_left_4:
 goto llnu_2_return;
 
 llnu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -1200,6 +1251,9 @@ void blasfeo_hp_dtrmm_lltn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 	if(m<=0 | n<=0)
 		return;
 
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldb = sB->m;
@@ -1410,9 +1464,9 @@ lunn_2:
 
 	// cache blocking alg
 
-	mc0 = MC;
-	nc0 = NC;
-	kc0 = KC;
+	mc0 = bs.d_mc;
+	nc0 = bs.d_nc;
+	kc0 = bs.d_kc;
 
 	// these must all be multiple of ps !!!
 //	mc0 = 12;
@@ -1432,9 +1486,9 @@ lunn_2:
 	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
 	tT_size = (tT_size + 4096 - 1) / 4096 * 4096;
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(&bs)==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
 		}
 	else
 		{
@@ -1535,7 +1589,10 @@ lunn_2:
 
 		}
 
-	free(mem);
+	if(blasfeo_is_init_block_size(&bs)==0)
+		{
+		blasfeo_work_free(mem);
+		}
 	return;
 
 #else
@@ -1543,7 +1600,7 @@ lunn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, m, &tB, (void *) (mem_align+tA_size));
@@ -1561,7 +1618,7 @@ lunn_2:
 
 	blasfeo_hp_dtrmm_lunn_m2(m, n, alpha, pA, sda, pB, sdb, D, ldd);
 
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 #endif
@@ -1776,7 +1833,7 @@ lunu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -1904,7 +1961,7 @@ lunu_2_left_4:
 goto lunu_2_return;
 
 lunu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -2119,7 +2176,7 @@ lunn_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -2247,7 +2304,7 @@ lunn_2_left_4:
 goto lunn_2_return;
 
 lunn_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -2462,7 +2519,7 @@ lunu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -2590,7 +2647,7 @@ lunu_2_left_4:
 goto lunu_2_return;
 
 lunu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -2804,7 +2861,7 @@ llnn_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -2932,7 +2989,7 @@ llnn_2_left_4:
 goto llnn_2_return;
 
 llnn_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -3146,7 +3203,7 @@ llnu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -3274,7 +3331,7 @@ llnu_2_left_4:
 goto llnu_2_return;
 
 llnu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -3295,6 +3352,9 @@ void blasfeo_hp_dtrmm_rlnn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 	if(m<=0 | n<=0)
 		return;
 
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldb = sB->m;
@@ -3499,9 +3559,9 @@ rutn_2:
 
 	// cache blocking alg
 
-	mc0 = NC; // XXX
-	nc0 = MC; // XXX
-	kc0 = KC;
+	mc0 = bs.d_nc; // XXX
+	nc0 = bs.d_mc; // XXX
+	kc0 = bs.d_kc;
 
 	// these must all be multiple of ps !!!
 //	mc0 = 4;
@@ -3519,9 +3579,9 @@ rutn_2:
 	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
 	tT_size = (tT_size + 4096 - 1) / 4096 * 4096;
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(&bs)==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
 		}
 	else
 		{
@@ -3623,16 +3683,19 @@ rutn_2:
 
 		}
 
-	free(mem);
+	if(blasfeo_is_init_block_size(&bs)==0)
+		{
+		blasfeo_work_free(mem);
+		}
 	return;
 
 #else
 
 	// cache blocking alg
 
-	mc0 = MC;
-	nc0 = NC;
-	kc0 = KC;
+	mc0 = bs.d_mc;
+	nc0 = bs.d_nc;
+	kc0 = bs.d_kc;
 
 	// these must all be multiple of ps !!!
 //	mc0 = 12;
@@ -3650,9 +3713,9 @@ rutn_2:
 	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
 	tT_size = (tT_size + 4096 - 1) / 4096 * 4096;
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(&bs)==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
 		}
 	else
 		{
@@ -3736,7 +3799,10 @@ rutn_2:
 
 		}
 
-	free(mem);
+	if(blasfeo_is_init_block_size(&bs)==0)
+		{
+		blasfeo_work_free(mem);
+		}
 	return;
 
 #endif
@@ -3747,7 +3813,7 @@ rutn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, n, &tB, (void *) (mem_align+tA_size));
@@ -3765,7 +3831,7 @@ rutn_2:
 
 	blasfeo_hp_dtrmm_rutn_m2(m, n, alpha, pA, sda, pB, sdb, D, ldd);
 
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 #endif
@@ -3975,7 +4041,7 @@ rutu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -4097,7 +4163,7 @@ rutu_2_left_4:
 goto rutu_2_return;
 
 rutu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -4306,7 +4372,7 @@ rltn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -4436,7 +4502,7 @@ rltn_2_left_4:
 goto rltn_2_return;
 
 rltn_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -4646,7 +4712,7 @@ rltu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -4776,7 +4842,7 @@ rltu_2_left_4:
 goto rltu_2_return;
 
 rltu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -4985,7 +5051,7 @@ rltn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -5107,7 +5173,7 @@ rltn_2_left_4:
 goto rltn_2_return;
 
 rltn_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -5316,7 +5382,7 @@ rltu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -5438,7 +5504,7 @@ rltu_2_left_4:
 goto rltu_2_return;
 
 rltu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -5648,7 +5714,7 @@ rutn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -5781,7 +5847,7 @@ rutn_2_left_4:
 goto rutn_2_return;
 
 rutn_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -5991,7 +6057,7 @@ rutu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -6123,7 +6189,7 @@ rutu_2_left_4:
 goto rutu_2_return;
 
 rutu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -6134,6 +6200,164 @@ rutu_2_return:
 
 
 
+// workspace size in bytes of the trmm routines, with the triangular matrix on the left (of size m) or on the right
+// (of size n): upper bound over the algorithms that can be selected, blk marks the routines with a cache blocking alg
+static size_t blasfeo_hp_dtrmm_worksize(int m, int n, int left, int blk)
+	{
+
+	const int ps = PS;
+
+	size_t size, tmp;
+	int k0, k1, m1, n1;
+
+	if(m<=0 | n<=0)
+		return 0;
+
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+
+	k0 = left ? m : n;
+
+	// small matrix
+	if(m<12 & n<12 & k0<=K_MAX_STACK)
+		return 0;
+
+	m1 = (m+128-1)/128*128;
+	n1 = (n+128-1)/128*128;
+	k1 = left ? m1 : n1;
+
+	// packed triangular matrix and kernel panel
+	size = blasfeo_work_memsize(blasfeo_pm_memsize_dmat(ps, M_KERNEL, k1)+blasfeo_pm_memsize_dmat(ps, k1, k1)+64);
+
+	if(blk)
+		{
+#if ! defined(TARGET_X64_INTEL_SKYLAKE_X)
+		// cache blocking alg, unless the buffer of blasfeo_init is used
+		tmp = blasfeo_is_init_block_size(&bs)==0 ? blasfeo_work_memsize(blasfeo_memsize_buffer_block_size(&bs)) : 0;
+#else
+		tmp = blasfeo_work_memsize(blasfeo_pm_memsize_dmat(ps, k1, k1)+blasfeo_pm_memsize_dmat(ps, m1, n1)+64);
+#endif
+		size = tmp>size ? tmp : size;
+		}
+
+	return size;
+
+	}
+
+
+
+size_t blasfeo_hp_dtrmm_llnn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_worksize(m, n, 1, 1);
+	}
+
+
+
+size_t blasfeo_hp_dtrmm_llnu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_worksize(m, n, 1, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrmm_lltn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_worksize(m, n, 1, 1);
+	}
+
+
+
+size_t blasfeo_hp_dtrmm_lltu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_worksize(m, n, 1, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrmm_lunn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_worksize(m, n, 1, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrmm_lunu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_worksize(m, n, 1, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrmm_lutn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_worksize(m, n, 1, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrmm_lutu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_worksize(m, n, 1, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrmm_rlnn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_worksize(m, n, 0, 1);
+	}
+
+
+
+size_t blasfeo_hp_dtrmm_rlnu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_worksize(m, n, 0, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrmm_rltn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_worksize(m, n, 0, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrmm_rltu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_worksize(m, n, 0, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrmm_runn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_worksize(m, n, 0, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrmm_runu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_worksize(m, n, 0, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrmm_rutn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_worksize(m, n, 0, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrmm_rutu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_worksize(m, n, 0, 0);
+	}
+
+
+
 #if defined(LA_HIGH_PERFORMANCE)
 
 
@@ -6266,5 +6490,277 @@ void blasfeo_dtrmm_rutu(int m, int n, double alpha, struct blasfeo_dmat *sA, int
 
 
 
+size_t blasfeo_dtrmm_llnn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_llnn_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrmm_llnn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrmm_llnn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrmm_llnu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_llnu_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrmm_llnu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrmm_llnu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrmm_lltn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_lltn_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrmm_lltn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrmm_lltn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrmm_lltu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_lltu_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrmm_lltu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrmm_lltu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrmm_lunn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_lunn_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrmm_lunn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrmm_lunn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrmm_lunu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_lunu_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrmm_lunu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrmm_lunu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrmm_lutn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_lutn_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrmm_lutn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrmm_lutn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrmm_lutu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_lutu_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrmm_lutu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrmm_lutu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrmm_rlnn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_rlnn_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrmm_rlnn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrmm_rlnn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrmm_rlnu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_rlnu_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrmm_rlnu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrmm_rlnu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrmm_rltn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_rltn_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrmm_rltn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrmm_rltn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrmm_rltu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_rltu_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrmm_rltu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrmm_rltu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrmm_runn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_runn_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrmm_runn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrmm_runn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrmm_runu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_runu_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrmm_runu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrmm_runu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrmm_rutn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_rutn_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrmm_rutn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrmm_rutn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrmm_rutu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrmm_rutu_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrmm_rutu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrmm_rutu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
 #endif
 
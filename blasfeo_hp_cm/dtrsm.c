@@ -45,6 +45,7 @@
 #include <blasfeo_d_kernel.h>
 #include <blasfeo_stdlib.h>
 #include <blasfeo_memory.h>
+#include <blasfeo_thread.h>
 
 
 
@@ -82,12 +83,67 @@
 #define blasfeo_dtrsm_runu blasfeo_cm_dtrsm_runu
 #define blasfeo_dtrsm_rutn blasfeo_cm_dtrsm_rutn
 #define blasfeo_dtrsm_rutu blasfeo_cm_dtrsm_rutu
+#define blasfeo_hp_dtrsm_llnn_worksize blasfeo_hp_cm_dtrsm_llnn_worksize
+#define blasfeo_hp_dtrsm_llnu_worksize blasfeo_hp_cm_dtrsm_llnu_worksize
+#define blasfeo_hp_dtrsm_lltn_worksize blasfeo_hp_cm_dtrsm_lltn_worksize
+#define blasfeo_hp_dtrsm_lltu_worksize blasfeo_hp_cm_dtrsm_lltu_worksize
+#define blasfeo_hp_dtrsm_lunn_worksize blasfeo_hp_cm_dtrsm_lunn_worksize
+#define blasfeo_hp_dtrsm_lunu_worksize blasfeo_hp_cm_dtrsm_lunu_worksize
+#define blasfeo_hp_dtrsm_lutn_worksize blasfeo_hp_cm_dtrsm_lutn_worksize
+#define blasfeo_hp_dtrsm_lutu_worksize blasfeo_hp_cm_dtrsm_lutu_worksize
+#define blasfeo_hp_dtrsm_rlnn_worksize blasfeo_hp_cm_dtrsm_rlnn_worksize
+#define blasfeo_hp_dtrsm_rlnu_worksize blasfeo_hp_cm_dtrsm_rlnu_worksize
+#define blasfeo_hp_dtrsm_rltn_worksize blasfeo_hp_cm_dtrsm_rltn_worksize
+#define blasfeo_hp_dtrsm_rltu_worksize blasfeo_hp_cm_dtrsm_rltu_worksize
+#define blasfeo_hp_dtrsm_runn_worksize blasfeo_hp_cm_dtrsm_runn_worksize
+#define blasfeo_hp_dtrsm_runu_worksize blasfeo_hp_cm_dtrsm_runu_worksize
+#define blasfeo_hp_dtrsm_rutn_worksize blasfeo_hp_cm_dtrsm_rutn_worksize
+#define blasfeo_hp_dtrsm_rutu_worksize blasfeo_hp_cm_dtrsm_rutu_worksize
+#define blasfeo_dtrsm_llnn_worksize blasfeo_cm_dtrsm_llnn_worksize
+#define blasfeo_dtrsm_llnu_worksize blasfeo_cm_dtrsm_llnu_worksize
+#define blasfeo_dtrsm_lltn_worksize blasfeo_cm_dtrsm_lltn_worksize
+#define blasfeo_dtrsm_lltu_worksize blasfeo_cm_dtrsm_lltu_worksize
+#define blasfeo_dtrsm_lunn_worksize blasfeo_cm_dtrsm_lunn_worksize
+#define blasfeo_dtrsm_lunu_worksize blasfeo_cm_dtrsm_lunu_worksize
+#define blasfeo_dtrsm_lutn_worksize blasfeo_cm_dtrsm_lutn_worksize
+#define blasfeo_dtrsm_lutu_worksize blasfeo_cm_dtrsm_lutu_worksize
+#define blasfeo_dtrsm_rlnn_worksize blasfeo_cm_dtrsm_rlnn_worksize
+#define blasfeo_dtrsm_rlnu_worksize blasfeo_cm_dtrsm_rlnu_worksize
+#define blasfeo_dtrsm_rltn_worksize blasfeo_cm_dtrsm_rltn_worksize
+#define blasfeo_dtrsm_rltu_worksize blasfeo_cm_dtrsm_rltu_worksize
+#define blasfeo_dtrsm_runn_worksize blasfeo_cm_dtrsm_runn_worksize
+#define blasfeo_dtrsm_runu_worksize blasfeo_cm_dtrsm_runu_worksize
+#define blasfeo_dtrsm_rutn_worksize blasfeo_cm_dtrsm_rutn_worksize
+#define blasfeo_dtrsm_rutu_worksize blasfeo_cm_dtrsm_rutu_worksize
+#define blasfeo_dtrsm_llnn_ws blasfeo_cm_dtrsm_llnn_ws
+#define blasfeo_dtrsm_llnu_ws blasfeo_cm_dtrsm_llnu_ws
+#define blasfeo_dtrsm_lltn_ws blasfeo_cm_dtrsm_lltn_ws
+#define blasfeo_dtrsm_lltu_ws blasfeo_cm_dtrsm_lltu_ws
+#define blasfeo_dtrsm_lunn_ws blasfeo_cm_dtrsm_lunn_ws
+#define blasfeo_dtrsm_lunu_ws blasfeo_cm_dtrsm_lunu_ws
+#define blasfeo_dtrsm_lutn_ws blasfeo_cm_dtrsm_lutn_ws
+#define blasfeo_dtrsm_lutu_ws blasfeo_cm_dtrsm_lutu_ws
+#define blasfeo_dtrsm_rlnn_ws blasfeo_cm_dtrsm_rlnn_ws
+#define blasfeo_dtrsm_rlnu_ws blasfeo_cm_dtrsm_rlnu_ws
+#define blasfeo_dtrsm_rltn_ws blasfeo_cm_dtrsm_rltn_ws
+#define blasfeo_dtrsm_rltu_ws blasfeo_cm_dtrsm_rltu_ws
+#define blasfeo_dtrsm_runn_ws blasfeo_cm_dtrsm_runn_ws
+#define blasfeo_dtrsm_runu_ws blasfeo_cm_dtrsm_runu_ws
+#define blasfeo_dtrsm_rutn_ws blasfeo_cm_dtrsm_rutn_ws
+#define blasfeo_dtrsm_rutu_ws blasfeo_cm_dtrsm_rutu_ws
+#define blasfeo_hp_dtrsm_plan blasfeo_cm_hp_dtrsm_plan
+#define blasfeo_hp_dtrsm_execute blasfeo_cm_hp_dtrsm_execute
+#define blasfeo_dtrsm_plan blasfeo_cm_dtrsm_plan
+#define blasfeo_dtrsm_execute blasfeo_cm_dtrsm_execute
 #endif
 
 
 
 #if ( defined(BLAS_API) & defined(MF_PANELMAJ) )
+#define blasfeo_hp_dgemm_nn blasfeo_hp_cm_dgemm_nn
 #define blasfeo_hp_dgemm_tn blasfeo_hp_cm_dgemm_tn
+#define blasfeo_hp_dgemm_nn_worksize blasfeo_hp_cm_dgemm_nn_worksize
+#define blasfeo_hp_dgemm_tn_worksize blasfeo_hp_cm_dgemm_tn_worksize
 #endif
 #include <blasfeo_d_blasfeo_hp_api.h>
 
@@ -99,9 +155,6 @@
 #define LLC_CACHE_EL D_LLC_CACHE_EL
 #define PS D_PS
 #define M_KERNEL D_M_KERNEL
-#define KC D_KC
-#define NC D_NC
-#define MC D_MC
 
 
 
@@ -784,7 +837,241 @@ rutn_2_return:
 
 
 
-void blasfeo_hp_dtrsm_llnn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+#if defined(MULTI_THREAD)
+
+// minimum number of right-hand sides per thread
+#define TRSM_MT_RHS 48
+// block size of the tiled alg
+#define TRSM_MT_NB 192
+
+
+
+void blasfeo_hp_dtrsm_llnn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_hp_dtrsm_llnu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_hp_dtrsm_lltn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_hp_dtrsm_lltu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_hp_dtrsm_lunn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_hp_dtrsm_lunu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_hp_dtrsm_lutn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_hp_dtrsm_lutu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_hp_dtrsm_rlnn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_hp_dtrsm_rlnu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_hp_dtrsm_rltn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_hp_dtrsm_rltu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_hp_dtrsm_runn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_hp_dtrsm_runu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_hp_dtrsm_rutn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_hp_dtrsm_rutu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+
+
+
+// arguments of the multi-threaded alg
+struct blasfeo_hp_dtrsm_mt_arg
+	{
+	void (*fun)(int, int, double, struct blasfeo_dmat *, int, int, struct blasfeo_dmat *, int, int, struct blasfeo_dmat *, int, int);
+	int left;
+	int m;
+	int n;
+	double alpha;
+	struct blasfeo_dmat *sA;
+	int ai;
+	int aj;
+	struct blasfeo_dmat *sB;
+	int bi;
+	int bj;
+	struct blasfeo_dmat *sD;
+	int di;
+	int dj;
+	char *work; // workspace of the solves, one slot per thread
+	size_t slotsize;
+	};
+
+
+
+// number of right-hand sides solved by each thread, a multiple of the kernel size
+static int blasfeo_hp_dtrsm_mt_rw(int r, int nth)
+	{
+	int rw = (r+nth-1)/nth;
+	return (rw+M_KERNEL-1)/M_KERNEL*M_KERNEL;
+	}
+
+
+
+static size_t blasfeo_hp_dtrsm_mt_slotsize(int left, int blk, int nth, int m, int n);
+
+
+
+// the right-hand sides (columns of B for the triangular matrix on the left, rows of B for the one on the right)
+// are independent: each thread solves a contiguous block of them with the single-threaded routine
+static void blasfeo_hp_dtrsm_mt_work(int tid, int nth, void *ptr)
+	{
+
+	struct blasfeo_hp_dtrsm_mt_arg *arg = ptr;
+
+	struct blasfeo_work prev;
+
+	int r = arg->left ? arg->n : arg->m;
+
+	int rw = blasfeo_hp_dtrsm_mt_rw(r, nth);
+	int r0 = tid*rw;
+	int r1 = r0+rw<r ? r0+rw : r;
+
+	if(r0>=r)
+		return;
+
+	// the workspace state is thread-local: each thread takes the allocations of its solve from its own slot
+	blasfeo_work_begin(arg->work+tid*arg->slotsize, arg->slotsize, &prev);
+
+	if(arg->left)
+		arg->fun(arg->m, r1-r0, arg->alpha, arg->sA, arg->ai, arg->aj, arg->sB, arg->bi, arg->bj+r0, arg->sD, arg->di, arg->dj+r0);
+	else
+		arg->fun(r1-r0, arg->n, arg->alpha, arg->sA, arg->ai, arg->aj, arg->sB, arg->bi+r0, arg->bj, arg->sD, arg->di+r0, arg->dj);
+
+	blasfeo_work_end(&prev);
+
+	return;
+
+	}
+
+
+
+// number of threads used to split the right-hand sides: at least TRSM_MT_RHS of them per thread
+static int blasfeo_hp_dtrsm_mt_nth(int left, int m, int n)
+	{
+	int k = left ? m : n;
+	int r = left ? n : m;
+	int nth = blasfeo_get_num_threads_flops(1.0*k*k*r);
+	if(k<TRSM_MT_RHS)
+		return 1;
+	int nth_max = r/TRSM_MT_RHS;
+	return nth<nth_max ? nth : nth_max;
+	}
+
+
+
+// use the tiled alg: large triangular matrix on the left and too few right-hand sides to split them
+static int blasfeo_hp_dtrsm_mt_blk(int left, int m, int n)
+	{
+	return left & m>=2*TRSM_MT_NB & blasfeo_get_num_threads_flops(1.0*m*m*n)>1 & blasfeo_hp_dtrsm_mt_nth(left, m, n)<2;
+	}
+
+
+
+// tiled alg: the solves with the diagonal blocks of the triangular matrix are performed by the single-threaded
+// routine, while the updates of the remaining rows go through the multi-threaded gemm;
+// forward substitution for lower not-transposed and upper transposed, backward substitution otherwise
+static void blasfeo_hp_dtrsm_left_blk_mt(void (*fun)(int, int, double, struct blasfeo_dmat *, int, int, struct blasfeo_dmat *, int, int, struct blasfeo_dmat *, int, int), int upper, int trans, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	const int nb = TRSM_MT_NB;
+
+	int forward = upper==trans;
+
+	int ii, i0, ib, r0, r1;
+
+	// the first solve and update read B and scale it by alpha, all the others work on D
+	struct blasfeo_dmat *sC = sB;
+	int ci = bi;
+	int cj = bj;
+	double beta = alpha;
+
+	for(ii=0; ii<m; ii+=nb)
+		{
+		ib = m-ii<nb ? m-ii : nb;
+		i0 = forward ? ii : m-ii-ib;
+		fun(ib, n, beta, sA, ai+i0, aj+i0, sC, ci+i0, cj, sD, di+i0, dj);
+		if(ii+ib<m)
+			{
+			r0 = forward ? i0+ib : 0;
+			r1 = forward ? m : i0;
+			if(trans)
+				blasfeo_hp_dgemm_tn(r1-r0, n, ib, -1.0, sA, ai+i0, aj+r0, sD, di+i0, dj, beta, sC, ci+r0, cj, sD, di+r0, dj);
+			else
+				blasfeo_hp_dgemm_nn(r1-r0, n, ib, -1.0, sA, ai+r0, aj+i0, sD, di+i0, dj, beta, sC, ci+r0, cj, sD, di+r0, dj);
+			}
+		sC = sD;
+		ci = di;
+		cj = dj;
+		beta = 1.0;
+		}
+
+	return;
+
+	}
+
+
+
+// multi-threaded alg: returns 1 if the operation has been performed, 0 if it is left to the single-threaded routine
+// blk marks the routines with a cache blocking alg, for the workspace of the threads
+static int blasfeo_hp_dtrsm_mt(void (*fun)(int, int, double, struct blasfeo_dmat *, int, int, struct blasfeo_dmat *, int, int, struct blasfeo_dmat *, int, int), int left, int upper, int trans, int blk, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	struct blasfeo_hp_dtrsm_mt_arg arg;
+	void *mem;
+
+	int nth = blasfeo_hp_dtrsm_mt_nth(left, m, n);
+
+	if(nth>1)
+		{
+		size_t slotsize = blasfeo_hp_dtrsm_mt_slotsize(left, blk, nth, m, n);
+		blasfeo_work_malloc(&mem, nth*slotsize);
+		arg.fun = fun;
+		arg.left = left;
+		arg.m = m;
+		arg.n = n;
+		arg.alpha = alpha;
+		arg.sA = sA;
+		arg.ai = ai;
+		arg.aj = aj;
+		arg.sB = sB;
+		arg.bi = bi;
+		arg.bj = bj;
+		arg.sD = sD;
+		arg.di = di;
+		arg.dj = dj;
+		arg.work = (char *) mem;
+		arg.slotsize = slotsize;
+		blasfeo_parallel_run(nth, &blasfeo_hp_dtrsm_mt_work, &arg);
+		blasfeo_work_free(mem);
+		return 1;
+		}
+
+	if(blasfeo_hp_dtrsm_mt_blk(left, m, n))
+		{
+		blasfeo_hp_dtrsm_left_blk_mt(fun, upper, trans, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+		return 1;
+		}
+
+	return 0;
+
+	}
+
+#endif // MULTI_THREAD
+
+
+
+// size-based choice between the llnn_2 and llnn_1 code paths of blasfeo_hp_dtrsm_llnn: nonzero selects llnn_2
+static int blasfeo_hp_dtrsm_llnn_alg(int m, int n)
+	{
+
+#if defined(TARGET_X64_INTEL_HASWELL)
+	if(m>=200 | n>=200 | m>K_MAX_STACK)
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(m>=64 | n>=64 | m>K_MAX_STACK)
+#else
+	if(m>=12 | n>=12 | m>K_MAX_STACK)
+#endif
+		{
+		return 1;
+		}
+
+	return 0;
+
+	}
+
+
+
+static void blasfeo_hp_dtrsm_llnn_run(int alg, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
 #if defined(PRINT_NAME)
@@ -794,6 +1081,11 @@ void blasfeo_hp_dtrsm_llnn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 	if(m<=0 | n<=0)
 		return;
 
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_llnn, 1, 0, 0, 0, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldb = sB->m;
@@ -854,13 +1146,7 @@ void blasfeo_hp_dtrsm_llnn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 
 
 
-#if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=200 | n>=200 | m>K_MAX_STACK)
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | m>K_MAX_STACK)
-#else
-	if(m>=12 | n>=12 | m>K_MAX_STACK)
-#endif
+	if(alg)
 		{
 		goto llnn_2;
 		}
@@ -1010,7 +1296,7 @@ llnn_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -1154,7 +1440,7 @@ llnn_2_left_4:
 goto llnn_2_return;
 
 llnn_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -1166,7 +1452,37 @@ llnn_2_return:
 
 
 
-void blasfeo_hp_dtrsm_llnu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+void blasfeo_hp_dtrsm_llnn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	blasfeo_hp_dtrsm_llnn_run(blasfeo_hp_dtrsm_llnn_alg(m, n), m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+
+	}
+
+
+
+// size-based choice between the llnu_2 and llnu_1 code paths of blasfeo_hp_dtrsm_llnu: nonzero selects llnu_2
+static int blasfeo_hp_dtrsm_llnu_alg(int m, int n)
+	{
+
+#if defined(TARGET_X64_INTEL_HASWELL)
+	if(m>=200 | n>=200 | m>K_MAX_STACK)
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(m>=64 | n>=64 | m>K_MAX_STACK)
+#else
+	if(m>=12 | n>=12 | m>K_MAX_STACK)
+#endif
+		{
+		return 1;
+		}
+
+	return 0;
+
+	}
+
+
+
+static void blasfeo_hp_dtrsm_llnu_run(int alg, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
 #if defined(PRINT_NAME)
@@ -1176,6 +1492,11 @@ void blasfeo_hp_dtrsm_llnu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 	if(m<=0 | n<=0)
 		return;
 
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_llnu, 1, 0, 0, 0, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldb = sB->m;
@@ -1236,13 +1557,7 @@ void blasfeo_hp_dtrsm_llnu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 
 
 
-#if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=200 | n>=200 | m>K_MAX_STACK)
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | m>K_MAX_STACK)
-#else
-	if(m>=12 | n>=12 | m>K_MAX_STACK)
-#endif
+	if(alg)
 		{
 		goto llnu_2;
 		}
@@ -1389,7 +1704,7 @@ llnu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -1530,7 +1845,7 @@ llnu_2_left_4:
 goto llnu_2_return;
 
 llnu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -1541,7 +1856,37 @@ llnu_2_return:
 
 
 
-void blasfeo_hp_dtrsm_lltn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+void blasfeo_hp_dtrsm_llnu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	blasfeo_hp_dtrsm_llnu_run(blasfeo_hp_dtrsm_llnu_alg(m, n), m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+
+	}
+
+
+
+// size-based choice between the lunn_2 and lltn_1 code paths of blasfeo_hp_dtrsm_lltn: nonzero selects lunn_2
+static int blasfeo_hp_dtrsm_lltn_alg(int m, int n)
+	{
+
+#if defined(TARGET_X64_INTEL_HASWELL)
+	if(m>=300 | n>=300 | m>K_MAX_STACK)
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(m>=64 | n>=64 | m>K_MAX_STACK)
+#else
+	if(m>=12 | n>=12 | m>K_MAX_STACK)
+#endif
+		{
+		return 1;
+		}
+
+	return 0;
+
+	}
+
+
+
+static void blasfeo_hp_dtrsm_lltn_run(int alg, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
 #if defined(PRINT_NAME)
@@ -1551,6 +1896,11 @@ void blasfeo_hp_dtrsm_lltn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 	if(m<=0 | n<=0)
 		return;
 
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_lltn, 1, 0, 1, 0, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldb = sB->m;
@@ -1611,13 +1961,7 @@ void blasfeo_hp_dtrsm_lltn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 
 
 
-#if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=300 | n>=300 | m>K_MAX_STACK)
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | m>K_MAX_STACK)
-#else
-	if(m>=12 | n>=12 | m>K_MAX_STACK)
-#endif
+	if(alg)
 		{
 		goto lunn_2;
 		}
@@ -1797,7 +2141,7 @@ lunn_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -1968,7 +2312,7 @@ lunn_2_left_4:
 	goto lunn_2_return;
 
 lunn_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -1980,7 +2324,37 @@ lunn_2_return:
 
 
 
-void blasfeo_hp_dtrsm_lltu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+void blasfeo_hp_dtrsm_lltn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	blasfeo_hp_dtrsm_lltn_run(blasfeo_hp_dtrsm_lltn_alg(m, n), m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+
+	}
+
+
+
+// size-based choice between the lunu_2 and lltu_1 code paths of blasfeo_hp_dtrsm_lltu: nonzero selects lunu_2
+static int blasfeo_hp_dtrsm_lltu_alg(int m, int n)
+	{
+
+#if defined(TARGET_X64_INTEL_HASWELL)
+	if(m>=300 | n>=300 | m>K_MAX_STACK)
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(m>=64 | n>=64 | m>K_MAX_STACK)
+#else
+	if(m>=12 | n>=12 | m>K_MAX_STACK)
+#endif
+		{
+		return 1;
+		}
+
+	return 0;
+
+	}
+
+
+
+static void blasfeo_hp_dtrsm_lltu_run(int alg, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
 #if defined(PRINT_NAME)
@@ -1990,6 +2364,11 @@ void blasfeo_hp_dtrsm_lltu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 	if(m<=0 | n<=0)
 		return;
 
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_lltu, 1, 0, 1, 0, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldb = sB->m;
@@ -2049,13 +2428,7 @@ void blasfeo_hp_dtrsm_lltu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 //	int n_min = n_cache<m_kernel_cache ? n_cache : m_kernel_cache;
 
 
-#if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=300 | n>=300 | m>K_MAX_STACK)
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | m>K_MAX_STACK)
-#else
-	if(m>=12 | n>=12 | m>K_MAX_STACK)
-#endif
+	if(alg)
 		{
 		goto lunu_2;
 		}
@@ -2229,7 +2602,7 @@ lunu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -2397,7 +2770,7 @@ lunu_2_left_4:
 	goto lunu_2_return;
 
 lunu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -2408,7 +2781,37 @@ lunu_2_return:
 
 
 
-void blasfeo_hp_dtrsm_lunn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+void blasfeo_hp_dtrsm_lltu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	blasfeo_hp_dtrsm_lltu_run(blasfeo_hp_dtrsm_lltu_alg(m, n), m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+
+	}
+
+
+
+// size-based choice between the lunn_2 and lunn_1 code paths of blasfeo_hp_dtrsm_lunn: nonzero selects lunn_2
+static int blasfeo_hp_dtrsm_lunn_alg(int m, int n)
+	{
+
+#if defined(TARGET_X64_INTEL_HASWELL)
+	if(m>=200 | n>=200 | m>K_MAX_STACK)
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(m>=64 | n>=64 | m>K_MAX_STACK)
+#else
+	if(m>=12 | n>=12 | m>K_MAX_STACK)
+#endif
+		{
+		return 1;
+		}
+
+	return 0;
+
+	}
+
+
+
+static void blasfeo_hp_dtrsm_lunn_run(int alg, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
 #if defined(PRINT_NAME)
@@ -2418,6 +2821,11 @@ void blasfeo_hp_dtrsm_lunn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 	if(m<=0 | n<=0)
 		return;
 
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_lunn, 1, 1, 0, 0, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldb = sB->m;
@@ -2478,13 +2886,7 @@ void blasfeo_hp_dtrsm_lunn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 
 
 lunn:
-#if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=200 | n>=200 | m>K_MAX_STACK)
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | m>K_MAX_STACK)
-#else
-	if(m>=12 | n>=12 | m>K_MAX_STACK)
-#endif
+	if(alg)
 		{
 		goto lunn_2;
 		}
@@ -2660,7 +3062,7 @@ lunn_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -2831,7 +3233,7 @@ lunn_2_left_4:
 	goto lunn_2_return;
 
 lunn_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -2843,16 +3245,51 @@ lunn_2_return:
 
 
 
-void blasfeo_hp_dtrsm_lunu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+void blasfeo_hp_dtrsm_lunn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
-#if defined(PRINT_NAME)
-	printf("\nblasfeo_hp_dtrsm_lunu (cm) %d %d %f %p %d %d %p %d %d %p %d %d\n", m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
-#endif
+	blasfeo_hp_dtrsm_lunn_run(blasfeo_hp_dtrsm_lunn_alg(m, n), m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
 
-	if(m<=0 | n<=0)
+	}
+
+
+
+// size-based choice between the lunu_2 and lunu_1 code paths of blasfeo_hp_dtrsm_lunu: nonzero selects lunu_2
+static int blasfeo_hp_dtrsm_lunu_alg(int m, int n)
+	{
+
+#if defined(TARGET_X64_INTEL_HASWELL)
+	if(m>=200 | n>=200 | m>K_MAX_STACK)
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(m>=64 | n>=64 | m>K_MAX_STACK)
+#else
+	if(m>=12 | n>=12 | m>K_MAX_STACK)
+#endif
+		{
+		return 1;
+		}
+
+	return 0;
+
+	}
+
+
+
+static void blasfeo_hp_dtrsm_lunu_run(int alg, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+#if defined(PRINT_NAME)
+	printf("\nblasfeo_hp_dtrsm_lunu (cm) %d %d %f %p %d %d %p %d %d %p %d %d\n", m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+#endif
+
+	if(m<=0 | n<=0)
 		return;
 
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_lunu, 1, 1, 0, 0, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldb = sB->m;
@@ -2913,13 +3350,7 @@ void blasfeo_hp_dtrsm_lunu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 
 
 lunu:
-#if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=200 | n>=200 | m>K_MAX_STACK)
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | m>K_MAX_STACK)
-#else
-	if(m>=12 | n>=12 | m>K_MAX_STACK)
-#endif
+	if(alg)
 		{
 		goto lunu_2;
 		}
@@ -3088,7 +3519,7 @@ lunu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -3256,7 +3687,7 @@ lunu_2_left_4:
 	goto lunu_2_return;
 
 lunu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -3267,7 +3698,39 @@ lunu_2_return:
 
 
 
-void blasfeo_hp_dtrsm_lutn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+void blasfeo_hp_dtrsm_lunu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	blasfeo_hp_dtrsm_lunu_run(blasfeo_hp_dtrsm_lunu_alg(m, n), m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+
+	}
+
+
+
+// size-based choice between the lutn_n1 and llnn_2 code paths of blasfeo_hp_dtrsm_lutn: nonzero selects lutn_n1
+static int blasfeo_hp_dtrsm_lutn_alg(int m, int n)
+	{
+
+	int k0 = m;
+
+#if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A57) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+	if(m<300 & n<300 & k0<=K_MAX_STACK)
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(m<64 & n<64 & k0<=K_MAX_STACK)
+#else
+	if(m<12 & n<12 & k0<=K_MAX_STACK)
+#endif
+		{
+		return 1;
+		}
+
+	return 0;
+
+	}
+
+
+
+static void blasfeo_hp_dtrsm_lutn_run(int alg, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
 #if defined(PRINT_NAME)
@@ -3277,6 +3740,14 @@ void blasfeo_hp_dtrsm_lutn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 	if(m<=0 | n<=0)
 		return;
 
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_lutn, 1, 1, 1, 1, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldb = sB->m;
@@ -3353,13 +3824,7 @@ void blasfeo_hp_dtrsm_lutn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 lutn:
 //	goto lutn_m1;
 //	goto llnn_2;
-#if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A57) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
-	if(m<300 & n<300 & k0<=K_MAX_STACK)
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m<64 & n<64 & k0<=K_MAX_STACK)
-#else
-	if(m<12 & n<12 & k0<=K_MAX_STACK)
-#endif
+	if(alg)
 		{
 		goto lutn_n1;
 		}
@@ -3535,9 +4000,9 @@ llnn_2:
 
 	// cache blocking alg
 
-	mc0 = MC;
-	nc0 = NC;
-	kc0 = KC;
+	mc0 = bs.d_mc;
+	nc0 = bs.d_nc;
+	kc0 = bs.d_kc;
 
 	// these must all be multiple of ps !!!
 //	mc0 = 12;
@@ -3555,9 +4020,9 @@ llnn_2:
 	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
 	tT_size = (tT_size + 4096 - 1) / 4096 * 4096;
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(&bs)==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
 		}
 	else
 		{
@@ -3670,16 +4135,19 @@ llnn_2:
 
 		}
 	
-	free(mem);
+	if(blasfeo_is_init_block_size(&bs)==0)
+		{
+		blasfeo_work_free(mem);
+		}
 	return;
 
 #else
 
 	// cache blocking alg
 
-	mc0 = NC; // XXX
-	nc0 = MC; // XXX
-	kc0 = KC;
+	mc0 = bs.d_nc; // XXX
+	nc0 = bs.d_mc; // XXX
+	kc0 = bs.d_kc;
 
 	// these must all be multiple of ps !!!
 //	mc0 = 4;
@@ -3697,9 +4165,9 @@ llnn_2:
 	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
 	tT_size = (tT_size + 4096 - 1) / 4096 * 4096;
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(&bs)==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
 		}
 	else
 		{
@@ -3781,7 +4249,10 @@ llnn_2:
 
 		}
 
-	free(mem);
+	if(blasfeo_is_init_block_size(&bs)==0)
+		{
+		blasfeo_work_free(mem);
+		}
 	return;
 
 #endif
@@ -3792,7 +4263,7 @@ llnn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, n, &tB, (void *) (mem_align+tA_size));
@@ -3812,7 +4283,7 @@ llnn_2:
 
 	blasfeo_hp_dtrsm_llnn_m2(m, n, alpha, pA, sda, dA, B, ldb, D, ldd, pB, sdb);
 
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 #endif
@@ -3824,7 +4295,37 @@ llnn_2:
 
 
 
-void blasfeo_hp_dtrsm_lutu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+void blasfeo_hp_dtrsm_lutn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	blasfeo_hp_dtrsm_lutn_run(blasfeo_hp_dtrsm_lutn_alg(m, n), m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+
+	}
+
+
+
+// size-based choice between the llnu_2 and lutu_1 code paths of blasfeo_hp_dtrsm_lutu: nonzero selects llnu_2
+static int blasfeo_hp_dtrsm_lutu_alg(int m, int n)
+	{
+
+#if defined(TARGET_X64_INTEL_HASWELL)
+	if(m>=300 | n>=300 | m>K_MAX_STACK)
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(m>=64 | n>=64 | m>K_MAX_STACK)
+#else
+	if(m>=12 | n>=12 | m>K_MAX_STACK)
+#endif
+		{
+		return 1;
+		}
+
+	return 0;
+
+	}
+
+
+
+static void blasfeo_hp_dtrsm_lutu_run(int alg, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
 #if defined(PRINT_NAME)
@@ -3834,6 +4335,11 @@ void blasfeo_hp_dtrsm_lutu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 	if(m<=0 | n<=0)
 		return;
 
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_lutu, 1, 1, 1, 0, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldb = sB->m;
@@ -3894,13 +4400,7 @@ void blasfeo_hp_dtrsm_lutu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 
 
 lutu:
-#if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=300 | n>=300 | m>K_MAX_STACK)
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | m>K_MAX_STACK)
-#else
-	if(m>=12 | n>=12 | m>K_MAX_STACK)
-#endif
+	if(alg)
 		{
 		goto llnu_2;
 		}
@@ -4045,7 +4545,7 @@ llnu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -4186,7 +4686,7 @@ llnu_2_left_4:
 goto llnu_2_return;
 
 llnu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -4197,8 +4697,40 @@ llnu_2_return:
 
 
 
+void blasfeo_hp_dtrsm_lutu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	blasfeo_hp_dtrsm_lutu_run(blasfeo_hp_dtrsm_lutu_alg(m, n), m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+
+	}
+
+
+
 // TODO optimize for cortex A57 !!!!!
-void blasfeo_hp_dtrsm_rlnn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+// size-based choice between the rlnn_1 and rutn_2 code paths of blasfeo_hp_dtrsm_rlnn: nonzero selects rlnn_1
+static int blasfeo_hp_dtrsm_rlnn_alg(int m, int n)
+	{
+
+	int k0 = n;
+
+#if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A57) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+	if(m<=300 & n<=300 & k0<=K_MAX_STACK)
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(m<64 & n<64 & k0<=K_MAX_STACK)
+#else
+	if(m<12 & n<12 & k0<=K_MAX_STACK)
+#endif
+		{
+		return 1;
+		}
+
+	return 0;
+
+	}
+
+
+
+static void blasfeo_hp_dtrsm_rlnn_run(int alg, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
 #if defined(PRINT_NAME)
@@ -4208,6 +4740,14 @@ void blasfeo_hp_dtrsm_rlnn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 	if(m<=0 | n<=0)
 		return;
 
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_rlnn, 0, 0, 0, 1, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldb = sB->m;
@@ -4284,13 +4824,7 @@ void blasfeo_hp_dtrsm_rlnn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 
 //	goto rlnn_1;
 //	goto rutn_2;
-#if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A57) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
-	if(m<=300 & n<=300 & k0<=K_MAX_STACK)
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m<64 & n<64 & k0<=K_MAX_STACK)
-#else
-	if(m<12 & n<12 & k0<=K_MAX_STACK)
-#endif
+	if(alg)
 		{
 		goto rlnn_1;
 		}
@@ -4454,9 +4988,9 @@ rutn_2:
 
 	// cache blocking alg
 
-	mc0 = MC;
-	nc0 = NC;
-	kc0 = KC;
+	mc0 = bs.d_mc;
+	nc0 = bs.d_nc;
+	kc0 = bs.d_kc;
 
 	// these must all be multiple of ps !!!
 //	mc0 = 20;
@@ -4474,9 +5008,9 @@ rutn_2:
 	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
 	tT_size = (tT_size + 4096 - 1) / 4096 * 4096;
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(&bs)==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
 		}
 	else
 		{
@@ -4562,7 +5096,10 @@ rutn_2:
 
 		}
 	
-	free(mem);
+	if(blasfeo_is_init_block_size(&bs)==0)
+		{
+		blasfeo_work_free(mem);
+		}
 	return;
 
 #else
@@ -4571,7 +5108,7 @@ rutn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, n, &tB, (void *) (mem_align+tA_size));
@@ -4591,7 +5128,7 @@ rutn_2:
 
 	blasfeo_hp_dtrsm_rutn_m2(m, n, alpha, pA, sda, dA, B, ldb, D, ldd, pB, sdb);
 
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 #endif
@@ -4603,7 +5140,37 @@ rutn_2:
 
 
 
-void blasfeo_hp_dtrsm_rlnu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+void blasfeo_hp_dtrsm_rlnn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	blasfeo_hp_dtrsm_rlnn_run(blasfeo_hp_dtrsm_rlnn_alg(m, n), m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+
+	}
+
+
+
+// size-based choice between the rutu_2 and rlnu_1 code paths of blasfeo_hp_dtrsm_rlnu: nonzero selects rutu_2
+static int blasfeo_hp_dtrsm_rlnu_alg(int m, int n)
+	{
+
+#if defined(TARGET_X64_INTEL_HASWELL)
+	if(m>300 | n>300 | n>K_MAX_STACK)
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(m>=64 | n>=64 | n>K_MAX_STACK)
+#else
+	if(m>=12 | n>=12 | n>K_MAX_STACK)
+#endif
+		{
+		return 1;
+		}
+
+	return 0;
+
+	}
+
+
+
+static void blasfeo_hp_dtrsm_rlnu_run(int alg, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
 #if defined(PRINT_NAME)
@@ -4613,6 +5180,11 @@ void blasfeo_hp_dtrsm_rlnu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 	if(m<=0 | n<=0)
 		return;
 
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_rlnu, 0, 0, 0, 0, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldb = sB->m;
@@ -4675,15 +5247,8 @@ void blasfeo_hp_dtrsm_rlnu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 
 
 rlnu:
-#if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>300 | n>300 | n>K_MAX_STACK)
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | n>K_MAX_STACK)
-#else
-	if(m>=12 | n>=12 | n>K_MAX_STACK)
-#endif
+	if(alg)
 		{
-//		pack_tran = 1;
 		goto rutu_2;
 		}
 	else
@@ -4841,7 +5406,7 @@ rutu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -4997,7 +5562,7 @@ rutu_2_left_4:
 	goto rutu_2_return;
 
 rutu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -5008,7 +5573,40 @@ rutu_2_return:
 
 
 
-void blasfeo_hp_dtrsm_rltn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+void blasfeo_hp_dtrsm_rlnu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	blasfeo_hp_dtrsm_rlnu_run(blasfeo_hp_dtrsm_rlnu_alg(m, n), m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+
+	}
+
+
+
+// size-based choice between the rltn_1 and rltn_2 code paths of blasfeo_hp_dtrsm_rltn: nonzero selects rltn_1
+static int blasfeo_hp_dtrsm_rltn_alg(int m, int n)
+	{
+
+	int k0 = n;
+
+#if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A57) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+	if(m<200 & n<200 & k0<=K_MAX_STACK)
+//	if(m<256 & n<256 & k0<=K_MAX_STACK)
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(m<64 & n<64 & k0<=K_MAX_STACK)
+#else
+	if(m<12 & n<12 & k0<=K_MAX_STACK)
+#endif
+		{
+		return 1;
+		}
+
+	return 0;
+
+	}
+
+
+
+static void blasfeo_hp_dtrsm_rltn_run(int alg, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
 #if defined(PRINT_NAME)
@@ -5018,6 +5616,14 @@ void blasfeo_hp_dtrsm_rltn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 	if(m<=0 | n<=0)
 		return;
 
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_rltn, 0, 0, 1, 1, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldb = sB->m;
@@ -5094,14 +5700,7 @@ void blasfeo_hp_dtrsm_rltn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 
 //	goto rltn_1;
 //	goto rltn_2;
-#if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A57) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
-	if(m<200 & n<200 & k0<=K_MAX_STACK)
-//	if(m<256 & n<256 & k0<=K_MAX_STACK)
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m<64 & n<64 & k0<=K_MAX_STACK)
-#else
-	if(m<12 & n<12 & k0<=K_MAX_STACK)
-#endif
+	if(alg)
 		{
 		goto rltn_1;
 		}
@@ -5236,9 +5835,9 @@ rltn_2:
 
 	// cache blocking alg
 
-	mc0 = MC;
-	nc0 = NC;
-	kc0 = KC;
+	mc0 = bs.d_mc;
+	nc0 = bs.d_nc;
+	kc0 = bs.d_kc;
 
 	// these must all be multiple of ps !!!
 //	mc0 = 12;
@@ -5256,9 +5855,9 @@ rltn_2:
 	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
 	tT_size = (tT_size + 4096 - 1) / 4096 * 4096;
-	if(blasfeo_is_init()==0)
+	if(blasfeo_is_init_block_size(&bs)==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
 		}
 	else
 		{
@@ -5341,7 +5940,10 @@ rltn_2:
 
 		}
 	
-	free(mem);
+	if(blasfeo_is_init_block_size(&bs)==0)
+		{
+		blasfeo_work_free(mem);
+		}
 	return;
 
 #else
@@ -5350,7 +5952,7 @@ rltn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, n, &tB, (void *) (mem_align+tA_size));
@@ -5370,7 +5972,7 @@ rltn_2:
 
 	blasfeo_hp_dtrsm_rltn_m2(m, n, alpha, pA, sda, dA, B, ldb, D, ldd, pB, sdb);
 
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 #endif
@@ -5382,32 +5984,67 @@ rltn_2:
 
 
 
-void blasfeo_hp_dtrsm_rltu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+void blasfeo_hp_dtrsm_rltn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
-#if defined(PRINT_NAME)
-	printf("\nblasfeo_hp_dtrsm_rltu (cm) %d %d %f %p %d %d %p %d %d %p %d %d\n", m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
-#endif
-
-	if(m<=0 | n<=0)
-		return;
+	blasfeo_hp_dtrsm_rltn_run(blasfeo_hp_dtrsm_rltn_alg(m, n), m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
 
-	// extract pointer to column-major matrices from structures
-	int lda = sA->m;
-	int ldb = sB->m;
-	int ldd = sD->m;
-	double *A = sA->pA + ai + aj*lda;
-	double *B = sB->pA + bi + bj*ldb;
-	double *D = sD->pA + di + dj*ldd;
+	}
 
-//	printf("\n%p %d %p %d %p %d\n", A, lda, B, ldb);
 
-	int ii, jj;
 
-	const int ps = 4; //D_PS;
+// size-based choice between the rltu_2 and rltu_1 code paths of blasfeo_hp_dtrsm_rltu: nonzero selects rltu_2
+static int blasfeo_hp_dtrsm_rltu_alg(int m, int n)
+	{
 
-#if defined(TARGET_GENERIC)
-	double pd0[K_MAX_STACK];
+#if defined(TARGET_X64_INTEL_HASWELL)
+	if(m>=200 | n>=200 | n>K_MAX_STACK)
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(m>=64 | n>=64 | n>K_MAX_STACK)
+#else
+	if(m>=12 | n>=12 | n>K_MAX_STACK)
+#endif
+		{
+		return 1;
+		}
+
+	return 0;
+
+	}
+
+
+
+static void blasfeo_hp_dtrsm_rltu_run(int alg, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+#if defined(PRINT_NAME)
+	printf("\nblasfeo_hp_dtrsm_rltu (cm) %d %d %f %p %d %d %p %d %d %p %d %d\n", m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+#endif
+
+	if(m<=0 | n<=0)
+		return;
+
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_rltu, 0, 0, 1, 0, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
+	// extract pointer to column-major matrices from structures
+	int lda = sA->m;
+	int ldb = sB->m;
+	int ldd = sD->m;
+	double *A = sA->pA + ai + aj*lda;
+	double *B = sB->pA + bi + bj*ldb;
+	double *D = sD->pA + di + dj*ldd;
+
+//	printf("\n%p %d %p %d %p %d\n", A, lda, B, ldb);
+
+	int ii, jj;
+
+	const int ps = 4; //D_PS;
+
+#if defined(TARGET_GENERIC)
+	double pd0[K_MAX_STACK];
 #else
 	ALIGNED( double pd0[K_MAX_STACK], 64 );
 #endif
@@ -5454,15 +6091,8 @@ void blasfeo_hp_dtrsm_rltu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 
 
 rltu:
-#if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=200 | n>=200 | n>K_MAX_STACK)
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | n>K_MAX_STACK)
-#else
-	if(m>=12 | n>=12 | n>K_MAX_STACK)
-#endif
+	if(alg)
 		{
-//		pack_tran = 0;
 		goto rltu_2;
 		}
 	else
@@ -5591,7 +6221,7 @@ rltu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -5752,7 +6382,7 @@ rltu_2_left_4:
 goto rltu_2_return;
 
 rltu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 	// never to get here
@@ -5762,7 +6392,37 @@ rltu_2_return:
 
 
 
-void blasfeo_hp_dtrsm_runn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+void blasfeo_hp_dtrsm_rltu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	blasfeo_hp_dtrsm_rltu_run(blasfeo_hp_dtrsm_rltu_alg(m, n), m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+
+	}
+
+
+
+// size-based choice between the rltn_2 and runn_1 code paths of blasfeo_hp_dtrsm_runn: nonzero selects rltn_2
+static int blasfeo_hp_dtrsm_runn_alg(int m, int n)
+	{
+
+#if defined(TARGET_X64_INTEL_HASWELL)
+	if(m>=300 | n>=300 | n>K_MAX_STACK)
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(m>=64 | n>=64 | n>K_MAX_STACK)
+#else
+	if(m>=12 | n>=12 | n>K_MAX_STACK)
+#endif
+		{
+		return 1;
+		}
+
+	return 0;
+
+	}
+
+
+
+static void blasfeo_hp_dtrsm_runn_run(int alg, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
 #if defined(PRINT_NAME)
@@ -5772,6 +6432,11 @@ void blasfeo_hp_dtrsm_runn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 	if(m<=0 | n<=0)
 		return;
 
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_runn, 0, 1, 0, 0, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldb = sB->m;
@@ -5834,15 +6499,8 @@ void blasfeo_hp_dtrsm_runn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 
 
 runn:
-#if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=300 | n>=300 | n>K_MAX_STACK)
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | n>K_MAX_STACK)
-#else
-	if(m>=12 | n>=12 | n>K_MAX_STACK)
-#endif
+	if(alg)
 		{
-//		pack_tran = 1;
 		goto rltn_2;
 		}
 	else
@@ -5974,7 +6632,7 @@ rltn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -6116,7 +6774,7 @@ rltn_2_left_4:
 goto rltn_2_return;
 
 rltn_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -6127,7 +6785,37 @@ rltn_2_return:
 
 
 
-void blasfeo_hp_dtrsm_runu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+void blasfeo_hp_dtrsm_runn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	blasfeo_hp_dtrsm_runn_run(blasfeo_hp_dtrsm_runn_alg(m, n), m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+
+	}
+
+
+
+// size-based choice between the rltu_2 and runu_1 code paths of blasfeo_hp_dtrsm_runu: nonzero selects rltu_2
+static int blasfeo_hp_dtrsm_runu_alg(int m, int n)
+	{
+
+#if defined(TARGET_X64_INTEL_HASWELL)
+	if(m>=300 | n>=300 | n>K_MAX_STACK)
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(m>=64 | n>=64 | n>K_MAX_STACK)
+#else
+	if(m>=12 | n>=12 | n>K_MAX_STACK)
+#endif
+		{
+		return 1;
+		}
+
+	return 0;
+
+	}
+
+
+
+static void blasfeo_hp_dtrsm_runu_run(int alg, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
 #if defined(PRINT_NAME)
@@ -6137,6 +6825,11 @@ void blasfeo_hp_dtrsm_runu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 	if(m<=0 | n<=0)
 		return;
 
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_runu, 0, 1, 0, 0, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldb = sB->m;
@@ -6199,15 +6892,8 @@ void blasfeo_hp_dtrsm_runu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 
 
 runu:
-#if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=300 | n>=300 | n>K_MAX_STACK)
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | n>K_MAX_STACK)
-#else
-	if(m>=12 | n>=12 | n>K_MAX_STACK)
-#endif
+	if(alg)
 		{
-//		pack_tran = 1;
 		goto rltu_2;
 		}
 	else
@@ -6334,7 +7020,7 @@ rltu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -6473,7 +7159,7 @@ rltu_2_left_4:
 goto rltu_2_return;
 
 rltu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 	// never to get here
@@ -6483,7 +7169,37 @@ rltu_2_return:
 
 
 
-void blasfeo_hp_dtrsm_rutn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+void blasfeo_hp_dtrsm_runu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	blasfeo_hp_dtrsm_runu_run(blasfeo_hp_dtrsm_runu_alg(m, n), m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+
+	}
+
+
+
+// size-based choice between the rutn_2 and rutn_1 code paths of blasfeo_hp_dtrsm_rutn: nonzero selects rutn_2
+static int blasfeo_hp_dtrsm_rutn_alg(int m, int n)
+	{
+
+#if defined(TARGET_X64_INTEL_HASWELL)
+	if(m>=200 | n>=200 | n>K_MAX_STACK)
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(m>=64 | n>=64 | n>K_MAX_STACK)
+#else
+	if(m>=12 | n>=12 | n>K_MAX_STACK)
+#endif
+		{
+		return 1;
+		}
+
+	return 0;
+
+	}
+
+
+
+static void blasfeo_hp_dtrsm_rutn_run(int alg, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
 #if defined(PRINT_NAME)
@@ -6493,6 +7209,11 @@ void blasfeo_hp_dtrsm_rutn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 	if(m<=0 | n<=0)
 		return;
 
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_rutn, 0, 1, 1, 0, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldb = sB->m;
@@ -6555,13 +7276,7 @@ void blasfeo_hp_dtrsm_rutn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 
 
 rutn:
-#if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=200 | n>=200 | n>K_MAX_STACK)
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | n>K_MAX_STACK)
-#else
-	if(m>=12 | n>=12 | n>K_MAX_STACK)
-#endif
+	if(alg)
 		{
 		goto rutn_2;
 		}
@@ -6723,7 +7438,7 @@ rutn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -6893,7 +7608,7 @@ rutn_2_left_4:
 	goto rutn_2_return;
 
 rutn_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 	// never to get here
@@ -6903,7 +7618,37 @@ rutn_2_return:
 
 
 
-void blasfeo_hp_dtrsm_rutu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+void blasfeo_hp_dtrsm_rutn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	blasfeo_hp_dtrsm_rutn_run(blasfeo_hp_dtrsm_rutn_alg(m, n), m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+
+	}
+
+
+
+// size-based choice between the rutu_2 and rutu_1 code paths of blasfeo_hp_dtrsm_rutu: nonzero selects rutu_2
+static int blasfeo_hp_dtrsm_rutu_alg(int m, int n)
+	{
+
+#if defined(TARGET_X64_INTEL_HASWELL)
+	if(m>=200 | n>=200 | n>K_MAX_STACK)
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	if(m>=64 | n>=64 | n>K_MAX_STACK)
+#else
+	if(m>=12 | n>=12 | n>K_MAX_STACK)
+#endif
+		{
+		return 1;
+		}
+
+	return 0;
+
+	}
+
+
+
+static void blasfeo_hp_dtrsm_rutu_run(int alg, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
 #if defined(PRINT_NAME)
@@ -6913,6 +7658,11 @@ void blasfeo_hp_dtrsm_rutu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 	if(m<=0 | n<=0)
 		return;
 
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_rutu, 0, 1, 1, 0, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 	// extract pointer to column-major matrices from structures
 	int lda = sA->m;
 	int ldb = sB->m;
@@ -6975,15 +7725,8 @@ void blasfeo_hp_dtrsm_rutu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 
 
 rutu:
-#if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=200 | n>=200 | n>K_MAX_STACK)
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | n>K_MAX_STACK)
-#else
-	if(m>=12 | n>=12 | n>K_MAX_STACK)
-#endif
+	if(alg)
 		{
-//		pack_tran = 0;
 		goto rutu_2;
 		}
 	else
@@ -7141,7 +7884,7 @@ rutu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -7307,7 +8050,7 @@ rutu_2_left_4:
 	goto rutu_2_return;
 
 rutu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 	// never to get here
@@ -7317,87 +8060,451 @@ rutu_2_return:
 
 
 
-#if defined(LA_HIGH_PERFORMANCE)
-
+void blasfeo_hp_dtrsm_rutu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
 
+	blasfeo_hp_dtrsm_rutu_run(blasfeo_hp_dtrsm_rutu_alg(m, n), m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
 
-void blasfeo_dtrsm_llnn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
-	{
-	blasfeo_hp_dtrsm_llnn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
-	return;
 	}
 
 
 
-void blasfeo_dtrsm_llnu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+// workspace size in bytes of the single-threaded trsm routines, with the triangular matrix on the left (of size m)
+// or on the right (of size n): upper bound over the algorithms that can be selected, blk marks the routines with a
+// cache blocking alg
+static size_t blasfeo_hp_dtrsm_st_worksize(int m, int n, int left, int blk)
 	{
-	blasfeo_hp_dtrsm_llnu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
-	return;
-	}
-
 
+	const int ps = PS;
 
-void blasfeo_dtrsm_lltn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
-	{
-	blasfeo_hp_dtrsm_lltn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
-	return;
-	}
+	size_t size, tmp;
+	int k0, k1, m1, n1;
 
+	if(m<=0 | n<=0)
+		return 0;
 
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
 
-void blasfeo_dtrsm_lltu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
-	{
-	blasfeo_hp_dtrsm_lltu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
-	return;
-	}
+	k0 = left ? m : n;
 
+	// small matrix
+	if(m<12 & n<12 & k0<=K_MAX_STACK)
+		return 0;
 
+	m1 = (m+128-1)/128*128;
+	n1 = (n+128-1)/128*128;
+	k1 = left ? m1 : n1;
 
-void blasfeo_dtrsm_lunn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
-	{
-	blasfeo_hp_dtrsm_lunn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
-	return;
-	}
+	// packed triangular matrix and kernel panel
+	size = blasfeo_work_memsize(blasfeo_pm_memsize_dmat(ps, M_KERNEL, k1)+blasfeo_pm_memsize_dmat(ps, k1, k1)+64);
 
+	if(blk)
+		{
+#if ! defined(TARGET_X64_INTEL_SKYLAKE_X)
+		// cache blocking alg, unless the buffer of blasfeo_init is used
+		tmp = blasfeo_is_init_block_size(&bs)==0 ? blasfeo_work_memsize(blasfeo_memsize_buffer_block_size(&bs)) : 0;
+#else
+		tmp = blasfeo_work_memsize(blasfeo_pm_memsize_dmat(ps, k1, k1)+blasfeo_pm_memsize_dmat(ps, m1, n1)+64);
+#endif
+		size = tmp>size ? tmp : size;
+		}
 
+	return size;
 
-void blasfeo_dtrsm_lunu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
-	{
-	blasfeo_hp_dtrsm_lunu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
-	return;
 	}
 
 
 
-void blasfeo_dtrsm_lutn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+#if defined(MULTI_THREAD)
+// workspace slot of each thread, sized for the solve of its block of right-hand sides
+static size_t blasfeo_hp_dtrsm_mt_slotsize(int left, int blk, int nth, int m, int n)
 	{
-	blasfeo_hp_dtrsm_lutn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
-	return;
-	}
 
+	struct blasfeo_block_size bs;
+	blasfeo_get_block_size(&bs);
 
+	size_t size;
 
-void blasfeo_dtrsm_lutu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
-	{
-	blasfeo_hp_dtrsm_lutu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
-	return;
-	}
+	int rw = blasfeo_hp_dtrsm_mt_rw(left ? n : m, nth);
 
+	if(left)
+		size = blasfeo_hp_dtrsm_st_worksize(m, rw, left, blk);
+	else
+		size = blasfeo_hp_dtrsm_st_worksize(rw, n, left, blk);
 
+	// the buffer of blasfeo_init is only available to the calling thread
+	if(blk & blasfeo_is_init_block_size(&bs))
+		size += blasfeo_work_memsize(blasfeo_memsize_buffer_block_size(&bs));
+
+	return (size+63)/64*64;
 
-void blasfeo_dtrsm_rlnn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
-	{
-	blasfeo_hp_dtrsm_rlnn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
-	return;
 	}
+#endif
 
 
 
-void blasfeo_dtrsm_rlnu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+// workspace size in bytes of the trsm routines, including the multi-threaded algs
+static size_t blasfeo_hp_dtrsm_worksize(int m, int n, int left, int blk)
 	{
-	blasfeo_hp_dtrsm_rlnu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
-	return;
-	}
+
+	if(m<=0 | n<=0)
+		return 0;
+
+#if defined(MULTI_THREAD)
+	size_t size, tmp;
+
+	// split of the right-hand sides: one slot per thread
+	int nth = blasfeo_hp_dtrsm_mt_nth(left, m, n);
+	if(nth>1)
+		return blasfeo_work_memsize(nth*blasfeo_hp_dtrsm_mt_slotsize(left, blk, nth, m, n));
+
+	// tiled alg: single-threaded solves with the diagonal blocks, and gemm updates
+	if(blasfeo_hp_dtrsm_mt_blk(left, m, n))
+		{
+		size = blasfeo_hp_dtrsm_worksize(TRSM_MT_NB, n, left, blk);
+		tmp = blasfeo_hp_dgemm_nn_worksize(m-TRSM_MT_NB, n, TRSM_MT_NB);
+		size = tmp>size ? tmp : size;
+		tmp = blasfeo_hp_dgemm_tn_worksize(m-TRSM_MT_NB, n, TRSM_MT_NB);
+		size = tmp>size ? tmp : size;
+		return size;
+		}
+#endif
+
+	return blasfeo_hp_dtrsm_st_worksize(m, n, left, blk);
+
+	}
+
+
+
+size_t blasfeo_hp_dtrsm_llnn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_worksize(m, n, 1, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrsm_llnu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_worksize(m, n, 1, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrsm_lltn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_worksize(m, n, 1, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrsm_lltu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_worksize(m, n, 1, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrsm_lunn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_worksize(m, n, 1, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrsm_lunu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_worksize(m, n, 1, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrsm_lutn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_worksize(m, n, 1, 1);
+	}
+
+
+
+size_t blasfeo_hp_dtrsm_lutu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_worksize(m, n, 1, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrsm_rlnn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_worksize(m, n, 0, 1);
+	}
+
+
+
+size_t blasfeo_hp_dtrsm_rlnu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_worksize(m, n, 0, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrsm_rltn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_worksize(m, n, 0, 1);
+	}
+
+
+
+size_t blasfeo_hp_dtrsm_rltu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_worksize(m, n, 0, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrsm_runn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_worksize(m, n, 0, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrsm_runu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_worksize(m, n, 0, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrsm_rutn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_worksize(m, n, 0, 0);
+	}
+
+
+
+size_t blasfeo_hp_dtrsm_rutu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_worksize(m, n, 0, 0);
+	}
+
+
+
+// execution plan: the variant and the code path are resolved at plan creation for the given sizes and offsets,
+// while the multi-threaded split is still decided at execution
+
+typedef int (*blasfeo_hp_dtrsm_alg_t)(int m, int n);
+typedef void (*blasfeo_hp_dtrsm_run_t)(int alg, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+
+// variants indexed by 8*right + 4*upper + 2*trans + unit
+static const blasfeo_hp_dtrsm_alg_t blasfeo_hp_dtrsm_alg_tab[16] =
+	{
+	&blasfeo_hp_dtrsm_llnn_alg,
+	&blasfeo_hp_dtrsm_llnu_alg,
+	&blasfeo_hp_dtrsm_lltn_alg,
+	&blasfeo_hp_dtrsm_lltu_alg,
+	&blasfeo_hp_dtrsm_lunn_alg,
+	&blasfeo_hp_dtrsm_lunu_alg,
+	&blasfeo_hp_dtrsm_lutn_alg,
+	&blasfeo_hp_dtrsm_lutu_alg,
+	&blasfeo_hp_dtrsm_rlnn_alg,
+	&blasfeo_hp_dtrsm_rlnu_alg,
+	&blasfeo_hp_dtrsm_rltn_alg,
+	&blasfeo_hp_dtrsm_rltu_alg,
+	&blasfeo_hp_dtrsm_runn_alg,
+	&blasfeo_hp_dtrsm_runu_alg,
+	&blasfeo_hp_dtrsm_rutn_alg,
+	&blasfeo_hp_dtrsm_rutu_alg,
+	};
+
+static const blasfeo_hp_dtrsm_run_t blasfeo_hp_dtrsm_run_tab[16] =
+	{
+	&blasfeo_hp_dtrsm_llnn_run,
+	&blasfeo_hp_dtrsm_llnu_run,
+	&blasfeo_hp_dtrsm_lltn_run,
+	&blasfeo_hp_dtrsm_lltu_run,
+	&blasfeo_hp_dtrsm_lunn_run,
+	&blasfeo_hp_dtrsm_lunu_run,
+	&blasfeo_hp_dtrsm_lutn_run,
+	&blasfeo_hp_dtrsm_lutu_run,
+	&blasfeo_hp_dtrsm_rlnn_run,
+	&blasfeo_hp_dtrsm_rlnu_run,
+	&blasfeo_hp_dtrsm_rltn_run,
+	&blasfeo_hp_dtrsm_rltu_run,
+	&blasfeo_hp_dtrsm_runn_run,
+	&blasfeo_hp_dtrsm_runu_run,
+	&blasfeo_hp_dtrsm_rutn_run,
+	&blasfeo_hp_dtrsm_rutu_run,
+	};
+
+
+
+void blasfeo_hp_dtrsm_plan(char side, char uplo, char ta, char diag, int m, int n, int ai, int aj, int bi, int bj, int di, int dj, struct blasfeo_dplan *plan)
+	{
+
+	int right, upper, trans, unit;
+
+	if(side=='l' | side=='L')
+		{
+		right = 0;
+		}
+	else if(side=='r' | side=='R')
+		{
+		right = 1;
+		}
+	else
+		{
+		printf("\nerror: blasfeo_dtrsm_plan: wrong value of side %c\n", side);
+		exit(1);
+		}
+	if(uplo=='l' | uplo=='L')
+		{
+		upper = 0;
+		}
+	else if(uplo=='u' | uplo=='U')
+		{
+		upper = 1;
+		}
+	else
+		{
+		printf("\nerror: blasfeo_dtrsm_plan: wrong value of uplo %c\n", uplo);
+		exit(1);
+		}
+	if(ta=='n' | ta=='N')
+		{
+		trans = 0;
+		}
+	else if(ta=='t' | ta=='T')
+		{
+		trans = 1;
+		}
+	else
+		{
+		printf("\nerror: blasfeo_dtrsm_plan: wrong value of ta %c\n", ta);
+		exit(1);
+		}
+	if(diag=='n' | diag=='N')
+		{
+		unit = 0;
+		}
+	else if(diag=='u' | diag=='U')
+		{
+		unit = 1;
+		}
+	else
+		{
+		printf("\nerror: blasfeo_dtrsm_plan: wrong value of diag %c\n", diag);
+		exit(1);
+		}
+
+	plan->m = m;
+	plan->n = n;
+	plan->k = 0;
+	plan->ai = ai;
+	plan->aj = aj;
+	plan->bi = bi;
+	plan->bj = bj;
+	plan->ci = 0;
+	plan->cj = 0;
+	plan->di = di;
+	plan->dj = dj;
+
+	plan->var = 8*right + 4*upper + 2*trans + unit;
+	plan->alg = blasfeo_hp_dtrsm_alg_tab[plan->var](m, n);
+
+	return;
+
+	}
+
+
+
+void blasfeo_hp_dtrsm_execute(struct blasfeo_dplan *plan, double alpha, struct blasfeo_dmat *sA, struct blasfeo_dmat *sB, struct blasfeo_dmat *sD)
+	{
+	blasfeo_hp_dtrsm_run_tab[plan->var](plan->alg, plan->m, plan->n, alpha, sA, plan->ai, plan->aj, sB, plan->bi, plan->bj, sD, plan->di, plan->dj);
+	}
+
+
+
+#if defined(LA_HIGH_PERFORMANCE)
+
+
+
+void blasfeo_dtrsm_llnn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dtrsm_llnn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	return;
+	}
+
+
+
+void blasfeo_dtrsm_llnu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dtrsm_llnu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	return;
+	}
+
+
+
+void blasfeo_dtrsm_lltn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dtrsm_lltn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	return;
+	}
+
+
+
+void blasfeo_dtrsm_lltu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dtrsm_lltu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	return;
+	}
+
+
+
+void blasfeo_dtrsm_lunn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dtrsm_lunn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	return;
+	}
+
+
+
+void blasfeo_dtrsm_lunu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dtrsm_lunu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	return;
+	}
+
+
+
+void blasfeo_dtrsm_lutn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dtrsm_lutn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	return;
+	}
+
+
+
+void blasfeo_dtrsm_lutu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dtrsm_lutu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	return;
+	}
+
+
+
+void blasfeo_dtrsm_rlnn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dtrsm_rlnn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	return;
+	}
+
+
+
+void blasfeo_dtrsm_rlnu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dtrsm_rlnu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	return;
+	}
 
 
 
@@ -7449,4 +8556,290 @@ void blasfeo_dtrsm_rutu(int m, int n, double alpha, struct blasfeo_dmat *sA, int
 
 
 
+size_t blasfeo_dtrsm_llnn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_llnn_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrsm_llnn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrsm_llnn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrsm_llnu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_llnu_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrsm_llnu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrsm_llnu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrsm_lltn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_lltn_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrsm_lltn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrsm_lltn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrsm_lltu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_lltu_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrsm_lltu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrsm_lltu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrsm_lunn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_lunn_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrsm_lunn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrsm_lunn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrsm_lunu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_lunu_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrsm_lunu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrsm_lunu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrsm_lutn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_lutn_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrsm_lutn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrsm_lutn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrsm_lutu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_lutu_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrsm_lutu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrsm_lutu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrsm_rlnn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_rlnn_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrsm_rlnn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrsm_rlnn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrsm_rlnu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_rlnu_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrsm_rlnu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrsm_rlnu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrsm_rltn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_rltn_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrsm_rltn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrsm_rltn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrsm_rltu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_rltu_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrsm_rltu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrsm_rltu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrsm_runn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_runn_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrsm_runn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrsm_runn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrsm_runu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_runu_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrsm_runu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrsm_runu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrsm_rutn_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_rutn_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrsm_rutn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrsm_rutn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_dtrsm_rutu_worksize(int m, int n)
+	{
+	return blasfeo_hp_dtrsm_rutu_worksize(m, n);
+	}
+
+
+
+void blasfeo_dtrsm_rutu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_dtrsm_rutu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+void blasfeo_dtrsm_plan(char side, char uplo, char ta, char diag, int m, int n, int ai, int aj, int bi, int bj, int di, int dj, struct blasfeo_dplan *plan)
+	{
+	blasfeo_hp_dtrsm_plan(side, uplo, ta, diag, m, n, ai, aj, bi, bj, di, dj, plan);
+	}
+
+
+
+void blasfeo_dtrsm_execute(struct blasfeo_dplan *plan, double alpha, struct blasfeo_dmat *sA, struct blasfeo_dmat *sB, struct blasfeo_dmat *sD)
+	{
+	blasfeo_hp_dtrsm_execute(plan, alpha, sA, sB, sD);
+	}
+
+
+
 #endif
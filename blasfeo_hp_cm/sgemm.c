@@ -59,6 +59,18 @@
 #define blasfeo_sgemm_nt blasfeo_cm_sgemm_nt
 #define blasfeo_sgemm_tn blasfeo_cm_sgemm_tn
 #define blasfeo_sgemm_tt blasfeo_cm_sgemm_tt
+#define blasfeo_hp_sgemm_nn_worksize blasfeo_hp_cm_sgemm_nn_worksize
+#define blasfeo_hp_sgemm_nt_worksize blasfeo_hp_cm_sgemm_nt_worksize
+#define blasfeo_hp_sgemm_tn_worksize blasfeo_hp_cm_sgemm_tn_worksize
+#define blasfeo_hp_sgemm_tt_worksize blasfeo_hp_cm_sgemm_tt_worksize
+#define blasfeo_sgemm_nn_worksize blasfeo_cm_sgemm_nn_worksize
+#define blasfeo_sgemm_nt_worksize blasfeo_cm_sgemm_nt_worksize
+#define blasfeo_sgemm_tn_worksize blasfeo_cm_sgemm_tn_worksize
+#define blasfeo_sgemm_tt_worksize blasfeo_cm_sgemm_tt_worksize
+#define blasfeo_sgemm_nn_ws blasfeo_cm_sgemm_nn_ws
+#define blasfeo_sgemm_nt_ws blasfeo_cm_sgemm_nt_ws
+#define blasfeo_sgemm_tn_ws blasfeo_cm_sgemm_tn_ws
+#define blasfeo_sgemm_tt_ws blasfeo_cm_sgemm_tt_ws
 #endif
 
 
@@ -2136,7 +2148,7 @@ nn_2:
 #if 1
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+2*4096);
 		}
 	else
 		{
@@ -2279,7 +2291,7 @@ nn_2:
 //	printf("\ntime: pack_A %e, pack_B %e, kernel %e, kernel2 %e, kernel3 %e\n", time_pack_A, time_pack_B, time_kernel, time_kernel2, time_kernel3); 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -2292,7 +2304,7 @@ nn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps, m_kernel, k1);
 	tB_size = blasfeo_pm_memsize_smat(ps, n1, k1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps, m_kernel, k, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps, n, k, &tB, (void *) (mem_align+tA_size));
@@ -2572,7 +2584,7 @@ nn_2_left_4:
 	goto nn_2_return;
 
 nn_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -2914,7 +2926,7 @@ nt_2:
 #if 1
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+2*4096);
 		}
 	else
 		{
@@ -3057,7 +3069,7 @@ nt_2:
 //	printf("\ntime: pack_A %e, pack_B %e, kernel %e, kernel2 %e, kernel3 %e\n", time_pack_A, time_pack_B, time_kernel, time_kernel2, time_kernel3); 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -3070,7 +3082,7 @@ nt_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps, m_kernel, k1);
 	tB_size = blasfeo_pm_memsize_smat(ps, n1, k1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps, m_kernel, k, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps, n, k, &tB, (void *) (mem_align+tA_size));
@@ -3321,7 +3333,7 @@ nt_2_left_4:
 	goto nt_2_return;
 
 nt_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -3609,7 +3621,7 @@ tn_2:
 #if 1
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+2*4096);
 		}
 	else
 		{
@@ -3752,7 +3764,7 @@ tn_2:
 //	printf("\ntime: pack_A %e, pack_B %e, kernel %e, kernel2 %e, kernel3 %e\n", time_pack_A, time_pack_B, time_kernel, time_kernel2, time_kernel3); 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -3765,7 +3777,7 @@ tn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps, m_kernel, k1);
 	tB_size = blasfeo_pm_memsize_smat(ps, n1, k1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps, m_kernel, k, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps, n, k, &tB, (void *) (mem_align+tA_size));
@@ -4052,7 +4064,7 @@ tn_2_left_4:
 	goto tn_2_return;
 
 tn_2_return:
-free(mem);
+blasfeo_work_free(mem);
 	return;
 
 
@@ -4359,7 +4371,7 @@ tt_2:
 #if 1
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_work_malloc(&mem, tA_size+tB_size+2*4096);
 		}
 	else
 		{
@@ -4502,7 +4514,7 @@ tt_2:
 //	printf("\ntime: pack_A %e, pack_B %e, kernel %e, kernel2 %e, kernel3 %e\n", time_pack_A, time_pack_B, time_kernel, time_kernel2, time_kernel3); 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_work_free(mem);
 		}
 
 	return;
@@ -4515,7 +4527,7 @@ tt_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps, m_kernel, k1);
 	tB_size = blasfeo_pm_memsize_smat(ps, n1, k1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps, m_kernel, k, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps, n, k, &tB, (void *) (mem_align+tA_size));
@@ -4774,7 +4786,7 @@ tt_2_left_4:
 	goto tt_2_return;
 
 tt_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -4824,6 +4836,65 @@ tt_0_return:
 
 
 
+// workspace size in bytes: upper bound over the algorithms that can be selected for a m x n x k product
+static size_t blasfeo_hp_sgemm_worksize(int m, int n, int k)
+	{
+
+#if ! ( defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57) | defined(TARGET_ARMV8A_ARM_CORTEX_A53) )
+	const int ps = PS;
+	int k1, n1;
+#endif
+
+	if(m<=0 | n<=0)
+		return 0;
+
+	// pack A and B alg: never selected for a single kernel block, unless forced
+#if ! defined(PACKING_ALG_2)
+	if(m<=M_KERNEL & n<=M_KERNEL & k<160)
+		return 0;
+#endif
+
+#if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+	// cache blocking alg, unless the buffer of blasfeo_init is used
+	return blasfeo_is_init()==0 ? blasfeo_work_memsize(blasfeo_memsize_buffer()) : 0;
+#else
+	k1 = (k+128-1)/128*128;
+	n1 = (n+128-1)/128*128;
+	return blasfeo_work_memsize(blasfeo_pm_memsize_smat(ps, M_KERNEL, k1)+blasfeo_pm_memsize_smat(ps, n1, k1)+64);
+#endif
+
+	}
+
+
+
+size_t blasfeo_hp_sgemm_nn_worksize(int m, int n, int k)
+	{
+	return blasfeo_hp_sgemm_worksize(m, n, k);
+	}
+
+
+
+size_t blasfeo_hp_sgemm_nt_worksize(int m, int n, int k)
+	{
+	return blasfeo_hp_sgemm_worksize(m, n, k);
+	}
+
+
+
+size_t blasfeo_hp_sgemm_tn_worksize(int m, int n, int k)
+	{
+	return blasfeo_hp_sgemm_worksize(m, n, k);
+	}
+
+
+
+size_t blasfeo_hp_sgemm_tt_worksize(int m, int n, int k)
+	{
+	return blasfeo_hp_sgemm_worksize(m, n, k);
+	}
+
+
+
 #if defined(LA_HIGH_PERFORMANCE)
 //#ifndef HP_BLAS
 
@@ -4857,6 +4928,74 @@ void blasfeo_sgemm_tt(int m, int n, int k, float alpha, struct blasfeo_smat *sA,
 
 
 
+size_t blasfeo_sgemm_nn_worksize(int m, int n, int k)
+	{
+	return blasfeo_hp_sgemm_nn_worksize(m, n, k);
+	}
+
+
+
+void blasfeo_sgemm_nn_ws(int m, int n, int k, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, float beta, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_sgemm_nn(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_sgemm_nt_worksize(int m, int n, int k)
+	{
+	return blasfeo_hp_sgemm_nt_worksize(m, n, k);
+	}
+
+
+
+void blasfeo_sgemm_nt_ws(int m, int n, int k, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, float beta, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_sgemm_nt(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_sgemm_tn_worksize(int m, int n, int k)
+	{
+	return blasfeo_hp_sgemm_tn_worksize(m, n, k);
+	}
+
+
+
+void blasfeo_sgemm_tn_ws(int m, int n, int k, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, float beta, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_sgemm_tn(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_sgemm_tt_worksize(int m, int n, int k)
+	{
+	return blasfeo_hp_sgemm_tt_worksize(m, n, k);
+	}
+
+
+
+void blasfeo_sgemm_tt_ws(int m, int n, int k, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, float beta, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_sgemm_tt(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
 //#endif
 #endif
 
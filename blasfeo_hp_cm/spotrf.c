@@ -41,6 +41,7 @@
 #include <blasfeo_common.h>
 #include <blasfeo_s_aux.h>
 #include <blasfeo_s_kernel.h>
+#include <blasfeo_memory.h>
 
 
 
@@ -52,6 +53,15 @@
 #define blasfeo_spotrf_l blasfeo_cm_spotrf_l
 #define blasfeo_spotrf_u blasfeo_cm_spotrf_u
 #define blasfeo_spotrf_l_mn blasfeo_cm_spotrf_l_mn
+#define blasfeo_hp_spotrf_l_worksize blasfeo_hp_cm_spotrf_l_worksize
+#define blasfeo_hp_spotrf_u_worksize blasfeo_hp_cm_spotrf_u_worksize
+#define blasfeo_hp_spotrf_l_mn_worksize blasfeo_hp_cm_spotrf_l_mn_worksize
+#define blasfeo_spotrf_l_worksize blasfeo_cm_spotrf_l_worksize
+#define blasfeo_spotrf_u_worksize blasfeo_cm_spotrf_u_worksize
+#define blasfeo_spotrf_l_mn_worksize blasfeo_cm_spotrf_l_mn_worksize
+#define blasfeo_spotrf_l_ws blasfeo_cm_spotrf_l_ws
+#define blasfeo_spotrf_u_ws blasfeo_cm_spotrf_u_ws
+#define blasfeo_spotrf_l_mn_ws blasfeo_cm_spotrf_l_mn_ws
 #endif
 
 
@@ -281,7 +291,7 @@ l_2:
 
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m1, m1);
-	mem = malloc(tA_size+64);
+	blasfeo_work_malloc(&mem, tA_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m, m, &tA, (void *) mem_align);
 
@@ -489,7 +499,7 @@ l_2_left_4:
 #endif
 
 l_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -796,7 +806,7 @@ u_1:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps, m1, m1);
 //	tA_size = blasfeo_memsize_smat(m, m);
-	mem = malloc(tA_size+64);
+	blasfeo_work_malloc(&mem, tA_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps, m, m, &tA, (void *) mem_align);
 
@@ -979,7 +989,7 @@ u_1_left_4:
 	goto u_1_return;
 
 u_1_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -1322,7 +1332,7 @@ l_2:
 	m1 = (m+128-1)/128*128;
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps, m1, n1);
-	mem = malloc(tA_size+64);
+	blasfeo_work_malloc(&mem, tA_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps, m, n, &tA, (void *) mem_align);
 
@@ -1580,7 +1590,7 @@ l_2_left_4:
 	goto l_2_return;
 
 l_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -1591,6 +1601,68 @@ l_2_return:
 
 
 
+size_t blasfeo_hp_spotrf_l_worksize(int m)
+	{
+
+#if defined(TARGET_X64_INTEL_HASWELL)
+	const int ps0 = 8;
+#else
+	const int ps0 = 4;
+#endif
+
+	int m1;
+
+	// small matrix
+	if(m<12 & m<=K_MAX_STACK)
+		return 0;
+
+	m1 = (m+128-1)/128*128;
+	return blasfeo_work_memsize(blasfeo_pm_memsize_smat(ps0, m1, m1)+64);
+
+	}
+
+
+
+size_t blasfeo_hp_spotrf_u_worksize(int m)
+	{
+
+	const int ps = 4; //D_PS;
+
+	int m1;
+
+	// small matrix
+	if(m<12 & m<=K_MAX_STACK)
+		return 0;
+
+	m1 = (m+128-1)/128*128;
+	return blasfeo_work_memsize(blasfeo_pm_memsize_smat(ps, m1, m1)+64);
+
+	}
+
+
+
+size_t blasfeo_hp_spotrf_l_mn_worksize(int m, int n)
+	{
+
+	const int ps = 4; //D_PS;
+
+	int m1, n1;
+
+	if(n<=0)
+		return 0;
+
+	// small matrix
+	if(m<12 & m<=K_MAX_STACK)
+		return 0;
+
+	m1 = (m+128-1)/128*128;
+	n1 = (n+128-1)/128*128;
+	return blasfeo_work_memsize(blasfeo_pm_memsize_smat(ps, m1, n1)+64);
+
+	}
+
+
+
 #if defined(LA_HIGH_PERFORMANCE)
 
 
@@ -1616,6 +1688,57 @@ void blasfeo_spotrf_l_mn(int m, int n, struct blasfeo_smat *sC, int ci, int cj,
 
 
 
+size_t blasfeo_spotrf_l_worksize(int m)
+	{
+	return blasfeo_hp_spotrf_l_worksize(m);
+	}
+
+
+
+void blasfeo_spotrf_l_ws(int m, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_spotrf_l(m, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_spotrf_u_worksize(int m)
+	{
+	return blasfeo_hp_spotrf_u_worksize(m);
+	}
+
+
+
+void blasfeo_spotrf_u_ws(int m, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_spotrf_u(m, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_spotrf_l_mn_worksize(int m, int n)
+	{
+	return blasfeo_hp_spotrf_l_mn_worksize(m, n);
+	}
+
+
+
+void blasfeo_spotrf_l_mn_ws(int m, int n, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_spotrf_l_mn(m, n, sC, ci, cj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
 #endif
 
 
@@ -41,6 +41,7 @@
 #include <blasfeo_common.h>
 #include <blasfeo_s_aux.h>
 #include <blasfeo_s_kernel.h>
+#include <blasfeo_memory.h>
 
 
 
@@ -78,6 +79,54 @@
 #define blasfeo_strsm_runu blasfeo_cm_strsm_runu
 #define blasfeo_strsm_rutn blasfeo_cm_strsm_rutn
 #define blasfeo_strsm_rutu blasfeo_cm_strsm_rutu
+#define blasfeo_hp_strsm_llnn_worksize blasfeo_hp_cm_strsm_llnn_worksize
+#define blasfeo_hp_strsm_llnu_worksize blasfeo_hp_cm_strsm_llnu_worksize
+#define blasfeo_hp_strsm_lltn_worksize blasfeo_hp_cm_strsm_lltn_worksize
+#define blasfeo_hp_strsm_lltu_worksize blasfeo_hp_cm_strsm_lltu_worksize
+#define blasfeo_hp_strsm_lunn_worksize blasfeo_hp_cm_strsm_lunn_worksize
+#define blasfeo_hp_strsm_lunu_worksize blasfeo_hp_cm_strsm_lunu_worksize
+#define blasfeo_hp_strsm_lutn_worksize blasfeo_hp_cm_strsm_lutn_worksize
+#define blasfeo_hp_strsm_lutu_worksize blasfeo_hp_cm_strsm_lutu_worksize
+#define blasfeo_hp_strsm_rlnn_worksize blasfeo_hp_cm_strsm_rlnn_worksize
+#define blasfeo_hp_strsm_rlnu_worksize blasfeo_hp_cm_strsm_rlnu_worksize
+#define blasfeo_hp_strsm_rltn_worksize blasfeo_hp_cm_strsm_rltn_worksize
+#define blasfeo_hp_strsm_rltu_worksize blasfeo_hp_cm_strsm_rltu_worksize
+#define blasfeo_hp_strsm_runn_worksize blasfeo_hp_cm_strsm_runn_worksize
+#define blasfeo_hp_strsm_runu_worksize blasfeo_hp_cm_strsm_runu_worksize
+#define blasfeo_hp_strsm_rutn_worksize blasfeo_hp_cm_strsm_rutn_worksize
+#define blasfeo_hp_strsm_rutu_worksize blasfeo_hp_cm_strsm_rutu_worksize
+#define blasfeo_strsm_llnn_worksize blasfeo_cm_strsm_llnn_worksize
+#define blasfeo_strsm_llnu_worksize blasfeo_cm_strsm_llnu_worksize
+#define blasfeo_strsm_lltn_worksize blasfeo_cm_strsm_lltn_worksize
+#define blasfeo_strsm_lltu_worksize blasfeo_cm_strsm_lltu_worksize
+#define blasfeo_strsm_lunn_worksize blasfeo_cm_strsm_lunn_worksize
+#define blasfeo_strsm_lunu_worksize blasfeo_cm_strsm_lunu_worksize
+#define blasfeo_strsm_lutn_worksize blasfeo_cm_strsm_lutn_worksize
+#define blasfeo_strsm_lutu_worksize blasfeo_cm_strsm_lutu_worksize
+#define blasfeo_strsm_rlnn_worksize blasfeo_cm_strsm_rlnn_worksize
+#define blasfeo_strsm_rlnu_worksize blasfeo_cm_strsm_rlnu_worksize
+#define blasfeo_strsm_rltn_worksize blasfeo_cm_strsm_rltn_worksize
+#define blasfeo_strsm_rltu_worksize blasfeo_cm_strsm_rltu_worksize
+#define blasfeo_strsm_runn_worksize blasfeo_cm_strsm_runn_worksize
+#define blasfeo_strsm_runu_worksize blasfeo_cm_strsm_runu_worksize
+#define blasfeo_strsm_rutn_worksize blasfeo_cm_strsm_rutn_worksize
+#define blasfeo_strsm_rutu_worksize blasfeo_cm_strsm_rutu_worksize
+#define blasfeo_strsm_llnn_ws blasfeo_cm_strsm_llnn_ws
+#define blasfeo_strsm_llnu_ws blasfeo_cm_strsm_llnu_ws
+#define blasfeo_strsm_lltn_ws blasfeo_cm_strsm_lltn_ws
+#define blasfeo_strsm_lltu_ws blasfeo_cm_strsm_lltu_ws
+#define blasfeo_strsm_lunn_ws blasfeo_cm_strsm_lunn_ws
+#define blasfeo_strsm_lunu_ws blasfeo_cm_strsm_lunu_ws
+#define blasfeo_strsm_lutn_ws blasfeo_cm_strsm_lutn_ws
+#define blasfeo_strsm_lutu_ws blasfeo_cm_strsm_lutu_ws
+#define blasfeo_strsm_rlnn_ws blasfeo_cm_strsm_rlnn_ws
+#define blasfeo_strsm_rlnu_ws blasfeo_cm_strsm_rlnu_ws
+#define blasfeo_strsm_rltn_ws blasfeo_cm_strsm_rltn_ws
+#define blasfeo_strsm_rltu_ws blasfeo_cm_strsm_rltu_ws
+#define blasfeo_strsm_runn_ws blasfeo_cm_strsm_runn_ws
+#define blasfeo_strsm_runu_ws blasfeo_cm_strsm_runu_ws
+#define blasfeo_strsm_rutn_ws blasfeo_cm_strsm_rutn_ws
+#define blasfeo_strsm_rutu_ws blasfeo_cm_strsm_rutu_ws
 #endif
 
 
@@ -238,7 +287,7 @@ llnn_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, m1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, m, m, &tB, (void *) (mem_align+tA_size));
@@ -292,7 +341,7 @@ llnn_2_left_4:
 goto llnn_2_return;
 
 llnn_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -435,7 +484,7 @@ llnu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, m1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, m, m, &tB, (void *) (mem_align+tA_size));
@@ -486,7 +535,7 @@ llnu_2_left_4:
 goto llnu_2_return;
 
 llnu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -646,7 +695,7 @@ lunn_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, m1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, m, m, &tB, (void *) (mem_align+tA_size));
@@ -712,7 +761,7 @@ lunn_2_left_4:
 	goto lunn_2_return;
 
 lunn_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -868,7 +917,7 @@ lunu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, m1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, m, m, &tB, (void *) (mem_align+tA_size));
@@ -931,7 +980,7 @@ lunu_2_left_4:
 	goto lunu_2_return;
 
 lunu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -1091,7 +1140,7 @@ lunn_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, m1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, m, m, &tB, (void *) (mem_align+tA_size));
@@ -1157,7 +1206,7 @@ lunn_2_left_4:
 	goto lunn_2_return;
 
 lunn_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -1313,7 +1362,7 @@ lunu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, m1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, m, m, &tB, (void *) (mem_align+tA_size));
@@ -1376,7 +1425,7 @@ lunu_2_left_4:
 	goto lunu_2_return;
 
 lunu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -1524,7 +1573,7 @@ llnn_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, m1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, m, m, &tB, (void *) (mem_align+tA_size));
@@ -1578,7 +1627,7 @@ llnn_2_left_4:
 goto llnn_2_return;
 
 llnn_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -1722,7 +1771,7 @@ llnu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, m1, m1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, m, m, &tB, (void *) (mem_align+tA_size));
@@ -1776,7 +1825,7 @@ llnu_2_left_4:
 goto llnu_2_return;
 
 llnu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -1937,7 +1986,7 @@ rutn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, n1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, n, n, &tB, (void *) (mem_align+tA_size));
@@ -2003,7 +2052,7 @@ rutn_2_left_4:
 	goto rutn_2_return;
 
 rutn_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -2160,7 +2209,7 @@ rutu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, n1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, n, n, &tB, (void *) (mem_align+tA_size));
@@ -2223,7 +2272,7 @@ rutu_2_left_4:
 	goto rutu_2_return;
 
 rutu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -2371,7 +2420,7 @@ rltn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, n1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, n, n, &tB, (void *) (mem_align+tA_size));
@@ -2424,7 +2473,7 @@ rltn_2_left_4:
 goto rltn_2_return;
 
 rltn_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -2568,7 +2617,7 @@ rltu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, n1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, n, n, &tB, (void *) (mem_align+tA_size));
@@ -2618,7 +2667,7 @@ rltu_2_left_4:
 goto rltu_2_return;
 
 rltu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -2766,7 +2815,7 @@ rltn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, n1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, n, n, &tB, (void *) (mem_align+tA_size));
@@ -2819,7 +2868,7 @@ rltn_2_left_4:
 goto rltn_2_return;
 
 rltn_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -2963,7 +3012,7 @@ rltu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, n1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, n, n, &tB, (void *) (mem_align+tA_size));
@@ -3013,7 +3062,7 @@ rltu_2_left_4:
 goto rltu_2_return;
 
 rltu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -3174,7 +3223,7 @@ rutn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, n1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, n, n, &tB, (void *) (mem_align+tA_size));
@@ -3240,7 +3289,7 @@ rutn_2_left_4:
 	goto rutn_2_return;
 
 rutn_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -3397,7 +3446,7 @@ rutu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, n1, n1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_work_malloc(&mem, tA_size+tB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, n, n, &tB, (void *) (mem_align+tA_size));
@@ -3460,7 +3509,7 @@ rutu_2_left_4:
 	goto rutu_2_return;
 
 rutu_2_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 
@@ -3472,6 +3521,143 @@ rutu_2_return:
 
 
 
+// workspace size in bytes of the trsm routines, with the triangular matrix on the left (of size m) or on the right
+// (of size n)
+static size_t blasfeo_hp_strsm_worksize(int m, int n, int left)
+	{
+
+	const int ps0 = 4;
+
+	int k0, k1;
+
+	if(m<=0 | n<=0)
+		return 0;
+
+	k0 = left ? m : n;
+
+	// small matrix
+	if(m<12 & n<12 & k0<=K_MAX_STACK)
+		return 0;
+
+	k1 = (k0+128-1)/128*128;
+	return blasfeo_work_memsize(blasfeo_pm_memsize_smat(ps0, M_KERNEL, k1)+blasfeo_pm_memsize_smat(ps0, k1, k1)+64);
+
+	}
+
+
+
+size_t blasfeo_hp_strsm_llnn_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_worksize(m, n, 1);
+	}
+
+
+
+size_t blasfeo_hp_strsm_llnu_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_worksize(m, n, 1);
+	}
+
+
+
+size_t blasfeo_hp_strsm_lltn_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_worksize(m, n, 1);
+	}
+
+
+
+size_t blasfeo_hp_strsm_lltu_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_worksize(m, n, 1);
+	}
+
+
+
+size_t blasfeo_hp_strsm_lunn_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_worksize(m, n, 1);
+	}
+
+
+
+size_t blasfeo_hp_strsm_lunu_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_worksize(m, n, 1);
+	}
+
+
+
+size_t blasfeo_hp_strsm_lutn_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_worksize(m, n, 1);
+	}
+
+
+
+size_t blasfeo_hp_strsm_lutu_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_worksize(m, n, 1);
+	}
+
+
+
+size_t blasfeo_hp_strsm_rlnn_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_worksize(m, n, 0);
+	}
+
+
+
+size_t blasfeo_hp_strsm_rlnu_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_worksize(m, n, 0);
+	}
+
+
+
+size_t blasfeo_hp_strsm_rltn_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_worksize(m, n, 0);
+	}
+
+
+
+size_t blasfeo_hp_strsm_rltu_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_worksize(m, n, 0);
+	}
+
+
+
+size_t blasfeo_hp_strsm_runn_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_worksize(m, n, 0);
+	}
+
+
+
+size_t blasfeo_hp_strsm_runu_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_worksize(m, n, 0);
+	}
+
+
+
+size_t blasfeo_hp_strsm_rutn_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_worksize(m, n, 0);
+	}
+
+
+
+size_t blasfeo_hp_strsm_rutu_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_worksize(m, n, 0);
+	}
+
+
+
 #if defined(LA_HIGH_PERFORMANCE)
 
 
@@ -3604,4 +3790,276 @@ void blasfeo_strsm_rutu(int m, int n, float alpha, struct blasfeo_smat *sA, int
 
 
 
+size_t blasfeo_strsm_llnn_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_llnn_worksize(m, n);
+	}
+
+
+
+void blasfeo_strsm_llnn_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_strsm_llnn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_strsm_llnu_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_llnu_worksize(m, n);
+	}
+
+
+
+void blasfeo_strsm_llnu_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_strsm_llnu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_strsm_lltn_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_lltn_worksize(m, n);
+	}
+
+
+
+void blasfeo_strsm_lltn_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_strsm_lltn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_strsm_lltu_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_lltu_worksize(m, n);
+	}
+
+
+
+void blasfeo_strsm_lltu_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_strsm_lltu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_strsm_lunn_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_lunn_worksize(m, n);
+	}
+
+
+
+void blasfeo_strsm_lunn_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_strsm_lunn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_strsm_lunu_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_lunu_worksize(m, n);
+	}
+
+
+
+void blasfeo_strsm_lunu_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_strsm_lunu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_strsm_lutn_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_lutn_worksize(m, n);
+	}
+
+
+
+void blasfeo_strsm_lutn_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_strsm_lutn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_strsm_lutu_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_lutu_worksize(m, n);
+	}
+
+
+
+void blasfeo_strsm_lutu_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_strsm_lutu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_strsm_rlnn_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_rlnn_worksize(m, n);
+	}
+
+
+
+void blasfeo_strsm_rlnn_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_strsm_rlnn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_strsm_rlnu_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_rlnu_worksize(m, n);
+	}
+
+
+
+void blasfeo_strsm_rlnu_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_strsm_rlnu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_strsm_rltn_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_rltn_worksize(m, n);
+	}
+
+
+
+void blasfeo_strsm_rltn_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_strsm_rltn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_strsm_rltu_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_rltu_worksize(m, n);
+	}
+
+
+
+void blasfeo_strsm_rltu_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_strsm_rltu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_strsm_runn_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_runn_worksize(m, n);
+	}
+
+
+
+void blasfeo_strsm_runn_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_strsm_runn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_strsm_runu_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_runu_worksize(m, n);
+	}
+
+
+
+void blasfeo_strsm_runu_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_strsm_runu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_strsm_rutn_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_rutn_worksize(m, n);
+	}
+
+
+
+void blasfeo_strsm_rutn_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_strsm_rutn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
+size_t blasfeo_strsm_rutu_worksize(int m, int n)
+	{
+	return blasfeo_hp_strsm_rutu_worksize(m, n);
+	}
+
+
+
+void blasfeo_strsm_rutu_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize)
+	{
+	struct blasfeo_work prev;
+	blasfeo_work_begin(work, worksize, &prev);
+	blasfeo_hp_strsm_rutu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	blasfeo_work_end(&prev);
+	}
+
+
+
 #endif
@@ -39,7 +39,9 @@
 #include <blasfeo_common.h>
 #include <blasfeo_d_kernel.h>
 #include <blasfeo_d_aux.h>
+#include <blasfeo_memory.h>
 #include <blasfeo_d_blasfeo_api.h>
+#include <blasfeo_thread.h>
 #if defined(BLASFEO_REF_API)
 #include <blasfeo_d_blasfeo_ref_api.h>
 #endif
@@ -310,9 +312,181 @@ void dlauum_blk_nt_l_lib(int m, int n, int nv, int *rv, int *cv, double *pA, int
 
 
 
+#if defined(MULTI_THREAD)
+
+// size of the blocks of rows or columns of D assigned to the threads: multiple of the kernel sizes of all targets
+#define GEMM_MT_BS 24
+// minimum number of multiply-adds per thread
+#define GEMM_MT_WORK (64*64*64)
+
+
+
+// arguments of the multi-threaded alg
+struct blasfeo_hp_dgemm_mt_arg
+	{
+	void (*fun)(int, int, int, double, struct blasfeo_dmat *, int, int, struct blasfeo_dmat *, int, int, double, struct blasfeo_dmat *, int, int, struct blasfeo_dmat *, int, int);
+	int ta; // A transposed
+	int tb; // B transposed
+	int rows; // split the rows of D, otherwise the columns
+	int m;
+	int n;
+	int k;
+	double alpha;
+	struct blasfeo_dmat *sA;
+	int ai;
+	int aj;
+	struct blasfeo_dmat *sB;
+	int bi;
+	int bj;
+	double beta;
+	struct blasfeo_dmat *sC;
+	int ci;
+	int cj;
+	struct blasfeo_dmat *sD;
+	int di;
+	int dj;
+	int nnode; // number of NUMA nodes, 0 if the node of the threads is unknown
+	int node[BLASFEO_MAX_THREADS]; // NUMA node of each thread
+	};
+
+
+
+// each panel block of D is computed by exactly one kernel call, so the blocks of rows (or columns) of D are
+// independent: each thread calls the single-threaded routine on its own block, with no packing;
+// the blocks are made of whole GEMM_MT_BS blocks, so that only the last thread runs the _vs edge kernels,
+// and this thread gets one block less if the blocks do not split evenly;
+// if the NUMA node of the threads is known, the rows of D go instead to the threads on the node owning their panels,
+// as by blasfeo_allocate_dmat_numa
+static void blasfeo_hp_dgemm_mt_work(int tid, int nth, void *ptr)
+	{
+
+	const int ps = 4;
+
+	struct blasfeo_hp_dgemm_mt_arg *arg = ptr;
+
+	int r = arg->rows ? arg->m : arg->n;
+
+	int r0, r1;
+	if(arg->rows & arg->nnode>=2)
+		{
+		int pa = arg->di/ps;
+		int off = arg->di%ps;
+		int p0, p1;
+		blasfeo_thread_numa_range(tid, nth, arg->node, arg->nnode, arg->sD->pm/ps, pa, pa+(off+r+ps-1)/ps, &p0, &p1);
+		r0 = (p0-pa)*ps - off;
+		r1 = (p1-pa)*ps - off;
+		r0 = r0<0 ? 0 : r0;
+		r1 = r1<r ? r1 : r;
+		}
+	else
+		{
+		int nb = (r+GEMM_MT_BS-1)/GEMM_MT_BS;
+		int nb0 = nb/nth;
+		int nb1 = nb%nth; // number of threads with one more block
+		int b0 = tid*nb0 + (tid<nb1 ? tid : nb1);
+		int b1 = b0 + nb0 + (tid<nb1 ? 1 : 0);
+		r0 = b0*GEMM_MT_BS;
+		r1 = b1*GEMM_MT_BS<r ? b1*GEMM_MT_BS : r;
+		}
+
+	if(r0>=r1)
+		return;
+
+	// the routines invalidate the stored inverse diagonal of D
+	struct blasfeo_dmat tD = *arg->sD;
+
+	if(arg->rows)
+		{
+		if(arg->ta)
+			arg->fun(r1-r0, arg->n, arg->k, arg->alpha, arg->sA, arg->ai, arg->aj+r0, arg->sB, arg->bi, arg->bj, arg->beta, arg->sC, arg->ci+r0, arg->cj, &tD, arg->di+r0, arg->dj);
+		else
+			arg->fun(r1-r0, arg->n, arg->k, arg->alpha, arg->sA, arg->ai+r0, arg->aj, arg->sB, arg->bi, arg->bj, arg->beta, arg->sC, arg->ci+r0, arg->cj, &tD, arg->di+r0, arg->dj);
+		}
+	else
+		{
+		if(arg->tb)
+			arg->fun(arg->m, r1-r0, arg->k, arg->alpha, arg->sA, arg->ai, arg->aj, arg->sB, arg->bi+r0, arg->bj, arg->beta, arg->sC, arg->ci, arg->cj+r0, &tD, arg->di, arg->dj+r0);
+		else
+			arg->fun(arg->m, r1-r0, arg->k, arg->alpha, arg->sA, arg->ai, arg->aj, arg->sB, arg->bi, arg->bj+r0, arg->beta, arg->sC, arg->ci, arg->cj+r0, &tD, arg->di, arg->dj+r0);
+		}
+
+	return;
+
+	}
+
+
+
+// multi-threaded alg, splitting the rows of D (or the columns, if they give more blocks):
+// returns 1 if the operation has been performed, 0 if it is left to the single-threaded routine
+static int blasfeo_hp_dgemm_mt(void (*fun)(int, int, int, double, struct blasfeo_dmat *, int, int, struct blasfeo_dmat *, int, int, double, struct blasfeo_dmat *, int, int, struct blasfeo_dmat *, int, int), int ta, int tb, int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	struct blasfeo_hp_dgemm_mt_arg arg;
+
+	if(m<=0 | n<=0 | k<=0)
+		return 0;
+
+	int nth = blasfeo_get_num_threads_flops(2.0*m*n*k);
+	if(nth<2)
+		return 0;
+
+	int nbm = (m+GEMM_MT_BS-1)/GEMM_MT_BS;
+	int nbn = (n+GEMM_MT_BS-1)/GEMM_MT_BS;
+	int rows = nbm>=nth | nbm>=nbn;
+	int nth_max = rows ? nbm : nbn;
+	nth = nth<nth_max ? nth : nth_max;
+	// at least GEMM_MT_WORK multiply-adds per thread
+	nth_max = (int) ((double) m * n * k / GEMM_MT_WORK);
+	nth = nth<nth_max ? nth : nth_max;
+
+	if(nth<2)
+		return 0;
+
+	arg.fun = fun;
+	arg.ta = ta;
+	arg.tb = tb;
+	arg.rows = rows;
+	arg.m = m;
+	arg.n = n;
+	arg.k = k;
+	arg.alpha = alpha;
+	arg.sA = sA;
+	arg.ai = ai;
+	arg.aj = aj;
+	arg.sB = sB;
+	arg.bi = bi;
+	arg.bj = bj;
+	arg.beta = beta;
+	arg.sC = sC;
+	arg.ci = ci;
+	arg.cj = cj;
+	arg.sD = sD;
+	arg.di = di;
+	arg.dj = dj;
+	// the NUMA placement is by blocks of rows
+	arg.nnode = rows ? blasfeo_thread_numa_nodes(nth, arg.node) : 0;
+
+	blasfeo_parallel_run(nth, &blasfeo_hp_dgemm_mt_work, &arg);
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	return 1;
+
+	}
+
+#endif // MULTI_THREAD
+
+
+
 // dgemm nn
 void blasfeo_hp_dgemm_nn(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dgemm_mt(&blasfeo_hp_dgemm_nn, 0, 0, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj))
+		return;
+#endif
+
 	if(m<=0 || n<=0)
 		return;
 
@@ -725,6 +899,11 @@ loop_CD:
 // dgemm nt
 void blasfeo_hp_dgemm_nt(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dgemm_mt(&blasfeo_hp_dgemm_nt, 0, 1, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj))
+		return;
+#endif
+
 	if(m<=0 | n<=0)
 		return;
 
@@ -1379,6 +1558,11 @@ loop_CD:
 // dgemm_tn
 void blasfeo_hp_dgemm_tn(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dgemm_mt(&blasfeo_hp_dgemm_tn, 1, 0, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj))
+		return;
+#endif
+
 	if(m<=0 || n<=0)
 		return;
 
@@ -1433,7 +1617,7 @@ void blasfeo_hp_dgemm_tn(int m, int n, int k, double alpha, struct blasfeo_dmat
 	if(k>K_MAX_STACK)
 		{
 		sAt_size = blasfeo_memsize_dmat(12, k);
-		mem = malloc(sAt_size+64);
+		blasfeo_work_malloc(&mem, sAt_size+64);
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		blasfeo_create_dmat(12, k, &sAt, (void *) mem_align);
 		pU = sAt.pA;
@@ -1845,7 +2029,7 @@ left_4_n0:
 tn_return:
 	if(k>K_MAX_STACK)
 		{
-		free(mem);
+		blasfeo_work_free(mem);
 		}
 	return;
 
@@ -1857,6 +2041,11 @@ tn_return:
 #if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_X64_INTEL_CORE) | defined(TARGET_GENERIC)
 void blasfeo_hp_dgemm_tt(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dgemm_mt(&blasfeo_hp_dgemm_tt, 1, 1, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj))
+		return;
+#endif
+
 	if(m<=0 || n<=0)
 		return;
 
@@ -2267,6 +2456,11 @@ loop_CD:
 #else
 void blasfeo_hp_dgemm_tt(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dgemm_mt(&blasfeo_hp_dgemm_tt, 1, 1, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj))
+		return;
+#endif
+
 	if(m<=0 || n<=0)
 		return;
 
@@ -2875,7 +3069,7 @@ tt_0_return:
 
 loop_00_1:
 	sAt_size = blasfeo_memsize_dmat(12, k);
-	mem = malloc(sAt_size+64);
+	blasfeo_work_malloc(&mem, sAt_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(12, k, &sAt, (void *) mem_align);
 	pAt = sAt.pA;
@@ -3072,7 +3266,7 @@ loop_00_1:
 	// main loop C, D not aligned
 loop_CD_1:
 	sAt_size = blasfeo_memsize_dmat(12, k);
-	mem = malloc(sAt_size+64);
+	blasfeo_work_malloc(&mem, sAt_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(12, k, &sAt, (void *) mem_align);
 	pAt = sAt.pA;
@@ -3406,7 +3600,7 @@ left_4_1_g:
 
 
 tt_1_return:
-	free(mem);
+	blasfeo_work_free(mem);
 	return;
 
 	}
@@ -3414,9 +3608,168 @@ tt_1_return:
 
 
 
+#if defined(MULTI_THREAD)
+
+// minimum number of right-hand sides per thread
+#define TRSM_MT_RHS 48
+
+
+
+// arguments of the multi-threaded alg
+struct blasfeo_hp_dtrsm_mt_arg
+	{
+	void (*fun)(int, int, double, struct blasfeo_dmat *, int, int, struct blasfeo_dmat *, int, int, struct blasfeo_dmat *, int, int);
+	int left;
+	int m;
+	int n;
+	double alpha;
+	struct blasfeo_dmat *sA;
+	int ai;
+	int aj;
+	struct blasfeo_dmat *sB;
+	int bi;
+	int bj;
+	struct blasfeo_dmat *sD;
+	int di;
+	int dj;
+	int nnode; // number of NUMA nodes, 0 if the node of the threads is unknown
+	int node[BLASFEO_MAX_THREADS]; // NUMA node of each thread
+	char *work; // workspace of the solves, one slot per thread
+	size_t slotsize;
+	};
+
+
+
+// the right-hand sides (columns of B for the triangular matrix on the left, rows of B for the one on the right)
+// are independent: each thread solves a contiguous block of them with the single-threaded routine;
+// the routines update the dA and use_dA fields of the matrix structures, so each thread works on private
+// copies of them, with its own buffer for the inverse of the diagonal, taken from its workspace slot;
+// if the NUMA node of the threads is known, the rows of B and D go to the threads on the node owning their panels,
+// as by blasfeo_allocate_dmat_numa (a block of columns spans all the nodes instead)
+static void blasfeo_hp_dtrsm_mt_work(int tid, int nth, void *ptr)
+	{
+
+	const int ps = 4;
+
+	struct blasfeo_hp_dtrsm_mt_arg *arg = ptr;
+
+	int r = arg->left ? arg->n : arg->m;
+	int k = arg->left ? arg->m : arg->n;
+
+	int r0, r1;
+	if(!arg->left & arg->nnode>=2)
+		{
+		int pa = arg->di/ps;
+		int off = arg->di%ps;
+		int p0, p1;
+		blasfeo_thread_numa_range(tid, nth, arg->node, arg->nnode, arg->sD->pm/ps, pa, pa+(off+r+ps-1)/ps, &p0, &p1);
+		r0 = (p0-pa)*ps - off;
+		r1 = (p1-pa)*ps - off;
+		r0 = r0<0 ? 0 : r0;
+		r1 = r1<r ? r1 : r;
+		}
+	else
+		{
+		// row blocks aligned to the panels
+		int rw = (r+nth-1)/nth;
+		rw = (rw+ps-1)/ps*ps;
+		r0 = tid*rw;
+		r1 = r0+rw<r ? r0+rw : r;
+		}
+
+	if(r0>=r1)
+		return;
+
+	struct blasfeo_dmat tA = *arg->sA;
+	struct blasfeo_dmat tB = *arg->sB;
+	struct blasfeo_dmat tD = *arg->sD;
+	struct blasfeo_work prev;
+	void *mem;
+
+	// the workspace state is thread-local: each thread takes its allocations from its own slot
+	blasfeo_work_begin(arg->work+tid*arg->slotsize, arg->slotsize, &prev);
+
+	blasfeo_work_malloc(&mem, (arg->ai+k)*sizeof(double));
+	tA.dA = mem;
+	tA.use_dA = 0;
+
+	if(arg->left)
+		arg->fun(arg->m, r1-r0, arg->alpha, &tA, arg->ai, arg->aj, &tB, arg->bi, arg->bj+r0, &tD, arg->di, arg->dj+r0);
+	else
+		arg->fun(r1-r0, arg->n, arg->alpha, &tA, arg->ai, arg->aj, &tB, arg->bi+r0, arg->bj, &tD, arg->di+r0, arg->dj);
+
+	blasfeo_work_free(mem);
+
+	blasfeo_work_end(&prev);
+
+	return;
+
+	}
+
+
+
+// multi-threaded alg, splitting the right-hand sides in blocks of at least TRSM_MT_RHS:
+// returns 1 if the operation has been performed, 0 if it is left to the single-threaded routine
+static int blasfeo_hp_dtrsm_mt(void (*fun)(int, int, double, struct blasfeo_dmat *, int, int, struct blasfeo_dmat *, int, int, struct blasfeo_dmat *, int, int), int left, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	struct blasfeo_hp_dtrsm_mt_arg arg;
+	void *mem;
+
+	int k = left ? m : n;
+	int r = left ? n : m;
+	int nth = blasfeo_get_num_threads_flops(1.0*k*k*r);
+	int nth_max = r/TRSM_MT_RHS;
+	nth = nth<nth_max ? nth : nth_max;
+
+	if(k<TRSM_MT_RHS | nth<2)
+		return 0;
+
+	arg.fun = fun;
+	arg.left = left;
+	arg.m = m;
+	arg.n = n;
+	arg.alpha = alpha;
+	arg.sA = sA;
+	arg.ai = ai;
+	arg.aj = aj;
+	arg.sB = sB;
+	arg.bi = bi;
+	arg.bj = bj;
+	arg.sD = sD;
+	arg.di = di;
+	arg.dj = dj;
+	// the NUMA placement is by blocks of rows
+	arg.nnode = left ? 0 : blasfeo_thread_numa_nodes(nth, arg.node);
+	// one slot per thread, carved from the workspace of the calling thread
+	arg.slotsize = blasfeo_work_memsize((ai+k)*sizeof(double));
+	blasfeo_work_malloc(&mem, nth*arg.slotsize);
+	arg.work = (char *) mem;
+
+	blasfeo_parallel_run(nth, &blasfeo_hp_dtrsm_mt_work, &arg);
+
+	blasfeo_work_free(mem);
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	return 1;
+
+	}
+
+#endif // MULTI_THREAD
+
+
+
 // dtrsm_llnn
 void blasfeo_hp_dtrsm_llnn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
+
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_llnn, 1, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 	// invalidate stored inverse diagonal of result matrix
 	sD->use_dA = 0;
 
@@ -3576,6 +3929,12 @@ void blasfeo_hp_dtrsm_llnn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 // dtrsm_llnu
 void blasfeo_hp_dtrsm_llnu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
+
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_llnu, 1, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 	// invalidate stored inverse diagonal of result matrix
 	sD->use_dA = 0;
 
@@ -3714,6 +4073,12 @@ void blasfeo_hp_dtrsm_llnu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 // dtrsm_lltn
 void blasfeo_hp_dtrsm_lltn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
+
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_lltn, 1, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 #if defined(BLASFEO_REF_API)
 	blasfeo_ref_dtrsm_lltn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
 	return;
@@ -3729,6 +4094,12 @@ void blasfeo_hp_dtrsm_lltn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 // dtrsm_lltu
 void blasfeo_hp_dtrsm_lltu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
+
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_lltu, 1, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 #if defined(BLASFEO_REF_API)
 	blasfeo_ref_dtrsm_lltu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
 	return;
@@ -3745,6 +4116,11 @@ void blasfeo_hp_dtrsm_lltu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 void blasfeo_hp_dtrsm_lunn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_lunn, 1, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 	if(m<=0 || n<=0)
 		return;
 
@@ -3873,6 +4249,11 @@ void blasfeo_hp_dtrsm_lunn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 void blasfeo_hp_dtrsm_lunu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_lunu, 1, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 	if(m<=0 || n<=0)
 		return;
 
@@ -3979,6 +4360,12 @@ void blasfeo_hp_dtrsm_lunu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 // dtrsm_lutn
 void blasfeo_hp_dtrsm_lutn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
+
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_lutn, 1, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 #if defined(BLASFEO_REF_API)
 	blasfeo_ref_dtrsm_lutn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
 	return;
@@ -3994,6 +4381,12 @@ void blasfeo_hp_dtrsm_lutn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 // dtrsm_lutu
 void blasfeo_hp_dtrsm_lutu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
+
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_lutu, 1, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 #if defined(BLASFEO_REF_API)
 	blasfeo_ref_dtrsm_lutu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
 	return;
@@ -4009,6 +4402,12 @@ void blasfeo_hp_dtrsm_lutu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 // dtrsm_rlnn
 void blasfeo_hp_dtrsm_rlnn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
+
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_rlnn, 0, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 #if defined(BLASFEO_REF_API)
 	blasfeo_ref_dtrsm_rlnn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
 	return;
@@ -4024,6 +4423,12 @@ void blasfeo_hp_dtrsm_rlnn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 // dtrsm_rlnu
 void blasfeo_hp_dtrsm_rlnu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
+
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_rlnu, 0, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 #if defined(BLASFEO_REF_API)
 	blasfeo_ref_dtrsm_rlnu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
 	return;
@@ -4040,6 +4445,11 @@ void blasfeo_hp_dtrsm_rlnu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 void blasfeo_hp_dtrsm_rltn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_rltn, 0, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 	if(m<=0 || n<=0)
 		return;
 
@@ -4274,10 +4684,26 @@ void blasfeo_hp_dtrsm_rltn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 void blasfeo_hp_dtrsm_rltu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_rltu, 0, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 	if(m<=0 || n<=0)
 		return;
 
-	if(ai!=0 | bi!=0 | di!=0)
+	const int ps = 4;
+
+	int sda = sA->cn;
+	int sdb = sB->cn;
+	int sdd = sD->cn;
+	int bir = bi & (ps-1);
+	int dir = di & (ps-1);
+	double *pA = sA->pA + aj*ps;
+	double *pB = sB->pA + bj*ps + (bi-bir)*sdb;
+	double *pD = sD->pA + dj*ps + (di-dir)*sdd;
+
+	if(ai!=0 | bir!=0 | dir!=0)
 		{
 #if defined(BLASFEO_REF_API)
 		blasfeo_ref_dtrsm_rltu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
@@ -4291,15 +4717,6 @@ void blasfeo_hp_dtrsm_rltu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 	// invalidate stored inverse diagonal of result matrix
 	sD->use_dA = 0;
 
-	const int ps = 4;
-
-	int sda = sA->cn;
-	int sdb = sB->cn;
-	int sdd = sD->cn;
-	double *pA = sA->pA + aj*ps;
-	double *pB = sB->pA + bj*ps;
-	double *pD = sD->pA + dj*ps;
-
 	int i, j;
 
 	i = 0;
@@ -4414,6 +4831,12 @@ void blasfeo_hp_dtrsm_rltu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 // dtrsm_runn
 void blasfeo_hp_dtrsm_runn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
+
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_runn, 0, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 #if defined(BLASFEO_REF_API)
 	blasfeo_ref_dtrsm_runn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
 	return;
@@ -4429,6 +4852,12 @@ void blasfeo_hp_dtrsm_runn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 // dtrsm_runu
 void blasfeo_hp_dtrsm_runu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
+
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_runu, 0, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 #if defined(BLASFEO_REF_API)
 	blasfeo_ref_dtrsm_runu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
 	return;
@@ -4444,7 +4873,24 @@ void blasfeo_hp_dtrsm_runu(int m, int n, double alpha, struct blasfeo_dmat *sA,
 // dtrsm_right_upper_transposed_notunit
 void blasfeo_hp_dtrsm_rutn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
-	if(ai!=0 | bi!=0 | di!=0)
+
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_rutn, 0, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
+	const int ps = 4;
+
+	int sda = sA->cn;
+	int sdb = sB->cn;
+	int sdd = sD->cn;
+	int bir = bi & (ps-1);
+	int dir = di & (ps-1);
+	double *pA = sA->pA + aj*ps;
+	double *pB = sB->pA + bj*ps + (bi-bir)*sdb;
+	double *pD = sD->pA + dj*ps + (di-dir)*sdd;
+
+	if(ai!=0 | bir!=0 | dir!=0)
 		{
 #if defined(BLASFEO_REF_API)
 		blasfeo_ref_dtrsm_rutn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
@@ -4457,15 +4903,6 @@ void blasfeo_hp_dtrsm_rutn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 
 	// invalidate stored inverse diagonal of result matrix
 	sD->use_dA = 0;
-
-	const int ps = 4;
-
-	int sda = sA->cn;
-	int sdb = sB->cn;
-	int sdd = sD->cn;
-	double *pA = sA->pA + aj*ps;
-	double *pB = sB->pA + bj*ps;
-	double *pD = sD->pA + dj*ps;
 	double *dA = sA->dA;
 
 	int ii;
@@ -4646,6 +5083,12 @@ void blasfeo_hp_dtrsm_rutn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 // dtrsm_rutu
 void blasfeo_hp_dtrsm_rutu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
+
+#if defined(MULTI_THREAD)
+	if(blasfeo_hp_dtrsm_mt(&blasfeo_hp_dtrsm_rutu, 0, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj))
+		return;
+#endif
+
 #if defined(BLASFEO_REF_API)
 	blasfeo_ref_dtrsm_rutu(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
 	return;
@@ -5135,7 +5578,7 @@ void blasfeo_hp_dsyrk_ln(int m, int k, double alpha, struct blasfeo_dmat *sA, in
 	if(k>K_MAX_STACK)
 		{
 		sAt_size = blasfeo_memsize_dmat(12, k);
-		mem = malloc(sAt_size+64);
+		blasfeo_work_malloc(&mem, sAt_size+64);
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		blasfeo_create_dmat(12, k, &sAt, (void *) mem_align);
 		pU = sAt.pA;
@@ -5851,7 +6294,7 @@ loop_BCD:
 end:
 	if(k>K_MAX_STACK)
 		{
-		free(mem);
+		blasfeo_work_free(mem);
 		}
 	return;
 
@@ -6605,7 +7048,7 @@ void blasfeo_hp_dsyrk_ut(int m, int k, double alpha, struct blasfeo_dmat *sA, in
 	if(k>K_MAX_STACK)
 		{
 		sdu = (k+ps-1)/ps*ps;
-		mem = malloc(12*sdu*sizeof(double)+63);
+		blasfeo_work_malloc(&mem, 12*sdu*sizeof(double)+63);
 		blasfeo_align_64_byte(mem, (void **) &pU);
 		}
 	else
@@ -6770,7 +7213,7 @@ left_4:
 end:
 	if(k>K_MAX_STACK)
 		{
-		free(mem);
+		blasfeo_work_free(mem);
 		}
 	return;
 
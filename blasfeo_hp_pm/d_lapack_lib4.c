@@ -38,9 +38,13 @@
 #include <math.h>
 
 #include <blasfeo_common.h>
+#include <blasfeo_stdlib.h>
 #include <blasfeo_d_aux.h>
+#include <blasfeo_memory.h>
 #include <blasfeo_d_kernel.h>
 #include <blasfeo_d_blasfeo_api.h>
+#include <blasfeo_d_blasfeo_hp_api.h>
+#include <blasfeo_thread.h>
 #if defined(BLASFEO_REF_API)
 #include <blasfeo_d_blasfeo_ref_api.h>
 #endif
@@ -101,7 +105,7 @@ void blasfeo_dgetrf_rp_test(int m, int n, struct blasfeo_dmat *sC, int ci, int c
 	if(n>K_MAX_STACK)
 		{
 		sdu = (n+ps-1)/ps*ps;
-		mem = malloc(12*sdu*sizeof(double)+64);
+		blasfeo_work_malloc(&mem, 12*sdu*sizeof(double)+64);
 		blasfeo_align_64_byte(mem, (void **) &pU);
 		}
 	else
@@ -504,7 +508,7 @@ left_4:
 end:
 	if(n>K_MAX_STACK)
 		{
-		free(mem);
+		blasfeo_work_free(mem);
 		}
 	return;
 
@@ -563,7 +567,7 @@ void blasfeo_dgetrf_np_test(int m, int n, struct blasfeo_dmat *sC, int ci, int c
 	if(n>K_MAX_STACK)
 		{
 		sdu = (n+ps-1)/ps*ps;
-		mem = malloc(12*sdu*sizeof(double)+63);
+		blasfeo_work_malloc(&mem, 12*sdu*sizeof(double)+63);
 		blasfeo_align_64_byte(mem, (void **) &pU);
 		}
 	else
@@ -664,7 +668,7 @@ void blasfeo_dgetrf_np_test(int m, int n, struct blasfeo_dmat *sC, int ci, int c
 end:
 	if(n>K_MAX_STACK)
 		{
-		free(mem);
+		blasfeo_work_free(mem);
 		}
 	return;
 
@@ -2377,45 +2381,17 @@ void blasfeo_hp_dgetrf_np(int m, int n, struct blasfeo_dmat *sC, int ci, int cj,
 
 
 // dgetrf row pivoting
-void blasfeo_hp_dgetrf_rp(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, int *ipiv)
+// row-pivoting LU factorization of the panel-major matrix pD, in place
+static void blasfeo_hp_dgetrf_rp_lib4(int m, int n, double *pD, int sdd, double *dD, int *ipiv)
 	{
 
-	if(ci!=0 | di!=0)
-		{
-#if defined(BLASFEO_REF_API)
-		blasfeo_ref_dgetrf_rp(m, n, sC, ci, cj, sD, di, dj, ipiv);
-		return;
-#else
-		printf("\nblasfeo_dgetrf_rp: feature not implemented yet: ci=%d, di=%d\n", ci, di);
-		exit(1);
-#endif
-		}
-
 	const int ps = 4;
 
-	int sdc = sC->cn;
-	int sdd = sD->cn;
-	double *pC = sC->pA + cj*ps;
-	double *pD = sD->pA + dj*ps;
-	double *dD = sD->dA; // XXX what to do if di and dj are not zero
-
-	if(di==0 && dj==0)
-		sD->use_dA = 1;
-	else
-		sD->use_dA = 0;
-
-	if(m<=0 | n<=0)
-		return;
-
 	int ii, jj, i0, i1, j0, ll, p;
 
 	double d1 = 1.0;
 	double dm1 = -1.0;
 
-	// needs to perform row-excanges on the yet-to-be-factorized matrix too
-	if(pC!=pD)
-		blasfeo_dgecp(m, n, sC, ci, cj, sD, di, dj);
-
 	// minimum matrix size
 	p = n<m ? n : m; // XXX
 
@@ -2449,8 +2425,8 @@ void blasfeo_hp_dgetrf_rp(int m, int n, struct blasfeo_dmat *sC, int ci, int cj,
 			ipiv[jj+ii] += jj;
 			if(ipiv[jj+ii]!=jj+ii)
 				{
-				blasfeo_drowsw(jj, sD, jj+ii, 0, sD, ipiv[jj+ii], 0);
-				blasfeo_drowsw(n-jj-12, sD, jj+ii, jj+12, sD, ipiv[jj+ii], jj+12);
+				kernel_drowsw_lib4(jj, pD+(jj+ii)/ps*ps*sdd+(jj+ii)%ps, pD+(ipiv[jj+ii])/ps*ps*sdd+(ipiv[jj+ii])%ps);
+				kernel_drowsw_lib4(n-jj-12, pD+(jj+ii)/ps*ps*sdd+(jj+ii)%ps+(jj+12)*ps, pD+(ipiv[jj+ii])/ps*ps*sdd+(ipiv[jj+ii])%ps+(jj+12)*ps);
 				}
 			}
 #else
@@ -3412,6 +3388,388 @@ void blasfeo_hp_dgetrf_rp(int m, int n, struct blasfeo_dmat *sC, int ci, int cj,
 
 
 
+#if defined(MULTI_THREAD)
+
+// panel width of the multi-threaded alg
+#define GETRF_MT_NB 96
+// number of columns of each trailing update task
+#define GETRF_MT_NC 48
+
+
+
+// apply the row interchanges of the panel k0:k0+w to the columns c0:c1
+static void blasfeo_hp_dgetrf_rp_swap_lib4(int k0, int w, int c0, int c1, double *pD, int sdd, int *ipiv)
+	{
+
+	const int ps = 4;
+
+	int ii;
+
+	for(ii=k0; ii<k0+w; ii++)
+		{
+		if(ipiv[ii]!=ii)
+			{
+			kernel_drowsw_lib4(c1-c0, pD+ii/ps*ps*sdd+ii%ps+c0*ps, pD+ipiv[ii]/ps*ps*sdd+ipiv[ii]%ps+c0*ps);
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// apply the factorized panel k0:k0+w to the rows k0:k0+w of the columns c0:c1: row interchanges, solve upper
+static void blasfeo_hp_dgetrf_rp_update_top_lib4(int k0, int w, int c0, int c1, double *pD, int sdd, int *ipiv)
+	{
+
+	const int ps = 4;
+
+	int ii, ll;
+
+	double d1 = 1.0;
+
+	blasfeo_hp_dgetrf_rp_swap_lib4(k0, w, c0, c1, pD, sdd, ipiv);
+
+	// solve upper
+	for(ll=c0; ll<c1; ll+=4)
+		{
+		for(ii=0; ii<w; ii+=4)
+			{
+			if(w-ii>=4 & c1-ll>=4)
+				{
+				kernel_dtrsm_nn_ll_one_4x4_lib4(ii, pD+(k0+ii)*sdd+k0*ps, pD+k0*sdd+ll*ps, sdd, &d1, pD+(k0+ii)*sdd+ll*ps, pD+(k0+ii)*sdd+ll*ps, pD+(k0+ii)*sdd+(k0+ii)*ps);
+				}
+			else
+				{
+				kernel_dtrsm_nn_ll_one_4x4_vs_lib4(ii, pD+(k0+ii)*sdd+k0*ps, pD+k0*sdd+ll*ps, sdd, &d1, pD+(k0+ii)*sdd+ll*ps, pD+(k0+ii)*sdd+ll*ps, pD+(k0+ii)*sdd+(k0+ii)*ps, w-ii, c1-ll);
+				}
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// update the columns c0:c1 with the factorized panel k0:k0+w: row interchanges, solve upper, trailing update
+static void blasfeo_hp_dgetrf_rp_update_lib4(int m, int k0, int w, int c0, int c1, struct blasfeo_dmat *sD, int dj, double *pD, int sdd, int *ipiv)
+	{
+
+	blasfeo_hp_dgetrf_rp_update_top_lib4(k0, w, c0, c1, pD, sdd, ipiv);
+
+	// trailing update
+	blasfeo_hp_dgemm_nn(m-k0-w, c1-c0, w, -1.0, sD, k0+w, dj+k0, sD, k0, dj+c0, 1.0, sD, k0+w, dj+c0, sD, k0+w, dj+c0);
+
+	return;
+
+	}
+
+
+
+// arguments of the multi-threaded alg
+struct blasfeo_hp_dgetrf_rp_mt_arg
+	{
+	int m;
+	int n;
+	struct blasfeo_dmat *sD;
+	int dj;
+	double *pD;
+	int sdd;
+	double *dD;
+	int *ipiv;
+	int next[2]; // next trailing column block, for the current and the next step
+	int done[2]; // number of column blocks with the rows of the panel updated, if nnode>=2
+	int next_node[2][BLASFEO_NUMA_MAX_NODES]; // next trailing column block of the rows owned by each node, if nnode>=2
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	struct blasfeo_barrier *bar;
+	int nnode; // number of NUMA nodes, 0 if the node of the threads is unknown
+	int node[BLASFEO_MAX_THREADS]; // NUMA node of each thread
+	};
+
+
+
+// trailing update of the step s with the factorized panel k0:k0+w if the NUMA node of the threads is known:
+// the rows of the panel are updated first by column blocks, then the rest in tiles made of the rows owned by a node
+// (as by blasfeo_allocate_dmat_numa) times a column block; each thread takes the tiles of its own node first
+static void blasfeo_hp_dgetrf_rp_mt_update_numa(int tid, struct blasfeo_hp_dgetrf_rp_mt_arg *arg, int s, int k0, int w, int cs)
+	{
+
+	const int ps = 4;
+	const int nc = GETRF_MT_NC;
+
+	int m = arg->m;
+	int n = arg->n;
+	int nnode = arg->nnode;
+	int np = arg->sD->pm/ps;
+	int k1 = k0+w;
+	int ntask = (n-cs+nc-1)/nc;
+
+	int ii, kk, c0, c1, r0, r1;
+
+	// rows of the panel
+	while(1)
+		{
+		pthread_mutex_lock(&arg->mutex);
+		c0 = cs + arg->next[s];
+		arg->next[s] += nc;
+		pthread_mutex_unlock(&arg->mutex);
+		if(c0>=n)
+			break;
+		c1 = n-c0<nc ? n : c0+nc;
+		blasfeo_hp_dgetrf_rp_update_top_lib4(k0, w, c0, c1, arg->pD, arg->sdd, arg->ipiv);
+		pthread_mutex_lock(&arg->mutex);
+		arg->done[s]++;
+		if(arg->done[s]==ntask)
+			pthread_cond_broadcast(&arg->cond);
+		pthread_mutex_unlock(&arg->mutex);
+		}
+	pthread_mutex_lock(&arg->mutex);
+	while(arg->done[s]<ntask)
+		pthread_cond_wait(&arg->cond, &arg->mutex);
+	pthread_mutex_unlock(&arg->mutex);
+
+	// rows below the panel, by node
+	for(ii=0; ii<nnode; ii++)
+		{
+		kk = (arg->node[tid]+ii)%nnode;
+		r0 = np*kk/nnode*ps;
+		r1 = np*(kk+1)/nnode*ps;
+		r0 = r0>k1 ? r0 : k1;
+		r1 = r1<m ? r1 : m;
+		if(r0>=r1)
+			continue;
+		while(1)
+			{
+			pthread_mutex_lock(&arg->mutex);
+			c0 = cs + arg->next_node[s][kk];
+			arg->next_node[s][kk] += nc;
+			pthread_mutex_unlock(&arg->mutex);
+			if(c0>=n)
+				break;
+			c1 = n-c0<nc ? n : c0+nc;
+			blasfeo_hp_dgemm_nn(r1-r0, c1-c0, w, -1.0, arg->sD, r0, arg->dj+k0, arg->sD, k0, arg->dj+c0, 1.0, arg->sD, r0, arg->dj+c0, arg->sD, r0, arg->dj+c0);
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// right-looking blocked alg with lookahead: at each step the thread 0 updates and factorizes
+// the next panel, while the other threads update the trailing matrix, split in column blocks
+// taken from a shared counter; the thread 0 joins them once the panel is factorized
+static void blasfeo_hp_dgetrf_rp_mt_work(int tid, int nth, void *ptr)
+	{
+
+	struct blasfeo_hp_dgetrf_rp_mt_arg *arg = ptr;
+
+	int m = arg->m;
+	int n = arg->n;
+	struct blasfeo_dmat *sD = arg->sD;
+	int dj = arg->dj;
+	double *pD = arg->pD;
+	int sdd = arg->sdd;
+	double *dD = arg->dD;
+	int *ipiv = arg->ipiv;
+
+	const int nb = GETRF_MT_NB;
+	const int nc = GETRF_MT_NC;
+
+	int ii, k0, k1, w, w1, c0, c1, cs, cw, step;
+
+	int p = m<n ? m : n;
+
+	// first panel
+	if(tid==0)
+		{
+		w = p<nb ? p : nb;
+		blasfeo_hp_dgetrf_rp_lib4(m, w, pD, sdd, dD, ipiv);
+		}
+	blasfeo_barrier_wait(arg->bar);
+
+	for(k0=0, step=0; k0<p; k0+=nb, step++)
+		{
+
+		w = p-k0<nb ? p-k0 : nb;
+		k1 = k0+w;
+		w1 = p-k1<nb ? p-k1 : nb;
+		// first column of the trailing update tasks
+		cs = k1+w1;
+
+		if(tid==0)
+			{
+			// the counters of the next step are free, the previous ones have been closed by the barrier
+			arg->next[(step+1)&1] = 0;
+			arg->done[(step+1)&1] = 0;
+			for(ii=0; ii<arg->nnode; ii++)
+				arg->next_node[(step+1)&1][ii] = 0;
+			// lookahead
+			if(w1>0)
+				{
+				blasfeo_hp_dgetrf_rp_update_lib4(m, k0, w, k1, k1+w1, sD, dj, pD, sdd, ipiv);
+				blasfeo_hp_dgetrf_rp_lib4(m-k1, w1, pD+k1*sdd+k1*4, sdd, dD+k1, ipiv+k1);
+				for(ii=k1; ii<k1+w1; ii++)
+					{
+					ipiv[ii] += k1;
+					}
+				}
+			}
+
+		// trailing update
+		if(arg->nnode>=2)
+			blasfeo_hp_dgetrf_rp_mt_update_numa(tid, arg, step&1, k0, w, cs);
+		else while(1)
+			{
+			pthread_mutex_lock(&arg->mutex);
+			c0 = cs + arg->next[step&1];
+			arg->next[step&1] += nc;
+			pthread_mutex_unlock(&arg->mutex);
+			if(c0>=n)
+				break;
+			c1 = n-c0<nc ? n : c0+nc;
+			blasfeo_hp_dgetrf_rp_update_lib4(m, k0, w, c0, c1, sD, dj, pD, sdd, ipiv);
+			}
+
+		blasfeo_barrier_wait(arg->bar);
+
+		}
+
+	// row interchanges on the left of each panel, split in column blocks
+	cw = (p+nth-1)/nth;
+	c0 = tid*cw;
+	c1 = c0+cw<p ? c0+cw : p;
+	for(k0=nb; k0<p; k0+=nb)
+		{
+		if(c0<k0)
+			{
+			w = p-k0<nb ? p-k0 : nb;
+			blasfeo_hp_dgetrf_rp_swap_lib4(k0, w, c0, c1<k0 ? c1 : k0, pD, sdd, ipiv);
+			}
+		}
+
+	return;
+
+	}
+
+
+
+static void blasfeo_hp_dgetrf_rp_mt(int nth, int m, int n, struct blasfeo_dmat *sD, int dj, double *pD, int sdd, double *dD, int *ipiv)
+	{
+
+	struct blasfeo_hp_dgetrf_rp_mt_arg arg;
+	struct blasfeo_barrier bar;
+
+	int ii;
+
+	blasfeo_barrier_init(&bar, nth);
+
+	arg.m = m;
+	arg.n = n;
+	arg.sD = sD;
+	arg.dj = dj;
+	arg.pD = pD;
+	arg.sdd = sdd;
+	arg.dD = dD;
+	arg.ipiv = ipiv;
+	arg.next[0] = 0;
+	arg.next[1] = 0;
+	arg.done[0] = 0;
+	arg.done[1] = 0;
+	arg.nnode = blasfeo_thread_numa_nodes(nth, arg.node);
+	for(ii=0; ii<arg.nnode; ii++)
+		{
+		arg.next_node[0][ii] = 0;
+		arg.next_node[1][ii] = 0;
+		}
+	pthread_mutex_init(&arg.mutex, NULL);
+	pthread_cond_init(&arg.cond, NULL);
+	arg.bar = &bar;
+
+	blasfeo_parallel_run(nth, &blasfeo_hp_dgetrf_rp_mt_work, &arg);
+
+	pthread_cond_destroy(&arg.cond);
+	pthread_mutex_destroy(&arg.mutex);
+	blasfeo_barrier_destroy(&bar);
+
+	return;
+
+	}
+
+
+
+// number of threads used by the multi-threaded alg: at least one trailing update task per thread
+static int blasfeo_hp_dgetrf_rp_mt_nth(int m, int n)
+	{
+	int p = m<n ? m : n;
+	int nth = blasfeo_get_num_threads_flops(2.0*((double) m*n*p - 0.5*(m+n)*p*p + 1.0/3.0*p*p*p));
+	if(p<2*GETRF_MT_NB)
+		return 1;
+	int nth_max = (n-2*GETRF_MT_NB+GETRF_MT_NC-1)/GETRF_MT_NC;
+	return nth<nth_max ? nth : nth_max;
+	}
+
+#endif // MULTI_THREAD
+
+
+
+void blasfeo_hp_dgetrf_rp(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, int *ipiv)
+	{
+
+	if(ci!=0 | di!=0)
+		{
+#if defined(BLASFEO_REF_API)
+		blasfeo_ref_dgetrf_rp(m, n, sC, ci, cj, sD, di, dj, ipiv);
+		return;
+#else
+		printf("\nblasfeo_dgetrf_rp: feature not implemented yet: ci=%d, di=%d\n", ci, di);
+		exit(1);
+#endif
+		}
+
+	const int ps = 4;
+
+	int sdc = sC->cn;
+	int sdd = sD->cn;
+	double *pC = sC->pA + cj*ps;
+	double *pD = sD->pA + dj*ps;
+	double *dD = sD->dA; // XXX what to do if di and dj are not zero
+
+	if(di==0 && dj==0)
+		sD->use_dA = 1;
+	else
+		sD->use_dA = 0;
+
+	if(m<=0 | n<=0)
+		return;
+
+	// needs to perform row-excanges on the yet-to-be-factorized matrix too
+	if(pC!=pD)
+		blasfeo_dgecp(m, n, sC, ci, cj, sD, di, dj);
+
+#if defined(MULTI_THREAD)
+	int nth = blasfeo_hp_dgetrf_rp_mt_nth(m, n);
+	if(nth>1)
+		{
+		blasfeo_hp_dgetrf_rp_mt(nth, m, n, sD, dj, pD, sdd, dD, ipiv);
+		// the panels stored the inverse of the diagonal in dD, restore the flag reset by the dgemm trailing updates
+		sD->use_dA = di==0 && dj==0;
+		return;
+		}
+#endif
+
+	blasfeo_hp_dgetrf_rp_lib4(m, n, pD, sdd, dD, ipiv);
+
+	return;
+
+	}
+
+
+
 int blasfeo_hp_dgeqrf_worksize(int m, int n)
 	{
 	const int ps = 4;
@@ -3566,7 +3924,8 @@ void blasfeo_hp_dgelqf(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, st
 		kernel_dgelqf_dlarft12_12_lib4(n-(ii+0), pD+(ii+0)*sdd+(ii+0)*ps, sdd, dD+(ii+0), &pT[0+0*12+0*ps]);
 		jj = ii+12;
 #if 1
-		for(; jj<m-11; jj+=12)
+		// the 12-row kernel is only correct if the reflector length is a multiple of 4
+		for(; jj<m-11 & ((n-ii)&(ps-1))==0; jj+=12)
 			{
 			kernel_dlarfb12_rn_12_lib4(n-ii, pD+ii*sdd+ii*ps, sdd, pT, pD+jj*sdd+ii*ps, pK);
 			}
@@ -3878,7 +4237,8 @@ void blasfeo_hp_dgelqf_pd(int m, int n, struct blasfeo_dmat *sC, int ci, int cj,
 		{
 		kernel_dgelqf_pd_dlarft12_12_lib4(n-(ii+0), pD+(ii+0)*sdd+(ii+0)*ps, sdd, dD+(ii+0), &pT[0+0*12+0*ps]);
 		jj = ii+12;
-		for(; jj<m-11; jj+=12)
+		// the 12-row kernel is only correct if the reflector length is a multiple of 4
+		for(; jj<m-11 & ((n-ii)&(ps-1))==0; jj+=12)
 			{
 			kernel_dlarfb12_rn_12_lib4(n-ii, pD+ii*sdd+ii*ps, sdd, pT, pD+jj*sdd+ii*ps, pK);
 			}
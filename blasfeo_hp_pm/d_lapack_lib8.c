@@ -38,9 +38,12 @@
 #include <math.h>
 
 #include <blasfeo_common.h>
+#include <blasfeo_stdlib.h>
 #include <blasfeo_d_aux.h>
 #include <blasfeo_d_kernel.h>
 #include <blasfeo_d_blasfeo_api.h>
+#include <blasfeo_d_blasfeo_hp_api.h>
+#include <blasfeo_thread.h>
 #if defined(BLASFEO_REF_API)
 #include <blasfeo_d_blasfeo_ref_api.h>
 #endif
@@ -947,15 +950,495 @@ void blasfeo_hp_dgetrf_np(int m, int n, struct blasfeo_dmat *sC, int ci, int cj,
 
 
 
+// swap two rows of a panel-major matrix, over kmax columns
+static void blasfeo_hp_dgetrf_rp_rowsw_lib8(int kmax, double *pA, double *pC)
+	{
+
+	const int ps = 8;
+
+	int ii;
+	double tmp;
+
+	for(ii=0; ii<kmax; ii++)
+		{
+		tmp = pA[ii*ps];
+		pA[ii*ps] = pC[ii*ps];
+		pC[ii*ps] = tmp;
+		}
+
+	return;
+
+	}
+
+
+
+// apply the row interchanges ipiv[i0:i0+w] to the columns c0:c1
+static void blasfeo_hp_dgetrf_rp_swap_lib8(int i0, int w, int c0, int c1, struct blasfeo_dmat *sD, int *ipiv)
+	{
+
+	int ii;
+
+	for(ii=i0; ii<i0+w; ii++)
+		{
+		if(ipiv[ii]!=ii)
+			{
+			blasfeo_hp_dgetrf_rp_rowsw_lib8(c1-c0, &BLASFEO_DMATEL(sD, ii, c0), &BLASFEO_DMATEL(sD, ipiv[ii], c0));
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// solve with the unit lower triangular matrix of size w at (di,lj) the columns bj:bj+n of the rows di:di+w;
+// blocked over 8 rows, with the off-diagonal blocks applied by the gemm
+static void blasfeo_hp_dgetrf_rp_trsm_lib8(int w, int n, struct blasfeo_dmat *sD, int di, int lj, int bj)
+	{
+
+	const int bs = 8;
+
+	int ii, jj, kk, ll, ib;
+	double tmp;
+
+	for(ll=0; ll<w; ll+=bs)
+		{
+		ib = w-ll<bs ? w-ll : bs;
+		if(ll>0)
+			{
+			blasfeo_hp_dgemm_nn(ib, n, ll, -1.0, sD, di+ll, lj, sD, di, bj, 1.0, sD, di+ll, bj, sD, di+ll, bj);
+			}
+		for(jj=0; jj<n; jj++)
+			{
+			for(ii=1; ii<ib; ii++)
+				{
+				tmp = BLASFEO_DMATEL(sD, di+ll+ii, bj+jj);
+				for(kk=0; kk<ii; kk++)
+					{
+					tmp -= BLASFEO_DMATEL(sD, di+ll+ii, lj+ll+kk) * BLASFEO_DMATEL(sD, di+ll+kk, bj+jj);
+					}
+				BLASFEO_DMATEL(sD, di+ll+ii, bj+jj) = tmp;
+				}
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// recursive row-pivoting LU factorization of the m x n panel at (di,dj), with m>=n;
+// the pivot indexes in ipiv[di:di+n] are row indexes of sD
+static void blasfeo_hp_dgetrf_rp_panel_lib8(int m, int n, struct blasfeo_dmat *sD, int di, int dj, int *ipiv)
+	{
+
+	const int bs = 8;
+
+	int ii, jj, kk, n1, ip;
+	double tmp, amax, inv_piv;
+
+	if(n<=bs)
+		{
+		// unblocked
+		for(jj=0; jj<n; jj++)
+			{
+			// find pivot
+			ip = di+jj;
+			amax = fabs(BLASFEO_DMATEL(sD, ip, dj+jj));
+			for(ii=di+jj+1; ii<di+m; ii++)
+				{
+				tmp = fabs(BLASFEO_DMATEL(sD, ii, dj+jj));
+				if(tmp>amax)
+					{
+					amax = tmp;
+					ip = ii;
+					}
+				}
+			ipiv[di+jj] = ip;
+			if(ip!=di+jj)
+				{
+				blasfeo_hp_dgetrf_rp_rowsw_lib8(n, &BLASFEO_DMATEL(sD, di+jj, dj), &BLASFEO_DMATEL(sD, ip, dj));
+				}
+			// scale column
+			tmp = BLASFEO_DMATEL(sD, di+jj, dj+jj);
+			inv_piv = tmp!=0.0 ? 1.0/tmp : 0.0;
+			sD->dA[di+jj] = inv_piv;
+			for(ii=di+jj+1; ii<di+m; ii++)
+				{
+				BLASFEO_DMATEL(sD, ii, dj+jj) *= inv_piv;
+				}
+			// rank-1 update of the panel
+			for(kk=jj+1; kk<n; kk++)
+				{
+				tmp = BLASFEO_DMATEL(sD, di+jj, dj+kk);
+				for(ii=di+jj+1; ii<di+m; ii++)
+					{
+					BLASFEO_DMATEL(sD, ii, dj+kk) -= BLASFEO_DMATEL(sD, ii, dj+jj) * tmp;
+					}
+				}
+			}
+		return;
+		}
+
+	// split in two panels, the left one multiple of the panel size
+	n1 = (n/2+bs-1)/bs*bs;
+
+	// left panel
+	blasfeo_hp_dgetrf_rp_panel_lib8(m, n1, sD, di, dj, ipiv);
+
+	// update right panel
+	blasfeo_hp_dgetrf_rp_swap_lib8(di, n1, dj+n1, dj+n, sD, ipiv);
+	blasfeo_hp_dgetrf_rp_trsm_lib8(n1, n-n1, sD, di, dj, dj+n1);
+	blasfeo_hp_dgemm_nn(m-n1, n-n1, n1, -1.0, sD, di+n1, dj, sD, di, dj+n1, 1.0, sD, di+n1, dj+n1, sD, di+n1, dj+n1);
+
+	// right panel
+	blasfeo_hp_dgetrf_rp_panel_lib8(m-n1, n-n1, sD, di+n1, dj+n1, ipiv);
+
+	// row interchanges of the right panel on the left one
+	blasfeo_hp_dgetrf_rp_swap_lib8(di+n1, n-n1, dj, dj+n1, sD, ipiv);
+
+	return;
+
+	}
+
+
+
+// panel width of the blocked alg
+#define GETRF_NB 96
+
+
+
+// update the columns c0:c1 with the factorized panel k0:k0+w: row interchanges, solve upper, trailing update
+static void blasfeo_hp_dgetrf_rp_update_lib8(int m, int k0, int w, int c0, int c1, struct blasfeo_dmat *sD, int dj, int *ipiv)
+	{
+
+	if(c1<=c0)
+		return;
+
+	blasfeo_hp_dgetrf_rp_swap_lib8(k0, w, dj+c0, dj+c1, sD, ipiv);
+	blasfeo_hp_dgetrf_rp_trsm_lib8(w, c1-c0, sD, k0, dj+k0, dj+c0);
+	if(m-k0-w>0)
+		blasfeo_hp_dgemm_nn(m-k0-w, c1-c0, w, -1.0, sD, k0+w, dj+k0, sD, k0, dj+c0, 1.0, sD, k0+w, dj+c0, sD, k0+w, dj+c0);
+
+	return;
+
+	}
+
+
+
+// right-looking blocked alg, with recursive panel factorization
+static void blasfeo_hp_dgetrf_rp_blk_lib8(int m, int n, struct blasfeo_dmat *sD, int dj, int *ipiv)
+	{
+
+	const int nb = GETRF_NB;
+
+	int k0, w;
+
+	int p = m<n ? m : n;
+
+	for(k0=0; k0<p; k0+=nb)
+		{
+		w = p-k0<nb ? p-k0 : nb;
+		blasfeo_hp_dgetrf_rp_panel_lib8(m-k0, w, sD, k0, dj+k0, ipiv);
+		blasfeo_hp_dgetrf_rp_update_lib8(m, k0, w, k0+w, n, sD, dj, ipiv);
+		blasfeo_hp_dgetrf_rp_swap_lib8(k0, w, dj, dj+k0, sD, ipiv);
+		}
+
+	return;
+
+	}
+
+
+
+#if defined(MULTI_THREAD)
+
+// number of columns of each trailing update task of the multi-threaded alg
+#define GETRF_MT_NC 48
+
+
+
+// arguments of the multi-threaded alg
+struct blasfeo_hp_dgetrf_rp_mt_arg
+	{
+	int m;
+	int n;
+	struct blasfeo_dmat *sD;
+	int dj;
+	int *ipiv;
+	int next[2]; // next trailing column block, for the current and the next step
+	int done[2]; // number of column blocks with the rows of the panel updated, if nnode>=2
+	int next_node[2][BLASFEO_NUMA_MAX_NODES]; // next trailing column block of the rows owned by each node, if nnode>=2
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	struct blasfeo_barrier *bar;
+	int nnode; // number of NUMA nodes, 0 if the node of the threads is unknown
+	int node[BLASFEO_MAX_THREADS]; // NUMA node of each thread
+	};
+
+
+
+// trailing update of the step s with the factorized panel k0:k0+w if the NUMA node of the threads is known:
+// the rows of the panel are updated first by column blocks, then the rest in tiles made of the rows owned by a node
+// (as by blasfeo_allocate_dmat_numa) times a column block; each thread takes the tiles of its own node first
+static void blasfeo_hp_dgetrf_rp_mt_update_numa(int tid, struct blasfeo_hp_dgetrf_rp_mt_arg *arg, int s, int k0, int w, int cs)
+	{
+
+	const int ps = 8;
+	const int nc = GETRF_MT_NC;
+
+	int m = arg->m;
+	int n = arg->n;
+	int dj = arg->dj;
+	struct blasfeo_dmat *sD = arg->sD;
+	int nnode = arg->nnode;
+	int np = sD->pm/ps;
+	int k1 = k0+w;
+	int ntask = (n-cs+nc-1)/nc;
+
+	int ii, kk, c0, c1, r0, r1;
+
+	// rows of the panel
+	while(1)
+		{
+		pthread_mutex_lock(&arg->mutex);
+		c0 = cs + arg->next[s];
+		arg->next[s] += nc;
+		pthread_mutex_unlock(&arg->mutex);
+		if(c0>=n)
+			break;
+		c1 = n-c0<nc ? n : c0+nc;
+		blasfeo_hp_dgetrf_rp_swap_lib8(k0, w, dj+c0, dj+c1, sD, arg->ipiv);
+		blasfeo_hp_dgetrf_rp_trsm_lib8(w, c1-c0, sD, k0, dj+k0, dj+c0);
+		pthread_mutex_lock(&arg->mutex);
+		arg->done[s]++;
+		if(arg->done[s]==ntask)
+			pthread_cond_broadcast(&arg->cond);
+		pthread_mutex_unlock(&arg->mutex);
+		}
+	pthread_mutex_lock(&arg->mutex);
+	while(arg->done[s]<ntask)
+		pthread_cond_wait(&arg->cond, &arg->mutex);
+	pthread_mutex_unlock(&arg->mutex);
+
+	// rows below the panel, by node
+	for(ii=0; ii<nnode; ii++)
+		{
+		kk = (arg->node[tid]+ii)%nnode;
+		r0 = np*kk/nnode*ps;
+		r1 = np*(kk+1)/nnode*ps;
+		r0 = r0>k1 ? r0 : k1;
+		r1 = r1<m ? r1 : m;
+		if(r0>=r1)
+			continue;
+		while(1)
+			{
+			pthread_mutex_lock(&arg->mutex);
+			c0 = cs + arg->next_node[s][kk];
+			arg->next_node[s][kk] += nc;
+			pthread_mutex_unlock(&arg->mutex);
+			if(c0>=n)
+				break;
+			c1 = n-c0<nc ? n : c0+nc;
+			blasfeo_hp_dgemm_nn(r1-r0, c1-c0, w, -1.0, sD, r0, dj+k0, sD, k0, dj+c0, 1.0, sD, r0, dj+c0, sD, r0, dj+c0);
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// right-looking blocked alg with lookahead: at each step the thread 0 updates and factorizes
+// the next panel, while the other threads update the trailing matrix, split in column blocks
+// taken from a shared counter; the thread 0 joins them once the panel is factorized
+static void blasfeo_hp_dgetrf_rp_mt_work(int tid, int nth, void *ptr)
+	{
+
+	struct blasfeo_hp_dgetrf_rp_mt_arg *arg = ptr;
+
+	int m = arg->m;
+	int n = arg->n;
+	struct blasfeo_dmat *sD = arg->sD;
+	int dj = arg->dj;
+	int *ipiv = arg->ipiv;
+
+	const int nb = GETRF_NB;
+	const int nc = GETRF_MT_NC;
+
+	int ii, k0, k1, w, w1, c0, c1, cs, cw, step;
+
+	int p = m<n ? m : n;
+
+	// first panel
+	if(tid==0)
+		{
+		w = p<nb ? p : nb;
+		blasfeo_hp_dgetrf_rp_panel_lib8(m, w, sD, 0, dj, ipiv);
+		}
+	blasfeo_barrier_wait(arg->bar);
+
+	for(k0=0, step=0; k0<p; k0+=nb, step++)
+		{
+
+		w = p-k0<nb ? p-k0 : nb;
+		k1 = k0+w;
+		w1 = p-k1<nb ? p-k1 : nb;
+		// first column of the trailing update tasks
+		cs = k1+w1;
+
+		if(tid==0)
+			{
+			// the counters of the next step are free, the previous ones have been closed by the barrier
+			arg->next[(step+1)&1] = 0;
+			arg->done[(step+1)&1] = 0;
+			for(ii=0; ii<arg->nnode; ii++)
+				arg->next_node[(step+1)&1][ii] = 0;
+			// lookahead
+			if(w1>0)
+				{
+				blasfeo_hp_dgetrf_rp_update_lib8(m, k0, w, k1, k1+w1, sD, dj, ipiv);
+				blasfeo_hp_dgetrf_rp_panel_lib8(m-k1, w1, sD, k1, dj+k1, ipiv);
+				}
+			}
+
+		// trailing update
+		if(arg->nnode>=2)
+			blasfeo_hp_dgetrf_rp_mt_update_numa(tid, arg, step&1, k0, w, cs);
+		else while(1)
+			{
+			pthread_mutex_lock(&arg->mutex);
+			c0 = cs + arg->next[step&1];
+			arg->next[step&1] += nc;
+			pthread_mutex_unlock(&arg->mutex);
+			if(c0>=n)
+				break;
+			c1 = n-c0<nc ? n : c0+nc;
+			blasfeo_hp_dgetrf_rp_update_lib8(m, k0, w, c0, c1, sD, dj, ipiv);
+			}
+
+		blasfeo_barrier_wait(arg->bar);
+
+		}
+
+	// row interchanges on the left of each panel, split in column blocks
+	cw = (p+nth-1)/nth;
+	c0 = tid*cw;
+	c1 = c0+cw<p ? c0+cw : p;
+	for(k0=nb; k0<p; k0+=nb)
+		{
+		if(c0<k0)
+			{
+			w = p-k0<nb ? p-k0 : nb;
+			blasfeo_hp_dgetrf_rp_swap_lib8(k0, w, dj+c0, dj+(c1<k0 ? c1 : k0), sD, ipiv);
+			}
+		}
+
+	return;
+
+	}
+
+
+
+static void blasfeo_hp_dgetrf_rp_mt(int nth, int m, int n, struct blasfeo_dmat *sD, int dj, int *ipiv)
+	{
+
+	struct blasfeo_hp_dgetrf_rp_mt_arg arg;
+	struct blasfeo_barrier bar;
+
+	int ii;
+
+	blasfeo_barrier_init(&bar, nth);
+
+	arg.m = m;
+	arg.n = n;
+	arg.sD = sD;
+	arg.dj = dj;
+	arg.ipiv = ipiv;
+	arg.next[0] = 0;
+	arg.next[1] = 0;
+	arg.done[0] = 0;
+	arg.done[1] = 0;
+	arg.nnode = blasfeo_thread_numa_nodes(nth, arg.node);
+	for(ii=0; ii<arg.nnode; ii++)
+		{
+		arg.next_node[0][ii] = 0;
+		arg.next_node[1][ii] = 0;
+		}
+	pthread_mutex_init(&arg.mutex, NULL);
+	pthread_cond_init(&arg.cond, NULL);
+	arg.bar = &bar;
+
+	blasfeo_parallel_run(nth, &blasfeo_hp_dgetrf_rp_mt_work, &arg);
+
+	pthread_cond_destroy(&arg.cond);
+	pthread_mutex_destroy(&arg.mutex);
+	blasfeo_barrier_destroy(&bar);
+
+	return;
+
+	}
+
+
+
+// number of threads used by the multi-threaded alg: at least one trailing update task per thread
+static int blasfeo_hp_dgetrf_rp_mt_nth(int m, int n)
+	{
+	int p = m<n ? m : n;
+	int nth = blasfeo_get_num_threads_flops(2.0*((double) m*n*p - 0.5*(m+n)*p*p + 1.0/3.0*p*p*p));
+	if(p<2*GETRF_NB)
+		return 1;
+	int nth_max = (n-2*GETRF_NB+GETRF_MT_NC-1)/GETRF_MT_NC;
+	return nth<nth_max ? nth : nth_max;
+	}
+
+#endif // MULTI_THREAD
+
+
+
 // dgetrf row pivoting
 void blasfeo_hp_dgetrf_rp(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, int *ipiv)
 	{
+
+	if(ci!=0 | di!=0)
+		{
 #if defined(BLASFEO_REF_API)
-	blasfeo_ref_dgetrf_rp(m, n, sC, ci, cj, sD, di, dj, ipiv);
+		blasfeo_ref_dgetrf_rp(m, n, sC, ci, cj, sD, di, dj, ipiv);
+		return;
 #else
-	printf("\nblasfeo_dgetrf_rp: feature not implemented yet\n");
-	exit(1);
+		printf("\nblasfeo_dgetrf_rp: feature not implemented yet: ci=%d, di=%d\n", ci, di);
+		exit(1);
+#endif
+		}
+
+	// the inverse of the diagonal is stored in sD->dA
+	sD->use_dA = 0;
+
+	if(m<=0 | n<=0)
+		return;
+
+	// needs to perform row-excanges on the yet-to-be-factorized matrix too
+	if(sC->pA!=sD->pA | cj!=dj)
+		blasfeo_dgecp(m, n, sC, ci, cj, sD, di, dj);
+
+#if defined(MULTI_THREAD)
+	int nth = blasfeo_hp_dgetrf_rp_mt_nth(m, n);
+	if(nth>1)
+		{
+		blasfeo_hp_dgetrf_rp_mt(nth, m, n, sD, dj, ipiv);
+		sD->use_dA = dj==0;
+		return;
+		}
 #endif
+
+	blasfeo_hp_dgetrf_rp_blk_lib8(m, n, sD, dj, ipiv);
+
+	sD->use_dA = dj==0;
+
+	return;
+
 	}
 
 
@@ -963,7 +1446,7 @@ void blasfeo_hp_dgetrf_rp(int m, int n, struct blasfeo_dmat *sC, int ci, int cj,
 int blasfeo_hp_dgeqrf_worksize(int m, int n)
 	{
 #if defined(BLASFEO_REF_API)
-	blasfeo_ref_dgeqrf_worksize(m, n);
+	return blasfeo_ref_dgeqrf_worksize(m, n);
 #else
 	printf("\nblasfeo_dgeqrf_worksize: feature not implemented yet\n");
 	exit(1);
@@ -1057,7 +1540,8 @@ void blasfeo_hp_dgelqf(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, st
 //d_print_mat(8, 8, pT, 8);
 		jj = ii+8;
 #if 1
-		for(; jj<m-23; jj+=24)
+		// the 24-row kernel is only correct if the reflector length is a multiple of 8
+		for(; jj<m-23 & ((n-ii)&(ps-1))==0; jj+=24)
 			{
 			kernel_dlarfb8_rn_24_lib8(n-ii, pD+ii*sdd+ii*ps, pT, pD+jj*sdd+ii*ps, sdd);
 			}
@@ -1186,7 +1670,8 @@ void blasfeo_hp_dgelqf_pd(int m, int n, struct blasfeo_dmat *sC, int ci, int cj,
 //d_print_mat(8, 8, pT, 8);
 //return;
 #if 1
-		for(; jj<m-23; jj+=24)
+		// the 24-row kernel is only correct if the reflector length is a multiple of 8
+		for(; jj<m-23 & ((n-ii)&(ps-1))==0; jj+=24)
 			{
 			kernel_dlarfb8_rn_24_lib8(n-ii, pD+ii*sdd+ii*ps, pT, pD+jj*sdd+ii*ps, sdd);
 			}
@@ -48,24 +48,77 @@
 
 void blasfeo_hp_sgemv_n(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, float beta, struct blasfeo_svec *sy, int yi, struct blasfeo_svec *sz, int zi)
 	{
-#if defined(BLASFEO_REF_API)
-	blasfeo_ref_sgemv_n(m, n, alpha, sA, ai, aj, sx, xi, beta, sy, yi, sz, zi);
-#else
-	printf("\nblasfeo_sgemv_n: feature not implemented yet\n");
-	exit(1);
-#endif
+
+	if(m<=0)
+		return;
+
+	const int bs = 16;
+
+	int i;
+
+	int sda = sA->cn;
+	float *pA = sA->pA + aj*bs + ai/bs*bs*sda + ai%bs;
+	float *x = sx->pa + xi;
+	float *y = sy->pa + yi;
+	float *z = sz->pa + zi;
+
+	i = 0;
+	// clean up at the beginning
+	if(ai%bs!=0)
+		{
+		i = bs-ai%bs<m ? bs-ai%bs : m;
+		kernel_sgemv_n_16_vs_lib16(n, &alpha, pA, x, &beta, y, z, i);
+		pA += bs*sda - ai%bs;
+		y += i;
+		z += i;
+		m -= i;
+		}
+	// main loop
+	i = 0;
+	for( ; i<m-15; i+=16)
+		{
+		kernel_sgemv_n_16_lib16(n, &alpha, &pA[i*sda], x, &beta, &y[i], &z[i]);
+		}
+	if(i<m)
+		{
+		kernel_sgemv_n_16_vs_lib16(n, &alpha, &pA[i*sda], x, &beta, &y[i], &z[i], m-i);
+		}
+
+	return;
+
 	}
 
 
 
 void blasfeo_hp_sgemv_t(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, float beta, struct blasfeo_svec *sy, int yi, struct blasfeo_svec *sz, int zi)
 	{
-#if defined(BLASFEO_REF_API)
-	blasfeo_ref_sgemv_t(m, n, alpha, sA, ai, aj, sx, xi, beta, sy, yi, sz, zi);
-#else
-	printf("\nblasfeo_sgemv_t: feature not implemented yet\n");
-	exit(1);
-#endif
+
+	if(n<=0)
+		return;
+
+	const int bs = 16;
+
+	int i;
+
+	int sda = sA->cn;
+	float *pA = sA->pA + aj*bs + ai/bs*bs*sda + ai%bs;
+	int offsetA = ai%bs;
+	float *x = sx->pa + xi;
+	float *y = sy->pa + yi;
+	float *z = sz->pa + zi;
+
+	i = 0;
+	for( ; i<n-7; i+=8)
+		{
+		kernel_sgemv_t_8_lib16(m, &alpha, offsetA, &pA[i*bs], sda, x, &beta, &y[i], &z[i]);
+		}
+	if(i<n)
+		{
+		kernel_sgemv_t_8_vs_lib16(m, &alpha, offsetA, &pA[i*bs], sda, x, &beta, &y[i], &z[i], n-i);
+		}
+
+	return;
+
 	}
 
 
@@ -132,15 +185,15 @@ void blasfeo_hp_strmv_lnn(int m, struct blasfeo_smat *sA, int ai, int aj, struct
 
 
 // m >= n
-void blasfeo_hp_strmv_lnu(int m, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, struct blasfeo_svec *sz, int zi)
-	{
-#if defined(BLASFEO_REF_API)
-	blasfeo_ref_strmv_lnu(m, sA, ai, aj, sx, xi, sz, zi);
-#else
-	printf("\nblasfeo_strmv_lnu: feature not implemented yet\n");
-	exit(1);
-#endif
-	}
+//void blasfeo_hp_strmv_lnu(int m, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, struct blasfeo_svec *sz, int zi)
+//	{
+//#if defined(BLASFEO_REF_API)
+//	blasfeo_ref_strmv_lnu(m, sA, ai, aj, sx, xi, sz, zi);
+//#else
+//	printf("\nblasfeo_strmv_lnu: feature not implemented yet\n");
+//	exit(1);
+//#endif
+//	}
 
 
 
@@ -158,15 +211,15 @@ void blasfeo_hp_strmv_ltn(int m, struct blasfeo_smat *sA, int ai, int aj, struct
 
 
 // m >= n
-void blasfeo_hp_strmv_ltu(int m, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, struct blasfeo_svec *sz, int zi)
-	{
-#if defined(BLASFEO_REF_API)
-	blasfeo_ref_strmv_ltu(m, sA, ai, aj, sx, xi, sz, zi);
-#else
-	printf("\nblasfeo_strmv_ltu: feature not implemented yet\n");
-	exit(1);
-#endif
-	}
+//void blasfeo_hp_strmv_ltu(int m, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, struct blasfeo_svec *sz, int zi)
+//	{
+//#if defined(BLASFEO_REF_API)
+//	blasfeo_ref_strmv_ltu(m, sA, ai, aj, sx, xi, sz, zi);
+//#else
+//	printf("\nblasfeo_strmv_ltu: feature not implemented yet\n");
+//	exit(1);
+//#endif
+//	}
 
 
 
@@ -357,10 +410,10 @@ void blasfeo_strmv_lnn(int m, struct blasfeo_smat *sA, int ai, int aj, struct bl
 
 
 
-void blasfeo_strmv_lnu(int m, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, struct blasfeo_svec *sz, int zi)
-	{
-	blasfeo_hp_strmv_lnu(m, sA, ai, aj, sx, xi, sz, zi);
-	}
+//void blasfeo_strmv_lnu(int m, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, struct blasfeo_svec *sz, int zi)
+//	{
+//	blasfeo_hp_strmv_lnu(m, sA, ai, aj, sx, xi, sz, zi);
+//	}
 
 
 
@@ -371,10 +424,10 @@ void blasfeo_strmv_ltn(int m, struct blasfeo_smat *sA, int ai, int aj, struct bl
 
 
 
-void blasfeo_strmv_ltu(int m, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, struct blasfeo_svec *sz, int zi)
-	{
-	blasfeo_hp_strmv_ltu(m, sA, ai, aj, sx, xi, sz, zi);
-	}
+//void blasfeo_strmv_ltu(int m, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, struct blasfeo_svec *sz, int zi)
+//	{
+//	blasfeo_hp_strmv_ltu(m, sA, ai, aj, sx, xi, sz, zi);
+//	}
 
 
 
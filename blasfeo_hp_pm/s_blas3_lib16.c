@@ -49,12 +49,81 @@
 // dgemm nn
 void blasfeo_hp_sgemm_nn(int m, int n, int k, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, float beta, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj)
 	{
+
+	if(m<=0 | n<=0)
+		return;
+
+	if(ai>0 | ci>0 | di>0)
+		{
 #if defined(BLASFEO_REF_API)
-	blasfeo_ref_sgemm_nn(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+		blasfeo_ref_sgemm_nn(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+		return;
 #else
-	printf("\nblasfeo_sgemm_nn: feature not implemented yet\n");
-	exit(1);
+		printf("\nblasfeo_sgemm_nn: feature not implemented yet: ai>0, ci>0, di>0\n");
+		exit(1);
 #endif
+		}
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	const int bs = 16;
+
+	int sda = sA->cn;
+	int sdb = sB->cn;
+	int sdc = sC->cn;
+	int sdd = sD->cn;
+	int offsetB = bi%bs;
+	float *pA = sA->pA + aj*bs;
+	float *pB = sB->pA + bj*bs + bi/bs*bs*sdb;
+	float *pC = sC->pA + cj*bs;
+	float *pD = sD->pA + dj*bs;
+
+	int i, j;
+
+	i = 0;
+	for(; i<m-31; i+=32)
+		{
+		j = 0;
+		for(; j<n-7; j+=8)
+			{
+			kernel_sgemm_nn_32x8_lib16(k, &alpha, &pA[i*sda], sda, offsetB, &pB[j*bs], sdb, &beta, &pC[j*bs+i*sdc], sdc, &pD[j*bs+i*sdd], sdd);
+			}
+		if(j<n)
+			{
+			kernel_sgemm_nn_32x8_vs_lib16(k, &alpha, &pA[i*sda], sda, offsetB, &pB[j*bs], sdb, &beta, &pC[j*bs+i*sdc], sdc, &pD[j*bs+i*sdd], sdd, m-i, n-j);
+			}
+		}
+	if(m-i>16)
+		{
+		goto left_32;
+		}
+	if(m-i>0)
+		{
+		goto left_16;
+		}
+
+	// common return if i==m
+	return;
+
+	// clean up loops definitions
+
+	left_32:
+	j = 0;
+	for(; j<n; j+=8)
+		{
+		kernel_sgemm_nn_32x8_vs_lib16(k, &alpha, &pA[i*sda], sda, offsetB, &pB[j*bs], sdb, &beta, &pC[j*bs+i*sdc], sdc, &pD[j*bs+i*sdd], sdd, m-i, n-j);
+		}
+	return;
+
+	left_16:
+	j = 0;
+	for(; j<n; j+=8)
+		{
+		kernel_sgemm_nn_16x8_vs_lib16(k, &alpha, &pA[i*sda], offsetB, &pB[j*bs], sdb, &beta, &pC[j*bs+i*sdc], &pD[j*bs+i*sdd], m-i, n-j);
+		}
+	return;
+
 	}
 
 
@@ -62,12 +131,80 @@ void blasfeo_hp_sgemm_nn(int m, int n, int k, float alpha, struct blasfeo_smat *
 // dgemm nt
 void blasfeo_hp_sgemm_nt(int m, int n, int k, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, float beta, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj)
 	{
+
+	if(m<=0 | n<=0)
+		return;
+
+	if(ai>0 | bi>0 | ci>0 | di>0)
+		{
 #if defined(BLASFEO_REF_API)
-	blasfeo_ref_sgemm_nt(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+		blasfeo_ref_sgemm_nt(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+		return;
 #else
-	printf("\nblasfeo_sgemm_nt: feature not implemented yet\n");
-	exit(1);
+		printf("\nblasfeo_sgemm_nt: feature not implemented yet: ai>0, bi>0, ci>0, di>0\n");
+		exit(1);
 #endif
+		}
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	const int bs = 16;
+
+	int sda = sA->cn;
+	int sdb = sB->cn;
+	int sdc = sC->cn;
+	int sdd = sD->cn;
+	float *pA = sA->pA + aj*bs;
+	float *pB = sB->pA + bj*bs;
+	float *pC = sC->pA + cj*bs;
+	float *pD = sD->pA + dj*bs;
+
+	int i, j;
+
+	i = 0;
+	for(; i<m-31; i+=32)
+		{
+		j = 0;
+		for(; j<n-7; j+=8)
+			{
+			kernel_sgemm_nt_32x8_lib16(k, &alpha, &pA[i*sda], sda, &pB[j%bs+(j/bs)*bs*sdb], &beta, &pC[j*bs+i*sdc], sdc, &pD[j*bs+i*sdd], sdd);
+			}
+		if(j<n)
+			{
+			kernel_sgemm_nt_32x8_vs_lib16(k, &alpha, &pA[i*sda], sda, &pB[j%bs+(j/bs)*bs*sdb], &beta, &pC[j*bs+i*sdc], sdc, &pD[j*bs+i*sdd], sdd, m-i, n-j);
+			}
+		}
+	if(m-i>16)
+		{
+		goto left_32;
+		}
+	if(m-i>0)
+		{
+		goto left_16;
+		}
+
+	// common return if i==m
+	return;
+
+	// clean up loops definitions
+
+	left_32:
+	j = 0;
+	for(; j<n; j+=8)
+		{
+		kernel_sgemm_nt_32x8_vs_lib16(k, &alpha, &pA[i*sda], sda, &pB[j%bs+(j/bs)*bs*sdb], &beta, &pC[j*bs+i*sdc], sdc, &pD[j*bs+i*sdd], sdd, m-i, n-j);
+		}
+	return;
+
+	left_16:
+	j = 0;
+	for(; j<n; j+=8)
+		{
+		kernel_sgemm_nt_16x8_vs_lib16(k, &alpha, &pA[i*sda], &pB[j%bs+(j/bs)*bs*sdb], &beta, &pC[j*bs+i*sdc], &pD[j*bs+i*sdd], m-i, n-j);
+		}
+	return;
+
 	}
 
 
@@ -231,12 +368,67 @@ void blasfeo_hp_strsm_rlnu(int m, int n, float alpha, struct blasfeo_smat *sA, i
 // dtrsm_right_lower_transposed_notunit
 void blasfeo_hp_strsm_rltn(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj)
 	{
+
+	if(ai!=0 | bi!=0 | di!=0 | alpha!=1.0)
+		{
 #if defined(BLASFEO_REF_API)
-	blasfeo_ref_strsm_rltn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+		blasfeo_ref_strsm_rltn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+		return;
 #else
-	printf("\nblasfeo_strsm_rltn: feature not implemented yet\n");
-	exit(1);
+		printf("\nblasfeo_strsm_rltn: feature not implemented yet: ai=%d, bi=%d, di=%d, alpha=%f\n", ai, bi, di, alpha);
+		exit(1);
 #endif
+		}
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	const int bs = 16;
+
+	int sda = sA->cn;
+	int sdb = sB->cn;
+	int sdd = sD->cn;
+	float *pA = sA->pA + aj*bs;
+	float *pB = sB->pA + bj*bs;
+	float *pD = sD->pA + dj*bs;
+	float *dA = sA->dA;
+
+	int i, j;
+
+	if(aj!=0 | sA->use_dA!=1)
+		{
+		for(i=0; i<n; i++)
+			dA[i] = 1.0 / pA[i%bs+(i/bs)*bs*sda+i*bs];
+		sA->use_dA = aj==0;
+		}
+
+	if(m<=0 || n<=0)
+		return;
+
+	i = 0;
+	for(; i<m-15; i+=16)
+		{
+		j = 0;
+		for(; j<n-7; j+=8)
+			{
+			kernel_strsm_nt_rl_inv_16x8_lib16(j, &pD[i*sdd], &pA[j%bs+(j/bs)*bs*sda], &pB[j*bs+i*sdb], &pD[j*bs+i*sdd], &pA[j%bs+(j/bs)*bs*sda+j*bs], &dA[j]);
+			}
+		if(j<n)
+			{
+			kernel_strsm_nt_rl_inv_16x8_vs_lib16(j, &pD[i*sdd], &pA[j%bs+(j/bs)*bs*sda], &pB[j*bs+i*sdb], &pD[j*bs+i*sdd], &pA[j%bs+(j/bs)*bs*sda+j*bs], &dA[j], m-i, n-j);
+			}
+		}
+	if(i<m)
+		{
+		j = 0;
+		for(; j<n; j+=8)
+			{
+			kernel_strsm_nt_rl_inv_16x8_vs_lib16(j, &pD[i*sdd], &pA[j%bs+(j/bs)*bs*sda], &pB[j*bs+i*sdb], &pD[j*bs+i*sdd], &pA[j%bs+(j/bs)*bs*sda+j*bs], &dA[j], m-i, n-j);
+			}
+		}
+
+	return;
+
 	}
 
 
@@ -332,26 +524,75 @@ void blasfeo_hp_strmm_rlnn(int m, int n, float alpha, struct blasfeo_smat *sB, i
 
 
 
-void blasfeo_hp_ssyrk_ln(int m, int k, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, float beta, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj)
+void blasfeo_hp_ssyrk_ln_mn(int m, int n, int k, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, float beta, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj)
 	{
+
+	if(m<=0 | n<=0)
+		return;
+
+	if(ai>0 | bi>0 | ci>0 | di>0)
+		{
 #if defined(BLASFEO_REF_API)
-	blasfeo_ref_ssyrk_ln(m, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+		blasfeo_ref_ssyrk_ln_mn(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+		return;
 #else
-	printf("\nblasfeo_ssyrk_ln: feature not implemented yet\n");
-	exit(1);
+		printf("\nblasfeo_ssyrk_ln_mn: feature not implemented yet: ai>0, bi>0, ci>0, di>0\n");
+		exit(1);
 #endif
+		}
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	const int bs = 16;
+
+	int sda = sA->cn;
+	int sdb = sB->cn;
+	int sdc = sC->cn;
+	int sdd = sD->cn;
+	float *pA = sA->pA + aj*bs;
+	float *pB = sB->pA + bj*bs;
+	float *pC = sC->pA + cj*bs;
+	float *pD = sD->pA + dj*bs;
+
+	int i, j;
+
+	for(i=0; i<m; i+=16)
+		{
+		// sub-diagonal blocks
+		for(j=0; j<i & j<n; j+=8)
+			{
+			if(m-i>=16 & n-j>=8)
+				kernel_sgemm_nt_16x8_lib16(k, &alpha, &pA[i*sda], &pB[j%bs+(j/bs)*bs*sdb], &beta, &pC[j*bs+i*sdc], &pD[j*bs+i*sdd]);
+			else
+				kernel_sgemm_nt_16x8_vs_lib16(k, &alpha, &pA[i*sda], &pB[j%bs+(j/bs)*bs*sdb], &beta, &pC[j*bs+i*sdc], &pD[j*bs+i*sdd], m-i, n-j);
+			}
+		// diagonal block, as a 16x8 and a 8x8 lower triangle
+		if(i<n)
+			{
+			if(m-i>=16 & n-i>=16)
+				{
+				kernel_ssyrk_nt_l_16x8_lib16(k, &alpha, &pA[i*sda], &pB[i*sdb], &beta, &pC[i*bs+i*sdc], &pD[i*bs+i*sdd]);
+				kernel_ssyrk_nt_l_8x8_lib16(k, &alpha, &pA[8+i*sda], &pB[8+i*sdb], &beta, &pC[8+(i+8)*bs+i*sdc], &pD[8+(i+8)*bs+i*sdd]);
+				}
+			else
+				{
+				kernel_ssyrk_nt_l_16x8_vs_lib16(k, &alpha, &pA[i*sda], &pB[i*sdb], &beta, &pC[i*bs+i*sdc], &pD[i*bs+i*sdd], m-i, n-i);
+				if(m-i>8 & n-i>8)
+					kernel_ssyrk_nt_l_8x8_vs_lib16(k, &alpha, &pA[8+i*sda], &pB[8+i*sdb], &beta, &pC[8+(i+8)*bs+i*sdc], &pD[8+(i+8)*bs+i*sdd], m-i-8, n-i-8);
+				}
+			}
+		}
+
+	return;
+
 	}
 
 
 
-void blasfeo_hp_ssyrk_ln_mn(int m, int n, int k, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, float beta, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj)
+void blasfeo_hp_ssyrk_ln(int m, int k, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, float beta, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj)
 	{
-#if defined(BLASFEO_REF_API)
-	blasfeo_ref_ssyrk_ln_mn(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
-#else
-	printf("\nblasfeo_ssyrk_ln_mn: feature not implemented yet\n");
-	exit(1);
-#endif
+	blasfeo_hp_ssyrk_ln_mn(m, m, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
 	}
 
 
@@ -39,6 +39,7 @@
 #include <blasfeo_common.h>
 #include <blasfeo_s_kernel.h>
 #include <blasfeo_s_aux.h>
+#include <blasfeo_memory.h>
 #if defined(BLASFEO_REF_API)
 #include <blasfeo_s_blasfeo_ref_api.h>
 #endif
@@ -1630,7 +1631,7 @@ void blasfeo_hp_ssyrk_ln(int m, int k, float alpha, struct blasfeo_smat *sA, int
 	if(k>K_MAX_STACK)
 		{
 		sdu = (k+ps-1)/ps*ps;
-		mem = malloc(8*sdu*sizeof(float)+63); // TODO update when bigger kernels are used !!!!!!!!!!!!!!!!
+		blasfeo_work_malloc(&mem, 8*sdu*sizeof(float)+63); // TODO update when bigger kernels are used !!!!!!!!!!!!!!!!
 		blasfeo_align_64_byte(mem, (void **) &pU);
 		}
 	else
@@ -1980,7 +1981,7 @@ loop_BCD:
 end:
 	if(k>K_MAX_STACK)
 		{
-		free(mem);
+		blasfeo_work_free(mem);
 		}
 	return;
 
@@ -48,31 +48,78 @@
 
 
 // spotrf
-void blasfeo_hp_spotrf_l(int m, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj)
+void blasfeo_hp_spotrf_l_mn(int m, int n, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj)
 	{
+
+	if(m<=0 | n<=0)
+		return;
+
+	if(ci>0 | di>0)
+		{
 #if defined(BLASFEO_REF_API)
-	blasfeo_ref_spotrf_l(m, sC, ci, cj, sD, di, dj);
+		blasfeo_ref_spotrf_l_mn(m, n, sC, ci, cj, sD, di, dj);
+		return;
 #else
-	printf("\nblasfeo_spotrf_l: feature not implemented yet\n");
-	exit(1);
+		printf("\nblasfeo_spotrf_l_mn: feature not implemented yet: ci>0, di>0\n");
+		exit(1);
 #endif
+		}
+
+	const int bs = 16;
+
+	int i, j;
+
+	int sdc = sC->cn;
+	int sdd = sD->cn;
+	float *pC = sC->pA + cj*bs;
+	float *pD = sD->pA + dj*bs;
+	float *dD = sD->dA; // XXX what to do if di and dj are not zero
+	if(di==0 & dj==0)
+		sD->use_dA = 1;
+	else
+		sD->use_dA = 0;
+
+	for(i=0; i<m; i+=16)
+		{
+		// sub-diagonal blocks
+		for(j=0; j<i & j<n; j+=8)
+			{
+			if(m-i>=16 & n-j>=8)
+				kernel_strsm_nt_rl_inv_16x8_lib16(j, &pD[i*sdd], &pD[j%bs+(j/bs)*bs*sdd], &pC[j*bs+i*sdc], &pD[j*bs+i*sdd], &pD[j%bs+(j/bs)*bs*sdd+j*bs], &dD[j]);
+			else
+				kernel_strsm_nt_rl_inv_16x8_vs_lib16(j, &pD[i*sdd], &pD[j%bs+(j/bs)*bs*sdd], &pC[j*bs+i*sdc], &pD[j*bs+i*sdd], &pD[j%bs+(j/bs)*bs*sdd+j*bs], &dD[j], m-i, n-j);
+			}
+		// diagonal block, as a 16x8 and a 8x8 factorization
+		if(i<n)
+			{
+			if(m-i>=16 & n-i>=16)
+				{
+				kernel_spotrf_nt_l_16x8_lib16(i, &pD[i*sdd], &pD[i*sdd], &pC[i*bs+i*sdc], &pD[i*bs+i*sdd], &dD[i]);
+				kernel_spotrf_nt_l_8x8_lib16(i+8, &pD[8+i*sdd], &pD[8+i*sdd], &pC[8+(i+8)*bs+i*sdc], &pD[8+(i+8)*bs+i*sdd], &dD[i+8]);
+				}
+			else
+				{
+				kernel_spotrf_nt_l_16x8_vs_lib16(i, &pD[i*sdd], &pD[i*sdd], &pC[i*bs+i*sdc], &pD[i*bs+i*sdd], &dD[i], m-i, n-i);
+				if(m-i>8 & n-i>8)
+					kernel_spotrf_nt_l_8x8_vs_lib16(i+8, &pD[8+i*sdd], &pD[8+i*sdd], &pC[8+(i+8)*bs+i*sdc], &pD[8+(i+8)*bs+i*sdd], &dD[i+8], m-i-8, n-i-8);
+				}
+			}
+		}
+
+	return;
+
 	}
 
 
 
-// spotrf
-void blasfeo_hp_spotrf_l_mn(int m, int n, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj)
+void blasfeo_hp_spotrf_l(int m, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj)
 	{
-#if defined(BLASFEO_REF_API)
-	blasfeo_ref_spotrf_l_mn(m, n, sC, ci, cj, sD, di, dj);
-#else
-	printf("\nblasfeo_spotrf_l_mn: feature not implemented yet\n");
-	exit(1);
-#endif
+	blasfeo_hp_spotrf_l_mn(m, m, sC, ci, cj, sD, di, dj);
 	}
 
 
 
+// spotrf
 // spotrf
 void blasfeo_hp_spotrf_u(int m, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj)
 	{
@@ -112,15 +159,127 @@ void blasfeo_hp_ssyrk_spotrf_ln(int m, int k, struct blasfeo_smat *sA, int ai, i
 
 
 
+// left-looking LU factorization in blocks of 8 columns, on a matrix with zero row offset;
+// if ipiv!=NULL partial pivoting is applied, with full row swaps
+static void sgetrf_lib16(int m, int n, float *pD, int sdd, float *dD, int *ipiv)
+	{
+
+	const int bs = 16;
+
+	float d_m1 = -1.0;
+	float d_1 = 1.0;
+
+	int i, j, l, p, jb, jmax, ip;
+	float tmp;
+
+	for(j=0; j<n; j+=8)
+		{
+		jb = n-j<8 ? n-j : 8;
+		// upper part: U(0:j,j:j+jb), one block of 8 rows at a time
+		for(p=0; p<j & p<m; p+=8)
+			{
+			kernel_strsm_nn_ll_one_8x8_vs_lib16(p, &pD[p%bs+(p/bs)*bs*sdd], 0, &pD[j*bs], sdd, &pD[p%bs+(p/bs)*bs*sdd+j*bs], &pD[p%bs+(p/bs)*bs*sdd+j*bs], &pD[p%bs+(p/bs)*bs*sdd+p*bs], m-p, jb);
+			}
+		if(j>=m)
+			continue;
+		// lower part: update of A(j:m,j:j+jb) with the left columns
+		if(j>0)
+			{
+			i = j;
+			if(i%bs!=0)
+				{
+				kernel_sgemm_nn_16x8_vs_lib16(j, &d_m1, &pD[i%bs+(i/bs)*bs*sdd], 0, &pD[j*bs], sdd, &d_1, &pD[i%bs+(i/bs)*bs*sdd+j*bs], &pD[i%bs+(i/bs)*bs*sdd+j*bs], m-i<8 ? m-i : 8, jb);
+				i += 8;
+				}
+			for(; i<m-16; i+=32)
+				{
+				kernel_sgemm_nn_32x8_vs_lib16(j, &d_m1, &pD[i*sdd], sdd, 0, &pD[j*bs], sdd, &d_1, &pD[j*bs+i*sdd], sdd, &pD[j*bs+i*sdd], sdd, m-i, jb);
+				}
+			if(i<m)
+				{
+				kernel_sgemm_nn_16x8_vs_lib16(j, &d_m1, &pD[i*sdd], 0, &pD[j*bs], sdd, &d_1, &pD[j*bs+i*sdd], &pD[j*bs+i*sdd], m-i, jb);
+				}
+			}
+		// factorization of the panel
+		if(ipiv==NULL)
+			{
+			kernel_sgetrf_np_8_vs_lib16(m-j, j%bs, &pD[(j/bs)*bs*sdd+j*bs], sdd, &dD[j], jb);
+			continue;
+			}
+		kernel_sgetrf_pivot_8_vs_lib16(m-j, j%bs, &pD[(j/bs)*bs*sdd+j*bs], sdd, &dD[j], &ipiv[j], jb);
+		// apply the row swaps to the columns outside of the panel
+		jmax = m-j<jb ? m-j : jb;
+		for(l=0; l<jmax; l++)
+			{
+			ipiv[j+l] += j;
+			ip = ipiv[j+l];
+			if(ip!=j+l)
+				{
+				for(i=0; i<n; i++)
+					{
+					if(i==j)
+						i += jb;
+					if(i>=n)
+						break;
+					tmp = pD[(j+l)%bs+((j+l)/bs)*bs*sdd+i*bs];
+					pD[(j+l)%bs+((j+l)/bs)*bs*sdd+i*bs] = pD[ip%bs+(ip/bs)*bs*sdd+i*bs];
+					pD[ip%bs+(ip/bs)*bs*sdd+i*bs] = tmp;
+					}
+				}
+			}
+		}
+
+	return;
+
+	}
+
+
+
 // dgetrf no pivoting
 void blasfeo_hp_sgetrf_np(int m, int n, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj)
 	{
+
+	if(m<=0 | n<=0)
+		return;
+
+	if(ci>0 | di>0)
+		{
 #if defined(BLASFEO_REF_API)
-	blasfeo_ref_sgetrf_np(m, n, sC, ci, cj, sD, di, dj);
+		blasfeo_ref_sgetrf_np(m, n, sC, ci, cj, sD, di, dj);
+		return;
 #else
-	printf("\nblasfeo_sgetf_np: feature not implemented yet\n");
-	exit(1);
+		printf("\nblasfeo_sgetrf_np: feature not implemented yet: ci>0, di>0\n");
+		exit(1);
 #endif
+		}
+
+	const int bs = 16;
+
+	int i, j;
+
+	int sdc = sC->cn;
+	int sdd = sD->cn;
+	float *pC = sC->pA + cj*bs;
+	float *pD = sD->pA + dj*bs;
+	float *dD = sD->dA; // XXX what to do if di and dj are not zero
+
+	// copy if needed
+	if(pC!=pD)
+		{
+		for(j=0; j<n; j++)
+			for(i=0; i<m; i++)
+				pD[i%bs+(i/bs)*bs*sdd+j*bs] = pC[i%bs+(i/bs)*bs*sdc+j*bs];
+		}
+
+	sgetrf_lib16(m, n, pD, sdd, dD, NULL);
+
+	if(di==0 & dj==0)
+		sD->use_dA = 1;
+	else
+		sD->use_dA = 0;
+
+	return;
+
 	}
 
 
@@ -128,12 +287,48 @@ void blasfeo_hp_sgetrf_np(int m, int n, struct blasfeo_smat *sC, int ci, int cj,
 // dgetrf row pivoting
 void blasfeo_hp_sgetrf_rp(int m, int n, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, int *ipiv)
 	{
+
+	if(m<=0 | n<=0)
+		return;
+
+	if(ci>0 | di>0)
+		{
 #if defined(BLASFEO_REF_API)
-	blasfeo_ref_sgetrf_rp(m, n, sC, ci, cj, sD, di, dj, ipiv);
+		blasfeo_ref_sgetrf_rp(m, n, sC, ci, cj, sD, di, dj, ipiv);
+		return;
 #else
-	printf("\nblasfeo_sgetrf_rp: feature not implemented yet\n");
-	exit(1);
+		printf("\nblasfeo_sgetrf_rp: feature not implemented yet: ci>0, di>0\n");
+		exit(1);
 #endif
+		}
+
+	const int bs = 16;
+
+	int i, j;
+
+	int sdc = sC->cn;
+	int sdd = sD->cn;
+	float *pC = sC->pA + cj*bs;
+	float *pD = sD->pA + dj*bs;
+	float *dD = sD->dA; // XXX what to do if di and dj are not zero
+
+	// copy if needed
+	if(pC!=pD)
+		{
+		for(j=0; j<n; j++)
+			for(i=0; i<m; i++)
+				pD[i%bs+(i/bs)*bs*sdd+j*bs] = pC[i%bs+(i/bs)*bs*sdc+j*bs];
+		}
+
+	sgetrf_lib16(m, n, pD, sdd, dD, ipiv);
+
+	if(di==0 & dj==0)
+		sD->use_dA = 1;
+	else
+		sD->use_dA = 0;
+
+	return;
+
 	}
 
 
@@ -0,0 +1,764 @@
+###################################################################################################
+#                                                                                                 #
+# This file is part of BLASFEO.                                                                   #
+#                                                                                                 #
+# BLASFEO -- BLAS for embedded optimization.                                                      #
+# Copyright (C) 2019 by Gianluca Frison.                                                          #
+# Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              #
+# All rights reserved.                                                                            #
+#                                                                                                 #
+# The 2-Clause BSD License                                                                        #
+#                                                                                                 #
+# Redistribution and use in source and binary forms, with or without                              #
+# modification, are permitted provided that the following conditions are met:                     #
+#                                                                                                 #
+# 1. Redistributions of source code must retain the above copyright notice, this                  #
+#    list of conditions and the following disclaimer.                                             #
+# 2. Redistributions in binary form must reproduce the above copyright notice,                    #
+#    this list of conditions and the following disclaimer in the documentation                    #
+#    and/or other materials provided with the distribution.                                       #
+#                                                                                                 #
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 #
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   #
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          #
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 #
+# ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  #
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    #
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     #
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      #
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   #
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    #
+#                                                                                                 #
+# Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             #
+#                                                                                                 #
+###################################################################################################
+
+# ----------- Include
+
+# Code generator of fixed-size routines: for each entry of a spec file it emits a fully unrolled implementation
+# specialized for the given sizes, working on the panel-major matrices of the library.
+#
+# usage: python3 blasfeo_codegen.py spec.json output_dir
+#
+# The spec file lists the routines and their sizes, e.g.
+#
+# {
+#   "routines": [
+#     {"routine": "dgemm_nt", "m": 16, "n": 12, "k": 12},
+#     {"routine": "dpotrf_l", "m": 12}
+#   ]
+# }
+#
+# and the generator writes to output_dir:
+# - blasfeo_fixed.h: the prototypes of the generated routines, e.g. blasfeo_fix_dgemm_nt_16x12x12
+# - blasfeo_fixed.c: their implementation, with one body per panel size (4 or 8) selected by D_PS
+# - blasfeo_fixed_benchmark.c: a benchmark of each generated routine against the generic one
+#
+# The generated routines take the same arguments as the generic ones minus the sizes. The row offsets of the
+# matrix arguments must be multiple of the panel size, otherwise the generic routine is called instead; the same
+# happens for the sizes too large for the unrolled code to beat the generic routine.
+# The vector code uses the GCC vector extensions (GCC and clang).
+
+import sys
+import json
+import argparse
+from pathlib import Path
+
+
+
+# supported routines: sizes, and largest unrolled work (product of the sizes, see unrolled())
+ROUTINES = {
+	'dgemm_nn': {'dims': ['m', 'n', 'k'], 'max_unroll': 16*16*16},
+	'dgemm_nt': {'dims': ['m', 'n', 'k'], 'max_unroll': 16*16*16},
+	'dsyrk_ln': {'dims': ['m', 'k'], 'max_unroll': 16*16*16},
+	'dtrsm_rltn': {'dims': ['m', 'n'], 'max_unroll': 16*16*16},
+	'dpotrf_l': {'dims': ['m'], 'max_unroll': 13*13*13},
+	'dtrsv_lnn': {'dims': ['m'], 'max_unroll': 32*32},
+	'dtrsv_ltn': {'dims': ['m'], 'max_unroll': 16*16},
+	}
+
+# largest size
+MAX_SIZE = 64
+
+# register blocking (row panels x columns) of the vector code for each panel size
+BLOCKING = {4: (2, 4), 8: (2, 8)}
+
+PANEL_SIZES = [4, 8]
+
+HEADER = '''/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* This file is generated by codegen/blasfeo_codegen.py from {spec}, do not edit.
+*                                                                                                 *
+**************************************************************************************************/
+'''
+
+
+
+def parse_arguments():
+	parser = argparse.ArgumentParser(description='BLASFEO fixed-size code generator')
+	parser.add_argument(dest='spec', type=str, help='spec file (json) with the routines and their sizes')
+	parser.add_argument(dest='output_dir', type=str, help='directory of the generated files')
+	return parser.parse_args()
+
+
+
+def read_spec(spec_file):
+	with open(spec_file) as f:
+		spec = json.load(f)
+	entries = []
+	for entry in spec['routines']:
+		routine = entry.get('routine')
+		if routine not in ROUTINES:
+			sys.exit('error: blasfeo_codegen: unknown routine {} (supported: {})'.format(routine, ', '.join(ROUTINES)))
+		dims = [entry.get(d) for d in ROUTINES[routine]['dims']]
+		for d, v in zip(ROUTINES[routine]['dims'], dims):
+			if not isinstance(v, int) or v<1 or v>MAX_SIZE:
+				sys.exit('error: blasfeo_codegen: {}: {} must be an integer between 1 and {}'.format(routine, d, MAX_SIZE))
+		if (routine, dims) not in entries:
+			entries.append((routine, dims))
+			if not unrolled(routine, dims):
+				print('note: blasfeo_codegen: {} {}: too large to pay off unrolled, the generic routine is called'.format(routine, 'x'.join(str(d) for d in dims)), file=sys.stderr)
+	return entries
+
+
+
+def unrolled(routine, dims):
+	# whether the routine is fully unrolled, or its body calls the generic routine: past the limits (measured on Haswell
+	# with D_PS=4 and Skylake-X with D_PS=8) the unrolled code spills registers and misses the instruction cache, and
+	# it is slower than the generic routine
+	if routine=='dsyrk_ln':
+		m, k = dims
+		work = m*m*k
+	elif routine=='dtrsm_rltn':
+		m, n = dims
+		work = m*n*n
+	elif routine=='dpotrf_l':
+		work = dims[0]**3
+	elif routine in ('dtrsv_lnn', 'dtrsv_ltn'):
+		work = dims[0]**2
+	else:
+		m, n, k = dims
+		work = m*n*k
+	return work<=ROUTINES[routine]['max_unroll']
+
+
+
+def fun_name(routine, dims):
+	return 'blasfeo_fix_{}_{}'.format(routine, 'x'.join(str(d) for d in dims))
+
+
+
+def signature(routine, dims):
+	mat = 'struct blasfeo_dmat *s{0}, int {1}i, int {1}j'
+	vec = 'struct blasfeo_dvec *s{0}, int {0}i'
+	if routine in ('dgemm_nn', 'dgemm_nt', 'dsyrk_ln'):
+		args = ['double alpha', mat.format('A', 'a'), mat.format('B', 'b'), 'double beta', mat.format('C', 'c'), mat.format('D', 'd')]
+	elif routine=='dtrsm_rltn':
+		args = ['double alpha', mat.format('A', 'a'), mat.format('B', 'b'), mat.format('D', 'd')]
+	elif routine=='dpotrf_l':
+		args = [mat.format('C', 'c'), mat.format('D', 'd')]
+	else: # dtrsv
+		args = [mat.format('A', 'a'), vec.format('x'), vec.format('z')]
+	return 'void {}({})'.format(fun_name(routine, dims), ', '.join(args))
+
+
+
+def generic_call(routine, dims):
+	if routine in ('dgemm_nn', 'dgemm_nt', 'dsyrk_ln'):
+		args = 'alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj'
+	elif routine=='dtrsm_rltn':
+		args = 'alpha, sA, ai, aj, sB, bi, bj, sD, di, dj'
+	elif routine=='dpotrf_l':
+		args = 'sC, ci, cj, sD, di, dj'
+	else:
+		args = 'sA, ai, aj, sx, xi, sz, zi'
+	return 'blasfeo_{}({}, {});'.format(routine, ', '.join(str(d) for d in dims), args)
+
+
+
+def flops(routine, dims):
+	if routine in ('dgemm_nn', 'dgemm_nt'):
+		m, n, k = dims
+		return 2.0*m*n*k
+	if routine=='dsyrk_ln':
+		m, k = dims
+		return 1.0*m*(m+1)*k
+	if routine=='dtrsm_rltn':
+		m, n = dims
+		return 1.0*m*n*n
+	if routine=='dpotrf_l':
+		m, = dims
+		return 1.0/3.0*m*m*m
+	m, = dims
+	return 1.0*m*m
+
+
+
+class Emitter:
+
+	def __init__(self):
+		self.lines = []
+
+	def __call__(self, line='', ind=1):
+		self.lines.append('\t'*ind+line if line else '')
+
+	def text(self):
+		return '\n'.join(self.lines)+'\n'
+
+
+
+# matrix element and panel column addresses, with the row offset multiple of the panel size
+
+def el(ps, X, i, j):
+	return 'p{}{}[{}]'.format(X, i//ps, j*ps+i%ps)
+
+def col(ps, X, p, j):
+	return 'p{}{}+{}'.format(X, p, j*ps)
+
+def panel_pointers(e, ps, X, x, nrow):
+	e('int sd{0} = s{1}->cn;'.format(x, X))
+	e('double *p{0}0 = s{0}->pA + {1}i*sd{1} + {1}j*{2};'.format(X, x, ps))
+	for p in range(1, (nrow+ps-1)//ps):
+		e('double *p{0}{1} = p{0}0 + {2}*sd{3};'.format(X, p, p*ps, x))
+
+
+
+class Panel:
+	# operations on panel columns, held either in one vector register (GCC vector extensions) or in ps scalars;
+	# the rows from nrow on of the last panel are padding: the vector code loads them as zero (their content may be
+	# anything, and denormals would stall the arithmetic), the scalar code skips them
+	def __init__(self, e, ps, vec, nrow):
+		self.e = e
+		self.ps = ps
+		self.vec = vec
+		self.nrow = nrow
+
+	def lane(self, v, l):
+		return '{}[{}]'.format(v, l) if self.vec else '{}_{}'.format(v, l)
+
+	def lanes(self, p):
+		return [l for l in range(self.ps) if p*self.ps+l < self.nrow]
+
+	def vld(self, X, p, j):
+		# vector load of the panel column, with the padding lanes set to zero
+		lanes = self.lanes(p)
+		if len(lanes)==self.ps:
+			return 'blasfeo_fix_vld({})'.format(col(self.ps, X, p, j))
+		return '(blasfeo_fix_vd) {{{}}}'.format(', '.join(el(self.ps, X, p*self.ps+l, j) if l in lanes else '0.0' for l in range(self.ps)))
+
+	def decl(self, names, init=None, panels=None):
+		# init: None, '0' or a list of (X, p, j) panel columns to load; panels: the panel of each name (scalar code)
+		if self.vec:
+			if init is None:
+				items = names
+			elif init=='0':
+				items = ['{} = {{0}}'.format(v) for v in names]
+			else:
+				items = ['{} = {}'.format(v, self.vld(*x)) for v, x in zip(names, init)]
+			self.e('blasfeo_fix_vd {};'.format(', '.join(items)))
+		else:
+			for idx, v in enumerate(names):
+				p = init[idx][1] if init not in (None, '0') else panels[idx]
+				if init is None:
+					items = [self.lane(v, l) for l in self.lanes(p)]
+				elif init=='0':
+					items = ['{} = 0.0'.format(self.lane(v, l)) for l in self.lanes(p)]
+				else:
+					X, p, j = init[idx]
+					items = ['{} = {}'.format(self.lane(v, l), el(self.ps, X, p*self.ps+l, j)) for l in self.lanes(p)]
+				self.e('double {};'.format(', '.join(items)))
+
+	def load(self, v, X, p, j, scale=None):
+		# v = [scale *] panel column
+		if self.vec:
+			self.e('{} = {}{};'.format(v, scale+' * ' if scale else '', self.vld(X, p, j)))
+		else:
+			for l in self.lanes(p):
+				self.e('{} = {}{};'.format(self.lane(v, l), scale+' * ' if scale else '', el(self.ps, X, p*self.ps+l, j)))
+
+	def fma(self, c, a, s, p, op='+='):
+		# c += a * s (or -=), with s a scalar and c, a columns of panel p
+		if self.vec:
+			self.e('{} {} {} * {};'.format(c, op, a, s))
+		else:
+			for l in self.lanes(p):
+				self.e('{} {} {} * {};'.format(self.lane(c, l), op, self.lane(a, l), s))
+
+	def scale(self, c, s, p, ind=1):
+		if self.vec:
+			self.e('{} *= {};'.format(c, s), ind)
+		else:
+			for l in self.lanes(p):
+				self.e('{} *= {};'.format(self.lane(c, l), s), ind)
+
+	def axpby(self, c, X, p, j, ind):
+		# c = alpha * c + beta * panel column
+		if self.vec:
+			self.e('{0} = alpha * {0} + beta * {1};'.format(c, self.vld(X, p, j)), ind)
+		else:
+			for l in self.lanes(p):
+				self.e('{0} = alpha * {0} + beta * {1};'.format(self.lane(c, l), el(self.ps, X, p*self.ps+l, j)), ind)
+
+	def store(self, X, p, j, v, row_min):
+		# store the rows row_min <= i < nrow of the panel column
+		ps = self.ps
+		lanes = [l for l in self.lanes(p) if row_min <= p*ps+l]
+		if self.vec and len(lanes)==ps:
+			self.e('blasfeo_fix_vst({}, {});'.format(col(ps, X, p, j), v))
+		else:
+			for l in lanes:
+				self.e('{} = {};'.format(el(ps, X, p*ps+l, j), self.lane(v, l)))
+
+
+
+def gen_gemm(e, ps, vec, routine, dims):
+	# D = beta * C + alpha * A * op(B), register blocked on panels x columns, k fully unrolled
+	if routine=='dsyrk_ln':
+		m, k = dims
+		n = m
+	else:
+		m, n, k = dims
+	trans_b = routine!='dgemm_nn'
+	lower = routine=='dsyrk_ln'
+	rp, nc = BLOCKING[ps] if vec else (1, 2)
+	npm = (m+ps-1)//ps
+	P = Panel(e, ps, vec, m)
+	panel_pointers(e, ps, 'A', 'a', m)
+	panel_pointers(e, ps, 'B', 'b', n if trans_b else k)
+	panel_pointers(e, ps, 'C', 'c', m)
+	panel_pointers(e, ps, 'D', 'd', m)
+	e()
+	nb = 0
+	for p0 in range(0, npm, rp):
+		panels = list(range(p0, min(p0+rp, npm)))
+		for j0 in range(0, n, nc):
+			cols = list(range(j0, min(j0+nc, n)))
+			# pairs (panel, column) with some element to store
+			blk = [(p, j) for p in panels for j in cols if not lower or min((p+1)*ps, m)-1 >= j]
+			if not blk:
+				continue
+			bpanels = sorted(set(p for p, j in blk))
+			a = {p: 'a{}_{}'.format(nb, p-p0) for p in bpanels}
+			c = {(p, j): 'c{}_{}{}'.format(nb, p-p0, j-j0) for p, j in blk}
+			nb += 1
+			e('// rows {}-{}, columns {}-{}'.format(bpanels[0]*ps, min((bpanels[-1]+1)*ps, m)-1, cols[0], cols[-1]))
+			P.decl([a[p] for p in bpanels], panels=bpanels)
+			P.decl([c[pj] for pj in blk], '0', [p for p, j in blk])
+			for kk in range(k):
+				for p in bpanels:
+					P.load(a[p], 'A', p, kk)
+				for j in cols:
+					b = el(ps, 'B', j, kk) if trans_b else el(ps, 'B', kk, j)
+					for p in bpanels:
+						if (p, j) in blk:
+							P.fma(c[p, j], a[p], b, p)
+			e('if(beta!=0.0)')
+			e('{', 2)
+			for p, j in blk:
+				P.axpby(c[p, j], 'C', p, j, 2)
+			e('}', 2)
+			e('else')
+			e('{', 2)
+			for p, j in blk:
+				P.scale(c[p, j], 'alpha', p, 2)
+			e('}', 2)
+			for p, j in blk:
+				P.store('D', p, j, c[p, j], j if lower else 0)
+			e()
+
+
+
+def gen_trsm(e, ps, vec, dims):
+	# D = alpha * B * A^{-T}, A lower: one panel of rows at a time, solving column by column
+	m, n = dims
+	npm = (m+ps-1)//ps
+	P = Panel(e, ps, vec, m)
+	panel_pointers(e, ps, 'A', 'a', n)
+	panel_pointers(e, ps, 'B', 'b', m)
+	panel_pointers(e, ps, 'D', 'd', m)
+	e()
+	e('double {};'.format(', '.join('inv{}'.format(j) for j in range(n))))
+	for j in range(n):
+		e('inv{} = 1.0 / {};'.format(j, el(ps, 'A', j, j)))
+	e()
+	e('sD->use_dA = 0;')
+	e()
+	for p in range(npm):
+		x = ['x{}_{}'.format(p, j) for j in range(n)]
+		e('// rows {}-{}'.format(p*ps, min((p+1)*ps, m)-1))
+		P.decl(x, panels=[p]*n)
+		for j in range(n):
+			P.load(x[j], 'B', p, j, 'alpha')
+			for l in range(j):
+				P.fma(x[j], x[l], el(ps, 'A', j, l), p, '-=')
+			P.scale(x[j], 'inv{}'.format(j), p)
+			P.store('D', p, j, x[j], 0)
+		e()
+
+
+
+def gen_potrf(e, ps, vec, dims):
+	# lower cholesky factorization, right-looking on the columns, with the panels of all columns in registers;
+	# non-positive pivots give a zero column, as in the generic routine
+	m, = dims
+	npm = (m+ps-1)//ps
+	P = Panel(e, ps, vec, m)
+	panel_pointers(e, ps, 'C', 'c', m)
+	panel_pointers(e, ps, 'D', 'd', m)
+	e()
+	v = {(j, p): 'v{}_{}'.format(j, p) for j in range(m) for p in range(j//ps, npm)}
+	for j in range(m):
+		P.decl([v[j, p] for p in range(j//ps, npm)], [('C', p, j) for p in range(j//ps, npm)])
+	e('double {};'.format(', '.join('inv{}'.format(j) for j in range(m))))
+	e('double tmp;')
+	e()
+	for j in range(m):
+		pj = j//ps
+		e('// column {}'.format(j))
+		e('tmp = {};'.format(P.lane(v[j, pj], j%ps)))
+		e('tmp = tmp>0.0 ? sqrt(tmp) : 0.0;')
+		e('inv{} = tmp>0.0 ? 1.0 / tmp : 0.0;'.format(j))
+		for p in range(pj, npm):
+			P.scale(v[j, p], 'inv{}'.format(j), p)
+		e('{} = tmp;'.format(el(ps, 'D', j, j)))
+		for p in range(pj, npm):
+			P.store('D', p, j, v[j, p], j+1)
+		for i in range(j+1, m):
+			e('tmp = {};'.format(P.lane(v[j, i//ps], i%ps)))
+			for p in range(i//ps, npm):
+				P.fma(v[i, p], v[j, p], 'tmp', p, '-=')
+		e()
+	e('if(di==0 && dj==0)')
+	e('{', 2)
+	for j in range(m):
+		e('sD->dA[{0}] = inv{0};'.format(j), 2)
+	e('sD->use_dA = {};'.format(m), 2)
+	e('}', 2)
+	e('else')
+	e('{', 2)
+	e('sD->use_dA = 0;', 2)
+	e('}', 2)
+
+
+
+def gen_trsv(e, ps, routine, dims):
+	# z = A^{-1} x (lnn) or z = A^{-T} x (ltn), A lower, on scalars
+	m, = dims
+	panel_pointers(e, ps, 'A', 'a', m)
+	e('double *x = sx->pa + xi;')
+	e('double *z = sz->pa + zi;')
+	e()
+	e('double {};'.format(', '.join('z{0} = x[{0}]'.format(j) for j in range(m))))
+	e()
+	order = range(m) if routine=='dtrsv_lnn' else range(m-1, -1, -1)
+	for j in order:
+		if routine=='dtrsv_lnn':
+			for l in range(j):
+				e('z{} -= {} * z{};'.format(j, el(ps, 'A', j, l), l))
+		else:
+			for l in range(j+1, m):
+				e('z{} -= {} * z{};'.format(j, el(ps, 'A', l, j), l))
+		e('z{0} *= 1.0 / {1};'.format(j, el(ps, 'A', j, j)))
+	e()
+	for j in range(m):
+		e('z[{0}] = z{0};'.format(j))
+
+
+
+def gen_body(e, ps, vec, routine, dims):
+	if routine in ('dgemm_nn', 'dgemm_nt', 'dsyrk_ln'):
+		gen_gemm(e, ps, vec, routine, dims)
+	elif routine=='dtrsm_rltn':
+		gen_trsm(e, ps, vec, dims)
+	elif routine=='dpotrf_l':
+		gen_potrf(e, ps, vec, dims)
+	else:
+		gen_trsv(e, ps, routine, dims)
+
+
+
+def row_offsets(routine):
+	if routine in ('dgemm_nn', 'dgemm_nt', 'dsyrk_ln'):
+		return ['ai', 'bi', 'ci', 'di']
+	if routine=='dtrsm_rltn':
+		return ['ai', 'bi', 'di']
+	if routine=='dpotrf_l':
+		return ['ci', 'di']
+	return ['ai']
+
+
+
+def gen_header(spec_name, entries):
+	e = Emitter()
+	e(HEADER.format(spec=spec_name).rstrip(), 0)
+	e(ind=0)
+	e('#ifndef BLASFEO_FIXED_H_', 0)
+	e('#define BLASFEO_FIXED_H_', 0)
+	e(ind=0)
+	e('#include <blasfeo_common.h>', 0)
+	e(ind=0)
+	e('#ifdef __cplusplus', 0)
+	e('extern "C" {', 0)
+	e('#endif', 0)
+	e(ind=0)
+	e(ind=0)
+	e(ind=0)
+	for routine, dims in entries:
+		e('{};'.format(signature(routine, dims)), 0)
+	e(ind=0)
+	e(ind=0)
+	e(ind=0)
+	e('#ifdef __cplusplus', 0)
+	e('}', 0)
+	e('#endif', 0)
+	e(ind=0)
+	e('#endif  // BLASFEO_FIXED_H_', 0)
+	return e.text()
+
+
+
+def gen_source(spec_name, entries):
+	e = Emitter()
+	e(HEADER.format(spec=spec_name).rstrip(), 0)
+	e(ind=0)
+	e('#include <math.h>', 0)
+	e(ind=0)
+	e('#include <blasfeo_target.h>', 0)
+	e('#include <blasfeo_block_size.h>', 0)
+	e('#include <blasfeo_common.h>', 0)
+	e('#include <blasfeo_d_blasfeo_api.h>', 0)
+	e('#include "blasfeo_fixed.h"', 0)
+	e(ind=0)
+	e(ind=0)
+	e(ind=0)
+	e('#if !defined(MF_PANELMAJ)', 0)
+	e('#error the fixed-size routines work on panel-major matrices', 0)
+	e('#endif', 0)
+	e('#if D_PS!=4 & D_PS!=8', 0)
+	e('#error panel size not supported by the fixed-size routines', 0)
+	e('#endif', 0)
+	e(ind=0)
+	e(ind=0)
+	e(ind=0)
+	e('// panel columns go in vector registers only where a register holds a whole one', 0)
+	e('#if (D_PS==4 & defined(__AVX__)) | (D_PS==8 & defined(__AVX512F__))', 0)
+	e('#define BLASFEO_FIX_VEC', 0)
+	e(ind=0)
+	e('typedef double blasfeo_fix_vd __attribute__ ((vector_size (D_PS*sizeof(double))));', 0)
+	e(ind=0)
+	e('static inline blasfeo_fix_vd blasfeo_fix_vld(const double *ptr)', 0)
+	e('{')
+	e('blasfeo_fix_vd v;')
+	e('__builtin_memcpy(&v, ptr, sizeof(v));')
+	e('return v;')
+	e('}')
+	e(ind=0)
+	e('static inline void blasfeo_fix_vst(double *ptr, blasfeo_fix_vd v)', 0)
+	e('{')
+	e('__builtin_memcpy(ptr, &v, sizeof(v));')
+	e('}')
+	e('#endif', 0)
+	for routine, dims in entries:
+		e(ind=0)
+		e(ind=0)
+		e(ind=0)
+		e(signature(routine, dims), 0)
+		e('{')
+		e(ind=0)
+		if not unrolled(routine, dims):
+			e(generic_call(routine, dims))
+			e(ind=0)
+			e('return;')
+			e(ind=0)
+			e('}')
+			continue
+		e('if(({}) != 0)'.format(' | '.join('{}%D_PS'.format(o) for o in row_offsets(routine))))
+		e('{', 2)
+		e(generic_call(routine, dims), 2)
+		e('return;', 2)
+		e('}', 2)
+		e(ind=0)
+		for idx, ps in enumerate(PANEL_SIZES):
+			e('#{} D_PS=={}'.format('if' if idx==0 else 'elif', ps), 0)
+			if routine in ('dtrsv_lnn', 'dtrsv_ltn'):
+				gen_body(e, ps, False, routine, dims)
+			else:
+				e('#if defined(BLASFEO_FIX_VEC)', 0)
+				gen_body(e, ps, True, routine, dims)
+				e('#else', 0)
+				gen_body(e, ps, False, routine, dims)
+				e('#endif', 0)
+		e('#endif', 0)
+		e(ind=0)
+		e('return;')
+		e(ind=0)
+		e('}')
+	return e.text()
+
+
+
+def gen_benchmark(spec_name, entries):
+	e = Emitter()
+	e(HEADER.format(spec=spec_name).rstrip(), 0)
+	e(ind=0)
+	e('#include <stdlib.h>', 0)
+	e('#include <stdio.h>', 0)
+	e('#include <math.h>', 0)
+	e('#include <string.h>', 0)
+	e(ind=0)
+	e('#include <blasfeo.h>', 0)
+	e('#include "blasfeo_fixed.h"', 0)
+	e(ind=0)
+	e(ind=0)
+	e(ind=0)
+	e('// generated fixed-size routines against the generic ones: time per call and max difference of the results', 0)
+	e(ind=0)
+	e('static void fill(struct blasfeo_dmat *sA, int m, int n, double diag)', 0)
+	e('{')
+	e('int ii, jj;')
+	e('for(jj=0; jj<n; jj++)')
+	e('for(ii=0; ii<m; ii++)', 2)
+	e('BLASFEO_DMATEL(sA, ii, jj) = (ii==jj ? diag : 0.0) + (double) rand() / RAND_MAX - 0.5;', 3)
+	e('}')
+	e(ind=0)
+	e('static double max_diff(struct blasfeo_dmat *sA, struct blasfeo_dmat *sB, int m, int n)', 0)
+	e('{')
+	e('int ii, jj;')
+	e('double tmp, diff = 0.0;')
+	e('for(jj=0; jj<n; jj++)')
+	e('for(ii=0; ii<m; ii++)', 2)
+	e('{', 3)
+	e('tmp = fabs(BLASFEO_DMATEL(sA, ii, jj) - BLASFEO_DMATEL(sB, ii, jj));', 3)
+	e('diff = tmp>diff ? tmp : diff;', 3)
+	e('}', 3)
+	e('return diff;')
+	e('}')
+	e(ind=0)
+	for routine, dims in entries:
+		m = dims[0]
+		n = dims[1] if routine in ('dgemm_nn', 'dgemm_nt', 'dtrsm_rltn') else m
+		k = dims[2] if routine in ('dgemm_nn', 'dgemm_nt') else dims[1] if routine=='dsyrk_ln' else n
+		if routine=='dgemm_nn':
+			sa, sb = (m, k), (k, n)
+		elif routine in ('dgemm_nt', 'dsyrk_ln'):
+			sa, sb = (m, k), (n, k)
+		elif routine=='dtrsm_rltn':
+			sa, sb = (n, n), (m, n)
+		else:
+			sa, sb = (m, m), (1, 1)
+		diag = float(max(sa)) if routine in ('dtrsm_rltn', 'dpotrf_l', 'dtrsv_lnn', 'dtrsv_ltn') else 0.0
+		name = fun_name(routine, dims)
+		gen = generic_call(routine, dims)
+		fix = '{}({});'.format(name, gen[gen.index('(')+1:gen.rindex(')')].split(', ', len(dims))[-1])
+		gen = gen.replace('sD', 'sD0').replace('sz', 'sz0')
+		fix = fix.replace('sD', 'sD1').replace('sz', 'sz1')
+		if routine=='dpotrf_l':
+			gen = gen.replace('sC', 'sA')
+			fix = fix.replace('sC', 'sA')
+		e(ind=0)
+		e('static void benchmark_{}()'.format(name), 0)
+		e('{')
+		e(ind=0)
+		e('int ii, nrep;')
+		e('double time_gen, time_fix, diff;')
+		e('blasfeo_timer timer;')
+		e('struct blasfeo_dmat sA, sB, sC, sD0, sD1;')
+		e('struct blasfeo_dvec sx, sz0, sz1;')
+		e(ind=0)
+		e('blasfeo_allocate_dmat({}, {}, &sA);'.format(*sa), 1)
+		e('blasfeo_allocate_dmat({}, {}, &sB);'.format(*sb), 1)
+		e('blasfeo_allocate_dmat({}, {}, &sC);'.format(m, n), 1)
+		e('blasfeo_allocate_dmat({}, {}, &sD0);'.format(m, n), 1)
+		e('blasfeo_allocate_dmat({}, {}, &sD1);'.format(m, n), 1)
+		e('blasfeo_allocate_dvec({}, &sx);'.format(m), 1)
+		e('blasfeo_allocate_dvec({}, &sz0);'.format(m), 1)
+		e('blasfeo_allocate_dvec({}, &sz1);'.format(m), 1)
+		# zero padding, not to time denormals in the generic routine
+		for s in ('sA', 'sB', 'sC', 'sD0', 'sD1', 'sx', 'sz0', 'sz1'):
+			e('memset({0}.mem, 0, {0}.memsize);'.format(s), 1)
+		e('fill(&sA, {}, {}, {});'.format(sa[0], sa[1], diag), 1)
+		e('fill(&sB, {}, {}, 0.0);'.format(*sb), 1)
+		e('fill(&sC, {}, {}, 0.0);'.format(m, n), 1)
+		e('blasfeo_dgese({0}, {1}, 0.0, &sD0, 0, 0);'.format(m, n), 1)
+		e('blasfeo_dgese({0}, {1}, 0.0, &sD1, 0, 0);'.format(m, n), 1)
+		e('for(ii=0; ii<{}; ii++)'.format(m), 1)
+		e('BLASFEO_DVECEL(&sx, ii) = (double) rand() / RAND_MAX - 0.5;', 2)
+		if 'alpha' in gen:
+			e('double alpha = 1.5;', 1)
+		if 'beta' in gen:
+			e('double beta = 0.5;', 1)
+		e('int {};'.format(', '.join('{}=0'.format(o) for o in ['ai', 'aj', 'bi', 'bj', 'ci', 'cj', 'di', 'dj', 'xi', 'zi'] if ' '+o+',' in gen or ' '+o+')' in gen)), 1)
+		if routine.startswith('dtrsv'):
+			e('struct blasfeo_dvec *psx = &sx;', 1)
+		e(ind=0)
+		call_gen = gen.replace('sA', '&sA').replace('sB', '&sB').replace('sC', '&sC').replace('sD0', '&sD0').replace('sx', 'psx').replace('sz0', '&sz0')
+		call_fix = fix.replace('sA', '&sA').replace('sB', '&sB').replace('sC', '&sC').replace('sD1', '&sD1').replace('sx', 'psx').replace('sz1', '&sz1')
+		e(call_gen, 1)
+		e(call_fix, 1)
+		if routine.startswith('dtrsv'):
+			e('diff = 0.0;', 1)
+			e('for(ii=0; ii<{}; ii++)'.format(m), 1)
+			e('diff = fabs(BLASFEO_DVECEL(&sz0, ii) - BLASFEO_DVECEL(&sz1, ii))>diff ? fabs(BLASFEO_DVECEL(&sz0, ii) - BLASFEO_DVECEL(&sz1, ii)) : diff;', 2)
+		elif routine in ('dsyrk_ln', 'dpotrf_l'):
+			e('blasfeo_dtrtr_l({0}, &sD0, 0, 0, &sD0, 0, 0);'.format(m), 1)
+			e('blasfeo_dtrtr_l({0}, &sD1, 0, 0, &sD1, 0, 0);'.format(m), 1)
+			e('diff = max_diff(&sD0, &sD1, {}, {});'.format(m, n), 1)
+		else:
+			e('diff = max_diff(&sD0, &sD1, {}, {});'.format(m, n), 1)
+		e(ind=0)
+		e('nrep = {};'.format(max(1000, int(1e8/flops(routine, dims)))), 1)
+		e('blasfeo_tic(&timer);', 1)
+		e('for(ii=0; ii<nrep; ii++)', 1)
+		e(call_gen, 2)
+		e('time_gen = blasfeo_toc(&timer) / nrep;', 1)
+		e('blasfeo_tic(&timer);', 1)
+		e('for(ii=0; ii<nrep; ii++)', 1)
+		e(call_fix, 2)
+		e('time_fix = blasfeo_toc(&timer) / nrep;', 1)
+		e(ind=0)
+		e('printf("{}\\t%f\\t%f\\t%f\\t%e\\n", 1e9*time_gen, 1e9*time_fix, time_gen/time_fix, diff);'.format('{:<24}'.format('{}_{}'.format(routine, 'x'.join(str(d) for d in dims)))), 1)
+		e(ind=0)
+		for s in ('sA', 'sB', 'sC', 'sD0', 'sD1'):
+			e('blasfeo_free_dmat(&{});'.format(s), 1)
+		for s in ('sx', 'sz0', 'sz1'):
+			e('blasfeo_free_dvec(&{});'.format(s), 1)
+		e(ind=0)
+		e('return;')
+		e(ind=0)
+		e('}')
+	e(ind=0)
+	e(ind=0)
+	e('int main()', 0)
+	e('{')
+	e(ind=0)
+	e('printf("\\nbenchmark generated fixed-size routines\\n\\n");')
+	e('printf("routine\\t\\t\\tgeneric [ns]\\tfixed [ns]\\tspeedup\\tmax diff\\n");')
+	for routine, dims in entries:
+		e('benchmark_{}();'.format(fun_name(routine, dims)))
+	e('printf("\\n");')
+	e(ind=0)
+	e('return 0;')
+	e(ind=0)
+	e('}')
+	return e.text()
+
+
+
+def main():
+	args = parse_arguments()
+	entries = read_spec(args.spec)
+	spec_name = Path(args.spec).name
+	out = Path(args.output_dir)
+	out.mkdir(parents=True, exist_ok=True)
+	for name, text in [('blasfeo_fixed.h', gen_header(spec_name, entries)), ('blasfeo_fixed.c', gen_source(spec_name, entries)), ('blasfeo_fixed_benchmark.c', gen_benchmark(spec_name, entries))]:
+		path = out / name
+		# rewrite only on change, not to trigger rebuilds
+		if not path.exists() or path.read_text()!=text:
+			path.write_text(text)
+
+
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,277 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+/*
+ * Runtime selection of the target in the fat library built by `make static_library_dispatch`.
+ *
+ * The library contains a full BLASFEO build for each target in DISPATCH_TARGETS, with all the
+ * global symbols prefixed by the target name (e.g. X64_INTEL_HASWELL_blasfeo_blas_dgemm).
+ * The BLAS and LAPACK API routines, the memory (and thread) management routines and the dgemm
+ * decision table routines are exported under their usual names, and forward to the target selected
+ * at the first call through a table of function pointers (one indirect call per routine call).
+ *
+ * The panel-major blasfeo_dmat API is not exported, since its memory layout depends on the target.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <blasfeo_target.h>
+#include <blasfeo_d_blas_api.h>
+#include <blasfeo_s_blas_api.h>
+#include <blasfeo_memory.h>
+#include <blasfeo_dgemm_tune.h>
+#include <blasfeo_processor_features.h>
+#include <blasfeo_dispatch.h>
+#if defined(MULTI_THREAD)
+#include <blasfeo_thread.h>
+#endif
+
+
+
+#if defined(FORTRAN_BLAS_API)
+#define BLAS(fun) fun##_
+#define LAPACK(fun) fun##_
+#else
+#define BLAS(fun) blasfeo_blas_##fun
+#define LAPACK(fun) blasfeo_lapack_##fun
+#endif
+
+#define CAT_(a, b) a##b
+#define CAT(a, b) CAT_(a, b)
+// name of the routine in the kernel set of target T
+#define TARGET_NAME(T, fun) CAT(T, CAT(_, fun))
+
+
+
+// exported routines: X(T, return type, return keyword, name, parameters, arguments)
+#define BLASFEO_DISPATCH_ROUTINES_BLAS(X, T) \
+	X(T, void, , BLAS(daxpy), (int *n, double *alpha, double *x, int *incx, double *y, int *incy), (n, alpha, x, incx, y, incy)) \
+	X(T, double, return, BLAS(ddot), (int *n, double *x, int *incx, double *y, int *incy), (n, x, incx, y, incy)) \
+	X(T, void, , BLAS(dcopy), (int *n, double *x, int *incx, double *y, int *incy), (n, x, incx, y, incy)) \
+	X(T, void, , BLAS(dgemv), (char *trans, int *m, int *n, double *alpha, double *A, int *lda, double *x, int *incx, double *beta, double *y, int *incy), (trans, m, n, alpha, A, lda, x, incx, beta, y, incy)) \
+	X(T, void, , BLAS(dsymv), (char *uplo, int *n, double *alpha, double *A, int *lda, double *x, int *incx, double *beta, double *y, int *incy), (uplo, n, alpha, A, lda, x, incx, beta, y, incy)) \
+	X(T, void, , BLAS(dger), (int *m, int *n, double *alpha, double *x, int *incx, double *y, int *incy, double *A, int *lda), (m, n, alpha, x, incx, y, incy, A, lda)) \
+	X(T, void, , BLAS(dgemm), (char *ta, char *tb, int *m, int *n, int *k, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc), (ta, tb, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc)) \
+	X(T, void, , BLAS(dsyrk), (char *uplo, char *ta, int *m, int *k, double *alpha, double *A, int *lda, double *beta, double *C, int *ldc), (uplo, ta, m, k, alpha, A, lda, beta, C, ldc)) \
+	X(T, void, , BLAS(dtrmm), (char *side, char *uplo, char *transa, char *diag, int *m, int *n, double *alpha, double *A, int *lda, double *B, int *ldb), (side, uplo, transa, diag, m, n, alpha, A, lda, B, ldb)) \
+	X(T, void, , BLAS(dtrsm), (char *side, char *uplo, char *transa, char *diag, int *m, int *n, double *alpha, double *A, int *lda, double *B, int *ldb), (side, uplo, transa, diag, m, n, alpha, A, lda, B, ldb)) \
+	X(T, void, , BLAS(dsyr2k), (char *uplo, char *ta, int *m, int *k, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc), (uplo, ta, m, k, alpha, A, lda, B, ldb, beta, C, ldc)) \
+	X(T, void, , LAPACK(dgesv), (int *m, int *n, double *A, int *lda, int *ipiv, double *B, int *ldb, int *info), (m, n, A, lda, ipiv, B, ldb, info)) \
+	X(T, void, , LAPACK(dgetrf), (int *m, int *n, double *A, int *lda, int *ipiv, int *info), (m, n, A, lda, ipiv, info)) \
+	X(T, void, , LAPACK(dgetrs), (char *trans, int *m, int *n, double *A, int *lda, int *ipiv, double *B, int *ldb, int *info), (trans, m, n, A, lda, ipiv, B, ldb, info)) \
+	X(T, void, , LAPACK(dlaswp), (int *n, double *A, int *lda, int *k1, int *k2, int *ipiv, int *incx), (n, A, lda, k1, k2, ipiv, incx)) \
+	X(T, void, , LAPACK(dposv), (char *uplo, int *m, int *n, double *A, int *lda, double *B, int *ldb, int *info), (uplo, m, n, A, lda, B, ldb, info)) \
+	X(T, void, , LAPACK(dpotrf), (char *uplo, int *m, double *A, int *lda, int *info), (uplo, m, A, lda, info)) \
+	X(T, void, , LAPACK(dpotrs), (char *uplo, int *m, int *n, double *A, int *lda, double *B, int *ldb, int *info), (uplo, m, n, A, lda, B, ldb, info)) \
+	X(T, void, , LAPACK(dtrtrs), (char *uplo, char *trans, char *diag, int *m, int *n, double *A, int *lda, double *B, int *ldb, int *info), (uplo, trans, diag, m, n, A, lda, B, ldb, info)) \
+	X(T, void, , BLAS(dgetr), (int *m, int *n, double *A, int *lda, double *B, int *ldb), (m, n, A, lda, B, ldb)) \
+	X(T, void, , BLAS(saxpy), (int *n, float *alpha, float *x, int *incx, float *y, int *incy), (n, alpha, x, incx, y, incy)) \
+	X(T, float, return, BLAS(sdot), (int *n, float *x, int *incx, float *y, int *incy), (n, x, incx, y, incy)) \
+	X(T, void, , BLAS(sgemm), (char *ta, char *tb, int *m, int *n, int *k, float *alpha, float *A, int *lda, float *B, int *ldb, float *beta, float *C, int *ldc), (ta, tb, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc)) \
+	X(T, void, , BLAS(strsm), (char *side, char *uplo, char *transa, char *diag, int *m, int *n, float *alpha, float *A, int *lda, float *B, int *ldb), (side, uplo, transa, diag, m, n, alpha, A, lda, B, ldb)) \
+	X(T, void, , LAPACK(spotrf), (char *uplo, int *m, float *A, int *lda, int *info), (uplo, m, A, lda, info))
+
+#define BLASFEO_DISPATCH_ROUTINES_MEMORY(X, T) \
+	X(T, int, return, blasfeo_is_init, (), ()) \
+	X(T, void, , blasfeo_init, (), ()) \
+	X(T, void, , blasfeo_init_buffer, (void *buffer), (buffer)) \
+	X(T, void, , blasfeo_quit, (), ()) \
+	X(T, void *, return, blasfeo_get_buffer, (), ()) \
+	X(T, size_t, return, blasfeo_memsize_buffer, (), ()) \
+	X(T, int, return, blasfeo_is_init_block_size, (struct blasfeo_block_size *bs), (bs)) \
+	X(T, size_t, return, blasfeo_memsize_buffer_block_size, (struct blasfeo_block_size *bs), (bs)) \
+	X(T, void, , blasfeo_get_block_size, (struct blasfeo_block_size *bs), (bs)) \
+	X(T, void, , blasfeo_set_block_size, (struct blasfeo_block_size *bs), (bs)) \
+	X(T, int, return, blasfeo_get_d_kc, (), ()) \
+	X(T, int, return, blasfeo_get_d_nc, (), ()) \
+	X(T, int, return, blasfeo_get_d_mc, (), ())
+
+#if defined(EXT_DEP)
+#define BLASFEO_DISPATCH_ROUTINES_TUNE_EXT_DEP(X, T) \
+	X(T, int, return, blasfeo_dgemm_tune_load, (char *file_name), (file_name)) \
+	X(T, int, return, blasfeo_dgemm_tune_save, (char *file_name), (file_name))
+#else
+#define BLASFEO_DISPATCH_ROUTINES_TUNE_EXT_DEP(X, T)
+#endif
+
+#define BLASFEO_DISPATCH_ROUTINES_TUNE(X, T) \
+	X(T, int, return, blasfeo_dgemm_tune_bin, (int size), (size)) \
+	X(T, int, return, blasfeo_dgemm_tune_bin_size, (int bin), (bin)) \
+	X(T, int, return, blasfeo_dgemm_tune_get, (int variant, int bm, int bn, int bk), (variant, bm, bn, bk)) \
+	X(T, void, , blasfeo_dgemm_tune_set, (int variant, int bm, int bn, int bk, int alg), (variant, bm, bn, bk, alg)) \
+	X(T, void, , blasfeo_dgemm_tune_clear, (), ()) \
+	X(T, int, return, blasfeo_dgemm_tune_alg, (int variant, int m, int n, int k), (variant, m, n, k)) \
+	BLASFEO_DISPATCH_ROUTINES_TUNE_EXT_DEP(X, T)
+
+#if defined(MULTI_THREAD)
+#define BLASFEO_DISPATCH_ROUTINES_THREAD(X, T) \
+	X(T, void, , blasfeo_set_num_threads, (int num_threads), (num_threads)) \
+	X(T, int, return, blasfeo_get_num_threads, (), ()) \
+	X(T, void, , blasfeo_set_thread_threshold, (double flops), (flops)) \
+	X(T, int, return, blasfeo_get_num_threads_flops, (double flops), (flops)) \
+	X(T, void, , blasfeo_set_thread_spin, (int spin), (spin)) \
+	X(T, void, , blasfeo_set_thread_exclusive, (int exclusive), (exclusive)) \
+	X(T, int, return, blasfeo_set_thread_affinity, (int ncpu, int *cpu), (ncpu, cpu))
+#else
+#define BLASFEO_DISPATCH_ROUTINES_THREAD(X, T)
+#endif
+
+#define BLASFEO_DISPATCH_ROUTINES(X, T) \
+	BLASFEO_DISPATCH_ROUTINES_BLAS(X, T) \
+	BLASFEO_DISPATCH_ROUTINES_MEMORY(X, T) \
+	BLASFEO_DISPATCH_ROUTINES_TUNE(X, T) \
+	BLASFEO_DISPATCH_ROUTINES_THREAD(X, T)
+
+
+
+// table of the routines of one target
+#define X_FIELD(T, ret, RET, fun, params, args) ret (*fun) params;
+struct blasfeo_dispatch_table
+	{
+	const char *name;
+	int features; // processor features needed by the target
+	BLASFEO_DISPATCH_ROUTINES(X_FIELD, )
+	};
+
+#define X_DECLARE(T, ret, RET, fun, params, args) ret TARGET_NAME(T, fun) params;
+#define X_ENTRY(T, ret, RET, fun, params, args) TARGET_NAME(T, fun),
+#define BLASFEO_DISPATCH_TABLE(T, feat) \
+	BLASFEO_DISPATCH_ROUTINES(X_DECLARE, T) \
+	static const struct blasfeo_dispatch_table table_##T = { #T, feat, BLASFEO_DISPATCH_ROUTINES(X_ENTRY, T) };
+
+#if defined(DISPATCH_X64_INTEL_SKYLAKE_X)
+BLASFEO_DISPATCH_TABLE(X64_INTEL_SKYLAKE_X, BLASFEO_PROCESSOR_FEATURE_AVX512F | BLASFEO_PROCESSOR_FEATURE_AVX2 | BLASFEO_PROCESSOR_FEATURE_FMA | BLASFEO_PROCESSOR_FEATURE_AVX)
+#endif
+#if defined(DISPATCH_X64_INTEL_HASWELL)
+BLASFEO_DISPATCH_TABLE(X64_INTEL_HASWELL, BLASFEO_PROCESSOR_FEATURE_AVX2 | BLASFEO_PROCESSOR_FEATURE_FMA | BLASFEO_PROCESSOR_FEATURE_AVX)
+#endif
+#if defined(DISPATCH_X64_INTEL_SANDY_BRIDGE)
+BLASFEO_DISPATCH_TABLE(X64_INTEL_SANDY_BRIDGE, BLASFEO_PROCESSOR_FEATURE_AVX)
+#endif
+BLASFEO_DISPATCH_TABLE(GENERIC, 0)
+
+// candidate targets, from the most to the least specialized
+static const struct blasfeo_dispatch_table *blasfeo_dispatch_tables[] =
+	{
+#if defined(DISPATCH_X64_INTEL_SKYLAKE_X)
+	&table_X64_INTEL_SKYLAKE_X,
+#endif
+#if defined(DISPATCH_X64_INTEL_HASWELL)
+	&table_X64_INTEL_HASWELL,
+#endif
+#if defined(DISPATCH_X64_INTEL_SANDY_BRIDGE)
+	&table_X64_INTEL_SANDY_BRIDGE,
+#endif
+	&table_GENERIC,
+	};
+
+
+
+// the table initially points to resolvers, that select the target and forward the call
+#define RESOLVER_NAME(fun) CAT(blasfeo_dispatch_resolve_, fun)
+#define X_RESOLVER(T, ret, RET, fun, params, args) static ret RESOLVER_NAME(fun) params { blasfeo_dispatch_select(); RET blasfeo_dispatch_current->fun args; }
+#define X_RESOLVER_ENTRY(T, ret, RET, fun, params, args) RESOLVER_NAME(fun),
+
+static void blasfeo_dispatch_select();
+
+static const struct blasfeo_dispatch_table table_resolve;
+
+static const struct blasfeo_dispatch_table *volatile blasfeo_dispatch_current = &table_resolve;
+
+BLASFEO_DISPATCH_ROUTINES(X_RESOLVER, )
+
+static const struct blasfeo_dispatch_table table_resolve = { "none", 0, BLASFEO_DISPATCH_ROUTINES(X_RESOLVER_ENTRY, ) };
+
+
+
+static const struct blasfeo_dispatch_table *blasfeo_dispatch_find()
+	{
+	int ntab = sizeof(blasfeo_dispatch_tables)/sizeof(blasfeo_dispatch_tables[0]);
+	int ii;
+
+	int features = 0;
+	blasfeo_processor_cpu_features(&features);
+
+	// the target can be forced with the BLASFEO_DISPATCH_TARGET environment variable, if the CPU supports it
+	char *env = getenv("BLASFEO_DISPATCH_TARGET");
+	if(env!=NULL && env[0]!='\0')
+		{
+		for(ii=0; ii<ntab; ii++)
+			{
+			if(strcmp(env, blasfeo_dispatch_tables[ii]->name)==0)
+				break;
+			}
+		if(ii==ntab)
+			printf("\nblasfeo_dispatch: BLASFEO_DISPATCH_TARGET=%s is not in the library, ignored\n", env);
+		else if((features & blasfeo_dispatch_tables[ii]->features)!=blasfeo_dispatch_tables[ii]->features)
+			printf("\nblasfeo_dispatch: BLASFEO_DISPATCH_TARGET=%s is not supported by the CPU, ignored\n", env);
+		else
+			return blasfeo_dispatch_tables[ii];
+		}
+
+	for(ii=0; ii<ntab; ii++)
+		{
+		if((features & blasfeo_dispatch_tables[ii]->features)==blasfeo_dispatch_tables[ii]->features)
+			return blasfeo_dispatch_tables[ii];
+		}
+	return &table_GENERIC;
+	}
+
+
+
+// the selection is idempotent, so concurrent first calls at worst repeat it
+static void blasfeo_dispatch_select()
+	{
+	if(blasfeo_dispatch_current==&table_resolve)
+		blasfeo_dispatch_current = blasfeo_dispatch_find();
+	}
+
+
+
+const char *blasfeo_dispatch_target()
+	{
+	blasfeo_dispatch_select();
+	return blasfeo_dispatch_current->name;
+	}
+
+
+
+// exported routines, forwarding to the selected target
+#define X_EXPORT(T, ret, RET, fun, params, args) ret fun params { RET blasfeo_dispatch_current->fun args; }
+
+BLASFEO_DISPATCH_ROUTINES(X_EXPORT, )
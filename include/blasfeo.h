@@ -46,7 +46,10 @@
 #include "blasfeo_s_aux_ext_dep.h"
 #include "blasfeo_s_kernel.h"
 #include "blasfeo_s_blas.h"
+#include "blasfeo_m_blasfeo_api.h"
 #include "blasfeo_i_aux_ext_dep.h"
 #include "blasfeo_v_aux_ext_dep.h"
 #include "blasfeo_timing.h"
 #include "blasfeo_memory.h"
+#include "blasfeo_thread.h"
+#include "blasfeo_dgemm_tune.h"
@@ -57,6 +57,9 @@
 #define D_KC 128 //256 // 192
 #define D_NC 144 //72 //96 //72 // 120 // 512
 #define D_MC 2400 // 6000
+#define D_NC_CACHE_SIZE (1024*1024) // per-core L2 cache size D_NC is tuned for: 1 MB
+#define D_MC_CACHE_SIZE (1408*1024) // per-core LLC share D_MC is tuned for: 1.375 MB
+#define D_VL 4 // vector length of the compact batch layout
 // single
 #define S_PS 16 // panel size
 #define S_PLD 4 // GCD of panel length TODO probably 16 when writing assebly
@@ -80,6 +83,9 @@
 #define D_KC 256 // 192
 #define D_NC 64 //96 //72 // 120 // 512
 #define D_MC 1500
+#define D_NC_CACHE_SIZE (256*1024) // per-core L2 cache size D_NC is tuned for: 256 kB
+#define D_MC_CACHE_SIZE (1536*1024) // per-core LLC share D_MC is tuned for: 6 MB on 4 cores
+#define D_VL 4 // vector length of the compact batch layout
 // single
 #define S_PS 8 // panel size
 #define S_PLD 4 // 2 // GCD of panel length
@@ -103,6 +109,9 @@
 #define D_KC 256 //320 //256 //320
 #define D_NC 72 //64 //72 //60 // 120
 #define D_MC 1000 // 800
+#define D_NC_CACHE_SIZE (256*1024) // per-core L2 cache size D_NC is tuned for: 256 kB
+#define D_MC_CACHE_SIZE (2048*1024) // per-core LLC share D_MC is tuned for: 4 MB on 2 cores
+#define D_VL 4 // vector length of the compact batch layout
 // single
 #define S_PS 8 // panel size
 #define S_PLD 4 // 2 // GCD of panel length
@@ -124,6 +133,7 @@
 #define D_KC 256
 #define D_NC 128 // TODO these are just dummy
 #define D_MC 3000 // TODO these are just dummy
+#define D_VL 2 // vector length of the compact batch layout
 // single
 #define S_PS 4
 #define S_PLD 4 //2
@@ -145,6 +155,7 @@
 #define D_KC 256
 #define D_NC 128 // TODO these are just dummy
 #define D_MC 3000 // TODO these are just dummy
+#define D_VL 2 // vector length of the compact batch layout
 // single
 #define S_PS 4
 #define S_PLD 4 //2
@@ -167,6 +178,7 @@
 #define D_KC 256
 #define D_NC 128 // TODO these are just dummy
 #define D_MC 3000 // TODO these are just dummy
+#define D_VL 2 // vector length of the compact batch layout
 // single
 #define S_PS 4
 #define S_PLD 4 //2
@@ -189,6 +201,7 @@
 #define D_KC 256
 #define D_NC 128 // TODO these are just dummy
 #define D_MC 3000 // TODO these are just dummy
+#define D_VL 2 // vector length of the compact batch layout
 // single
 #define S_PS 4
 #define S_PLD 4 //2
@@ -212,6 +225,7 @@
 #define D_KC 512 //256
 #define D_NC 128 //256
 #define D_MC 6000
+#define D_VL 2 // vector length of the compact batch layout
 // single
 #define S_PS 4
 #define S_PLD 4 //2
@@ -235,6 +249,7 @@
 #define D_KC 512 //256
 #define D_NC 128 //256
 #define D_MC 6000
+#define D_VL 2 // vector length of the compact batch layout
 // single
 #define S_PS 4
 #define S_PLD 4 //2
@@ -258,6 +273,7 @@
 #define D_KC 320
 #define D_NC 256
 #define D_MC 6000
+#define D_VL 2 // vector length of the compact batch layout
 // single
 #define S_PS 4
 #define S_PLD 4 //2
@@ -281,6 +297,7 @@
 #define D_KC 128 //224 //256 //192
 #define D_NC 72 //40 //36 //48
 #define D_MC (4*192) //512 //488 //600
+#define D_VL 2 // vector length of the compact batch layout
 // single
 #define S_PS 4
 #define S_PLD 4 //2
@@ -304,6 +321,7 @@
 #define D_KC 224
 #define D_NC 160
 #define D_MC 6000
+#define D_VL 2 // vector length of the compact batch layout
 // single
 #define S_PS 4
 #define S_PLD 4 //2
@@ -327,6 +345,7 @@
 #define D_KC 160
 #define D_NC 128
 #define D_MC 6000
+#define D_VL 2 // vector length of the compact batch layout
 // single
 #define S_PS 4
 #define S_PLD 4 //2
@@ -349,6 +368,7 @@
 #define D_KC 256
 #define D_NC 128 // TODO these are just dummy
 #define D_MC 3000 // TODO these are just dummy
+#define D_VL 1 // vector length of the compact batch layout
 // single
 #define S_PS 4
 #define S_PLD 4 //2
@@ -371,6 +391,7 @@
 #define D_KC 256
 #define D_NC 128 // TODO these are just dummy
 #define D_MC 3000 // TODO these are just dummy
+#define D_VL 1 // vector length of the compact batch layout
 // single
 #define S_PS 4
 #define S_PLD 4 //2
@@ -393,6 +414,7 @@
 #define D_KC 256
 #define D_NC 128 // TODO these are just dummy
 #define D_MC 3000 // TODO these are just dummy
+#define D_VL 1 // vector length of the compact batch layout
 // single
 #define S_PS 4
 #define S_PLD 4 //2
@@ -415,6 +437,7 @@
 #define D_KC 256
 #define D_NC 128 // TODO these are just dummy
 #define D_MC 3000 // TODO these are just dummy
+#define D_VL 4 // vector length of the compact batch layout
 
 // single
 #define S_PS 4
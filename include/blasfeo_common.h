@@ -38,6 +38,8 @@
 
 
 
+#include <stddef.h>
+
 #include "blasfeo_target.h"
 
 
@@ -267,6 +269,85 @@ struct blasfeo_cm_svec
 
 
 
+// Compact batch matrix structure: nb matrices of size m*n, interleaved in groups of D_VL matrices,
+// such that element (i,j) of the matrices in a group is stored contiguously
+struct blasfeo_dmat_compact
+	{
+	double *mem; // pointer to passed chunk of memory
+	double *pA; // pointer to a ng*m*n*D_VL array of doubles, with ng=ceil(nb/D_VL) groups, the first is aligned to cache line size
+	int m; // rows
+	int n; // cols
+	int nb; // number of matrices in the batch
+	int ng; // number of groups of D_VL matrices
+	int memsize; // size of needed memory
+	};
+
+#define BLASFEO_DMATEL_COMPACT(sA,ib,ai,aj) ((sA)->pA[((ib)/D_VL)*(sA)->m*(sA)->n*D_VL+((ai)+(aj)*(sA)->m)*D_VL+(ib)%D_VL])
+
+
+
+// Half-precision matrix structure: IEEE fp16 elements, stored as raw 16-bit values, in panel-major
+// layout with panels of H_PS rows; routines convert them to single precision in registers
+#define H_PS 8 // panel size
+
+struct blasfeo_hmat
+	{
+	unsigned short *mem; // pointer to passed chunk of memory
+	unsigned short *pA; // pointer to a pm*cn array of fp16 values, the first is aligned to cache line size
+	int m; // rows
+	int n; // cols
+	int pm; // packed number or rows
+	int cn; // packed number or cols
+	int memsize; // size of needed memory
+	};
+
+#define BLASFEO_HMATEL(sA,ai,aj) ((sA)->pA[((ai)-((ai)&(H_PS-1)))*(sA)->cn+(aj)*H_PS+((ai)&(H_PS-1))])
+
+
+
+// Recorded operation graph: a sequence of routine calls recorded once and replayed many times; compiling it
+// resolves the dependencies between the calls, groups the independent ones in levels and assigns them to threads
+struct blasfeo_dgraph_node;
+
+struct blasfeo_dgraph
+	{
+	struct blasfeo_dgraph_node *node; // recorded calls
+	int *perm; // calls sorted by level
+	int *lev_ptr; // calls perm[lev_ptr[l]] to perm[lev_ptr[l+1]-1] form the level l
+	int *lev_nth; // number of threads of each level
+	size_t slotsize; // scratch memory of one thread
+	int max_node; // max number of recorded calls
+	int n_node; // number of recorded calls
+	int n_lev; // number of levels
+	int n_slot; // max number of threads of a level
+	int compiled; // flag to tell if the plan is up to date with the recorded calls
+	int memsize; // size of needed memory
+	};
+
+// Execution plan of a routine call of fixed size and offsets: the variant and the code path are resolved once
+// at plan creation, and the execution only extracts the matrix pointers and runs the selected code path
+struct blasfeo_dplan
+	{
+	int m; // sizes
+	int n;
+	int k;
+	int ai; // offsets
+	int aj;
+	int bi;
+	int bj;
+	int ci;
+	int cj;
+	int di;
+	int dj;
+	int var; // routine variant (side, uplo, transposition, diag)
+	int alg; // selected code path
+	};
+
+// JIT-compiled dgemm kernel of fixed sizes, scalars, transpositions and strides, owned by the kernel cache
+struct blasfeo_djit_dgemm;
+
+
+
 #ifdef __cplusplus
 }
 #endif
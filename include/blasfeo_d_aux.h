@@ -65,6 +65,8 @@ size_t blasfeo_memsize_dmat(int m, int n);
 size_t blasfeo_memsize_diag_dmat(int m, int n);
 // returns the memory size (in bytes) needed for a dvec
 size_t blasfeo_memsize_dvec(int m);
+// returns the memory size (in bytes) needed for a compact batch of nb matrices of size m*n
+size_t blasfeo_memsize_dmat_compact(int m, int n, int nb);
 
 // --- creation
 //
@@ -72,6 +74,9 @@ size_t blasfeo_memsize_dvec(int m);
 void blasfeo_create_dmat(int m, int n, struct blasfeo_dmat *sA, void *memory);
 // create a strvec for a vector of size m by using memory passed by a pointer (pointer is not updated)
 void blasfeo_create_dvec(int m, struct blasfeo_dvec *sA, void *memory);
+// create a compact batch of nb matrices of size m*n by using memory passed by a pointer (pointer is not updated),
+// aligned to D_VL doubles; the memory is not initialized
+void blasfeo_create_dmat_compact(int m, int n, int nb, struct blasfeo_dmat_compact *sA, void *memory);
 
 // --- packing
 // pack the column-major matrix A into the matrix struct B
@@ -80,16 +85,24 @@ void blasfeo_pack_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sB
 void blasfeo_pack_l_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sB, int bi, int bj);
 // pack the upper-triangular column-major matrix A into the matrix struct B
 void blasfeo_pack_u_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sB, int bi, int bj);
+// pack the column-major matrix A, scaled by alpha, into the matrix struct B
+void blasfeo_pack_sc_dmat(int m, int n, double alpha, double *A, int lda, struct blasfeo_dmat *sB, int bi, int bj);
 // transpose and pack the column-major matrix A into the matrix struct B
 void blasfeo_pack_tran_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sB, int bi, int bj);
+// transpose and pack the column-major matrix A, scaled by alpha, into the matrix struct B
+void blasfeo_pack_tran_sc_dmat(int m, int n, double alpha, double *A, int lda, struct blasfeo_dmat *sB, int bi, int bj);
 // pack the vector x into the vector structure y
 void blasfeo_pack_dvec(int m, double *x, int xi, struct blasfeo_dvec *sy, int yi);
+// pack the nb column-major matrices A[ib] into the compact batch B, zeroing the padding matrices of the last group
+void blasfeo_pack_dmat_compact(int m, int n, double **A, int lda, struct blasfeo_dmat_compact *sB, int bi, int bj);
 // unpack the matrix structure A into the column-major matrix B
 void blasfeo_unpack_dmat(int m, int n, struct blasfeo_dmat *sA, int ai, int aj, double *B, int ldb);
 // transpose and unpack the matrix structure A into the column-major matrix B
 void blasfeo_unpack_tran_dmat(int m, int n, struct blasfeo_dmat *sA, int ai, int aj, double *B, int ldb);
 // pack the vector structure x into the vector y
 void blasfeo_unpack_dvec(int m, struct blasfeo_dvec *sx, int xi, double *y,  int yi);
+// unpack the compact batch A into the nb column-major matrices B[ib]
+void blasfeo_unpack_dmat_compact(int m, int n, struct blasfeo_dmat_compact *sA, int ai, int aj, double **B, int ldb);
 
 // --- cast
 //
@@ -101,10 +101,20 @@ void d_print_exp_tran_mat(int row, int col, double *A, int lda);
 void blasfeo_allocate_dmat(int m, int n, struct blasfeo_dmat *sA);
 // create a strvec for a vector of size m by dynamically allocating memory
 void blasfeo_allocate_dvec(int m, struct blasfeo_dvec *sa);
+// create a strmat for a matrix of size m*n by dynamically allocating memory with a NUMA placement policy (BLASFEO_NUMA_*);
+// with BLASFEO_NUMA_PARTITION the panel rows (the columns if column-major) are split in one contiguous chunk per node
+// (the pack routines and the panel-major multi-threaded dgemm, dtrsm_r* and dgetrf_rp assign each chunk to the threads on its node)
+void blasfeo_allocate_dmat_numa(int m, int n, struct blasfeo_dmat *sA, int policy);
+// zero a strmat in parallel, each panel row (column if column-major) written by a thread on its owning node
+void blasfeo_first_touch_dmat(struct blasfeo_dmat *sA);
 // free the memory allocated by blasfeo_allocate_dmat
 void blasfeo_free_dmat(struct blasfeo_dmat *sA);
 // free the memory allocated by blasfeo_allocate_dvec
 void blasfeo_free_dvec(struct blasfeo_dvec *sa);
+// create a compact batch of nb matrices of size m*n by dynamically allocating memory
+void blasfeo_allocate_dmat_compact(int m, int n, int nb, struct blasfeo_dmat_compact *sA);
+// free the memory allocated by blasfeo_allocate_dmat_compact
+void blasfeo_free_dmat_compact(struct blasfeo_dmat_compact *sA);
 // print a strmat
 void blasfeo_print_dmat(int m, int n, struct blasfeo_dmat *sA, int ai, int aj);
 // print in exponential notation a strmat
@@ -74,8 +74,12 @@ void blasfeo_ref_pack_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat
 void blasfeo_ref_pack_l_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sB, int bi, int bj);
 // pack the upper-triangular column-major matrix A into the matrix struct B
 void blasfeo_ref_pack_u_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sB, int bi, int bj);
+// pack the column-major matrix A, scaled by alpha, into the matrix struct B
+void blasfeo_ref_pack_sc_dmat(int m, int n, double alpha, double *A, int lda, struct blasfeo_dmat *sB, int bi, int bj);
 // transpose and pack the column-major matrix A into the matrix struct B
 void blasfeo_ref_pack_tran_dmat(int m, int n, double *A, int lda, struct blasfeo_dmat *sB, int bi, int bj);
+// transpose and pack the column-major matrix A, scaled by alpha, into the matrix struct B
+void blasfeo_ref_pack_tran_sc_dmat(int m, int n, double alpha, double *A, int lda, struct blasfeo_dmat *sB, int bi, int bj);
 // pack the vector x into the vector structure y
 void blasfeo_ref_pack_dvec(int m, double *x, int xi, struct blasfeo_dvec *sy, int yi);
 // unpack the matrix structure A into the column-major matrix B
@@ -270,12 +270,28 @@ void blasfeo_dgetrf_rp(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, st
 // D <= qr( C )
 int blasfeo_dgeqrf_worksize(int m, int n); // in bytes
 void blasfeo_dgeqrf(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work);
+// D <= Q^T * B, with Q the orthogonal factor of blasfeo_dgeqrf(m, n, ., ., ., sA, ai, aj, .), B and D of size (m)x(nrhs)
+void blasfeo_dormqr_lt(int m, int n, int nrhs, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+// R <= qr( C ), tall-skinny QR (m>=n): row blocks of C are factorized independently (in parallel) and the R factors
+// are combined in a reduction tree; only the upper triangle of D is written, the Q factor is kept in the workspace
+size_t blasfeo_dgeqrf_tsqr_worksize(int m, int n); // in bytes
+void blasfeo_dgeqrf_tsqr(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work);
+// D <= Q^T * B, with Q the orthogonal factor of blasfeo_dgeqrf_tsqr(m, n, ..., work), B and D of size (m)x(nrhs);
+// the rows 0 to n-1 of D are the ones matching R (e.g. the least-squares solution is R^{-1} * D[0:n,:])
+void blasfeo_dormqr_tsqr_lt(int m, int n, int nrhs, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work);
 // D <= Q factor, where C is the output of the LQ factorization
 int blasfeo_dorglq_worksize(int m, int n, int k); // in bytes
 void blasfeo_dorglq(int m, int n, int k, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work);
 // D <= lq( C )
 void blasfeo_dgelqf(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work);
 int blasfeo_dgelqf_worksize(int m, int n); // in bytes
+// L <= lq( C ), short-wide LQ (n>=m): column blocks of C are factorized independently (in parallel) and the L factors
+// are combined in a reduction tree; only the lower triangle of D is written, the Q factor is kept in the workspace
+size_t blasfeo_dgelqf_tslq_worksize(int m, int n); // in bytes
+void blasfeo_dgelqf_tslq(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work);
+// D <= B * Q^T, with Q the orthogonal factor of blasfeo_dgelqf_tslq(m, n, ..., work), B and D of size (nrhs)x(n);
+// the columns 0 to m-1 of D are the ones matching L (e.g. the min-norm solution of L * Q * x = b is Q^T * [L^{-1} * b; 0])
+void blasfeo_dormlq_tslq_rt(int m, int n, int nrhs, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work);
 // D <= lq( C ), positive diagonal elements
 void blasfeo_dgelqf_pd(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work);
 // [L, A] <= lq( [L, A] ), positive diagonal elements, array of matrices, with
@@ -289,6 +305,242 @@ void blasfeo_dgelqf_pd_lla(int m, int n1, struct blasfeo_dmat *sL0, int l0i, int
 
 
 
+//
+// batched routines: the same operation on batch independent problems of equal size,
+// the i-th problem uses the matrices sX[i] at offsets (xi[i], xj[i])
+//
+
+// D[i] <= beta * C[i] + alpha * A[i] * B[i]^T
+void blasfeo_dgemm_nt_batch(int m, int n, int k, double alpha, struct blasfeo_dmat **sA, int *ai, int *aj, struct blasfeo_dmat **sB, int *bi, int *bj, double beta, struct blasfeo_dmat **sC, int *ci, int *cj, struct blasfeo_dmat **sD, int *di, int *dj, int batch);
+// D[i] <= chol( C[i] ) ; C, D lower triangular
+void blasfeo_dpotrf_l_batch(int m, struct blasfeo_dmat **sC, int *ci, int *cj, struct blasfeo_dmat **sD, int *di, int *dj, int batch);
+
+
+
+//
+// compact routines: the same operation on all the matrices of a compact batch,
+// vectorized across the batch
+//
+
+// D <= beta * C + alpha * A * B
+void blasfeo_dgemm_nn_compact(int m, int n, int k, double alpha, struct blasfeo_dmat_compact *sA, int ai, int aj, struct blasfeo_dmat_compact *sB, int bi, int bj, double beta, struct blasfeo_dmat_compact *sC, int ci, int cj, struct blasfeo_dmat_compact *sD, int di, int dj);
+// D <= beta * C + alpha * A * B^T
+void blasfeo_dgemm_nt_compact(int m, int n, int k, double alpha, struct blasfeo_dmat_compact *sA, int ai, int aj, struct blasfeo_dmat_compact *sB, int bi, int bj, double beta, struct blasfeo_dmat_compact *sC, int ci, int cj, struct blasfeo_dmat_compact *sD, int di, int dj);
+// D <= alpha * B * A^{-T} , with A lower triangular
+void blasfeo_dtrsm_rltn_compact(int m, int n, double alpha, struct blasfeo_dmat_compact *sA, int ai, int aj, struct blasfeo_dmat_compact *sB, int bi, int bj, struct blasfeo_dmat_compact *sD, int di, int dj);
+// D <= chol( C ) ; C, D lower triangular
+void blasfeo_dpotrf_l_compact(int m, struct blasfeo_dmat_compact *sC, int ci, int cj, struct blasfeo_dmat_compact *sD, int di, int dj);
+// D <= lu( C ) ; no pivoting
+void blasfeo_dgetrf_np_compact(int m, int n, struct blasfeo_dmat_compact *sC, int ci, int cj, struct blasfeo_dmat_compact *sD, int di, int dj);
+
+
+
+//
+// recorded operation graphs: the blasfeo_dgraph_<routine> calls record a call to the routine (with the same
+// arguments, the matrix and vector structures being referenced and not copied) without running it; the recorded
+// sequence is compiled once and then replayed, independent calls in the same level running in parallel
+//
+
+// memory size (in bytes) of a graph of up to max_node recorded calls
+size_t blasfeo_dgraph_memsize(int max_node);
+// create a graph of up to max_node recorded calls by using memory passed by a pointer (pointer is not updated)
+void blasfeo_dgraph_create(int max_node, struct blasfeo_dgraph *sG, void *memory);
+// drop the recorded calls
+void blasfeo_dgraph_begin(struct blasfeo_dgraph *sG);
+// dependencies, levels and threads of the recorded calls
+void blasfeo_dgraph_compile(struct blasfeo_dgraph *sG);
+// size in bytes of the scratch memory of blasfeo_dgraph_run (64-byte aligned), after blasfeo_dgraph_compile
+size_t blasfeo_dgraph_worksize(struct blasfeo_dgraph *sG);
+// run the recorded calls; work can be NULL if the worksize is 0
+void blasfeo_dgraph_run(struct blasfeo_dgraph *sG, void *work);
+//
+void blasfeo_dgraph_dgemm_nn(struct blasfeo_dgraph *sG, int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_dgraph_dgemm_nt(struct blasfeo_dgraph *sG, int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_dgraph_dsyrk_ln(struct blasfeo_dgraph *sG, int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_dgraph_dsyrk_ln_mn(struct blasfeo_dgraph *sG, int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_dgraph_dtrmm_rlnn(struct blasfeo_dgraph *sG, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_dgraph_dtrmm_rutn(struct blasfeo_dgraph *sG, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_dgraph_dtrsm_rltn(struct blasfeo_dgraph *sG, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_dgraph_dpotrf_l(struct blasfeo_dgraph *sG, int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_dgraph_dpotrf_l_mn(struct blasfeo_dgraph *sG, int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_dgraph_dsyrk_dpotrf_ln(struct blasfeo_dgraph *sG, int m, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_dgraph_dsyrk_dpotrf_ln_mn(struct blasfeo_dgraph *sG, int m, int n, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+void blasfeo_dgraph_dgemv_n(struct blasfeo_dgraph *sG, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sx, int xi, double beta, struct blasfeo_dvec *sy, int yi, struct blasfeo_dvec *sz, int zi);
+void blasfeo_dgraph_dgemv_t(struct blasfeo_dgraph *sG, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sx, int xi, double beta, struct blasfeo_dvec *sy, int yi, struct blasfeo_dvec *sz, int zi);
+void blasfeo_dgraph_dtrsv_lnn(struct blasfeo_dgraph *sG, int m, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sx, int xi, struct blasfeo_dvec *sz, int zi);
+void blasfeo_dgraph_dtrsv_ltn(struct blasfeo_dgraph *sG, int m, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sx, int xi, struct blasfeo_dvec *sz, int zi);
+void blasfeo_dgraph_dtrsv_lnn_mn(struct blasfeo_dgraph *sG, int m, int n, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sx, int xi, struct blasfeo_dvec *sz, int zi);
+void blasfeo_dgraph_dtrsv_ltn_mn(struct blasfeo_dgraph *sG, int m, int n, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sx, int xi, struct blasfeo_dvec *sz, int zi);
+void blasfeo_dgraph_dtrmv_lnn(struct blasfeo_dgraph *sG, int m, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sx, int xi, struct blasfeo_dvec *sz, int zi);
+void blasfeo_dgraph_dtrmv_ltn(struct blasfeo_dgraph *sG, int m, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sx, int xi, struct blasfeo_dvec *sz, int zi);
+void blasfeo_dgraph_dgecp(struct blasfeo_dgraph *sG, int m, int n, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj);
+void blasfeo_dgraph_dgead(struct blasfeo_dgraph *sG, int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj);
+void blasfeo_dgraph_drowex(struct blasfeo_dgraph *sG, int kmax, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sx, int xi);
+void blasfeo_dgraph_dveccp(struct blasfeo_dgraph *sG, int m, struct blasfeo_dvec *sx, int xi, struct blasfeo_dvec *sy, int yi);
+void blasfeo_dgraph_dvecsc(struct blasfeo_dgraph *sG, int m, double alpha, struct blasfeo_dvec *sx, int xi);
+void blasfeo_dgraph_daxpy(struct blasfeo_dgraph *sG, int m, double alpha, struct blasfeo_dvec *sx, int xi, struct blasfeo_dvec *sy, int yi, struct blasfeo_dvec *sz, int zi);
+
+
+
+//
+// JIT-compiled kernels of small dgemm (x86-64 with AVX2 or AVX-512, Linux and Mac): the kernel of
+// D <= beta * C + alpha * op(A) * op(B) is generated for the sizes (up to 32), the scalars, the transpositions and the
+// strides of the matrices on first request, and then cached in a table keyed on them
+//
+
+// kernel for matrices with the strides of sA, sB, sC and sD; alpha=1, beta=0 and beta=1 are baked in the kernel, any
+// other alpha and beta are given at run; NULL if the JIT does not support the architecture, the transposition of A
+// (only ta='n') or the sizes, if the kernel cannot be generated, or if the cache is full
+struct blasfeo_djit_dgemm *blasfeo_djit_dgemm_dispatch(char ta, char tb, int m, int n, int k, double alpha, struct blasfeo_dmat *sA, struct blasfeo_dmat *sB, double beta, struct blasfeo_dmat *sC, struct blasfeo_dmat *sD);
+// run a kernel on matrices with the strides given at dispatch; matrices with other strides, alpha and beta different
+// from the variant of the kernel and, in panel-major, row offsets not multiple of the panel size fall back to the
+// generic routine
+void blasfeo_djit_dgemm_run(struct blasfeo_djit_dgemm *jit, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= beta * C + alpha * op(A) * op(B) with the cached kernel, or with blasfeo_dgemm_<ta><tb> if there is none
+void blasfeo_djit_dgemm(char ta, char tb, int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// free the cached kernels; the kernels returned by blasfeo_djit_dgemm_dispatch become invalid, and none can be in use
+void blasfeo_djit_free();
+
+
+
+//
+// workspace routines (column-major high-performance): the *_worksize routines return the size in bytes of the
+// workspace used by the corresponding routine, the *_ws routines take it (64-byte aligned) and its size in bytes
+// as last arguments instead of allocating it; scratch buffers not fitting in worksize are taken from the heap
+//
+
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_COLMAJ) )
+size_t blasfeo_dgemm_nn_worksize(int m, int n, int k);
+void blasfeo_dgemm_nn_ws(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dgemm_nt_worksize(int m, int n, int k);
+void blasfeo_dgemm_nt_ws(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dgemm_tn_worksize(int m, int n, int k);
+void blasfeo_dgemm_tn_ws(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dgemm_tt_worksize(int m, int n, int k);
+void blasfeo_dgemm_tt_ws(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dsyrk3_ln_worksize(int m, int k);
+void blasfeo_dsyrk3_ln_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dsyrk3_lt_worksize(int m, int k);
+void blasfeo_dsyrk3_lt_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dsyrk3_un_worksize(int m, int k);
+void blasfeo_dsyrk3_un_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dsyrk3_ut_worksize(int m, int k);
+void blasfeo_dsyrk3_ut_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dsyrk_ln_worksize(int m, int k);
+void blasfeo_dsyrk_ln_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dsyrk_ln_mn_worksize(int m, int n, int k);
+void blasfeo_dsyrk_ln_mn_ws(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dsyrk_lt_worksize(int m, int k);
+void blasfeo_dsyrk_lt_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dsyrk_un_worksize(int m, int k);
+void blasfeo_dsyrk_un_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dsyrk_ut_worksize(int m, int k);
+void blasfeo_dsyrk_ut_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrsm_llnn_worksize(int m, int n);
+void blasfeo_dtrsm_llnn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrsm_llnu_worksize(int m, int n);
+void blasfeo_dtrsm_llnu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrsm_lltn_worksize(int m, int n);
+void blasfeo_dtrsm_lltn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrsm_lltu_worksize(int m, int n);
+void blasfeo_dtrsm_lltu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrsm_lunn_worksize(int m, int n);
+void blasfeo_dtrsm_lunn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrsm_lunu_worksize(int m, int n);
+void blasfeo_dtrsm_lunu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrsm_lutn_worksize(int m, int n);
+void blasfeo_dtrsm_lutn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrsm_lutu_worksize(int m, int n);
+void blasfeo_dtrsm_lutu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrsm_rlnn_worksize(int m, int n);
+void blasfeo_dtrsm_rlnn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrsm_rlnu_worksize(int m, int n);
+void blasfeo_dtrsm_rlnu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrsm_rltn_worksize(int m, int n);
+void blasfeo_dtrsm_rltn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrsm_rltu_worksize(int m, int n);
+void blasfeo_dtrsm_rltu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrsm_runn_worksize(int m, int n);
+void blasfeo_dtrsm_runn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrsm_runu_worksize(int m, int n);
+void blasfeo_dtrsm_runu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrsm_rutn_worksize(int m, int n);
+void blasfeo_dtrsm_rutn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrsm_rutu_worksize(int m, int n);
+void blasfeo_dtrsm_rutu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrmm_llnn_worksize(int m, int n);
+void blasfeo_dtrmm_llnn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrmm_llnu_worksize(int m, int n);
+void blasfeo_dtrmm_llnu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrmm_lltn_worksize(int m, int n);
+void blasfeo_dtrmm_lltn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrmm_lltu_worksize(int m, int n);
+void blasfeo_dtrmm_lltu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrmm_lunn_worksize(int m, int n);
+void blasfeo_dtrmm_lunn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrmm_lunu_worksize(int m, int n);
+void blasfeo_dtrmm_lunu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrmm_lutn_worksize(int m, int n);
+void blasfeo_dtrmm_lutn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrmm_lutu_worksize(int m, int n);
+void blasfeo_dtrmm_lutu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrmm_rlnn_worksize(int m, int n);
+void blasfeo_dtrmm_rlnn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrmm_rlnu_worksize(int m, int n);
+void blasfeo_dtrmm_rlnu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrmm_rltn_worksize(int m, int n);
+void blasfeo_dtrmm_rltn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrmm_rltu_worksize(int m, int n);
+void blasfeo_dtrmm_rltu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrmm_runn_worksize(int m, int n);
+void blasfeo_dtrmm_runn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrmm_runu_worksize(int m, int n);
+void blasfeo_dtrmm_runu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrmm_rutn_worksize(int m, int n);
+void blasfeo_dtrmm_rutn_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dtrmm_rutu_worksize(int m, int n);
+void blasfeo_dtrmm_rutu_ws(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dsyr2k_ln_worksize(int m, int k);
+void blasfeo_dsyr2k_ln_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dsyr2k_lt_worksize(int m, int k);
+void blasfeo_dsyr2k_lt_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dsyr2k_un_worksize(int m, int k);
+void blasfeo_dsyr2k_un_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dsyr2k_ut_worksize(int m, int k);
+void blasfeo_dsyr2k_ut_ws(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dpotrf_l_worksize(int m);
+void blasfeo_dpotrf_l_ws(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dpotrf_u_worksize(int m);
+void blasfeo_dpotrf_u_ws(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dpotrf_l_mn_worksize(int m, int n);
+void blasfeo_dpotrf_l_mn_ws(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_dgetrf_rp_worksize(int m, int n);
+void blasfeo_dgetrf_rp_ws(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, int *ipiv, void *work, size_t worksize);
+// pre-packed left factor (pack once, compute many): size in bytes of the memory of a pre-packed m x k op(A)
+size_t blasfeo_dgemm_pack_memsize(int m, int k);
+// pack op(A) of size m x k, with op(A)=A if ta is 'n' and op(A)=A^T if ta is 't', into sP using the memory mem (64-byte aligned)
+void blasfeo_dgemm_pack(char ta, int m, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_pm_dmat *sP, void *mem);
+// D <= beta * C + alpha * op(A) * B, with op(A) pre-packed in sP
+void blasfeo_dgemm_compute_n(int n, double alpha, struct blasfeo_pm_dmat *sP, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= beta * C + alpha * op(A) * B^T, with op(A) pre-packed in sP
+void blasfeo_dgemm_compute_t(int n, double alpha, struct blasfeo_pm_dmat *sP, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// execution plans of fixed sizes and offsets, with the variant and the code path resolved at plan creation
+// plan D <= beta * C + alpha * op(A) * op(B), with op(A)=A if ta is 'n' and op(A)=A^T if ta is 't', op(B) likewise
+void blasfeo_dgemm_plan(char ta, char tb, int m, int n, int k, int ai, int aj, int bi, int bj, int ci, int cj, int di, int dj, struct blasfeo_dplan *plan);
+void blasfeo_dgemm_execute(struct blasfeo_dplan *plan, double alpha, struct blasfeo_dmat *sA, struct blasfeo_dmat *sB, double beta, struct blasfeo_dmat *sC, struct blasfeo_dmat *sD);
+// plan D <= beta * C + alpha * A * B^T if ta is 'n' or alpha * A^T * B if ta is 't', lower or upper triangular part as uplo
+void blasfeo_dsyrk_plan(char uplo, char ta, int m, int k, int ai, int aj, int bi, int bj, int ci, int cj, int di, int dj, struct blasfeo_dplan *plan);
+void blasfeo_dsyrk_execute(struct blasfeo_dplan *plan, double alpha, struct blasfeo_dmat *sA, struct blasfeo_dmat *sB, double beta, struct blasfeo_dmat *sC, struct blasfeo_dmat *sD);
+// plan the triangular solve of the dtrsm variant given by side ('l'/'r'), uplo ('l'/'u'), ta ('n'/'t') and diag ('n'/'u')
+void blasfeo_dtrsm_plan(char side, char uplo, char ta, char diag, int m, int n, int ai, int aj, int bi, int bj, int di, int dj, struct blasfeo_dplan *plan);
+void blasfeo_dtrsm_execute(struct blasfeo_dplan *plan, double alpha, struct blasfeo_dmat *sA, struct blasfeo_dmat *sB, struct blasfeo_dmat *sD);
+// plan the cholesky factorization of the lower ('l') or upper ('u') triangular part
+void blasfeo_dpotrf_plan(char uplo, int m, int ci, int cj, int di, int dj, struct blasfeo_dplan *plan);
+void blasfeo_dpotrf_execute(struct blasfeo_dplan *plan, struct blasfeo_dmat *sC, struct blasfeo_dmat *sD);
+#endif
+
+
+
 //
 // BLAS API helper functions
 //
@@ -353,6 +605,134 @@ void blasfeo_cm_dger(int m, int n, double alpha, struct blasfeo_cm_dvec *sx, int
 void blasfeo_cm_dpotrf_l(int m, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj);
 void blasfeo_cm_dpotrf_u(int m, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj);
 void blasfeo_cm_dgetrf_rp(int m, int n, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, int *ipiv);
+// workspace
+size_t blasfeo_cm_dgemm_nn_worksize(int m, int n, int k);
+void blasfeo_cm_dgemm_nn_ws(int m, int n, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dgemm_nt_worksize(int m, int n, int k);
+void blasfeo_cm_dgemm_nt_ws(int m, int n, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dgemm_tn_worksize(int m, int n, int k);
+void blasfeo_cm_dgemm_tn_ws(int m, int n, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dgemm_tt_worksize(int m, int n, int k);
+void blasfeo_cm_dgemm_tt_ws(int m, int n, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dsyrk3_ln_worksize(int m, int k);
+void blasfeo_cm_dsyrk3_ln_ws(int m, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dsyrk3_lt_worksize(int m, int k);
+void blasfeo_cm_dsyrk3_lt_ws(int m, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dsyrk3_un_worksize(int m, int k);
+void blasfeo_cm_dsyrk3_un_ws(int m, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dsyrk3_ut_worksize(int m, int k);
+void blasfeo_cm_dsyrk3_ut_ws(int m, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dsyrk_ln_worksize(int m, int k);
+void blasfeo_cm_dsyrk_ln_ws(int m, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dsyrk_ln_mn_worksize(int m, int n, int k);
+void blasfeo_cm_dsyrk_ln_mn_ws(int m, int n, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dsyrk_lt_worksize(int m, int k);
+void blasfeo_cm_dsyrk_lt_ws(int m, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dsyrk_un_worksize(int m, int k);
+void blasfeo_cm_dsyrk_un_ws(int m, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dsyrk_ut_worksize(int m, int k);
+void blasfeo_cm_dsyrk_ut_ws(int m, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrsm_llnn_worksize(int m, int n);
+void blasfeo_cm_dtrsm_llnn_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrsm_llnu_worksize(int m, int n);
+void blasfeo_cm_dtrsm_llnu_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrsm_lltn_worksize(int m, int n);
+void blasfeo_cm_dtrsm_lltn_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrsm_lltu_worksize(int m, int n);
+void blasfeo_cm_dtrsm_lltu_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrsm_lunn_worksize(int m, int n);
+void blasfeo_cm_dtrsm_lunn_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrsm_lunu_worksize(int m, int n);
+void blasfeo_cm_dtrsm_lunu_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrsm_lutn_worksize(int m, int n);
+void blasfeo_cm_dtrsm_lutn_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrsm_lutu_worksize(int m, int n);
+void blasfeo_cm_dtrsm_lutu_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrsm_rlnn_worksize(int m, int n);
+void blasfeo_cm_dtrsm_rlnn_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrsm_rlnu_worksize(int m, int n);
+void blasfeo_cm_dtrsm_rlnu_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrsm_rltn_worksize(int m, int n);
+void blasfeo_cm_dtrsm_rltn_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrsm_rltu_worksize(int m, int n);
+void blasfeo_cm_dtrsm_rltu_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrsm_runn_worksize(int m, int n);
+void blasfeo_cm_dtrsm_runn_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrsm_runu_worksize(int m, int n);
+void blasfeo_cm_dtrsm_runu_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrsm_rutn_worksize(int m, int n);
+void blasfeo_cm_dtrsm_rutn_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrsm_rutu_worksize(int m, int n);
+void blasfeo_cm_dtrsm_rutu_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrmm_llnn_worksize(int m, int n);
+void blasfeo_cm_dtrmm_llnn_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrmm_llnu_worksize(int m, int n);
+void blasfeo_cm_dtrmm_llnu_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrmm_lltn_worksize(int m, int n);
+void blasfeo_cm_dtrmm_lltn_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrmm_lltu_worksize(int m, int n);
+void blasfeo_cm_dtrmm_lltu_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrmm_lunn_worksize(int m, int n);
+void blasfeo_cm_dtrmm_lunn_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrmm_lunu_worksize(int m, int n);
+void blasfeo_cm_dtrmm_lunu_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrmm_lutn_worksize(int m, int n);
+void blasfeo_cm_dtrmm_lutn_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrmm_lutu_worksize(int m, int n);
+void blasfeo_cm_dtrmm_lutu_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrmm_rlnn_worksize(int m, int n);
+void blasfeo_cm_dtrmm_rlnn_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrmm_rlnu_worksize(int m, int n);
+void blasfeo_cm_dtrmm_rlnu_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrmm_rltn_worksize(int m, int n);
+void blasfeo_cm_dtrmm_rltn_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrmm_rltu_worksize(int m, int n);
+void blasfeo_cm_dtrmm_rltu_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrmm_runn_worksize(int m, int n);
+void blasfeo_cm_dtrmm_runn_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrmm_runu_worksize(int m, int n);
+void blasfeo_cm_dtrmm_runu_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrmm_rutn_worksize(int m, int n);
+void blasfeo_cm_dtrmm_rutn_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dtrmm_rutu_worksize(int m, int n);
+void blasfeo_cm_dtrmm_rutu_ws(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dsyr2k_ln_worksize(int m, int k);
+void blasfeo_cm_dsyr2k_ln_ws(int m, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dsyr2k_lt_worksize(int m, int k);
+void blasfeo_cm_dsyr2k_lt_ws(int m, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dsyr2k_un_worksize(int m, int k);
+void blasfeo_cm_dsyr2k_un_ws(int m, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dsyr2k_ut_worksize(int m, int k);
+void blasfeo_cm_dsyr2k_ut_ws(int m, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dpotrf_l_worksize(int m);
+void blasfeo_cm_dpotrf_l_ws(int m, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dpotrf_u_worksize(int m);
+void blasfeo_cm_dpotrf_u_ws(int m, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dpotrf_l_mn_worksize(int m, int n);
+void blasfeo_cm_dpotrf_l_mn_ws(int m, int n, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_dgetrf_rp_worksize(int m, int n);
+void blasfeo_cm_dgetrf_rp_ws(int m, int n, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj, int *ipiv, void *work, size_t worksize);
+// pre-packed left factor (pack once, compute many): size in bytes of the memory of a pre-packed m x k op(A)
+size_t blasfeo_cm_dgemm_pack_memsize(int m, int k);
+// pack op(A) of size m x k, with op(A)=A if ta is 'n' and op(A)=A^T if ta is 't', into sP using the memory mem (64-byte aligned)
+void blasfeo_cm_dgemm_pack(char ta, int m, int k, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_pm_dmat *sP, void *mem);
+// D <= beta * C + alpha * op(A) * B, with op(A) pre-packed in sP
+void blasfeo_cm_dgemm_compute_n(int n, double alpha, struct blasfeo_pm_dmat *sP, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj);
+// D <= beta * C + alpha * op(A) * B^T, with op(A) pre-packed in sP
+void blasfeo_cm_dgemm_compute_t(int n, double alpha, struct blasfeo_pm_dmat *sP, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj);
+// execution plans of fixed sizes and offsets, with the variant and the code path resolved at plan creation
+// plan D <= beta * C + alpha * op(A) * op(B), with op(A)=A if ta is 'n' and op(A)=A^T if ta is 't', op(B) likewise
+void blasfeo_cm_dgemm_plan(char ta, char tb, int m, int n, int k, int ai, int aj, int bi, int bj, int ci, int cj, int di, int dj, struct blasfeo_dplan *plan);
+void blasfeo_cm_dgemm_execute(struct blasfeo_dplan *plan, double alpha, struct blasfeo_cm_dmat *sA, struct blasfeo_cm_dmat *sB, double beta, struct blasfeo_cm_dmat *sC, struct blasfeo_cm_dmat *sD);
+// plan D <= beta * C + alpha * A * B^T if ta is 'n' or alpha * A^T * B if ta is 't', lower or upper triangular part as uplo
+void blasfeo_cm_dsyrk_plan(char uplo, char ta, int m, int k, int ai, int aj, int bi, int bj, int ci, int cj, int di, int dj, struct blasfeo_dplan *plan);
+void blasfeo_cm_dsyrk_execute(struct blasfeo_dplan *plan, double alpha, struct blasfeo_cm_dmat *sA, struct blasfeo_cm_dmat *sB, double beta, struct blasfeo_cm_dmat *sC, struct blasfeo_cm_dmat *sD);
+// plan the triangular solve of the dtrsm variant given by side ('l'/'r'), uplo ('l'/'u'), ta ('n'/'t') and diag ('n'/'u')
+void blasfeo_cm_dtrsm_plan(char side, char uplo, char ta, char diag, int m, int n, int ai, int aj, int bi, int bj, int di, int dj, struct blasfeo_dplan *plan);
+void blasfeo_cm_dtrsm_execute(struct blasfeo_dplan *plan, double alpha, struct blasfeo_cm_dmat *sA, struct blasfeo_cm_dmat *sB, struct blasfeo_cm_dmat *sD);
+// plan the cholesky factorization of the lower ('l') or upper ('u') triangular part
+void blasfeo_cm_dpotrf_plan(char uplo, int m, int ci, int cj, int di, int dj, struct blasfeo_dplan *plan);
+void blasfeo_cm_dpotrf_execute(struct blasfeo_dplan *plan, struct blasfeo_cm_dmat *sC, struct blasfeo_cm_dmat *sD);
 #endif
 
 
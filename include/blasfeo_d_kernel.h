@@ -1314,6 +1314,16 @@ void kernel_dpack_buffer_ut(int m, double *A, int lda, double *pA, int sda);
 
 
 
+// compact batch layout: one group of 4 interleaved matrices
+//
+void kernel_dgemm_nn_compact_lib4(int m, int n, int k, double *alpha, double *A, int lda, double *B, int ldb, double *beta, double *C, int ldc, double *D, int ldd);
+void kernel_dgemm_nt_compact_lib4(int m, int n, int k, double *alpha, double *A, int lda, double *B, int ldb, double *beta, double *C, int ldc, double *D, int ldd);
+void kernel_dtrsm_nt_rl_inv_compact_lib4(int m, int n, double *alpha, double *A, int lda, double *B, int ldb, double *D, int ldd);
+void kernel_dpotrf_l_compact_lib4(int m, double *C, int ldc, double *D, int ldd);
+void kernel_dgetrf_np_compact_lib4(int m, int n, double *C, int ldc, double *D, int ldd);
+
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,92 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#ifndef BLASFEO_DGEMM_TUNE_H_
+#define BLASFEO_DGEMM_TUNE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+// decision table for the packing algorithm of the column-major dgemm: each of m, n and k is mapped to the bin
+// b such that 2^(b-1) < size <= 2^b (the last bin collecting all larger sizes), and each (m,n,k) bin triple
+// can be assigned a packing algorithm overriding the built-in heuristic of the target
+#define BLASFEO_DGEMM_TUNE_BINS 12
+
+// packing algorithms
+#define BLASFEO_DGEMM_ALG_AUTO -1 // built-in heuristic
+#define BLASFEO_DGEMM_ALG_0 0 // no packing (ignored for tn, pack A on the targets lacking it, as PACKING_ALG_0)
+#define BLASFEO_DGEMM_ALG_M1 1 // pack A
+#define BLASFEO_DGEMM_ALG_N1 2 // pack B
+#define BLASFEO_DGEMM_ALG_2 3 // pack A and B (cache blocking)
+
+// transposition variants
+#define BLASFEO_DGEMM_NN 0
+#define BLASFEO_DGEMM_NT 1
+#define BLASFEO_DGEMM_TN 2
+#define BLASFEO_DGEMM_TT 3
+
+
+
+// bin of a matrix size
+int blasfeo_dgemm_tune_bin(int size);
+// representative size of a bin, at which the tuner measures
+int blasfeo_dgemm_tune_bin_size(int bin);
+// packing algorithm assigned to a bin triple
+int blasfeo_dgemm_tune_get(int variant, int bm, int bn, int bk);
+// assign a packing algorithm to a bin triple (BLASFEO_DGEMM_ALG_AUTO restores the heuristic)
+void blasfeo_dgemm_tune_set(int variant, int bm, int bn, int bk, int alg);
+// reset the whole table to the built-in heuristic
+void blasfeo_dgemm_tune_clear();
+// packing algorithm for a matrix size, as looked up by dgemm; at the first call the table is loaded from the
+// file in the BLASFEO_DGEMM_TUNE environment variable, if set
+int blasfeo_dgemm_tune_alg(int variant, int m, int n, int k);
+#if defined(EXT_DEP)
+// load a table written by blasfeo_dgemm_tune_save (or the dgemm tuner benchmark); the table is rejected if it
+// was tuned for another target; returns 0 on success
+int blasfeo_dgemm_tune_load(char *file_name);
+// write the non-default entries of the table; returns 0 on success
+int blasfeo_dgemm_tune_save(char *file_name);
+#endif
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLASFEO_DGEMM_TUNE_H_
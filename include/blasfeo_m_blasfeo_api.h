@@ -0,0 +1,81 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#ifndef BLASFEO_M_BLASFEO_API_H_
+#define BLASFEO_M_BLASFEO_API_H_
+
+
+
+#include <stdlib.h>
+
+#include "blasfeo_common.h"
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+//
+// mixed-precision LAPACK: the matrix is factorized in single precision and the solution is refined in double
+// precision; if the refinement does not converge (or the single-precision factorization breaks down) the system
+// is solved again with a double-precision factorization. A and B are not modified, and the routines return the
+// number of refinement iterations, or a negative number if the double-precision fallback has been used.
+// The mixed-precision path is only taken for n>=512, by dposv_mixed with the vectorized panel-major lib4 kernels
+// and by both routines with the external LAPACK, where the single-precision factorizations are substantially faster
+// than the double-precision ones; elsewhere the routines directly solve the system in double precision
+//
+
+// X <= A^{-1} * B, A of size n x n (general), B and X of size n x nrhs
+int blasfeo_dgesv_mixed(int n, int nrhs, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sX, int xi, int xj);
+// X <= A^{-1} * B, A of size n x n (symmetric positive definite, only the lower triangle is accessed), B and X of size n x nrhs
+int blasfeo_dposv_mixed(int n, int nrhs, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sX, int xi, int xj);
+
+// workspace variants, see blasfeo_memory.h
+size_t blasfeo_dgesv_mixed_worksize(int n, int nrhs);
+int blasfeo_dgesv_mixed_ws(int n, int nrhs, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sX, int xi, int xj, void *work, size_t worksize);
+size_t blasfeo_dposv_mixed_worksize(int n, int nrhs);
+int blasfeo_dposv_mixed_ws(int n, int nrhs, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sX, int xi, int xj, void *work, size_t worksize);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // BLASFEO_M_BLASFEO_API_H_
@@ -43,14 +43,81 @@ extern "C" {
 
 
 
+#include <stdlib.h>
+
+
+
+// the packing buffer is thread-local: blasfeo_init and blasfeo_quit act on the calling thread only
 //
 int blasfeo_is_init();
-//
+// allocate the packing buffer of the calling thread, and start the (shared) thread pool
 void blasfeo_init();
-//
+// use the user-provided memory (at least blasfeo_memsize_buffer bytes) as packing buffer of the calling thread,
+// and start the (shared) thread pool
+void blasfeo_init_buffer(void *buffer);
+// release the packing buffer of the calling thread, and stop the (shared) thread pool
 void blasfeo_quit();
 //
 void *blasfeo_get_buffer();
+// size in bytes of the packing buffer (for the current block sizes)
+size_t blasfeo_memsize_buffer();
+
+
+
+// workspace: caller-provided scratch memory of the calling thread, from which the computational routines take
+// their temporary buffers (in stack order) instead of calling malloc; the *_worksize routines return the size
+// needed by a routine call, and the *_ws routines run it on a given workspace of given size
+struct blasfeo_work
+	{
+	char *ptr; // workspace memory
+	size_t size; // size in bytes
+	size_t used; // bytes in use
+	};
+
+// use size bytes at work as workspace of the calling thread, saving the current workspace in prev
+void blasfeo_work_begin(void *work, size_t size, struct blasfeo_work *prev);
+// restore the workspace saved in prev
+void blasfeo_work_end(struct blasfeo_work *prev);
+// scratch buffer of size bytes: 64-byte aligned from the workspace if it has room left, from the heap otherwise
+// (in NO_HEAP builds, running out of workspace is a fatal error)
+void blasfeo_work_malloc(void **ptr, size_t size);
+// release a scratch buffer of blasfeo_work_malloc (in reverse order of allocation)
+void blasfeo_work_free(void *ptr);
+// workspace size taken by a scratch buffer of size bytes
+size_t blasfeo_work_memsize(size_t size);
+
+
+
+// block sizes of the cache blocking in the column-major level 3 routines (dgemm, dsyrk, dtrsm, ...)
+struct blasfeo_block_size
+	{
+	int d_kc; // inner dimension of the packed blocks
+	int d_nc; // width of the packed panel kept in the L2 cache
+	int d_mc; // height of the packed block kept in the last level cache
+	};
+
+// block sizes in use: at the first call, the D_KC, D_NC and D_MC defaults are scaled by the ratio between
+// the detected per-core cache sizes and the ones they are tuned for, and overridden by the BLASFEO_D_KC,
+// BLASFEO_D_NC and BLASFEO_D_MC environment variables
+void blasfeo_get_block_size(struct blasfeo_block_size *bs);
+// set the block sizes (entries <=0 are left unchanged); as the environment variables, the values are rounded down
+// to multiples of the kernel sizes and limited to 16 times the defaults; the block sizes are published at once,
+// so concurrent calls always see a consistent set; packing buffers created before are not used any longer
+// by the blocked routines if too small, call blasfeo_init again to resize them
+void blasfeo_set_block_size(struct blasfeo_block_size *bs);
+//
+int blasfeo_get_d_kc();
+//
+int blasfeo_get_d_nc();
+//
+int blasfeo_get_d_mc();
+// as blasfeo_is_init and blasfeo_memsize_buffer, for the block sizes bs instead of the current ones: the blocked
+// routines read the block sizes once per call, and check the packing buffer against them
+int blasfeo_is_init_block_size(struct blasfeo_block_size *bs);
+size_t blasfeo_memsize_buffer_block_size(struct blasfeo_block_size *bs);
+// total size of the last level cache in bytes, detected at the first call (the LLC_CACHE_SIZE default of the target
+// if the detection fails, 0 if unknown)
+int blasfeo_get_llc_size();
 
 
 
@@ -39,20 +39,18 @@
 /**
  * Flags to indicate the different processor features
  */
-//enum
-//{
-//    // x86-64 CPU features
-//    BLASFEO_PROCESSOR_FEATURE_AVX  = 0x0001,    /// AVX instruction set
-//    BLASFEO_PROCESSOR_FEATURE_AVX2 = 0x0002,    /// AVX2 instruction set
-//    BLASFEO_PROCESSOR_FEATURE_FMA  = 0x0004,    /// FMA instruction set
-//    BLASFEO_PROCESSOR_FEATURE_SSE3 = 0x0008,    /// SSE3 instruction set
-//
-//    // ARM CPU features
-//    BLASFEO_PROCESSOR_FEATURE_VFPv3  = 0x0100,  /// VFPv3 instruction set
-//    BLASFEO_PROCESSOR_FEATURE_NEON   = 0x0100,  /// NEON instruction set
-//    BLASFEO_PROCESSOR_FEATURE_VFPv4  = 0x0100,  /// VFPv4 instruction set
-//    BLASFEO_PROCESSOR_FEATURE_NEONv2 = 0x0100,  /// NEONv2 instruction set
-//} BLASFEO_PROCESSOR_FEATURES;
+// x86-64 CPU features
+#define BLASFEO_PROCESSOR_FEATURE_AVX     0x0001    /// AVX instruction set
+#define BLASFEO_PROCESSOR_FEATURE_AVX2    0x0002    /// AVX2 instruction set
+#define BLASFEO_PROCESSOR_FEATURE_FMA     0x0004    /// FMA instruction set
+#define BLASFEO_PROCESSOR_FEATURE_SSE3    0x0008    /// SSE3 instruction set
+#define BLASFEO_PROCESSOR_FEATURE_AVX512F 0x0010    /// AVX512F instruction set (and OS support for its state)
+
+// ARM CPU features
+#define BLASFEO_PROCESSOR_FEATURE_VFPv3  0x0100  /// VFPv3 instruction set
+#define BLASFEO_PROCESSOR_FEATURE_NEON   0x0100  /// NEON instruction set
+#define BLASFEO_PROCESSOR_FEATURE_VFPv4  0x0100  /// VFPv4 instruction set
+#define BLASFEO_PROCESSOR_FEATURE_NEONv2 0x0100  /// NEONv2 instruction set
 
 /**
  * Test the features that this processor provides against what the library was compiled with.
@@ -85,4 +83,23 @@ void blasfeo_processor_feature_string( int features, char* featureString );
  */
 void blasfeo_processor_library_string( char* featureString );
 
+/**
+ * Detect the data cache sizes of the current processor (from sysfs on Linux, or from CPUID on x86).
+ *
+ * @param l1 - Pointer to an integer to store the L1 data cache size in bytes (0 if unknown)
+ * @param l2 - Pointer to an integer to store the L2 cache size in bytes (0 if unknown)
+ * @param llc - Pointer to an integer to store the last level cache size in bytes (0 if unknown)
+ */
+void blasfeo_processor_cache_sizes( int* l1, int* l2, int* llc );
+
+/**
+ * Detect the data cache sizes available to each core of the current processor: the private L1 and L2 caches,
+ * and the share of the last level cache, divided among the cores sharing it.
+ *
+ * @param l1 - Pointer to an integer to store the L1 data cache size in bytes (0 if unknown)
+ * @param l2 - Pointer to an integer to store the L2 cache size in bytes (0 if unknown)
+ * @param llc - Pointer to an integer to store the per-core share of the last level cache in bytes (0 if unknown)
+ */
+void blasfeo_processor_cache_sizes_per_core( int* l1, int* l2, int* llc );
+
 #endif  // BLASFEO_PROCESSOR_FEATURES_H_
@@ -66,6 +66,16 @@ void blasfeo_create_smat(int m, int n, struct blasfeo_smat *sA, void *memory);
 void blasfeo_create_smat_ps(int ps, int m, int n, struct blasfeo_smat *sA, void *memory);
 // create a strvec for a vector of size m by using memory passed by a pointer (pointer is not updated)
 void blasfeo_create_svec(int m, struct blasfeo_svec *sA, void *memory);
+// returns the memory size (in bytes) needed for a half-precision hmat
+size_t blasfeo_memsize_hmat(int m, int n);
+// create a half-precision hmat for a matrix of size m*n by using memory passed by a pointer (pointer is not updated)
+void blasfeo_create_hmat(int m, int n, struct blasfeo_hmat *sA, void *memory);
+// convert a single-precision scalar to half precision (round to nearest even) and back
+unsigned short blasfeo_cvt_s2h(float a);
+float blasfeo_cvt_h2s(unsigned short a);
+// convert the single-precision matrix A into the half-precision matrix B, and back
+void blasfeo_cvt_s2h_mat(int m, int n, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_hmat *sB, int bi, int bj);
+void blasfeo_cvt_h2s_mat(int m, int n, struct blasfeo_hmat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj);
 void blasfeo_pack_smat(int m, int n, float *A, int lda, struct blasfeo_smat *sA, int ai, int aj);
 void blasfeo_pack_l_smat(int m, int n, float *A, int lda, struct blasfeo_smat *sA, int ai, int aj);
 void blasfeo_pack_u_smat(int m, int n, float *A, int lda, struct blasfeo_smat *sA, int ai, int aj);
@@ -95,10 +95,19 @@ void s_print_exp_tran_mat(int row, int col, float *A, int lda);
 void blasfeo_allocate_smat(int m, int n, struct blasfeo_smat *sA);
 // create a strvec for a vector of size m by dynamically allocating memory
 void blasfeo_allocate_svec(int m, struct blasfeo_svec *sa);
+// create a strmat for a matrix of size m*n by dynamically allocating memory with a NUMA placement policy (BLASFEO_NUMA_*);
+// with BLASFEO_NUMA_PARTITION the panel rows (the columns if column-major) are split in one contiguous chunk per node
+void blasfeo_allocate_smat_numa(int m, int n, struct blasfeo_smat *sA, int policy);
+// zero a strmat in parallel, each panel row (column if column-major) written by a thread on its owning node
+void blasfeo_first_touch_smat(struct blasfeo_smat *sA);
 // free the memory allocated by blasfeo_allocate_dmat
 void blasfeo_free_smat(struct blasfeo_smat *sA);
 // free the memory allocated by blasfeo_allocate_dvec
 void blasfeo_free_svec(struct blasfeo_svec *sa);
+// create a half-precision hmat for a matrix of size m*n by dynamically allocating memory
+void blasfeo_allocate_hmat(int m, int n, struct blasfeo_hmat *sA);
+// free the memory allocated by blasfeo_allocate_hmat
+void blasfeo_free_hmat(struct blasfeo_hmat *sA);
 // print a strmat
 void blasfeo_print_smat(int m, int n, struct blasfeo_smat *sA, int ai, int aj);
 // print in exponential notation a strmat
@@ -244,6 +244,78 @@ void blasfeo_sgelqf_pd_lla(int m, int n1, struct blasfeo_smat *sL0, int l0i, int
 
 
 
+//
+// workspace routines (column-major high-performance): the *_worksize routines return the size in bytes of the
+// workspace used by the corresponding routine, the *_ws routines take it (64-byte aligned) and its size in bytes
+// as last arguments instead of allocating it; scratch buffers not fitting in worksize are taken from the heap
+//
+
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_COLMAJ) )
+size_t blasfeo_sgemm_nn_worksize(int m, int n, int k);
+void blasfeo_sgemm_nn_ws(int m, int n, int k, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, float beta, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_sgemm_nt_worksize(int m, int n, int k);
+void blasfeo_sgemm_nt_ws(int m, int n, int k, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, float beta, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_sgemm_tn_worksize(int m, int n, int k);
+void blasfeo_sgemm_tn_ws(int m, int n, int k, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, float beta, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_sgemm_tt_worksize(int m, int n, int k);
+void blasfeo_sgemm_tt_ws(int m, int n, int k, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, float beta, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_strsm_llnn_worksize(int m, int n);
+void blasfeo_strsm_llnn_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_strsm_llnu_worksize(int m, int n);
+void blasfeo_strsm_llnu_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_strsm_lltn_worksize(int m, int n);
+void blasfeo_strsm_lltn_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_strsm_lltu_worksize(int m, int n);
+void blasfeo_strsm_lltu_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_strsm_lunn_worksize(int m, int n);
+void blasfeo_strsm_lunn_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_strsm_lunu_worksize(int m, int n);
+void blasfeo_strsm_lunu_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_strsm_lutn_worksize(int m, int n);
+void blasfeo_strsm_lutn_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_strsm_lutu_worksize(int m, int n);
+void blasfeo_strsm_lutu_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_strsm_rlnn_worksize(int m, int n);
+void blasfeo_strsm_rlnn_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_strsm_rlnu_worksize(int m, int n);
+void blasfeo_strsm_rlnu_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_strsm_rltn_worksize(int m, int n);
+void blasfeo_strsm_rltn_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_strsm_rltu_worksize(int m, int n);
+void blasfeo_strsm_rltu_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_strsm_runn_worksize(int m, int n);
+void blasfeo_strsm_runn_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_strsm_runu_worksize(int m, int n);
+void blasfeo_strsm_runu_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_strsm_rutn_worksize(int m, int n);
+void blasfeo_strsm_rutn_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_strsm_rutu_worksize(int m, int n);
+void blasfeo_strsm_rutu_ws(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_spotrf_l_worksize(int m);
+void blasfeo_spotrf_l_ws(int m, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_spotrf_u_worksize(int m);
+void blasfeo_spotrf_u_ws(int m, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_spotrf_l_mn_worksize(int m, int n);
+void blasfeo_spotrf_l_mn_ws(int m, int n, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, void *work, size_t worksize);
+#endif
+
+
+
+
+//
+// half-precision storage routines: A is a half-precision hmat, converted to single precision in registers,
+// all the other operands and the accumulation are in single precision
+//
+
+// D <= beta * C + alpha * A * B^T
+void blasfeo_hgemm_nt(int m, int n, int k, float alpha, struct blasfeo_hmat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, float beta, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj);
+// z <= beta * y + alpha * A * x
+void blasfeo_hgemv_n(int m, int n, float alpha, struct blasfeo_hmat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, float beta, struct blasfeo_svec *sy, int yi, struct blasfeo_svec *sz, int zi);
+// z <= beta * y + alpha * A^T * x
+void blasfeo_hgemv_t(int m, int n, float alpha, struct blasfeo_hmat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, float beta, struct blasfeo_svec *sy, int yi, struct blasfeo_svec *sz, int zi);
+
+
+
 //
 // BLAS API helper functions
 //
@@ -273,6 +345,53 @@ void blasfeo_cm_strsm_rutu(int m, int n, float alpha, struct blasfeo_cm_smat *sA
 // LAPACK
 void blasfeo_cm_spotrf_l(int m, struct blasfeo_cm_smat *sC, int ci, int cj, struct blasfeo_cm_smat *sD, int di, int dj);
 void blasfeo_cm_spotrf_u(int m, struct blasfeo_cm_smat *sC, int ci, int cj, struct blasfeo_cm_smat *sD, int di, int dj);
+// workspace
+size_t blasfeo_cm_sgemm_nn_worksize(int m, int n, int k);
+void blasfeo_cm_sgemm_nn_ws(int m, int n, int k, float alpha, struct blasfeo_cm_smat *sA, int ai, int aj, struct blasfeo_cm_smat *sB, int bi, int bj, float beta, struct blasfeo_cm_smat *sC, int ci, int cj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_sgemm_nt_worksize(int m, int n, int k);
+void blasfeo_cm_sgemm_nt_ws(int m, int n, int k, float alpha, struct blasfeo_cm_smat *sA, int ai, int aj, struct blasfeo_cm_smat *sB, int bi, int bj, float beta, struct blasfeo_cm_smat *sC, int ci, int cj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_sgemm_tn_worksize(int m, int n, int k);
+void blasfeo_cm_sgemm_tn_ws(int m, int n, int k, float alpha, struct blasfeo_cm_smat *sA, int ai, int aj, struct blasfeo_cm_smat *sB, int bi, int bj, float beta, struct blasfeo_cm_smat *sC, int ci, int cj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_sgemm_tt_worksize(int m, int n, int k);
+void blasfeo_cm_sgemm_tt_ws(int m, int n, int k, float alpha, struct blasfeo_cm_smat *sA, int ai, int aj, struct blasfeo_cm_smat *sB, int bi, int bj, float beta, struct blasfeo_cm_smat *sC, int ci, int cj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_strsm_llnn_worksize(int m, int n);
+void blasfeo_cm_strsm_llnn_ws(int m, int n, float alpha, struct blasfeo_cm_smat *sA, int ai, int aj, struct blasfeo_cm_smat *sB, int bi, int bj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_strsm_llnu_worksize(int m, int n);
+void blasfeo_cm_strsm_llnu_ws(int m, int n, float alpha, struct blasfeo_cm_smat *sA, int ai, int aj, struct blasfeo_cm_smat *sB, int bi, int bj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_strsm_lltn_worksize(int m, int n);
+void blasfeo_cm_strsm_lltn_ws(int m, int n, float alpha, struct blasfeo_cm_smat *sA, int ai, int aj, struct blasfeo_cm_smat *sB, int bi, int bj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_strsm_lltu_worksize(int m, int n);
+void blasfeo_cm_strsm_lltu_ws(int m, int n, float alpha, struct blasfeo_cm_smat *sA, int ai, int aj, struct blasfeo_cm_smat *sB, int bi, int bj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_strsm_lunn_worksize(int m, int n);
+void blasfeo_cm_strsm_lunn_ws(int m, int n, float alpha, struct blasfeo_cm_smat *sA, int ai, int aj, struct blasfeo_cm_smat *sB, int bi, int bj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_strsm_lunu_worksize(int m, int n);
+void blasfeo_cm_strsm_lunu_ws(int m, int n, float alpha, struct blasfeo_cm_smat *sA, int ai, int aj, struct blasfeo_cm_smat *sB, int bi, int bj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_strsm_lutn_worksize(int m, int n);
+void blasfeo_cm_strsm_lutn_ws(int m, int n, float alpha, struct blasfeo_cm_smat *sA, int ai, int aj, struct blasfeo_cm_smat *sB, int bi, int bj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_strsm_lutu_worksize(int m, int n);
+void blasfeo_cm_strsm_lutu_ws(int m, int n, float alpha, struct blasfeo_cm_smat *sA, int ai, int aj, struct blasfeo_cm_smat *sB, int bi, int bj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_strsm_rlnn_worksize(int m, int n);
+void blasfeo_cm_strsm_rlnn_ws(int m, int n, float alpha, struct blasfeo_cm_smat *sA, int ai, int aj, struct blasfeo_cm_smat *sB, int bi, int bj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_strsm_rlnu_worksize(int m, int n);
+void blasfeo_cm_strsm_rlnu_ws(int m, int n, float alpha, struct blasfeo_cm_smat *sA, int ai, int aj, struct blasfeo_cm_smat *sB, int bi, int bj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_strsm_rltn_worksize(int m, int n);
+void blasfeo_cm_strsm_rltn_ws(int m, int n, float alpha, struct blasfeo_cm_smat *sA, int ai, int aj, struct blasfeo_cm_smat *sB, int bi, int bj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_strsm_rltu_worksize(int m, int n);
+void blasfeo_cm_strsm_rltu_ws(int m, int n, float alpha, struct blasfeo_cm_smat *sA, int ai, int aj, struct blasfeo_cm_smat *sB, int bi, int bj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_strsm_runn_worksize(int m, int n);
+void blasfeo_cm_strsm_runn_ws(int m, int n, float alpha, struct blasfeo_cm_smat *sA, int ai, int aj, struct blasfeo_cm_smat *sB, int bi, int bj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_strsm_runu_worksize(int m, int n);
+void blasfeo_cm_strsm_runu_ws(int m, int n, float alpha, struct blasfeo_cm_smat *sA, int ai, int aj, struct blasfeo_cm_smat *sB, int bi, int bj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_strsm_rutn_worksize(int m, int n);
+void blasfeo_cm_strsm_rutn_ws(int m, int n, float alpha, struct blasfeo_cm_smat *sA, int ai, int aj, struct blasfeo_cm_smat *sB, int bi, int bj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_strsm_rutu_worksize(int m, int n);
+void blasfeo_cm_strsm_rutu_ws(int m, int n, float alpha, struct blasfeo_cm_smat *sA, int ai, int aj, struct blasfeo_cm_smat *sB, int bi, int bj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_spotrf_l_worksize(int m);
+void blasfeo_cm_spotrf_l_ws(int m, struct blasfeo_cm_smat *sC, int ci, int cj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_spotrf_u_worksize(int m);
+void blasfeo_cm_spotrf_u_ws(int m, struct blasfeo_cm_smat *sC, int ci, int cj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
+size_t blasfeo_cm_spotrf_l_mn_worksize(int m, int n);
+void blasfeo_cm_spotrf_l_mn_ws(int m, int n, struct blasfeo_cm_smat *sC, int ci, int cj, struct blasfeo_cm_smat *sD, int di, int dj, void *work, size_t worksize);
 #endif
 
 
@@ -178,6 +178,53 @@ void kernel_ssymv_l_4r_lib8(int kmax, float *alpha, float *A, int sda, float *x,
 void kernel_ssymv_l_4l_gen_lib8(int kmax, float *alpha, int offA, float *A, int sda, float *x, float *z, int km);
 void kernel_ssymv_l_4r_gen_lib8(int kmax, float *alpha, int offA, float *A, int sda, float *x, float *z, int km);
 
+
+
+//
+// lib16
+//
+
+// 32x8
+void kernel_sgemm_nt_32x8_lib16(int k, float *alpha, float *A, int sda, float *B, float *beta, float *C, int sdc, float *D, int sdd);
+void kernel_sgemm_nt_32x8_vs_lib16(int k, float *alpha, float *A, int sda, float *B, float *beta, float *C, int sdc, float *D, int sdd, int km, int kn);
+void kernel_sgemm_nn_32x8_lib16(int k, float *alpha, float *A, int sda, int offsetB, float *B, int sdb, float *beta, float *C, int sdc, float *D, int sdd);
+void kernel_sgemm_nn_32x8_vs_lib16(int k, float *alpha, float *A, int sda, int offsetB, float *B, int sdb, float *beta, float *C, int sdc, float *D, int sdd, int km, int kn);
+// 16x8
+void kernel_sgemm_nt_16x8_lib16(int k, float *alpha, float *A, float *B, float *beta, float *C, float *D);
+void kernel_sgemm_nt_16x8_vs_lib16(int k, float *alpha, float *A, float *B, float *beta, float *C, float *D, int km, int kn);
+void kernel_sgemm_nn_16x8_lib16(int k, float *alpha, float *A, int offsetB, float *B, int sdb, float *beta, float *C, float *D);
+void kernel_sgemm_nn_16x8_vs_lib16(int k, float *alpha, float *A, int offsetB, float *B, int sdb, float *beta, float *C, float *D, int km, int kn);
+void kernel_ssyrk_nt_l_16x8_lib16(int k, float *alpha, float *A, float *B, float *beta, float *C, float *D);
+void kernel_ssyrk_nt_l_16x8_vs_lib16(int k, float *alpha, float *A, float *B, float *beta, float *C, float *D, int km, int kn);
+void kernel_spotrf_nt_l_16x8_lib16(int k, float *A, float *B, float *C, float *D, float *inv_diag_D);
+void kernel_spotrf_nt_l_16x8_vs_lib16(int k, float *A, float *B, float *C, float *D, float *inv_diag_D, int km, int kn);
+void kernel_strsm_nt_rl_inv_16x8_lib16(int k, float *A, float *B, float *C, float *D, float *E, float *inv_diag_E);
+void kernel_strsm_nt_rl_inv_16x8_vs_lib16(int k, float *A, float *B, float *C, float *D, float *E, float *inv_diag_E, int km, int kn);
+// 8x8 (A, C and D point to row 8 of their panel)
+void kernel_ssyrk_nt_l_8x8_lib16(int k, float *alpha, float *A, float *B, float *beta, float *C, float *D);
+void kernel_ssyrk_nt_l_8x8_vs_lib16(int k, float *alpha, float *A, float *B, float *beta, float *C, float *D, int km, int kn);
+void kernel_spotrf_nt_l_8x8_lib16(int k, float *A, float *B, float *C, float *D, float *inv_diag_D);
+void kernel_spotrf_nt_l_8x8_vs_lib16(int k, float *A, float *B, float *C, float *D, float *inv_diag_D, int km, int kn);
+void kernel_strsm_nn_ll_one_8x8_vs_lib16(int k, float *A, int offsetB, float *B, int sdb, float *C, float *D, float *E, int km, int kn);
+// 8
+void kernel_sgetrf_pivot_8_vs_lib16(int m, int offA, float *pA, int sda, float *inv_diag_A, int *ipiv, int n);
+void kernel_sgetrf_np_8_vs_lib16(int m, int offA, float *pA, int sda, float *inv_diag_A, int n);
+void kernel_sgemv_t_8_lib16(int k, float *alpha, int offsetA, float *A, int sda, float *x, float *beta, float *y, float *z);
+void kernel_sgemv_t_8_vs_lib16(int k, float *alpha, int offsetA, float *A, int sda, float *x, float *beta, float *y, float *z, int kn);
+// 16
+void kernel_sgemv_n_16_lib16(int k, float *alpha, float *A, float *x, float *beta, float *y, float *z);
+void kernel_sgemv_n_16_vs_lib16(int k, float *alpha, float *A, float *x, float *beta, float *y, float *z, int km);
+
+// half-precision A
+// 8x4
+void kernel_hgemm_nt_8x4_lib8(int k, float *alpha, unsigned short *A, float *B, float *beta, float *C, float *D);
+void kernel_hgemm_nt_8x4_vs_lib8(int k, float *alpha, unsigned short *A, float *B, float *beta, float *C, float *D, int km, int kn);
+// 8
+void kernel_hgemv_n_8_lib8(int k, float *alpha, unsigned short *A, float *x, float *beta, float *y, float *z);
+void kernel_hgemv_n_8_vs_lib8(int k, float *alpha, unsigned short *A, float *x, float *beta, float *y, float *z, int km);
+void kernel_hgemv_t_8_lib8(int k, float *alpha, unsigned short *A, int sda, float *x, float *beta, float *y, float *z);
+void kernel_hgemv_t_8_vs_lib8(int k, float *alpha, unsigned short *A, int sda, float *x, float *beta, float *y, float *z, int kn);
+
 // -------- aux
 
 // ---- copy
@@ -44,6 +44,27 @@ extern "C" {
 
 #include <stdlib.h>
 
+
+
+// NUMA placement policies of memory pages
+#define BLASFEO_NUMA_DEFAULT 0 // first touch: each page on the node of the thread writing it first
+#define BLASFEO_NUMA_LOCAL 1 // on the node of the allocating thread
+#define BLASFEO_NUMA_INTERLEAVE 2 // round-robin over all nodes
+#define BLASFEO_NUMA_PARTITION 3 // one contiguous chunk per node, in node order
+
+// huge page modes of the aligned allocations
+#define BLASFEO_HUGE_PAGES_OFF 0
+#define BLASFEO_HUGE_PAGES_ON 1 // allocations spanning a huge page aligned to it, and advised for transparent huge pages
+#define BLASFEO_HUGE_PAGES_PREFAULT 2 // as BLASFEO_HUGE_PAGES_ON, and all pages touched at allocation
+
+// size of the (transparent) huge pages
+#define BLASFEO_HUGE_PAGE_SIZE (2*1024*1024)
+
+// max number of NUMA nodes
+#define BLASFEO_NUMA_MAX_NODES 64
+
+
+
 //
 void blasfeo_malloc(void **ptr, size_t size);
 //
@@ -52,6 +73,21 @@ void blasfeo_malloc_align(void **ptr, size_t size);
 void blasfeo_free(void *ptr);
 //
 void blasfeo_free_align(void *ptr);
+// huge page mode (BLASFEO_HUGE_PAGES_*) of blasfeo_malloc_align, blasfeo_malloc_align_numa and therefore of blasfeo_allocate_dmat
+// and of the blasfeo_init packing buffer (Linux only); the prefault mode defeats the NUMA first-touch placement
+void blasfeo_set_huge_pages(int mode);
+// huge page mode, initialized by the BLASFEO_HUGE_PAGES environment variable (default BLASFEO_HUGE_PAGES_OFF)
+int blasfeo_get_huge_pages();
+// number of NUMA nodes (1 if unknown, or if not on Linux)
+int blasfeo_numa_num_nodes();
+// NUMA node of the cpu (0 if unknown)
+int blasfeo_numa_node_of_cpu(int cpu);
+// set the placement policy of the pages overlapping [ptr, ptr+size); pages already touched are moved if possible; returns 0 on success
+int blasfeo_numa_bind(void *ptr, size_t size, int policy);
+// place the pages overlapping [ptr, ptr+size) preferably on the node; returns 0 on success
+int blasfeo_numa_bind_node(void *ptr, size_t size, int node);
+// allocate memory aligned to the page size, with the NUMA placement policy (to be freed with blasfeo_free_align)
+void blasfeo_malloc_align_numa(void **ptr, size_t size, int policy);
 
 
 
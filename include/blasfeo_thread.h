@@ -0,0 +1,116 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#ifndef BLASFEO_THREAD_H_
+#define BLASFEO_THREAD_H_
+
+#if defined(MULTI_THREAD)
+#include <pthread.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+// max number of threads used by the parallel routines
+#define BLASFEO_MAX_THREADS 64
+
+
+
+//
+void blasfeo_set_num_threads(int num_threads);
+// number of threads used by the parallel routines; it is 1 inside a parallel region
+int blasfeo_get_num_threads();
+// operations with fewer floating-point operations than flops are run on the calling thread (default 0)
+void blasfeo_set_thread_threshold(double flops);
+// number of threads used for an operation of flops floating-point operations
+int blasfeo_get_num_threads_flops(double flops);
+// number of busy-waiting iterations of an idle thread before it sleeps
+void blasfeo_set_thread_spin(int spin);
+// exclusive mode: idle threads never sleep, for pool threads pinned to isolated cores
+void blasfeo_set_thread_exclusive(int exclusive);
+// pin the pool thread tid (tid>=1) to the core cpu[(tid-1)%ncpu], or unpin them all if ncpu is 0;
+// the calling thread, that is the thread 0, is left untouched; returns 0 on success (Linux only)
+int blasfeo_set_thread_affinity(int ncpu, int *cpu);
+// NUMA node of each of the nth threads of a parallel region started by the calling thread, the pool threads being
+// pinned by blasfeo_set_thread_affinity; returns the number of nodes, or 0 if the mapping is unknown
+int blasfeo_thread_numa_nodes(int nth, int *node);
+// blocks [ba,bb) of a matrix of nb blocks partitioned over the nnode NUMA nodes in contiguous chunks, as by blasfeo_allocate_dmat_numa:
+// range [*b0,*b1) computed by the thread tid, the blocks of each node being split over the threads on that node;
+// the blocks are split evenly over the threads if nnode<2, or if a node owning some of the blocks has no thread
+void blasfeo_thread_numa_range(int tid, int nth, int *node, int nnode, int nb, int ba, int bb, int *b0, int *b1);
+// start the persistent pool threads, up to the number of threads, and hold the pool in the calling thread
+// (called by blasfeo_init, otherwise the threads are started on first use)
+void blasfeo_thread_pool_init();
+// release the pool held by the calling thread, and stop the pool threads if no other thread holds it
+// (called by blasfeo_quit)
+void blasfeo_thread_pool_quit();
+
+
+
+#if defined(MULTI_THREAD)
+
+// barrier for the threads of a parallel region
+struct blasfeo_barrier
+	{
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	int nth;
+	int count;
+	int phase;
+	};
+
+//
+void blasfeo_barrier_init(struct blasfeo_barrier *bar, int nth);
+//
+void blasfeo_barrier_wait(struct blasfeo_barrier *bar);
+//
+void blasfeo_barrier_destroy(struct blasfeo_barrier *bar);
+// run fun(tid, nth, arg) on nth threads, tid 0 being the calling thread and the others taken from the pool;
+// the callers wait for the pool if it is in use, and nested calls run fun(0, 1, arg) on the calling thread
+void blasfeo_parallel_run(int nth, void (*fun)(int tid, int nth, void *arg), void *arg);
+
+#endif // MULTI_THREAD
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLASFEO_THREAD_H_
@@ -1051,7 +1051,7 @@ void kernel_dlarf_t_4_lib4(int m, int n, double *pD, int sdd, double *pVt, doubl
 	double a0, a1, a2, a3, b0, b1;
 	double tmp, d0, d1, d2, d3;
 	double *pC, *pW;
-	double pT[16];// = {};
+	ALIGNED( double pT[16], 32 ); // loaded with aligned AVX loads
 	int ldt = 4;
 	// dot product of v
 	v10 = 0.0;
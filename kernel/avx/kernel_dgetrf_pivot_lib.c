@@ -43,6 +43,7 @@
 #include "../../include/blasfeo_common.h"
 #include "../../include/blasfeo_d_aux.h"
 #include "../../include/blasfeo_d_kernel.h"
+#include "../../include/blasfeo_memory.h"
 
 
 
@@ -1349,7 +1350,7 @@ void kernel_dgetrf_pivot_8_vs_lib(int m, double *C, int ldc, double *pd, int* ip
 	if(m>K_MAX_STACK)
 		{
 		m4 = (m+3)/4*4;
-		tmp_pU = malloc(3*4*m4*sizeof(double)+64);
+		blasfeo_work_malloc((void **) &tmp_pU, 3*4*m4*sizeof(double)+64);
 		blasfeo_align_64_byte(tmp_pU, (void **) &pU);
 		sdu = m4;
 		}
@@ -1429,7 +1430,7 @@ void kernel_dgetrf_pivot_8_vs_lib(int m, double *C, int ldc, double *pd, int* ip
 	end:
 	if(m>K_MAX_STACK)
 		{
-		free(tmp_pU);
+		blasfeo_work_free(tmp_pU);
 		}
 
 	return;
@@ -0,0 +1,556 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <mmintrin.h>
+#include <xmmintrin.h>  // SSE
+#include <emmintrin.h>  // SSE2
+#include <pmmintrin.h>  // SSE3
+#include <smmintrin.h>  // SSE4
+#include <immintrin.h>  // AVX
+
+#include "../../include/blasfeo_common.h"
+#include "../../include/blasfeo_d_kernel.h"
+
+
+
+// kernels on a group of 4 interleaved matrices of a compact batch:
+// element (i,j) of the 4 matrices is stored in the 4 contiguous doubles at A[(i+j*lda)*4]
+
+
+
+// D <= beta * C + alpha * A * B^T
+void kernel_dgemm_nt_compact_lib4(int m, int n, int k, double *alpha, double *A, int lda, double *B, int ldb, double *beta, double *C, int ldc, double *D, int ldd)
+	{
+
+	const int vl = 4;
+
+	int ii, jj, ll;
+
+	__m256d
+		a_0, a_1, a_2, a_3,
+		b_0, b_1,
+		d_00, d_10, d_20, d_30,
+		d_01, d_11, d_21, d_31,
+		alpha0, beta0;
+
+	alpha0 = _mm256_broadcast_sd( alpha );
+	beta0 = _mm256_broadcast_sd( beta );
+
+	jj = 0;
+	for(; jj<n-1; jj+=2)
+		{
+		ii = 0;
+		for(; ii<m-3; ii+=4)
+			{
+			d_00 = _mm256_setzero_pd();
+			d_10 = _mm256_setzero_pd();
+			d_20 = _mm256_setzero_pd();
+			d_30 = _mm256_setzero_pd();
+			d_01 = _mm256_setzero_pd();
+			d_11 = _mm256_setzero_pd();
+			d_21 = _mm256_setzero_pd();
+			d_31 = _mm256_setzero_pd();
+			for(ll=0; ll<k; ll++)
+				{
+				b_0 = _mm256_load_pd( &B[(jj+0+ll*ldb)*vl] );
+				b_1 = _mm256_load_pd( &B[(jj+1+ll*ldb)*vl] );
+				a_0 = _mm256_load_pd( &A[(ii+0+ll*lda)*vl] );
+				a_1 = _mm256_load_pd( &A[(ii+1+ll*lda)*vl] );
+				a_2 = _mm256_load_pd( &A[(ii+2+ll*lda)*vl] );
+				a_3 = _mm256_load_pd( &A[(ii+3+ll*lda)*vl] );
+				d_00 = _mm256_fmadd_pd( a_0, b_0, d_00 );
+				d_10 = _mm256_fmadd_pd( a_1, b_0, d_10 );
+				d_20 = _mm256_fmadd_pd( a_2, b_0, d_20 );
+				d_30 = _mm256_fmadd_pd( a_3, b_0, d_30 );
+				d_01 = _mm256_fmadd_pd( a_0, b_1, d_01 );
+				d_11 = _mm256_fmadd_pd( a_1, b_1, d_11 );
+				d_21 = _mm256_fmadd_pd( a_2, b_1, d_21 );
+				d_31 = _mm256_fmadd_pd( a_3, b_1, d_31 );
+				}
+			d_00 = _mm256_mul_pd( alpha0, d_00 );
+			d_10 = _mm256_mul_pd( alpha0, d_10 );
+			d_20 = _mm256_mul_pd( alpha0, d_20 );
+			d_30 = _mm256_mul_pd( alpha0, d_30 );
+			d_01 = _mm256_mul_pd( alpha0, d_01 );
+			d_11 = _mm256_mul_pd( alpha0, d_11 );
+			d_21 = _mm256_mul_pd( alpha0, d_21 );
+			d_31 = _mm256_mul_pd( alpha0, d_31 );
+			if(beta[0]!=0.0)
+				{
+				d_00 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+0+(jj+0)*ldc)*vl] ), d_00 );
+				d_10 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+1+(jj+0)*ldc)*vl] ), d_10 );
+				d_20 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+2+(jj+0)*ldc)*vl] ), d_20 );
+				d_30 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+3+(jj+0)*ldc)*vl] ), d_30 );
+				d_01 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+0+(jj+1)*ldc)*vl] ), d_01 );
+				d_11 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+1+(jj+1)*ldc)*vl] ), d_11 );
+				d_21 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+2+(jj+1)*ldc)*vl] ), d_21 );
+				d_31 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+3+(jj+1)*ldc)*vl] ), d_31 );
+				}
+			_mm256_store_pd( &D[(ii+0+(jj+0)*ldd)*vl], d_00 );
+			_mm256_store_pd( &D[(ii+1+(jj+0)*ldd)*vl], d_10 );
+			_mm256_store_pd( &D[(ii+2+(jj+0)*ldd)*vl], d_20 );
+			_mm256_store_pd( &D[(ii+3+(jj+0)*ldd)*vl], d_30 );
+			_mm256_store_pd( &D[(ii+0+(jj+1)*ldd)*vl], d_01 );
+			_mm256_store_pd( &D[(ii+1+(jj+1)*ldd)*vl], d_11 );
+			_mm256_store_pd( &D[(ii+2+(jj+1)*ldd)*vl], d_21 );
+			_mm256_store_pd( &D[(ii+3+(jj+1)*ldd)*vl], d_31 );
+			}
+		for(; ii<m; ii++)
+			{
+			d_00 = _mm256_setzero_pd();
+			d_01 = _mm256_setzero_pd();
+			for(ll=0; ll<k; ll++)
+				{
+				a_0 = _mm256_load_pd( &A[(ii+ll*lda)*vl] );
+				d_00 = _mm256_fmadd_pd( a_0, _mm256_load_pd( &B[(jj+0+ll*ldb)*vl] ), d_00 );
+				d_01 = _mm256_fmadd_pd( a_0, _mm256_load_pd( &B[(jj+1+ll*ldb)*vl] ), d_01 );
+				}
+			d_00 = _mm256_mul_pd( alpha0, d_00 );
+			d_01 = _mm256_mul_pd( alpha0, d_01 );
+			if(beta[0]!=0.0)
+				{
+				d_00 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+(jj+0)*ldc)*vl] ), d_00 );
+				d_01 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+(jj+1)*ldc)*vl] ), d_01 );
+				}
+			_mm256_store_pd( &D[(ii+(jj+0)*ldd)*vl], d_00 );
+			_mm256_store_pd( &D[(ii+(jj+1)*ldd)*vl], d_01 );
+			}
+		}
+	for(; jj<n; jj++)
+		{
+		ii = 0;
+		for(; ii<m-3; ii+=4)
+			{
+			d_00 = _mm256_setzero_pd();
+			d_10 = _mm256_setzero_pd();
+			d_20 = _mm256_setzero_pd();
+			d_30 = _mm256_setzero_pd();
+			for(ll=0; ll<k; ll++)
+				{
+				b_0 = _mm256_load_pd( &B[(jj+ll*ldb)*vl] );
+				d_00 = _mm256_fmadd_pd( _mm256_load_pd( &A[(ii+0+ll*lda)*vl] ), b_0, d_00 );
+				d_10 = _mm256_fmadd_pd( _mm256_load_pd( &A[(ii+1+ll*lda)*vl] ), b_0, d_10 );
+				d_20 = _mm256_fmadd_pd( _mm256_load_pd( &A[(ii+2+ll*lda)*vl] ), b_0, d_20 );
+				d_30 = _mm256_fmadd_pd( _mm256_load_pd( &A[(ii+3+ll*lda)*vl] ), b_0, d_30 );
+				}
+			d_00 = _mm256_mul_pd( alpha0, d_00 );
+			d_10 = _mm256_mul_pd( alpha0, d_10 );
+			d_20 = _mm256_mul_pd( alpha0, d_20 );
+			d_30 = _mm256_mul_pd( alpha0, d_30 );
+			if(beta[0]!=0.0)
+				{
+				d_00 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+0+jj*ldc)*vl] ), d_00 );
+				d_10 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+1+jj*ldc)*vl] ), d_10 );
+				d_20 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+2+jj*ldc)*vl] ), d_20 );
+				d_30 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+3+jj*ldc)*vl] ), d_30 );
+				}
+			_mm256_store_pd( &D[(ii+0+jj*ldd)*vl], d_00 );
+			_mm256_store_pd( &D[(ii+1+jj*ldd)*vl], d_10 );
+			_mm256_store_pd( &D[(ii+2+jj*ldd)*vl], d_20 );
+			_mm256_store_pd( &D[(ii+3+jj*ldd)*vl], d_30 );
+			}
+		for(; ii<m; ii++)
+			{
+			d_00 = _mm256_setzero_pd();
+			for(ll=0; ll<k; ll++)
+				{
+				d_00 = _mm256_fmadd_pd( _mm256_load_pd( &A[(ii+ll*lda)*vl] ), _mm256_load_pd( &B[(jj+ll*ldb)*vl] ), d_00 );
+				}
+			d_00 = _mm256_mul_pd( alpha0, d_00 );
+			if(beta[0]!=0.0)
+				{
+				d_00 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+jj*ldc)*vl] ), d_00 );
+				}
+			_mm256_store_pd( &D[(ii+jj*ldd)*vl], d_00 );
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// D <= beta * C + alpha * A * B
+void kernel_dgemm_nn_compact_lib4(int m, int n, int k, double *alpha, double *A, int lda, double *B, int ldb, double *beta, double *C, int ldc, double *D, int ldd)
+	{
+
+	const int vl = 4;
+
+	int ii, jj, ll;
+
+	__m256d
+		a_0, a_1, a_2, a_3,
+		b_0, b_1,
+		d_00, d_10, d_20, d_30,
+		d_01, d_11, d_21, d_31,
+		alpha0, beta0;
+
+	alpha0 = _mm256_broadcast_sd( alpha );
+	beta0 = _mm256_broadcast_sd( beta );
+
+	jj = 0;
+	for(; jj<n-1; jj+=2)
+		{
+		ii = 0;
+		for(; ii<m-3; ii+=4)
+			{
+			d_00 = _mm256_setzero_pd();
+			d_10 = _mm256_setzero_pd();
+			d_20 = _mm256_setzero_pd();
+			d_30 = _mm256_setzero_pd();
+			d_01 = _mm256_setzero_pd();
+			d_11 = _mm256_setzero_pd();
+			d_21 = _mm256_setzero_pd();
+			d_31 = _mm256_setzero_pd();
+			for(ll=0; ll<k; ll++)
+				{
+				b_0 = _mm256_load_pd( &B[(ll+(jj+0)*ldb)*vl] );
+				b_1 = _mm256_load_pd( &B[(ll+(jj+1)*ldb)*vl] );
+				a_0 = _mm256_load_pd( &A[(ii+0+ll*lda)*vl] );
+				a_1 = _mm256_load_pd( &A[(ii+1+ll*lda)*vl] );
+				a_2 = _mm256_load_pd( &A[(ii+2+ll*lda)*vl] );
+				a_3 = _mm256_load_pd( &A[(ii+3+ll*lda)*vl] );
+				d_00 = _mm256_fmadd_pd( a_0, b_0, d_00 );
+				d_10 = _mm256_fmadd_pd( a_1, b_0, d_10 );
+				d_20 = _mm256_fmadd_pd( a_2, b_0, d_20 );
+				d_30 = _mm256_fmadd_pd( a_3, b_0, d_30 );
+				d_01 = _mm256_fmadd_pd( a_0, b_1, d_01 );
+				d_11 = _mm256_fmadd_pd( a_1, b_1, d_11 );
+				d_21 = _mm256_fmadd_pd( a_2, b_1, d_21 );
+				d_31 = _mm256_fmadd_pd( a_3, b_1, d_31 );
+				}
+			d_00 = _mm256_mul_pd( alpha0, d_00 );
+			d_10 = _mm256_mul_pd( alpha0, d_10 );
+			d_20 = _mm256_mul_pd( alpha0, d_20 );
+			d_30 = _mm256_mul_pd( alpha0, d_30 );
+			d_01 = _mm256_mul_pd( alpha0, d_01 );
+			d_11 = _mm256_mul_pd( alpha0, d_11 );
+			d_21 = _mm256_mul_pd( alpha0, d_21 );
+			d_31 = _mm256_mul_pd( alpha0, d_31 );
+			if(beta[0]!=0.0)
+				{
+				d_00 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+0+(jj+0)*ldc)*vl] ), d_00 );
+				d_10 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+1+(jj+0)*ldc)*vl] ), d_10 );
+				d_20 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+2+(jj+0)*ldc)*vl] ), d_20 );
+				d_30 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+3+(jj+0)*ldc)*vl] ), d_30 );
+				d_01 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+0+(jj+1)*ldc)*vl] ), d_01 );
+				d_11 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+1+(jj+1)*ldc)*vl] ), d_11 );
+				d_21 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+2+(jj+1)*ldc)*vl] ), d_21 );
+				d_31 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+3+(jj+1)*ldc)*vl] ), d_31 );
+				}
+			_mm256_store_pd( &D[(ii+0+(jj+0)*ldd)*vl], d_00 );
+			_mm256_store_pd( &D[(ii+1+(jj+0)*ldd)*vl], d_10 );
+			_mm256_store_pd( &D[(ii+2+(jj+0)*ldd)*vl], d_20 );
+			_mm256_store_pd( &D[(ii+3+(jj+0)*ldd)*vl], d_30 );
+			_mm256_store_pd( &D[(ii+0+(jj+1)*ldd)*vl], d_01 );
+			_mm256_store_pd( &D[(ii+1+(jj+1)*ldd)*vl], d_11 );
+			_mm256_store_pd( &D[(ii+2+(jj+1)*ldd)*vl], d_21 );
+			_mm256_store_pd( &D[(ii+3+(jj+1)*ldd)*vl], d_31 );
+			}
+		for(; ii<m; ii++)
+			{
+			d_00 = _mm256_setzero_pd();
+			d_01 = _mm256_setzero_pd();
+			for(ll=0; ll<k; ll++)
+				{
+				a_0 = _mm256_load_pd( &A[(ii+ll*lda)*vl] );
+				d_00 = _mm256_fmadd_pd( a_0, _mm256_load_pd( &B[(ll+(jj+0)*ldb)*vl] ), d_00 );
+				d_01 = _mm256_fmadd_pd( a_0, _mm256_load_pd( &B[(ll+(jj+1)*ldb)*vl] ), d_01 );
+				}
+			d_00 = _mm256_mul_pd( alpha0, d_00 );
+			d_01 = _mm256_mul_pd( alpha0, d_01 );
+			if(beta[0]!=0.0)
+				{
+				d_00 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+(jj+0)*ldc)*vl] ), d_00 );
+				d_01 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+(jj+1)*ldc)*vl] ), d_01 );
+				}
+			_mm256_store_pd( &D[(ii+(jj+0)*ldd)*vl], d_00 );
+			_mm256_store_pd( &D[(ii+(jj+1)*ldd)*vl], d_01 );
+			}
+		}
+	for(; jj<n; jj++)
+		{
+		ii = 0;
+		for(; ii<m-3; ii+=4)
+			{
+			d_00 = _mm256_setzero_pd();
+			d_10 = _mm256_setzero_pd();
+			d_20 = _mm256_setzero_pd();
+			d_30 = _mm256_setzero_pd();
+			for(ll=0; ll<k; ll++)
+				{
+				b_0 = _mm256_load_pd( &B[(ll+jj*ldb)*vl] );
+				d_00 = _mm256_fmadd_pd( _mm256_load_pd( &A[(ii+0+ll*lda)*vl] ), b_0, d_00 );
+				d_10 = _mm256_fmadd_pd( _mm256_load_pd( &A[(ii+1+ll*lda)*vl] ), b_0, d_10 );
+				d_20 = _mm256_fmadd_pd( _mm256_load_pd( &A[(ii+2+ll*lda)*vl] ), b_0, d_20 );
+				d_30 = _mm256_fmadd_pd( _mm256_load_pd( &A[(ii+3+ll*lda)*vl] ), b_0, d_30 );
+				}
+			d_00 = _mm256_mul_pd( alpha0, d_00 );
+			d_10 = _mm256_mul_pd( alpha0, d_10 );
+			d_20 = _mm256_mul_pd( alpha0, d_20 );
+			d_30 = _mm256_mul_pd( alpha0, d_30 );
+			if(beta[0]!=0.0)
+				{
+				d_00 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+0+jj*ldc)*vl] ), d_00 );
+				d_10 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+1+jj*ldc)*vl] ), d_10 );
+				d_20 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+2+jj*ldc)*vl] ), d_20 );
+				d_30 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+3+jj*ldc)*vl] ), d_30 );
+				}
+			_mm256_store_pd( &D[(ii+0+jj*ldd)*vl], d_00 );
+			_mm256_store_pd( &D[(ii+1+jj*ldd)*vl], d_10 );
+			_mm256_store_pd( &D[(ii+2+jj*ldd)*vl], d_20 );
+			_mm256_store_pd( &D[(ii+3+jj*ldd)*vl], d_30 );
+			}
+		for(; ii<m; ii++)
+			{
+			d_00 = _mm256_setzero_pd();
+			for(ll=0; ll<k; ll++)
+				{
+				d_00 = _mm256_fmadd_pd( _mm256_load_pd( &A[(ii+ll*lda)*vl] ), _mm256_load_pd( &B[(ll+jj*ldb)*vl] ), d_00 );
+				}
+			d_00 = _mm256_mul_pd( alpha0, d_00 );
+			if(beta[0]!=0.0)
+				{
+				d_00 = _mm256_fmadd_pd( beta0, _mm256_load_pd( &C[(ii+jj*ldc)*vl] ), d_00 );
+				}
+			_mm256_store_pd( &D[(ii+jj*ldd)*vl], d_00 );
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// D <= alpha * B * A^{-T} , with A lower triangular
+void kernel_dtrsm_nt_rl_inv_compact_lib4(int m, int n, double *alpha, double *A, int lda, double *B, int ldb, double *D, int ldd)
+	{
+
+	const int vl = 4;
+
+	int ii, jj, ll;
+
+	__m256d
+		a_0, inv_0,
+		d_0, d_1, d_2, d_3,
+		alpha0, one0;
+
+	alpha0 = _mm256_broadcast_sd( alpha );
+	one0 = _mm256_set1_pd( 1.0 );
+
+	for(jj=0; jj<n; jj++)
+		{
+		inv_0 = _mm256_div_pd( one0, _mm256_load_pd( &A[(jj+jj*lda)*vl] ) );
+		ii = 0;
+		for(; ii<m-3; ii+=4)
+			{
+			d_0 = _mm256_mul_pd( alpha0, _mm256_load_pd( &B[(ii+0+jj*ldb)*vl] ) );
+			d_1 = _mm256_mul_pd( alpha0, _mm256_load_pd( &B[(ii+1+jj*ldb)*vl] ) );
+			d_2 = _mm256_mul_pd( alpha0, _mm256_load_pd( &B[(ii+2+jj*ldb)*vl] ) );
+			d_3 = _mm256_mul_pd( alpha0, _mm256_load_pd( &B[(ii+3+jj*ldb)*vl] ) );
+			for(ll=0; ll<jj; ll++)
+				{
+				a_0 = _mm256_load_pd( &A[(jj+ll*lda)*vl] );
+				d_0 = _mm256_fnmadd_pd( _mm256_load_pd( &D[(ii+0+ll*ldd)*vl] ), a_0, d_0 );
+				d_1 = _mm256_fnmadd_pd( _mm256_load_pd( &D[(ii+1+ll*ldd)*vl] ), a_0, d_1 );
+				d_2 = _mm256_fnmadd_pd( _mm256_load_pd( &D[(ii+2+ll*ldd)*vl] ), a_0, d_2 );
+				d_3 = _mm256_fnmadd_pd( _mm256_load_pd( &D[(ii+3+ll*ldd)*vl] ), a_0, d_3 );
+				}
+			_mm256_store_pd( &D[(ii+0+jj*ldd)*vl], _mm256_mul_pd( d_0, inv_0 ) );
+			_mm256_store_pd( &D[(ii+1+jj*ldd)*vl], _mm256_mul_pd( d_1, inv_0 ) );
+			_mm256_store_pd( &D[(ii+2+jj*ldd)*vl], _mm256_mul_pd( d_2, inv_0 ) );
+			_mm256_store_pd( &D[(ii+3+jj*ldd)*vl], _mm256_mul_pd( d_3, inv_0 ) );
+			}
+		for(; ii<m; ii++)
+			{
+			d_0 = _mm256_mul_pd( alpha0, _mm256_load_pd( &B[(ii+jj*ldb)*vl] ) );
+			for(ll=0; ll<jj; ll++)
+				{
+				d_0 = _mm256_fnmadd_pd( _mm256_load_pd( &D[(ii+ll*ldd)*vl] ), _mm256_load_pd( &A[(jj+ll*lda)*vl] ), d_0 );
+				}
+			_mm256_store_pd( &D[(ii+jj*ldd)*vl], _mm256_mul_pd( d_0, inv_0 ) );
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// D <= chol( C ) , lower triangular; non-positive pivots give a zero column
+void kernel_dpotrf_l_compact_lib4(int m, double *C, int ldc, double *D, int ldd)
+	{
+
+	const int vl = 4;
+
+	int ii, jj, ll;
+
+	__m256d
+		d_0, d_1, d_2, d_3,
+		b_0, inv_0, mask_0,
+		zero0, one0;
+
+	zero0 = _mm256_setzero_pd();
+	one0 = _mm256_set1_pd( 1.0 );
+
+	for(jj=0; jj<m; jj++)
+		{
+		// diagonal element
+		d_0 = _mm256_load_pd( &C[(jj+jj*ldc)*vl] );
+		for(ll=0; ll<jj; ll++)
+			{
+			b_0 = _mm256_load_pd( &D[(jj+ll*ldd)*vl] );
+			d_0 = _mm256_fnmadd_pd( b_0, b_0, d_0 );
+			}
+		mask_0 = _mm256_cmp_pd( d_0, zero0, _CMP_GT_OQ );
+		d_0 = _mm256_and_pd( mask_0, _mm256_sqrt_pd( d_0 ) );
+		inv_0 = _mm256_and_pd( mask_0, _mm256_div_pd( one0, d_0 ) );
+		_mm256_store_pd( &D[(jj+jj*ldd)*vl], d_0 );
+		// column below the diagonal
+		ii = jj+1;
+		for(; ii<m-3; ii+=4)
+			{
+			d_0 = _mm256_load_pd( &C[(ii+0+jj*ldc)*vl] );
+			d_1 = _mm256_load_pd( &C[(ii+1+jj*ldc)*vl] );
+			d_2 = _mm256_load_pd( &C[(ii+2+jj*ldc)*vl] );
+			d_3 = _mm256_load_pd( &C[(ii+3+jj*ldc)*vl] );
+			for(ll=0; ll<jj; ll++)
+				{
+				b_0 = _mm256_load_pd( &D[(jj+ll*ldd)*vl] );
+				d_0 = _mm256_fnmadd_pd( _mm256_load_pd( &D[(ii+0+ll*ldd)*vl] ), b_0, d_0 );
+				d_1 = _mm256_fnmadd_pd( _mm256_load_pd( &D[(ii+1+ll*ldd)*vl] ), b_0, d_1 );
+				d_2 = _mm256_fnmadd_pd( _mm256_load_pd( &D[(ii+2+ll*ldd)*vl] ), b_0, d_2 );
+				d_3 = _mm256_fnmadd_pd( _mm256_load_pd( &D[(ii+3+ll*ldd)*vl] ), b_0, d_3 );
+				}
+			_mm256_store_pd( &D[(ii+0+jj*ldd)*vl], _mm256_mul_pd( d_0, inv_0 ) );
+			_mm256_store_pd( &D[(ii+1+jj*ldd)*vl], _mm256_mul_pd( d_1, inv_0 ) );
+			_mm256_store_pd( &D[(ii+2+jj*ldd)*vl], _mm256_mul_pd( d_2, inv_0 ) );
+			_mm256_store_pd( &D[(ii+3+jj*ldd)*vl], _mm256_mul_pd( d_3, inv_0 ) );
+			}
+		for(; ii<m; ii++)
+			{
+			d_0 = _mm256_load_pd( &C[(ii+jj*ldc)*vl] );
+			for(ll=0; ll<jj; ll++)
+				{
+				d_0 = _mm256_fnmadd_pd( _mm256_load_pd( &D[(ii+ll*ldd)*vl] ), _mm256_load_pd( &D[(jj+ll*ldd)*vl] ), d_0 );
+				}
+			_mm256_store_pd( &D[(ii+jj*ldd)*vl], _mm256_mul_pd( d_0, inv_0 ) );
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// D <= lu( C ) , no pivoting; L has unit diagonal, U is stored on and above the diagonal
+void kernel_dgetrf_np_compact_lib4(int m, int n, double *C, int ldc, double *D, int ldd)
+	{
+
+	const int vl = 4;
+
+	int ii, jj, ll;
+	int p = m<n ? m : n;
+
+	__m256d
+		d_0, d_1, d_2, d_3,
+		b_0, inv_0,
+		one0;
+
+	one0 = _mm256_set1_pd( 1.0 );
+
+	// left-looking (Crout-like) variant, one column at a time
+	for(jj=0; jj<n; jj++)
+		{
+		// upper part: solve with the unit lower triangular factor
+		for(ii=0; ii<jj & ii<m; ii++)
+			{
+			d_0 = _mm256_load_pd( &C[(ii+jj*ldc)*vl] );
+			for(ll=0; ll<ii; ll++)
+				{
+				d_0 = _mm256_fnmadd_pd( _mm256_load_pd( &D[(ii+ll*ldd)*vl] ), _mm256_load_pd( &D[(ll+jj*ldd)*vl] ), d_0 );
+				}
+			_mm256_store_pd( &D[(ii+jj*ldd)*vl], d_0 );
+			}
+		if(jj>=p)
+			continue;
+		// diagonal element
+		d_0 = _mm256_load_pd( &C[(jj+jj*ldc)*vl] );
+		for(ll=0; ll<jj; ll++)
+			{
+			d_0 = _mm256_fnmadd_pd( _mm256_load_pd( &D[(jj+ll*ldd)*vl] ), _mm256_load_pd( &D[(ll+jj*ldd)*vl] ), d_0 );
+			}
+		_mm256_store_pd( &D[(jj+jj*ldd)*vl], d_0 );
+		inv_0 = _mm256_div_pd( one0, d_0 );
+		// lower part
+		ii = jj+1;
+		for(; ii<m-3; ii+=4)
+			{
+			d_0 = _mm256_load_pd( &C[(ii+0+jj*ldc)*vl] );
+			d_1 = _mm256_load_pd( &C[(ii+1+jj*ldc)*vl] );
+			d_2 = _mm256_load_pd( &C[(ii+2+jj*ldc)*vl] );
+			d_3 = _mm256_load_pd( &C[(ii+3+jj*ldc)*vl] );
+			for(ll=0; ll<jj; ll++)
+				{
+				b_0 = _mm256_load_pd( &D[(ll+jj*ldd)*vl] );
+				d_0 = _mm256_fnmadd_pd( _mm256_load_pd( &D[(ii+0+ll*ldd)*vl] ), b_0, d_0 );
+				d_1 = _mm256_fnmadd_pd( _mm256_load_pd( &D[(ii+1+ll*ldd)*vl] ), b_0, d_1 );
+				d_2 = _mm256_fnmadd_pd( _mm256_load_pd( &D[(ii+2+ll*ldd)*vl] ), b_0, d_2 );
+				d_3 = _mm256_fnmadd_pd( _mm256_load_pd( &D[(ii+3+ll*ldd)*vl] ), b_0, d_3 );
+				}
+			_mm256_store_pd( &D[(ii+0+jj*ldd)*vl], _mm256_mul_pd( d_0, inv_0 ) );
+			_mm256_store_pd( &D[(ii+1+jj*ldd)*vl], _mm256_mul_pd( d_1, inv_0 ) );
+			_mm256_store_pd( &D[(ii+2+jj*ldd)*vl], _mm256_mul_pd( d_2, inv_0 ) );
+			_mm256_store_pd( &D[(ii+3+jj*ldd)*vl], _mm256_mul_pd( d_3, inv_0 ) );
+			}
+		for(; ii<m; ii++)
+			{
+			d_0 = _mm256_load_pd( &C[(ii+jj*ldc)*vl] );
+			for(ll=0; ll<jj; ll++)
+				{
+				d_0 = _mm256_fnmadd_pd( _mm256_load_pd( &D[(ii+ll*ldd)*vl] ), _mm256_load_pd( &D[(ll+jj*ldd)*vl] ), d_0 );
+				}
+			_mm256_store_pd( &D[(ii+jj*ldd)*vl], _mm256_mul_pd( d_0, inv_0 ) );
+			}
+		}
+
+	return;
+
+	}
@@ -0,0 +1,382 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+
+#include <mmintrin.h>
+#include <xmmintrin.h>  // SSE
+#include <emmintrin.h>  // SSE2
+#include <pmmintrin.h>  // SSE3
+#include <smmintrin.h>  // SSE4
+#include <immintrin.h>  // AVX
+
+#include "../../include/blasfeo_common.h"
+#include "../../include/blasfeo_block_size.h"
+#include "../../include/blasfeo_s_kernel.h"
+
+
+
+// kernels with the A operand in half precision (panels of 8 rows of fp16 elements, converted to fp32 with F16C
+// on load) and B, C, D in single precision (panels of S_PS rows); all arithmetic is in single precision
+
+
+
+// D <= beta * C + alpha * A * B^T
+void kernel_hgemm_nt_8x4_lib8(int k, float *alpha, unsigned short *A, float *B, float *beta, float *C, float *D)
+	{
+
+	const int ps = S_PS;
+
+	__m256
+		a_0, a_1,
+		d_0, d_1, d_2, d_3,
+		e_0, e_1, e_2, e_3,
+		tmp;
+
+	d_0 = _mm256_setzero_ps();
+	d_1 = _mm256_setzero_ps();
+	d_2 = _mm256_setzero_ps();
+	d_3 = _mm256_setzero_ps();
+	e_0 = _mm256_setzero_ps();
+	e_1 = _mm256_setzero_ps();
+	e_2 = _mm256_setzero_ps();
+	e_3 = _mm256_setzero_ps();
+
+	int kk;
+
+	// two sets of accumulators to hide the fma latency
+	for(kk=0; kk<k-1; kk+=2)
+		{
+		a_0 = _mm256_cvtph_ps(_mm_loadu_si128((__m128i *) &A[0]));
+		a_1 = _mm256_cvtph_ps(_mm_loadu_si128((__m128i *) &A[8]));
+		d_0 = _mm256_fmadd_ps(a_0, _mm256_broadcast_ss(&B[0]), d_0);
+		d_1 = _mm256_fmadd_ps(a_0, _mm256_broadcast_ss(&B[1]), d_1);
+		d_2 = _mm256_fmadd_ps(a_0, _mm256_broadcast_ss(&B[2]), d_2);
+		d_3 = _mm256_fmadd_ps(a_0, _mm256_broadcast_ss(&B[3]), d_3);
+		e_0 = _mm256_fmadd_ps(a_1, _mm256_broadcast_ss(&B[ps+0]), e_0);
+		e_1 = _mm256_fmadd_ps(a_1, _mm256_broadcast_ss(&B[ps+1]), e_1);
+		e_2 = _mm256_fmadd_ps(a_1, _mm256_broadcast_ss(&B[ps+2]), e_2);
+		e_3 = _mm256_fmadd_ps(a_1, _mm256_broadcast_ss(&B[ps+3]), e_3);
+		A += 16;
+		B += 2*ps;
+		}
+	for(; kk<k; kk++)
+		{
+		a_0 = _mm256_cvtph_ps(_mm_loadu_si128((__m128i *) &A[0]));
+		d_0 = _mm256_fmadd_ps(a_0, _mm256_broadcast_ss(&B[0]), d_0);
+		d_1 = _mm256_fmadd_ps(a_0, _mm256_broadcast_ss(&B[1]), d_1);
+		d_2 = _mm256_fmadd_ps(a_0, _mm256_broadcast_ss(&B[2]), d_2);
+		d_3 = _mm256_fmadd_ps(a_0, _mm256_broadcast_ss(&B[3]), d_3);
+		A += 8;
+		B += ps;
+		}
+
+	d_0 = _mm256_add_ps(d_0, e_0);
+	d_1 = _mm256_add_ps(d_1, e_1);
+	d_2 = _mm256_add_ps(d_2, e_2);
+	d_3 = _mm256_add_ps(d_3, e_3);
+
+	tmp = _mm256_broadcast_ss(alpha);
+	d_0 = _mm256_mul_ps(tmp, d_0);
+	d_1 = _mm256_mul_ps(tmp, d_1);
+	d_2 = _mm256_mul_ps(tmp, d_2);
+	d_3 = _mm256_mul_ps(tmp, d_3);
+
+	if(*beta!=0.0f)
+		{
+		tmp = _mm256_broadcast_ss(beta);
+		d_0 = _mm256_fmadd_ps(tmp, _mm256_loadu_ps(&C[0*ps]), d_0);
+		d_1 = _mm256_fmadd_ps(tmp, _mm256_loadu_ps(&C[1*ps]), d_1);
+		d_2 = _mm256_fmadd_ps(tmp, _mm256_loadu_ps(&C[2*ps]), d_2);
+		d_3 = _mm256_fmadd_ps(tmp, _mm256_loadu_ps(&C[3*ps]), d_3);
+		}
+
+	_mm256_storeu_ps(&D[0*ps], d_0);
+	_mm256_storeu_ps(&D[1*ps], d_1);
+	_mm256_storeu_ps(&D[2*ps], d_2);
+	_mm256_storeu_ps(&D[3*ps], d_3);
+
+	return;
+
+	}
+
+
+
+// D <= beta * C + alpha * A * B^T, storing only the upper-left km x kn block
+void kernel_hgemm_nt_8x4_vs_lib8(int k, float *alpha, unsigned short *A, float *B, float *beta, float *C, float *D, int km, int kn)
+	{
+
+	const int ps = S_PS;
+
+	float CD[8*4] __attribute__ ((aligned (32))) = {0};
+
+	int ii, jj;
+
+	km = km<8 ? km : 8;
+	kn = kn<4 ? kn : 4;
+
+	// copy the valid part of C, as the rows and columns past km and kn may be outside of the matrix
+	if(*beta!=0.0f)
+		{
+		for(jj=0; jj<kn; jj++)
+			for(ii=0; ii<km; ii++)
+				CD[ii+8*jj] = C[ii+ps*jj];
+		}
+
+	// B and C are stored in panels of ps>=8 rows, so reading 4 rows of B is always in allocated memory;
+	// the local buffer has panel size 8, so the full kernel is used only if it matches the matrix panel size
+	if(ps==8)
+		{
+		kernel_hgemm_nt_8x4_lib8(k, alpha, A, B, beta, CD, CD);
+		}
+	else
+		{
+		__m256
+			a_0,
+			d_0, d_1, d_2, d_3,
+			tmp;
+		d_0 = _mm256_setzero_ps();
+		d_1 = _mm256_setzero_ps();
+		d_2 = _mm256_setzero_ps();
+		d_3 = _mm256_setzero_ps();
+		int kk;
+		for(kk=0; kk<k; kk++)
+			{
+			a_0 = _mm256_cvtph_ps(_mm_loadu_si128((__m128i *) &A[8*kk]));
+			d_0 = _mm256_fmadd_ps(a_0, _mm256_broadcast_ss(&B[0+ps*kk]), d_0);
+			d_1 = _mm256_fmadd_ps(a_0, _mm256_broadcast_ss(&B[1+ps*kk]), d_1);
+			d_2 = _mm256_fmadd_ps(a_0, _mm256_broadcast_ss(&B[2+ps*kk]), d_2);
+			d_3 = _mm256_fmadd_ps(a_0, _mm256_broadcast_ss(&B[3+ps*kk]), d_3);
+			}
+		tmp = _mm256_broadcast_ss(alpha);
+		d_0 = _mm256_mul_ps(tmp, d_0);
+		d_1 = _mm256_mul_ps(tmp, d_1);
+		d_2 = _mm256_mul_ps(tmp, d_2);
+		d_3 = _mm256_mul_ps(tmp, d_3);
+		tmp = _mm256_broadcast_ss(beta);
+		d_0 = _mm256_fmadd_ps(tmp, _mm256_load_ps(&CD[0]), d_0);
+		d_1 = _mm256_fmadd_ps(tmp, _mm256_load_ps(&CD[8]), d_1);
+		d_2 = _mm256_fmadd_ps(tmp, _mm256_load_ps(&CD[16]), d_2);
+		d_3 = _mm256_fmadd_ps(tmp, _mm256_load_ps(&CD[24]), d_3);
+		_mm256_store_ps(&CD[0], d_0);
+		_mm256_store_ps(&CD[8], d_1);
+		_mm256_store_ps(&CD[16], d_2);
+		_mm256_store_ps(&CD[24], d_3);
+		}
+
+	for(jj=0; jj<kn; jj++)
+		for(ii=0; ii<km; ii++)
+			D[ii+ps*jj] = CD[ii+8*jj];
+
+	return;
+
+	}
+
+
+
+// z <= beta * y + alpha * A * x, with A of size 8 x k
+void kernel_hgemv_n_8_lib8(int k, float *alpha, unsigned short *A, float *x, float *beta, float *y, float *z)
+	{
+
+	__m256
+		a_0, a_1,
+		d_0, d_1,
+		tmp;
+
+	d_0 = _mm256_setzero_ps();
+	d_1 = _mm256_setzero_ps();
+
+	int kk;
+
+	for(kk=0; kk<k-1; kk+=2)
+		{
+		a_0 = _mm256_cvtph_ps(_mm_loadu_si128((__m128i *) &A[0]));
+		a_1 = _mm256_cvtph_ps(_mm_loadu_si128((__m128i *) &A[8]));
+		d_0 = _mm256_fmadd_ps(a_0, _mm256_broadcast_ss(&x[0]), d_0);
+		d_1 = _mm256_fmadd_ps(a_1, _mm256_broadcast_ss(&x[1]), d_1);
+		A += 16;
+		x += 2;
+		}
+	for(; kk<k; kk++)
+		{
+		a_0 = _mm256_cvtph_ps(_mm_loadu_si128((__m128i *) &A[0]));
+		d_0 = _mm256_fmadd_ps(a_0, _mm256_broadcast_ss(&x[0]), d_0);
+		A += 8;
+		x += 1;
+		}
+
+	d_0 = _mm256_add_ps(d_0, d_1);
+	d_0 = _mm256_mul_ps(_mm256_broadcast_ss(alpha), d_0);
+	if(*beta!=0.0f)
+		{
+		tmp = _mm256_broadcast_ss(beta);
+		d_0 = _mm256_fmadd_ps(tmp, _mm256_loadu_ps(&y[0]), d_0);
+		}
+	_mm256_storeu_ps(&z[0], d_0);
+
+	return;
+
+	}
+
+
+
+// z <= beta * y + alpha * A * x, storing only the first km elements
+void kernel_hgemv_n_8_vs_lib8(int k, float *alpha, unsigned short *A, float *x, float *beta, float *y, float *z, int km)
+	{
+
+	float yz[8] __attribute__ ((aligned (32))) = {0};
+
+	int ii;
+
+	if(*beta!=0.0f)
+		{
+		for(ii=0; ii<km; ii++)
+			yz[ii] = y[ii];
+		}
+
+	kernel_hgemv_n_8_lib8(k, alpha, A, x, beta, yz, yz);
+
+	for(ii=0; ii<km; ii++)
+		z[ii] = yz[ii];
+
+	return;
+
+	}
+
+
+
+// z <= beta * y + alpha * A^T * x, with A of size k x kn (kn<=8) stored in panels of 8 rows with panel stride sda
+void kernel_hgemv_t_8_vs_lib8(int k, float *alpha, unsigned short *A, int sda, float *x, float *beta, float *y, float *z, int kn)
+	{
+
+	const int ps = 8;
+
+	__m256
+		a_0, x_0,
+		d_0, d_1, d_2, d_3, d_4, d_5, d_6, d_7,
+		mask;
+
+	d_0 = _mm256_setzero_ps();
+	d_1 = _mm256_setzero_ps();
+	d_2 = _mm256_setzero_ps();
+	d_3 = _mm256_setzero_ps();
+	d_4 = _mm256_setzero_ps();
+	d_5 = _mm256_setzero_ps();
+	d_6 = _mm256_setzero_ps();
+	d_7 = _mm256_setzero_ps();
+
+	float xx[8] __attribute__ ((aligned (32)));
+	float ii_f[8] __attribute__ ((aligned (32))) = {0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f};
+
+	int kk, ii;
+
+	// the columns past kn are not read, as they may be outside of the matrix
+#define HGEMV_T_COL(jj, d) \
+	if(kn>jj) \
+		{ \
+		a_0 = _mm256_cvtph_ps(_mm_loadu_si128((__m128i *) &A[jj*ps])); \
+		d = _mm256_fmadd_ps(_mm256_and_ps(a_0, mask), x_0, d); \
+		}
+
+	for(kk=0; kk<k; kk+=ps)
+		{
+		if(k-kk>=ps)
+			{
+			x_0 = _mm256_loadu_ps(&x[kk]);
+			mask = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			}
+		else
+			{
+			// zero the rows past k in both x and A, so that non-finite values there do not propagate
+			for(ii=0; ii<k-kk; ii++)
+				xx[ii] = x[kk+ii];
+			for(; ii<ps; ii++)
+				xx[ii] = 0.0f;
+			x_0 = _mm256_load_ps(xx);
+			mask = _mm256_cmp_ps(_mm256_load_ps(ii_f), _mm256_set1_ps((float) (k-kk)), _CMP_LT_OQ);
+			}
+		HGEMV_T_COL(0, d_0)
+		HGEMV_T_COL(1, d_1)
+		HGEMV_T_COL(2, d_2)
+		HGEMV_T_COL(3, d_3)
+		HGEMV_T_COL(4, d_4)
+		HGEMV_T_COL(5, d_5)
+		HGEMV_T_COL(6, d_6)
+		HGEMV_T_COL(7, d_7)
+		A += ps*sda;
+		}
+
+#undef HGEMV_T_COL
+
+	// reduce the 8 accumulators into one vector with the 8 results
+	d_0 = _mm256_hadd_ps(d_0, d_1);
+	d_2 = _mm256_hadd_ps(d_2, d_3);
+	d_4 = _mm256_hadd_ps(d_4, d_5);
+	d_6 = _mm256_hadd_ps(d_6, d_7);
+	d_0 = _mm256_hadd_ps(d_0, d_2);
+	d_4 = _mm256_hadd_ps(d_4, d_6);
+	d_1 = _mm256_permute2f128_ps(d_0, d_4, 0x20);
+	d_3 = _mm256_permute2f128_ps(d_0, d_4, 0x31);
+	d_0 = _mm256_add_ps(d_1, d_3);
+
+	d_0 = _mm256_mul_ps(_mm256_broadcast_ss(alpha), d_0);
+
+	float yz[8] __attribute__ ((aligned (32)));
+	_mm256_store_ps(yz, d_0);
+
+	if(*beta!=0.0f)
+		{
+		for(ii=0; ii<kn; ii++)
+			z[ii] = beta[0]*y[ii] + yz[ii];
+		}
+	else
+		{
+		for(ii=0; ii<kn; ii++)
+			z[ii] = yz[ii];
+		}
+
+	return;
+
+	}
+
+
+
+// z <= beta * y + alpha * A^T * x, with A of size k x 8 stored in panels of 8 rows with panel stride sda
+void kernel_hgemv_t_8_lib8(int k, float *alpha, unsigned short *A, int sda, float *x, float *beta, float *y, float *z)
+	{
+	kernel_hgemv_t_8_vs_lib8(k, alpha, A, sda, x, beta, y, z, 8);
+	return;
+	}
+
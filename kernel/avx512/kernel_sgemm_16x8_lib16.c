@@ -0,0 +1,918 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+
+#include <mmintrin.h>
+#include <xmmintrin.h>  // SSE
+#include <emmintrin.h>  // SSE2
+#include <pmmintrin.h>  // SSE3
+#include <smmintrin.h>  // SSE4
+#include <immintrin.h>  // AVX
+
+#include <blasfeo_common.h>
+#include <blasfeo_s_kernel.h>
+
+
+
+// mask selecting the first km rows of a 16-wide panel
+static __mmask16 kernel_smask_16_lib16(int km)
+	{
+	return km>=16 ? (__mmask16) 0xffff : (__mmask16) ((1<<km)-1);
+	}
+
+
+
+// broadcast of the element ii of the vector v
+static __m512 kernel_sbcast_16_lib16(__m512 v, int ii)
+	{
+	return _mm512_permutexvar_ps(_mm512_set1_epi32(ii), v);
+	}
+
+
+
+
+// D = alpha * A * B^T + beta * C, on the rows selected by ma and the first kn columns;
+// if lower!=0 only the lower triangle (row>=column) is stored
+static void kernel_sgemm_nt_16x8_mask_lib16(int k, float *alpha, float *A, float *B, float *beta, float *C, float *D, __mmask16 ma, int kn, int lower)
+	{
+	__m512
+		d_00, d_01, d_02, d_03, d_04, d_05, d_06, d_07,
+		a_0, b_0, tmp;
+
+	d_00 = _mm512_setzero_ps();
+	d_01 = _mm512_setzero_ps();
+	d_02 = _mm512_setzero_ps();
+	d_03 = _mm512_setzero_ps();
+	d_04 = _mm512_setzero_ps();
+	d_05 = _mm512_setzero_ps();
+	d_06 = _mm512_setzero_ps();
+	d_07 = _mm512_setzero_ps();
+
+	int kk;
+
+	for(kk=0; kk<k; kk++)
+		{
+		a_0 = _mm512_maskz_loadu_ps(ma, &A[0]);
+		b_0 = _mm512_set1_ps(B[0]);
+		d_00 = _mm512_fmadd_ps(a_0, b_0, d_00);
+		b_0 = _mm512_set1_ps(B[1]);
+		d_01 = _mm512_fmadd_ps(a_0, b_0, d_01);
+		b_0 = _mm512_set1_ps(B[2]);
+		d_02 = _mm512_fmadd_ps(a_0, b_0, d_02);
+		b_0 = _mm512_set1_ps(B[3]);
+		d_03 = _mm512_fmadd_ps(a_0, b_0, d_03);
+		b_0 = _mm512_set1_ps(B[4]);
+		d_04 = _mm512_fmadd_ps(a_0, b_0, d_04);
+		b_0 = _mm512_set1_ps(B[5]);
+		d_05 = _mm512_fmadd_ps(a_0, b_0, d_05);
+		b_0 = _mm512_set1_ps(B[6]);
+		d_06 = _mm512_fmadd_ps(a_0, b_0, d_06);
+		b_0 = _mm512_set1_ps(B[7]);
+		d_07 = _mm512_fmadd_ps(a_0, b_0, d_07);
+		A += 16;
+		B += 16;
+		}
+
+	tmp = _mm512_set1_ps(alpha[0]);
+	d_00 = _mm512_mul_ps(tmp, d_00);
+	d_01 = _mm512_mul_ps(tmp, d_01);
+	d_02 = _mm512_mul_ps(tmp, d_02);
+	d_03 = _mm512_mul_ps(tmp, d_03);
+	d_04 = _mm512_mul_ps(tmp, d_04);
+	d_05 = _mm512_mul_ps(tmp, d_05);
+	d_06 = _mm512_mul_ps(tmp, d_06);
+	d_07 = _mm512_mul_ps(tmp, d_07);
+
+	if(beta[0]!=0.0)
+		{
+		tmp = _mm512_set1_ps(beta[0]);
+		d_00 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>0 ? ma : 0, &C[0+16*0]), d_00);
+		d_01 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>1 ? ma : 0, &C[0+16*1]), d_01);
+		d_02 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>2 ? ma : 0, &C[0+16*2]), d_02);
+		d_03 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>3 ? ma : 0, &C[0+16*3]), d_03);
+		d_04 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>4 ? ma : 0, &C[0+16*4]), d_04);
+		d_05 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>5 ? ma : 0, &C[0+16*5]), d_05);
+		d_06 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>6 ? ma : 0, &C[0+16*6]), d_06);
+		d_07 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>7 ? ma : 0, &C[0+16*7]), d_07);
+		}
+
+	if(kn>0) _mm512_mask_storeu_ps(&D[0+16*0], lower ? ma & (__mmask16) (0xffff<<0) : ma, d_00);
+	if(kn>1) _mm512_mask_storeu_ps(&D[0+16*1], lower ? ma & (__mmask16) (0xffff<<1) : ma, d_01);
+	if(kn>2) _mm512_mask_storeu_ps(&D[0+16*2], lower ? ma & (__mmask16) (0xffff<<2) : ma, d_02);
+	if(kn>3) _mm512_mask_storeu_ps(&D[0+16*3], lower ? ma & (__mmask16) (0xffff<<3) : ma, d_03);
+	if(kn>4) _mm512_mask_storeu_ps(&D[0+16*4], lower ? ma & (__mmask16) (0xffff<<4) : ma, d_04);
+	if(kn>5) _mm512_mask_storeu_ps(&D[0+16*5], lower ? ma & (__mmask16) (0xffff<<5) : ma, d_05);
+	if(kn>6) _mm512_mask_storeu_ps(&D[0+16*6], lower ? ma & (__mmask16) (0xffff<<6) : ma, d_06);
+	if(kn>7) _mm512_mask_storeu_ps(&D[0+16*7], lower ? ma & (__mmask16) (0xffff<<7) : ma, d_07);
+
+	return;
+
+	}
+
+
+
+// D = alpha * A * B^T + beta * C, on the first km rows and kn columns of a 32x8 block
+static void kernel_sgemm_nt_32x8_mask_lib16(int k, float *alpha, float *A, int sda, float *B, float *beta, float *C, int sdc, float *D, int sdd, int km, int kn)
+	{
+	__m512
+		d_00, d_01, d_02, d_03, d_04, d_05, d_06, d_07, d_10, d_11, d_12, d_13, d_14, d_15, d_16, d_17,
+		a_0, a_1, b_0, tmp;
+
+	d_00 = _mm512_setzero_ps();
+	d_01 = _mm512_setzero_ps();
+	d_02 = _mm512_setzero_ps();
+	d_03 = _mm512_setzero_ps();
+	d_04 = _mm512_setzero_ps();
+	d_05 = _mm512_setzero_ps();
+	d_06 = _mm512_setzero_ps();
+	d_07 = _mm512_setzero_ps();
+	d_10 = _mm512_setzero_ps();
+	d_11 = _mm512_setzero_ps();
+	d_12 = _mm512_setzero_ps();
+	d_13 = _mm512_setzero_ps();
+	d_14 = _mm512_setzero_ps();
+	d_15 = _mm512_setzero_ps();
+	d_16 = _mm512_setzero_ps();
+	d_17 = _mm512_setzero_ps();
+
+	__mmask16 ma_0 = kernel_smask_16_lib16(km);
+	__mmask16 ma_1 = kernel_smask_16_lib16(km-16);
+	float *A1 = A + 16*sda;
+	float *C1 = C + 16*sdc;
+	float *D1 = D + 16*sdd;
+	int kk;
+
+	for(kk=0; kk<k; kk++)
+		{
+		a_0 = _mm512_maskz_loadu_ps(ma_0, &A[0]);
+		a_1 = _mm512_maskz_loadu_ps(ma_1, &A1[0]);
+		b_0 = _mm512_set1_ps(B[0]);
+		d_00 = _mm512_fmadd_ps(a_0, b_0, d_00);
+		d_10 = _mm512_fmadd_ps(a_1, b_0, d_10);
+		b_0 = _mm512_set1_ps(B[1]);
+		d_01 = _mm512_fmadd_ps(a_0, b_0, d_01);
+		d_11 = _mm512_fmadd_ps(a_1, b_0, d_11);
+		b_0 = _mm512_set1_ps(B[2]);
+		d_02 = _mm512_fmadd_ps(a_0, b_0, d_02);
+		d_12 = _mm512_fmadd_ps(a_1, b_0, d_12);
+		b_0 = _mm512_set1_ps(B[3]);
+		d_03 = _mm512_fmadd_ps(a_0, b_0, d_03);
+		d_13 = _mm512_fmadd_ps(a_1, b_0, d_13);
+		b_0 = _mm512_set1_ps(B[4]);
+		d_04 = _mm512_fmadd_ps(a_0, b_0, d_04);
+		d_14 = _mm512_fmadd_ps(a_1, b_0, d_14);
+		b_0 = _mm512_set1_ps(B[5]);
+		d_05 = _mm512_fmadd_ps(a_0, b_0, d_05);
+		d_15 = _mm512_fmadd_ps(a_1, b_0, d_15);
+		b_0 = _mm512_set1_ps(B[6]);
+		d_06 = _mm512_fmadd_ps(a_0, b_0, d_06);
+		d_16 = _mm512_fmadd_ps(a_1, b_0, d_16);
+		b_0 = _mm512_set1_ps(B[7]);
+		d_07 = _mm512_fmadd_ps(a_0, b_0, d_07);
+		d_17 = _mm512_fmadd_ps(a_1, b_0, d_17);
+		A += 16;
+		A1 += 16;
+		B += 16;
+		}
+
+	tmp = _mm512_set1_ps(alpha[0]);
+	d_00 = _mm512_mul_ps(tmp, d_00);
+	d_01 = _mm512_mul_ps(tmp, d_01);
+	d_02 = _mm512_mul_ps(tmp, d_02);
+	d_03 = _mm512_mul_ps(tmp, d_03);
+	d_04 = _mm512_mul_ps(tmp, d_04);
+	d_05 = _mm512_mul_ps(tmp, d_05);
+	d_06 = _mm512_mul_ps(tmp, d_06);
+	d_07 = _mm512_mul_ps(tmp, d_07);
+	d_10 = _mm512_mul_ps(tmp, d_10);
+	d_11 = _mm512_mul_ps(tmp, d_11);
+	d_12 = _mm512_mul_ps(tmp, d_12);
+	d_13 = _mm512_mul_ps(tmp, d_13);
+	d_14 = _mm512_mul_ps(tmp, d_14);
+	d_15 = _mm512_mul_ps(tmp, d_15);
+	d_16 = _mm512_mul_ps(tmp, d_16);
+	d_17 = _mm512_mul_ps(tmp, d_17);
+
+	if(beta[0]!=0.0)
+		{
+		tmp = _mm512_set1_ps(beta[0]);
+		d_00 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>0 ? ma_0 : 0, &C[0+16*0]), d_00);
+		d_01 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>1 ? ma_0 : 0, &C[0+16*1]), d_01);
+		d_02 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>2 ? ma_0 : 0, &C[0+16*2]), d_02);
+		d_03 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>3 ? ma_0 : 0, &C[0+16*3]), d_03);
+		d_04 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>4 ? ma_0 : 0, &C[0+16*4]), d_04);
+		d_05 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>5 ? ma_0 : 0, &C[0+16*5]), d_05);
+		d_06 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>6 ? ma_0 : 0, &C[0+16*6]), d_06);
+		d_07 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>7 ? ma_0 : 0, &C[0+16*7]), d_07);
+		d_10 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>0 ? ma_1 : 0, &C1[0+16*0]), d_10);
+		d_11 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>1 ? ma_1 : 0, &C1[0+16*1]), d_11);
+		d_12 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>2 ? ma_1 : 0, &C1[0+16*2]), d_12);
+		d_13 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>3 ? ma_1 : 0, &C1[0+16*3]), d_13);
+		d_14 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>4 ? ma_1 : 0, &C1[0+16*4]), d_14);
+		d_15 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>5 ? ma_1 : 0, &C1[0+16*5]), d_15);
+		d_16 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>6 ? ma_1 : 0, &C1[0+16*6]), d_16);
+		d_17 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>7 ? ma_1 : 0, &C1[0+16*7]), d_17);
+		}
+
+	if(kn>0) _mm512_mask_storeu_ps(&D[0+16*0], ma_0, d_00);
+	if(kn>1) _mm512_mask_storeu_ps(&D[0+16*1], ma_0, d_01);
+	if(kn>2) _mm512_mask_storeu_ps(&D[0+16*2], ma_0, d_02);
+	if(kn>3) _mm512_mask_storeu_ps(&D[0+16*3], ma_0, d_03);
+	if(kn>4) _mm512_mask_storeu_ps(&D[0+16*4], ma_0, d_04);
+	if(kn>5) _mm512_mask_storeu_ps(&D[0+16*5], ma_0, d_05);
+	if(kn>6) _mm512_mask_storeu_ps(&D[0+16*6], ma_0, d_06);
+	if(kn>7) _mm512_mask_storeu_ps(&D[0+16*7], ma_0, d_07);
+	if(kn>0) _mm512_mask_storeu_ps(&D1[0+16*0], ma_1, d_10);
+	if(kn>1) _mm512_mask_storeu_ps(&D1[0+16*1], ma_1, d_11);
+	if(kn>2) _mm512_mask_storeu_ps(&D1[0+16*2], ma_1, d_12);
+	if(kn>3) _mm512_mask_storeu_ps(&D1[0+16*3], ma_1, d_13);
+	if(kn>4) _mm512_mask_storeu_ps(&D1[0+16*4], ma_1, d_14);
+	if(kn>5) _mm512_mask_storeu_ps(&D1[0+16*5], ma_1, d_15);
+	if(kn>6) _mm512_mask_storeu_ps(&D1[0+16*6], ma_1, d_16);
+	if(kn>7) _mm512_mask_storeu_ps(&D1[0+16*7], ma_1, d_17);
+
+	return;
+
+	}
+
+
+
+// D = alpha * A * B + beta * C, on the rows selected by ma and the first kn columns;
+// B starts at row offsetB of its panel
+static void kernel_sgemm_nn_16x8_mask_lib16(int k, float *alpha, float *A, int offsetB, float *B, int sdb, float *beta, float *C, float *D, __mmask16 ma, int kn)
+	{
+	__m512
+		d_00, d_01, d_02, d_03, d_04, d_05, d_06, d_07,
+		a_0, b_0, tmp;
+
+	d_00 = _mm512_setzero_ps();
+	d_01 = _mm512_setzero_ps();
+	d_02 = _mm512_setzero_ps();
+	d_03 = _mm512_setzero_ps();
+	d_04 = _mm512_setzero_ps();
+	d_05 = _mm512_setzero_ps();
+	d_06 = _mm512_setzero_ps();
+	d_07 = _mm512_setzero_ps();
+
+	// columns of B past kn are clamped to the first one, to stay inside the matrix
+	int b_1 = kn>1 ? 16*1 : 0;
+	int b_2 = kn>2 ? 16*2 : 0;
+	int b_3 = kn>3 ? 16*3 : 0;
+	int b_4 = kn>4 ? 16*4 : 0;
+	int b_5 = kn>5 ? 16*5 : 0;
+	int b_6 = kn>6 ? 16*6 : 0;
+	int b_7 = kn>7 ? 16*7 : 0;
+	int kk, ll, kend;
+	int offb = offsetB;
+
+	for(kk=0; kk<k; )
+		{
+		kend = 16-offb<k-kk ? 16-offb : k-kk;
+		for(ll=offb; ll<offb+kend; ll++)
+			{
+			a_0 = _mm512_maskz_loadu_ps(ma, &A[0]);
+			b_0 = _mm512_set1_ps(B[ll]);
+			d_00 = _mm512_fmadd_ps(a_0, b_0, d_00);
+			b_0 = _mm512_set1_ps(B[ll+b_1]);
+			d_01 = _mm512_fmadd_ps(a_0, b_0, d_01);
+			b_0 = _mm512_set1_ps(B[ll+b_2]);
+			d_02 = _mm512_fmadd_ps(a_0, b_0, d_02);
+			b_0 = _mm512_set1_ps(B[ll+b_3]);
+			d_03 = _mm512_fmadd_ps(a_0, b_0, d_03);
+			b_0 = _mm512_set1_ps(B[ll+b_4]);
+			d_04 = _mm512_fmadd_ps(a_0, b_0, d_04);
+			b_0 = _mm512_set1_ps(B[ll+b_5]);
+			d_05 = _mm512_fmadd_ps(a_0, b_0, d_05);
+			b_0 = _mm512_set1_ps(B[ll+b_6]);
+			d_06 = _mm512_fmadd_ps(a_0, b_0, d_06);
+			b_0 = _mm512_set1_ps(B[ll+b_7]);
+			d_07 = _mm512_fmadd_ps(a_0, b_0, d_07);
+			A += 16;
+			}
+		kk += kend;
+		B += 16*sdb;
+		offb = 0;
+		}
+
+	int lower = 0;
+
+	tmp = _mm512_set1_ps(alpha[0]);
+	d_00 = _mm512_mul_ps(tmp, d_00);
+	d_01 = _mm512_mul_ps(tmp, d_01);
+	d_02 = _mm512_mul_ps(tmp, d_02);
+	d_03 = _mm512_mul_ps(tmp, d_03);
+	d_04 = _mm512_mul_ps(tmp, d_04);
+	d_05 = _mm512_mul_ps(tmp, d_05);
+	d_06 = _mm512_mul_ps(tmp, d_06);
+	d_07 = _mm512_mul_ps(tmp, d_07);
+
+	if(beta[0]!=0.0)
+		{
+		tmp = _mm512_set1_ps(beta[0]);
+		d_00 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>0 ? ma : 0, &C[0+16*0]), d_00);
+		d_01 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>1 ? ma : 0, &C[0+16*1]), d_01);
+		d_02 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>2 ? ma : 0, &C[0+16*2]), d_02);
+		d_03 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>3 ? ma : 0, &C[0+16*3]), d_03);
+		d_04 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>4 ? ma : 0, &C[0+16*4]), d_04);
+		d_05 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>5 ? ma : 0, &C[0+16*5]), d_05);
+		d_06 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>6 ? ma : 0, &C[0+16*6]), d_06);
+		d_07 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>7 ? ma : 0, &C[0+16*7]), d_07);
+		}
+
+	if(kn>0) _mm512_mask_storeu_ps(&D[0+16*0], lower ? ma & (__mmask16) (0xffff<<0) : ma, d_00);
+	if(kn>1) _mm512_mask_storeu_ps(&D[0+16*1], lower ? ma & (__mmask16) (0xffff<<1) : ma, d_01);
+	if(kn>2) _mm512_mask_storeu_ps(&D[0+16*2], lower ? ma & (__mmask16) (0xffff<<2) : ma, d_02);
+	if(kn>3) _mm512_mask_storeu_ps(&D[0+16*3], lower ? ma & (__mmask16) (0xffff<<3) : ma, d_03);
+	if(kn>4) _mm512_mask_storeu_ps(&D[0+16*4], lower ? ma & (__mmask16) (0xffff<<4) : ma, d_04);
+	if(kn>5) _mm512_mask_storeu_ps(&D[0+16*5], lower ? ma & (__mmask16) (0xffff<<5) : ma, d_05);
+	if(kn>6) _mm512_mask_storeu_ps(&D[0+16*6], lower ? ma & (__mmask16) (0xffff<<6) : ma, d_06);
+	if(kn>7) _mm512_mask_storeu_ps(&D[0+16*7], lower ? ma & (__mmask16) (0xffff<<7) : ma, d_07);
+
+	return;
+
+	}
+
+
+
+// D = alpha * A * B + beta * C, on the first km rows and kn columns of a 32x8 block
+static void kernel_sgemm_nn_32x8_mask_lib16(int k, float *alpha, float *A, int sda, int offsetB, float *B, int sdb, float *beta, float *C, int sdc, float *D, int sdd, int km, int kn)
+	{
+	__m512
+		d_00, d_01, d_02, d_03, d_04, d_05, d_06, d_07, d_10, d_11, d_12, d_13, d_14, d_15, d_16, d_17,
+		a_0, a_1, b_0, tmp;
+
+	d_00 = _mm512_setzero_ps();
+	d_01 = _mm512_setzero_ps();
+	d_02 = _mm512_setzero_ps();
+	d_03 = _mm512_setzero_ps();
+	d_04 = _mm512_setzero_ps();
+	d_05 = _mm512_setzero_ps();
+	d_06 = _mm512_setzero_ps();
+	d_07 = _mm512_setzero_ps();
+	d_10 = _mm512_setzero_ps();
+	d_11 = _mm512_setzero_ps();
+	d_12 = _mm512_setzero_ps();
+	d_13 = _mm512_setzero_ps();
+	d_14 = _mm512_setzero_ps();
+	d_15 = _mm512_setzero_ps();
+	d_16 = _mm512_setzero_ps();
+	d_17 = _mm512_setzero_ps();
+
+	__mmask16 ma_0 = kernel_smask_16_lib16(km);
+	__mmask16 ma_1 = kernel_smask_16_lib16(km-16);
+	float *A1 = A + 16*sda;
+	float *C1 = C + 16*sdc;
+	float *D1 = D + 16*sdd;
+	// columns of B past kn are clamped to the first one, to stay inside the matrix
+	int b_1 = kn>1 ? 16*1 : 0;
+	int b_2 = kn>2 ? 16*2 : 0;
+	int b_3 = kn>3 ? 16*3 : 0;
+	int b_4 = kn>4 ? 16*4 : 0;
+	int b_5 = kn>5 ? 16*5 : 0;
+	int b_6 = kn>6 ? 16*6 : 0;
+	int b_7 = kn>7 ? 16*7 : 0;
+	int kk, ll, kend;
+	int offb = offsetB;
+
+	for(kk=0; kk<k; )
+		{
+		kend = 16-offb<k-kk ? 16-offb : k-kk;
+		for(ll=offb; ll<offb+kend; ll++)
+			{
+			a_0 = _mm512_maskz_loadu_ps(ma_0, &A[0]);
+			a_1 = _mm512_maskz_loadu_ps(ma_1, &A1[0]);
+			b_0 = _mm512_set1_ps(B[ll]);
+			d_00 = _mm512_fmadd_ps(a_0, b_0, d_00);
+			d_10 = _mm512_fmadd_ps(a_1, b_0, d_10);
+			b_0 = _mm512_set1_ps(B[ll+b_1]);
+			d_01 = _mm512_fmadd_ps(a_0, b_0, d_01);
+			d_11 = _mm512_fmadd_ps(a_1, b_0, d_11);
+			b_0 = _mm512_set1_ps(B[ll+b_2]);
+			d_02 = _mm512_fmadd_ps(a_0, b_0, d_02);
+			d_12 = _mm512_fmadd_ps(a_1, b_0, d_12);
+			b_0 = _mm512_set1_ps(B[ll+b_3]);
+			d_03 = _mm512_fmadd_ps(a_0, b_0, d_03);
+			d_13 = _mm512_fmadd_ps(a_1, b_0, d_13);
+			b_0 = _mm512_set1_ps(B[ll+b_4]);
+			d_04 = _mm512_fmadd_ps(a_0, b_0, d_04);
+			d_14 = _mm512_fmadd_ps(a_1, b_0, d_14);
+			b_0 = _mm512_set1_ps(B[ll+b_5]);
+			d_05 = _mm512_fmadd_ps(a_0, b_0, d_05);
+			d_15 = _mm512_fmadd_ps(a_1, b_0, d_15);
+			b_0 = _mm512_set1_ps(B[ll+b_6]);
+			d_06 = _mm512_fmadd_ps(a_0, b_0, d_06);
+			d_16 = _mm512_fmadd_ps(a_1, b_0, d_16);
+			b_0 = _mm512_set1_ps(B[ll+b_7]);
+			d_07 = _mm512_fmadd_ps(a_0, b_0, d_07);
+			d_17 = _mm512_fmadd_ps(a_1, b_0, d_17);
+			A += 16;
+			A1 += 16;
+			}
+		kk += kend;
+		B += 16*sdb;
+		offb = 0;
+		}
+
+	tmp = _mm512_set1_ps(alpha[0]);
+	d_00 = _mm512_mul_ps(tmp, d_00);
+	d_01 = _mm512_mul_ps(tmp, d_01);
+	d_02 = _mm512_mul_ps(tmp, d_02);
+	d_03 = _mm512_mul_ps(tmp, d_03);
+	d_04 = _mm512_mul_ps(tmp, d_04);
+	d_05 = _mm512_mul_ps(tmp, d_05);
+	d_06 = _mm512_mul_ps(tmp, d_06);
+	d_07 = _mm512_mul_ps(tmp, d_07);
+	d_10 = _mm512_mul_ps(tmp, d_10);
+	d_11 = _mm512_mul_ps(tmp, d_11);
+	d_12 = _mm512_mul_ps(tmp, d_12);
+	d_13 = _mm512_mul_ps(tmp, d_13);
+	d_14 = _mm512_mul_ps(tmp, d_14);
+	d_15 = _mm512_mul_ps(tmp, d_15);
+	d_16 = _mm512_mul_ps(tmp, d_16);
+	d_17 = _mm512_mul_ps(tmp, d_17);
+
+	if(beta[0]!=0.0)
+		{
+		tmp = _mm512_set1_ps(beta[0]);
+		d_00 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>0 ? ma_0 : 0, &C[0+16*0]), d_00);
+		d_01 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>1 ? ma_0 : 0, &C[0+16*1]), d_01);
+		d_02 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>2 ? ma_0 : 0, &C[0+16*2]), d_02);
+		d_03 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>3 ? ma_0 : 0, &C[0+16*3]), d_03);
+		d_04 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>4 ? ma_0 : 0, &C[0+16*4]), d_04);
+		d_05 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>5 ? ma_0 : 0, &C[0+16*5]), d_05);
+		d_06 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>6 ? ma_0 : 0, &C[0+16*6]), d_06);
+		d_07 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>7 ? ma_0 : 0, &C[0+16*7]), d_07);
+		d_10 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>0 ? ma_1 : 0, &C1[0+16*0]), d_10);
+		d_11 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>1 ? ma_1 : 0, &C1[0+16*1]), d_11);
+		d_12 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>2 ? ma_1 : 0, &C1[0+16*2]), d_12);
+		d_13 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>3 ? ma_1 : 0, &C1[0+16*3]), d_13);
+		d_14 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>4 ? ma_1 : 0, &C1[0+16*4]), d_14);
+		d_15 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>5 ? ma_1 : 0, &C1[0+16*5]), d_15);
+		d_16 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>6 ? ma_1 : 0, &C1[0+16*6]), d_16);
+		d_17 = _mm512_fmadd_ps(tmp, _mm512_maskz_loadu_ps(kn>7 ? ma_1 : 0, &C1[0+16*7]), d_17);
+		}
+
+	if(kn>0) _mm512_mask_storeu_ps(&D[0+16*0], ma_0, d_00);
+	if(kn>1) _mm512_mask_storeu_ps(&D[0+16*1], ma_0, d_01);
+	if(kn>2) _mm512_mask_storeu_ps(&D[0+16*2], ma_0, d_02);
+	if(kn>3) _mm512_mask_storeu_ps(&D[0+16*3], ma_0, d_03);
+	if(kn>4) _mm512_mask_storeu_ps(&D[0+16*4], ma_0, d_04);
+	if(kn>5) _mm512_mask_storeu_ps(&D[0+16*5], ma_0, d_05);
+	if(kn>6) _mm512_mask_storeu_ps(&D[0+16*6], ma_0, d_06);
+	if(kn>7) _mm512_mask_storeu_ps(&D[0+16*7], ma_0, d_07);
+	if(kn>0) _mm512_mask_storeu_ps(&D1[0+16*0], ma_1, d_10);
+	if(kn>1) _mm512_mask_storeu_ps(&D1[0+16*1], ma_1, d_11);
+	if(kn>2) _mm512_mask_storeu_ps(&D1[0+16*2], ma_1, d_12);
+	if(kn>3) _mm512_mask_storeu_ps(&D1[0+16*3], ma_1, d_13);
+	if(kn>4) _mm512_mask_storeu_ps(&D1[0+16*4], ma_1, d_14);
+	if(kn>5) _mm512_mask_storeu_ps(&D1[0+16*5], ma_1, d_15);
+	if(kn>6) _mm512_mask_storeu_ps(&D1[0+16*6], ma_1, d_16);
+	if(kn>7) _mm512_mask_storeu_ps(&D1[0+16*7], ma_1, d_17);
+
+	return;
+
+	}
+
+
+
+void kernel_sgemm_nt_32x8_lib16(int k, float *alpha, float *A, int sda, float *B, float *beta, float *C, int sdc, float *D, int sdd)
+	{
+	kernel_sgemm_nt_32x8_mask_lib16(k, alpha, A, sda, B, beta, C, sdc, D, sdd, 32, 8);
+	}
+
+
+
+void kernel_sgemm_nt_32x8_vs_lib16(int k, float *alpha, float *A, int sda, float *B, float *beta, float *C, int sdc, float *D, int sdd, int km, int kn)
+	{
+	kernel_sgemm_nt_32x8_mask_lib16(k, alpha, A, sda, B, beta, C, sdc, D, sdd, km, kn);
+	}
+
+
+
+void kernel_sgemm_nn_32x8_lib16(int k, float *alpha, float *A, int sda, int offsetB, float *B, int sdb, float *beta, float *C, int sdc, float *D, int sdd)
+	{
+	kernel_sgemm_nn_32x8_mask_lib16(k, alpha, A, sda, offsetB, B, sdb, beta, C, sdc, D, sdd, 32, 8);
+	}
+
+
+
+void kernel_sgemm_nn_32x8_vs_lib16(int k, float *alpha, float *A, int sda, int offsetB, float *B, int sdb, float *beta, float *C, int sdc, float *D, int sdd, int km, int kn)
+	{
+	kernel_sgemm_nn_32x8_mask_lib16(k, alpha, A, sda, offsetB, B, sdb, beta, C, sdc, D, sdd, km, kn);
+	}
+
+
+
+void kernel_sgemm_nt_16x8_lib16(int k, float *alpha, float *A, float *B, float *beta, float *C, float *D)
+	{
+	kernel_sgemm_nt_16x8_mask_lib16(k, alpha, A, B, beta, C, D, 0xffff, 8, 0);
+	}
+
+
+
+void kernel_sgemm_nt_16x8_vs_lib16(int k, float *alpha, float *A, float *B, float *beta, float *C, float *D, int km, int kn)
+	{
+	kernel_sgemm_nt_16x8_mask_lib16(k, alpha, A, B, beta, C, D, kernel_smask_16_lib16(km), kn, 0);
+	}
+
+
+
+void kernel_sgemm_nn_16x8_lib16(int k, float *alpha, float *A, int offsetB, float *B, int sdb, float *beta, float *C, float *D)
+	{
+	kernel_sgemm_nn_16x8_mask_lib16(k, alpha, A, offsetB, B, sdb, beta, C, D, 0xffff, 8);
+	}
+
+
+
+void kernel_sgemm_nn_16x8_vs_lib16(int k, float *alpha, float *A, int offsetB, float *B, int sdb, float *beta, float *C, float *D, int km, int kn)
+	{
+	kernel_sgemm_nn_16x8_mask_lib16(k, alpha, A, offsetB, B, sdb, beta, C, D, kernel_smask_16_lib16(km), kn);
+	}
+
+
+
+void kernel_ssyrk_nt_l_16x8_lib16(int k, float *alpha, float *A, float *B, float *beta, float *C, float *D)
+	{
+	kernel_sgemm_nt_16x8_mask_lib16(k, alpha, A, B, beta, C, D, 0xffff, 8, 1);
+	}
+
+
+
+void kernel_ssyrk_nt_l_16x8_vs_lib16(int k, float *alpha, float *A, float *B, float *beta, float *C, float *D, int km, int kn)
+	{
+	kernel_sgemm_nt_16x8_mask_lib16(k, alpha, A, B, beta, C, D, kernel_smask_16_lib16(km), kn, 1);
+	}
+
+
+
+// the 8x8 kernels operate on the lower half of a panel: A, C and D point to row 8 of their panel
+void kernel_ssyrk_nt_l_8x8_lib16(int k, float *alpha, float *A, float *B, float *beta, float *C, float *D)
+	{
+	kernel_sgemm_nt_16x8_mask_lib16(k, alpha, A, B, beta, C, D, 0x00ff, 8, 1);
+	}
+
+
+
+void kernel_ssyrk_nt_l_8x8_vs_lib16(int k, float *alpha, float *A, float *B, float *beta, float *C, float *D, int km, int kn)
+	{
+	kernel_sgemm_nt_16x8_mask_lib16(k, alpha, A, B, beta, C, D, kernel_smask_16_lib16(km<8 ? km : 8), kn, 1);
+	}
+
+
+
+// cholesky factorization of the 8x8 top block of D and solution of the rows below it
+static void kernel_spotrf_l_post_16x8_lib16(float *D, float *inv_diag_D, __mmask16 ma, int kn)
+	{
+
+	__m512
+		d_00, d_01, d_02, d_03, d_04, d_05, d_06, d_07;
+	float tmp;
+	d_00 = _mm512_maskz_loadu_ps(kn>0 ? ma : 0, &D[0+16*0]);
+	d_01 = _mm512_maskz_loadu_ps(kn>1 ? ma : 0, &D[0+16*1]);
+	d_02 = _mm512_maskz_loadu_ps(kn>2 ? ma : 0, &D[0+16*2]);
+	d_03 = _mm512_maskz_loadu_ps(kn>3 ? ma : 0, &D[0+16*3]);
+	d_04 = _mm512_maskz_loadu_ps(kn>4 ? ma : 0, &D[0+16*4]);
+	d_05 = _mm512_maskz_loadu_ps(kn>5 ? ma : 0, &D[0+16*5]);
+	d_06 = _mm512_maskz_loadu_ps(kn>6 ? ma : 0, &D[0+16*6]);
+	d_07 = _mm512_maskz_loadu_ps(kn>7 ? ma : 0, &D[0+16*7]);
+
+	tmp = _mm512_cvtss_f32(kernel_sbcast_16_lib16(d_00, 0));
+	tmp = tmp>0.0 ? 1.0/sqrtf(tmp) : 0.0;
+	inv_diag_D[0] = tmp;
+	d_00 = _mm512_mul_ps(d_00, _mm512_set1_ps(tmp));
+	if(kn==1)
+		goto store;
+	d_01 = _mm512_fnmadd_ps(d_00, kernel_sbcast_16_lib16(d_00, 1), d_01);
+	d_02 = _mm512_fnmadd_ps(d_00, kernel_sbcast_16_lib16(d_00, 2), d_02);
+	d_03 = _mm512_fnmadd_ps(d_00, kernel_sbcast_16_lib16(d_00, 3), d_03);
+	d_04 = _mm512_fnmadd_ps(d_00, kernel_sbcast_16_lib16(d_00, 4), d_04);
+	d_05 = _mm512_fnmadd_ps(d_00, kernel_sbcast_16_lib16(d_00, 5), d_05);
+	d_06 = _mm512_fnmadd_ps(d_00, kernel_sbcast_16_lib16(d_00, 6), d_06);
+	d_07 = _mm512_fnmadd_ps(d_00, kernel_sbcast_16_lib16(d_00, 7), d_07);
+
+	tmp = _mm512_cvtss_f32(kernel_sbcast_16_lib16(d_01, 1));
+	tmp = tmp>0.0 ? 1.0/sqrtf(tmp) : 0.0;
+	inv_diag_D[1] = tmp;
+	d_01 = _mm512_mul_ps(d_01, _mm512_set1_ps(tmp));
+	if(kn==2)
+		goto store;
+	d_02 = _mm512_fnmadd_ps(d_01, kernel_sbcast_16_lib16(d_01, 2), d_02);
+	d_03 = _mm512_fnmadd_ps(d_01, kernel_sbcast_16_lib16(d_01, 3), d_03);
+	d_04 = _mm512_fnmadd_ps(d_01, kernel_sbcast_16_lib16(d_01, 4), d_04);
+	d_05 = _mm512_fnmadd_ps(d_01, kernel_sbcast_16_lib16(d_01, 5), d_05);
+	d_06 = _mm512_fnmadd_ps(d_01, kernel_sbcast_16_lib16(d_01, 6), d_06);
+	d_07 = _mm512_fnmadd_ps(d_01, kernel_sbcast_16_lib16(d_01, 7), d_07);
+
+	tmp = _mm512_cvtss_f32(kernel_sbcast_16_lib16(d_02, 2));
+	tmp = tmp>0.0 ? 1.0/sqrtf(tmp) : 0.0;
+	inv_diag_D[2] = tmp;
+	d_02 = _mm512_mul_ps(d_02, _mm512_set1_ps(tmp));
+	if(kn==3)
+		goto store;
+	d_03 = _mm512_fnmadd_ps(d_02, kernel_sbcast_16_lib16(d_02, 3), d_03);
+	d_04 = _mm512_fnmadd_ps(d_02, kernel_sbcast_16_lib16(d_02, 4), d_04);
+	d_05 = _mm512_fnmadd_ps(d_02, kernel_sbcast_16_lib16(d_02, 5), d_05);
+	d_06 = _mm512_fnmadd_ps(d_02, kernel_sbcast_16_lib16(d_02, 6), d_06);
+	d_07 = _mm512_fnmadd_ps(d_02, kernel_sbcast_16_lib16(d_02, 7), d_07);
+
+	tmp = _mm512_cvtss_f32(kernel_sbcast_16_lib16(d_03, 3));
+	tmp = tmp>0.0 ? 1.0/sqrtf(tmp) : 0.0;
+	inv_diag_D[3] = tmp;
+	d_03 = _mm512_mul_ps(d_03, _mm512_set1_ps(tmp));
+	if(kn==4)
+		goto store;
+	d_04 = _mm512_fnmadd_ps(d_03, kernel_sbcast_16_lib16(d_03, 4), d_04);
+	d_05 = _mm512_fnmadd_ps(d_03, kernel_sbcast_16_lib16(d_03, 5), d_05);
+	d_06 = _mm512_fnmadd_ps(d_03, kernel_sbcast_16_lib16(d_03, 6), d_06);
+	d_07 = _mm512_fnmadd_ps(d_03, kernel_sbcast_16_lib16(d_03, 7), d_07);
+
+	tmp = _mm512_cvtss_f32(kernel_sbcast_16_lib16(d_04, 4));
+	tmp = tmp>0.0 ? 1.0/sqrtf(tmp) : 0.0;
+	inv_diag_D[4] = tmp;
+	d_04 = _mm512_mul_ps(d_04, _mm512_set1_ps(tmp));
+	if(kn==5)
+		goto store;
+	d_05 = _mm512_fnmadd_ps(d_04, kernel_sbcast_16_lib16(d_04, 5), d_05);
+	d_06 = _mm512_fnmadd_ps(d_04, kernel_sbcast_16_lib16(d_04, 6), d_06);
+	d_07 = _mm512_fnmadd_ps(d_04, kernel_sbcast_16_lib16(d_04, 7), d_07);
+
+	tmp = _mm512_cvtss_f32(kernel_sbcast_16_lib16(d_05, 5));
+	tmp = tmp>0.0 ? 1.0/sqrtf(tmp) : 0.0;
+	inv_diag_D[5] = tmp;
+	d_05 = _mm512_mul_ps(d_05, _mm512_set1_ps(tmp));
+	if(kn==6)
+		goto store;
+	d_06 = _mm512_fnmadd_ps(d_05, kernel_sbcast_16_lib16(d_05, 6), d_06);
+	d_07 = _mm512_fnmadd_ps(d_05, kernel_sbcast_16_lib16(d_05, 7), d_07);
+
+	tmp = _mm512_cvtss_f32(kernel_sbcast_16_lib16(d_06, 6));
+	tmp = tmp>0.0 ? 1.0/sqrtf(tmp) : 0.0;
+	inv_diag_D[6] = tmp;
+	d_06 = _mm512_mul_ps(d_06, _mm512_set1_ps(tmp));
+	if(kn==7)
+		goto store;
+	d_07 = _mm512_fnmadd_ps(d_06, kernel_sbcast_16_lib16(d_06, 7), d_07);
+
+	tmp = _mm512_cvtss_f32(kernel_sbcast_16_lib16(d_07, 7));
+	tmp = tmp>0.0 ? 1.0/sqrtf(tmp) : 0.0;
+	inv_diag_D[7] = tmp;
+	d_07 = _mm512_mul_ps(d_07, _mm512_set1_ps(tmp));
+
+store:
+	if(kn>0) _mm512_mask_storeu_ps(&D[0+16*0], ma & (__mmask16) (0xffff<<0), d_00);
+	if(kn>1) _mm512_mask_storeu_ps(&D[0+16*1], ma & (__mmask16) (0xffff<<1), d_01);
+	if(kn>2) _mm512_mask_storeu_ps(&D[0+16*2], ma & (__mmask16) (0xffff<<2), d_02);
+	if(kn>3) _mm512_mask_storeu_ps(&D[0+16*3], ma & (__mmask16) (0xffff<<3), d_03);
+	if(kn>4) _mm512_mask_storeu_ps(&D[0+16*4], ma & (__mmask16) (0xffff<<4), d_04);
+	if(kn>5) _mm512_mask_storeu_ps(&D[0+16*5], ma & (__mmask16) (0xffff<<5), d_05);
+	if(kn>6) _mm512_mask_storeu_ps(&D[0+16*6], ma & (__mmask16) (0xffff<<6), d_06);
+	if(kn>7) _mm512_mask_storeu_ps(&D[0+16*7], ma & (__mmask16) (0xffff<<7), d_07);
+
+	return;
+
+	}
+
+
+
+// solution of D * E^T = D, with E lower triangular with inverted diagonal in inv_diag_E
+static void kernel_strsm_nt_rl_inv_post_16x8_lib16(float *D, float *E, float *inv_diag_E, __mmask16 ma, int kn)
+	{
+
+	__m512
+		d_00, d_01, d_02, d_03, d_04, d_05, d_06, d_07;
+	d_00 = _mm512_maskz_loadu_ps(kn>0 ? ma : 0, &D[0+16*0]);
+	d_01 = _mm512_maskz_loadu_ps(kn>1 ? ma : 0, &D[0+16*1]);
+	d_02 = _mm512_maskz_loadu_ps(kn>2 ? ma : 0, &D[0+16*2]);
+	d_03 = _mm512_maskz_loadu_ps(kn>3 ? ma : 0, &D[0+16*3]);
+	d_04 = _mm512_maskz_loadu_ps(kn>4 ? ma : 0, &D[0+16*4]);
+	d_05 = _mm512_maskz_loadu_ps(kn>5 ? ma : 0, &D[0+16*5]);
+	d_06 = _mm512_maskz_loadu_ps(kn>6 ? ma : 0, &D[0+16*6]);
+	d_07 = _mm512_maskz_loadu_ps(kn>7 ? ma : 0, &D[0+16*7]);
+
+	d_00 = _mm512_mul_ps(d_00, _mm512_set1_ps(inv_diag_E[0]));
+	if(kn==1)
+		goto store;
+	d_01 = _mm512_fnmadd_ps(d_00, _mm512_set1_ps(E[1+16*0]), d_01);
+	d_02 = _mm512_fnmadd_ps(d_00, _mm512_set1_ps(E[2+16*0]), d_02);
+	d_03 = _mm512_fnmadd_ps(d_00, _mm512_set1_ps(E[3+16*0]), d_03);
+	d_04 = _mm512_fnmadd_ps(d_00, _mm512_set1_ps(E[4+16*0]), d_04);
+	d_05 = _mm512_fnmadd_ps(d_00, _mm512_set1_ps(E[5+16*0]), d_05);
+	d_06 = _mm512_fnmadd_ps(d_00, _mm512_set1_ps(E[6+16*0]), d_06);
+	d_07 = _mm512_fnmadd_ps(d_00, _mm512_set1_ps(E[7+16*0]), d_07);
+
+	d_01 = _mm512_mul_ps(d_01, _mm512_set1_ps(inv_diag_E[1]));
+	if(kn==2)
+		goto store;
+	d_02 = _mm512_fnmadd_ps(d_01, _mm512_set1_ps(E[2+16*1]), d_02);
+	d_03 = _mm512_fnmadd_ps(d_01, _mm512_set1_ps(E[3+16*1]), d_03);
+	d_04 = _mm512_fnmadd_ps(d_01, _mm512_set1_ps(E[4+16*1]), d_04);
+	d_05 = _mm512_fnmadd_ps(d_01, _mm512_set1_ps(E[5+16*1]), d_05);
+	d_06 = _mm512_fnmadd_ps(d_01, _mm512_set1_ps(E[6+16*1]), d_06);
+	d_07 = _mm512_fnmadd_ps(d_01, _mm512_set1_ps(E[7+16*1]), d_07);
+
+	d_02 = _mm512_mul_ps(d_02, _mm512_set1_ps(inv_diag_E[2]));
+	if(kn==3)
+		goto store;
+	d_03 = _mm512_fnmadd_ps(d_02, _mm512_set1_ps(E[3+16*2]), d_03);
+	d_04 = _mm512_fnmadd_ps(d_02, _mm512_set1_ps(E[4+16*2]), d_04);
+	d_05 = _mm512_fnmadd_ps(d_02, _mm512_set1_ps(E[5+16*2]), d_05);
+	d_06 = _mm512_fnmadd_ps(d_02, _mm512_set1_ps(E[6+16*2]), d_06);
+	d_07 = _mm512_fnmadd_ps(d_02, _mm512_set1_ps(E[7+16*2]), d_07);
+
+	d_03 = _mm512_mul_ps(d_03, _mm512_set1_ps(inv_diag_E[3]));
+	if(kn==4)
+		goto store;
+	d_04 = _mm512_fnmadd_ps(d_03, _mm512_set1_ps(E[4+16*3]), d_04);
+	d_05 = _mm512_fnmadd_ps(d_03, _mm512_set1_ps(E[5+16*3]), d_05);
+	d_06 = _mm512_fnmadd_ps(d_03, _mm512_set1_ps(E[6+16*3]), d_06);
+	d_07 = _mm512_fnmadd_ps(d_03, _mm512_set1_ps(E[7+16*3]), d_07);
+
+	d_04 = _mm512_mul_ps(d_04, _mm512_set1_ps(inv_diag_E[4]));
+	if(kn==5)
+		goto store;
+	d_05 = _mm512_fnmadd_ps(d_04, _mm512_set1_ps(E[5+16*4]), d_05);
+	d_06 = _mm512_fnmadd_ps(d_04, _mm512_set1_ps(E[6+16*4]), d_06);
+	d_07 = _mm512_fnmadd_ps(d_04, _mm512_set1_ps(E[7+16*4]), d_07);
+
+	d_05 = _mm512_mul_ps(d_05, _mm512_set1_ps(inv_diag_E[5]));
+	if(kn==6)
+		goto store;
+	d_06 = _mm512_fnmadd_ps(d_05, _mm512_set1_ps(E[6+16*5]), d_06);
+	d_07 = _mm512_fnmadd_ps(d_05, _mm512_set1_ps(E[7+16*5]), d_07);
+
+	d_06 = _mm512_mul_ps(d_06, _mm512_set1_ps(inv_diag_E[6]));
+	if(kn==7)
+		goto store;
+	d_07 = _mm512_fnmadd_ps(d_06, _mm512_set1_ps(E[7+16*6]), d_07);
+
+	d_07 = _mm512_mul_ps(d_07, _mm512_set1_ps(inv_diag_E[7]));
+
+store:
+	if(kn>0) _mm512_mask_storeu_ps(&D[0+16*0], ma, d_00);
+	if(kn>1) _mm512_mask_storeu_ps(&D[0+16*1], ma, d_01);
+	if(kn>2) _mm512_mask_storeu_ps(&D[0+16*2], ma, d_02);
+	if(kn>3) _mm512_mask_storeu_ps(&D[0+16*3], ma, d_03);
+	if(kn>4) _mm512_mask_storeu_ps(&D[0+16*4], ma, d_04);
+	if(kn>5) _mm512_mask_storeu_ps(&D[0+16*5], ma, d_05);
+	if(kn>6) _mm512_mask_storeu_ps(&D[0+16*6], ma, d_06);
+	if(kn>7) _mm512_mask_storeu_ps(&D[0+16*7], ma, d_07);
+
+	return;
+
+	}
+
+
+
+// solution of E * D = D, with E unit lower triangular 8x8 (upper half of a panel)
+static void kernel_strsm_nn_ll_one_post_8x8_lib16(float *D, float *E, __mmask16 ma, int kn)
+	{
+
+	__m512
+		d_00, d_01, d_02, d_03, d_04, d_05, d_06, d_07,
+		e_0;
+	int ii;
+	d_00 = _mm512_maskz_loadu_ps(kn>0 ? ma : 0, &D[0+16*0]);
+	d_01 = _mm512_maskz_loadu_ps(kn>1 ? ma : 0, &D[0+16*1]);
+	d_02 = _mm512_maskz_loadu_ps(kn>2 ? ma : 0, &D[0+16*2]);
+	d_03 = _mm512_maskz_loadu_ps(kn>3 ? ma : 0, &D[0+16*3]);
+	d_04 = _mm512_maskz_loadu_ps(kn>4 ? ma : 0, &D[0+16*4]);
+	d_05 = _mm512_maskz_loadu_ps(kn>5 ? ma : 0, &D[0+16*5]);
+	d_06 = _mm512_maskz_loadu_ps(kn>6 ? ma : 0, &D[0+16*6]);
+	d_07 = _mm512_maskz_loadu_ps(kn>7 ? ma : 0, &D[0+16*7]);
+
+	for(ii=0; ii<7; ii++)
+		{
+		e_0 = _mm512_maskz_loadu_ps(ma & (__mmask16) (0xffff<<(ii+1)), &E[0+16*ii]);
+		d_00 = _mm512_fnmadd_ps(e_0, kernel_sbcast_16_lib16(d_00, ii), d_00);
+		d_01 = _mm512_fnmadd_ps(e_0, kernel_sbcast_16_lib16(d_01, ii), d_01);
+		d_02 = _mm512_fnmadd_ps(e_0, kernel_sbcast_16_lib16(d_02, ii), d_02);
+		d_03 = _mm512_fnmadd_ps(e_0, kernel_sbcast_16_lib16(d_03, ii), d_03);
+		d_04 = _mm512_fnmadd_ps(e_0, kernel_sbcast_16_lib16(d_04, ii), d_04);
+		d_05 = _mm512_fnmadd_ps(e_0, kernel_sbcast_16_lib16(d_05, ii), d_05);
+		d_06 = _mm512_fnmadd_ps(e_0, kernel_sbcast_16_lib16(d_06, ii), d_06);
+		d_07 = _mm512_fnmadd_ps(e_0, kernel_sbcast_16_lib16(d_07, ii), d_07);
+		}
+
+	if(kn>0) _mm512_mask_storeu_ps(&D[0+16*0], ma, d_00);
+	if(kn>1) _mm512_mask_storeu_ps(&D[0+16*1], ma, d_01);
+	if(kn>2) _mm512_mask_storeu_ps(&D[0+16*2], ma, d_02);
+	if(kn>3) _mm512_mask_storeu_ps(&D[0+16*3], ma, d_03);
+	if(kn>4) _mm512_mask_storeu_ps(&D[0+16*4], ma, d_04);
+	if(kn>5) _mm512_mask_storeu_ps(&D[0+16*5], ma, d_05);
+	if(kn>6) _mm512_mask_storeu_ps(&D[0+16*6], ma, d_06);
+	if(kn>7) _mm512_mask_storeu_ps(&D[0+16*7], ma, d_07);
+
+	return;
+
+	}
+
+
+
+void kernel_spotrf_nt_l_16x8_lib16(int k, float *A, float *B, float *C, float *D, float *inv_diag_D)
+	{
+	float alpha = -1.0;
+	float beta = 1.0;
+	kernel_sgemm_nt_16x8_mask_lib16(k, &alpha, A, B, &beta, C, D, 0xffff, 8, 1);
+	kernel_spotrf_l_post_16x8_lib16(D, inv_diag_D, 0xffff, 8);
+	}
+
+
+
+void kernel_spotrf_nt_l_16x8_vs_lib16(int k, float *A, float *B, float *C, float *D, float *inv_diag_D, int km, int kn)
+	{
+	float alpha = -1.0;
+	float beta = 1.0;
+	__mmask16 ma = kernel_smask_16_lib16(km);
+	kernel_sgemm_nt_16x8_mask_lib16(k, &alpha, A, B, &beta, C, D, ma, kn, 1);
+	kernel_spotrf_l_post_16x8_lib16(D, inv_diag_D, ma, kn);
+	}
+
+
+
+void kernel_spotrf_nt_l_8x8_lib16(int k, float *A, float *B, float *C, float *D, float *inv_diag_D)
+	{
+	float alpha = -1.0;
+	float beta = 1.0;
+	kernel_sgemm_nt_16x8_mask_lib16(k, &alpha, A, B, &beta, C, D, 0x00ff, 8, 1);
+	kernel_spotrf_l_post_16x8_lib16(D, inv_diag_D, 0x00ff, 8);
+	}
+
+
+
+void kernel_spotrf_nt_l_8x8_vs_lib16(int k, float *A, float *B, float *C, float *D, float *inv_diag_D, int km, int kn)
+	{
+	float alpha = -1.0;
+	float beta = 1.0;
+	__mmask16 ma = kernel_smask_16_lib16(km<8 ? km : 8);
+	kernel_sgemm_nt_16x8_mask_lib16(k, &alpha, A, B, &beta, C, D, ma, kn, 1);
+	kernel_spotrf_l_post_16x8_lib16(D, inv_diag_D, ma, kn);
+	}
+
+
+
+void kernel_strsm_nt_rl_inv_16x8_lib16(int k, float *A, float *B, float *C, float *D, float *E, float *inv_diag_E)
+	{
+	float alpha = -1.0;
+	float beta = 1.0;
+	kernel_sgemm_nt_16x8_mask_lib16(k, &alpha, A, B, &beta, C, D, 0xffff, 8, 0);
+	kernel_strsm_nt_rl_inv_post_16x8_lib16(D, E, inv_diag_E, 0xffff, 8);
+	}
+
+
+
+void kernel_strsm_nt_rl_inv_16x8_vs_lib16(int k, float *A, float *B, float *C, float *D, float *E, float *inv_diag_E, int km, int kn)
+	{
+	float alpha = -1.0;
+	float beta = 1.0;
+	__mmask16 ma = kernel_smask_16_lib16(km);
+	kernel_sgemm_nt_16x8_mask_lib16(k, &alpha, A, B, &beta, C, D, ma, kn, 0);
+	kernel_strsm_nt_rl_inv_post_16x8_lib16(D, E, inv_diag_E, ma, kn);
+	}
+
+
+
+void kernel_strsm_nn_ll_one_8x8_vs_lib16(int k, float *A, int offsetB, float *B, int sdb, float *C, float *D, float *E, int km, int kn)
+	{
+	float alpha = -1.0;
+	float beta = 1.0;
+	__mmask16 ma = kernel_smask_16_lib16(km<8 ? km : 8);
+	kernel_sgemm_nn_16x8_mask_lib16(k, &alpha, A, offsetB, B, sdb, &beta, C, D, ma, kn);
+	kernel_strsm_nn_ll_one_post_8x8_lib16(D, E, ma, kn);
+	}
+
+
+
@@ -0,0 +1,197 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <mmintrin.h>
+#include <xmmintrin.h>  // SSE
+#include <emmintrin.h>  // SSE2
+#include <pmmintrin.h>  // SSE3
+#include <smmintrin.h>  // SSE4
+#include <immintrin.h>  // AVX
+
+#include <blasfeo_common.h>
+#include <blasfeo_s_kernel.h>
+
+
+
+// z = alpha * A * x + beta * y, on the rows selected by ma
+static void kernel_sgemv_n_16_mask_lib16(int k, float *alpha, float *A, float *x, float *beta, float *y, float *z, __mmask16 ma)
+	{
+
+	__m512
+		z_0, z_1, z_2, z_3,
+		a_0, tmp;
+
+	z_0 = _mm512_setzero_ps();
+	z_1 = _mm512_setzero_ps();
+	z_2 = _mm512_setzero_ps();
+	z_3 = _mm512_setzero_ps();
+
+	int kk;
+
+	for(kk=0; kk<k-3; kk+=4)
+		{
+		a_0 = _mm512_maskz_loadu_ps(ma, &A[0+16*0]);
+		z_0 = _mm512_fmadd_ps(a_0, _mm512_set1_ps(x[0]), z_0);
+		a_0 = _mm512_maskz_loadu_ps(ma, &A[0+16*1]);
+		z_1 = _mm512_fmadd_ps(a_0, _mm512_set1_ps(x[1]), z_1);
+		a_0 = _mm512_maskz_loadu_ps(ma, &A[0+16*2]);
+		z_2 = _mm512_fmadd_ps(a_0, _mm512_set1_ps(x[2]), z_2);
+		a_0 = _mm512_maskz_loadu_ps(ma, &A[0+16*3]);
+		z_3 = _mm512_fmadd_ps(a_0, _mm512_set1_ps(x[3]), z_3);
+		A += 64;
+		x += 4;
+		}
+	for(; kk<k; kk++)
+		{
+		a_0 = _mm512_maskz_loadu_ps(ma, &A[0]);
+		z_0 = _mm512_fmadd_ps(a_0, _mm512_set1_ps(x[0]), z_0);
+		A += 16;
+		x += 1;
+		}
+
+	z_0 = _mm512_add_ps(z_0, z_1);
+	z_2 = _mm512_add_ps(z_2, z_3);
+	z_0 = _mm512_add_ps(z_0, z_2);
+
+	z_0 = _mm512_mul_ps(z_0, _mm512_set1_ps(alpha[0]));
+	if(beta[0]!=0.0)
+		{
+		tmp = _mm512_maskz_loadu_ps(ma, &y[0]);
+		z_0 = _mm512_fmadd_ps(tmp, _mm512_set1_ps(beta[0]), z_0);
+		}
+
+	_mm512_mask_storeu_ps(&z[0], ma, z_0);
+
+	return;
+
+	}
+
+
+
+void kernel_sgemv_n_16_lib16(int k, float *alpha, float *A, float *x, float *beta, float *y, float *z)
+	{
+	kernel_sgemv_n_16_mask_lib16(k, alpha, A, x, beta, y, z, 0xffff);
+	}
+
+
+
+void kernel_sgemv_n_16_vs_lib16(int k, float *alpha, float *A, float *x, float *beta, float *y, float *z, int km)
+	{
+	__mmask16 ma = km>=16 ? (__mmask16) 0xffff : (__mmask16) ((1<<km)-1);
+	kernel_sgemv_n_16_mask_lib16(k, alpha, A, x, beta, y, z, ma);
+	}
+
+
+
+// z = alpha * A^T * x + beta * y, on the first kn columns; A starts at row offsetA of its panel
+void kernel_sgemv_t_8_vs_lib16(int k, float *alpha, int offsetA, float *A, int sda, float *x, float *beta, float *y, float *z, int kn)
+	{
+
+	const int ps = 16;
+
+	__m512
+		z_0, z_1, z_2, z_3, z_4, z_5, z_6, z_7,
+		x_0;
+
+	__mmask16 ma;
+	// columns of A past kn are clamped to the first one, to stay inside the matrix
+	int a_1 = kn>1 ? ps*1 : 0;
+	int a_2 = kn>2 ? ps*2 : 0;
+	int a_3 = kn>3 ? ps*3 : 0;
+	int a_4 = kn>4 ? ps*4 : 0;
+	int a_5 = kn>5 ? ps*5 : 0;
+	int a_6 = kn>6 ? ps*6 : 0;
+	int a_7 = kn>7 ? ps*7 : 0;
+	int kk, kend;
+
+	z_0 = _mm512_setzero_ps();
+	z_1 = _mm512_setzero_ps();
+	z_2 = _mm512_setzero_ps();
+	z_3 = _mm512_setzero_ps();
+	z_4 = _mm512_setzero_ps();
+	z_5 = _mm512_setzero_ps();
+	z_6 = _mm512_setzero_ps();
+	z_7 = _mm512_setzero_ps();
+
+	A -= offsetA;
+	x -= offsetA;
+	kk = -offsetA;
+	for(; kk<k; kk+=ps)
+		{
+		kend = k-kk<ps ? k-kk : ps;
+		ma = (__mmask16) ((0xffff<<(kk<0 ? -kk : 0)) & (0xffff>>(ps-kend)));
+		x_0 = _mm512_maskz_loadu_ps(ma, &x[0]);
+		z_0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(ma, &A[0]), x_0, z_0);
+		z_1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(ma, &A[a_1]), x_0, z_1);
+		z_2 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(ma, &A[a_2]), x_0, z_2);
+		z_3 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(ma, &A[a_3]), x_0, z_3);
+		z_4 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(ma, &A[a_4]), x_0, z_4);
+		z_5 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(ma, &A[a_5]), x_0, z_5);
+		z_6 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(ma, &A[a_6]), x_0, z_6);
+		z_7 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(ma, &A[a_7]), x_0, z_7);
+		A += ps*sda;
+		x += ps;
+		}
+
+	float zz[8];
+	zz[0] = _mm512_reduce_add_ps(z_0);
+	zz[1] = _mm512_reduce_add_ps(z_1);
+	zz[2] = _mm512_reduce_add_ps(z_2);
+	zz[3] = _mm512_reduce_add_ps(z_3);
+	zz[4] = _mm512_reduce_add_ps(z_4);
+	zz[5] = _mm512_reduce_add_ps(z_5);
+	zz[6] = _mm512_reduce_add_ps(z_6);
+	zz[7] = _mm512_reduce_add_ps(z_7);
+
+	for(kk=0; kk<kn & kk<8; kk++)
+		{
+		if(beta[0]!=0.0)
+			z[kk] = alpha[0]*zz[kk] + beta[0]*y[kk];
+		else
+			z[kk] = alpha[0]*zz[kk];
+		}
+
+	return;
+
+	}
+
+
+
+void kernel_sgemv_t_8_lib16(int k, float *alpha, int offsetA, float *A, int sda, float *x, float *beta, float *y, float *z)
+	{
+	kernel_sgemv_t_8_vs_lib16(k, alpha, offsetA, A, sda, x, beta, y, z, 8);
+	}
+
+
@@ -0,0 +1,150 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <math.h>
+#include <stdio.h>
+
+#include <mmintrin.h>
+#include <xmmintrin.h>  // SSE
+#include <emmintrin.h>  // SSE2
+#include <pmmintrin.h>  // SSE3
+#include <smmintrin.h>  // SSE4
+#include <immintrin.h>  // AVX
+
+#include <blasfeo_common.h>
+#include <blasfeo_s_kernel.h>
+
+
+
+// scale the column jj below the diagonal by inv and apply the rank-1 update to the columns jj+1..n-1;
+// rows are numbered from the row offA of the panel pA
+static void kernel_sgetrf_update_8_lib16(int m, int offA, float *pA, int sda, int jj, float inv, int n)
+	{
+	const int ps = 16;
+	int ii, ll, ii0, ii1;
+	__mmask16 msk;
+	__m512 v_0, c_0;
+	float *pU = pA + (offA+jj)/ps*ps*sda + (offA+jj)%ps;
+	float *pP;
+	for(ii=(offA+jj+1)/ps*ps; ii<offA+m; ii+=ps)
+		{
+		ii0 = offA+jj+1>ii ? offA+jj+1-ii : 0;
+		ii1 = offA+m<ii+ps ? offA+m-ii : ps;
+		msk = (__mmask16) ((0xffff<<ii0) & (0xffff>>(ps-ii1)));
+		pP = pA + ii/ps*ps*sda;
+		v_0 = _mm512_maskz_loadu_ps(msk, &pP[ps*jj]);
+		v_0 = _mm512_mul_ps(v_0, _mm512_set1_ps(inv));
+		_mm512_mask_storeu_ps(&pP[ps*jj], msk, v_0);
+		for(ll=jj+1; ll<n; ll++)
+			{
+			c_0 = _mm512_maskz_loadu_ps(msk, &pP[ps*ll]);
+			c_0 = _mm512_fnmadd_ps(v_0, _mm512_set1_ps(pU[ps*ll]), c_0);
+			_mm512_mask_storeu_ps(&pP[ps*ll], msk, c_0);
+			}
+		}
+	return;
+	}
+
+
+
+// LU factorization with partial pivoting of a panel of m rows and n<=8 columns,
+// starting at row offA of the panel pA; ipiv is relative to the first row
+void kernel_sgetrf_pivot_8_vs_lib16(int m, int offA, float *pA, int sda, float *inv_diag_A, int *ipiv, int n)
+	{
+	if(m<=0 | n<=0)
+		return;
+	const int ps = 16;
+	int ii, jj, ll, idamax;
+	float tmp0, tmp1, amax;
+	float *pR, *pS;
+	int jmax = m<n ? m : n;
+	for(jj=0; jj<jmax; jj++)
+		{
+		// pivot search
+		idamax = jj;
+		amax = -1.0;
+		for(ii=jj; ii<m; ii++)
+			{
+			tmp0 = fabsf(pA[(offA+ii)/ps*ps*sda+(offA+ii)%ps+ps*jj]);
+			if(tmp0>amax)
+				{
+				amax = tmp0;
+				idamax = ii;
+				}
+			}
+		ipiv[jj] = idamax;
+		// row swap
+		if(idamax!=jj)
+			{
+			pR = pA + (offA+jj)/ps*ps*sda + (offA+jj)%ps;
+			pS = pA + (offA+idamax)/ps*ps*sda + (offA+idamax)%ps;
+			for(ll=0; ll<n; ll++)
+				{
+				tmp1 = pR[ps*ll];
+				pR[ps*ll] = pS[ps*ll];
+				pS[ps*ll] = tmp1;
+				}
+			}
+		// pivot inversion, column scaling and update
+		tmp0 = 1.0 / pA[(offA+jj)/ps*ps*sda+(offA+jj)%ps+ps*jj];
+		inv_diag_A[jj] = tmp0;
+		kernel_sgetrf_update_8_lib16(m, offA, pA, sda, jj, tmp0, n);
+		}
+	return;
+	}
+
+
+
+// LU factorization without pivoting of a panel of m rows and n<=8 columns,
+// starting at row offA of the panel pA
+void kernel_sgetrf_np_8_vs_lib16(int m, int offA, float *pA, int sda, float *inv_diag_A, int n)
+	{
+	if(m<=0 | n<=0)
+		return;
+	const int ps = 16;
+	int jj;
+	float tmp0;
+	int jmax = m<n ? m : n;
+	for(jj=0; jj<jmax; jj++)
+		{
+		tmp0 = 1.0 / pA[(offA+jj)/ps*ps*sda+(offA+jj)%ps+ps*jj];
+		inv_diag_A[jj] = tmp0;
+		kernel_sgetrf_update_8_lib16(m, offA, pA, sda, jj, tmp0, n);
+		}
+	return;
+	}
+
+
@@ -2483,6 +2483,20 @@ void kernel_dsyrk_nt_l_4x4_gen_lib4(int kmax, double *alpha, double *A, double *
 
 		CC[3+bs*3] = beta[0]*C1[2+bs*3];
 		}
+
+	// with n0>0 the stored triangle is shifted right by n0 columns, load the part of C above the diagonal too
+	int ii, jj;
+	if(n0>0)
+		{
+		C1 = C0 + sdc*bs;
+		for(jj=n0; jj<bs; jj++)
+			{
+			for(ii=0; ii<jj; ii++)
+				{
+				CC[ii+bs*jj] = beta[0]*(offsetC+ii<bs ? C0[offsetC+ii+bs*jj] : C1[offsetC+ii-bs+bs*jj]);
+				}
+			}
+		}
 	
 	double beta1 = 1.0;
 
@@ -15,6 +15,16 @@ SHARED_LIBS += -lm
 LIBS += $(LIBS_EXTERNAL_BLAS)
 SHARED_LIBS += $(SHARED_LIBS_EXTERNAL_BLAS)
 
+LIBS += $(LIBS_MULTI_THREAD)
+SHARED_LIBS += $(LIBS_MULTI_THREAD)
+
+{% if test_macros.ROUTINE_CLASS == "codegen" -%}
+# fixed-size routines generated from codegen_spec.json, in the companion library blasfeo_fixed
+CODEGEN_PATH=$(ABS_BINARY_PATH)/codegen
+CFLAGS += -I$(CODEGEN_PATH)
+LIBS := $(CODEGEN_PATH)/libblasfeo_fixed.a $(LIBS)
+{% endif %}
+
 {% for flag, value in test_macros.items() %}
 {%- if value -%}
 	CFLAGS += -D{{flag | upper}}={{value}}
@@ -29,6 +39,10 @@ $(error No EXTERNAL_BLAS specified, install specify one reference blas implement
 {%- endif %}
 
 test.o:
+{%- if test_macros.ROUTINE_CLASS == "codegen" %}
+	# generate and build the fixed-size routines
+	$(MAKE) -C $(BLASFEO_PATH)/codegen static_library SPEC=$(TESTS_DIR)/codegen_spec.json BINARY_DIR=$(CODEGEN_PATH)
+{%- endif %}
 	# build executable obj $(ABS_BINARY_PATH)
 	$(CC) $(CFLAGS) -c $(TESTS_DIR)/test.c -o $(ABS_BINARY_PATH)/test.o
 	$(CC) $(CFLAGS) $(ABS_BINARY_PATH)/test.o -o $(ABS_BINARY_PATH)/test.out $(LIBS)
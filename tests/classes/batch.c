@@ -0,0 +1,123 @@
+// CLASS_BATCH
+//
+
+// the problems of the batch are taken from the same matrices: the inputs of problem p are shifted down by
+// p*BATCH_ROW_STRIDE rows (a multiple of the panel size, to keep the alignment of the offsets), and its result
+// is written p*BATCH_COL_STRIDE columns to the right
+#define BATCH_NB 3
+#define BATCH_ROW_STRIDE 8
+#define BATCH_COL_STRIDE 16
+// max size of the problems, for the results not to overlap
+#define BATCH_MAX_SIZE 12
+
+
+
+void call_routines(struct RoutineArgs *args)
+	{
+
+	struct blasfeo_dmat *sA[BATCH_NB];
+	struct blasfeo_dmat *sB[BATCH_NB];
+	struct blasfeo_dmat *sC[BATCH_NB];
+	struct blasfeo_dmat *sD[BATCH_NB];
+	int ai[BATCH_NB], aj[BATCH_NB];
+	int bi[BATCH_NB], bj[BATCH_NB];
+	int ci[BATCH_NB], cj[BATCH_NB];
+	int di[BATCH_NB], dj[BATCH_NB];
+	int ii;
+
+	if(!strcmp(string(ROUTINE), "dpotrf_l_batch"))
+		{
+		// principal sub-matrices of A_po, the first problem has the offsets of the sweep
+		for(ii=0; ii<BATCH_NB; ii++)
+			{
+			sC[ii] = args->sA_po;
+			ci[ii] = args->ai+ii*BATCH_ROW_STRIDE;
+			cj[ii] = args->aj+ii*BATCH_ROW_STRIDE;
+			sD[ii] = args->sD;
+			di[ii] = args->di;
+			dj[ii] = args->dj+ii*BATCH_COL_STRIDE;
+			}
+
+		blasfeo_dpotrf_l_batch(args->m, sC, ci, cj, sD, di, dj, BATCH_NB);
+
+		for(ii=0; ii<BATCH_NB; ii++)
+			{
+			blasfeo_ref_dpotrf_l(
+				args->m,
+				args->rA_po, ci[ii], cj[ii],
+				args->rD, di[ii], dj[ii]);
+			}
+		}
+	else // dgemm_nt_batch
+		{
+		for(ii=0; ii<BATCH_NB; ii++)
+			{
+			sA[ii] = args->sA;
+			ai[ii] = args->ai+ii*BATCH_ROW_STRIDE;
+			aj[ii] = args->aj;
+			sB[ii] = args->sB;
+			bi[ii] = args->bi+ii*BATCH_ROW_STRIDE;
+			bj[ii] = args->bj;
+			sC[ii] = args->sC;
+			ci[ii] = args->ci+ii*BATCH_ROW_STRIDE;
+			cj[ii] = args->cj;
+			sD[ii] = args->sD;
+			di[ii] = args->di;
+			dj[ii] = args->dj+ii*BATCH_COL_STRIDE;
+			}
+
+		blasfeo_dgemm_nt_batch(args->m, args->n, args->k, args->alpha, sA, ai, aj, sB, bi, bj, args->beta, sC, ci, cj, sD, di, dj, BATCH_NB);
+
+		for(ii=0; ii<BATCH_NB; ii++)
+			{
+			blasfeo_ref_dgemm_nt(
+				args->m, args->n, args->k,
+				args->alpha,
+				args->rA, ai[ii], aj[ii],
+				args->rB, bi[ii], bj[ii],
+				args->beta,
+				args->rC, ci[ii], cj[ii],
+				args->rD, di[ii], dj[ii]);
+			}
+		}
+
+	}
+
+
+
+void print_routine(struct RoutineArgs *args)
+	{
+	printf("blasfeo_%s(%d, %d, %d, %f, A, %d, %d, B, %d, %d, %f, C, %d, %d, D, %d, %d, %d);\n", string(ROUTINE), args->m, args->n, args->k, args->alpha, args->ai, args->aj, args->bi, args->bj, args->beta, args->ci, args->cj, args->di, args->dj, BATCH_NB);
+	}
+
+
+
+void print_routine_matrices(struct RoutineArgs *args)
+	{
+	printf("\nPrint D:\n");
+	blasfeo_print_xmat_debug(args->m, BATCH_NB*BATCH_COL_STRIDE, args->sD, args->di, args->dj, 0, 0, 0, "HP");
+	blasfeo_print_xmat_debug(args->m, BATCH_NB*BATCH_COL_STRIDE, args->rD, args->di, args->dj, 0, 0, 0, "REF");
+	}
+
+
+
+void set_test_args(struct TestArgs *targs)
+	{
+	// aligned and unaligned row offsets, for the kernel path and the full routine
+#if defined(MF_PANELMAJ)
+	targs->ais = 2;
+	targs->bis = 2;
+	targs->dis = 2;
+#endif
+	targs->xjs = 2;
+
+	// from below to above the size of one kernel
+	targs->nis = BATCH_MAX_SIZE;
+	if(strcmp(string(ROUTINE), "dpotrf_l_batch"))
+		{
+		targs->njs = BATCH_MAX_SIZE;
+		targs->nks = 5;
+		}
+
+	targs->alphas = 1;
+	}
@@ -0,0 +1,156 @@
+// CLASS_CODEGEN
+//
+
+// fixed-size routines generated from tests/codegen_spec.json, in the panel-major build only;
+// the sizes of the test are the ones of the spec, and the offset sweep covers the generic fallback
+#include "blasfeo_fixed.h"
+
+#define FIXED_GEMM_NN_M 11
+#define FIXED_GEMM_NN_K 7
+#define FIXED_GEMM_NT_M 13
+#define FIXED_GEMM_NT_K 5
+#define FIXED_SYRK_LN_M 10
+#define FIXED_SYRK_LN_K 7
+#define FIXED_TRSM_RLTN_M 9
+#define FIXED_POTRF_L_M 7
+#define FIXED_TRSV_M 9
+
+
+
+// the solution of trsv is stored in the column dj of D, from row di
+static void call_trsv(struct RoutineArgs *args, int lt)
+	{
+
+	struct blasfeo_dvec sx, sz, rx, rz;
+	blasfeo_allocate_dvec(args->m, &sx);
+	blasfeo_allocate_dvec(args->m, &sz);
+	blasfeo_allocate_dvec(args->m, &rx);
+	blasfeo_allocate_dvec(args->m, &rz);
+
+	blasfeo_dcolex(args->m, args->sB, args->bi, args->bj, &sx, 0);
+	blasfeo_ref_dcolex(args->m, args->rB, args->bi, args->bj, &rx, 0);
+
+	if(lt)
+		{
+		blasfeo_fix_dtrsv_ltn_9(args->sA, args->ai, args->aj, &sx, 0, &sz, 0);
+		blasfeo_ref_dtrsv_ltn(args->m, args->rA, args->ai, args->aj, &rx, 0, &rz, 0);
+		}
+	else
+		{
+		blasfeo_fix_dtrsv_lnn_9(args->sA, args->ai, args->aj, &sx, 0, &sz, 0);
+		blasfeo_ref_dtrsv_lnn(args->m, args->rA, args->ai, args->aj, &rx, 0, &rz, 0);
+		}
+
+	blasfeo_dcolin(args->m, &sz, 0, args->sD, args->di, args->dj);
+	blasfeo_ref_dcolin(args->m, &rz, 0, args->rD, args->di, args->dj);
+
+	blasfeo_free_dvec(&sx);
+	blasfeo_free_dvec(&sz);
+	blasfeo_free_dvec(&rx);
+	blasfeo_free_dvec(&rz);
+
+	}
+
+
+
+void call_routines(struct RoutineArgs *args)
+	{
+
+	if(!strcmp(string(ROUTINE), "dfixed_gemm_nn"))
+		{
+		blasfeo_fix_dgemm_nn_11x11x7(args->alpha, args->sA, args->ai, args->aj, args->sB, args->bi, args->bj, args->beta, args->sC, args->ci, args->cj, args->sD, args->di, args->dj);
+		blasfeo_ref_dgemm_nn(args->m, args->n, args->k, args->alpha, args->rA, args->ai, args->aj, args->rB, args->bi, args->bj, args->beta, args->rC, args->ci, args->cj, args->rD, args->di, args->dj);
+		}
+	else if(!strcmp(string(ROUTINE), "dfixed_gemm_nt"))
+		{
+		blasfeo_fix_dgemm_nt_13x13x5(args->alpha, args->sA, args->ai, args->aj, args->sB, args->bi, args->bj, args->beta, args->sC, args->ci, args->cj, args->sD, args->di, args->dj);
+		blasfeo_ref_dgemm_nt(args->m, args->n, args->k, args->alpha, args->rA, args->ai, args->aj, args->rB, args->bi, args->bj, args->beta, args->rC, args->ci, args->cj, args->rD, args->di, args->dj);
+		}
+	else if(!strcmp(string(ROUTINE), "dfixed_syrk_ln"))
+		{
+		blasfeo_fix_dsyrk_ln_10x7(args->alpha, args->sA, args->ai, args->aj, args->sB, args->bi, args->bj, args->beta, args->sC, args->ci, args->cj, args->sD, args->di, args->dj);
+		blasfeo_ref_dsyrk_ln(args->m, args->k, args->alpha, args->rA, args->ai, args->aj, args->rB, args->bi, args->bj, args->beta, args->rC, args->ci, args->cj, args->rD, args->di, args->dj);
+		}
+	else if(!strcmp(string(ROUTINE), "dfixed_trsm_rltn"))
+		{
+		blasfeo_fix_dtrsm_rltn_9x9(args->alpha, args->sA, args->ai, args->aj, args->sB, args->bi, args->bj, args->sD, args->di, args->dj);
+		blasfeo_ref_dtrsm_rltn(args->m, args->n, args->alpha, args->rA, args->ai, args->aj, args->rB, args->bi, args->bj, args->rD, args->di, args->dj);
+		}
+	else if(!strcmp(string(ROUTINE), "dfixed_potrf_l"))
+		{
+		blasfeo_fix_dpotrf_l_7(args->sA_po, args->ai, args->aj, args->sD, args->di, args->dj);
+		blasfeo_ref_dpotrf_l(args->m, args->rA_po, args->ai, args->aj, args->rD, args->di, args->dj);
+		}
+	else if(!strcmp(string(ROUTINE), "dfixed_trsv_lnn"))
+		{
+		call_trsv(args, 0);
+		}
+	else // dfixed_trsv_ltn
+		{
+		call_trsv(args, 1);
+		}
+
+	}
+
+
+
+void print_routine(struct RoutineArgs *args)
+	{
+	printf("blasfeo_%s(%d, %d, %d, %f, A, %d, %d, B, %d, %d, %f, C, %d, %d, D, %d, %d);\n", string(ROUTINE), args->m, args->n, args->k, args->alpha, args->ai, args->aj, args->bi, args->bj, args->beta, args->ci, args->cj, args->di, args->dj);
+	}
+
+
+
+void print_routine_matrices(struct RoutineArgs *args)
+	{
+	printf("\nPrint D:\n");
+	blasfeo_print_xmat_debug(args->m, args->n, args->sD, args->di, args->dj, 0, 0, 0, "HP");
+	blasfeo_print_xmat_debug(args->m, args->n, args->rD, args->di, args->dj, 0, 0, 0, "REF");
+	}
+
+
+
+void set_test_args(struct TestArgs *targs)
+	{
+	// aligned and unaligned row offsets
+	// the offsets of A are left to zero for potrf, for A_po to stay positive definite
+	if(strcmp(string(ROUTINE), "dfixed_potrf_l"))
+		{
+		targs->ais = 9;
+		targs->xjs = 2;
+		}
+	targs->bis = 9;
+	targs->dis = 9;
+
+	// square D, for the comparison to cover it
+	if(!strcmp(string(ROUTINE), "dfixed_gemm_nn"))
+		{
+		targs->ni0 = FIXED_GEMM_NN_M;
+		targs->nk0 = FIXED_GEMM_NN_K;
+		}
+	else if(!strcmp(string(ROUTINE), "dfixed_gemm_nt"))
+		{
+		targs->ni0 = FIXED_GEMM_NT_M;
+		targs->nk0 = FIXED_GEMM_NT_K;
+		}
+	else if(!strcmp(string(ROUTINE), "dfixed_syrk_ln"))
+		{
+		targs->ni0 = FIXED_SYRK_LN_M;
+		targs->nk0 = FIXED_SYRK_LN_K;
+		}
+	else if(!strcmp(string(ROUTINE), "dfixed_trsm_rltn"))
+		{
+		targs->ni0 = FIXED_TRSM_RLTN_M;
+		}
+	else if(!strcmp(string(ROUTINE), "dfixed_potrf_l"))
+		{
+		targs->ni0 = FIXED_POTRF_L_M;
+		}
+	else
+		{
+		targs->ni0 = FIXED_TRSV_M;
+		}
+	targs->nj0 = targs->ni0;
+
+	targs->alphas = 1;
+	}
@@ -0,0 +1,201 @@
+// CLASS_COMPACT
+//
+// the problems of the batch are taken from the same matrices: the inputs of problem p are shifted down by
+// p*COMPACT_ROW_STRIDE rows (and right as well, for the factorizations of A_po), and packed at the offsets of the
+// sweep in the compact batches; the result of problem p is unpacked p*COMPACT_MAX_SIZE rows down in D
+//
+// the results are compared over the first n rows and m columns of D: the result of each problem has k rows and
+// m columns, and the inner size of dgemm is m+k-1
+
+// not a multiple of the vector length, for a partially filled last group
+#define COMPACT_NB 7
+#define COMPACT_ROW_STRIDE 6
+// max number of rows and columns of the results
+#define COMPACT_MAX_SIZE 8
+// size of the matrices of the compact batches, for the offsets and the largest inner size
+#define COMPACT_SIZE (2*COMPACT_MAX_SIZE+2)
+
+// the routine name is d<variant>, e.g. dgemm_nn_compact
+#define COMPACT_VARIANT (string(ROUTINE)+1)
+
+
+
+// pack the m x n sub-matrices of the problems, at row i0 (and column j0) shifted by the problem, at bi, bj of sB
+static void compact_pack(int m, int n, struct STRMAT_REF *rA, int i0, int j0, int diag, struct blasfeo_dmat_compact *sB, int bi, int bj, double *work)
+	{
+	double *pA[COMPACT_NB];
+	int ii, jj, pp, r0;
+	for(pp=0; pp<COMPACT_NB; pp++)
+		{
+		pA[pp] = work + pp*COMPACT_SIZE*COMPACT_SIZE;
+		r0 = pp*COMPACT_ROW_STRIDE;
+		for(jj=0; jj<n; jj++)
+			{
+			for(ii=0; ii<m; ii++)
+				{
+				pA[pp][ii+jj*COMPACT_SIZE] = MATEL_REF(rA, i0+r0+ii, j0+(diag ? r0 : 0)+jj);
+				}
+			}
+		}
+	blasfeo_pack_dmat_compact(m, n, pA, COMPACT_SIZE, sB, bi, bj);
+	}
+
+
+
+// unpack the m x n results of the problems at ai, aj of sA, to D
+static void compact_unpack(int m, int n, struct blasfeo_dmat_compact *sA, int ai, int aj, struct STRMAT *sD, double *work)
+	{
+	double *pD[COMPACT_NB];
+	int ii, jj, pp;
+	for(pp=0; pp<COMPACT_NB; pp++)
+		pD[pp] = work + pp*COMPACT_SIZE*COMPACT_SIZE;
+	blasfeo_unpack_dmat_compact(m, n, sA, ai, aj, pD, COMPACT_SIZE);
+	for(pp=0; pp<COMPACT_NB; pp++)
+		{
+		for(jj=0; jj<n; jj++)
+			{
+			for(ii=0; ii<m; ii++)
+				{
+				MATEL_LIBSTR(sD, pp*COMPACT_MAX_SIZE+ii, jj) = pD[pp][ii+jj*COMPACT_SIZE];
+				}
+			}
+		}
+	}
+
+
+
+void call_routines(struct RoutineArgs *args)
+	{
+
+	const char *v = COMPACT_VARIANT;
+	int pp, r0;
+
+	int m = args->k;
+	int n = args->m;
+	int k = args->m+args->k-1;
+
+	struct blasfeo_dmat_compact cA, cB, cC, cD;
+	blasfeo_allocate_dmat_compact(COMPACT_SIZE, COMPACT_SIZE, COMPACT_NB, &cA);
+	blasfeo_allocate_dmat_compact(COMPACT_SIZE, COMPACT_SIZE, COMPACT_NB, &cB);
+	blasfeo_allocate_dmat_compact(COMPACT_SIZE, COMPACT_SIZE, COMPACT_NB, &cC);
+	blasfeo_allocate_dmat_compact(COMPACT_SIZE, COMPACT_SIZE, COMPACT_NB, &cD);
+	double *work;
+	d_zeros(&work, COMPACT_NB*COMPACT_SIZE, COMPACT_SIZE);
+
+	// D as in the reference matrix, for the entries not written by the routine
+	compact_pack(COMPACT_SIZE, COMPACT_SIZE, args->rD, 0, 0, 0, &cD, 0, 0, work);
+
+	if(!strcmp(v, "gemm_nn_compact") | !strcmp(v, "gemm_nt_compact"))
+		{
+		int nt = !strcmp(v, "gemm_nt_compact");
+		compact_pack(m, k, args->rA, 0, 0, 0, &cA, args->ai, args->aj, work);
+		if(nt)
+			compact_pack(n, k, args->rB, 0, 0, 0, &cB, args->bi, args->bj, work);
+		else
+			compact_pack(k, n, args->rB, 0, 0, 0, &cB, args->bi, args->bj, work);
+		compact_pack(m, n, args->rC, 0, 0, 0, &cC, args->ci, args->cj, work);
+
+		if(nt)
+			blasfeo_dgemm_nt_compact(m, n, k, args->alpha, &cA, args->ai, args->aj, &cB, args->bi, args->bj, args->beta, &cC, args->ci, args->cj, &cD, args->di, args->dj);
+		else
+			blasfeo_dgemm_nn_compact(m, n, k, args->alpha, &cA, args->ai, args->aj, &cB, args->bi, args->bj, args->beta, &cC, args->ci, args->cj, &cD, args->di, args->dj);
+
+		for(pp=0; pp<COMPACT_NB; pp++)
+			{
+			r0 = pp*COMPACT_ROW_STRIDE;
+			if(nt)
+				blasfeo_ref_dgemm_nt(m, n, k, args->alpha, args->rA, r0, 0, args->rB, r0, 0, args->beta, args->rC, r0, 0, args->rD, pp*COMPACT_MAX_SIZE, 0);
+			else
+				blasfeo_ref_dgemm_nn(m, n, k, args->alpha, args->rA, r0, 0, args->rB, r0, 0, args->beta, args->rC, r0, 0, args->rD, pp*COMPACT_MAX_SIZE, 0);
+			}
+		}
+	else if(!strcmp(v, "trsm_rltn_compact"))
+		{
+		compact_pack(n, n, args->rA_po, 0, 0, 1, &cA, args->ai, args->aj, work);
+		compact_pack(m, n, args->rB, 0, 0, 0, &cB, args->bi, args->bj, work);
+
+		blasfeo_dtrsm_rltn_compact(m, n, args->alpha, &cA, args->ai, args->aj, &cB, args->bi, args->bj, &cD, args->di, args->dj);
+
+		for(pp=0; pp<COMPACT_NB; pp++)
+			{
+			r0 = pp*COMPACT_ROW_STRIDE;
+			blasfeo_ref_dtrsm_rltn(m, n, args->alpha, args->rA_po, r0, r0, args->rB, r0, 0, args->rD, pp*COMPACT_MAX_SIZE, 0);
+			}
+		}
+	else if(!strcmp(v, "potrf_l_compact"))
+		{
+		// square factorization of size n
+		m = n;
+		compact_pack(n, n, args->rA_po, 0, 0, 1, &cC, args->ci, args->cj, work);
+
+		blasfeo_dpotrf_l_compact(n, &cC, args->ci, args->cj, &cD, args->di, args->dj);
+
+		for(pp=0; pp<COMPACT_NB; pp++)
+			{
+			r0 = pp*COMPACT_ROW_STRIDE;
+			blasfeo_ref_dpotrf_l(n, args->rA_po, r0, r0, args->rD, pp*COMPACT_MAX_SIZE, 0);
+			}
+		}
+	else // getrf_np_compact
+		{
+		// tall and square factorizations: for m<n the reference routine also writes the rows below m
+		n = n<m ? n : m;
+		compact_pack(m, n, args->rA_po, 0, 0, 1, &cC, args->ci, args->cj, work);
+
+		blasfeo_dgetrf_np_compact(m, n, &cC, args->ci, args->cj, &cD, args->di, args->dj);
+
+		for(pp=0; pp<COMPACT_NB; pp++)
+			{
+			r0 = pp*COMPACT_ROW_STRIDE;
+			blasfeo_ref_dgetrf_np(m, n, args->rA_po, r0, r0, args->rD, pp*COMPACT_MAX_SIZE, 0);
+			}
+		}
+
+	compact_unpack(m, n, &cD, args->di, args->dj, args->sD, work);
+
+	d_free(work);
+	blasfeo_free_dmat_compact(&cA);
+	blasfeo_free_dmat_compact(&cB);
+	blasfeo_free_dmat_compact(&cC);
+	blasfeo_free_dmat_compact(&cD);
+
+	}
+
+
+
+void print_routine(struct RoutineArgs *args)
+	{
+	printf("blasfeo_%s(%d, %d, %d, %f, A, %d, %d, B, %d, %d, %f, C, %d, %d, D, %d, %d); nb = %d\n", COMPACT_VARIANT, args->k, args->m, args->m+args->k-1, args->alpha, args->ai, args->aj, args->bi, args->bj, args->beta, args->ci, args->cj, args->di, args->dj, COMPACT_NB);
+	}
+
+
+
+void print_routine_matrices(struct RoutineArgs *args)
+	{
+	printf("\nPrint D:\n");
+	blasfeo_print_xmat_debug(COMPACT_NB*COMPACT_MAX_SIZE, args->m, args->sD, 0, 0, 0, 0, 0, "HP");
+	blasfeo_print_xmat_debug(COMPACT_NB*COMPACT_MAX_SIZE, args->m, args->rD, 0, 0, 0, 0, 0, "REF");
+	}
+
+
+
+void set_test_args(struct TestArgs *targs)
+	{
+	// zero and nonzero offsets in the compact batches
+	targs->ais = 2;
+	targs->bis = 2;
+	targs->dis = 2;
+	targs->xjs = 2;
+
+	// m and k from one to the max size, across the kernel size; n covers the results of all the problems
+	targs->ni0 = 1;
+	targs->nis = COMPACT_MAX_SIZE;
+	targs->nk0 = 1;
+	targs->nks = COMPACT_MAX_SIZE;
+	targs->nj0 = COMPACT_NB*COMPACT_MAX_SIZE;
+	targs->njs = 1;
+
+	// alpha one and any other
+	targs->alphas = 2;
+	targs->alpha_l[1] = 0.02;
+	}
@@ -0,0 +1,166 @@
+// CLASS_FP16
+//
+// the half-precision matrix is A rounded to half precision, and the reference routines run in single precision on
+// the same rounded values; the conversions are compared against the scalar conversion routines
+
+// a wrong rounding of the conversions is a relative error of about 2^-11, the sums of hgemm and hgemv are over
+// positive terms
+#define REL_TOL 1e-5
+
+// the routine name is s<variant>, e.g. shgemm_nt
+#define FP16_VARIANT (string(ROUTINE)+1)
+
+
+
+void call_routines(struct RoutineArgs *args)
+	{
+
+	const char *v = FP16_VARIANT;
+	int ii, jj;
+
+	// all the test matrices have the same size
+	int n_max = args->sA->m;
+
+	struct blasfeo_hmat sH;
+	blasfeo_allocate_hmat(n_max, n_max, &sH);
+
+	// A rounded to half precision, for the reference routines
+	struct STRMAT_REF rH;
+	ALLOCATE_STRMAT_REF(n_max, n_max, &rH);
+	for(jj=0; jj<n_max; jj++)
+		{
+		for(ii=0; ii<n_max; ii++)
+			{
+			BLASFEO_HMATEL(&sH, ii, jj) = blasfeo_cvt_s2h(MATEL_LIBSTR(args->sA, ii, jj));
+			MATEL_REF(&rH, ii, jj) = blasfeo_cvt_h2s(blasfeo_cvt_s2h(MATEL_REF(args->rA, ii, jj)));
+			}
+		}
+
+	if(!strcmp(v, "cvt_s2h"))
+		{
+		// A is converted at the row offset of B, to also cover different alignments of the two matrices
+		blasfeo_cvt_s2h_mat(args->m, args->n, args->sA, args->ai, args->aj, &sH, args->bi, args->aj);
+		for(jj=0; jj<args->n; jj++)
+			{
+			for(ii=0; ii<args->m; ii++)
+				{
+				MATEL_LIBSTR(args->sD, args->di+ii, args->dj+jj) = blasfeo_cvt_h2s(BLASFEO_HMATEL(&sH, args->bi+ii, args->aj+jj));
+				}
+			}
+		blasfeo_ref_sgecp(args->m, args->n, &rH, args->ai, args->aj, args->rD, args->di, args->dj);
+		}
+	else if(!strcmp(v, "cvt_h2s"))
+		{
+		blasfeo_cvt_h2s_mat(args->m, args->n, &sH, args->ai, args->aj, args->sD, args->di, args->dj);
+		blasfeo_ref_sgecp(args->m, args->n, &rH, args->ai, args->aj, args->rD, args->di, args->dj);
+		}
+	else if(!strcmp(v, "hgemm_nt"))
+		{
+		blasfeo_hgemm_nt(
+			args->m, args->n, args->k,
+			args->alpha,
+			&sH, args->ai, args->aj,
+			args->sB, args->bi, args->bj,
+			args->beta,
+			args->sC, args->ci, args->cj,
+			args->sD, args->di, args->dj);
+		blasfeo_ref_sgemm_nt(
+			args->m, args->n, args->k,
+			args->alpha,
+			&rH, args->ai, args->aj,
+			args->rB, args->bi, args->bj,
+			args->beta,
+			args->rC, args->ci, args->cj,
+			args->rD, args->di, args->dj);
+		}
+	else // hgemv_n, hgemv_t
+		{
+		// x is a column of B and y a column of C, z is copied to a column of D
+		struct STRVEC sx, sy, sz;
+		struct STRVEC_REF rx, ry, rz;
+		blasfeo_allocate_svec(n_max, &sx);
+		blasfeo_allocate_svec(n_max, &sy);
+		blasfeo_allocate_svec(n_max, &sz);
+		blasfeo_allocate_svec(n_max, &rx);
+		blasfeo_allocate_svec(n_max, &ry);
+		blasfeo_allocate_svec(n_max, &rz);
+		for(ii=0; ii<n_max; ii++)
+			{
+			VECEL_LIBSTR(&sx, ii) = MATEL_LIBSTR(args->sB, ii, args->bj);
+			VECEL_LIBSTR(&sy, ii) = MATEL_LIBSTR(args->sC, ii, args->cj);
+			VECEL_LIBSTR(&sz, ii) = -1.0;
+			VECEL_REF(&rx, ii) = MATEL_REF(args->rB, ii, args->bj);
+			VECEL_REF(&ry, ii) = MATEL_REF(args->rC, ii, args->cj);
+			VECEL_REF(&rz, ii) = -1.0;
+			}
+
+		int nz = args->m;
+		if(!strcmp(v, "hgemv_n"))
+			{
+			blasfeo_hgemv_n(args->m, args->n, args->alpha, &sH, args->ai, args->aj, &sx, args->bi, args->beta, &sy, args->ci, &sz, args->di);
+			blasfeo_ref_sgemv_n(args->m, args->n, args->alpha, &rH, args->ai, args->aj, &rx, args->bi, args->beta, &ry, args->ci, &rz, args->di);
+			}
+		else
+			{
+			nz = args->n;
+			blasfeo_hgemv_t(args->m, args->n, args->alpha, &sH, args->ai, args->aj, &sx, args->bi, args->beta, &sy, args->ci, &sz, args->di);
+			blasfeo_ref_sgemv_t(args->m, args->n, args->alpha, &rH, args->ai, args->aj, &rx, args->bi, args->beta, &ry, args->ci, &rz, args->di);
+			}
+
+		for(ii=0; ii<nz; ii++)
+			{
+			MATEL_LIBSTR(args->sD, args->di+ii, args->dj) = VECEL_LIBSTR(&sz, args->di+ii);
+			MATEL_REF(args->rD, args->di+ii, args->dj) = VECEL_REF(&rz, args->di+ii);
+			}
+
+		blasfeo_free_svec(&sx);
+		blasfeo_free_svec(&sy);
+		blasfeo_free_svec(&sz);
+		blasfeo_free_svec(&rx);
+		blasfeo_free_svec(&ry);
+		blasfeo_free_svec(&rz);
+		}
+
+	blasfeo_free_hmat(&sH);
+	FREE_STRMAT_REF(&rH);
+
+	}
+
+
+
+void print_routine(struct RoutineArgs *args)
+	{
+	printf("blasfeo_%s(%d, %d, %d, %f, A, %d, %d, B, %d, %d, %f, C, %d, %d, D, %d, %d);\n", FP16_VARIANT, args->m, args->n, args->k, args->alpha, args->ai, args->aj, args->bi, args->bj, args->beta, args->ci, args->cj, args->di, args->dj);
+	}
+
+
+
+void print_routine_matrices(struct RoutineArgs *args)
+	{
+	printf("\nPrint D:\n");
+	blasfeo_print_xmat_debug(args->m, args->n, args->sD, args->di, args->dj, 0, 0, 0, "HP");
+	blasfeo_print_xmat_debug(args->m, args->n, args->rD, args->di, args->dj, 0, 0, 0, "REF");
+	}
+
+
+
+void set_test_args(struct TestArgs *targs)
+	{
+	// aligned and unaligned row offsets, for the kernels and the scalar loops
+	targs->ais = 2;
+	targs->bis = 2;
+	targs->dis = 2;
+	targs->xjs = 2;
+
+	// m crossing the half-precision panel size, n crossing the kernel width; the results are compared over
+	// the first n rows and m columns of D, that cover the vector results of hgemv_n for n>=m+di
+	targs->ni0 = 1;
+	targs->nis = 19;
+	targs->nj0 = 21;
+	targs->njs = 6;
+	targs->nks = 6;
+
+	// alpha one and any other
+	targs->alphas = 2;
+	targs->alpha_l[1] = 0.02;
+	}
@@ -96,6 +96,15 @@ void set_test_args(struct TestArgs *targs)
 	targs->xjs = 2;
 #endif
 
+#if defined(NUM_THREADS)
+	// enough work to split it over the threads
+	targs->ni0 = 100;
+	targs->nj0 = 100;
+	targs->nk0 = 100;
+	targs->nis = 2;
+	targs->njs = 2;
+	targs->nks = 2;
+#else
 #if defined(TARGET_X64_INTEL_SKYLAKE_X)
 	targs->nis = 25;
 	targs->njs = 25;
@@ -104,6 +113,7 @@ void set_test_args(struct TestArgs *targs)
 	targs->njs = 5;
 #endif
 	targs->nks = 6;
+#endif
 
 	targs->alphas = 1;
 	}
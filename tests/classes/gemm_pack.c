@@ -0,0 +1,110 @@
+// CLASS_GEMM_PACK
+//
+
+// the pre-packed left factor is only available in the column-major high-performance build;
+// with k around 200 the columns of D are split in more than one block on all targets
+#define TEST_LARGE 1
+
+// the routine name is dgemm_pack_<ta><tb>, e.g. dgemm_pack_tn packs A^T and calls the compute_n routine
+#define PACK_VARIANT (string(ROUTINE)+11)
+
+
+
+typedef void (*ref_gemm_t)(int, int, int, REAL, struct STRMAT_REF *, int, int, struct STRMAT_REF *, int, int, REAL, struct STRMAT_REF *, int, int, struct STRMAT_REF *, int, int);
+
+static const char *gemm_var[] = {"nn", "nt", "tn", "tt"};
+static ref_gemm_t gemm_ref[] = {blasfeo_ref_dgemm_nn, blasfeo_ref_dgemm_nt, blasfeo_ref_dgemm_tn, blasfeo_ref_dgemm_tt};
+
+
+
+void call_routines(struct RoutineArgs *args)
+	{
+
+	const char *v = PACK_VARIANT;
+	struct blasfeo_pm_dmat sP;
+	void *mem;
+	int ii, idx;
+
+	for(idx=0; idx<4; idx++)
+		{
+		if(!strcmp(v, gemm_var[idx]))
+			break;
+		}
+
+	v_zeros_align(&mem, blasfeo_dgemm_pack_memsize(args->m, args->k));
+
+	blasfeo_dgemm_pack(v[0], args->m, args->k, args->sA, args->ai, args->aj, &sP, mem);
+
+	// two calls on the same packed matrix, the second one accumulating on D
+	for(ii=0; ii<2; ii++)
+		{
+		if(v[1]=='n')
+			blasfeo_dgemm_compute_n(args->n,
+				args->alpha,
+				&sP,
+				args->sB, args->bi, args->bj,
+				args->beta,
+				ii==0 ? args->sC : args->sD, ii==0 ? args->ci : args->di, ii==0 ? args->cj : args->dj,
+				args->sD, args->di, args->dj);
+		else
+			blasfeo_dgemm_compute_t(args->n,
+				args->alpha,
+				&sP,
+				args->sB, args->bi, args->bj,
+				args->beta,
+				ii==0 ? args->sC : args->sD, ii==0 ? args->ci : args->di, ii==0 ? args->cj : args->dj,
+				args->sD, args->di, args->dj);
+
+		gemm_ref[idx](
+			args->m, args->n, args->k,
+			args->alpha,
+			args->rA, args->ai, args->aj,
+			args->rB, args->bi, args->bj,
+			args->beta,
+			ii==0 ? args->rC : args->rD, ii==0 ? args->ci : args->di, ii==0 ? args->cj : args->dj,
+			args->rD, args->di, args->dj);
+		}
+
+	v_free_align(mem);
+
+	}
+
+
+
+void print_routine(struct RoutineArgs *args)
+	{
+	printf("blasfeo_%s(%d, %d, %d, %f, A, %d, %d, B, %d, %d, %f, C, %d, %d, D, %d, %d);\n", string(ROUTINE), args->m, args->n, args->k, args->alpha, args->ai, args->aj, args->bi, args->bj, args->beta, args->ci, args->cj, args->di, args->dj);
+	}
+
+
+
+void print_routine_matrices(struct RoutineArgs *args)
+	{
+	printf("\nPrint D:\n");
+	blasfeo_print_xmat_debug(args->m, args->n, args->sD, args->di, args->dj, 0, 0, 0, "HP");
+	blasfeo_print_xmat_debug(args->m, args->n, args->rD, args->di, args->dj, 0, 0, 0, "REF");
+	}
+
+
+
+void set_test_args(struct TestArgs *targs)
+	{
+	targs->ais = 2;
+	targs->bis = 2;
+	targs->dis = 2;
+	targs->xjs = 2;
+
+	// m crossing the remainders of the panel sizes 4 and 8, n and k around 200
+	targs->ni0 = 190;
+	targs->nis = 9;
+	targs->nj0 = 190;
+	targs->njs = 2;
+	targs->nk0 = 190;
+	targs->nks = 2;
+
+	// beta zero and any other
+	targs->alphas = 1;
+	targs->betas = 2;
+	targs->beta_l[0] = 0.0;
+	targs->beta_l[1] = 0.02;
+	}
@@ -0,0 +1,221 @@
+// CLASS_GEQRF_TSQR/GELQF_TSLQ
+//
+// the apply routines dormqr_tsqr_lt and dormlq_tslq_rt are tested on A itself: Q^T * A = [R; 0] and A * Q^T = [L, 0];
+// dormqr_lt is tested the same way, with the reflectors of the blocked factorization dgeqrf
+
+// the tall-skinny alg needs several leaf blocks
+#define TEST_LARGE 1
+// the error on the small entries of R is relative to the norm of their row, over about 600 rows
+#define REL_TOL 1e-9
+
+
+
+// only the triangular factor is compared: the reflectors written by the reference routine are reset
+// (to zero for the apply routines), and the sign of each row of R (column of L) is fixed by a positive diagonal
+static void normalize_factor(int lq, int apply, int m, int n, struct RoutineArgs *args)
+	{
+	int ii, jj;
+	int p = m<n ? m : n;
+	for(ii=0; ii<m; ii++)
+		{
+		for(jj=0; jj<n; jj++)
+			{
+			if(lq ? jj>ii : ii>jj)
+				MATEL_REF(args->rD, args->di+ii, args->dj+jj) = apply ? 0.0 : -1.0;
+			}
+		}
+	for(ii=0; ii<p; ii++)
+		{
+		if(MATEL_LIBSTR(args->sD, args->di+ii, args->dj+ii)<0)
+			{
+			for(jj=ii; jj<p; jj++)
+				{
+				if(lq)
+					MATEL_LIBSTR(args->sD, args->di+jj, args->dj+ii) *= -1.0;
+				else
+					MATEL_LIBSTR(args->sD, args->di+ii, args->dj+jj) *= -1.0;
+				}
+			}
+		if(MATEL_REF(args->rD, args->di+ii, args->dj+ii)<0)
+			{
+			for(jj=ii; jj<p; jj++)
+				{
+				if(lq)
+					MATEL_REF(args->rD, args->di+jj, args->dj+ii) *= -1.0;
+				else
+					MATEL_REF(args->rD, args->di+ii, args->dj+jj) *= -1.0;
+				}
+			}
+		}
+	}
+
+
+
+// the entries of Q^T * A below R (of A * Q^T right of L) are zero up to rounding: they are set to zero if small with
+// respect to the diagonal element of their column (row), and otherwise kept for the comparison to fail
+static void flush_zeros(int lq, int m, int n, struct RoutineArgs *args)
+	{
+	int ii, jj;
+	REAL dii;
+	for(ii=0; ii<m; ii++)
+		{
+		for(jj=0; jj<n; jj++)
+			{
+			if(lq ? jj>ii : ii>jj)
+				{
+				dii = lq ? MATEL_LIBSTR(args->sD, args->di+ii, args->dj+ii) : MATEL_LIBSTR(args->sD, args->di+jj, args->dj+jj);
+				if(fabs(MATEL_LIBSTR(args->sD, args->di+ii, args->dj+jj))<=REL_TOL*fabs(dii))
+					MATEL_LIBSTR(args->sD, args->di+ii, args->dj+jj) = 0.0;
+				}
+			}
+		}
+	}
+
+
+
+void call_routines(struct RoutineArgs *args)
+	{
+
+	int lq = !strcmp(string(ROUTINE), "dgelqf_tslq") | !strcmp(string(ROUTINE), "dormlq_tslq_rt");
+	int blocked = !strcmp(string(ROUTINE), "dormqr_lt");
+	int apply = blocked | !strcmp(string(ROUTINE), "dormqr_tsqr_lt") | !strcmp(string(ROUTINE), "dormlq_tslq_rt");
+
+	// tall-skinny QR, short-wide LQ
+	if(lq ? args->m>args->n : args->m<args->n)
+		return;
+
+	// allocate memory for work
+	size_t memsize = lq ? blasfeo_dgelqf_tslq_worksize(args->m, args->n) : blocked ? blasfeo_dgeqrf_worksize(args->m, args->n) : blasfeo_dgeqrf_tsqr_worksize(args->m, args->n);
+	void *mem;
+	v_zeros_align(&mem, memsize);
+
+	int ref_memsize = lq ? blasfeo_ref_dgelqf_worksize(args->m, args->n) : blasfeo_ref_dgeqrf_worksize(args->m, args->n);
+	void *ref_mem;
+	v_zeros_align(&ref_mem, ref_memsize);
+
+	// routine call
+	//
+	if(blocked)
+		{
+		// the reflectors are stored below the diagonal of F, and their scalar factors in F
+		struct STRMAT sF;
+		ALLOCATE_STRMAT(args->m, args->n, &sF);
+		blasfeo_dgeqrf(
+			args->m, args->n,
+			args->sA_po, args->ai, args->aj,
+			&sF, 0, 0,
+			mem
+			);
+		blasfeo_dormqr_lt(
+			args->m, args->n, args->n,
+			&sF, 0, 0,
+			args->sA_po, args->ai, args->aj,
+			args->sD, args->di, args->dj
+			);
+		FREE_STRMAT(&sF);
+		flush_zeros(lq, args->m, args->n, args);
+		}
+	else if(lq)
+		blasfeo_dgelqf_tslq(
+			args->m, args->n,
+			args->sA_po, args->ai, args->aj,
+			args->sD, args->di, args->dj,
+			mem
+			);
+	else
+		blasfeo_dgeqrf_tsqr(
+			args->m, args->n,
+			args->sA_po, args->ai, args->aj,
+			args->sD, args->di, args->dj,
+			mem
+			);
+
+	// the factor is overwritten by the orthogonal factor applied to A
+	if(apply & !blocked)
+		{
+		if(lq)
+			blasfeo_dormlq_tslq_rt(
+				args->m, args->n, args->m,
+				args->sA_po, args->ai, args->aj,
+				args->sD, args->di, args->dj,
+				mem
+				);
+		else
+			blasfeo_dormqr_tsqr_lt(
+				args->m, args->n, args->n,
+				args->sA_po, args->ai, args->aj,
+				args->sD, args->di, args->dj,
+				mem
+				);
+		flush_zeros(lq, args->m, args->n, args);
+		}
+
+	if(lq)
+		blasfeo_ref_dgelqf(
+			args->m, args->n,
+			args->rA_po, args->ai, args->aj,
+			args->rD, args->di, args->dj,
+			ref_mem
+			);
+	else
+		blasfeo_ref_dgeqrf(
+			args->m, args->n,
+			args->rA_po, args->ai, args->aj,
+			args->rD, args->di, args->dj,
+			ref_mem
+			);
+
+	normalize_factor(lq, apply, args->m, args->n, args);
+
+	// free memory
+	v_free_align(mem);
+	v_free_align(ref_mem);
+
+	}
+
+
+
+void print_routine(struct RoutineArgs *args)
+	{
+	printf("blasfeo_%s(%d, %d, A, %d, %d, D, %d, %d, work);\n", string(ROUTINE), args->m, args->n, args->ai, args->aj, args->di, args->dj);
+	}
+
+
+
+void print_routine_matrices(struct RoutineArgs *args)
+	{
+	printf("\nPrint A:\n");
+	blasfeo_print_xmat_debug(args->m, args->n, args->sA_po, args->ai, args->aj, 0, 0, 0, "HP");
+	blasfeo_print_xmat_debug(args->m, args->n, args->rA_po, args->ai, args->aj, 0, 0, 0, "REF");
+
+	printf("\nPrint R (L), or Q^T * A (A * Q^T):\n");
+	blasfeo_print_xmat_debug(args->m, args->n, args->sD, args->di, args->dj, 0, 0, 0, "HP");
+	blasfeo_print_xmat_debug(args->m, args->n, args->rD, args->di, args->dj, 0, 0, 0, "REF");
+	}
+
+
+
+void set_test_args(struct TestArgs *targs)
+	{
+	// three leaf blocks of 32768 elements
+	int nl = 590;
+	int ns = 180;
+	if(!strcmp(string(ROUTINE), "dgelqf_tslq") | !strcmp(string(ROUTINE), "dormlq_tslq_rt"))
+		{
+		targs->ni0 = ns;
+		targs->nj0 = nl;
+		}
+	else
+		{
+		targs->ni0 = nl;
+		targs->nj0 = ns;
+		}
+	targs->nis = 4;
+	targs->njs = 4;
+#if defined(MF_PANELMAJ)
+	targs->ais = 2;
+	targs->dis = 2;
+#endif
+
+	targs->alphas = 1;
+	}
@@ -0,0 +1,101 @@
+// CLASS_GESV_MIXED/POSV_MIXED
+//
+
+// the mixed-precision path is only taken for n>=512
+#define TEST_LARGE 1
+
+
+
+// args->n is the size of the system and args->m the number of right-hand sides,
+// the solution being compared over the first args->n rows
+void call_routines(struct RoutineArgs *args)
+	{
+
+	int ii, jj;
+	REAL tmp;
+
+	int po = !strcmp(string(ROUTINE), "dposv_mixed");
+
+	// routine call
+	//
+	BLASFEO(ROUTINE)(
+		args->n, args->m,
+		po ? args->sA_po : args->sA, args->ai, args->aj,
+		args->sB, args->bi, args->bj,
+		args->sD, args->di, args->dj
+		);
+
+	// reference solution, with a double-precision factorization
+	struct STRMAT_REF rF;
+	ALLOCATE_STRMAT_REF(args->n, args->n, &rF);
+
+	blasfeo_ref_dgecp(args->n, args->m, args->rB, args->bi, args->bj, args->rD, args->di, args->dj);
+	if(po)
+		{
+		blasfeo_ref_dpotrf_l(args->n, args->rA_po, args->ai, args->aj, &rF, 0, 0);
+		blasfeo_ref_dtrsm_llnn(args->n, args->m, 1.0, &rF, 0, 0, args->rD, args->di, args->dj, args->rD, args->di, args->dj);
+		blasfeo_ref_dtrsm_lltn(args->n, args->m, 1.0, &rF, 0, 0, args->rD, args->di, args->dj, args->rD, args->di, args->dj);
+		}
+	else
+		{
+		blasfeo_ref_dgetrf_rp(args->n, args->n, args->rA, args->ai, args->aj, &rF, 0, 0, args->ripiv);
+		for(ii=0; ii<args->n; ii++)
+			{
+			if(args->ripiv[ii]!=ii)
+				{
+				for(jj=0; jj<args->m; jj++)
+					{
+					tmp = MATEL_REF(args->rD, args->di+ii, args->dj+jj);
+					MATEL_REF(args->rD, args->di+ii, args->dj+jj) = MATEL_REF(args->rD, args->di+args->ripiv[ii], args->dj+jj);
+					MATEL_REF(args->rD, args->di+args->ripiv[ii], args->dj+jj) = tmp;
+					}
+				}
+			}
+		blasfeo_ref_dtrsm_llnu(args->n, args->m, 1.0, &rF, 0, 0, args->rD, args->di, args->dj, args->rD, args->di, args->dj);
+		blasfeo_ref_dtrsm_lunn(args->n, args->m, 1.0, &rF, 0, 0, args->rD, args->di, args->dj, args->rD, args->di, args->dj);
+		}
+
+	FREE_STRMAT_REF(&rF);
+
+	}
+
+
+
+void print_routine(struct RoutineArgs *args)
+	{
+	printf("blasfeo_%s(%d, %d, A, %d, %d, B, %d, %d, X, %d, %d);\n", string(ROUTINE), args->n, args->m, args->ai, args->aj, args->bi, args->bj, args->di, args->dj);
+	}
+
+
+
+void print_routine_matrices(struct RoutineArgs *args)
+	{
+	printf("\nPrint B:\n");
+	blasfeo_print_xmat_debug(args->n, args->m, args->sB, args->bi, args->bj, 0, 0, 0, "HP");
+	blasfeo_print_xmat_debug(args->n, args->m, args->rB, args->bi, args->bj, 0, 0, 0, "REF");
+
+	printf("\nPrint X:\n");
+	blasfeo_print_xmat_debug(args->n, args->m, args->sD, args->di, args->dj, 0, 0, 0, "HP");
+	blasfeo_print_xmat_debug(args->n, args->m, args->rD, args->di, args->dj, 0, 0, 0, "REF");
+	}
+
+
+
+void set_test_args(struct TestArgs *targs)
+	{
+	// right-hand sides
+	targs->ni0 = 1;
+	targs->nis = 3;
+	// size of the system
+	targs->nj0 = 520;
+	targs->njs = 2;
+#if defined(MF_PANELMAJ)
+	// the row and column offsets of A are equal, for A_po to stay positive definite
+	if(strcmp(string(ROUTINE), "dposv_mixed"))
+		targs->ais = 2;
+	targs->bis = 2;
+	targs->dis = 2;
+#endif
+
+	targs->alphas = 1;
+	}
@@ -3,19 +3,59 @@
 
 void call_routines(struct RoutineArgs *args)
 	{
+#if defined(NUM_THREADS)
+	// for the large sizes A_po is strongly diagonally dominant, and would never be pivoted: the rows of the
+	// factorized block are reversed, that moves the largest entry of each column away from the diagonal
+	int ii, jj, i0;
+	int n_max = args->sA_po->m;
+	int mn = args->m<args->n ? args->m : args->n;
+	struct STRMAT sP;
+	struct STRMAT_REF rP;
+	ALLOCATE_STRMAT(n_max, n_max, &sP);
+	ALLOCATE_STRMAT_REF(n_max, n_max, &rP);
+	for(jj=0; jj<n_max; jj++)
+		{
+		for(ii=0; ii<n_max; ii++)
+			{
+			i0 = ii>=args->ai & ii<args->ai+args->m ? 2*args->ai+args->m-1-ii : ii;
+			MATEL_LIBSTR(&sP, ii, jj) = MATEL_LIBSTR(args->sA_po, i0, jj);
+			MATEL_REF(&rP, ii, jj) = MATEL_REF(args->rA_po, i0, jj);
+			}
+		}
+	struct STRMAT *sA = &sP;
+	struct STRMAT_REF *rA = &rP;
+#else
+	struct STRMAT *sA = args->sA_po;
+	struct STRMAT_REF *rA = args->rA_po;
+#endif
+
 	// routine call
 	//
 	BLASFEO(ROUTINE)(
 		args->m, args->n,
-		args->sA_po, args->ai, args->aj,
+		sA, args->ai, args->aj,
 		args->sD, args->di, args->dj,
 		args->sipiv);
 
 	BLASFEO(REF(ROUTINE))(
 		args->m, args->n,
-		args->rA_po, args->ai, args->aj,
+		rA, args->ai, args->aj,
 		args->rD, args->di, args->dj,
 		args->ripiv);
+
+#if defined(NUM_THREADS)
+	FREE_STRMAT(&sP);
+	FREE_STRMAT_REF(&rP);
+
+	// the row swaps of the lookahead alg are only covered if the reference does pivot
+	for(ii=0; ii<mn && args->ripiv[ii]==ii; ii++)
+		;
+	if(ii==mn)
+		{
+		printf("\nerror: %s: the test matrix is not pivoted\n", string(ROUTINE));
+		exit(1);
+		}
+#endif
 	}
 
 
@@ -47,6 +87,14 @@ void set_test_args(struct TestArgs *targs)
 //	targs->dis = 1;
 //	targs->xjs = 5;
 
+#if defined(NUM_THREADS)
+	// enough trailing columns for the lookahead alg
+	targs->ni0 = 250;
+	targs->nj0 = 250;
+	targs->nis = 2;
+	targs->njs = 2;
+#else
 	targs->nis = 13;
 	targs->njs = 13;
+#endif
 	}
@@ -0,0 +1,154 @@
+// CLASS_GRAPH
+//
+
+// block size of the recorded calls
+#define GRAPH_BS 8
+#define GRAPH_MAX_NODE 64
+
+
+
+// D <= alpha * A * B + beta * C, recorded by blocks of rows of D
+static void record_gemm_nn(struct blasfeo_dgraph *sG, struct RoutineArgs *args)
+	{
+	int ii, mb;
+	for(ii=0; ii<args->m; ii+=GRAPH_BS)
+		{
+		mb = args->m-ii<GRAPH_BS ? args->m-ii : GRAPH_BS;
+		blasfeo_dgraph_dgemm_nn(sG, mb, args->n, args->k,
+			args->alpha,
+			args->sA, args->ai+ii, args->aj,
+			args->sB, args->bi, args->bj,
+			args->beta,
+			args->sC, args->ci+ii, args->cj,
+			args->sD, args->di+ii, args->dj);
+		}
+	}
+
+
+
+// D <= chol( C ), recorded as a left-looking blocked Cholesky factorization
+static void record_potrf_l(struct blasfeo_dgraph *sG, struct RoutineArgs *args)
+	{
+	int jj, mb, mr;
+	int ci = args->ai;
+	int cj = args->aj;
+	int di = args->di;
+	int dj = args->dj;
+	for(jj=0; jj<args->m; jj+=GRAPH_BS)
+		{
+		mb = args->m-jj<GRAPH_BS ? args->m-jj : GRAPH_BS;
+		mr = args->m-jj-mb;
+		if(jj==0)
+			{
+			blasfeo_dgraph_dpotrf_l(sG, mb, args->sA_po, ci, cj, args->sD, di, dj);
+			if(mr>0)
+				blasfeo_dgraph_dtrsm_rltn(sG, mr, mb, 1.0, args->sD, di, dj, args->sA_po, ci+mb, cj, args->sD, di+mb, dj);
+			}
+		else
+			{
+			blasfeo_dgraph_dsyrk_ln(sG, mb, jj, -1.0, args->sD, di+jj, dj, args->sD, di+jj, dj, 1.0, args->sA_po, ci+jj, cj+jj, args->sD, di+jj, dj+jj);
+			blasfeo_dgraph_dpotrf_l(sG, mb, args->sD, di+jj, dj+jj, args->sD, di+jj, dj+jj);
+			if(mr>0)
+				{
+				blasfeo_dgraph_dgemm_nt(sG, mr, mb, jj, -1.0, args->sD, di+jj+mb, dj, args->sD, di+jj, dj, 1.0, args->sA_po, ci+jj+mb, cj+jj, args->sD, di+jj+mb, dj+jj);
+				blasfeo_dgraph_dtrsm_rltn(sG, mr, mb, 1.0, args->sD, di+jj, dj+jj, args->sD, di+jj+mb, dj+jj, args->sD, di+jj+mb, dj+jj);
+				}
+			}
+		}
+	}
+
+
+
+void call_routines(struct RoutineArgs *args)
+	{
+
+	int po = !strcmp(string(ROUTINE), "dgraph_potrf_l");
+
+	// record, compile and run the graph
+	//
+	struct blasfeo_dgraph sG;
+	void *mem;
+	v_zeros_align(&mem, blasfeo_dgraph_memsize(GRAPH_MAX_NODE));
+	blasfeo_dgraph_create(GRAPH_MAX_NODE, &sG, mem);
+
+	blasfeo_dgraph_begin(&sG);
+	if(po)
+		record_potrf_l(&sG, args);
+	else
+		record_gemm_nn(&sG, args);
+	blasfeo_dgraph_compile(&sG);
+
+	void *work;
+	v_zeros_align(&work, blasfeo_dgraph_worksize(&sG));
+	blasfeo_dgraph_run(&sG, work);
+
+	v_free_align(work);
+	v_free_align(mem);
+
+	// reference routine
+	//
+	if(po)
+		blasfeo_ref_dpotrf_l(
+			args->m,
+			args->rA_po, args->ai, args->aj,
+			args->rD, args->di, args->dj);
+	else
+		blasfeo_ref_dgemm_nn(
+			args->m, args->n, args->k,
+			args->alpha,
+			args->rA, args->ai, args->aj,
+			args->rB, args->bi, args->bj,
+			args->beta,
+			args->rC, args->ci, args->cj,
+			args->rD, args->di, args->dj);
+
+	}
+
+
+
+void print_routine(struct RoutineArgs *args)
+	{
+	printf("blasfeo_%s(%d, %d, %d, %f, A, %d, %d, B, %d, %d, %f, C, %d, %d, D, %d, %d);\n", string(ROUTINE), args->m, args->n, args->k, args->alpha, args->ai, args->aj, args->bi, args->bj, args->beta, args->ci, args->cj, args->di, args->dj);
+	}
+
+
+
+void print_routine_matrices(struct RoutineArgs *args)
+	{
+	printf("\nPrint D:\n");
+	blasfeo_print_xmat_debug(args->m, args->n, args->sD, args->di, args->dj, 0, 0, 0, "HP");
+	blasfeo_print_xmat_debug(args->m, args->n, args->rD, args->di, args->dj, 0, 0, 0, "REF");
+	}
+
+
+
+void set_test_args(struct TestArgs *targs)
+	{
+#if defined(MF_PANELMAJ)
+	targs->dis = 5;
+	targs->xjs = 2;
+#endif
+
+	// from one to five blocks of GRAPH_BS
+	targs->nis = 40;
+	if(!strcmp(string(ROUTINE), "dgraph_potrf_l"))
+		{
+		// the lower triangle is compared over the first args->n rows
+		targs->nj0 = 40;
+		}
+	else
+		{
+#if defined(NUM_THREADS)
+		// the time of the small graph runs goes in the thread start-up, sweep fewer sizes
+		targs->nis = 20;
+		targs->njs = 4;
+		targs->nks = 2;
+#else
+		targs->nis = 20;
+		targs->njs = 20;
+		targs->nks = 6;
+#endif
+		}
+
+	targs->alphas = 1;
+	}
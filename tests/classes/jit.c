@@ -0,0 +1,125 @@
+// CLASS_JIT
+//
+
+// the routine name is djit_<variant>, e.g. djit_gemm_nt
+#define JIT_VARIANT (string(ROUTINE)+5)
+// the kernels are generated up to this size, larger sizes go to the generic routine
+#define JIT_TEST_SIZE 32
+
+
+
+typedef void (*ref_gemm_t)(int, int, int, REAL, struct STRMAT_REF *, int, int, struct STRMAT_REF *, int, int, REAL, struct STRMAT_REF *, int, int, struct STRMAT_REF *, int, int);
+
+static const char *gemm_var[] = {"gemm_nn", "gemm_nt", "gemm_tn", "gemm_tt"};
+static ref_gemm_t gemm_ref[] = {blasfeo_ref_dgemm_nn, blasfeo_ref_dgemm_nt, blasfeo_ref_dgemm_tn, blasfeo_ref_dgemm_tt};
+
+// the three cases of beta of the kernels: zero, one and any other
+static const REAL jit_beta[] = {0.0, 1.0, 0.02};
+
+
+
+void call_routines(struct RoutineArgs *args)
+	{
+
+	const char *v = JIT_VARIANT;
+	int ii, idx;
+
+	for(idx=0; idx<4; idx++)
+		{
+		if(!strcmp(v, gemm_var[idx]))
+			break;
+		}
+
+	// one call for each case of beta, the first one from C and the others accumulating on D
+	for(ii=0; ii<3; ii++)
+		{
+		blasfeo_djit_dgemm(v[5], v[6], args->m, args->n, args->k,
+			args->alpha,
+			args->sA, args->ai, args->aj,
+			args->sB, args->bi, args->bj,
+			jit_beta[ii],
+			ii==0 ? args->sC : args->sD, ii==0 ? args->ci : args->di, ii==0 ? args->cj : args->dj,
+			args->sD, args->di, args->dj);
+
+		gemm_ref[idx](
+			args->m, args->n, args->k,
+			args->alpha,
+			args->rA, args->ai, args->aj,
+			args->rB, args->bi, args->bj,
+			jit_beta[ii],
+			ii==0 ? args->rC : args->rD, ii==0 ? args->ci : args->di, ii==0 ? args->cj : args->dj,
+			args->rD, args->di, args->dj);
+		}
+
+	// a kernel dispatched for a matrix A with other strides: the run falls back to the generic routine
+	struct STRMAT sT;
+	ALLOCATE_STRMAT(args->sA->m+4, args->sA->n+4, &sT);
+	struct blasfeo_djit_dgemm *jit = blasfeo_djit_dgemm_dispatch(v[5], v[6], args->m, args->n, args->k, args->alpha, &sT, args->sB, jit_beta[2], args->sD, args->sD);
+	if(jit!=NULL)
+		blasfeo_djit_dgemm_run(jit,
+			args->alpha,
+			args->sA, args->ai, args->aj,
+			args->sB, args->bi, args->bj,
+			jit_beta[2],
+			args->sD, args->di, args->dj,
+			args->sD, args->di, args->dj);
+	else
+		blasfeo_djit_dgemm(v[5], v[6], args->m, args->n, args->k,
+			args->alpha,
+			args->sA, args->ai, args->aj,
+			args->sB, args->bi, args->bj,
+			jit_beta[2],
+			args->sD, args->di, args->dj,
+			args->sD, args->di, args->dj);
+	FREE_STRMAT(&sT);
+
+	gemm_ref[idx](
+		args->m, args->n, args->k,
+		args->alpha,
+		args->rA, args->ai, args->aj,
+		args->rB, args->bi, args->bj,
+		jit_beta[2],
+		args->rD, args->di, args->dj,
+		args->rD, args->di, args->dj);
+
+	// keep the cache below its cap, for all the sizes of the sweep to run generated kernels
+	blasfeo_djit_free();
+
+	}
+
+
+
+void print_routine(struct RoutineArgs *args)
+	{
+	printf("blasfeo_%s(%d, %d, %d, %f, A, %d, %d, B, %d, %d, {0, 1, %f}, C, %d, %d, D, %d, %d);\n", string(ROUTINE), args->m, args->n, args->k, args->alpha, args->ai, args->aj, args->bi, args->bj, jit_beta[2], args->ci, args->cj, args->di, args->dj);
+	}
+
+
+
+void print_routine_matrices(struct RoutineArgs *args)
+	{
+	printf("\nPrint D:\n");
+	blasfeo_print_xmat_debug(args->m, args->n, args->sD, args->di, args->dj, 0, 0, 0, "HP");
+	blasfeo_print_xmat_debug(args->m, args->n, args->rD, args->di, args->dj, 0, 0, 0, "REF");
+	}
+
+
+
+void set_test_args(struct TestArgs *targs)
+	{
+	// the generated kernels take panel-aligned row offsets, the others go to the generic routine
+#if defined(MF_PANELMAJ)
+	targs->ais = 2;
+#endif
+	targs->xjs = 2;
+
+	// up to past the max size of the generated kernels, with k around the max too
+	targs->nis = JIT_TEST_SIZE+2;
+	targs->njs = JIT_TEST_SIZE+2;
+	targs->nk0 = JIT_TEST_SIZE-1;
+	targs->nks = 3;
+
+	// alpha one and any other
+	targs->alphas = 2;
+	targs->alpha_l[1] = 0.0001;
+	}
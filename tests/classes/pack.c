@@ -0,0 +1,135 @@
+// CLASS_PACK
+//
+// the pack routines read a column-major copy of A, at the offsets of A, and write D; the unpack routines read A
+// and write a column-major matrix, then copied to D
+//
+// the results are compared over the first n rows and m columns of D: the matrix structure has k rows and k-61
+// columns, and the transposed routines write its transpose
+
+// the matrix structure is above the min number of elements per thread of the multi-threaded pack, for 4 threads
+#define TEST_LARGE 1
+#define PACK_N_DIFF 61
+
+// the routine name is d<variant>, e.g. dpack_tran_sc_mat
+#define PACK_VARIANT (string(ROUTINE)+1)
+
+
+
+void call_routines(struct RoutineArgs *args)
+	{
+
+	const char *v = PACK_VARIANT;
+	int ii, jj;
+
+	// all the test matrices have the same size
+	int n_max = args->sA->m;
+
+	int m = args->k;
+	int n = args->k-PACK_N_DIFF;
+
+	double *sW, *rW;
+	d_zeros(&sW, n_max, n_max);
+	d_zeros(&rW, n_max, n_max);
+
+	if(!strncmp(v, "pack", 4))
+		{
+		// column-major copy of A
+		for(jj=0; jj<n_max; jj++)
+			{
+			for(ii=0; ii<n_max; ii++)
+				{
+				sW[ii+jj*n_max] = MATEL_REF(args->rA, ii, jj);
+				}
+			}
+		double *pA = sW + args->ai + args->aj*n_max;
+
+		if(!strcmp(v, "pack_mat"))
+			{
+			blasfeo_pack_dmat(m, n, pA, n_max, args->sD, args->di, args->dj);
+			blasfeo_ref_pack_dmat(m, n, pA, n_max, args->rD, args->di, args->dj);
+			}
+		else if(!strcmp(v, "pack_sc_mat"))
+			{
+			blasfeo_pack_sc_dmat(m, n, args->alpha, pA, n_max, args->sD, args->di, args->dj);
+			blasfeo_ref_pack_sc_dmat(m, n, args->alpha, pA, n_max, args->rD, args->di, args->dj);
+			}
+		else if(!strcmp(v, "pack_tran_mat"))
+			{
+			blasfeo_pack_tran_dmat(m, n, pA, n_max, args->sD, args->di, args->dj);
+			blasfeo_ref_pack_tran_dmat(m, n, pA, n_max, args->rD, args->di, args->dj);
+			}
+		else // pack_tran_sc_mat
+			{
+			blasfeo_pack_tran_sc_dmat(m, n, args->alpha, pA, n_max, args->sD, args->di, args->dj);
+			blasfeo_ref_pack_tran_sc_dmat(m, n, args->alpha, pA, n_max, args->rD, args->di, args->dj);
+			}
+		}
+	else // unpack_mat, unpack_tran_mat
+		{
+		int tran = !strcmp(v, "unpack_tran_mat");
+		if(tran)
+			{
+			blasfeo_unpack_tran_dmat(m, n, args->sA, args->ai, args->aj, sW, n_max);
+			blasfeo_ref_unpack_tran_dmat(m, n, args->rA, args->ai, args->aj, rW, n_max);
+			}
+		else
+			{
+			blasfeo_unpack_dmat(m, n, args->sA, args->ai, args->aj, sW, n_max);
+			blasfeo_ref_unpack_dmat(m, n, args->rA, args->ai, args->aj, rW, n_max);
+			}
+
+		int mw = tran ? n : m;
+		int nw = tran ? m : n;
+		for(jj=0; jj<nw; jj++)
+			{
+			for(ii=0; ii<mw; ii++)
+				{
+				MATEL_LIBSTR(args->sD, args->di+ii, args->dj+jj) = sW[ii+jj*n_max];
+				MATEL_REF(args->rD, args->di+ii, args->dj+jj) = rW[ii+jj*n_max];
+				}
+			}
+		}
+
+	d_free(sW);
+	d_free(rW);
+
+	}
+
+
+
+void print_routine(struct RoutineArgs *args)
+	{
+	printf("blasfeo_%s(%d, %d, %f, A, %d, %d, D, %d, %d);\n", PACK_VARIANT, args->k, args->k-PACK_N_DIFF, args->alpha, args->ai, args->aj, args->di, args->dj);
+	}
+
+
+
+void print_routine_matrices(struct RoutineArgs *args)
+	{
+	printf("\nPrint D:\n");
+	blasfeo_print_xmat_debug(args->k, args->k, args->sD, args->di, args->dj, 0, 0, 0, "HP");
+	blasfeo_print_xmat_debug(args->k, args->k, args->rD, args->di, args->dj, 0, 0, 0, "REF");
+	}
+
+
+
+void set_test_args(struct TestArgs *targs)
+	{
+	// all the row offsets in the panels of size 4 and 8, for the first panel of the split in the matrix structure
+	targs->ais = 9;
+	targs->bis = 1;
+	targs->dis = 9;
+	targs->xjs = 2;
+
+	// k crossing the remainders of the panel size 4; the compared part of D covers the results at all the offsets
+	targs->ni0 = 410;
+	targs->nis = 1;
+	targs->nj0 = 410;
+	targs->njs = 1;
+	targs->nk0 = 397;
+	targs->nks = 4;
+
+	// alpha one and any other
+	targs->alphas = 2;
+	targs->alpha_l[1] = 0.02;
+	}
@@ -0,0 +1,154 @@
+// CLASS_PLAN
+//
+
+// the execution plans are only available in the column-major high-performance build;
+// the size sweep crosses the small/blocked switch of the Haswell code paths
+#define TEST_LARGE 1
+
+// the routine name is dplan_<variant>, e.g. dplan_gemm_nt
+#define PLAN_VARIANT (string(ROUTINE)+6)
+
+
+
+typedef void (*ref_gemm_t)(int, int, int, REAL, struct STRMAT_REF *, int, int, struct STRMAT_REF *, int, int, REAL, struct STRMAT_REF *, int, int, struct STRMAT_REF *, int, int);
+typedef void (*ref_syrk_t)(int, int, REAL, struct STRMAT_REF *, int, int, struct STRMAT_REF *, int, int, REAL, struct STRMAT_REF *, int, int, struct STRMAT_REF *, int, int);
+typedef void (*ref_trsm_t)(int, int, REAL, struct STRMAT_REF *, int, int, struct STRMAT_REF *, int, int, struct STRMAT_REF *, int, int);
+typedef void (*ref_potrf_t)(int, struct STRMAT_REF *, int, int, struct STRMAT_REF *, int, int);
+
+static const char *gemm_var[] = {"gemm_nn", "gemm_nt", "gemm_tn", "gemm_tt"};
+static ref_gemm_t gemm_ref[] = {blasfeo_ref_dgemm_nn, blasfeo_ref_dgemm_nt, blasfeo_ref_dgemm_tn, blasfeo_ref_dgemm_tt};
+
+static const char *syrk_var[] = {"syrk_ln", "syrk_lt", "syrk_un", "syrk_ut"};
+static ref_syrk_t syrk_ref[] = {blasfeo_ref_dsyrk_ln, blasfeo_ref_dsyrk_lt, blasfeo_ref_dsyrk_un, blasfeo_ref_dsyrk_ut};
+
+static const char *trsm_var[] = {
+	"trsm_llnn", "trsm_llnu", "trsm_lltn", "trsm_lltu", "trsm_lunn", "trsm_lunu", "trsm_lutn", "trsm_lutu",
+	"trsm_rlnn", "trsm_rlnu", "trsm_rltn", "trsm_rltu", "trsm_runn", "trsm_runu", "trsm_rutn", "trsm_rutu"};
+static ref_trsm_t trsm_ref[] = {
+	blasfeo_ref_dtrsm_llnn, blasfeo_ref_dtrsm_llnu, blasfeo_ref_dtrsm_lltn, blasfeo_ref_dtrsm_lltu,
+	blasfeo_ref_dtrsm_lunn, blasfeo_ref_dtrsm_lunu, blasfeo_ref_dtrsm_lutn, blasfeo_ref_dtrsm_lutu,
+	blasfeo_ref_dtrsm_rlnn, blasfeo_ref_dtrsm_rlnu, blasfeo_ref_dtrsm_rltn, blasfeo_ref_dtrsm_rltu,
+	blasfeo_ref_dtrsm_runn, blasfeo_ref_dtrsm_runu, blasfeo_ref_dtrsm_rutn, blasfeo_ref_dtrsm_rutu};
+
+static const char *potrf_var[] = {"potrf_l", "potrf_u"};
+static ref_potrf_t potrf_ref[] = {blasfeo_ref_dpotrf_l, blasfeo_ref_dpotrf_u};
+
+
+
+// index of the variant in the list, or -1
+static int find_variant(const char **var, int nvar)
+	{
+	int ii;
+	for(ii=0; ii<nvar; ii++)
+		{
+		if(!strcmp(PLAN_VARIANT, var[ii]))
+			return ii;
+		}
+	return -1;
+	}
+
+
+
+void call_routines(struct RoutineArgs *args)
+	{
+
+	const char *v = PLAN_VARIANT;
+	struct blasfeo_dplan plan;
+	int idx;
+
+	if((idx = find_variant(gemm_var, 4)) >= 0)
+		{
+		blasfeo_dgemm_plan(v[5], v[6], args->m, args->n, args->k, args->ai, args->aj, args->bi, args->bj, args->ci, args->cj, args->di, args->dj, &plan);
+		blasfeo_dgemm_execute(&plan, args->alpha, args->sA, args->sB, args->beta, args->sC, args->sD);
+
+		gemm_ref[idx](
+			args->m, args->n, args->k,
+			args->alpha,
+			args->rA, args->ai, args->aj,
+			args->rB, args->bi, args->bj,
+			args->beta,
+			args->rC, args->ci, args->cj,
+			args->rD, args->di, args->dj);
+		}
+	else if((idx = find_variant(syrk_var, 4)) >= 0)
+		{
+		// as in the syrk class, k is given by args->n
+		blasfeo_dsyrk_plan(v[5], v[6], args->m, args->n, args->ai, args->aj, args->bi, args->bj, args->ci, args->cj, args->di, args->dj, &plan);
+		blasfeo_dsyrk_execute(&plan, args->alpha, args->sA, args->sB, args->beta, args->sC, args->sD);
+
+		syrk_ref[idx](
+			args->m, args->n,
+			args->alpha,
+			args->rA, args->ai, args->aj,
+			args->rB, args->bi, args->bj,
+			args->beta,
+			args->rC, args->ci, args->cj,
+			args->rD, args->di, args->dj);
+		}
+	else if((idx = find_variant(trsm_var, 16)) >= 0)
+		{
+		blasfeo_dtrsm_plan(v[5], v[6], v[7], v[8], args->m, args->n, args->ai, args->aj, args->bi, args->bj, args->di, args->dj, &plan);
+		blasfeo_dtrsm_execute(&plan, args->alpha, args->sA, args->sB, args->sD);
+
+		trsm_ref[idx](
+			args->m, args->n,
+			args->alpha,
+			args->rA, args->ai, args->aj,
+			args->rB, args->bi, args->bj,
+			args->rD, args->di, args->dj);
+		}
+	else if((idx = find_variant(potrf_var, 2)) >= 0)
+		{
+		blasfeo_dpotrf_plan(v[6], args->m, args->ai, args->aj, args->di, args->dj, &plan);
+		blasfeo_dpotrf_execute(&plan, args->sA_po, args->sD);
+
+		potrf_ref[idx](
+			args->m,
+			args->rA_po, args->ai, args->aj,
+			args->rD, args->di, args->dj);
+		}
+	else
+		{
+		printf("\nerror: no plan for %s\n", string(ROUTINE));
+		exit(1);
+		}
+
+	}
+
+
+
+void print_routine(struct RoutineArgs *args)
+	{
+	printf("blasfeo_%s(%d, %d, %d, %f, A, %d, %d, B, %d, %d, %f, C, %d, %d, D, %d, %d);\n", string(ROUTINE), args->m, args->n, args->k, args->alpha, args->ai, args->aj, args->bi, args->bj, args->beta, args->ci, args->cj, args->di, args->dj);
+	}
+
+
+
+void print_routine_matrices(struct RoutineArgs *args)
+	{
+	printf("\nPrint D:\n");
+	blasfeo_print_xmat_debug(args->m, args->n, args->sD, args->di, args->dj, 0, 0, 0, "HP");
+	blasfeo_print_xmat_debug(args->m, args->n, args->rD, args->di, args->dj, 0, 0, 0, "REF");
+	}
+
+
+
+void set_test_args(struct TestArgs *targs)
+	{
+	// the plan stores the offsets
+	targs->ais = 2;
+	targs->dis = 2;
+	targs->xjs = 2;
+
+	// m around 200, below 200 for n and k
+	targs->ni0 = 190;
+	targs->nis = 14;
+	targs->nj0 = 190;
+	if(!strncmp(PLAN_VARIANT, "gemm", 4))
+		{
+		targs->nk0 = 1;
+		targs->nks = 3;
+		}
+
+	targs->alphas = 1;
+	}
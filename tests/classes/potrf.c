@@ -42,5 +42,12 @@ void print_routine_matrices(struct RoutineArgs *args)
 
 void set_test_args(struct TestArgs *targs)
 	{
+#if defined(NUM_THREADS)
+	// at least four tiles per side for the tiled alg
+	targs->ni0 = 580;
+	targs->nj0 = 580;
+	targs->nis = 2;
+#else
 	targs->nis = 21;
+#endif
 	}
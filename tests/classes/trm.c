@@ -13,11 +13,23 @@ void call_routines(struct RoutineArgs *args)
 		args->sB, args->bi, args->bj,
 		args->sD, args->di, args->dj);
 
+#if defined(TEST_HP_REFERENCE)
+	// built without the reference routines: the reference is the same routine, single-threaded
+	int nth = blasfeo_get_num_threads();
+	blasfeo_set_num_threads(1);
+	BLASFEO(ROUTINE)(
+		args->m, args->n, args->alpha,
+		args->rA, args->ai, args->aj,
+		args->rB, args->bi, args->bj,
+		args->rD, args->di, args->dj);
+	blasfeo_set_num_threads(nth);
+#else
 	BLASFEO(REF(ROUTINE))(
 		args->m, args->n, args->alpha,
 		args->rA, args->ai, args->aj,
 		args->rB, args->bi, args->bj,
 		args->rD, args->di, args->dj);
+#endif
 
 	}
 
@@ -65,8 +77,22 @@ void print_routine_matrices(struct RoutineArgs *args)
 
 void set_test_args(struct TestArgs *targs)
 	{
+#if defined(TEST_HP_REFERENCE)
+	// enough right-hand sides for all the threads, with row blocks starting inside the matrices
+	targs->ni0 = 200;
+	targs->nj0 = 200;
+	targs->nis = 2;
+	targs->njs = 2;
+#elif defined(NUM_THREADS)
+	// enough right-hand sides to split them over the threads
+	targs->ni0 = 100;
+	targs->nj0 = 100;
+	targs->nis = 2;
+	targs->njs = 2;
+#else
 	targs->nis = 21;
 	targs->njs = 21;
+#endif
 //	targs->nks = 20;
 
 //	targs->ni0 = 10;
@@ -34,7 +34,8 @@
 **************************************************************************************************/
 
 // TODO later on check that it's equal to 1
-#if defined(BLASFEO_REF_API)
+// with TEST_HP_REFERENCE the test class computes the reference result with the high-performance routines
+#if defined(BLASFEO_REF_API) | defined(TEST_HP_REFERENCE)
 
 // libc
 #include <stdlib.h>
@@ -81,7 +81,15 @@
 #define ALLOCATE_STRMAT_REF blasfeo_allocate_dmat
 #define FREE_STRMAT_REF blasfeo_free_dmat
 
+#if defined(BLASFEO_REF_API)
 #define GESE_REF blasfeo_ref_dgese
 #define GECP_REF blasfeo_ref_dgecp
 #define PACK_STRMAT_REF blasfeo_ref_pack_dmat
 #define PRINT_STRMAT_REF blasfeo_ref_print_dmat
+#else
+// the reference matrices of TEST_HP_REFERENCE are handled by the high-performance routines
+#define GESE_REF blasfeo_dgese
+#define GECP_REF blasfeo_dgecp
+#define PACK_STRMAT_REF blasfeo_pack_dmat
+#define PRINT_STRMAT_REF blasfeo_print_dmat
+#endif
@@ -81,7 +81,15 @@
 #define ALLOCATE_STRMAT_REF blasfeo_allocate_smat
 #define FREE_STRMAT_REF blasfeo_free_smat
 
+#if defined(BLASFEO_REF_API)
 #define GESE_REF blasfeo_ref_sgese
 #define GECP_REF blasfeo_ref_sgecp
 #define PACK_STRMAT_REF blasfeo_ref_pack_smat
 #define PRINT_STRMAT_REF blasfeo_ref_print_smat
+#else
+// the reference matrices of TEST_HP_REFERENCE are handled by the high-performance routines
+#define GESE_REF blasfeo_sgese
+#define GECP_REF blasfeo_sgecp
+#define PACK_STRMAT_REF blasfeo_pack_smat
+#define PRINT_STRMAT_REF blasfeo_print_smat
+#endif
@@ -93,8 +93,22 @@ int main()
 	{
 	print_compilation_flags();
 
+#if defined(NUM_THREADS)
+	blasfeo_set_num_threads(NUM_THREADS);
+#endif
+
 	int ii, jj, kk;
+#if defined(NUM_THREADS) | defined(TEST_LARGE)
+	// large enough for the multi-threaded paths, and for the classes defining TEST_LARGE
+	int n = 600;
+	// diagonal shifts keeping A and A_po well conditioned, the largest entries of A*A' growing as n^5
+	REAL a_shift = 1E9;
+	REAL po_shift = 1E14;
+#else
 	int n = 60;
+	REAL a_shift = 1.0;
+	REAL po_shift = 1E6;
+#endif
 	int bad_calls;
 	double test_elapsed_time;
 	const char* result_code;
@@ -133,8 +147,8 @@ int main()
 	for(ii=0; ii<n*n; ii++) C[ii] = 0.5*(ii+1);
 
 	// A non singular matrix
-	// A[i,i] = A[i,i] + 1
-	for(ii=0; ii<n; ii++) A[(ii*n)+ii] = A[(ii*n)+ii] + 1;
+	// A[i,i] = A[i,i] + a_shift
+	for(ii=0; ii<n; ii++) A[(ii*n)+ii] = A[(ii*n)+ii] + a_shift;
 
 	// Create positive definite matrix
 	// A_po = A * A'
@@ -150,9 +164,9 @@ int main()
 		}
 	}
 
-	// A_po[i,i] = A_po[i,i] + 1E6 + i
+	// A_po[i,i] = A_po[i,i] + po_shift + i
 	// Well conditioned positive definite matrix
-	for(ii=0; ii<n; ii++) A_po[(ii*n)+ii] = A_po[(ii*n)+ii] + 1E6+ii;
+	for(ii=0; ii<n; ii++) A_po[(ii*n)+ii] = A_po[(ii*n)+ii] + po_shift+ii;
 
 	// Allocate HP matrices
 	struct STRMAT sA; ALLOCATE_STRMAT(n, n, &sA);
@@ -35,11 +35,14 @@
 
 
 
+// the routine class can define a looser tolerance
+#ifndef REL_TOL
 #ifdef DOUBLE_PRECISION
 #define REL_TOL 1e-11
 #else
 #define REL_TOL 9e-4
 #endif
+#endif
 
 
 
@@ -58,6 +61,9 @@ void print_compilation_flags()
 #endif
 	SHOW_DEFINE(K_MAX_STACK)
 	SHOW_DEFINE(PACKING_ALG)
+#if defined(NUM_THREADS)
+	SHOW_DEFINE(NUM_THREADS)
+#endif
 	SHOW_DEFINE(ROUTINE_FULLNAME)
 	}
 
@@ -39,6 +39,7 @@
 #include <string.h>
 
 #include <blasfeo_common.h>
+#include <blasfeo_thread.h>
 
 
 